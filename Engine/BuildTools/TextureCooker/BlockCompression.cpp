@@ -0,0 +1,383 @@
+#include "BlockCompression.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace BlockCompression {
+namespace {
+    struct Block {
+        float px[16][4];
+    };
+
+    Block loadBlock(const uint8_t* rgba) {
+        Block block;
+        for (int i = 0; i < 16; i++) {
+            for (int c = 0; c < 4; c++) {
+                block.px[i][c] = rgba[i * 4 + c];
+            }
+        }
+        return block;
+    }
+
+    // Principal axis of the first `channels` channels through power iteration on the covariance matrix.
+    void principalAxis(const Block& block, int channels, float mean[4], float axis[4]) {
+        for (int c = 0; c < 4; c++) {
+            mean[c] = 0.0f;
+            axis[c] = 0.0f;
+        }
+        for (int i = 0; i < 16; i++) {
+            for (int c = 0; c < channels; c++) mean[c] += block.px[i][c];
+        }
+        for (int c = 0; c < channels; c++) mean[c] /= 16.0f;
+
+        float cov[4][4] = {};
+        for (int i = 0; i < 16; i++) {
+            float d[4];
+            for (int c = 0; c < channels; c++) d[c] = block.px[i][c] - mean[c];
+            for (int a = 0; a < channels; a++) {
+                for (int b = 0; b < channels; b++) cov[a][b] += d[a] * d[b];
+            }
+        }
+
+        // Start from the channel with the biggest spread, converges in a few steps for 4x4 blocks.
+        int start = 0;
+        for (int c = 1; c < channels; c++) {
+            if (cov[c][c] > cov[start][start]) start = c;
+        }
+        float v[4] = {};
+        for (int c = 0; c < channels; c++) v[c] = cov[start][c];
+
+        for (int iteration = 0; iteration < 8; iteration++) {
+            float next[4] = {};
+            for (int a = 0; a < channels; a++) {
+                for (int b = 0; b < channels; b++) next[a] += cov[a][b] * v[b];
+            }
+            float length = 0.0f;
+            for (int c = 0; c < channels; c++) length += next[c] * next[c];
+            length = std::sqrt(length);
+            if (length < 1e-6f) break;
+            for (int c = 0; c < channels; c++) v[c] = next[c] / length;
+        }
+
+        float length = 0.0f;
+        for (int c = 0; c < channels; c++) length += v[c] * v[c];
+        if (length < 1e-6f) {
+            for (int c = 0; c < channels; c++) v[c] = 1.0f / std::sqrt(static_cast<float>(channels));
+        }
+        for (int c = 0; c < channels; c++) axis[c] = v[c];
+    }
+
+    // Endpoints at the extreme projections of block texels on the principal axis.
+    void axisEndpoints(const Block& block, int channels, float low[4], float high[4]) {
+        float mean[4], axis[4];
+        principalAxis(block, channels, mean, axis);
+
+        float minT = 0.0f, maxT = 0.0f;
+        for (int i = 0; i < 16; i++) {
+            float t = 0.0f;
+            for (int c = 0; c < channels; c++) t += (block.px[i][c] - mean[c]) * axis[c];
+            minT = std::min(minT, t);
+            maxT = std::max(maxT, t);
+        }
+
+        for (int c = 0; c < 4; c++) {
+            low[c] = c < channels ? std::clamp(mean[c] + axis[c] * minT, 0.0f, 255.0f) : 255.0f;
+            high[c] = c < channels ? std::clamp(mean[c] + axis[c] * maxT, 0.0f, 255.0f) : 255.0f;
+        }
+    }
+
+    uint16_t pack565(const float color[3]) {
+        int r = static_cast<int>(std::lround(color[0] * 31.0f / 255.0f));
+        int g = static_cast<int>(std::lround(color[1] * 63.0f / 255.0f));
+        int b = static_cast<int>(std::lround(color[2] * 31.0f / 255.0f));
+        return static_cast<uint16_t>((std::clamp(r, 0, 31) << 11) | (std::clamp(g, 0, 63) << 5) | std::clamp(b, 0, 31));
+    }
+
+    void unpack565(uint16_t value, int out[3]) {
+        int r = (value >> 11) & 31;
+        int g = (value >> 5) & 63;
+        int b = value & 31;
+        out[0] = (r << 3) | (r >> 2);
+        out[1] = (g << 2) | (g >> 4);
+        out[2] = (b << 3) | (b >> 2);
+    }
+
+    // Writes four color BC1 block for given 565 endpoints and returns its squared error.
+    float fitColorIndices(const Block& block, uint16_t c0, uint16_t c1, uint8_t indices[16]) {
+        int palette[4][3];
+        unpack565(c0, palette[0]);
+        unpack565(c1, palette[1]);
+        for (int c = 0; c < 3; c++) {
+            palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+            palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+        }
+
+        float total = 0.0f;
+        for (int i = 0; i < 16; i++) {
+            float best = 1e30f;
+            for (int p = 0; p < 4; p++) {
+                float error = 0.0f;
+                for (int c = 0; c < 3; c++) {
+                    float d = block.px[i][c] - palette[p][c];
+                    error += d * d;
+                }
+                if (error < best) {
+                    best = error;
+                    indices[i] = static_cast<uint8_t>(p);
+                }
+            }
+            total += best;
+        }
+        return total;
+    }
+
+    // Orders endpoints for four color mode and packs the 8 byte block.
+    void writeColorBlock(uint16_t c0, uint16_t c1, uint8_t indices[16], uint8_t* out) {
+        if (c0 < c1) {
+            std::swap(c0, c1);
+            static const uint8_t swapped[4] = { 1, 0, 3, 2 };
+            for (int i = 0; i < 16; i++) indices[i] = swapped[indices[i]];
+        } else if (c0 == c1) {
+            for (int i = 0; i < 16; i++) indices[i] = 0;
+        }
+
+        uint32_t bits = 0;
+        for (int i = 0; i < 16; i++) bits |= static_cast<uint32_t>(indices[i]) << (i * 2);
+
+        out[0] = static_cast<uint8_t>(c0 & 0xFF);
+        out[1] = static_cast<uint8_t>(c0 >> 8);
+        out[2] = static_cast<uint8_t>(c1 & 0xFF);
+        out[3] = static_cast<uint8_t>(c1 >> 8);
+        for (int i = 0; i < 4; i++) out[4 + i] = static_cast<uint8_t>(bits >> (i * 8));
+    }
+
+    void encodeColorBlock(const Block& block, uint8_t* out) {
+        float low[4], high[4];
+        axisEndpoints(block, 3, low, high);
+
+        uint16_t c0 = pack565(high);
+        uint16_t c1 = pack565(low);
+        uint8_t indices[16];
+        float error = fitColorIndices(block, c0, c1, indices);
+
+        // One least squares pass, solves endpoints that best reproduce texels for the chosen indices.
+        static const float weights[4] = { 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f };
+        float aa = 0.0f, ab = 0.0f, bb = 0.0f;
+        float ax[3] = {}, bx[3] = {};
+        for (int i = 0; i < 16; i++) {
+            float a = weights[indices[i]];
+            float b = 1.0f - a;
+            aa += a * a;
+            ab += a * b;
+            bb += b * b;
+            for (int c = 0; c < 3; c++) {
+                ax[c] += a * block.px[i][c];
+                bx[c] += b * block.px[i][c];
+            }
+        }
+
+        float det = aa * bb - ab * ab;
+        if (std::fabs(det) > 1e-6f) {
+            float refinedHigh[3], refinedLow[3];
+            for (int c = 0; c < 3; c++) {
+                refinedHigh[c] = std::clamp((ax[c] * bb - bx[c] * ab) / det, 0.0f, 255.0f);
+                refinedLow[c] = std::clamp((bx[c] * aa - ax[c] * ab) / det, 0.0f, 255.0f);
+            }
+
+            uint16_t r0 = pack565(refinedHigh);
+            uint16_t r1 = pack565(refinedLow);
+            uint8_t refinedIndices[16];
+            float refinedError = fitColorIndices(block, r0, r1, refinedIndices);
+            if (refinedError < error) {
+                c0 = r0;
+                c1 = r1;
+                std::memcpy(indices, refinedIndices, sizeof(indices));
+            }
+        }
+
+        writeColorBlock(c0, c1, indices, out);
+    }
+
+    void encodeAlphaBlock(const Block& block, uint8_t* out) {
+        int minAlpha = 255, maxAlpha = 0;
+        for (int i = 0; i < 16; i++) {
+            int alpha = static_cast<int>(block.px[i][3]);
+            minAlpha = std::min(minAlpha, alpha);
+            maxAlpha = std::max(maxAlpha, alpha);
+        }
+
+        std::memset(out, 0, 8);
+        out[0] = static_cast<uint8_t>(maxAlpha);
+        out[1] = static_cast<uint8_t>(minAlpha);
+        if (maxAlpha == minAlpha) return;
+
+        // Eight value mode (a0 > a1): index 0 = a0, 1 = a1, 2..7 interpolate from a0 towards a1.
+        int palette[8];
+        palette[0] = maxAlpha;
+        palette[1] = minAlpha;
+        for (int i = 1; i < 7; i++) {
+            palette[i + 1] = ((7 - i) * maxAlpha + i * minAlpha) / 7;
+        }
+
+        uint64_t bits = 0;
+        for (int i = 0; i < 16; i++) {
+            int alpha = static_cast<int>(block.px[i][3]);
+            int best = 0;
+            for (int p = 1; p < 8; p++) {
+                if (std::abs(palette[p] - alpha) < std::abs(palette[best] - alpha)) best = p;
+            }
+            bits |= static_cast<uint64_t>(best) << (i * 3);
+        }
+        for (int i = 0; i < 6; i++) out[2 + i] = static_cast<uint8_t>(bits >> (i * 8));
+    }
+
+    class BitWriter {
+    public:
+        explicit BitWriter(uint8_t* out) : m_out(out) { std::memset(m_out, 0, 16); }
+
+        void write(uint32_t value, int count) {
+            for (int i = 0; i < count; i++, m_position++) {
+                if (value & (1u << i)) m_out[m_position >> 3] |= static_cast<uint8_t>(1u << (m_position & 7));
+            }
+        }
+
+    private:
+        uint8_t* m_out;
+        int m_position = 0;
+    };
+
+    const int BC7_WEIGHTS_4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+    // Quantizes endpoint to 7 bits per channel plus shared p-bit, picks the p-bit with lower error.
+    void quantizeMode6Endpoint(const float endpoint[4], int quantized[4], int& pBit) {
+        float bestError = 1e30f;
+        for (int p = 0; p < 2; p++) {
+            int candidate[4];
+            float error = 0.0f;
+            for (int c = 0; c < 4; c++) {
+                candidate[c] = std::clamp(static_cast<int>(std::lround((endpoint[c] - p) / 2.0f)), 0, 127);
+                float d = endpoint[c] - static_cast<float>((candidate[c] << 1) | p);
+                error += d * d;
+            }
+            if (error < bestError) {
+                bestError = error;
+                pBit = p;
+                std::memcpy(quantized, candidate, sizeof(candidate));
+            }
+        }
+    }
+
+    float fitMode6Indices(const Block& block, const int q0[4], int p0, const int q1[4], int p1, uint8_t indices[16]) {
+        int e0[4], e1[4];
+        for (int c = 0; c < 4; c++) {
+            e0[c] = (q0[c] << 1) | p0;
+            e1[c] = (q1[c] << 1) | p1;
+        }
+
+        int palette[16][4];
+        for (int w = 0; w < 16; w++) {
+            for (int c = 0; c < 4; c++) {
+                palette[w][c] = (e0[c] * (64 - BC7_WEIGHTS_4[w]) + e1[c] * BC7_WEIGHTS_4[w] + 32) >> 6;
+            }
+        }
+
+        float total = 0.0f;
+        for (int i = 0; i < 16; i++) {
+            float best = 1e30f;
+            for (int w = 0; w < 16; w++) {
+                float error = 0.0f;
+                for (int c = 0; c < 4; c++) {
+                    float d = block.px[i][c] - palette[w][c];
+                    error += d * d;
+                }
+                if (error < best) {
+                    best = error;
+                    indices[i] = static_cast<uint8_t>(w);
+                }
+            }
+            total += best;
+        }
+        return total;
+    }
+}
+
+    void encodeBC1(const uint8_t* rgba, uint8_t* out) {
+        encodeColorBlock(loadBlock(rgba), out);
+    }
+
+    void encodeBC3(const uint8_t* rgba, uint8_t* out) {
+        Block block = loadBlock(rgba);
+        encodeAlphaBlock(block, out);
+        encodeColorBlock(block, out + 8);
+    }
+
+    void encodeBC7(const uint8_t* rgba, uint8_t* out) {
+        Block block = loadBlock(rgba);
+
+        float low[4], high[4];
+        axisEndpoints(block, 4, low, high);
+
+        int q0[4], q1[4], p0 = 0, p1 = 0;
+        quantizeMode6Endpoint(low, q0, p0);
+        quantizeMode6Endpoint(high, q1, p1);
+
+        uint8_t indices[16];
+        float error = fitMode6Indices(block, q0, p0, q1, p1, indices);
+
+        // Least squares refinement of both endpoints for the chosen weights.
+        float aa = 0.0f, ab = 0.0f, bb = 0.0f;
+        float ax[4] = {}, bx[4] = {};
+        for (int i = 0; i < 16; i++) {
+            float b = BC7_WEIGHTS_4[indices[i]] / 64.0f;
+            float a = 1.0f - b;
+            aa += a * a;
+            ab += a * b;
+            bb += b * b;
+            for (int c = 0; c < 4; c++) {
+                ax[c] += a * block.px[i][c];
+                bx[c] += b * block.px[i][c];
+            }
+        }
+
+        float det = aa * bb - ab * ab;
+        if (std::fabs(det) > 1e-6f) {
+            float refinedLow[4], refinedHigh[4];
+            for (int c = 0; c < 4; c++) {
+                refinedLow[c] = std::clamp((ax[c] * bb - bx[c] * ab) / det, 0.0f, 255.0f);
+                refinedHigh[c] = std::clamp((bx[c] * aa - ax[c] * ab) / det, 0.0f, 255.0f);
+            }
+
+            int r0[4], r1[4], rp0 = 0, rp1 = 0;
+            quantizeMode6Endpoint(refinedLow, r0, rp0);
+            quantizeMode6Endpoint(refinedHigh, r1, rp1);
+            uint8_t refinedIndices[16];
+            float refinedError = fitMode6Indices(block, r0, rp0, r1, rp1, refinedIndices);
+            if (refinedError < error) {
+                std::memcpy(q0, r0, sizeof(q0));
+                std::memcpy(q1, r1, sizeof(q1));
+                p0 = rp0;
+                p1 = rp1;
+                std::memcpy(indices, refinedIndices, sizeof(indices));
+            }
+        }
+
+        // Anchor texel stores only 3 index bits, its top bit has to be zero.
+        if (indices[0] & 8) {
+            std::swap(q0, q1);
+            std::swap(p0, p1);
+            for (int i = 0; i < 16; i++) indices[i] = static_cast<uint8_t>(15 - indices[i]);
+        }
+
+        BitWriter writer(out);
+        writer.write(1u << 6, 7);
+        for (int c = 0; c < 4; c++) {
+            writer.write(static_cast<uint32_t>(q0[c]), 7);
+            writer.write(static_cast<uint32_t>(q1[c]), 7);
+        }
+        writer.write(static_cast<uint32_t>(p0), 1);
+        writer.write(static_cast<uint32_t>(p1), 1);
+        writer.write(indices[0], 3);
+        for (int i = 1; i < 16; i++) writer.write(indices[i], 4);
+    }
+}
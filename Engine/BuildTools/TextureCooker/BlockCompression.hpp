@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstdint>
+
+// Encoders of single 4x4 blocks. Input is always 16 RGBA8 texels in row major order (64 bytes).
+namespace BlockCompression {
+    // BC1 in four color mode, alpha is ignored. Writes 8 bytes.
+    void encodeBC1(const uint8_t* rgba, uint8_t* out);
+
+    // BC3: BC1 color block (always four color) preceded by an interpolated alpha block. Writes 16 bytes.
+    void encodeBC3(const uint8_t* rgba, uint8_t* out);
+
+    // BC7 mode 6: one subset, RGBA endpoints with p-bits and 4 bit indices. Writes 16 bytes.
+    void encodeBC7(const uint8_t* rgba, uint8_t* out);
+}
@@ -0,0 +1,261 @@
+#include "TextureCooker.hpp"
+#include "BlockCompression.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "../../Core/thirdparty/stb/stb_image.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+    const std::array<float, 256>& srgbToLinearTable() {
+        static const std::array<float, 256> table = [] {
+            std::array<float, 256> values{};
+            for (int i = 0; i < 256; i++) {
+                float c = i / 255.0f;
+                values[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+            }
+            return values;
+        }();
+        return table;
+    }
+
+    uint8_t linearToSrgb(float linear) {
+        float c = linear <= 0.0031308f ? linear * 12.92f : 1.055f * std::pow(linear, 1.0f / 2.4f) - 0.055f;
+        return static_cast<uint8_t>(std::clamp(std::lround(c * 255.0f), 0L, 255L));
+    }
+
+    const char* encodingName(vex::TextureEncoding encoding) {
+        switch (encoding) {
+            case vex::TextureEncoding::BC1: return "BC1";
+            case vex::TextureEncoding::BC3: return "BC3";
+            case vex::TextureEncoding::BC7: return "BC7";
+            default: return "RGBA8";
+        }
+    }
+
+    uint64_t alignUp(uint64_t value, uint64_t alignment) {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+}
+
+bool TextureCooker::isSourceImage(const std::string& path) {
+    std::string extension = fs::path(path).extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return extension == ".png" || extension == ".jpg" || extension == ".jpeg" || extension == ".tga" || extension == ".bmp";
+}
+
+TextureCooker::Image TextureCooker::downsample(const Image& source) {
+    // Box filter in linear space, odd edges reuse the last texel.
+    const auto& toLinear = srgbToLinearTable();
+    Image level;
+    level.width = std::max(source.width / 2, 1u);
+    level.height = std::max(source.height / 2, 1u);
+    level.rgba.resize(static_cast<size_t>(level.width) * level.height * 4);
+
+    for (uint32_t y = 0; y < level.height; y++) {
+        uint32_t y0 = std::min(y * 2, source.height - 1);
+        uint32_t y1 = std::min(y * 2 + 1, source.height - 1);
+        for (uint32_t x = 0; x < level.width; x++) {
+            uint32_t x0 = std::min(x * 2, source.width - 1);
+            uint32_t x1 = std::min(x * 2 + 1, source.width - 1);
+            const uint8_t* texels[4] = {
+                &source.rgba[(static_cast<size_t>(y0) * source.width + x0) * 4],
+                &source.rgba[(static_cast<size_t>(y0) * source.width + x1) * 4],
+                &source.rgba[(static_cast<size_t>(y1) * source.width + x0) * 4],
+                &source.rgba[(static_cast<size_t>(y1) * source.width + x1) * 4]
+            };
+
+            uint8_t* out = &level.rgba[(static_cast<size_t>(y) * level.width + x) * 4];
+            for (int c = 0; c < 3; c++) {
+                float sum = 0.0f;
+                for (const uint8_t* texel : texels) sum += toLinear[texel[c]];
+                out[c] = linearToSrgb(sum * 0.25f);
+            }
+            out[3] = static_cast<uint8_t>((texels[0][3] + texels[1][3] + texels[2][3] + texels[3][3] + 2) / 4);
+        }
+    }
+    return level;
+}
+
+std::vector<uint8_t> TextureCooker::encodeLevel(const Image& level, vex::TextureEncoding encoding) {
+    if (!vex::isBlockCompressed(encoding)) {
+        return level.rgba;
+    }
+
+    std::vector<uint8_t> out(vex::textureLevelBytes(encoding, level.width, level.height));
+    const uint32_t blockBytes = vex::textureBlockBytes(encoding);
+    const uint32_t blocksX = (level.width + 3) / 4;
+    const uint32_t blocksY = (level.height + 3) / 4;
+
+    uint8_t block[64];
+    for (uint32_t by = 0; by < blocksY; by++) {
+        for (uint32_t bx = 0; bx < blocksX; bx++) {
+            // Blocks past the edge of small mips repeat the edge texels.
+            for (uint32_t py = 0; py < 4; py++) {
+                uint32_t y = std::min(by * 4 + py, level.height - 1);
+                for (uint32_t px = 0; px < 4; px++) {
+                    uint32_t x = std::min(bx * 4 + px, level.width - 1);
+                    std::copy_n(&level.rgba[(static_cast<size_t>(y) * level.width + x) * 4], 4, &block[(py * 4 + px) * 4]);
+                }
+            }
+
+            uint8_t* target = &out[(static_cast<size_t>(by) * blocksX + bx) * blockBytes];
+            switch (encoding) {
+                case vex::TextureEncoding::BC1: BlockCompression::encodeBC1(block, target); break;
+                case vex::TextureEncoding::BC3: BlockCompression::encodeBC3(block, target); break;
+                case vex::TextureEncoding::BC7: BlockCompression::encodeBC7(block, target); break;
+                default: break;
+            }
+        }
+    }
+    return out;
+}
+
+bool TextureCooker::cook(const std::string& inputPath, const std::string& outputPath, CookReport& report) const {
+    auto start = std::chrono::steady_clock::now();
+
+    int width = 0, height = 0, channels = 0;
+    stbi_uc* pixels = stbi_load(inputPath.c_str(), &width, &height, &channels, STBI_rgb_alpha);
+    if (!pixels) {
+        std::cerr << "Failed to decode " << inputPath << ": " << stbi_failure_reason() << std::endl;
+        return false;
+    }
+
+    Image image;
+    image.width = static_cast<uint32_t>(width);
+    image.height = static_cast<uint32_t>(height);
+    image.rgba.assign(pixels, pixels + static_cast<size_t>(width) * height * 4);
+    stbi_image_free(pixels);
+
+    vex::TextureEncoding encoding = options_.encoding;
+    if (options_.autoEncoding) {
+        bool hasAlpha = false;
+        for (size_t i = 3; i < image.rgba.size() && !hasAlpha; i += 4) {
+            hasAlpha = image.rgba[i] != 255;
+        }
+        encoding = hasAlpha ? vex::TextureEncoding::BC3 : vex::TextureEncoding::BC1;
+    }
+
+    const uint32_t levelCount = options_.generateMips ? vex::fullMipCount(image.width, image.height) : 1;
+
+    std::vector<std::vector<uint8_t>> levels;
+    levels.reserve(levelCount);
+    Image current = std::move(image);
+    for (uint32_t level = 0; level < levelCount; level++) {
+        if (level > 0) {
+            current = downsample(current);
+        }
+        levels.push_back(encodeLevel(current, encoding));
+    }
+
+    vex::TextureContainerHeader header;
+    header.encoding = encoding;
+    header.width = static_cast<uint32_t>(width);
+    header.height = static_cast<uint32_t>(height);
+    header.levelCount = levelCount;
+    header.sourceBytes = vex::rawMipChainBytes(header.width, header.height);
+
+    std::vector<vex::TextureLevelIndex> index(levelCount);
+    uint64_t offset = alignUp(sizeof(header) + sizeof(vex::TextureLevelIndex) * levelCount, 16);
+    uint64_t cookedBytes = 0;
+    for (uint32_t level = 0; level < levelCount; level++) {
+        index[level].byteOffset = offset;
+        index[level].byteLength = levels[level].size();
+        offset = alignUp(offset + levels[level].size(), 16);
+        cookedBytes += levels[level].size();
+    }
+
+    fs::path tempPath = outputPath + ".tmp";
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            std::cerr << "Failed to create output file: " << tempPath.string() << std::endl;
+            return false;
+        }
+
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(index.data()), static_cast<std::streamsize>(sizeof(vex::TextureLevelIndex) * levelCount));
+
+        const char padding[16] = {};
+        for (uint32_t level = 0; level < levelCount; level++) {
+            uint64_t position = static_cast<uint64_t>(out.tellp());
+            out.write(padding, static_cast<std::streamsize>(index[level].byteOffset - position));
+            out.write(reinterpret_cast<const char*>(levels[level].data()), static_cast<std::streamsize>(levels[level].size()));
+        }
+
+        if (!out.flush()) {
+            std::cerr << "Failed to write output file: " << tempPath.string() << std::endl;
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    fs::rename(tempPath, outputPath, ec);
+    if (ec) {
+        std::cerr << "Failed to move " << tempPath.string() << " to " << outputPath << ": " << ec.message() << std::endl;
+        fs::remove(tempPath, ec);
+        return false;
+    }
+
+    report.width = header.width;
+    report.height = header.height;
+    report.levelCount = levelCount;
+    report.encoding = encoding;
+    report.sourceBytes = header.sourceBytes;
+    report.cookedBytes = cookedBytes;
+    report.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << inputPath << ": " << report.width << "x" << report.height << " " << encodingName(encoding)
+              << ", " << levelCount << " mips, " << (cookedBytes / 1024) << " KiB (RGBA8 " << (report.sourceBytes / 1024)
+              << " KiB, saved " << static_cast<int>(100.0 - 100.0 * cookedBytes / std::max<uint64_t>(report.sourceBytes, 1)) << "%)"
+              << ", " << static_cast<int>(report.milliseconds) << " ms" << std::endl;
+    return true;
+}
+
+int TextureCooker::cookDirectory(const std::string& directory) const {
+    int failed = 0;
+    uint64_t totalSource = 0;
+    uint64_t totalCooked = 0;
+    size_t cooked = 0;
+    size_t skipped = 0;
+
+    std::error_code ec;
+    for (const auto& entry : fs::recursive_directory_iterator(directory, ec)) {
+        if (!entry.is_regular_file() || !isSourceImage(entry.path().string())) continue;
+
+        fs::path outputPath = entry.path();
+        outputPath.replace_extension(vex::TEXTURE_CONTAINER_EXTENSION);
+
+        std::error_code timeError;
+        if (fs::exists(outputPath) && fs::last_write_time(outputPath, timeError) >= fs::last_write_time(entry.path(), timeError) && !timeError) {
+            skipped++;
+            continue;
+        }
+
+        CookReport report;
+        if (cook(entry.path().string(), outputPath.string(), report)) {
+            totalSource += report.sourceBytes;
+            totalCooked += report.cookedBytes;
+            cooked++;
+        } else {
+            failed++;
+        }
+    }
+
+    if (ec) {
+        std::cerr << "Failed to walk " << directory << ": " << ec.message() << std::endl;
+        return 1;
+    }
+
+    std::cout << "Cooked " << cooked << " textures (" << skipped << " up to date, " << failed << " failed), "
+              << (totalCooked / 1024) << " KiB instead of " << (totalSource / 1024) << " KiB" << std::endl;
+    return failed;
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "../../Core/include/components/TextureContainer.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct CookOptions {
+    bool autoEncoding = true; // BC1 for opaque sources, BC3 when any texel has alpha
+    vex::TextureEncoding encoding = vex::TextureEncoding::BC1;
+    bool generateMips = true;
+};
+
+struct CookReport {
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t levelCount = 0;
+    vex::TextureEncoding encoding = vex::TextureEncoding::RGBA8;
+    uint64_t sourceBytes = 0; // full RGBA8 mip chain
+    uint64_t cookedBytes = 0; // level data only
+    double milliseconds = 0.0;
+};
+
+class TextureCooker {
+public:
+    explicit TextureCooker(const CookOptions& options) : options_(options) {}
+
+    // Decodes image, builds mip chain, compresses every level and writes a .vtex file.
+    bool cook(const std::string& inputPath, const std::string& outputPath, CookReport& report) const;
+
+    // Cooks every image under directory into a sibling .vtex, skipping ones newer than their source.
+    int cookDirectory(const std::string& directory) const;
+
+    static bool isSourceImage(const std::string& path);
+
+private:
+    struct Image {
+        uint32_t width;
+        uint32_t height;
+        std::vector<uint8_t> rgba;
+    };
+
+    static Image downsample(const Image& source);
+    static std::vector<uint8_t> encodeLevel(const Image& level, vex::TextureEncoding encoding);
+
+    CookOptions options_;
+};
@@ -0,0 +1,67 @@
+#include "TextureCooker.hpp"
+
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+    void printUsage() {
+        std::cerr << "Usage: TextureCooker <input image> [output.vtex] [--format auto|bc1|bc3|bc7|rgba8] [--no-mips]\n";
+        std::cerr << "       TextureCooker --dir <assets folder> [--format ...] [--no-mips]\n";
+        std::cerr << "  auto picks BC1 for opaque images and BC3 for images with alpha.\n";
+        std::cerr << "  --dir cooks every png/jpg/tga/bmp into a .vtex next to it, the engine loads it instead of the source.\n";
+        std::cerr << "Example: TextureCooker --dir Assets --format bc7\n";
+    }
+}
+
+int main(int argc, char* argv[]) {
+    CookOptions options;
+    std::string directory;
+    std::vector<std::string> positional;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--dir" && i + 1 < argc) {
+            directory = argv[++i];
+        } else if (arg == "--format" && i + 1 < argc) {
+            std::string format = argv[++i];
+            options.autoEncoding = false;
+            if (format == "auto") options.autoEncoding = true;
+            else if (format == "bc1") options.encoding = vex::TextureEncoding::BC1;
+            else if (format == "bc3") options.encoding = vex::TextureEncoding::BC3;
+            else if (format == "bc7") options.encoding = vex::TextureEncoding::BC7;
+            else if (format == "rgba8") options.encoding = vex::TextureEncoding::RGBA8;
+            else {
+                std::cerr << "Unknown format: " << format << "\n";
+                printUsage();
+                return 1;
+            }
+        } else if (arg == "--no-mips") {
+            options.generateMips = false;
+        } else if (!arg.empty() && arg[0] == '-') {
+            printUsage();
+            return 1;
+        } else {
+            positional.push_back(arg);
+        }
+    }
+
+    TextureCooker cooker(options);
+
+    if (!directory.empty()) {
+        return cooker.cookDirectory(directory) == 0 ? 0 : 1;
+    }
+
+    if (positional.empty() || positional.size() > 2) {
+        printUsage();
+        return 1;
+    }
+
+    std::string output = positional.size() == 2
+        ? positional[1]
+        : std::filesystem::path(positional[0]).replace_extension(vex::TEXTURE_CONTAINER_EXTENSION).string();
+
+    CookReport report;
+    return cooker.cook(positional[0], output, report) ? 0 : 1;
+}
@@ -173,9 +173,30 @@ void PerformSafeClean(const std::filesystem::path& projectDir) {
     }
 }
 
-bool EnsureSharedEngineBuilt(const std::filesystem::path& projectDir, const std::string& buildType, const std::string& parallel, bool is_dist = false) {
+std::string GetEngineConfig(const std::string& buildType) {
+    return (buildType == "-d" || buildType == "-debug") ? "Debug" : "Release";
+}
+
+std::filesystem::path GetEngineBinDir(const std::filesystem::path& projectDir, const std::string& buildType, bool is_dist) {
+    std::filesystem::path enginePath = std::filesystem::weakly_canonical(projectDir / GetEngineCorePath());
 
+    std::string outputDirName = GetEngineConfig(buildType);
+    if (outputDirName == "Release" && is_dist) {
+        outputDirName = "Distribution";
+    }
+
+    return enginePath / "bin" / outputDirName;
+}
+
+std::filesystem::path GetMeshCookerPath(const std::filesystem::path& engineBinDir) {
+    #ifdef _WIN32
+        return engineBinDir / "MeshCooker.exe";
+    #else
+        return engineBinDir / "MeshCooker";
+    #endif
+}
 
+bool EnsureSharedEngineBuilt(const std::filesystem::path& projectDir, const std::string& buildType, const std::string& parallel, bool is_dist = false) {
     std::string engineRelPath = GetEngineCorePath();
     if (engineRelPath.empty()) {
         std::cerr << "Error: Could not find engine path";
@@ -183,19 +204,8 @@ bool EnsureSharedEngineBuilt(const std::filesystem::path& projectDir, const std:
     }
 
     std::filesystem::path enginePath = std::filesystem::weakly_canonical(projectDir / engineRelPath);
-
-    std::string cmakeConfig = "Release";
-    std::string outputDirName = "Release";
-
-    if (buildType == "-d" || buildType == "-debug") {
-        cmakeConfig = "Debug";
-        outputDirName = "Debug";
-    } else if (is_dist) {
-        cmakeConfig = "Release";
-        outputDirName = "Distribution";
-    }
-
-    std::filesystem::path engineBuildDir = enginePath / "bin" / outputDirName;
+    std::string cmakeConfig = GetEngineConfig(buildType);
+    std::filesystem::path engineBuildDir = GetEngineBinDir(projectDir, buildType, is_dist);
     std::filesystem::path targetFile = engineBuildDir / "VEXTargets.cmake";
 
     #ifdef __linux__
@@ -204,37 +214,63 @@ bool EnsureSharedEngineBuilt(const std::filesystem::path& projectDir, const std:
         std::filesystem::path libFile = engineBuildDir / "VEX.dll";
     #endif
 
-    if (std::filesystem::exists(targetFile) && std::filesystem::exists(libFile)) {
-        return true;
-    }
+    if (!std::filesystem::exists(targetFile) || !std::filesystem::exists(libFile)) {
+        std::cout << ">> Shared VEX Engine (" << engineBuildDir.filename().string() << ") missing. Building it now...\n";
+        std::cout << ">> Engine Path: " << enginePath.string() << "\n";
 
-    std::cout << ">> Shared VEX Engine (" << outputDirName << ") missing. Building it now...\n";
-    std::cout << ">> Engine Path: " << enginePath.string() << "\n";
+        std::filesystem::create_directories(engineBuildDir);
 
-    std::filesystem::create_directories(engineBuildDir);
+        std::string configCmd = "cmake -G Ninja -S \"" + enginePath.string() + "\" -B \"" + engineBuildDir.string() +
+                                "\" -DCMAKE_BUILD_TYPE=" + cmakeConfig + " -DCMAKE_C_COMPILER=clang -DCMAKE_CXX_COMPILER=" + GetCXXCompiler();
 
-    std::filesystem::path cmakeSource = enginePath;
+        if (is_dist) {
+            configCmd += " -DVEX_DIST_BUILD=ON";
+        }
 
-    std::string configCmd = "cmake -G Ninja -S \"" + cmakeSource.string() + "\" -B \"" + engineBuildDir.string() +
-                            "\" -DCMAKE_BUILD_TYPE=" + cmakeConfig + " -DCMAKE_C_COMPILER=clang -DCMAKE_CXX_COMPILER=" + GetCXXCompiler();
+        if (std::system(configCmd.c_str()) != 0) {
+            std::cerr << "Engine Configuration Failed.\n";
+            return false;
+        }
 
-    if (is_dist) {
-        configCmd += " -DVEX_DIST_BUILD=ON";
+        // Only what the game links and copies, benchmarks and tests stay out even when the build dir was configured with them.
+        std::string buildCmd = "cmake --build \"" + engineBuildDir.string() + "\" --config " + cmakeConfig + " --target VEX compile_shaders " + parallel;
+        if (std::system(buildCmd.c_str()) != 0) {
+            std::cerr << "Engine Build Failed.\n";
+            return false;
+        }
+
+        std::cout << ">> Engine built successfully.\n";
     }
 
-    if (std::system(configCmd.c_str()) != 0) {
-        std::cerr << "Engine Configuration Failed.\n";
-        return false;
+    // Built on every run, Ninja makes it a no-op when MeshCooker is up to date and rebuilds it when the engine changed.
+    std::string cookerCmd = "cmake --build \"" + engineBuildDir.string() + "\" --config " + cmakeConfig + " --target MeshCooker " + parallel;
+    if (std::system(cookerCmd.c_str()) != 0) {
+        std::cerr << ">> Warning: MeshCooker build failed, meshes will be imported at runtime.\n";
     }
+    return true;
+}
 
-    std::string buildCmd = "cmake --build \"" + engineBuildDir.string() + "\" --config " + cmakeConfig + " " + parallel;
-    if (std::system(buildCmd.c_str()) != 0) {
-        std::cerr << "Engine Build Failed.\n";
-        return false;
+// Cooks every mesh of the copied project into a .vmesh next to it, so the game doesn't import them with Assimp at runtime.
+void CookMeshes(const std::filesystem::path& engineBinDir, const std::filesystem::path& assetsDir) {
+    if (!std::filesystem::exists(assetsDir)) {
+        return;
     }
 
-    std::cout << ">> Engine built successfully.\n";
-    return true;
+    std::filesystem::path cooker = GetMeshCookerPath(engineBinDir);
+    if (!std::filesystem::exists(cooker)) {
+        std::cerr << ">> Warning: MeshCooker not found at " << cooker.string() << ", meshes will be imported at runtime.\n";
+        return;
+    }
+
+    std::string cmd = "\"" + cooker.string() + "\" --dir \"" + assetsDir.string() + "\"";
+    #ifdef _WIN32
+        cmd = "\"" + cmd + "\"";
+    #endif
+
+    std::cout << ">> Cooking meshes...\n";
+    if (std::system(cmd.c_str()) != 0) {
+        std::cerr << ">> Warning: Some meshes failed to cook, they will be imported at runtime.\n";
+    }
 }
 
 int main(int argc, char* argv[]) {
@@ -334,6 +370,8 @@ int main(int argc, char* argv[]) {
     }
     std::filesystem::copy(module_src, module_dest);
 
+    CookMeshes(GetEngineBinDir(project_dir, build_type, is_dist), intermediate_dir / "Assets");
+
     // Change working directory to Intermediate
     try {
         std::filesystem::current_path(intermediate_dir);
@@ -9,7 +9,7 @@ cmake -B "$BUILD_DIR" -G "Ninja" -DCMAKE_C_COMPILER=clang -DCMAKE_CXX_COMPILER=c
 cmake --build "$BUILD_DIR"
 
 echo "Creating global commands (Sudo password required)..."
-TOOLS=("VPAK_Packer" "ProjectBuilder" "VexCrashDecoder")
+TOOLS=("VPAK_Packer" "ProjectBuilder" "VexCrashDecoder" "TextureCooker")
 ABS_BUILD_DIR=$(cd "$BUILD_DIR" && pwd)
 
 for tool in "${TOOLS[@]}"; do
@@ -24,7 +24,11 @@
 #include "components/enviroment.hpp"
 #include "components/UI/VexUI.hpp"
 #include "components/PhysicsSystem.hpp"
+#include "components/TransformSystem.hpp"
+#include "components/HierarchySystem.hpp"
+#include "components/SystemScheduler.hpp"
 #include "components/AudioSystem.hpp"
+#include "components/DynamicAABBTree.hpp"
 
 #include "VEX/VEX_export.h"
 
@@ -51,11 +55,14 @@ public:
     /// 4. Vulkan Interface (Renderer) and ImGui wrapper.
     /// 5. InputSystem and SceneManager.
     /// @note Detects Wayland on Linux to enforce software VSync strategies if necessary.
+    /// @note Headless engine opens a hidden window on SDL's `offscreen` or `dummy` video driver and renders into offscreen images, so it runs on machines
+    /// without a display, e.g. CI with lavapipe. Frames can be read back through `Interface::readbackFrame`.
     /// @param const char* title - Title of the game window.
     /// @param int width - Initial width of the game window.
     /// @param int height - Initial height of the game window.
     /// @param GameInfo gInfo - Game Info struct containing versioning and metadata.
-    Engine(const char* title, int width, int height, GameInfo gInfo);
+    /// @param bool headless - Render without a visible window or swapchain.
+    Engine(const char* title, int width, int height, GameInfo gInfo, bool headless = false);
     ~Engine();
 
     /// @brief Starts and runs the main game loop.
@@ -118,9 +125,21 @@ public:
     /// @brief Returns pointer to PhysicsSystem.
     PhysicsSystem* getPhysicsSystem() { return m_physicsSystem.get(); }
 
+    /// @brief Returns scheduler of ECS systems, they run every unpaused frame after GameObject updates and before physics.
+    /// @details Systems declaring components that don't conflict run in parallel, see `SystemScheduler`.
+    /// @code
+    /// GetEngine().getSystemScheduler().addSystem("Spin", SystemAccess().write<TransformComponent>().read<SpinComponent>(),
+    ///     [](entt::registry& registry, float deltaTime) { ... });
+    /// @endcode
+    SystemScheduler& getSystemScheduler() { return *m_systemScheduler; }
+
     /// @brief Returns pointer to SceneManager.
     SceneManager* getSceneManager();
 
+    /// @brief Returns bounding volume hierarchy of all rendered meshes for AABB, sphere and ray queries.
+    /// @details Query callbacks receive `entt::to_integral(entity)`. Bounds are refit during rendering, so they lag one frame behind update.
+    const DynamicAABBTree& getSpatialTree();
+
     /// @brief Creates and returns a shared pointer to a VexUI instance.
     /// @details Constructs a VexUI object linked to the current Vulkan context, VFS, and resource manager.
     /// @return std::shared_ptr<VexUI> - A ready-to-use UI instance.
@@ -200,9 +219,16 @@ public:
     /// @brief Returns the time since last frame.
     float getDeltaTime() const { return m_deltaTime; }
 
+    /// @brief Returns true if the engine renders into offscreen images instead of a window.
+    bool isHeadless() const { return m_headless; }
+
     /// @brief Returns the audio system.
     std::shared_ptr<AudioSystem> getAudioSystem() const { return m_audioSystem; }
 
+    /// @brief Sets the key starting and stopping a CPU profiler capture, written to `profile_<time>.json` next to the executable.
+    /// @param SDL_Keycode key - Capture key, `SDLK_UNKNOWN` disables it. F10 by default.
+    void setProfilerCaptureKey(SDL_Keycode key) { m_profilerCaptureKey = key; }
+
 protected:
 
     /// @brief Alternative constructor for editor to skip default init code.
@@ -217,6 +243,10 @@ protected:
     std::unique_ptr<ImGUIWrapper> m_imgui;
     std::unique_ptr<InputSystem> m_inputSystem;
     std::unique_ptr<PhysicsSystem> m_physicsSystem;
+    std::unique_ptr<TransformSystem> m_transformSystem;
+    std::unique_ptr<HierarchySystem> m_hierarchySystem;
+    std::unique_ptr<JobPool> m_jobPool;
+    std::unique_ptr<SystemScheduler> m_systemScheduler;
     std::unique_ptr<SceneManager> m_sceneManager;
 
     entt::registry m_registry;
@@ -225,10 +255,12 @@ protected:
     bool m_paused = false;
     bool m_internally_paused = false; // to pause if the window is in the background.
     bool m_renderPhysicsDebug = false;
+    bool m_headless = false;
     int m_frame = 0;
 
     int m_targetFps = 0;
     bool m_vsyncEnabled = false;
+    SDL_Keycode m_profilerCaptureKey = SDLK_F10;
 
     float m_deltaTime = 0.016f;
 
@@ -0,0 +1,232 @@
+/**
+ *  @file   DynamicAABBTree.hpp
+ *  @brief  This file defines DynamicAABBTree class, bounding volume hierarchy used for culling and spatial queries.
+ *  @author Eryk Roszkowski
+ ***********************************************/
+
+#pragma once
+#include <glm/glm.hpp>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace vex {
+    /// @brief Axis aligned bounding box.
+    struct AABB {
+        glm::vec3 min = glm::vec3(0.0f);
+        glm::vec3 max = glm::vec3(0.0f);
+
+        /// @brief Creates box enclosing a sphere.
+        static AABB fromSphere(const glm::vec3& center, float radius) {
+            return { center - glm::vec3(radius), center + glm::vec3(radius) };
+        }
+
+        /// @brief Returns smallest box enclosing both boxes.
+        static AABB merge(const AABB& a, const AABB& b) {
+            return { glm::min(a.min, b.min), glm::max(a.max, b.max) };
+        }
+
+        /// @brief Returns true if `other` is fully inside this box.
+        bool contains(const AABB& other) const {
+            return glm::all(glm::lessThanEqual(min, other.min)) && glm::all(glm::greaterThanEqual(max, other.max));
+        }
+
+        /// @brief Returns true if boxes touch or overlap.
+        bool overlaps(const AABB& other) const {
+            return glm::all(glm::lessThanEqual(min, other.max)) && glm::all(glm::greaterThanEqual(max, other.min));
+        }
+
+        /// @brief Returns half of surface area, used as insertion cost.
+        float perimeter() const {
+            glm::vec3 d = max - min;
+            return d.x * d.y + d.y * d.z + d.z * d.x;
+        }
+    };
+
+    /// @brief Result of testing a box against a set of planes.
+    enum class CullResult {
+        OUTSIDE,
+        INTERSECTING,
+        INSIDE
+    };
+
+    /// @brief Incrementally updated bounding volume hierarchy of AABBs.
+    /// @details Leaves store enlarged ("fat") boxes so small movements don't touch the tree, `moveProxy` only reinserts a leaf once it leaves its fat box.
+    /// Inner nodes are kept balanced with tree rotations on insert and remove.
+    /// Each proxy carries a `uint32_t` user value (e.g. `entt::to_integral(entity)`) passed back by queries.
+    /// Queries walk the tree without allocating once their stack has grown. The tree is not thread safe, but concurrent queries without updates are fine if each uses its own stack.
+    class DynamicAABBTree {
+    public:
+        /// @brief Returned when a proxy does not exist.
+        static constexpr int32_t NULL_NODE = -1;
+
+        /// @brief Constructor for DynamicAABBTree.
+        /// @param float margin - Minimal enlargement of leaf boxes in world units, boxes also grow by 10% of their size.
+        explicit DynamicAABBTree(float margin = 0.1f);
+
+        /// @brief Adds a box to the tree.
+        /// @param const AABB& aabb - Tight bounds of the object.
+        /// @param uint32_t userData - Value returned by queries.
+        /// @return int32_t - Proxy id used to move or remove the box.
+        int32_t createProxy(const AABB& aabb, uint32_t userData);
+
+        /// @brief Removes a box from the tree.
+        /// @param int32_t proxyId - Proxy returned by `createProxy`.
+        void destroyProxy(int32_t proxyId);
+
+        /// @brief Updates bounds of a proxy.
+        /// @param int32_t proxyId - Proxy returned by `createProxy`.
+        /// @param const AABB& aabb - New tight bounds.
+        /// @return bool - True if the leaf had to be reinserted.
+        bool moveProxy(int32_t proxyId, const AABB& aabb);
+
+        /// @brief Returns user value of a proxy.
+        uint32_t getUserData(int32_t proxyId) const { return m_nodes[proxyId].userData; }
+
+        /// @brief Returns fat box of a proxy.
+        const AABB& getFatAABB(int32_t proxyId) const { return m_nodes[proxyId].aabb; }
+
+        /// @brief Returns number of proxies in the tree.
+        uint32_t getProxyCount() const { return m_proxyCount; }
+
+        /// @brief Returns height of the tree, 0 for a single leaf.
+        int32_t getHeight() const { return m_root == NULL_NODE ? 0 : m_nodes[m_root].height; }
+
+        /// @brief Removes all proxies.
+        void clear();
+
+        /// @brief Calls `callback(userData)` for every proxy whose fat box overlaps `aabb`.
+        /// @details Callback returns `false` to stop the query.
+        template <typename Callback>
+        void queryAABB(const AABB& aabb, Callback&& callback) const {
+            traverse([&](const AABB& box) { return box.overlaps(aabb); },
+                     [&](int32_t node) { return callback(m_nodes[node].userData); });
+        }
+
+        /// @brief Calls `callback(userData)` for every proxy whose fat box overlaps the sphere.
+        /// @details Callback returns `false` to stop the query.
+        template <typename Callback>
+        void querySphere(const glm::vec3& center, float radius, Callback&& callback) const {
+            const float radiusSqr = radius * radius;
+            traverse([&](const AABB& box) {
+                         glm::vec3 d = glm::clamp(center, box.min, box.max) - center;
+                         return glm::dot(d, d) <= radiusSqr;
+                     },
+                     [&](int32_t node) { return callback(m_nodes[node].userData); });
+        }
+
+        /// @brief Calls `callback(userData, float distance)` for every proxy whose fat box is hit by the ray, in no particular order.
+        /// @details `distance` is the entry distance along `direction` (not normalized). Callback returns `false` to stop the query.
+        /// @param const glm::vec3& origin - Ray origin.
+        /// @param const glm::vec3& direction - Ray direction.
+        /// @param float maxDistance - Ray length in units of `direction`.
+        template <typename Callback>
+        void queryRay(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, Callback&& callback) const {
+            const glm::vec3 invDir = 1.0f / direction;
+            float hitDistance = 0.0f;
+            auto hit = [&](const AABB& box) {
+                glm::vec3 t0 = (box.min - origin) * invDir;
+                glm::vec3 t1 = (box.max - origin) * invDir;
+                glm::vec3 tMin = glm::min(t0, t1);
+                glm::vec3 tMax = glm::max(t0, t1);
+                float enter = glm::max(glm::max(tMin.x, tMin.y), glm::max(tMin.z, 0.0f));
+                float exit = glm::min(glm::min(tMax.x, tMax.y), glm::min(tMax.z, maxDistance));
+                hitDistance = enter;
+                return enter <= exit;
+            };
+            traverse(hit, [&](int32_t node) { return callback(m_nodes[node].userData, hitDistance); });
+        }
+
+        /// @brief Hierarchical culling against planes (`xyz` = normal pointing inside, `w` = distance).
+        /// @details Calls `callback(userData, bool fullyInside)` for every proxy not fully outside.
+        /// Subtrees fully inside all planes are reported without further tests, `fullyInside` false means the caller may want an exact test.
+        template <typename Callback>
+        void queryPlanes(const std::array<glm::vec4, 6>& planes, Callback&& callback) const {
+            if (m_root == NULL_NODE) return;
+
+            m_stack.clear();
+            m_stack.push_back({ m_root, false });
+
+            while (!m_stack.empty()) {
+                auto [nodeId, inside] = m_stack.back();
+                m_stack.pop_back();
+                const Node& node = m_nodes[nodeId];
+
+                if (!inside) {
+                    CullResult result = cullAABB(node.aabb, planes);
+                    if (result == CullResult::OUTSIDE) continue;
+                    inside = result == CullResult::INSIDE;
+                }
+
+                if (node.isLeaf()) {
+                    if (!callback(node.userData, inside)) return;
+                } else {
+                    m_stack.push_back({ node.child1, inside });
+                    m_stack.push_back({ node.child2, inside });
+                }
+            }
+        }
+
+        /// @brief Tests a box against planes (`xyz` = normal pointing inside, `w` = distance).
+        static CullResult cullAABB(const AABB& box, const std::array<glm::vec4, 6>& planes);
+
+    private:
+        /// @brief Single tree node, leaves have `child1 == NULL_NODE`.
+        struct Node {
+            AABB aabb;
+            int32_t parent = NULL_NODE; // next free node when unused
+            int32_t child1 = NULL_NODE;
+            int32_t child2 = NULL_NODE;
+            int32_t height = -1;        // -1 when unused
+            uint32_t userData = 0;
+
+            bool isLeaf() const { return child1 == NULL_NODE; }
+        };
+
+        /// @brief Entry of traversal stack.
+        struct StackEntry {
+            int32_t node;
+            bool inside;
+        };
+
+        /// @brief Generic depth first walk, `test(box)` decides whether to descend, `visit(node)` is called for leaves.
+        template <typename Test, typename Visit>
+        void traverse(Test&& test, Visit&& visit) const {
+            if (m_root == NULL_NODE) return;
+
+            m_stack.clear();
+            m_stack.push_back({ m_root, false });
+
+            while (!m_stack.empty()) {
+                int32_t nodeId = m_stack.back().node;
+                m_stack.pop_back();
+                const Node& node = m_nodes[nodeId];
+
+                if (!test(node.aabb)) continue;
+
+                if (node.isLeaf()) {
+                    if (!visit(nodeId)) return;
+                } else {
+                    m_stack.push_back({ node.child1, false });
+                    m_stack.push_back({ node.child2, false });
+                }
+            }
+        }
+
+        int32_t allocateNode();
+        void freeNode(int32_t nodeId);
+        void insertLeaf(int32_t leaf);
+        void removeLeaf(int32_t leaf);
+        int32_t balance(int32_t nodeId);
+        AABB fatten(const AABB& aabb) const;
+
+        std::vector<Node> m_nodes;
+        int32_t m_root = NULL_NODE;
+        int32_t m_freeList = NULL_NODE;
+        uint32_t m_proxyCount = 0;
+        float m_margin;
+
+        mutable std::vector<StackEntry> m_stack;
+    };
+}
@@ -22,14 +22,32 @@
 #include "components/errorUtils.hpp"
 #include "components/colorTypes.hpp"
 #include "components/assetTypes.hpp"
+#include "components/Handle.hpp"
 #include "entt/entity/fwd.hpp"
 
 #include "components/errorUtils.hpp"
 
 namespace vex{
 
+class TransformSystem;
+class HierarchySystem;
+
+/// @brief Struct linking an entity to its parent and its children, so they can be walked without scanning the registry.
+/// @details Children form an intrusive doubly linked list through `nextSibling` and `prevSibling`. Maintained by `HierarchySystem`
+/// from `TransformComponent` parents, don't edit it directly.
+struct RelationshipComponent {
+    entt::entity parent = entt::null;
+    entt::entity firstChild = entt::null;
+    entt::entity nextSibling = entt::null;
+    entt::entity prevSibling = entt::null;
+    uint32_t childCount = 0;
+};
+
 /// @brief Struct containing transform data and methods.
 struct TransformComponent {
+    friend class TransformSystem;
+    friend class HierarchySystem;
+
     #ifdef DEBUG
     public:
     glm::vec3 position = {0.0f, 0.0f, 0.0f};
@@ -107,12 +125,15 @@ struct TransformComponent {
             return false;
         }
 
+        if (lastTransformed) return true;
+
         if (parent != entt::null && m_registry->valid(parent) && m_registry->all_of<TransformComponent>(parent)) {
             result = m_registry->get<TransformComponent>(parent).transformedLately();
         }
-        return (lastTransformed || result);
+        return result;
     }
 
+    /// @brief Check if the transform or any of its parents changed since `TransformSystem` last updated world matrices.
     bool isDirty(){
         bool result = false;
 
@@ -121,10 +142,12 @@ struct TransformComponent {
             return false;
         }
 
+        if (dirty) return true;
+
         if (parent != entt::null && m_registry->valid(parent) && m_registry->all_of<TransformComponent>(parent)) {
             result = m_registry->get<TransformComponent>(parent).isDirty();
         }
-        return (dirty || result);
+        return result;
     }
 
     void setRegistry(entt::registry& reg) {
@@ -165,9 +188,9 @@ struct TransformComponent {
     }
 
     /// @brief Set the parent entity.
-    void setParent(entt::entity newParent) {
-        parent = newParent;
-    }
+    /// @details Goes through `HierarchySystem::setParent`, so children of the old and new parent are kept in sync. Reparenting to
+    /// a descendant or an invalid entity is refused.
+    void setParent(entt::entity newParent);
 
     /// @brief Get the parent entity.
     entt::entity getParent() const {
@@ -234,11 +257,20 @@ struct TransformComponent {
 
     // --------------------------------------------------
 
+    /// @brief Returns the local matrix, translation * rotation * scale.
+    /// @return glm::mat4
+    glm::mat4 localMatrix() const {
+        const glm::mat3 rotationMatrix = glm::mat3_cast(m_rotationQuat);
+        return glm::mat4(
+            glm::vec4(rotationMatrix[0] * scale.x, 0.0f),
+            glm::vec4(rotationMatrix[1] * scale.y, 0.0f),
+            glm::vec4(rotationMatrix[2] * scale.z, 0.0f),
+            glm::vec4(position, 1.0f));
+    }
+
+    /// @brief Recomputes the world matrix through the parent chain and caches it.
     glm::mat4 recalculateMatrix(){
-        glm::mat4 local = glm::mat4(1.0f);
-        local = glm::translate(local, position);
-        local *= glm::mat4_cast(m_rotationQuat);
-        local = glm::scale(local, scale);
+        const glm::mat4 local = localMatrix();
 
         if (parent != entt::null && m_registry && m_registry->valid(parent) && m_registry->all_of<TransformComponent>(parent)) {
             cachedMatrix = m_registry->get<TransformComponent>(parent).recalculateMatrix() * local;
@@ -249,17 +281,23 @@ struct TransformComponent {
         return cachedMatrix;
     }
 
-    /// @brief Method used by renderer to calculate the transformation matrix.
+    /// @brief Method to get the world matrix, recalculated through the parent chain if anything in it changed since the last `TransformSystem` update.
+    /// @details Dirty flags are only cleared by `TransformSystem`, which also passes them on to children.
     /// @param bool forceRecalculate if force recalculate
     glm::mat4 matrix(bool forceRecalculate = false) {
         if(isDirty() || forceRecalculate){
-            dirty = false;
             return recalculateMatrix();
         }
 
         return cachedMatrix;
     }
 
+    /// @brief Returns the world matrix computed by the last `TransformSystem` update without checking parents. Used by the renderer, which runs right after that update.
+    /// @return const glm::mat4&
+    const glm::mat4& getWorldMatrix() const {
+        return cachedMatrix;
+    }
+
     /// @brief Method to get world position, needed when object is parented as position parameter stores local position.
     /// @return glm::vec3
     glm::vec3 getWorldPosition() {
@@ -417,9 +455,10 @@ enum class RenderType {
 /// @brief Struct containing raw meshData, mesh id, texture paths and material properties. It just template and data for rendering backend to load/convert this data to its acceptible format. This is made weirdly cause its made in mind for multiple backends. IDK i hate this system but i have no better idea.
 struct MeshComponent {
     // Render Data
+    /// @brief Path and vertex format of the mesh. Submeshes are only filled on components built by hand, adding such a component to an entity moves them into
+    /// the mesh cache shared by every component with the same path, see `MeshManager::getMeshData`.
     MeshData meshData;
     uint32_t id = UINT32_MAX;
-    std::vector<std::string> textureNames;
     RenderType renderType = RenderType::OPAQUE;
     vex::rgba color = glm::vec4(1.f);
 
@@ -432,6 +471,12 @@ struct MeshComponent {
     glm::vec3 worldCenter = glm::vec3(0.0f);
     float worldRadius = 1.0f;
 
+    /// @brief Level of detail picked by the renderer last frame, 0 is full detail. Not saved, it only exists to keep selection stable between frames.
+    uint32_t lod = 0;
+
+    /// @brief (used internally by the engine) Uploaded mesh of `meshData.meshPath`, resolved once when the component is bound so drawing doesn't look meshes up by path. Not saved.
+    MeshHandle meshHandle;
+
     /// @brief (used internally by the engine, DO NOT CALL) returns true if the component is fresh.
     bool getIsFresh(){
         return fresh;
@@ -24,8 +24,9 @@ namespace vex {
     /// @brief Just creates meshcomponent from file. Copies meshData and texture paths for later backend specific processing.
     /// @param const std::string& path Path to the mesh file.
     /// @param Engine& engine Reference to the engine.
+    /// @param VertexFormat format Vertex layout used on the GPU, `COMPACT` halves vertex memory at the cost of small precision loss.
     /// @return MeshComponent created from the file.
-    MeshComponent createMeshFromPath(const std::string& path, Engine& engine);
+    MeshComponent createMeshFromPath(const std::string& path, Engine& engine, VertexFormat format = VertexFormat::STANDARD);
 
     /// @brief Creates model object from file. Esentially just runs two other functions just with empty transform component.
     /// @param const std::string& path Path to the mesh file.
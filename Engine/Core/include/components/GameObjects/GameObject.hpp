@@ -12,6 +12,7 @@
   #include "components/errorUtils.hpp"
 
   #include "components/GameComponents/BasicComponents.hpp"
+  #include "components/HierarchySystem.hpp"
   #include "../../../thirdparty/uuid/UUID.hpp"
 
   namespace vex {
@@ -43,7 +44,7 @@
     /// @brief Destroys the GameObject and removes it from the engine's registry.
     /// @details
     /// 1. Checks validity to prevent double deletion.
-    /// 2. Iterates `TransformComponent`s to find children and unparents them (sets parent to `entt::null`).
+    /// 2. Destroys the entity, `HierarchySystem` unparents its children (sets parent to `entt::null`) walking only their list.
     /// 3. Destroys the entity in the registry and marks this object as invalid.
     void Destroy();
 
@@ -85,14 +86,20 @@
 
       /// @brief Function that parent this Object to another GameObject. You need to pass another GameObject's entity.
       /// @param entt::entity entity - Entity of GameObject we want to parent to.
-      /// @details Helper function that retrieves the `TransformComponent` of this object and calls `setParent` with the provided entity ID.
+      /// @details Helper function that calls `HierarchySystem::setParent`, which also sets parent of the `TransformComponent`. Parenting to own descendant is refused.
       /// @code
       /// GameObject* parent = new GameObject();
       /// GameObject* child = new GameObject();
       /// child->ParentTo(parent->GetEntity());
       /// @endcode
       void ParentTo(entt::entity entity){
-          GetComponent<TransformComponent>().setParent(entity);
+          HierarchySystem::setParent(m_engine.getRegistry(), m_entity, entity);
+      }
+
+      /// @brief Function that returns entities parented directly to this Object.
+      /// @return std::vector<entt::entity> - Children entities, most recently parented first.
+      std::vector<entt::entity> GetChildren() const {
+          return HierarchySystem::getChildren(m_engine.getRegistry(), m_entity);
       }
 
       /// @brief Function that sets the type of the GameObject.
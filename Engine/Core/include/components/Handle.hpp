@@ -0,0 +1,141 @@
+/**
+ *  @file   Handle.hpp
+ *  @brief  This file defines generational handles and HandlePool, used to reference GPU resources without string lookups.
+ *  @author Eryk Roszkowski
+ ***********************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace vex {
+    /// @brief Slot index plus generation of the object living in it.
+    /// @details Generation changes whenever the slot is freed, so a handle kept after its object was destroyed is detected as stale instead of
+    /// silently pointing at whatever reused the slot. Default constructed handle is null. `Tag` only keeps handles of different resources apart.
+    template <typename Tag>
+    struct Handle {
+        /// @brief Index of a null handle.
+        static constexpr uint32_t NULL_INDEX = UINT32_MAX;
+
+        uint32_t index = NULL_INDEX;
+        uint32_t generation = 0;
+
+        /// @brief Returns true if handle was never assigned. A non null handle can still be stale.
+        bool isNull() const { return index == NULL_INDEX; }
+
+        bool operator==(const Handle&) const = default;
+    };
+
+    struct MeshHandleTag {};
+    struct TextureHandleTag {};
+
+    /// @brief Handle of a mesh uploaded by MeshManager.
+    using MeshHandle = Handle<MeshHandleTag>;
+
+    /// @brief Handle of a texture slot of VulkanResources, its index is the bindless texture index.
+    using TextureHandle = Handle<TextureHandleTag>;
+
+    /// @brief Array of objects addressed by generational handles, lookup is one bounds check and one generation compare.
+    /// @details Freed slots are reused, objects don't move while they are alive unless the pool grows. Not thread safe, but concurrent `get` without inserts or erases is fine.
+    /// A slot whose generation reaches `MaxGeneration` is retired instead of wrapping back to a generation an old handle may still carry.
+    /// `MaxGeneration` only exists so tests can reach the limit without billions of erases.
+    template <typename T, typename Tag, uint32_t MaxGeneration = UINT32_MAX>
+    class HandlePool {
+        static_assert(MaxGeneration > 1, "a slot needs at least one generation above the default handle");
+
+    public:
+        using HandleType = Handle<Tag>;
+
+        /// @brief Stores object in a free slot.
+        /// @param T value
+        /// @return HandleType
+        HandleType insert(T value) {
+            uint32_t index;
+            if (!m_freeSlots.empty()) {
+                index = m_freeSlots.back();
+                m_freeSlots.pop_back();
+            } else {
+                index = static_cast<uint32_t>(m_slots.size());
+                m_slots.emplace_back();
+            }
+
+            Slot& slot = m_slots[index];
+            slot.value = std::move(value);
+            slot.alive = true;
+            m_count++;
+            return { index, slot.generation };
+        }
+
+        /// @brief Destroys object and invalidates every handle pointing at it.
+        /// @param HandleType handle
+        /// @return bool - false if handle was already stale.
+        bool erase(HandleType handle) {
+            if (!contains(handle)) return false;
+
+            Slot& slot = m_slots[handle.index];
+            slot.value = T{};
+            slot.alive = false;
+            slot.generation++;
+            if (slot.generation < MaxGeneration) {
+                m_freeSlots.push_back(handle.index);
+            } else {
+                m_retiredCount++;
+            }
+            m_count--;
+            return true;
+        }
+
+        /// @brief Returns object a handle points to.
+        /// @param HandleType handle
+        /// @return T* - nullptr if handle is null or stale.
+        T* get(HandleType handle) {
+            return contains(handle) ? &m_slots[handle.index].value : nullptr;
+        }
+
+        /// @brief Returns object a handle points to.
+        /// @param HandleType handle
+        /// @return const T* - nullptr if handle is null or stale.
+        const T* get(HandleType handle) const {
+            return contains(handle) ? &m_slots[handle.index].value : nullptr;
+        }
+
+        /// @brief Returns true if handle points at a live object.
+        /// @param HandleType handle
+        /// @return bool
+        bool contains(HandleType handle) const {
+            return handle.index < m_slots.size() && m_slots[handle.index].alive && m_slots[handle.index].generation == handle.generation;
+        }
+
+        /// @brief Returns number of live objects.
+        /// @return size_t
+        size_t size() const { return m_count; }
+
+        /// @brief Returns number of slots that ran out of generations and are never reused.
+        /// @return size_t
+        size_t retiredCount() const { return m_retiredCount; }
+
+        /// @brief Destroys all objects, handles given out so far become stale.
+        void clear() {
+            for (uint32_t index = 0; index < m_slots.size(); index++) {
+                if (m_slots[index].alive) {
+                    erase({ index, m_slots[index].generation });
+                }
+            }
+        }
+
+    private:
+        struct Slot {
+            T value{};
+            uint32_t generation = 1; // starts above the default handle generation
+            bool alive = false;
+        };
+
+        std::vector<Slot> m_slots;
+        std::vector<uint32_t> m_freeSlots;
+        size_t m_count = 0;
+        size_t m_retiredCount = 0;
+    };
+}
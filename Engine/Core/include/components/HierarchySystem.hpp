@@ -0,0 +1,83 @@
+/**
+ *  @file   HierarchySystem.hpp
+ *  @brief  This file defines HierarchySystem class keeping parent and child links of entities in `RelationshipComponent`s.
+ *  @author Eryk Roszkowski
+ ***********************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <entt/entt.hpp>
+
+#include "components/GameComponents/BasicComponents.hpp"
+
+namespace vex {
+
+    /// @brief Keeps `RelationshipComponent`s in sync with `TransformComponent` parents.
+    /// @details Reparenting, enumerating children and destroying an entity cost O(children) instead of a scan over every transform.
+    /// Transforms constructed or replaced with a parent are linked by signal handlers, destroyed entities are unlinked from their
+    /// parent and their children become roots. `TransformComponent::setParent` calls `setParent`, so every reparent goes through here.
+    class HierarchySystem {
+    public:
+        /// @brief Constructor for HierarchySystem, connects to construction, replacement and destruction signals of the registry.
+        /// @param entt::registry& registry - Registry holding the entities, has to outlive the system.
+        HierarchySystem(entt::registry& registry);
+
+        HierarchySystem(const HierarchySystem&) = delete;
+        HierarchySystem& operator=(const HierarchySystem&) = delete;
+
+        /// @brief Moves `child` under `parent`, or makes it a root when `parent` is `entt::null`. Also sets the transform parent.
+        /// @param entt::registry& registry - Registry holding both entities.
+        /// @param entt::entity child - Entity to reparent.
+        /// @param entt::entity parent - New parent, has to be valid and not `child` or one of its descendants.
+        /// @return bool - False if the parent was refused, nothing is changed then.
+        static bool setParent(entt::registry& registry, entt::entity child, entt::entity parent);
+
+        /// @brief Returns parent of the entity, `entt::null` for roots.
+        /// @return entt::entity
+        static entt::entity getParent(const entt::registry& registry, entt::entity entity);
+
+        /// @brief Returns number of direct children of the entity.
+        /// @return uint32_t
+        static uint32_t getChildCount(const entt::registry& registry, entt::entity entity);
+
+        /// @brief Returns direct children of the entity, most recently attached first.
+        /// @return std::vector<entt::entity>
+        static std::vector<entt::entity> getChildren(const entt::registry& registry, entt::entity entity);
+
+        /// @brief Calls `func(entt::entity)` for every direct child. The next child is read before the call, so `func` may reparent or destroy the current one.
+        /// @param const entt::registry& registry - Registry holding the entity.
+        /// @param entt::entity entity - Parent whose children are visited.
+        /// @param Func&& func - Callable taking the child entity.
+        template <typename Func>
+        static void forEachChild(const entt::registry& registry, entt::entity entity, Func&& func) {
+            const auto* relationship = registry.valid(entity) ? registry.try_get<RelationshipComponent>(entity) : nullptr;
+            entt::entity child = relationship ? relationship->firstChild : entt::null;
+            while (child != entt::null) {
+                const entt::entity next = registry.get<RelationshipComponent>(child).nextSibling;
+                func(child);
+                child = next;
+            }
+        }
+
+        /// @brief Destroys the entity together with all of its descendants, children before their parents.
+        /// @details Only for entities not owned by a `GameObject`, those are destroyed through `Scene::DestroyGameObject`.
+        static void destroySubtree(entt::registry& registry, entt::entity entity);
+
+    private:
+        /// @brief Signal handler linking a constructed or replaced transform to its parent.
+        void onTransformChanged(entt::registry& registry, entt::entity entity);
+
+        /// @brief Signal handler unlinking a destroyed entity from its parent and turning its children into roots.
+        void onRelationshipDestroyed(entt::registry& registry, entt::entity entity);
+
+        /// @brief Removes the entity from the child list of its parent, leaves its own children attached.
+        static void unlink(entt::registry& registry, entt::entity entity, RelationshipComponent& relationship);
+
+        entt::scoped_connection m_constructConnection;
+        entt::scoped_connection m_updateConnection;
+        entt::scoped_connection m_destroyConnection;
+    };
+}
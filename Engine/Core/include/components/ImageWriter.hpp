@@ -0,0 +1,22 @@
+/**
+ *  @file   ImageWriter.hpp
+ *  @brief  This file defines functions writing images to disk.
+ *  @author Eryk Roszkowski
+ ***********************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace vex {
+    /// @brief Writes 8 bit RGBA pixels to a PNG file.
+    /// @details Pixel data is stored without compression, so files are big but nothing beyond the standard library is needed. Meant for frames
+    /// captured by tests and benchmarks, see `Interface::saveFrame`.
+    /// @param const std::string& path - Output file path.
+    /// @param const uint8_t* rgba - Tightly packed rows, top row first.
+    /// @param uint32_t width - Width in pixels.
+    /// @param uint32_t height - Height in pixels.
+    /// @return bool - False if the file couldn't be written.
+    bool writePng(const std::string& path, const uint8_t* rgba, uint32_t width, uint32_t height);
+}
@@ -0,0 +1,105 @@
+/**
+ *  @file   JobPool.hpp
+ *  @brief  This file defines JobPool class running short jobs on a fixed set of work stealing threads.
+ *  @author Eryk Roszkowski
+ ***********************************************/
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace vex {
+
+    /// @brief Counts unfinished jobs submitted with it, `JobPool::wait` returns once the count drops to zero.
+    /// @details A job may submit more jobs into its own group, they are counted before the submitting job finishes.
+    class JobGroup {
+    public:
+        JobGroup() = default;
+        JobGroup(const JobGroup&) = delete;
+        JobGroup& operator=(const JobGroup&) = delete;
+
+        /// @brief Returns true if every job of the group finished.
+        /// @return bool
+        bool isDone() const { return m_pending.load(std::memory_order_acquire) == 0; }
+
+    private:
+        friend class JobPool;
+        std::atomic<uint32_t> m_pending{ 0 };
+    };
+
+    /// @brief Runs jobs on `threadCount - 1` workers and on threads waiting for a group.
+    /// @details Every worker owns a queue, it takes its newest job first and steals the oldest ones of other queues when its own is
+    /// empty. Jobs submitted from a worker go to its queue, jobs submitted from any other thread go to a shared one. Main thread jobs
+    /// are only run by the thread calling `wait`.
+    class JobPool {
+    public:
+        using Job = std::function<void()>;
+
+        /// @brief Constructor for JobPool, starts `threadCount - 1` workers.
+        /// @param uint32_t threadCount - Number of threads running jobs including the thread calling `wait`.
+        JobPool(uint32_t threadCount);
+        ~JobPool();
+
+        JobPool(const JobPool&) = delete;
+        JobPool& operator=(const JobPool&) = delete;
+
+        /// @brief Queues a job, exceptions thrown by it are logged.
+        /// @param JobGroup& group - Group the job is counted in, has to outlive the job.
+        /// @param Job job - Job to run.
+        /// @param bool mainThread - Run the job only on the thread waiting for the group.
+        void submit(JobGroup& group, Job job, bool mainThread = false);
+
+        /// @brief Runs queued jobs on the calling thread until every job of the group finished.
+        /// @param JobGroup& group - Group to wait for.
+        void wait(JobGroup& group);
+
+        /// @brief Returns number of threads running jobs including the waiting one.
+        /// @return uint32_t
+        uint32_t getThreadCount() const { return m_threadCount; }
+
+    private:
+        struct QueuedJob {
+            Job job;
+            JobGroup* group = nullptr;
+        };
+
+        struct alignas(64) WorkQueue {
+            std::mutex mutex;
+            std::deque<QueuedJob> jobs;
+        };
+
+        /// @brief Worker main loop, runs jobs and sleeps while no queue has any.
+        void workerLoop(uint32_t queueIndex);
+
+        /// @brief Takes the newest job of own queue or steals the oldest job of another one.
+        bool takeJob(uint32_t queueIndex, QueuedJob& out);
+
+        /// @brief Takes the oldest main thread job.
+        bool takeMainThreadJob(QueuedJob& out);
+
+        /// @brief Runs a job and marks it finished in its group.
+        void runJob(QueuedJob& job);
+
+        uint32_t m_threadCount;
+        // Queue 0 is shared by threads that aren't workers, queue i belongs to worker i.
+        std::vector<std::unique_ptr<WorkQueue>> m_queues;
+        WorkQueue m_mainThreadQueue;
+        std::vector<std::thread> m_workers;
+
+        // Raised under m_sleepMutex so sleepers can't miss work, lowered without it.
+        std::atomic<uint32_t> m_queuedJobs{ 0 };
+        std::atomic<uint32_t> m_queuedMainThreadJobs{ 0 };
+        std::mutex m_sleepMutex;
+        std::condition_variable m_workCondition;
+        std::condition_variable m_waitCondition;
+        bool m_stop = false;
+    };
+}
@@ -8,6 +8,7 @@
 #include "components/pathUtils.hpp"
 #include "components/assetTypes.hpp"
 
+#include <cstdint>
 #include <filesystem>
 #include <glm/glm.hpp>
 #include <vector>
@@ -29,18 +30,51 @@ namespace vex {
         glm::vec2 uv = glm::vec2(-100000.0f);
     };
 
+    /// @brief Layout of vertices uploaded to the GPU, chosen per mesh at import time.
+    enum class VertexFormat : uint8_t {
+        STANDARD = 0, ///< `Vertex` as it is, 32 bytes.
+        COMPACT = 1   ///< `CompactVertex`, 16 bytes, see `VertexQuantization.hpp`.
+    };
+
+    /// @brief Quantized vertex used by meshes imported with `VertexFormat::COMPACT`.
+    /// @details Position is 16 bit unorm relative to submesh bounds (4th component is padding), normal is octahedral encoded 16 bit snorm
+    /// and UV is half float. CPU side data always stays in `Vertex`, this is only what ends up in the vertex buffer.
+    struct CompactVertex {
+        uint16_t position[4];
+        int16_t normal[2];
+        uint16_t uv[2];
+    };
+
+    static_assert(sizeof(Vertex) == 32, "Vertex layout changed");
+    static_assert(sizeof(CompactVertex) == 16, "CompactVertex layout changed");
+
+    /// @brief Levels of detail a submesh can have, including the imported one.
+    inline constexpr uint32_t MAX_MESH_LODS = 4;
+
+    /// @brief Simplified level of a submesh, generated at import time by `generateLods` (see `MeshSimplifier.hpp`).
+    struct SubmeshLod {
+        /// @brief Triangle list indexing the same vertices as the full detail level.
+        std::vector<uint32_t> indices;
+        /// @brief Largest distance the simplified surface may be off the imported one, in mesh units.
+        float error = 0.0f;
+    };
+
     /// @brief Submesh structure for mesh data, its made like this cause some file formats hold multiple meshes in one file, but engine supports only one mesh per file
     struct Submesh {
         std::vector<Vertex> vertices;
         std::vector<uint32_t> indices;
         texture_asset_path texturePath;
         std::vector<glm::vec3> triangleCenters;
+        /// @brief Levels 1 and up, coarser with every entry. Empty if the submesh wasn't simplified.
+        std::vector<SubmeshLod> lods;
     };
 
     /// @brief Mesh data structure for loading and managing mesh data
     struct MeshData {
         std::vector<Submesh> submeshes;
         mesh_asset_path meshPath;
+        /// @brief Vertex layout used when the mesh is uploaded, falls back to `STANDARD` if the mesh can't be quantized.
+        VertexFormat vertexFormat = VertexFormat::STANDARD;
 
         /// @brief Loads mesh data from a file using the Virtual File System.
         /// @details Uses Assimp with a custom `VPKAssimpIOSystem` to read files directly from VFS memory buffers (supporting compressed VPKs).
@@ -58,6 +92,10 @@ namespace vex {
             submeshes.clear();
         }
 
+        /// @brief Returns bytes of CPU memory held by vertices, indices, triangle centers and levels of detail of all submeshes.
+        /// @return size_t
+        size_t getMemoryBytes() const;
+
     private:
         /// @brief Internal helper to convert an Assimp `aiScene` into VEX `Submesh` structures.
         /// @details Extracts vertices, normals, and texture coordinates. If texture coordinates are missing, initializes UVs to `(-100000.0f)` to signal the shader.
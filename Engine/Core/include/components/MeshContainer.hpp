@@ -0,0 +1,81 @@
+/**
+ *  @file   MeshContainer.hpp
+ *  @brief  This file defines the cooked mesh container (.vmesh) shared by the engine and the mesh cooker.
+ *  @author Eryk Roszkowski
+ ***********************************************/
+
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
+
+namespace vex {
+    /// @brief Simplified levels a `.vmesh` submesh record has room for, levels above the imported one.
+    inline constexpr uint32_t MESH_CONTAINER_MAX_LODS = 3;
+
+    /// @brief Header at the start of a `.vmesh` file.
+    /// @details Layout: header, then one `MeshContainerSubmesh` per submesh, then data blobs. Vertices are stored as `Vertex`, indices as
+    /// `uint32_t` and triangle centers as 3 floats, so every blob can be copied out as it is. Offsets are from the start of the file and
+    /// 16 byte aligned.
+    struct MeshContainerHeader {
+        char identifier[4] = {'V', 'M', 'S', 'H'};
+        uint32_t version = 1;
+        uint64_t sourceHash = 0; ///< Hash of the source file and LOD settings the file was cooked with, see `hashMeshSource`.
+        uint32_t submeshCount = 0;
+        uint32_t reserved = 0;
+        float boundsCenter[3] = {0.0f, 0.0f, 0.0f};
+        float boundsRadius = 0.0f;
+    };
+
+    /// @brief Index range of one simplified level inside a `.vmesh` file.
+    struct MeshContainerLod {
+        uint64_t indexOffset;
+        uint32_t indexCount;
+        float error;
+    };
+
+    /// @brief Location of one submesh inside a `.vmesh` file.
+    struct MeshContainerSubmesh {
+        uint64_t vertexOffset;
+        uint64_t indexOffset;
+        uint64_t centerOffset;  ///< One center per triangle of the full detail level.
+        uint64_t textureOffset; ///< Texture name relative to the mesh folder, not null terminated.
+        uint32_t vertexCount;
+        uint32_t indexCount;
+        uint32_t textureLength;
+        uint32_t lodCount;
+        MeshContainerLod lods[MESH_CONTAINER_MAX_LODS];
+    };
+
+    static_assert(sizeof(MeshContainerHeader) == 40, "MeshContainerHeader layout changed");
+    static_assert(sizeof(MeshContainerLod) == 16, "MeshContainerLod layout changed");
+    static_assert(sizeof(MeshContainerSubmesh) == 96, "MeshContainerSubmesh layout changed");
+
+    /// @brief File extension of cooked meshes.
+    inline constexpr const char* MESH_CONTAINER_EXTENSION = ".vmesh";
+
+    /// @brief Returns true if data starts with a `.vmesh` header of supported version.
+    /// @param const void* data - File data.
+    /// @param size_t size - Size of file data.
+    /// @return bool
+    inline bool isMeshContainer(const void* data, size_t size) {
+        if (size < sizeof(MeshContainerHeader)) return false;
+        MeshContainerHeader header;
+        std::memcpy(&header, data, sizeof(header));
+        return std::memcmp(header.identifier, "VMSH", 4) == 0 && header.version == 1;
+    }
+
+    /// @brief 64 bit FNV-1a, continues from `hash` so several buffers can be chained.
+    /// @param const void* data - Bytes to hash.
+    /// @param size_t size - Number of bytes.
+    /// @param uint64_t hash - Previous result, or the FNV offset basis to start a new hash.
+    /// @return uint64_t
+    inline uint64_t hashBytes(const void* data, size_t size, uint64_t hash = 0xcbf29ce484222325ull) {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < size; i++) {
+            hash ^= bytes[i];
+            hash *= 0x100000001b3ull;
+        }
+        return hash;
+    }
+}
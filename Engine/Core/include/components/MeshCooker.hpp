@@ -0,0 +1,71 @@
+/**
+ *  @file   MeshCooker.hpp
+ *  @brief  This file defines functions writing and reading cooked meshes (.vmesh), used by MeshManager and the mesh cooker tool.
+ *  @author Eryk Roszkowski
+ ***********************************************/
+
+#pragma once
+#include "components/Mesh.hpp"
+#include "components/MeshContainer.hpp"
+#include "components/MeshSimplifier.hpp"
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace vex {
+    /// @brief Bounding sphere of a whole mesh in its local space.
+    struct MeshBounds {
+        glm::vec3 center = glm::vec3(0.0f);
+        float radius = 0.0f;
+    };
+
+    /// @brief Returns path of the cooked sibling of a mesh source, same path with `.vmesh` extension.
+    /// @param const std::string& sourcePath - Path of the source mesh.
+    /// @return std::string
+    std::string cookedMeshPath(const std::string& sourcePath);
+
+    /// @brief Hashes source file contents together with everything else that changes what gets cooked (container version, LOD settings).
+    /// @param const void* data - Source file data.
+    /// @param size_t size - Size of source file data.
+    /// @param const MeshLodSettings& settings - LOD settings the mesh is (or was) cooked with.
+    /// @return uint64_t
+    uint64_t hashMeshSource(const void* data, size_t size, const MeshLodSettings& settings);
+
+    /// @brief Computes bounding sphere around the bounding box of all submeshes.
+    /// @param const MeshData& meshData - Mesh to compute bounds of.
+    /// @return MeshBounds
+    MeshBounds computeMeshBounds(const MeshData& meshData);
+
+    /// @brief Fills `Submesh::triangleCenters` with one center per full detail triangle, existing centers are replaced.
+    /// @param Submesh& submesh - Submesh to compute centers of.
+    void computeTriangleCenters(Submesh& submesh);
+
+    /// @brief Computes one center per full detail triangle of a submesh without modifying it.
+    /// @param const Submesh& submesh - Submesh to compute centers of.
+    /// @param std::vector<glm::vec3>& outCenters - Receives centers, existing contents are replaced.
+    void computeTriangleCenters(const Submesh& submesh, std::vector<glm::vec3>& outCenters);
+
+    /// @brief Serializes an imported mesh into a `.vmesh` file.
+    /// @details Stores vertices, indices, generated levels, triangle centers and bounds, so loading needs neither Assimp nor any pass over the vertices.
+    /// Texture paths are stored relative to the folder of `sourcePath`, the same way they are referenced by the source file.
+    /// @param const MeshData& meshData - Imported mesh, with LODs already generated. Missing triangle centers are computed.
+    /// @param const std::string& sourcePath - Path the mesh was imported from.
+    /// @param uint64_t sourceHash - Result of `hashMeshSource` for the source file.
+    /// @return std::vector<uint8_t> - File contents.
+    std::vector<uint8_t> writeCookedMesh(const MeshData& meshData, const std::string& sourcePath, uint64_t sourceHash);
+
+    /// @brief Deserializes a `.vmesh` file.
+    /// @details Every offset is checked against `size`, a truncated or corrupted file is rejected instead of read out of bounds.
+    /// @param const void* data - File data.
+    /// @param size_t size - Size of file data.
+    /// @param const std::string& sourcePath - Path of the source mesh, texture paths are resolved relative to its folder.
+    /// @param MeshData& outMeshData - Receives submeshes, with LODs and triangle centers. Only written on success.
+    /// @param MeshBounds& outBounds - Receives stored bounds.
+    /// @param uint64_t& outSourceHash - Receives source hash the file was cooked from.
+    /// @return bool - false if data isn't a valid `.vmesh` file.
+    bool readCookedMesh(const void* data, size_t size, const std::string& sourcePath, MeshData& outMeshData, MeshBounds& outBounds, uint64_t& outSourceHash);
+}
@@ -0,0 +1,58 @@
+/**
+ *  @file   MeshSimplifier.hpp
+ *  @brief  This file defines quadric error mesh simplifier used to generate levels of detail at import time.
+ *  @author Eryk Roszkowski
+ ***********************************************/
+
+#pragma once
+#include "components/Mesh.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace vex {
+    /// @brief Controls how many levels of detail `generateLods` builds and how far they may deviate from the imported mesh.
+    struct MeshLodSettings {
+        /// @brief Levels generated on top of the imported one, capped by `MAX_MESH_LODS - 1`. 0 disables generation.
+        uint32_t levelCount = 3;
+        /// @brief Triangle count of each level relative to the previous one.
+        float reductionPerLevel = 0.5f;
+        /// @brief Largest allowed error relative to submesh bounding radius, levels stop early once it would be exceeded.
+        float maxError = 0.02f;
+        /// @brief Submeshes (and levels) with fewer triangles are not simplified further.
+        uint32_t minTriangles = 64;
+    };
+
+    /// @brief Simplifies triangle list with half edge collapses ordered by quadric error.
+    /// @details Vertices that are exactly identical are welded first, so unwelded imports still collapse, and UV or normal seams are kept
+    /// by only collapsing a vertex onto a neighbour that can take over each of its attribute variants. Borders only collapse along themselves,
+    /// non manifold vertices are locked and collapses flipping a triangle are rejected.
+    ///
+    /// Error is the square root of the largest accepted sum of squared distances between a kept vertex and the planes of the original
+    /// triangles (and border edges) merged into it, so it never underestimates how far any of those planes moved.
+    /// @param const std::vector<Vertex>& vertices - Vertices of the submesh, never modified.
+    /// @param const std::vector<uint32_t>& indices - Triangle list.
+    /// @param size_t targetIndexCount - Stops once the result has this many indices or less.
+    /// @param float targetError - Stops before a collapse would make error larger than this, in mesh units.
+    /// @param float* outError - Optional, receives error of the result.
+    /// @return std::vector<uint32_t> - Triangle list indexing the original `vertices`.
+    std::vector<uint32_t> simplifyMesh(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices,
+                                       size_t targetIndexCount, float targetError, float* outError = nullptr);
+
+    /// @brief Fills `Submesh::lods` of every submesh.
+    /// @details Whole chain comes from a single simplification pass, snapshotted each time a level's triangle target is reached, so every
+    /// level is a coarser version of the previous one and its error is measured against the imported surface. A level is dropped when
+    /// it doesn't remove at least a tenth of the triangles of the previous one, which also ends the chain.
+    /// @param MeshData& meshData - Mesh to generate levels for, existing levels are replaced.
+    /// @param const MeshLodSettings& settings - Generation settings.
+    void generateLods(MeshData& meshData, const MeshLodSettings& settings);
+
+    /// @brief Returns error of every level of a whole mesh, the values `Renderer::selectLod` compares against its pixel threshold.
+    /// @details Level 0 is full detail with error 0. A level's error is the largest over all submeshes, a submesh with a shorter chain
+    /// is drawn with its coarsest level there and counts with that level's error. Since every chain's error never decreases, neither
+    /// does the result.
+    /// @param const MeshData& meshData - Mesh with generated (or cooked) levels.
+    /// @return std::vector<float> - One entry per level, at most `MAX_MESH_LODS`.
+    std::vector<float> computeLodErrors(const MeshData& meshData);
+}
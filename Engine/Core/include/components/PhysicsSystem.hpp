@@ -244,25 +244,37 @@ namespace vex {
         }
 
         // @brief Creates a mesh-shaped physics component.
+        // @details Mesh components only hold a path, vertices live in MeshManager. When the shape is left without vertices, MeshManager fills them
+        // as soon as the physics component and a mesh component meet on the same entity.
         // @param MeshComponent& mesh The mesh component to create the physics component from.
         // @param BodyType bodyType The type of body (static, dynamic, kinematic).
         // @param float mass The mass of the mesh.
         // @param float friction The friction coefficient of the mesh.
         // @param float bounce The bounce coefficient of the mesh.
         static PhysicsComponent Mesh(MeshComponent& mesh, BodyType bodyType = BodyType::STATIC, float mass = 1.0f, float friction = 0.5f, float bounce = 0.1f) {
+            return Mesh(mesh.meshData, bodyType, mass, friction, bounce);
+        }
+
+        // @brief Creates a mesh-shaped physics component from mesh data, for example the one returned by `MeshManager::getMeshData`.
+        // @param const MeshData& meshData The mesh data to copy vertices and indices from.
+        // @param BodyType bodyType The type of body (static, dynamic, kinematic).
+        // @param float mass The mass of the mesh.
+        // @param float friction The friction coefficient of the mesh.
+        // @param float bounce The bounce coefficient of the mesh.
+        static PhysicsComponent Mesh(const MeshData& meshData, BodyType bodyType = BodyType::STATIC, float mass = 1.0f, float friction = 0.5f, float bounce = 0.1f) {
             PhysicsComponent pc;
             pc.shape = ShapeType::MESH;
             pc.bodyType = bodyType;
             pc.mass = mass;
             pc.friction = friction;
             pc.bounce = bounce;
-            if (!mesh.meshData.submeshes.empty()) {
+            if (!meshData.submeshes.empty()) {
                 pc.meshVertices.clear();
                 pc.meshIndices.clear();
 
                 size_t vertexOffset = 0;
 
-                for (const auto& sm : mesh.meshData.submeshes) {
+                for (const auto& sm : meshData.submeshes) {
                     for (const auto& v : sm.vertices) {
                         pc.meshVertices.push_back(v.position);
                     }
@@ -0,0 +1,143 @@
+/**
+ *  @file   Profiler.hpp
+ *  @brief  This file defines CPU Profiler, ProfileScope and the VEX_PROFILE_SCOPE macro used to measure named zones of a frame.
+ *  @author Eryk Roszkowski
+ ***********************************************/
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "VEX/VEX_export.h"
+
+/// @brief Set to 0 to compile every `VEX_PROFILE_SCOPE` out, the `VEX_PROFILER` CMake option controls it for the engine and games.
+#ifndef VEX_PROFILER
+    #define VEX_PROFILER 1
+#endif
+
+namespace vex {
+    /// @brief Finished zone, times are nanoseconds of `Profiler::now`.
+    struct ProfileZone {
+        /// @brief Name passed to the scope, has to outlive the profiler (string literal).
+        const char* name;
+        uint64_t start;
+        uint64_t end;
+        /// @brief Number of zones of the same thread that were open when this one started.
+        uint32_t depth;
+    };
+
+    /// @brief Zones recorded by the main thread during one frame, ordered by start time.
+    struct ProfileFrame {
+        uint64_t index = 0;
+        uint64_t start = 0;
+        uint64_t end = 0;
+        std::vector<ProfileZone> zones;
+    };
+
+    /// @brief Process wide CPU profiler collecting zones from every thread.
+    /// @details Each thread writes finished zones into its own ring buffer of `PROFILER_RING_SIZE` entries, so recording takes no lock.
+    /// The main thread calls `beginFrame` once per frame: it keeps its own zones of the previous frame for `getLastFrame` and,
+    /// while capturing, drains the rings of all threads. A thread producing more zones than its ring holds between two frames loses the oldest.
+    /// Recording is off until `setEnabled(true)` or `startCapture`, a disabled scope costs one relaxed atomic load.
+    class VEX_EXPORT Profiler {
+    public:
+        /// @brief Entries in the ring buffer of one thread.
+        static constexpr uint32_t PROFILER_RING_SIZE = 1u << 15;
+
+        /// @brief Enables or disables recording of zones.
+        /// @param bool enabled
+        static void setEnabled(bool enabled);
+
+        /// @brief Returns true while zones are recorded.
+        /// @return bool
+        static bool isEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+        /// @brief Ends the previous frame and starts a new one. Called by `Engine::run` on the main thread.
+        static void beginFrame();
+
+        /// @brief Starts collecting zones of all threads for export, enables recording until the capture stops.
+        static void startCapture();
+
+        /// @brief Stops a capture and writes it as Chrome Trace Event JSON, loadable in chrome://tracing and Perfetto.
+        /// @param const std::string& path - Output file.
+        /// @return bool - False if no capture was running or the file couldn't be written.
+        static bool stopCapture(const std::string& path);
+
+        /// @brief Captures the next frames and writes them to a file once done.
+        /// @param uint32_t frameCount - Number of frames to capture.
+        /// @param const std::string& path - Output file.
+        static void captureFrames(uint32_t frameCount, const std::string& path);
+
+        /// @brief Returns a capture file name with the local time, `profile_<date>_<time>.json`.
+        /// @return std::string
+        static std::string captureFileName();
+
+        /// @brief Returns true while a capture is running.
+        /// @return bool
+        static bool isCapturing();
+
+        /// @brief Returns zones of the main thread recorded during the last finished frame. Main thread only.
+        /// @return const ProfileFrame&
+        static const ProfileFrame& getLastFrame();
+
+        /// @brief Names the calling thread in exported traces.
+        /// @param const char* name - Thread name, copied.
+        static void setThreadName(const char* name);
+
+        /// @brief Returns current time in nanoseconds of a steady clock.
+        /// @return uint64_t
+        static uint64_t now() {
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+        }
+
+        /// @brief (used by ProfileScope) opens a zone on the calling thread.
+        /// @return uint64_t - Start time.
+        static uint64_t enterZone();
+
+        /// @brief (used by ProfileScope) closes the innermost zone of the calling thread.
+        /// @param const char* name - Zone name.
+        /// @param uint64_t start - Value returned by `enterZone`.
+        static void leaveZone(const char* name, uint64_t start);
+
+    private:
+        static std::atomic<bool> s_enabled;
+    };
+
+    /// @brief Records a zone from construction to destruction if the profiler was enabled at construction. Use through `VEX_PROFILE_SCOPE`.
+    class ProfileScope {
+    public:
+        explicit ProfileScope(const char* name) {
+            if (Profiler::isEnabled()) [[unlikely]] {
+                m_name = name;
+                m_start = Profiler::enterZone();
+            }
+        }
+
+        ~ProfileScope() {
+            if (m_name) [[unlikely]] {
+                Profiler::leaveZone(m_name, m_start);
+            }
+        }
+
+        ProfileScope(const ProfileScope&) = delete;
+        ProfileScope& operator=(const ProfileScope&) = delete;
+
+    private:
+        const char* m_name = nullptr;
+        uint64_t m_start = 0;
+    };
+}
+
+#define VEX_PROFILE_CONCAT_INNER(a, b) a##b
+#define VEX_PROFILE_CONCAT(a, b) VEX_PROFILE_CONCAT_INNER(a, b)
+
+#if VEX_PROFILER
+    /// @brief Measures the rest of the enclosing block as a zone named `name`, which has to be a string literal.
+    #define VEX_PROFILE_SCOPE(name) ::vex::ProfileScope VEX_PROFILE_CONCAT(vexProfileScope, __LINE__)(name)
+#else
+    #define VEX_PROFILE_SCOPE(name) ((void)0)
+#endif
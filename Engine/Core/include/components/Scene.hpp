@@ -37,14 +37,14 @@ Scene& operator=(Scene&&) = default;
 
 /// @brief Calls `BeginPlay` on all objects in the scene.
 /// @details Iterates through both main storage (`m_objects`) and the added queue (`m_addedObjects`).
-/// If `VEX_USE_PARALLEL_EXECUTION` is defined and object count > 50, execution is parallelized.
+/// Objects run one after another, objects created meanwhile aren't visited.
 void sceneBegin();
 
 /// @brief Updates all objects in the scene.
 /// @details
 /// 1. Flushes the destruction queue via `FlushDestructionQueue`.
-/// 2. Calls `Update(deltaTime)` on all active objects.
-/// 3. Supports parallel execution for large object counts if configured.
+/// 2. Calls `Update(deltaTime)` on all active objects one after another, objects created meanwhile are updated next frame.
+/// Parallel per entity work goes into systems on `Engine::getSystemScheduler`, which run after this.
 /// @param float deltaTime - Delta time since last frame.
 void sceneUpdate(float deltaTime);
 
@@ -104,7 +104,7 @@ std::string GetScenePath(){
 }
 
 /// @brief Processes the queue of objects marked for destruction.
-/// @details Waits for the GPU to finish operations via `Engine::WaitForGpu` to ensure safe deletion, then removes the objects from internal storage vectors.
+/// @details Removes the objects from internal storage vectors without waiting for the GPU, meshes and UI they owned are released through the renderer's deferred deletion queue once frames in flight no longer use them.
 void FlushDestructionQueue();
 
 private:
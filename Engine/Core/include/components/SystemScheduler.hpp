@@ -0,0 +1,146 @@
+/**
+ *  @file   SystemScheduler.hpp
+ *  @brief  This file defines SystemScheduler class running ECS systems in parallel according to the components they declare.
+ *  @author Eryk Roszkowski
+ ***********************************************/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <entt/entt.hpp>
+
+#include "components/JobPool.hpp"
+
+namespace vex {
+
+    /// @brief Components a system reads and writes, used to decide which systems may run at the same time.
+    /// @details Two systems conflict when one writes a component the other reads or writes, or when either is exclusive.
+    /// @code
+    /// SystemAccess().read<TransformComponent>().write<VelocityComponent>()
+    /// @endcode
+    class SystemAccess {
+    public:
+        /// @brief Declares components the system only reads.
+        template <typename... Components>
+        SystemAccess& read() {
+            (add<Components>(m_reads), ...);
+            return *this;
+        }
+
+        /// @brief Declares components the system reads and writes.
+        template <typename... Components>
+        SystemAccess& write() {
+            (add<Components>(m_writes), ...);
+            return *this;
+        }
+
+        /// @brief Marks the system as touching the whole registry, for example creating or destroying entities. It runs alone.
+        SystemAccess& exclusive() {
+            m_exclusive = true;
+            return *this;
+        }
+
+        /// @brief Runs the system on the thread calling `SystemScheduler::run`, for systems using APIs bound to that thread.
+        SystemAccess& mainThread() {
+            m_mainThread = true;
+            return *this;
+        }
+
+        /// @brief Returns true if the systems can't run at the same time.
+        /// @return bool
+        bool conflictsWith(const SystemAccess& other) const;
+
+    private:
+        friend class SystemScheduler;
+
+        template <typename Component>
+        void add(std::vector<entt::id_type>& ids) {
+            using Type = std::remove_const_t<Component>;
+            ids.push_back(entt::type_id<Type>().hash());
+            m_storages.push_back([](entt::registry& registry) { registry.storage<Type>(); });
+        }
+
+        std::vector<entt::id_type> m_reads;
+        std::vector<entt::id_type> m_writes;
+        // Create declared pools at registration, creating one from a system would modify the registry other systems are reading.
+        std::vector<void (*)(entt::registry&)> m_storages;
+        bool m_exclusive = false;
+        bool m_mainThread = false;
+    };
+
+    /// @brief Runs registered systems once per `run`, systems that don't conflict run at the same time on a `JobPool`.
+    /// @details Dependencies are fixed at registration: a system waits for every earlier registered system it conflicts with. So
+    /// conflicting systems always run in registration order and the result doesn't depend on thread timing. Systems only get a
+    /// registry reference, touching components they didn't declare is a data race.
+    class SystemScheduler {
+    public:
+        using SystemFunction = std::function<void(entt::registry&, float)>;
+
+        /// @brief Constructor for SystemScheduler.
+        /// @param entt::registry& registry - Registry passed to systems, has to outlive the scheduler.
+        /// @param JobPool& jobPool - Pool running the systems, has to outlive the scheduler.
+        SystemScheduler(entt::registry& registry, JobPool& jobPool);
+
+        SystemScheduler(const SystemScheduler&) = delete;
+        SystemScheduler& operator=(const SystemScheduler&) = delete;
+
+        /// @brief Registers a system after all systems registered before it. Can't be called from `run`.
+        /// @param const std::string& name - Name shown in logs and profiler captures.
+        /// @param const SystemAccess& access - Components the system reads and writes.
+        /// @param SystemFunction function - Called with the registry and frame delta time.
+        /// @return uint32_t - Index of the system.
+        uint32_t addSystem(const std::string& name, const SystemAccess& access, SystemFunction function);
+
+        /// @brief Runs every enabled system once and returns when all finished. The calling thread runs systems too.
+        /// @param float deltaTime - Delta time passed to systems.
+        void run(float deltaTime);
+
+        /// @brief Enables or disables a system, a disabled system is skipped but still orders the systems around it.
+        void setSystemEnabled(uint32_t index, bool enabled);
+
+        /// @brief Returns number of registered systems.
+        /// @return size_t
+        size_t getSystemCount() const { return m_systems.size(); }
+
+        /// @brief Returns name of a system.
+        /// @return const std::string&
+        const std::string& getSystemName(uint32_t index) const { return m_systems[index].name; }
+
+        /// @brief Returns indices of systems the system waits for.
+        /// @return const std::vector<uint32_t>&
+        const std::vector<uint32_t>& getDependencies(uint32_t index) const { return m_systems[index].dependencies; }
+
+        /// @brief Returns pool running the systems, systems may split their own work over it.
+        /// @return JobPool&
+        JobPool& getJobPool() { return m_jobPool; }
+
+    private:
+        struct System {
+            std::string name;
+            SystemAccess access;
+            SystemFunction function;
+            std::vector<uint32_t> dependencies;
+            std::vector<uint32_t> dependents;
+            std::atomic<uint32_t> remaining{ 0 };  // dependencies not finished in the current run
+            bool enabled = true;
+        };
+
+        /// @brief Queues a system whose dependencies all finished.
+        void schedule(uint32_t index);
+
+        entt::registry& m_registry;
+        JobPool& m_jobPool;
+        // Deque keeps names at fixed addresses, the profiler keeps pointers to them.
+        std::deque<System> m_systems;
+        std::vector<uint32_t> m_roots;
+        JobGroup* m_p_group = nullptr;
+        float m_deltaTime = 0.0f;
+    };
+}
@@ -0,0 +1,116 @@
+/**
+ *  @file   TextureContainer.hpp
+ *  @brief  This file defines the cooked texture container (.vtex) shared by the engine and the texture cooker.
+ *  @author Eryk Roszkowski
+ ***********************************************/
+
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
+
+namespace vex {
+    /// @brief Pixel encoding of every level in a `.vtex` file, all encodings are sRGB.
+    enum class TextureEncoding : uint32_t {
+        RGBA8 = 0, ///< Uncompressed fallback, 4 bytes per texel.
+        BC1 = 1,   ///< 8 bytes per 4x4 block, opaque textures.
+        BC3 = 2,   ///< 16 bytes per 4x4 block, interpolated alpha.
+        BC7 = 3    ///< 16 bytes per 4x4 block, high quality color and alpha.
+    };
+
+    /// @brief Header at the start of a `.vtex` file.
+    /// @details Layout follows KTX2: header, then one `TextureLevelIndex` per mip level (level 0 first), then level data.
+    /// Level data offsets are from the start of the file and 16 byte aligned, so they can be copied into a staging buffer as they are.
+    struct TextureContainerHeader {
+        char identifier[4] = {'V', 'T', 'E', 'X'};
+        uint32_t version = 1;
+        TextureEncoding encoding = TextureEncoding::RGBA8;
+        uint32_t width = 0;
+        uint32_t height = 0;
+        uint32_t levelCount = 0;
+        uint64_t sourceBytes = 0; ///< Size of full RGBA8 mip chain of the source, used for reporting savings.
+    };
+
+    /// @brief Location of one mip level inside a `.vtex` file.
+    struct TextureLevelIndex {
+        uint64_t byteOffset;
+        uint64_t byteLength;
+    };
+
+    static_assert(sizeof(TextureContainerHeader) == 32, "TextureContainerHeader layout changed");
+    static_assert(sizeof(TextureLevelIndex) == 16, "TextureLevelIndex layout changed");
+
+    /// @brief File extension of cooked textures.
+    inline constexpr const char* TEXTURE_CONTAINER_EXTENSION = ".vtex";
+
+    /// @brief Returns true if data starts with a `.vtex` header of supported version.
+    /// @param const void* data - File data.
+    /// @param size_t size - Size of file data.
+    /// @return bool
+    inline bool isTextureContainer(const void* data, size_t size) {
+        if (size < sizeof(TextureContainerHeader)) return false;
+        TextureContainerHeader header;
+        std::memcpy(&header, data, sizeof(header));
+        return std::memcmp(header.identifier, "VTEX", 4) == 0 && header.version == 1;
+    }
+
+    /// @brief Returns bytes per 4x4 block, or per texel for RGBA8.
+    /// @param TextureEncoding encoding - Encoding.
+    /// @return uint32_t
+    inline uint32_t textureBlockBytes(TextureEncoding encoding) {
+        switch (encoding) {
+            case TextureEncoding::BC1: return 8;
+            case TextureEncoding::BC3: return 16;
+            case TextureEncoding::BC7: return 16;
+            default: return 4;
+        }
+    }
+
+    /// @brief Returns true for block compressed encodings.
+    /// @param TextureEncoding encoding - Encoding.
+    /// @return bool
+    inline bool isBlockCompressed(TextureEncoding encoding) {
+        return encoding != TextureEncoding::RGBA8;
+    }
+
+    /// @brief Returns size in bytes of a single level.
+    /// @param TextureEncoding encoding - Encoding.
+    /// @param uint32_t width - Level width in texels.
+    /// @param uint32_t height - Level height in texels.
+    /// @return uint64_t
+    inline uint64_t textureLevelBytes(TextureEncoding encoding, uint32_t width, uint32_t height) {
+        if (!isBlockCompressed(encoding)) {
+            return static_cast<uint64_t>(width) * height * 4;
+        }
+        return static_cast<uint64_t>((width + 3) / 4) * ((height + 3) / 4) * textureBlockBytes(encoding);
+    }
+
+    /// @brief Returns number of levels in a full mip chain down to 1x1.
+    /// @param uint32_t width - Level 0 width.
+    /// @param uint32_t height - Level 0 height.
+    /// @return uint32_t
+    inline uint32_t fullMipCount(uint32_t width, uint32_t height) {
+        uint32_t levels = 1;
+        uint32_t size = width > height ? width : height;
+        while (size > 1) {
+            size >>= 1;
+            levels++;
+        }
+        return levels;
+    }
+
+    /// @brief Returns size in bytes of a full RGBA8 mip chain, the baseline savings are reported against.
+    /// @param uint32_t width - Level 0 width.
+    /// @param uint32_t height - Level 0 height.
+    /// @return uint64_t
+    inline uint64_t rawMipChainBytes(uint32_t width, uint32_t height) {
+        uint64_t bytes = 0;
+        uint32_t levels = fullMipCount(width, height);
+        for (uint32_t level = 0; level < levels; level++) {
+            bytes += textureLevelBytes(TextureEncoding::RGBA8, width, height);
+            width = width > 1 ? width / 2 : 1;
+            height = height > 1 ? height / 2 : 1;
+        }
+        return bytes;
+    }
+}
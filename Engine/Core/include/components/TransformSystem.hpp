@@ -0,0 +1,72 @@
+/**
+ *  @file   TransformSystem.hpp
+ *  @brief  This file defines TransformSystem class updating world matrices of the transform hierarchy in one pass.
+ *  @author Eryk Roszkowski
+ ***********************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <entt/entt.hpp>
+#include <glm/glm.hpp>
+
+#include "components/GameComponents/BasicComponents.hpp"
+
+namespace vex {
+
+    /// @brief Computes world matrices of all `TransformComponent`s once per frame.
+    /// @details Keeps its own array of the hierarchy sorted by depth, so every parent comes before its children and each depth level
+    /// is one contiguous range. Dirty flags are propagated downward while walking that array and world matrices are written to
+    /// `TransformComponent::getWorldMatrix`, with levels large enough split across threads. The order is rebuilt when transforms are
+    /// added or removed, or a parent change is noticed during the pass.
+    class TransformSystem {
+    public:
+        /// @brief Constructor for TransformSystem, connects to construction and destruction of transforms in the registry.
+        /// @param entt::registry& registry - Registry holding the transforms, has to outlive the system.
+        TransformSystem(entt::registry& registry);
+
+        TransformSystem(const TransformSystem&) = delete;
+        TransformSystem& operator=(const TransformSystem&) = delete;
+
+        /// @brief Recomputes world matrices of dirty transforms and their descendants and clears their dirty flags.
+        void update();
+
+        /// @brief Forces the order to be rebuilt and every world matrix to be recomputed on the next update.
+        void invalidate() { m_orderDirty = true; }
+
+        /// @brief Returns number of depth levels of the hierarchy, 1 if no transform has a parent.
+        /// @return size_t
+        size_t getLevelCount() const { return m_levelStarts.empty() ? 0 : m_levelStarts.size() - 1; }
+
+    private:
+        static constexpr uint32_t NO_PARENT = UINT32_MAX;
+        /// @brief Levels with fewer transforms are updated on the calling thread.
+        static constexpr size_t PARALLEL_LEVEL_SIZE = 4096;
+
+        /// @brief Signal handler for construction and destruction of a transform.
+        void onTransformChanged(entt::registry& registry, entt::entity entity);
+
+        /// @brief Sorts all transforms by depth, transforms in parent cycles are treated as roots.
+        void rebuildOrder();
+
+        /// @brief Updates transforms `[begin, end)` of the order, all of them on the same level.
+        /// @return bool - False if a transform's parent isn't the one the order was built with.
+        bool updateRange(size_t begin, size_t end, bool force);
+
+        entt::registry& m_registry;
+        entt::scoped_connection m_constructConnection;
+        entt::scoped_connection m_destroyConnection;
+        bool m_orderDirty = true;
+
+        // Parallel arrays in hierarchy order. Component pointers stay valid until a transform is added or removed, which rebuilds the order.
+        std::vector<TransformComponent*> m_components;
+        std::vector<uint32_t> m_parents;             // index of the parent in the order
+        std::vector<entt::entity> m_parentEntities;  // parent when the order was built
+        std::vector<glm::mat4> m_world;
+        std::vector<uint8_t> m_changed;              // world matrix recomputed this update
+        std::vector<size_t> m_levelStarts;           // level l spans [m_levelStarts[l], m_levelStarts[l + 1])
+        std::vector<uint32_t> m_indices;             // 0..n-1, the range the parallel update runs over
+    };
+}
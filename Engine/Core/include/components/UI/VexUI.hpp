@@ -306,7 +306,7 @@ private:
 
     VkBuffer m_vb = VK_NULL_HANDLE;
     VmaAllocation m_vbAlloc = VK_NULL_HANDLE;
-    size_t m_vbSize = 0;
+    size_t m_vbSize = 0; // size of one frame's region, the buffer holds MAX_FRAMES_IN_FLIGHT of them
     VkSampler m_uiSampler = VK_NULL_HANDLE;
 
     /// @brief Loads fonts for the UI.
@@ -329,7 +329,8 @@ private:
 
     /// @brief Uploads the vertex buffer to the GPU.
     /// @param const std::vector<float>& verts The vertex buffer to upload.
-    void uploadVerts(const std::vector<float>& verts);
+    /// @param int currentFrame The frame in flight whose region of the buffer is written.
+    void uploadVerts(const std::vector<float>& verts, int currentFrame);
 
     /// @brief Parses a node from json to widgets.
     /// @param const nlohmann::json& j The json node to parse.
@@ -0,0 +1,98 @@
+/**
+ *  @file   VertexQuantization.hpp
+ *  @brief  This file defines helpers converting vertices and indices to the compact formats uploaded to the GPU.
+ *  @author Eryk Roszkowski
+ ***********************************************/
+
+#pragma once
+#include "components/Mesh.hpp"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace vex {
+    /// @brief Largest absolute UV value a `COMPACT` mesh may use.
+    /// @details Half floats keep 11 significant bits, below 16 the rounding error is at most 1/256 which is less than a texel of the small textures the engine is made for.
+    inline constexpr float COMPACT_UV_LIMIT = 16.0f;
+
+    /// @brief UV stored for untextured vertices, lowest finite half float. Still passes the `uv.x <= -10000` check in shaders.
+    inline constexpr uint16_t COMPACT_UNTEXTURED_UV = 0xFBFF;
+
+    /// @brief Worst case angle between a unit normal and its octahedral 2x16 bit snorm round trip, in radians.
+    inline constexpr float COMPACT_NORMAL_MAX_ERROR = 0.0001f;
+
+    /// @brief Maps local positions of a submesh into the [0, 1] cube stored as 16 bit unorm.
+    /// @details Scale is uniform on purpose, so the dequantization matrix can be folded into the model matrix without skewing normals.
+    struct PositionQuantization {
+        glm::vec3 origin = glm::vec3(0.0f);
+        float scale = 1.0f;
+
+        /// @brief Returns matrix taking dequantized [0, 1] positions back to submesh local space.
+        /// @return glm::mat4
+        glm::mat4 matrix() const;
+
+        /// @brief Returns largest distance (per axis) between a position and its round trip, half a quantization step plus float rounding.
+        /// @return float
+        float maxError() const;
+    };
+
+    /// @brief Converts float to half float, rounding to nearest even. Values out of range become infinity.
+    /// @param float value
+    /// @return uint16_t
+    uint16_t floatToHalf(float value);
+
+    /// @brief Converts half float to float.
+    /// @param uint16_t value
+    /// @return float
+    float halfToFloat(uint16_t value);
+
+    /// @brief Encodes unit vector onto octahedron unfolded into [-1, 1] square.
+    /// @param glm::vec3 normal - Unit vector.
+    /// @return glm::vec2
+    glm::vec2 octahedralEncode(glm::vec3 normal);
+
+    /// @brief Decodes vector encoded by `octahedralEncode`, same math as `decodeNormal` in shaders.
+    /// @param glm::vec2 encoded - Encoded vector.
+    /// @return glm::vec3 - Unit vector.
+    glm::vec3 octahedralDecode(glm::vec2 encoded);
+
+    /// @brief Returns quantization covering bounds of given vertices.
+    /// @param const std::vector<Vertex>& vertices - Vertices of a single submesh.
+    /// @return PositionQuantization
+    PositionQuantization computePositionQuantization(const std::vector<Vertex>& vertices);
+
+    /// @brief Returns true if all textured UVs fit within `COMPACT_UV_LIMIT`.
+    /// @param const std::vector<Vertex>& vertices - Vertices of a single submesh.
+    /// @return bool
+    bool canQuantizeUVs(const std::vector<Vertex>& vertices);
+
+    /// @brief Quantizes single vertex.
+    /// @param const Vertex& vertex - Source vertex.
+    /// @param const PositionQuantization& quantization - Quantization of its submesh.
+    /// @return CompactVertex
+    CompactVertex quantizeVertex(const Vertex& vertex, const PositionQuantization& quantization);
+
+    /// @brief Restores vertex the way the vertex shader sees it.
+    /// @param const CompactVertex& vertex - Quantized vertex.
+    /// @param const PositionQuantization& quantization - Quantization of its submesh.
+    /// @return Vertex
+    Vertex dequantizeVertex(const CompactVertex& vertex, const PositionQuantization& quantization);
+
+    /// @brief Quantizes all vertices of a submesh.
+    /// @param const std::vector<Vertex>& vertices - Source vertices.
+    /// @param const PositionQuantization& quantization - Quantization of the submesh.
+    /// @param std::vector<CompactVertex>& out - Receives quantized vertices.
+    void quantizeVertices(const std::vector<Vertex>& vertices, const PositionQuantization& quantization, std::vector<CompactVertex>& out);
+
+    /// @brief Returns true if every index of a submesh with `vertexCount` vertices fits in 16 bits.
+    /// @param size_t vertexCount
+    /// @return bool
+    inline bool canUse16BitIndices(size_t vertexCount) { return vertexCount <= UINT16_MAX; }
+
+    /// @brief Narrows indices to 16 bits, caller must check `canUse16BitIndices` first.
+    /// @param const std::vector<uint32_t>& indices - Source indices.
+    /// @param std::vector<uint16_t>& out - Receives narrowed indices.
+    void narrowIndices(const std::vector<uint32_t>& indices, std::vector<uint16_t>& out);
+}
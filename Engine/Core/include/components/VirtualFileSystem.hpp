@@ -45,7 +45,7 @@ public:
 
     /// @brief Loads a file into memory from the specified path.
     /// @details
-    /// - **Packed Mode**: Locates the file entry in the loaded VPK, seeks to the data offset, and reads `entry->data_size` bytes.
+    /// - **Packed Mode**: Locates the file entry in the loaded VPK, seeks to the data offset, and reads `entry->data_size` bytes (protected by `stream_mutex`, safe to call from worker threads).
     /// - **Loose Mode**: Reads the file from disk using `std::ifstream`, resolving the path relative to the base directory.
     /// @param const std::string& virtual_path - The relative path or unique ID of the file to load.
     /// @return std::unique_ptr<FileData> - Unique pointer to the struct containing the raw data vector and size, or nullptr if not found.
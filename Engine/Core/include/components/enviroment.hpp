@@ -27,6 +27,10 @@ namespace vex {
       bool textureQuantization = true;
       /// @brief Enables screen dithering. (PS1 style dithering)
       bool screenDither = true;
+      /// @brief Sorts transparent meshes per triangle instead of per submesh. Fixes overlaps inside a single mesh at higher CPU cost.
+      bool perTriangleTransparency = false;
+      /// @brief Largest on screen error, in pixels, a mesh level of detail may have. Coarser levels are drawn as long as they stay under it, 0 always draws full detail.
+      float lodErrorPixels = 1.0f;
       /// @brief Ambient light color
       glm::vec3 ambientLight = glm::vec3(1.0f);
       /// @brief Ambient light strength
@@ -43,4 +43,11 @@ namespace vex {
     /// If creation fails, falls back to `std::filesystem::current_path()`.
     /// @return std::filesystem::path - The resolved log directory.
     std::filesystem::path VEX_EXPORT GetLogDir();
+
+    /// @brief Gets per-user writable directory for caches and settings.
+    /// @details Uses `SDL_GetPrefPath("VEX", appName)`, so it survives reinstalls and works when the executable dir is read only.
+    /// If it can't be resolved, falls back to `GetExecutableDir() / "Engine" / "cache"`.
+    /// @param const std::string& appName - Application name, usually `GameInfo::projectName`.
+    /// @return std::filesystem::path - Existing directory.
+    std::filesystem::path VEX_EXPORT GetUserDataDir(const std::string& appName);
 }
@@ -13,26 +13,30 @@
 #include "components/backends/vulkan/PhysicsDebug.hpp"
 
 #include "components/SceneManager.hpp"
+#include "components/Profiler.hpp"
 #include "components/backends/vulkan/context.hpp"
 #include "entt/entity/fwd.hpp"
 
+#include <algorithm>
 #include <cstdint>
 #include <filesystem>
 #include <memory>
+#include <thread>
 
 #include "VexBuildVersion.hpp"
 
 namespace vex {
 
-Engine::Engine(const char* title, int width, int height, GameInfo gInfo) {
+Engine::Engine(const char* title, int width, int height, GameInfo gInfo, bool headless) {
     std::filesystem::current_path(GetExecutableDir());
     m_gameInfo = gInfo;
+    m_headless = headless;
     if(m_gameInfo.versionMajor == 0 && m_gameInfo.versionMinor == 0 && m_gameInfo.versionPatch == 0){
         log("Project version not set!");
     }
 
     log("Creating window..");
-    m_window = std::make_shared<Window>(title, width, height);
+    m_window = std::make_shared<Window>(title, width, height, headless);
     m_resolutionManager = std::make_unique<ResolutionManager>(m_window->GetSDLWindow());
 
     #ifdef __linux__
@@ -49,13 +53,21 @@ Engine::Engine(const char* title, int width, int height, GameInfo gInfo) {
 
     m_physicsSystem = std::make_unique<PhysicsSystem>(m_registry);
     m_physicsSystem->init();
-
+    m_transformSystem = std::make_unique<TransformSystem>(m_registry);
+    m_hierarchySystem = std::make_unique<HierarchySystem>(m_registry);
+    m_jobPool = std::make_unique<JobPool>(std::max(1u, std::thread::hardware_concurrency()));
+    m_systemScheduler = std::make_unique<SystemScheduler>(m_registry, *m_jobPool);
+
+    if (headless) {
+        // Machines without a display usually have no audio device either.
+        SDL_SetHint(SDL_HINT_AUDIO_DRIVER, "dummy");
+    }
     m_audioSystem = std::make_unique<AudioSystem>(m_registry);
     m_audioSystem->Init(m_vfs.get());
 
     auto renderRes = m_resolutionManager->getRenderResolution();
     log("Initializing Vulkan interface...");
-    m_interface = std::make_unique<Interface>(m_window->GetSDLWindow(), renderRes, m_gameInfo, m_vfs.get());
+    m_interface = std::make_unique<Interface>(m_window->GetSDLWindow(), renderRes, m_gameInfo, m_vfs.get(), headless);
     m_imgui = std::make_unique<VulkanImGUIWrapper>(m_window->GetSDLWindow(), *m_interface->getContext());
     m_imgui->init();
 
@@ -80,6 +92,10 @@ Interface* Engine::getInterface() {
     return m_interface.get();
 }
 
+const DynamicAABBTree& Engine::getSpatialTree() {
+    return m_interface->getMeshManager().getSpatialTree();
+}
+
 std::shared_ptr<VexUI> Engine::createVexUI(){
     return std::make_shared<VexUI>(*m_interface->getContext(), m_vfs.get(), m_interface->getResources());
 }
@@ -88,11 +104,15 @@ void Engine::run(std::function<void()> onUpdateLoop) {
     Uint64 lastTime = SDL_GetPerformanceCounter();
 
     while (m_running) {
+        Profiler::beginFrame();
+        VEX_PROFILE_SCOPE("Frame");
+
         Uint64 frameStart = SDL_GetPerformanceCounter();
         if (onUpdateLoop) onUpdateLoop();
 
         SDL_Event event;
         while (SDL_PollEvent(&event)) {
+            VEX_PROFILE_SCOPE("Events");
             processEvent(event, m_deltaTime);
             m_imgui->processEvent(&event);
             auto uiView = m_registry.view<UiComponent>();
@@ -124,6 +144,16 @@ void Engine::run(std::function<void()> onUpdateLoop) {
                     //auto renderRes = m_resolutionManager->getRenderResolution();
                     //m_interface->setRenderResolution(renderRes);
                     break;
+                case SDL_EVENT_KEY_DOWN:
+                    if (m_profilerCaptureKey != SDLK_UNKNOWN && event.key.key == m_profilerCaptureKey && !event.key.repeat) {
+                        if (Profiler::isCapturing()) {
+                            Profiler::stopCapture(Profiler::captureFileName());
+                        } else {
+                            log("Profiler capture started");
+                            Profiler::startCapture();
+                        }
+                    }
+                    break;
             }
         }
 
@@ -147,6 +177,7 @@ void Engine::run(std::function<void()> onUpdateLoop) {
         #endif
 
         if (targetFps > 0) {
+            VEX_PROFILE_SCOPE("FrameLimit");
             float targetFrameTime = 1000.0f / targetFps;
 
             Uint64 frameEnd = SDL_GetPerformanceCounter();
@@ -198,6 +229,10 @@ Engine::~Engine() {
         m_physicsSystem->shutdown();
         m_physicsSystem.reset();
     }
+    m_transformSystem.reset();
+    m_hierarchySystem.reset();
+    m_systemScheduler.reset();
+    m_jobPool.reset();
     m_imgui.reset();
     m_interface.reset();
     m_inputSystem.reset();
@@ -243,10 +278,15 @@ void Engine::processEvent(const SDL_Event& event, float deltaTime) {
 }
 
 void Engine::update(float deltaTime) {
-    m_inputSystem->update(deltaTime);
+    VEX_PROFILE_SCOPE("Engine::update");
+    {
+        VEX_PROFILE_SCOPE("Input");
+        m_inputSystem->update(deltaTime);
+    }
 
     auto cameraEntity = getCamera();
     if (cameraEntity != entt::null) {
+        VEX_PROFILE_SCOPE("Audio");
         m_audioSystem->Update(cameraEntity);
     }
 
@@ -263,7 +303,14 @@ void Engine::update(float deltaTime) {
         }
 
         if(!(m_paused || m_internally_paused)){
-            m_sceneManager->scenesUpdate(deltaTime);
+            {
+                VEX_PROFILE_SCOPE("Scenes");
+                m_sceneManager->scenesUpdate(deltaTime);
+            }
+            {
+                VEX_PROFILE_SCOPE("Systems");
+                m_systemScheduler->run(deltaTime);
+            }
             m_physicsSystem->update(deltaTime);
         }
     }else{
@@ -281,6 +328,7 @@ void Engine::update(float deltaTime) {
     }
 
     if(!m_internally_paused){
+        m_transformSystem->update();
         render();
         m_frame++;
     }
@@ -0,0 +1,265 @@
+#include <components/DynamicAABBTree.hpp>
+
+#include <algorithm>
+#include <cassert>
+
+namespace vex {
+    DynamicAABBTree::DynamicAABBTree(float margin) : m_margin(margin) {}
+
+    void DynamicAABBTree::clear() {
+        m_nodes.clear();
+        m_root = NULL_NODE;
+        m_freeList = NULL_NODE;
+        m_proxyCount = 0;
+    }
+
+    AABB DynamicAABBTree::fatten(const AABB& aabb) const {
+        glm::vec3 grow = glm::max(glm::vec3(m_margin), (aabb.max - aabb.min) * 0.1f);
+        return { aabb.min - grow, aabb.max + grow };
+    }
+
+    int32_t DynamicAABBTree::allocateNode() {
+        int32_t nodeId;
+        if (m_freeList != NULL_NODE) {
+            nodeId = m_freeList;
+            m_freeList = m_nodes[nodeId].parent;
+        } else {
+            nodeId = static_cast<int32_t>(m_nodes.size());
+            m_nodes.emplace_back();
+        }
+
+        Node& node = m_nodes[nodeId];
+        node.parent = NULL_NODE;
+        node.child1 = NULL_NODE;
+        node.child2 = NULL_NODE;
+        node.height = 0;
+        node.userData = 0;
+        return nodeId;
+    }
+
+    void DynamicAABBTree::freeNode(int32_t nodeId) {
+        m_nodes[nodeId].parent = m_freeList;
+        m_nodes[nodeId].height = -1;
+        m_freeList = nodeId;
+    }
+
+    int32_t DynamicAABBTree::createProxy(const AABB& aabb, uint32_t userData) {
+        int32_t proxyId = allocateNode();
+        m_nodes[proxyId].aabb = fatten(aabb);
+        m_nodes[proxyId].userData = userData;
+
+        insertLeaf(proxyId);
+        m_proxyCount++;
+        return proxyId;
+    }
+
+    void DynamicAABBTree::destroyProxy(int32_t proxyId) {
+        assert(proxyId >= 0 && proxyId < static_cast<int32_t>(m_nodes.size()) && m_nodes[proxyId].isLeaf());
+
+        removeLeaf(proxyId);
+        freeNode(proxyId);
+        m_proxyCount--;
+    }
+
+    bool DynamicAABBTree::moveProxy(int32_t proxyId, const AABB& aabb) {
+        assert(proxyId >= 0 && proxyId < static_cast<int32_t>(m_nodes.size()) && m_nodes[proxyId].isLeaf());
+
+        const AABB& fat = m_nodes[proxyId].aabb;
+        if (fat.contains(aabb)) [[likely]] {
+            // Still inside, but shrink if the fat box got way too big (e.g. object was scaled down).
+            AABB refit = fatten(aabb);
+            AABB huge = { refit.min - (refit.max - refit.min), refit.max + (refit.max - refit.min) };
+            if (huge.contains(fat)) {
+                return false;
+            }
+        }
+
+        removeLeaf(proxyId);
+        m_nodes[proxyId].aabb = fatten(aabb);
+        insertLeaf(proxyId);
+        return true;
+    }
+
+    void DynamicAABBTree::insertLeaf(int32_t leaf) {
+        if (m_root == NULL_NODE) {
+            m_root = leaf;
+            m_nodes[leaf].parent = NULL_NODE;
+            return;
+        }
+
+        // Descend picking the child with the cheapest surface area increase.
+        const AABB leafAABB = m_nodes[leaf].aabb;
+        int32_t index = m_root;
+        while (!m_nodes[index].isLeaf()) {
+            const Node& node = m_nodes[index];
+            int32_t child1 = node.child1;
+            int32_t child2 = node.child2;
+
+            float area = node.aabb.perimeter();
+            float combinedArea = AABB::merge(node.aabb, leafAABB).perimeter();
+
+            float cost = 2.0f * combinedArea;
+            float inheritanceCost = 2.0f * (combinedArea - area);
+
+            auto descendCost = [&](int32_t child) {
+                const Node& c = m_nodes[child];
+                float merged = AABB::merge(leafAABB, c.aabb).perimeter();
+                return c.isLeaf() ? merged + inheritanceCost : (merged - c.aabb.perimeter()) + inheritanceCost;
+            };
+
+            float cost1 = descendCost(child1);
+            float cost2 = descendCost(child2);
+
+            if (cost < cost1 && cost < cost2) break;
+
+            index = cost1 < cost2 ? child1 : child2;
+        }
+
+        int32_t sibling = index;
+        int32_t oldParent = m_nodes[sibling].parent;
+        int32_t newParent = allocateNode();
+        m_nodes[newParent].parent = oldParent;
+        m_nodes[newParent].aabb = AABB::merge(leafAABB, m_nodes[sibling].aabb);
+        m_nodes[newParent].height = m_nodes[sibling].height + 1;
+        m_nodes[newParent].child1 = sibling;
+        m_nodes[newParent].child2 = leaf;
+        m_nodes[sibling].parent = newParent;
+        m_nodes[leaf].parent = newParent;
+
+        if (oldParent != NULL_NODE) {
+            if (m_nodes[oldParent].child1 == sibling) {
+                m_nodes[oldParent].child1 = newParent;
+            } else {
+                m_nodes[oldParent].child2 = newParent;
+            }
+        } else {
+            m_root = newParent;
+        }
+
+        // Walk back up fixing heights and boxes.
+        index = m_nodes[leaf].parent;
+        while (index != NULL_NODE) {
+            index = balance(index);
+
+            Node& node = m_nodes[index];
+            node.height = 1 + std::max(m_nodes[node.child1].height, m_nodes[node.child2].height);
+            node.aabb = AABB::merge(m_nodes[node.child1].aabb, m_nodes[node.child2].aabb);
+
+            index = node.parent;
+        }
+    }
+
+    void DynamicAABBTree::removeLeaf(int32_t leaf) {
+        if (leaf == m_root) {
+            m_root = NULL_NODE;
+            return;
+        }
+
+        int32_t parent = m_nodes[leaf].parent;
+        int32_t grandParent = m_nodes[parent].parent;
+        int32_t sibling = m_nodes[parent].child1 == leaf ? m_nodes[parent].child2 : m_nodes[parent].child1;
+
+        if (grandParent == NULL_NODE) {
+            m_root = sibling;
+            m_nodes[sibling].parent = NULL_NODE;
+            freeNode(parent);
+            return;
+        }
+
+        if (m_nodes[grandParent].child1 == parent) {
+            m_nodes[grandParent].child1 = sibling;
+        } else {
+            m_nodes[grandParent].child2 = sibling;
+        }
+        m_nodes[sibling].parent = grandParent;
+        freeNode(parent);
+
+        int32_t index = grandParent;
+        while (index != NULL_NODE) {
+            index = balance(index);
+
+            Node& node = m_nodes[index];
+            node.aabb = AABB::merge(m_nodes[node.child1].aabb, m_nodes[node.child2].aabb);
+            node.height = 1 + std::max(m_nodes[node.child1].height, m_nodes[node.child2].height);
+
+            index = node.parent;
+        }
+    }
+
+    int32_t DynamicAABBTree::balance(int32_t iA) {
+        // Rotates the taller child up if subtree heights differ by more than one, returns new subtree root.
+        Node& A = m_nodes[iA];
+        if (A.isLeaf() || A.height < 2) {
+            return iA;
+        }
+
+        int32_t iB = A.child1;
+        int32_t iC = A.child2;
+        int32_t heightDiff = m_nodes[iC].height - m_nodes[iB].height;
+
+        auto rotate = [&](int32_t iUp, int32_t iDown, bool upIsChild2) {
+            Node& up = m_nodes[iUp];
+            int32_t iF = up.child1;
+            int32_t iG = up.child2;
+
+            // Swap A and up.
+            up.child1 = iA;
+            up.parent = A.parent;
+            A.parent = iUp;
+
+            if (up.parent != NULL_NODE) {
+                if (m_nodes[up.parent].child1 == iA) {
+                    m_nodes[up.parent].child1 = iUp;
+                } else {
+                    m_nodes[up.parent].child2 = iUp;
+                }
+            } else {
+                m_root = iUp;
+            }
+
+            // Keep the taller grandchild under up, move the shorter one to A.
+            int32_t iKeep = m_nodes[iF].height > m_nodes[iG].height ? iF : iG;
+            int32_t iMove = iKeep == iF ? iG : iF;
+
+            up.child2 = iKeep;
+            if (upIsChild2) {
+                A.child2 = iMove;
+            } else {
+                A.child1 = iMove;
+            }
+            m_nodes[iMove].parent = iA;
+
+            A.aabb = AABB::merge(m_nodes[iDown].aabb, m_nodes[iMove].aabb);
+            up.aabb = AABB::merge(A.aabb, m_nodes[iKeep].aabb);
+
+            A.height = 1 + std::max(m_nodes[iDown].height, m_nodes[iMove].height);
+            up.height = 1 + std::max(A.height, m_nodes[iKeep].height);
+
+            return iUp;
+        };
+
+        if (heightDiff > 1) {
+            return rotate(iC, iB, true);
+        }
+        if (heightDiff < -1) {
+            return rotate(iB, iC, false);
+        }
+        return iA;
+    }
+
+    CullResult DynamicAABBTree::cullAABB(const AABB& box, const std::array<glm::vec4, 6>& planes) {
+        const glm::vec3 center = (box.min + box.max) * 0.5f;
+        const glm::vec3 extent = (box.max - box.min) * 0.5f;
+
+        CullResult result = CullResult::INSIDE;
+        for (const auto& plane : planes) {
+            glm::vec3 normal = glm::vec3(plane);
+            float distance = glm::dot(normal, center) + plane.w;
+            float projected = glm::dot(glm::abs(normal), extent);
+
+            if (distance < -projected) return CullResult::OUTSIDE;
+            if (distance < projected) result = CullResult::INTERSECTING;
+        }
+        return result;
+    }
+}
@@ -10,8 +10,8 @@ namespace vex {
     ModelObject* createModelFromComponents(const std::string& name, MeshComponent meshComponent, TransformComponent transformComponent, Engine& engine, entt::entity parent){
         return engine.getInterface()->getMeshManager().createModel(name, meshComponent, transformComponent, parent);
     }
-    MeshComponent createMeshFromPath(const std::string& path, Engine& engine){
-        return engine.getInterface()->getMeshManager().loadMesh(path);
+    MeshComponent createMeshFromPath(const std::string& path, Engine& engine, VertexFormat format){
+        return engine.getInterface()->getMeshManager().loadMesh(path, format);
     }
     ModelObject* createModelFromPath(const std::string& path, const std::string& name, Engine& engine, entt::entity parent){
         MeshComponent meshComponent = createMeshFromPath(path, engine);
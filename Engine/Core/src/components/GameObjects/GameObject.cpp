@@ -23,13 +23,7 @@ namespace vex {
             log("[GameObject] Destroying entity ID: %d", (int)m_entity);
 
             if (m_engine.getRegistry().valid(m_entity)) {
-                 auto view = m_engine.getRegistry().view<TransformComponent>();
-                 for (auto entity : view) {
-                     auto& transform = view.get<TransformComponent>(entity);
-                     if (transform.getParent() == m_entity) {
-                         transform.setParent(entt::null);
-                     }
-                 }
+                 // HierarchySystem unparents the children when the relationship goes away.
                  m_engine.getRegistry().destroy(m_entity);
             }
 
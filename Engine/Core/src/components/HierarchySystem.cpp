@@ -0,0 +1,142 @@
+#include "components/HierarchySystem.hpp"
+#include "components/errorUtils.hpp"
+
+namespace vex {
+    void TransformComponent::setParent(entt::entity newParent) {
+        // Copies living outside the registry have no entity to link.
+        if (m_registry) {
+            const entt::entity self = entt::to_entity(m_registry->storage<TransformComponent>(), *this);
+            if (self != entt::null) {
+                HierarchySystem::setParent(*m_registry, self, newParent);
+                return;
+            }
+        }
+        parent = newParent;
+    }
+
+    HierarchySystem::HierarchySystem(entt::registry& registry) {
+        m_constructConnection = registry.on_construct<TransformComponent>().connect<&HierarchySystem::onTransformChanged>(*this);
+        m_updateConnection = registry.on_update<TransformComponent>().connect<&HierarchySystem::onTransformChanged>(*this);
+        m_destroyConnection = registry.on_destroy<RelationshipComponent>().connect<&HierarchySystem::onRelationshipDestroyed>(*this);
+    }
+
+    void HierarchySystem::onTransformChanged(entt::registry& registry, entt::entity entity) {
+        const entt::entity parent = registry.get<TransformComponent>(entity).parent;
+        if (!setParent(registry, entity, parent)) {
+            setParent(registry, entity, entt::null);
+        }
+    }
+
+    void HierarchySystem::onRelationshipDestroyed(entt::registry& registry, entt::entity entity) {
+        auto& relationship = registry.get<RelationshipComponent>(entity);
+        unlink(registry, entity, relationship);
+
+        entt::entity child = relationship.firstChild;
+        while (child != entt::null) {
+            auto& childRelationship = registry.get<RelationshipComponent>(child);
+            const entt::entity next = childRelationship.nextSibling;
+            childRelationship.parent = entt::null;
+            childRelationship.prevSibling = entt::null;
+            childRelationship.nextSibling = entt::null;
+            if (auto* transform = registry.try_get<TransformComponent>(child)) {
+                transform->parent = entt::null;
+                transform->dirty = true;
+            }
+            child = next;
+        }
+        relationship.firstChild = entt::null;
+        relationship.childCount = 0;
+    }
+
+    void HierarchySystem::unlink(entt::registry& registry, entt::entity entity, RelationshipComponent& relationship) {
+        if (relationship.parent == entt::null) return;
+
+        auto& parentRelationship = registry.get<RelationshipComponent>(relationship.parent);
+        if (relationship.prevSibling != entt::null) {
+            registry.get<RelationshipComponent>(relationship.prevSibling).nextSibling = relationship.nextSibling;
+        } else {
+            parentRelationship.firstChild = relationship.nextSibling;
+        }
+        if (relationship.nextSibling != entt::null) {
+            registry.get<RelationshipComponent>(relationship.nextSibling).prevSibling = relationship.prevSibling;
+        }
+        parentRelationship.childCount--;
+
+        relationship.parent = entt::null;
+        relationship.prevSibling = entt::null;
+        relationship.nextSibling = entt::null;
+    }
+
+    bool HierarchySystem::setParent(entt::registry& registry, entt::entity child, entt::entity parent) {
+        if (!registry.valid(child)) return false;
+
+        if (parent != entt::null) {
+            if (!registry.valid(parent)) {
+                log(LogLevel::WARNING, "Cannot parent entity %u to invalid entity %u", (uint32_t)child, (uint32_t)parent);
+                return false;
+            }
+            for (entt::entity ancestor = parent; ancestor != entt::null; ancestor = getParent(registry, ancestor)) {
+                if (ancestor == child) {
+                    log(LogLevel::WARNING, "Cannot parent entity %u to its own descendant %u", (uint32_t)child, (uint32_t)parent);
+                    return false;
+                }
+            }
+        }
+
+        auto* relationship = registry.try_get<RelationshipComponent>(child);
+        const entt::entity currentParent = relationship ? relationship->parent : entt::null;
+        if (currentParent != parent) {
+            if (!relationship) {
+                relationship = &registry.emplace<RelationshipComponent>(child);
+            }
+            unlink(registry, child, *relationship);
+
+            if (parent != entt::null) {
+                auto& parentRelationship = registry.get_or_emplace<RelationshipComponent>(parent);
+                relationship->parent = parent;
+                relationship->nextSibling = parentRelationship.firstChild;
+                if (parentRelationship.firstChild != entt::null) {
+                    registry.get<RelationshipComponent>(parentRelationship.firstChild).prevSibling = child;
+                }
+                parentRelationship.firstChild = child;
+                parentRelationship.childCount++;
+            }
+        }
+
+        if (auto* transform = registry.try_get<TransformComponent>(child); transform && transform->parent != parent) {
+            transform->parent = parent;
+            transform->dirty = true;
+        }
+        return true;
+    }
+
+    entt::entity HierarchySystem::getParent(const entt::registry& registry, entt::entity entity) {
+        const auto* relationship = registry.valid(entity) ? registry.try_get<RelationshipComponent>(entity) : nullptr;
+        return relationship ? relationship->parent : entt::null;
+    }
+
+    uint32_t HierarchySystem::getChildCount(const entt::registry& registry, entt::entity entity) {
+        const auto* relationship = registry.valid(entity) ? registry.try_get<RelationshipComponent>(entity) : nullptr;
+        return relationship ? relationship->childCount : 0;
+    }
+
+    std::vector<entt::entity> HierarchySystem::getChildren(const entt::registry& registry, entt::entity entity) {
+        std::vector<entt::entity> children;
+        children.reserve(getChildCount(registry, entity));
+        forEachChild(registry, entity, [&](entt::entity child) { children.push_back(child); });
+        return children;
+    }
+
+    void HierarchySystem::destroySubtree(entt::registry& registry, entt::entity entity) {
+        if (!registry.valid(entity)) return;
+
+        // Breadth first, so walking it backwards destroys every child before its parent and no child list is rewired on the way.
+        std::vector<entt::entity> subtree{ entity };
+        for (size_t i = 0; i < subtree.size(); i++) {
+            forEachChild(registry, subtree[i], [&](entt::entity child) { subtree.push_back(child); });
+        }
+        for (size_t i = subtree.size(); i-- > 0;) {
+            registry.destroy(subtree[i]);
+        }
+    }
+}
@@ -0,0 +1,123 @@
+#include "components/ImageWriter.hpp"
+
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <vector>
+
+namespace vex {
+    namespace {
+        constexpr size_t MAX_STORED_BLOCK = 65535; // Deflate stored blocks keep their length in 16 bits.
+        constexpr size_t MAX_IDAT_BYTES = 1 << 20;
+
+        const std::array<uint32_t, 256>& crcTable() {
+            static const std::array<uint32_t, 256> table = [] {
+                std::array<uint32_t, 256> result{};
+                for (uint32_t n = 0; n < 256; n++) {
+                    uint32_t c = n;
+                    for (int k = 0; k < 8; k++) {
+                        c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                    }
+                    result[n] = c;
+                }
+                return result;
+            }();
+            return table;
+        }
+
+        uint32_t crc32(const uint8_t* data, size_t size, uint32_t crc = 0) {
+            const auto& table = crcTable();
+            crc = ~crc;
+            for (size_t i = 0; i < size; i++) {
+                crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+            }
+            return ~crc;
+        }
+
+        void appendU32(std::vector<uint8_t>& out, uint32_t value) {
+            out.push_back(static_cast<uint8_t>(value >> 24));
+            out.push_back(static_cast<uint8_t>(value >> 16));
+            out.push_back(static_cast<uint8_t>(value >> 8));
+            out.push_back(static_cast<uint8_t>(value));
+        }
+
+        void writeChunk(std::ofstream& file, const char type[4], const uint8_t* data, size_t size) {
+            std::vector<uint8_t> header;
+            appendU32(header, static_cast<uint32_t>(size));
+            header.insert(header.end(), type, type + 4);
+
+            uint32_t crc = crc32(header.data() + 4, 4);
+            crc = crc32(data, size, crc);
+
+            std::vector<uint8_t> footer;
+            appendU32(footer, crc);
+
+            file.write(reinterpret_cast<const char*>(header.data()), header.size());
+            file.write(reinterpret_cast<const char*>(data), size);
+            file.write(reinterpret_cast<const char*>(footer.data()), footer.size());
+        }
+    }
+
+    bool writePng(const std::string& path, const uint8_t* rgba, uint32_t width, uint32_t height) {
+        if (!rgba || width == 0 || height == 0) return false;
+
+        // Every row starts with filter type 0, rows are stored as they are.
+        const size_t rowBytes = static_cast<size_t>(width) * 4;
+        std::vector<uint8_t> raw;
+        raw.reserve((rowBytes + 1) * height);
+        for (uint32_t y = 0; y < height; y++) {
+            raw.push_back(0);
+            const uint8_t* row = rgba + rowBytes * y;
+            raw.insert(raw.end(), row, row + rowBytes);
+        }
+
+        std::vector<uint8_t> zlib;
+        zlib.reserve(raw.size() + raw.size() / MAX_STORED_BLOCK * 5 + 16);
+        zlib.push_back(0x78);
+        zlib.push_back(0x01);
+
+        uint32_t adlerA = 1;
+        uint32_t adlerB = 0;
+        size_t offset = 0;
+        do {
+            const size_t blockSize = std::min(MAX_STORED_BLOCK, raw.size() - offset);
+            const bool last = offset + blockSize == raw.size();
+            zlib.push_back(last ? 1 : 0);
+            zlib.push_back(static_cast<uint8_t>(blockSize));
+            zlib.push_back(static_cast<uint8_t>(blockSize >> 8));
+            zlib.push_back(static_cast<uint8_t>(~blockSize));
+            zlib.push_back(static_cast<uint8_t>(~blockSize >> 8));
+            zlib.insert(zlib.end(), raw.begin() + offset, raw.begin() + offset + blockSize);
+
+            for (size_t i = offset; i < offset + blockSize; i++) {
+                adlerA = (adlerA + raw[i]) % 65521;
+                adlerB = (adlerB + adlerA) % 65521;
+            }
+            offset += blockSize;
+        } while (offset < raw.size());
+        appendU32(zlib, (adlerB << 16) | adlerA);
+
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file) return false;
+
+        static const uint8_t signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+        file.write(reinterpret_cast<const char*>(signature), sizeof(signature));
+
+        std::vector<uint8_t> header;
+        appendU32(header, width);
+        appendU32(header, height);
+        header.push_back(8); // bit depth
+        header.push_back(6); // RGBA
+        header.push_back(0); // deflate
+        header.push_back(0); // adaptive filtering
+        header.push_back(0); // no interlace
+        writeChunk(file, "IHDR", header.data(), header.size());
+
+        for (size_t chunk = 0; chunk < zlib.size(); chunk += MAX_IDAT_BYTES) {
+            writeChunk(file, "IDAT", zlib.data() + chunk, std::min(MAX_IDAT_BYTES, zlib.size() - chunk));
+        }
+        writeChunk(file, "IEND", nullptr, 0);
+
+        return static_cast<bool>(file);
+    }
+}
@@ -0,0 +1,146 @@
+#include "components/JobPool.hpp"
+#include "components/Profiler.hpp"
+#include "components/errorUtils.hpp"
+
+#include <algorithm>
+#include <string>
+
+namespace vex {
+    namespace {
+        // Which pool and queue the calling thread works for, null on threads that aren't workers.
+        thread_local const JobPool* t_pool = nullptr;
+        thread_local uint32_t t_queueIndex = 0;
+    }
+
+    JobPool::JobPool(uint32_t threadCount) : m_threadCount(std::max(threadCount, 1u)) {
+        m_queues.reserve(m_threadCount);
+        for (uint32_t i = 0; i < m_threadCount; i++) {
+            m_queues.push_back(std::make_unique<WorkQueue>());
+        }
+        for (uint32_t i = 1; i < m_threadCount; i++) {
+            m_workers.emplace_back(&JobPool::workerLoop, this, i);
+        }
+
+        log("JobPool created with %u threads", m_threadCount);
+    }
+
+    JobPool::~JobPool() {
+        {
+            std::lock_guard<std::mutex> lock(m_sleepMutex);
+            m_stop = true;
+        }
+        m_workCondition.notify_all();
+        for (auto& worker : m_workers) {
+            worker.join();
+        }
+    }
+
+    void JobPool::submit(JobGroup& group, Job job, bool mainThread) {
+        group.m_pending.fetch_add(1, std::memory_order_relaxed);
+
+        // Counted before it's queued, a thread woken early finds nothing and goes back to sleep.
+        {
+            std::lock_guard<std::mutex> lock(m_sleepMutex);
+            (mainThread ? m_queuedMainThreadJobs : m_queuedJobs).fetch_add(1, std::memory_order_relaxed);
+        }
+
+        WorkQueue& queue = mainThread ? m_mainThreadQueue : *m_queues[t_pool == this ? t_queueIndex : 0];
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.jobs.push_back({ std::move(job), &group });
+        }
+
+        if (!mainThread) {
+            m_workCondition.notify_one();
+        }
+        m_waitCondition.notify_all();
+    }
+
+    bool JobPool::takeJob(uint32_t queueIndex, QueuedJob& out) {
+        {
+            WorkQueue& own = *m_queues[queueIndex];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.jobs.empty()) {
+                out = std::move(own.jobs.back());
+                own.jobs.pop_back();
+                m_queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+
+        for (uint32_t offset = 1; offset < m_threadCount; offset++) {
+            WorkQueue& victim = *m_queues[(queueIndex + offset) % m_threadCount];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.jobs.empty()) {
+                out = std::move(victim.jobs.front());
+                victim.jobs.pop_front();
+                m_queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool JobPool::takeMainThreadJob(QueuedJob& out) {
+        std::lock_guard<std::mutex> lock(m_mainThreadQueue.mutex);
+        if (m_mainThreadQueue.jobs.empty()) return false;
+        out = std::move(m_mainThreadQueue.jobs.front());
+        m_mainThreadQueue.jobs.pop_front();
+        m_queuedMainThreadJobs.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    void JobPool::runJob(QueuedJob& job) {
+        try {
+            job.job();
+        } catch (const std::exception& e) {
+            log(LogLevel::ERROR, "Job failed: %s", e.what());
+        }
+        // Captures are released before the group can be seen as done, the waiter may free what they point to right after.
+        job.job = nullptr;
+
+        if (job.group->m_pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            { std::lock_guard<std::mutex> lock(m_sleepMutex); }
+            m_waitCondition.notify_all();
+        }
+        job.group = nullptr;
+    }
+
+    void JobPool::workerLoop(uint32_t queueIndex) {
+        t_pool = this;
+        t_queueIndex = queueIndex;
+        Profiler::setThreadName(("Job worker " + std::to_string(queueIndex)).c_str());
+
+        QueuedJob job;
+        while (true) {
+            if (takeJob(queueIndex, job)) {
+                runJob(job);
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(m_sleepMutex);
+            m_workCondition.wait(lock, [&] { return m_stop || m_queuedJobs.load(std::memory_order_relaxed) > 0; });
+            if (m_stop) return;
+        }
+    }
+
+    void JobPool::wait(JobGroup& group) {
+        // Workers waiting inside a job must not pick up main thread jobs.
+        const bool worker = t_pool == this;
+        const uint32_t queueIndex = worker ? t_queueIndex : 0;
+
+        QueuedJob job;
+        while (!group.isDone()) {
+            if ((!worker && takeMainThreadJob(job)) || takeJob(queueIndex, job)) {
+                runJob(job);
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(m_sleepMutex);
+            m_waitCondition.wait(lock, [&] {
+                return group.isDone() || m_queuedJobs.load(std::memory_order_relaxed) > 0 ||
+                       (!worker && m_queuedMainThreadJobs.load(std::memory_order_relaxed) > 0);
+            });
+        }
+    }
+}
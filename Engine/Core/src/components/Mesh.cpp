@@ -320,4 +320,18 @@ void MeshData::processScene(const aiScene* scene, const std::string& textureBase
         if (vfs) importer.SetIOHandler(nullptr);
         meshPath = realPath;
     }
+
+    size_t MeshData::getMemoryBytes() const {
+        size_t bytes = submeshes.capacity() * sizeof(Submesh);
+        for (const auto& submesh : submeshes) {
+            bytes += submesh.vertices.capacity() * sizeof(Vertex);
+            bytes += submesh.indices.capacity() * sizeof(uint32_t);
+            bytes += submesh.triangleCenters.capacity() * sizeof(glm::vec3);
+            bytes += submesh.lods.capacity() * sizeof(SubmeshLod);
+            for (const auto& lod : submesh.lods) {
+                bytes += lod.indices.capacity() * sizeof(uint32_t);
+            }
+        }
+        return bytes;
+    }
 }
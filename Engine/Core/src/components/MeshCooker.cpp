@@ -0,0 +1,209 @@
+#include "components/MeshCooker.hpp"
+
+#include <algorithm>
+#include <cfloat>
+#include <cstring>
+#include <filesystem>
+
+namespace vex {
+    static_assert(MESH_CONTAINER_MAX_LODS == MAX_MESH_LODS - 1, "MeshContainerSubmesh has to hold every generated level");
+
+    namespace {
+        constexpr size_t BLOB_ALIGNMENT = 16;
+
+        size_t alignBlob(size_t offset) {
+            return (offset + BLOB_ALIGNMENT - 1) & ~(BLOB_ALIGNMENT - 1);
+        }
+
+        std::string meshFolder(const std::string& sourcePath) {
+            std::filesystem::path folder(sourcePath);
+            folder.remove_filename();
+            return folder.string();
+        }
+
+        /// Appends a blob at the next aligned offset and returns that offset.
+        uint64_t appendBlob(std::vector<uint8_t>& file, const void* data, size_t size) {
+            const size_t offset = alignBlob(file.size());
+            file.resize(offset + size);
+            if (size > 0) {
+                std::memcpy(file.data() + offset, data, size);
+            }
+            return offset;
+        }
+
+        bool blobInRange(uint64_t offset, uint64_t count, uint64_t elementSize, size_t fileSize) {
+            if (offset > fileSize) return false;
+            return count <= (fileSize - offset) / elementSize;
+        }
+
+        void fillTriangleCenters(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, std::vector<glm::vec3>& centers) {
+            centers.clear();
+            centers.reserve(indices.size() / 3);
+            for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+                const auto& p0 = vertices[indices[i + 0]].position;
+                const auto& p1 = vertices[indices[i + 1]].position;
+                const auto& p2 = vertices[indices[i + 2]].position;
+                centers.push_back((p0 + p1 + p2) / 3.0f);
+            }
+        }
+
+        bool indicesInRange(const std::vector<uint32_t>& indices, size_t vertexCount) {
+            return indices.empty() || *std::max_element(indices.begin(), indices.end()) < vertexCount;
+        }
+
+        template <typename T>
+        void readBlob(const uint8_t* file, uint64_t offset, uint64_t count, std::vector<T>& out) {
+            out.resize(count);
+            if (count > 0) {
+                std::memcpy(out.data(), file + offset, count * sizeof(T));
+            }
+        }
+    }
+
+    std::string cookedMeshPath(const std::string& sourcePath) {
+        return std::filesystem::path(sourcePath).replace_extension(MESH_CONTAINER_EXTENSION).string();
+    }
+
+    uint64_t hashMeshSource(const void* data, size_t size, const MeshLodSettings& settings) {
+        const MeshContainerHeader header;
+        uint64_t hash = hashBytes(&header.version, sizeof(header.version));
+        hash = hashBytes(&settings.levelCount, sizeof(settings.levelCount), hash);
+        hash = hashBytes(&settings.reductionPerLevel, sizeof(settings.reductionPerLevel), hash);
+        hash = hashBytes(&settings.maxError, sizeof(settings.maxError), hash);
+        hash = hashBytes(&settings.minTriangles, sizeof(settings.minTriangles), hash);
+        return hashBytes(data, size, hash);
+    }
+
+    MeshBounds computeMeshBounds(const MeshData& meshData) {
+        glm::vec3 min = glm::vec3(FLT_MAX);
+        glm::vec3 max = glm::vec3(-FLT_MAX);
+
+        for (const auto& submesh : meshData.submeshes) {
+            for (const auto& vertex : submesh.vertices) {
+                min = glm::min(min, vertex.position);
+                max = glm::max(max, vertex.position);
+            }
+        }
+
+        MeshBounds bounds;
+        bounds.center = (min + max) * 0.5f;
+        bounds.radius = glm::length(max - bounds.center);
+        return bounds;
+    }
+
+    void computeTriangleCenters(Submesh& submesh) {
+        fillTriangleCenters(submesh.vertices, submesh.indices, submesh.triangleCenters);
+    }
+
+    void computeTriangleCenters(const Submesh& submesh, std::vector<glm::vec3>& outCenters) {
+        fillTriangleCenters(submesh.vertices, submesh.indices, outCenters);
+    }
+
+    std::vector<uint8_t> writeCookedMesh(const MeshData& meshData, const std::string& sourcePath, uint64_t sourceHash) {
+        const MeshBounds bounds = computeMeshBounds(meshData);
+        const std::string folder = meshFolder(sourcePath);
+
+        MeshContainerHeader header;
+        header.sourceHash = sourceHash;
+        header.submeshCount = static_cast<uint32_t>(meshData.submeshes.size());
+        header.boundsCenter[0] = bounds.center.x;
+        header.boundsCenter[1] = bounds.center.y;
+        header.boundsCenter[2] = bounds.center.z;
+        header.boundsRadius = bounds.radius;
+
+        std::vector<MeshContainerSubmesh> records(meshData.submeshes.size());
+        std::vector<uint8_t> file(sizeof(MeshContainerHeader) + records.size() * sizeof(MeshContainerSubmesh));
+
+        std::vector<glm::vec3> centers;
+        for (size_t i = 0; i < meshData.submeshes.size(); i++) {
+            const Submesh& submesh = meshData.submeshes[i];
+            MeshContainerSubmesh& record = records[i];
+            std::memset(&record, 0, sizeof(record));
+
+            record.vertexCount = static_cast<uint32_t>(submesh.vertices.size());
+            record.vertexOffset = appendBlob(file, submesh.vertices.data(), submesh.vertices.size() * sizeof(Vertex));
+            record.indexCount = static_cast<uint32_t>(submesh.indices.size());
+            record.indexOffset = appendBlob(file, submesh.indices.data(), submesh.indices.size() * sizeof(uint32_t));
+
+            const std::vector<glm::vec3>* triangleCenters = &submesh.triangleCenters;
+            if (submesh.triangleCenters.size() != submesh.indices.size() / 3) {
+                fillTriangleCenters(submesh.vertices, submesh.indices, centers);
+                triangleCenters = &centers;
+            }
+            record.centerOffset = appendBlob(file, triangleCenters->data(), triangleCenters->size() * sizeof(glm::vec3));
+
+            std::string texture = submesh.texturePath;
+            if (!folder.empty() && texture.compare(0, folder.size(), folder) == 0) {
+                texture.erase(0, folder.size());
+            }
+            record.textureLength = static_cast<uint32_t>(texture.size());
+            record.textureOffset = appendBlob(file, texture.data(), texture.size());
+
+            record.lodCount = static_cast<uint32_t>(std::min<size_t>(submesh.lods.size(), MESH_CONTAINER_MAX_LODS));
+            for (uint32_t level = 0; level < record.lodCount; level++) {
+                const SubmeshLod& lod = submesh.lods[level];
+                record.lods[level].indexCount = static_cast<uint32_t>(lod.indices.size());
+                record.lods[level].indexOffset = appendBlob(file, lod.indices.data(), lod.indices.size() * sizeof(uint32_t));
+                record.lods[level].error = lod.error;
+            }
+        }
+
+        std::memcpy(file.data(), &header, sizeof(header));
+        if (!records.empty()) {
+            std::memcpy(file.data() + sizeof(header), records.data(), records.size() * sizeof(MeshContainerSubmesh));
+        }
+        return file;
+    }
+
+    bool readCookedMesh(const void* data, size_t size, const std::string& sourcePath, MeshData& outMeshData, MeshBounds& outBounds, uint64_t& outSourceHash) {
+        if (!isMeshContainer(data, size)) return false;
+
+        const uint8_t* file = static_cast<const uint8_t*>(data);
+        MeshContainerHeader header;
+        std::memcpy(&header, file, sizeof(header));
+
+        if (!blobInRange(sizeof(header), header.submeshCount, sizeof(MeshContainerSubmesh), size)) return false;
+
+        const std::string folder = meshFolder(sourcePath);
+        std::vector<Submesh> submeshes(header.submeshCount);
+
+        for (uint32_t i = 0; i < header.submeshCount; i++) {
+            MeshContainerSubmesh record;
+            std::memcpy(&record, file + sizeof(header) + i * sizeof(MeshContainerSubmesh), sizeof(record));
+
+            if (!blobInRange(record.vertexOffset, record.vertexCount, sizeof(Vertex), size) ||
+                !blobInRange(record.indexOffset, record.indexCount, sizeof(uint32_t), size) ||
+                !blobInRange(record.centerOffset, record.indexCount / 3, sizeof(glm::vec3), size) ||
+                !blobInRange(record.textureOffset, record.textureLength, 1, size) ||
+                record.lodCount > MESH_CONTAINER_MAX_LODS) {
+                return false;
+            }
+            for (uint32_t level = 0; level < record.lodCount; level++) {
+                if (!blobInRange(record.lods[level].indexOffset, record.lods[level].indexCount, sizeof(uint32_t), size)) return false;
+            }
+
+            Submesh& submesh = submeshes[i];
+            readBlob(file, record.vertexOffset, record.vertexCount, submesh.vertices);
+            readBlob(file, record.indexOffset, record.indexCount, submesh.indices);
+            readBlob(file, record.centerOffset, record.indexCount / 3, submesh.triangleCenters);
+            if (!indicesInRange(submesh.indices, submesh.vertices.size())) return false;
+
+            if (record.textureLength > 0) {
+                submesh.texturePath = folder + std::string(reinterpret_cast<const char*>(file + record.textureOffset), record.textureLength);
+            }
+
+            submesh.lods.resize(record.lodCount);
+            for (uint32_t level = 0; level < record.lodCount; level++) {
+                readBlob(file, record.lods[level].indexOffset, record.lods[level].indexCount, submesh.lods[level].indices);
+                submesh.lods[level].error = record.lods[level].error;
+                if (!indicesInRange(submesh.lods[level].indices, submesh.vertices.size())) return false;
+            }
+        }
+
+        outMeshData.submeshes = std::move(submeshes);
+        outBounds.center = glm::vec3(header.boundsCenter[0], header.boundsCenter[1], header.boundsCenter[2]);
+        outBounds.radius = header.boundsRadius;
+        outSourceHash = header.sourceHash;
+        return true;
+    }
+}
@@ -0,0 +1,459 @@
+#include "components/MeshSimplifier.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <queue>
+#include <unordered_map>
+#include <utility>
+
+namespace vex {
+    namespace {
+        // Collapses turning a triangle by more than ~78 degrees are rejected, catches folds before they become flips.
+        constexpr double MIN_NORMAL_COSINE = 0.2;
+
+        /// Sum of squared distances to a set of planes, stored as symmetric 3x3 matrix, vector and constant.
+        struct Quadric {
+            double a00 = 0.0, a01 = 0.0, a02 = 0.0, a11 = 0.0, a12 = 0.0, a22 = 0.0;
+            double b0 = 0.0, b1 = 0.0, b2 = 0.0;
+            double c = 0.0;
+
+            void addPlane(const glm::dvec3& n, double d) {
+                a00 += n.x * n.x; a01 += n.x * n.y; a02 += n.x * n.z;
+                a11 += n.y * n.y; a12 += n.y * n.z; a22 += n.z * n.z;
+                b0 += n.x * d; b1 += n.y * d; b2 += n.z * d;
+                c += d * d;
+            }
+
+            Quadric& operator+=(const Quadric& other) {
+                a00 += other.a00; a01 += other.a01; a02 += other.a02;
+                a11 += other.a11; a12 += other.a12; a22 += other.a22;
+                b0 += other.b0; b1 += other.b1; b2 += other.b2;
+                c += other.c;
+                return *this;
+            }
+
+            double evaluate(const glm::dvec3& p) const {
+                const double value = a00 * p.x * p.x + a11 * p.y * p.y + a22 * p.z * p.z
+                                   + 2.0 * (a01 * p.x * p.y + a02 * p.x * p.z + a12 * p.y * p.z)
+                                   + 2.0 * (b0 * p.x + b1 * p.y + b2 * p.z) + c;
+                return std::max(value, 0.0);
+            }
+        };
+
+        template <typename T>
+        struct BytewiseHash {
+            size_t operator()(const T& value) const {
+                uint32_t words[sizeof(T) / sizeof(uint32_t)];
+                std::memcpy(words, &value, sizeof(T));
+                size_t hash = 0;
+                for (uint32_t word : words) {
+                    hash = (hash ^ word) * 0x100000001B3ull;
+                }
+                return hash;
+            }
+        };
+
+        template <typename T>
+        struct BytewiseEqual {
+            bool operator()(const T& a, const T& b) const { return std::memcmp(&a, &b, sizeof(T)) == 0; }
+        };
+
+        /// Half edge collapse simplifier working on welded positions, corners keep referencing original vertices ("wedges").
+        class QuadricSimplifier {
+        public:
+            QuadricSimplifier(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices) {
+                weld(vertices);
+
+                m_triangles.reserve(indices.size() / 3);
+                for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+                    const std::array<uint32_t, 3> corners = { m_wedgeOf[indices[i]], m_wedgeOf[indices[i + 1]], m_wedgeOf[indices[i + 2]] };
+                    const uint32_t p0 = m_positionOf[corners[0]], p1 = m_positionOf[corners[1]], p2 = m_positionOf[corners[2]];
+                    if (p0 == p1 || p1 == p2 || p0 == p2) continue;
+
+                    const uint32_t triangle = static_cast<uint32_t>(m_triangles.size());
+                    m_triangles.push_back(corners);
+                    m_positionTriangles[p0].push_back(triangle);
+                    m_positionTriangles[p1].push_back(triangle);
+                    m_positionTriangles[p2].push_back(triangle);
+                }
+                m_alive.assign(m_triangles.size(), 1);
+                m_triangleCount = m_triangles.size();
+
+                buildQuadrics();
+                for (uint32_t p = 0; p < m_positions.size(); p++) {
+                    pushBestCollapse(p);
+                }
+            }
+
+            /// Collapses until `targetTriangles` or `maxCost` is reached. Can be called again with a lower target to continue.
+            void run(size_t targetTriangles, double maxCost) {
+                while (m_triangleCount > targetTriangles && !m_queue.empty()) {
+                    const Candidate candidate = m_queue.top();
+                    if (m_removed[candidate.from] || candidate.version != m_versions[candidate.from]) {
+                        m_queue.pop();
+                        continue;
+                    }
+                    if (candidate.cost > maxCost) break;
+                    m_queue.pop();
+
+                    // Rings of both ends may have changed since the candidate was queued without touching `from` directly.
+                    if (m_removed[candidate.to] || !isValidCollapse(candidate.from, candidate.to)) {
+                        m_versions[candidate.from]++;
+                        pushBestCollapse(candidate.from);
+                        continue;
+                    }
+
+                    collapse(candidate.from, candidate.to);
+                    m_largestCost = std::max(m_largestCost, candidate.cost);
+
+                    gatherEdges(candidate.to, m_ring);
+                    const std::vector<Edge> ring = m_ring;
+                    m_versions[candidate.to]++;
+                    pushBestCollapse(candidate.to);
+                    for (const Edge& edge : ring) {
+                        m_versions[edge.position]++;
+                        pushBestCollapse(edge.position);
+                    }
+                }
+            }
+
+            /// Returns current triangles as indices into the original vertices.
+            std::vector<uint32_t> getIndices() const {
+                std::vector<uint32_t> result;
+                result.reserve(m_triangleCount * 3);
+                for (size_t t = 0; t < m_triangles.size(); t++) {
+                    if (!m_alive[t]) continue;
+                    result.insert(result.end(), m_triangles[t].begin(), m_triangles[t].end());
+                }
+                return result;
+            }
+
+            /// Returns error of the current triangles, see `simplifyMesh`.
+            float getError() const { return static_cast<float>(std::sqrt(m_largestCost)); }
+
+        private:
+            struct Edge {
+                uint32_t position;
+                uint32_t triangles;
+            };
+
+            struct Candidate {
+                double cost;
+                uint32_t from;
+                uint32_t to;
+                uint32_t version;
+
+                bool operator>(const Candidate& other) const { return cost > other.cost; }
+            };
+
+            void weld(const std::vector<Vertex>& vertices) {
+                std::unordered_map<Vertex, uint32_t, BytewiseHash<Vertex>, BytewiseEqual<Vertex>> wedges;
+                std::unordered_map<glm::vec3, uint32_t, BytewiseHash<glm::vec3>, BytewiseEqual<glm::vec3>> positions;
+                wedges.reserve(vertices.size());
+                positions.reserve(vertices.size());
+
+                // Relative to bounds center, keeps quadric evaluation precise for meshes far from the origin.
+                glm::vec3 min = glm::vec3(FLT_MAX);
+                glm::vec3 max = glm::vec3(-FLT_MAX);
+                for (const auto& vertex : vertices) {
+                    min = glm::min(min, vertex.position);
+                    max = glm::max(max, vertex.position);
+                }
+                const glm::dvec3 center = vertices.empty() ? glm::dvec3(0.0) : (glm::dvec3(min) + glm::dvec3(max)) * 0.5;
+
+                m_wedgeOf.resize(vertices.size());
+                m_positionOf.assign(vertices.size(), UINT32_MAX);
+                for (uint32_t i = 0; i < vertices.size(); i++) {
+                    const uint32_t wedge = wedges.try_emplace(vertices[i], i).first->second;
+                    m_wedgeOf[i] = wedge;
+                    if (wedge != i) continue;
+
+                    auto [it, inserted] = positions.try_emplace(vertices[i].position, static_cast<uint32_t>(m_positions.size()));
+                    if (inserted) {
+                        m_positions.push_back(glm::dvec3(vertices[i].position) - center);
+                    }
+                    m_positionOf[i] = it->second;
+                }
+
+                m_positionTriangles.resize(m_positions.size());
+                m_quadrics.resize(m_positions.size());
+                m_versions.assign(m_positions.size(), 0);
+                m_removed.assign(m_positions.size(), 0);
+            }
+
+            uint32_t cornerPosition(uint32_t triangle, int corner) const { return m_positionOf[m_triangles[triangle][corner]]; }
+
+            void buildQuadrics() {
+                std::vector<Edge> ring;
+                for (uint32_t t = 0; t < m_triangles.size(); t++) {
+                    const glm::dvec3& p0 = m_positions[cornerPosition(t, 0)];
+                    const glm::dvec3 normal = glm::cross(m_positions[cornerPosition(t, 1)] - p0, m_positions[cornerPosition(t, 2)] - p0);
+                    const double length = glm::length(normal);
+                    if (length <= 0.0) continue;
+
+                    const glm::dvec3 n = normal / length;
+                    Quadric plane;
+                    plane.addPlane(n, -glm::dot(n, p0));
+                    for (int corner = 0; corner < 3; corner++) {
+                        m_quadrics[cornerPosition(t, corner)] += plane;
+                    }
+
+                    // Border and seam edges also get a plane perpendicular to the triangle, so moving along the surface away from them costs too.
+                    for (int corner = 0; corner < 3; corner++) {
+                        const uint32_t a = cornerPosition(t, corner);
+                        const uint32_t b = cornerPosition(t, (corner + 1) % 3);
+                        if (!isBorderOrSeam(t, a, b)) continue;
+
+                        const glm::dvec3 edge = m_positions[b] - m_positions[a];
+                        const glm::dvec3 sideNormal = glm::cross(edge, n);
+                        const double sideLength = glm::length(sideNormal);
+                        if (sideLength <= 0.0) continue;
+
+                        Quadric side;
+                        side.addPlane(sideNormal / sideLength, -glm::dot(sideNormal / sideLength, m_positions[a]));
+                        m_quadrics[a] += side;
+                        m_quadrics[b] += side;
+                    }
+                }
+            }
+
+            uint32_t wedgeAt(uint32_t triangle, uint32_t position) const {
+                for (int corner = 0; corner < 3; corner++) {
+                    if (cornerPosition(triangle, corner) == position) return m_triangles[triangle][corner];
+                }
+                return UINT32_MAX;
+            }
+
+            bool isBorderOrSeam(uint32_t triangle, uint32_t a, uint32_t b) const {
+                uint32_t sharing = 0;
+                for (uint32_t other : m_positionTriangles[a]) {
+                    if (other == triangle || wedgeAt(other, b) == UINT32_MAX) continue;
+                    sharing++;
+                    if (wedgeAt(other, a) != wedgeAt(triangle, a) || wedgeAt(other, b) != wedgeAt(triangle, b)) return true;
+                }
+                return sharing != 1;
+            }
+
+            /// Collects positions connected to `position` and how many live triangles use each edge, dropping dead triangles from its list.
+            void gatherEdges(uint32_t position, std::vector<Edge>& out) {
+                out.clear();
+                auto& triangles = m_positionTriangles[position];
+                std::erase_if(triangles, [this](uint32_t t) { return !m_alive[t]; });
+
+                for (uint32_t t : triangles) {
+                    for (int corner = 0; corner < 3; corner++) {
+                        const uint32_t other = cornerPosition(t, corner);
+                        if (other == position) continue;
+
+                        auto it = std::find_if(out.begin(), out.end(), [other](const Edge& e) { return e.position == other; });
+                        if (it == out.end()) {
+                            out.push_back({ other, 1 });
+                        } else {
+                            it->triangles++;
+                        }
+                    }
+                }
+            }
+
+            static const Edge* findEdge(const std::vector<Edge>& edges, uint32_t position) {
+                auto it = std::find_if(edges.begin(), edges.end(), [position](const Edge& e) { return e.position == position; });
+                return it == edges.end() ? nullptr : &*it;
+            }
+
+            bool isValidCollapse(uint32_t from, uint32_t to) {
+                gatherEdges(from, m_fromEdges);
+                gatherEdges(to, m_toEdges);
+
+                const Edge* edge = findEdge(m_fromEdges, to);
+                if (!edge) return false;
+
+                bool fromBorder = false;
+                for (const Edge& e : m_fromEdges) {
+                    if (e.triangles > 2) return false;
+                    fromBorder |= e.triangles == 1;
+                }
+                for (const Edge& e : m_toEdges) {
+                    if (e.triangles > 2) return false;
+                }
+                if (fromBorder && edge->triangles != 1) return false;
+
+                // Link condition, the only shared neighbours may be the opposite corners of triangles on the edge, otherwise topology changes.
+                uint32_t shared = 0;
+                for (const Edge& e : m_fromEdges) {
+                    if (findEdge(m_toEdges, e.position)) shared++;
+                }
+                if (shared != edge->triangles) return false;
+
+                // Every attribute variant of `from` must map onto exactly one variant of `to` through a triangle they share.
+                m_wedgeMap.clear();
+                for (uint32_t t : m_positionTriangles[from]) {
+                    const uint32_t toWedge = wedgeAt(t, to);
+                    if (toWedge == UINT32_MAX) continue;
+
+                    const uint32_t fromWedge = wedgeAt(t, from);
+                    auto it = std::find_if(m_wedgeMap.begin(), m_wedgeMap.end(), [fromWedge](const auto& m) { return m.first == fromWedge; });
+                    if (it == m_wedgeMap.end()) {
+                        m_wedgeMap.emplace_back(fromWedge, toWedge);
+                    } else if (it->second != toWedge) {
+                        return false;
+                    }
+                }
+
+                const glm::dvec3& target = m_positions[to];
+                for (uint32_t t : m_positionTriangles[from]) {
+                    if (wedgeAt(t, to) != UINT32_MAX) continue;
+
+                    const uint32_t fromWedge = wedgeAt(t, from);
+                    if (std::none_of(m_wedgeMap.begin(), m_wedgeMap.end(), [fromWedge](const auto& m) { return m.first == fromWedge; })) {
+                        return false;
+                    }
+
+                    glm::dvec3 corners[3];
+                    for (int corner = 0; corner < 3; corner++) {
+                        corners[corner] = m_positions[cornerPosition(t, corner)];
+                    }
+                    const glm::dvec3 before = glm::cross(corners[1] - corners[0], corners[2] - corners[0]);
+                    for (int corner = 0; corner < 3; corner++) {
+                        if (cornerPosition(t, corner) == from) corners[corner] = target;
+                    }
+                    const glm::dvec3 after = glm::cross(corners[1] - corners[0], corners[2] - corners[0]);
+
+                    if (glm::dot(before, after) <= MIN_NORMAL_COSINE * glm::length(before) * glm::length(after)) return false;
+                }
+                return true;
+            }
+
+            /// Moves every triangle of `from` onto `to`, uses the wedge mapping left by the last successful `isValidCollapse`.
+            void collapse(uint32_t from, uint32_t to) {
+                for (uint32_t t : m_positionTriangles[from]) {
+                    if (wedgeAt(t, to) != UINT32_MAX) {
+                        m_alive[t] = 0;
+                        m_triangleCount--;
+                        continue;
+                    }
+
+                    for (int corner = 0; corner < 3; corner++) {
+                        if (cornerPosition(t, corner) != from) continue;
+                        const uint32_t fromWedge = m_triangles[t][corner];
+                        m_triangles[t][corner] = std::find_if(m_wedgeMap.begin(), m_wedgeMap.end(), [fromWedge](const auto& m) { return m.first == fromWedge; })->second;
+                    }
+                    m_positionTriangles[to].push_back(t);
+                }
+
+                m_quadrics[to] += m_quadrics[from];
+                m_positionTriangles[from].clear();
+                m_removed[from] = 1;
+            }
+
+            /// Queues the cheapest valid collapse of `from`, if it has any.
+            void pushBestCollapse(uint32_t from) {
+                if (m_removed[from]) return;
+
+                gatherEdges(from, m_ring);
+                m_costs.clear();
+                for (const Edge& edge : m_ring) {
+                    if (edge.triangles > 2) return;
+                    const glm::dvec3& target = m_positions[edge.position];
+                    m_costs.emplace_back(m_quadrics[from].evaluate(target) + m_quadrics[edge.position].evaluate(target), edge.position);
+                }
+                std::sort(m_costs.begin(), m_costs.end());
+
+                for (const auto& [cost, to] : m_costs) {
+                    if (isValidCollapse(from, to)) {
+                        m_queue.push({ cost, from, to, m_versions[from] });
+                        return;
+                    }
+                }
+            }
+
+            std::vector<uint32_t> m_wedgeOf;    // original vertex -> first identical vertex
+            std::vector<uint32_t> m_positionOf; // wedge -> welded position, only valid for wedges
+            std::vector<glm::dvec3> m_positions;
+            std::vector<Quadric> m_quadrics;
+            std::vector<std::vector<uint32_t>> m_positionTriangles;
+            std::vector<uint32_t> m_versions;
+            std::vector<uint8_t> m_removed;
+
+            std::vector<std::array<uint32_t, 3>> m_triangles;
+            std::vector<uint8_t> m_alive;
+            size_t m_triangleCount = 0;
+            double m_largestCost = 0.0;
+
+            std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate>> m_queue;
+
+            std::vector<Edge> m_ring;
+            std::vector<Edge> m_fromEdges;
+            std::vector<Edge> m_toEdges;
+            std::vector<std::pair<double, uint32_t>> m_costs;
+            std::vector<std::pair<uint32_t, uint32_t>> m_wedgeMap;
+        };
+    }
+
+    std::vector<uint32_t> simplifyMesh(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices,
+                                       size_t targetIndexCount, float targetError, float* outError) {
+        QuadricSimplifier simplifier(vertices, indices);
+
+        const double maxError = std::max(static_cast<double>(targetError), 0.0);
+        simplifier.run(targetIndexCount / 3, maxError * maxError);
+
+        if (outError) {
+            *outError = simplifier.getError();
+        }
+        return simplifier.getIndices();
+    }
+
+    void generateLods(MeshData& meshData, const MeshLodSettings& settings) {
+        const uint32_t levelCount = std::min(settings.levelCount, MAX_MESH_LODS - 1);
+
+        for (auto& submesh : meshData.submeshes) {
+            submesh.lods.clear();
+            if (levelCount == 0 || submesh.indices.size() / 3 < settings.minTriangles) continue;
+
+            glm::vec3 min = glm::vec3(FLT_MAX);
+            glm::vec3 max = glm::vec3(-FLT_MAX);
+            for (const auto& vertex : submesh.vertices) {
+                min = glm::min(min, vertex.position);
+                max = glm::max(max, vertex.position);
+            }
+            const double maxError = static_cast<double>(settings.maxError) * glm::length(max - min) * 0.5;
+
+            // One pass for the whole chain, quadrics keep measuring against the imported surface so each level's error is absolute.
+            QuadricSimplifier simplifier(submesh.vertices, submesh.indices);
+            size_t previousCount = submesh.indices.size();
+            for (uint32_t level = 1; level <= levelCount; level++) {
+                const size_t targetTriangles = static_cast<size_t>(static_cast<double>(previousCount / 3) * settings.reductionPerLevel);
+                if (targetTriangles < settings.minTriangles) break;
+
+                simplifier.run(targetTriangles, maxError * maxError);
+
+                SubmeshLod lod;
+                lod.indices = simplifier.getIndices();
+                lod.error = simplifier.getError();
+                if (lod.indices.empty() || lod.indices.size() * 10 > previousCount * 9) break;
+
+                previousCount = lod.indices.size();
+                submesh.lods.push_back(std::move(lod));
+            }
+        }
+    }
+
+    std::vector<float> computeLodErrors(const MeshData& meshData) {
+        size_t levelCount = 1;
+        for (const auto& submesh : meshData.submeshes) {
+            levelCount = std::max(levelCount, 1 + std::min<size_t>(submesh.lods.size(), MAX_MESH_LODS - 1));
+        }
+
+        std::vector<float> errors(levelCount, 0.0f);
+        for (const auto& submesh : meshData.submeshes) {
+            const size_t submeshLevels = std::min<size_t>(submesh.lods.size(), MAX_MESH_LODS - 1);
+            if (submeshLevels == 0) continue;
+            for (size_t level = 1; level < levelCount; level++) {
+                errors[level] = std::max(errors[level], submesh.lods[std::min(level, submeshLevels) - 1].error);
+            }
+        }
+        return errors;
+    }
+}
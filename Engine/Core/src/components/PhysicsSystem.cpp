@@ -6,6 +6,7 @@
 #include <glm/gtc/constants.hpp>
 #include <glm/gtx/matrix_decompose.hpp>
 #include <components/errorUtils.hpp>
+#include <components/Profiler.hpp>
 #include <thread>
 
 #if defined(__cpp_lib_execution) && defined(__cpp_lib_parallel_algorithm)
@@ -182,6 +183,7 @@ namespace vex {
         }
 
     void PhysicsSystem::update(float deltaTime) {
+        VEX_PROFILE_SCOPE("PhysicsSystem::update");
         if (!m_physicsSystem) return;
 
         auto charView = m_registry.view<CharacterComponent, TransformComponent>();
@@ -368,40 +370,10 @@ namespace vex {
             }
             break;
         case ShapeType::MESH:
+            // Vertices are filled from the mesh cache when the shape meets a MeshComponent, see MeshManager.
             if (pc.meshVertices.empty() || pc.meshIndices.empty()) {
                 log(LogLevel::ERROR, "Mesh shape has no vertices or indices");
-
-                if(r.any_of<MeshComponent>(e)){
-                    auto& mc = r.get<MeshComponent>(e);
-
-                    if (!mc.meshData.submeshes.empty()) {
-                        pc.meshVertices.clear();
-                        pc.meshIndices.clear();
-
-                        size_t vertexOffset = 0;
-
-                        for (const auto& sm : mc.meshData.submeshes) {
-                            for (const auto& v : sm.vertices) {
-                                pc.meshVertices.push_back(v.position);
-                            }
-                            for (auto idx : sm.indices) {
-                                pc.meshIndices.push_back(static_cast<uint32_t>(idx + vertexOffset));
-                            }
-                            vertexOffset += sm.vertices.size();
-                        }
-
-                        if (pc.meshVertices.empty() || pc.meshIndices.empty()) {
-                            log(LogLevel::ERROR, "Mesh shape has no vertices or indices. I have no fucking idea why because it just copied those and would error out if there were none :C");
-                            return std::nullopt;
-                        }
-                    }else{
-                        log(LogLevel::ERROR, "MeshComponent has no verticies");
-                        return std::nullopt;
-                    }
-                }else{
-                    log(LogLevel::ERROR, "MeshComponent also not found");
-                    return std::nullopt;
-                }
+                return std::nullopt;
             }
 
             if (pc.bodyType == BodyType::DYNAMIC) {
@@ -0,0 +1,295 @@
+#include "components/Profiler.hpp"
+#include "components/errorUtils.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <sstream>
+
+namespace vex {
+    namespace {
+        constexpr uint64_t RING_MASK = Profiler::PROFILER_RING_SIZE - 1;
+        static_assert((Profiler::PROFILER_RING_SIZE & RING_MASK) == 0, "PROFILER_RING_SIZE has to be a power of two");
+
+        /// @brief Ring entry. Fields are atomics so a reader racing a lapping writer reads garbage it then discards, not UB. Stored with
+        /// release and loaded with acquire, a reader seeing any field of a new zone also sees `head` the writer had before writing it.
+        struct ZoneSlot {
+            std::atomic<const char*> name{ nullptr };
+            std::atomic<uint64_t> start{ 0 };
+            std::atomic<uint64_t> end{ 0 };
+            std::atomic<uint32_t> depth{ 0 };
+        };
+
+        /// @brief Zones of one thread. Only the owning thread writes slots and `head`, readers hold `g_mutex`.
+        struct ThreadBuffer {
+            std::unique_ptr<ZoneSlot[]> slots = std::make_unique<ZoneSlot[]>(Profiler::PROFILER_RING_SIZE);
+            std::atomic<uint64_t> head{ 0 }; // zones written so far
+            std::atomic<bool> exited{ false };
+            uint32_t depth = 0;              // owning thread only
+            uint64_t frameCursor = 0;        // main thread only
+            uint64_t captureCursor = 0;      // under g_mutex
+            uint32_t id = 0;
+            std::string name;                // under g_mutex
+        };
+
+        struct CapturedZone {
+            ProfileZone zone;
+            uint32_t thread;
+        };
+
+        std::mutex g_mutex;
+        std::vector<std::shared_ptr<ThreadBuffer>> g_threads;
+        uint32_t g_nextThreadId = 0;
+
+        // Capture state, under g_mutex.
+        bool g_capturing = false;
+        bool g_userEnabled = false;
+        uint64_t g_captureStart = 0;
+        uint64_t g_droppedZones = 0;
+        std::vector<CapturedZone> g_captured;
+        std::vector<std::pair<uint32_t, std::string>> g_capturedThreads;
+
+        // Frame state, main thread only.
+        ProfileFrame g_lastFrame;
+        uint64_t g_frameIndex = 0;
+        uint64_t g_frameStart = 0;
+        uint32_t g_framesToCapture = 0;
+        std::string g_framesCapturePath;
+
+        /// @brief Keeps the buffer of a thread alive while it runs and marks it exited afterwards so it's dropped once drained.
+        struct ThreadHandle {
+            std::shared_ptr<ThreadBuffer> buffer;
+            ~ThreadHandle() {
+                if (buffer) buffer->exited.store(true, std::memory_order_release);
+            }
+        };
+
+        thread_local ThreadHandle t_handle;
+        thread_local std::string t_name; // kept until the buffer exists
+
+        ThreadBuffer& threadBuffer() {
+            ThreadBuffer* buffer = t_handle.buffer.get();
+            if (buffer) [[likely]] return *buffer;
+
+            auto created = std::make_shared<ThreadBuffer>();
+            {
+                std::lock_guard lock(g_mutex);
+                created->id = g_nextThreadId++;
+                created->name = t_name.empty() ? "Thread " + std::to_string(created->id) : t_name;
+                g_threads.push_back(created);
+            }
+            t_handle.buffer = std::move(created);
+            return *t_handle.buffer;
+        }
+
+        ProfileZone readSlot(const ZoneSlot& slot) {
+            return { slot.name.load(std::memory_order_acquire), slot.start.load(std::memory_order_acquire),
+                     slot.end.load(std::memory_order_acquire), slot.depth.load(std::memory_order_acquire) };
+        }
+
+        /// @brief Copies zones of a buffer written after `cursor`, drops the ones already overwritten. Returns the new cursor.
+        uint64_t readZones(const ThreadBuffer& buffer, uint64_t cursor, std::vector<ProfileZone>& out, uint64_t& dropped) {
+            const uint64_t head = buffer.head.load(std::memory_order_acquire);
+            uint64_t first = std::max(cursor, head > Profiler::PROFILER_RING_SIZE ? head - Profiler::PROFILER_RING_SIZE : 0);
+            const size_t base = out.size();
+            for (uint64_t i = first; i < head; i++) {
+                out.push_back(readSlot(buffer.slots[i & RING_MASK]));
+            }
+
+            // Slots the writer reached while they were copied may be torn, drop them. The slot of `after` counts as being written.
+            // A torn slot was read with at least one new field, whose acquire load makes this load see the head that reached it.
+            const uint64_t after = buffer.head.load(std::memory_order_relaxed) + 1;
+            const uint64_t valid = after > Profiler::PROFILER_RING_SIZE ? after - Profiler::PROFILER_RING_SIZE : 0;
+            if (valid > first) {
+                const uint64_t torn = std::min(valid, head) - first;
+                out.erase(out.begin() + base, out.begin() + base + torn);
+                first += torn;
+            }
+            dropped += first - cursor;
+            return head;
+        }
+
+        /// @brief Moves zones of all threads into the capture if one runs and forgets exited threads. Caller holds `g_mutex`.
+        void drainThreads() {
+            std::vector<ProfileZone> zones;
+            for (auto it = g_threads.begin(); it != g_threads.end();) {
+                ThreadBuffer& buffer = **it;
+                const bool exited = buffer.exited.load(std::memory_order_acquire);
+                if (!g_capturing) {
+                    it = exited ? g_threads.erase(it) : it + 1;
+                    continue;
+                }
+
+                zones.clear();
+                buffer.captureCursor = readZones(buffer, buffer.captureCursor, zones, g_droppedZones);
+                for (const ProfileZone& zone : zones) {
+                    if (zone.start >= g_captureStart) g_captured.push_back({ zone, buffer.id });
+                }
+                if (!zones.empty() && std::none_of(g_capturedThreads.begin(), g_capturedThreads.end(), [&](const auto& t) { return t.first == buffer.id; })) {
+                    g_capturedThreads.emplace_back(buffer.id, buffer.name);
+                }
+
+                it = exited ? g_threads.erase(it) : it + 1;
+            }
+        }
+
+        bool writeTrace(const std::string& path) {
+            nlohmann::json events = nlohmann::json::array();
+            for (const auto& [id, name] : g_capturedThreads) {
+                events.push_back({ { "name", "thread_name" }, { "ph", "M" }, { "pid", 0 }, { "tid", id }, { "args", { { "name", name } } } });
+            }
+            for (const CapturedZone& captured : g_captured) {
+                events.push_back({
+                    { "name", captured.zone.name ? captured.zone.name : "?" },
+                    { "ph", "X" },
+                    { "pid", 0 },
+                    { "tid", captured.thread },
+                    { "ts", (captured.zone.start - g_captureStart) / 1000.0 },
+                    { "dur", (captured.zone.end - captured.zone.start) / 1000.0 },
+                });
+            }
+
+            std::ofstream file(path);
+            if (!file) return false;
+            file << nlohmann::json{ { "traceEvents", std::move(events) }, { "displayTimeUnit", "ms" } }.dump();
+            return static_cast<bool>(file);
+        }
+    }
+
+    std::atomic<bool> Profiler::s_enabled{ false };
+
+    void Profiler::setEnabled(bool enabled) {
+        std::lock_guard lock(g_mutex);
+        g_userEnabled = enabled;
+        s_enabled.store(enabled || g_capturing, std::memory_order_relaxed);
+    }
+
+    void Profiler::beginFrame() {
+        const uint64_t time = now();
+        g_lastFrame.zones.clear();
+        if (!t_handle.buffer && !isEnabled()) {
+            g_lastFrame.index = g_frameIndex++;
+            g_frameStart = time;
+            return;
+        }
+
+        if (t_name.empty()) setThreadName("Main");
+        ThreadBuffer& main = threadBuffer();
+        uint64_t dropped = 0;
+        main.frameCursor = readZones(main, main.frameCursor, g_lastFrame.zones, dropped);
+        std::stable_sort(g_lastFrame.zones.begin(), g_lastFrame.zones.end(),
+                         [](const ProfileZone& a, const ProfileZone& b) { return a.start < b.start || (a.start == b.start && a.depth < b.depth); });
+        g_lastFrame.index = g_frameIndex++;
+        g_lastFrame.start = g_frameStart;
+        g_lastFrame.end = time;
+        g_frameStart = time;
+
+        bool finished = false;
+        {
+            std::lock_guard lock(g_mutex);
+            drainThreads();
+            finished = g_framesToCapture > 0 && --g_framesToCapture == 0;
+        }
+        if (finished) {
+            stopCapture(g_framesCapturePath);
+        }
+    }
+
+    void Profiler::startCapture() {
+        std::lock_guard lock(g_mutex);
+        if (g_capturing) return;
+
+        g_captured.clear();
+        g_capturedThreads.clear();
+        g_droppedZones = 0;
+        g_captureStart = now();
+        // Zones recorded before the capture aren't part of it.
+        for (auto& buffer : g_threads) {
+            buffer->captureCursor = buffer->head.load(std::memory_order_acquire);
+        }
+        g_framesToCapture = 0;
+        g_capturing = true;
+        s_enabled.store(true, std::memory_order_relaxed);
+    }
+
+    bool Profiler::stopCapture(const std::string& path) {
+        std::lock_guard lock(g_mutex);
+        if (!g_capturing) return false;
+
+        drainThreads();
+        g_capturing = false;
+        g_framesToCapture = 0;
+        s_enabled.store(g_userEnabled, std::memory_order_relaxed);
+
+        if (g_droppedZones > 0) {
+            log(LogLevel::WARNING, "Profiler capture lost %llu zones, ring buffers were overwritten between frames", static_cast<unsigned long long>(g_droppedZones));
+        }
+
+        const bool written = writeTrace(path);
+        if (written) {
+            log("Profiler capture with %zu zones written to %s", g_captured.size(), path.c_str());
+        } else {
+            log(LogLevel::WARNING, "Failed to write profiler capture to %s", path.c_str());
+        }
+        g_captured.clear();
+        g_captured.shrink_to_fit();
+        return written;
+    }
+
+    void Profiler::captureFrames(uint32_t frameCount, const std::string& path) {
+        if (frameCount == 0) return;
+        startCapture();
+        std::lock_guard lock(g_mutex);
+        g_framesToCapture = frameCount + 1; // the frame in progress isn't counted
+        g_framesCapturePath = path;
+    }
+
+    std::string Profiler::captureFileName() {
+        const std::time_t time = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+        std::stringstream ss;
+        ss << "profile_" << std::put_time(std::localtime(&time), "%Y%m%d_%H%M%S") << ".json";
+        return ss.str();
+    }
+
+    bool Profiler::isCapturing() {
+        std::lock_guard lock(g_mutex);
+        return g_capturing;
+    }
+
+    const ProfileFrame& Profiler::getLastFrame() {
+        return g_lastFrame;
+    }
+
+    void Profiler::setThreadName(const char* name) {
+        t_name = name;
+        if (!t_handle.buffer) return;
+
+        std::lock_guard lock(g_mutex);
+        t_handle.buffer->name = t_name;
+    }
+
+    uint64_t Profiler::enterZone() {
+        threadBuffer().depth++;
+        return now();
+    }
+
+    void Profiler::leaveZone(const char* name, uint64_t start) {
+        const uint64_t end = now();
+        ThreadBuffer& buffer = threadBuffer();
+        buffer.depth--;
+
+        // Release pairs with the acquire loads in readSlot, a reader seeing any of these stores also sees `head` pointing at this slot.
+        const uint64_t head = buffer.head.load(std::memory_order_relaxed);
+        ZoneSlot& slot = buffer.slots[head & RING_MASK];
+        slot.name.store(name, std::memory_order_release);
+        slot.start.store(start, std::memory_order_release);
+        slot.end.store(end, std::memory_order_release);
+        slot.depth.store(buffer.depth, std::memory_order_release);
+        buffer.head.store(head + 1, std::memory_order_release);
+    }
+}
@@ -7,16 +7,12 @@
 #include "components/enviroment.hpp"
 #include "components/VirtualFileSystem.hpp"
 
-#if defined(__cpp_lib_execution) && defined(__cpp_lib_parallel_algorithm)
-    #include <execution>
-    #define VEX_USE_PARALLEL_EXECUTION
-#endif
-
 #include <nlohmann/json.hpp>
 #include <cstdint>
 #include <fstream>
 #include <filesystem>
 #include <exception>
+#include <unordered_map>
 
 namespace vex {
 
@@ -60,6 +56,8 @@ void Scene::load(){
         env.textureQuantization = shading.value("textureQuantization", env.textureQuantization);
         env.screenDither = shading.value("screenDither", env.screenDither);
         env.ntfsArtifacts = shading.value("ntfsArtifacts", env.ntfsArtifacts);
+        env.perTriangleTransparency = shading.value("perTriangleTransparency", env.perTriangleTransparency);
+        env.lodErrorPixels = shading.value("lodErrorPixels", env.lodErrorPixels);
     }
 
     if (json.contains("environment") && json["environment"].contains("lighting")) {
@@ -108,6 +106,15 @@ void Scene::load(){
         return;
     }
 
+    // Parents are looked up by name, objects already in the scene first like before and the first one with a name wins.
+    std::unordered_map<std::string, entt::entity> entitiesByName;
+    entitiesByName.reserve(m_objects.size() + objects.size());
+    for (const auto& m_obj : m_objects) {
+        if (m_obj && m_obj->isValid() && m_engine->getRegistry().valid(m_obj->GetEntity())) {
+            entitiesByName.try_emplace(m_obj->GetComponent<NameComponent>().name, m_obj->GetEntity());
+        }
+    }
+
     for (const auto& obj : objects) {
         std::string type = obj.value("type", "");
         std::string name = obj.value("name", "");
@@ -139,31 +146,15 @@ void Scene::load(){
 
         std::string parent = obj.value("parent", "");
                         if (!parent.empty()) {
-                            bool parentFound = false;
-                            for(const auto& m_obj : m_objects) {
-                                // FIX: Check if m_obj is valid and its entity exists in registry
-                                if (!m_obj || !m_obj->isValid() || !m_engine->getRegistry().valid(m_obj->GetEntity())) {
-                                    continue;
-                                }
-
-                                entt::entity e = m_obj->GetEntity();
-                                bool valid = m_engine->getRegistry().valid(e);
-
-                                log("Checking Object at %p | Entity ID: %u (Hex: %X) | Valid in Registry: %d",
-                                        (void*)m_obj.get(), (uint32_t)e, (uint32_t)e, valid);
-
-                                // Safe to access component now
-                                if (m_obj->GetComponent<NameComponent>().name == parent) {
-                                    gameObj->ParentTo(m_obj->GetEntity());
-                                    log("Parented object '%s' to '%s'", name.c_str(), parent.c_str());
-                                    parentFound = true;
-                                    break;
-                                }
-                            }
-                            if (!parentFound) {
+                            auto parentIt = entitiesByName.find(parent);
+                            if (parentIt != entitiesByName.end() && m_engine->getRegistry().valid(parentIt->second)) {
+                                gameObj->ParentTo(parentIt->second);
+                                log("Parented object '%s' to '%s'", name.c_str(), parent.c_str());
+                            } else {
                                 log(LogLevel::WARNING, "Parent '%s' not found for object '%s'", parent.c_str(), name.c_str());
                             }
                         }
+                        entitiesByName.try_emplace(name, gameObj->GetEntity());
 
         if (gameObj) {
             //DestroyGameObject(*gameObj);
@@ -180,60 +171,29 @@ void Scene::load(){
 void Scene::sceneBegin(){
     load();
 
-    uint32_t size = m_objects.size();
-    size += m_addedObjects.size();
-
-    bool useParallel = false;
-    #ifdef VEX_USE_PARALLEL_EXECUTION
-        if(size > 50) useParallel = true;
-    #endif
-
-    if(useParallel){
-        #ifdef VEX_USE_PARALLEL_EXECUTION
-        std::for_each(std::execution::par_unseq, m_objects.begin(), m_objects.end(), [&](auto& obj){
-            try{ obj->BeginPlay(); } catch(const std::exception& e){ handle_exception(e); }
-        });
-        std::for_each(std::execution::par_unseq, m_addedObjects.begin(), m_addedObjects.end(), [&](auto& obj){
-            try{ obj->BeginPlay(); } catch(const std::exception& e){ handle_exception(e); }
-        });
-        #endif
-    }else{
-        for (auto& obj : m_objects) {
-            try{ obj->BeginPlay(); } catch(const std::exception& e){ handle_exception(e); }
-        }
-        for (auto& obj : m_addedObjects) {
-            try{ obj->BeginPlay(); } catch(const std::exception& e){ handle_exception(e); }
-        }
+    // GameObjects may touch anything and create objects, which grows these vectors, so they run one by one and by index.
+    // Parallel work belongs in systems registered on Engine::getSystemScheduler.
+    const size_t objectCount = m_objects.size();
+    const size_t addedCount = m_addedObjects.size();
+    for (size_t i = 0; i < objectCount; i++) {
+        try{ m_objects[i]->BeginPlay(); } catch(const std::exception& e){ handle_exception(e); }
+    }
+    for (size_t i = 0; i < addedCount; i++) {
+        try{ m_addedObjects[i]->BeginPlay(); } catch(const std::exception& e){ handle_exception(e); }
     }
 }
 
 void Scene::sceneUpdate(float deltaTime){
     FlushDestructionQueue();
 
-    uint32_t size = m_objects.size();
-    size += m_addedObjects.size();
-
-    bool useParallel = false;
-    #ifdef VEX_USE_PARALLEL_EXECUTION
-        if(size > 50) useParallel = true;
-    #endif
-
-    if(useParallel){
-        #ifdef VEX_USE_PARALLEL_EXECUTION
-        std::for_each(std::execution::par_unseq, m_objects.begin(), m_objects.end(), [&](auto& obj){
-            try{ obj->Update(deltaTime); } catch(const std::exception& e){ log("Error: %s", e.what()); }
-        });
-        std::for_each(std::execution::par_unseq, m_addedObjects.begin(), m_addedObjects.end(), [&](auto& obj){
-            try{ obj->Update(deltaTime); } catch(const std::exception& e){ log("Error: %s", e.what()); }
-        });
-        #endif
-    }else{
-        for (auto& obj : m_objects) {
-            try{ obj->Update(deltaTime); } catch(const std::exception& e){ log("Error: %s", e.what()); }
-        }
-        for (auto& obj : m_addedObjects) {
-            try{ obj->Update(deltaTime); } catch(const std::exception& e){ log("Error: %s", e.what()); }
-        }
+    // Objects created during this loop get their first update next frame.
+    const size_t objectCount = m_objects.size();
+    const size_t addedCount = m_addedObjects.size();
+    for (size_t i = 0; i < objectCount; i++) {
+        try{ m_objects[i]->Update(deltaTime); } catch(const std::exception& e){ log("Error: %s", e.what()); }
+    }
+    for (size_t i = 0; i < addedCount; i++) {
+        try{ m_addedObjects[i]->Update(deltaTime); } catch(const std::exception& e){ log("Error: %s", e.what()); }
     }
 }
 
@@ -265,10 +225,6 @@ void Scene::DestroyGameObject(GameObject* obj) {
 void Scene::FlushDestructionQueue() {
     if (m_pendingDestruction.empty()) return;
 
-    if (m_engine) {
-        m_engine->WaitForGpu();
-    }
-
     for (GameObject* obj : m_pendingDestruction) {
         if (!obj) continue;
 
@@ -353,16 +309,24 @@ void Scene::Save(const std::string& path) {
         {"screenQuantization", env.screenQuantization},
         {"textureQuantization", env.textureQuantization},
         {"screenDither", env.screenDither},
-        {"ntfsArtifacts", env.ntfsArtifacts}
+        {"ntfsArtifacts", env.ntfsArtifacts},
+        {"perTriangleTransparency", env.perTriangleTransparency},
+        {"lodErrorPixels", env.lodErrorPixels}
     };
 
     std::unordered_map<entt::entity, std::vector<GameObject*>> hierarchyMap;
+    std::unordered_map<entt::entity, GameObject*> objectsByEntity;
     std::vector<GameObject*> rootObjects;
 
+    for (const auto& objPtr : m_addedObjects) {
+        if (objPtr) objectsByEntity.try_emplace(objPtr->GetEntity(), objPtr.get());
+    }
+
     for (const auto& objPtr : m_objects) {
         if (!objPtr || !objPtr->isValid()) continue;
 
         GameObject* obj = objPtr.get();
+        objectsByEntity.insert_or_assign(obj->GetEntity(), obj);
         entt::entity parentEntity = entt::null;
 
         if (obj->HasComponent<TransformComponent>()) {
@@ -410,9 +374,9 @@ void Scene::Save(const std::string& path) {
         if (obj->HasComponent<TransformComponent>()) {
             entt::entity parentEntity = obj->GetComponent<TransformComponent>().getParent();
             if (parentEntity != entt::null && m_engine->getRegistry().valid(parentEntity)) {
-                GameObject* parentObj = GetGameObjectByEntity(parentEntity);
-                if (parentObj) {
-                    objJson["parent"] = parentObj->GetComponent<NameComponent>().name;
+                auto parentIt = objectsByEntity.find(parentEntity);
+                if (parentIt != objectsByEntity.end()) {
+                    objJson["parent"] = parentIt->second->GetComponent<NameComponent>().name;
                 }
             }
         }
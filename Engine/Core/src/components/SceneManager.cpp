@@ -9,6 +9,7 @@
 #include "components/GameObjects/FogObject.hpp"
 #include "components/GameObjects/Creators/ModelCreator.hpp"
 #include "components/PhysicsSystem.hpp"
+#include "components/Profiler.hpp"
 #include "components/enviroment.hpp"
 #include "components/VirtualFileSystem.hpp"
 #include <memory>
@@ -36,6 +37,7 @@ namespace vex {
 
         void to_json(nlohmann::json& j, const MeshComponent& m) {
                 j["path"] = m.meshData.meshPath;
+                j["vertexFormat"] = (int)m.meshData.vertexFormat;
                 j["renderType"] = (int)m.renderType;
                 j["color"] = m.color;
                 j["textureOverrides"] = m.textureOverrides;
@@ -46,6 +48,7 @@ namespace vex {
                     std::string path = j["path"];
                     m.meshData.meshPath = path;
                 }
+                if (j.contains("vertexFormat")) m.meshData.vertexFormat = (VertexFormat)j["vertexFormat"].get<int>();
                 if (j.contains("renderType")) m.renderType = (RenderType)j["renderType"];
                 if (j.contains("color")) m.color = j["color"];
                 if (j.contains("textureOverrides")) m.textureOverrides = j["textureOverrides"];
@@ -192,6 +195,7 @@ namespace vex {
     REGISTER_GAME_OBJECT(ModelObject);
 
 void SceneManager::loadScene(const std::string& path, Engine& engine) {
+    VEX_PROFILE_SCOPE("SceneManager::loadScene");
     clearScenes();
     loadSceneWithoutClearing(path, engine);
 }
@@ -201,6 +205,7 @@ void SceneManager::unloadScene(const std::string& path) {
 }
 
 void SceneManager::loadSceneWithoutClearing(const std::string& path, Engine& engine) {
+    VEX_PROFILE_SCOPE("SceneManager::loadSceneWithoutClearing");
     lastSceneName = path;
     m_scenes.emplace(path, std::make_shared<Scene>(path, engine));
     m_scenes[path]->sceneBegin();
@@ -0,0 +1,107 @@
+#include "components/SystemScheduler.hpp"
+#include "components/Profiler.hpp"
+#include "components/errorUtils.hpp"
+
+#include <algorithm>
+
+namespace vex {
+    bool SystemAccess::conflictsWith(const SystemAccess& other) const {
+        if (m_exclusive || other.m_exclusive) return true;
+
+        auto overlaps = [](const std::vector<entt::id_type>& a, const std::vector<entt::id_type>& b) {
+            return std::any_of(a.begin(), a.end(), [&](entt::id_type id) { return std::find(b.begin(), b.end(), id) != b.end(); });
+        };
+        return overlaps(m_writes, other.m_writes) || overlaps(m_writes, other.m_reads) || overlaps(m_reads, other.m_writes);
+    }
+
+    SystemScheduler::SystemScheduler(entt::registry& registry, JobPool& jobPool) : m_registry(registry), m_jobPool(jobPool) {}
+
+    uint32_t SystemScheduler::addSystem(const std::string& name, const SystemAccess& access, SystemFunction function) {
+        if (m_p_group) {
+            throw_error("SystemScheduler::addSystem called while systems are running");
+        }
+
+        for (auto createStorage : access.m_storages) {
+            createStorage(m_registry);
+        }
+
+        const uint32_t index = static_cast<uint32_t>(m_systems.size());
+        System& system = m_systems.emplace_back();
+        system.name = name;
+        system.access = access;
+        system.function = std::move(function);
+
+        // Newest conflicting systems first, one already waited for through another dependency adds no edge.
+        std::vector<uint8_t> waitedFor(index, 0);
+        for (uint32_t earlier = index; earlier-- > 0;) {
+            if (waitedFor[earlier] || !m_systems[earlier].access.conflictsWith(access)) continue;
+
+            system.dependencies.push_back(earlier);
+            m_systems[earlier].dependents.push_back(index);
+
+            std::vector<uint32_t> stack{ earlier };
+            while (!stack.empty()) {
+                const uint32_t current = stack.back();
+                stack.pop_back();
+                if (waitedFor[current]) continue;
+                waitedFor[current] = 1;
+                stack.insert(stack.end(), m_systems[current].dependencies.begin(), m_systems[current].dependencies.end());
+            }
+        }
+        std::reverse(system.dependencies.begin(), system.dependencies.end());
+
+        if (system.dependencies.empty()) {
+            m_roots.push_back(index);
+        }
+
+        log("Registered system '%s' waiting for %zu systems", name.c_str(), system.dependencies.size());
+        return index;
+    }
+
+    void SystemScheduler::setSystemEnabled(uint32_t index, bool enabled) {
+        m_systems[index].enabled = enabled;
+    }
+
+    void SystemScheduler::schedule(uint32_t index) {
+        System& system = m_systems[index];
+        m_jobPool.submit(*m_p_group, [this, &system] {
+            if (system.enabled) {
+                #if VEX_PROFILER
+                    ProfileScope scope(system.name.c_str());
+                #endif
+                try {
+                    system.function(m_registry, m_deltaTime);
+                } catch (const std::exception& e) {
+                    log(LogLevel::ERROR, "System '%s' failed: %s", system.name.c_str(), e.what());
+                }
+            }
+
+            for (uint32_t dependent : system.dependents) {
+                if (m_systems[dependent].remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    schedule(dependent);
+                }
+            }
+        }, system.access.m_mainThread);
+    }
+
+    void SystemScheduler::run(float deltaTime) {
+        if (m_systems.empty()) return;
+        if (m_p_group) {
+            log(LogLevel::ERROR, "SystemScheduler::run called while systems are running");
+            return;
+        }
+
+        for (System& system : m_systems) {
+            system.remaining.store(static_cast<uint32_t>(system.dependencies.size()), std::memory_order_relaxed);
+        }
+
+        JobGroup group;
+        m_p_group = &group;
+        m_deltaTime = deltaTime;
+        for (uint32_t root : m_roots) {
+            schedule(root);
+        }
+        m_jobPool.wait(group);
+        m_p_group = nullptr;
+    }
+}
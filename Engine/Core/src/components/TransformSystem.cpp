@@ -0,0 +1,161 @@
+#include "components/TransformSystem.hpp"
+#include "components/Profiler.hpp"
+#include "components/errorUtils.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+#if defined(__cpp_lib_execution) && defined(__cpp_lib_parallel_algorithm)
+    #include <execution>
+    #define VEX_HAS_PARALLEL_EXECUTION
+#endif
+
+namespace vex {
+    TransformSystem::TransformSystem(entt::registry& registry) : m_registry(registry) {
+        m_constructConnection = m_registry.on_construct<TransformComponent>().connect<&TransformSystem::onTransformChanged>(*this);
+        m_destroyConnection = m_registry.on_destroy<TransformComponent>().connect<&TransformSystem::onTransformChanged>(*this);
+    }
+
+    void TransformSystem::onTransformChanged(entt::registry&, entt::entity) {
+        m_orderDirty = true;
+    }
+
+    void TransformSystem::update() {
+        VEX_PROFILE_SCOPE("TransformSystem::update");
+
+        // A parent changed since the order was built: rebuild and redo everything, matrices computed so far may use the old parent.
+        for (int attempt = 0; attempt < 2; attempt++) {
+            const bool force = m_orderDirty;
+            if (m_orderDirty) {
+                rebuildOrder();
+            }
+
+            bool orderValid = true;
+            for (size_t level = 0; level + 1 < m_levelStarts.size(); level++) {
+                orderValid &= updateRange(m_levelStarts[level], m_levelStarts[level + 1], force);
+            }
+            if (orderValid) return;
+            m_orderDirty = true;
+        }
+    }
+
+    bool TransformSystem::updateRange(size_t begin, size_t end, bool force) {
+        // Reads only finished levels and writes only its own entries, so any split of a level is safe.
+        auto updateOne = [this, force](size_t i) {
+            TransformComponent& transform = *m_components[i];
+            if (transform.parent != m_parentEntities[i]) [[unlikely]] {
+                m_changed[i] = 0;
+                return false;
+            }
+
+            const uint32_t parent = m_parents[i];
+            const bool changed = force || transform.dirty || (parent != NO_PARENT && m_changed[parent]);
+            m_changed[i] = changed;
+            if (!changed) return true;
+
+            const glm::mat4 local = transform.localMatrix();
+            m_world[i] = parent != NO_PARENT ? m_world[parent] * local : local;
+            transform.cachedMatrix = m_world[i];
+            transform.dirty = false;
+            return true;
+        };
+
+        #ifdef VEX_HAS_PARALLEL_EXECUTION
+            if (end - begin >= PARALLEL_LEVEL_SIZE) {
+                // Iterates indices by value, parallel algorithms may pass copies of the elements so their addresses mean nothing.
+                return std::transform_reduce(std::execution::par, m_indices.begin() + begin, m_indices.begin() + end, true,
+                                             std::logical_and<>(), [&](uint32_t i) { return updateOne(i); });
+            }
+        #endif
+
+        bool valid = true;
+        for (size_t i = begin; i < end; i++) {
+            valid &= updateOne(i);
+        }
+        return valid;
+    }
+
+    void TransformSystem::rebuildOrder() {
+        VEX_PROFILE_SCOPE("TransformSystem::rebuildOrder");
+        constexpr uint32_t UNVISITED = UINT32_MAX;
+        constexpr uint32_t VISITING = UINT32_MAX - 1;
+
+        auto& storage = m_registry.storage<TransformComponent>();
+        const size_t count = storage.size();
+        const entt::entity* entities = storage.data();
+
+        auto parentSlot = [&](size_t slot) -> uint32_t {
+            const entt::entity parent = storage.get(entities[slot]).parent;
+            if (parent == entt::null || !m_registry.valid(parent) || !storage.contains(parent)) return NO_PARENT;
+            return static_cast<uint32_t>(storage.index(parent));
+        };
+
+        // Depth of every slot, walking each chain once. A transform closing a parent cycle is cut off its parent and the walk retried.
+        std::vector<uint32_t> depths(count, UNVISITED);
+        std::vector<uint32_t> parents(count, NO_PARENT);
+        std::vector<uint8_t> cut(count, 0);
+        std::vector<uint32_t> chain;
+        bool cycleFound = false;
+        for (size_t slot = 0; slot < count; slot++) {
+            chain.clear();
+            uint32_t current = static_cast<uint32_t>(slot);
+            while (current != NO_PARENT && depths[current] == UNVISITED) {
+                depths[current] = VISITING;
+                chain.push_back(current);
+                parents[current] = cut[current] ? NO_PARENT : parentSlot(current);
+                current = parents[current];
+            }
+
+            if (current != NO_PARENT && depths[current] == VISITING) {
+                cut[current] = 1;
+                cycleFound = true;
+                for (uint32_t visited : chain) {
+                    depths[visited] = UNVISITED;
+                }
+                slot--;
+                continue;
+            }
+
+            uint32_t depth = current == NO_PARENT ? 0 : depths[current] + 1;
+            for (size_t i = chain.size(); i-- > 0;) {
+                depths[chain[i]] = depth++;
+            }
+        }
+        if (cycleFound) {
+            log(LogLevel::WARNING, "Transform hierarchy contains a parent cycle, transforms closing it are treated as roots");
+        }
+
+        // Counting sort by depth, keeps storage order inside a level.
+        m_levelStarts.clear();
+        for (uint32_t depth : depths) {
+            if (depth + 2 > m_levelStarts.size()) m_levelStarts.resize(depth + 2, 0);
+            m_levelStarts[depth + 1]++;
+        }
+        for (size_t level = 1; level < m_levelStarts.size(); level++) {
+            m_levelStarts[level] += m_levelStarts[level - 1];
+        }
+
+        std::vector<uint32_t> orderOfSlot(count);
+        std::vector<size_t> next(m_levelStarts.begin(), m_levelStarts.end());
+        for (size_t slot = 0; slot < count; slot++) {
+            orderOfSlot[slot] = static_cast<uint32_t>(next[depths[slot]]++);
+        }
+
+        m_components.resize(count);
+        m_parents.resize(count);
+        m_parentEntities.resize(count);
+        m_world.resize(count);
+        m_changed.assign(count, 0);
+        m_indices.resize(count);
+        std::iota(m_indices.begin(), m_indices.end(), 0u);
+        for (size_t slot = 0; slot < count; slot++) {
+            const uint32_t index = orderOfSlot[slot];
+            TransformComponent& transform = storage.get(entities[slot]);
+            m_components[index] = &transform;
+            m_parents[index] = parents[slot] == NO_PARENT ? NO_PARENT : orderOfSlot[parents[slot]];
+            m_parentEntities[index] = transform.parent;
+        }
+
+        m_orderDirty = false;
+    }
+}
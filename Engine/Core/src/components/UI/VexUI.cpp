@@ -9,6 +9,7 @@
 
 #include <components/errorUtils.hpp>
 #include <components/pathUtils.hpp>
+#include <components/Profiler.hpp>
 #include "../HardwareInfo.hpp"
 
 namespace vex {
@@ -76,18 +77,26 @@ VexUI::VexUI(VulkanContext& ctx, VirtualFileSystem* vfs, VulkanResources* res)
 
 VexUI::~VexUI() {
     freeTree(m_root);
+    // Frames in flight may still draw this UI, GPU objects go away once their fences were waited.
+    VkDevice device = m_ctx.device;
+    VmaAllocator allocator = m_ctx.allocator;
     for (auto& [k, a] : m_fontAtlases) {
-        if (a.view) vkDestroyImageView(m_ctx.device, a.view, nullptr);
-        if (a.image) vmaDestroyImage(m_ctx.allocator, a.image, a.alloc);
+        m_ctx.deletionQueue.push([device, allocator, view = a.view, image = a.image, alloc = a.alloc]() {
+            if (view) vkDestroyImageView(device, view, nullptr);
+            if (image) vmaDestroyImage(allocator, image, alloc);
+        });
     }
-    if (m_uiSampler) vkDestroySampler(m_ctx.device, m_uiSampler, nullptr);
-    if (m_vb) vmaDestroyBuffer(m_ctx.allocator, m_vb, m_vbAlloc);
+    m_ctx.deletionQueue.push([device, allocator, sampler = m_uiSampler, vb = m_vb, vbAlloc = m_vbAlloc]() {
+        if (sampler) vkDestroySampler(device, sampler, nullptr);
+        if (vb) vmaDestroyBuffer(allocator, vb, vbAlloc);
+    });
 }
 
 bool VexUI::init() {
     const size_t VB_BYTES = 2 * 1024 * 1024;
+    // One region per frame in flight, so writing this frame's vertices never races the GPU reading an older frame.
     VkBufferCreateInfo bi{VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
-    bi.size = VB_BYTES;
+    bi.size = VB_BYTES * m_ctx.MAX_FRAMES_IN_FLIGHT;
     bi.usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
     VmaAllocationCreateInfo ai{};
     ai.usage = VMA_MEMORY_USAGE_CPU_TO_GPU;
@@ -685,15 +694,14 @@ void VexUI::batch(Widget* w, std::vector<float>& verts, glm::vec2 parentOffset)
 }
 
 void VexUI::render(VkCommandBuffer cmd, VkPipeline pipeline, VkPipelineLayout pipelineLayout, int currentFrame) {
+    VEX_PROFILE_SCOPE("VexUI::render");
     if (!m_root) return;
     layout(m_ctx.currentRenderResolution);
 
-    vkDeviceWaitIdle(m_ctx.device);
-
     std::vector<float> verts;
     verts.reserve(1024 * 9);
     batch(m_root, verts);
-    uploadVerts(verts);
+    uploadVerts(verts, currentFrame);
 
     if (verts.empty()) return;
 
@@ -701,17 +709,13 @@ void VexUI::render(VkCommandBuffer cmd, VkPipeline pipeline, VkPipelineLayout pi
 
     VkDescriptorSet globalUBO = m_res->getUBODescriptorSet(currentFrame);
         if (globalUBO != VK_NULL_HANDLE) {
-            // We must provide an offset because Binding 1 is DYNAMIC.
-            // We use 0 since the UI doesn't actually read lights, but the API demands a valid offset.
-            uint32_t dynamicOffset = 0;
-
             vkCmdBindDescriptorSets(
                 cmd,
                 VK_PIPELINE_BIND_POINT_GRAPHICS,
                 pipelineLayout,
                 0,
                 1, &globalUBO,
-                1, &dynamicOffset // <--- Changed from 0, nullptr
+                0, nullptr
             );
         }
 
@@ -731,7 +735,7 @@ void VexUI::render(VkCommandBuffer cmd, VkPipeline pipeline, VkPipelineLayout pi
         sizeof(UIPushConstants),
         &uiPC);
 
-    VkDeviceSize offset = 0;
+    VkDeviceSize offset = static_cast<VkDeviceSize>(currentFrame) * m_vbSize;
     vkCmdBindVertexBuffers(cmd, 0, 1, &m_vb, &offset);
 
     const uint32_t verticesPerQuad = 6;
@@ -774,13 +778,13 @@ void VexUI::render(VkCommandBuffer cmd, VkPipeline pipeline, VkPipelineLayout pi
     }
 }
 
-void VexUI::uploadVerts(const std::vector<float>& verts) {
+void VexUI::uploadVerts(const std::vector<float>& verts, int currentFrame) {
     if (verts.empty()) return;
     size_t bytes = verts.size() * sizeof(float);
     if (bytes > m_vbSize) throw_error("UI VB overflow");
 
     void* dst; vmaMapMemory(m_ctx.allocator, m_vbAlloc, &dst);
-    memcpy(dst, verts.data(), bytes);
+    memcpy(static_cast<char*>(dst) + static_cast<size_t>(currentFrame) * m_vbSize, verts.data(), bytes);
     vmaUnmapMemory(m_ctx.allocator, m_vbAlloc);
 }
 
@@ -0,0 +1,169 @@
+#include "components/VertexQuantization.hpp"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+namespace vex {
+    namespace {
+        float signNotZero(float value) { return value >= 0.0f ? 1.0f : -1.0f; }
+
+        bool isUntexturedUV(const glm::vec2& uv) { return uv.x <= -10000.0f; }
+    }
+
+    glm::mat4 PositionQuantization::matrix() const {
+        glm::mat4 result(scale);
+        result[3] = glm::vec4(origin, 1.0f);
+        return result;
+    }
+
+    float PositionQuantization::maxError() const {
+        const float magnitude = std::max({ std::abs(origin.x), std::abs(origin.y), std::abs(origin.z) }) + scale;
+        return scale / (2.0f * 65535.0f) + magnitude * FLT_EPSILON * 4.0f;
+    }
+
+    uint16_t floatToHalf(float value) {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+
+        const uint32_t sign = (bits >> 16) & 0x8000;
+        const uint32_t absBits = bits & 0x7FFFFFFF;
+
+        if (absBits >= 0x7F800000) { // inf or NaN
+            return static_cast<uint16_t>(sign | 0x7C00 | (absBits > 0x7F800000 ? 0x200 : 0));
+        }
+        if (absBits >= 0x477FF000) { // rounds past 65504
+            return static_cast<uint16_t>(sign | 0x7C00);
+        }
+        if (absBits < 0x38800000) { // below smallest normal half, 2^-14
+            float magnitude;
+            std::memcpy(&magnitude, &absBits, sizeof(magnitude));
+            return static_cast<uint16_t>(sign | static_cast<uint32_t>(std::nearbyint(magnitude * 16777216.0f)));
+        }
+
+        // Rebias exponent from 127 to 15 and round the 13 dropped mantissa bits to nearest even, a carry correctly bumps the exponent.
+        const uint32_t rebiased = absBits - 0x38000000;
+        const uint32_t rounded = rebiased + 0xFFF + ((rebiased >> 13) & 1);
+        return static_cast<uint16_t>(sign | (rounded >> 13));
+    }
+
+    float halfToFloat(uint16_t value) {
+        const uint32_t sign = static_cast<uint32_t>(value & 0x8000) << 16;
+        const uint32_t exponent = (value >> 10) & 0x1F;
+        const uint32_t mantissa = value & 0x3FF;
+
+        if (exponent == 0) {
+            const float magnitude = static_cast<float>(mantissa) / 16777216.0f;
+            return sign ? -magnitude : magnitude;
+        }
+
+        uint32_t bits;
+        if (exponent == 31) {
+            bits = sign | 0x7F800000 | (mantissa << 13);
+        } else {
+            bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+        }
+
+        float result;
+        std::memcpy(&result, &bits, sizeof(result));
+        return result;
+    }
+
+    glm::vec2 octahedralEncode(glm::vec3 normal) {
+        const float l1 = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+        if (l1 <= FLT_MIN) {
+            return glm::vec2(0.0f);
+        }
+
+        normal /= l1;
+        glm::vec2 encoded(normal.x, normal.y);
+        if (normal.z < 0.0f) {
+            encoded = glm::vec2((1.0f - std::abs(normal.y)) * signNotZero(normal.x),
+                                (1.0f - std::abs(normal.x)) * signNotZero(normal.y));
+        }
+        return encoded;
+    }
+
+    glm::vec3 octahedralDecode(glm::vec2 encoded) {
+        glm::vec3 normal(encoded.x, encoded.y, 1.0f - std::abs(encoded.x) - std::abs(encoded.y));
+        const float t = std::max(-normal.z, 0.0f);
+        normal.x += normal.x >= 0.0f ? -t : t;
+        normal.y += normal.y >= 0.0f ? -t : t;
+        return glm::normalize(normal);
+    }
+
+    PositionQuantization computePositionQuantization(const std::vector<Vertex>& vertices) {
+        PositionQuantization quantization;
+        if (vertices.empty()) return quantization;
+
+        glm::vec3 min = glm::vec3(FLT_MAX);
+        glm::vec3 max = glm::vec3(-FLT_MAX);
+        for (const auto& vertex : vertices) {
+            min = glm::min(min, vertex.position);
+            max = glm::max(max, vertex.position);
+        }
+
+        const glm::vec3 extent = max - min;
+        const float scale = std::max({ extent.x, extent.y, extent.z });
+
+        quantization.origin = min;
+        quantization.scale = scale > 0.0f ? scale : 1.0f;
+        return quantization;
+    }
+
+    bool canQuantizeUVs(const std::vector<Vertex>& vertices) {
+        for (const auto& vertex : vertices) {
+            if (isUntexturedUV(vertex.uv)) continue;
+            if (!(std::abs(vertex.uv.x) <= COMPACT_UV_LIMIT && std::abs(vertex.uv.y) <= COMPACT_UV_LIMIT)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    CompactVertex quantizeVertex(const Vertex& vertex, const PositionQuantization& quantization) {
+        CompactVertex result{};
+
+        const glm::vec3 normalized = glm::clamp((vertex.position - quantization.origin) / quantization.scale, 0.0f, 1.0f);
+        for (int axis = 0; axis < 3; axis++) {
+            result.position[axis] = static_cast<uint16_t>(std::lround(normalized[axis] * 65535.0f));
+        }
+
+        const glm::vec2 encoded = glm::clamp(octahedralEncode(vertex.normal), -1.0f, 1.0f);
+        result.normal[0] = static_cast<int16_t>(std::lround(encoded.x * 32767.0f));
+        result.normal[1] = static_cast<int16_t>(std::lround(encoded.y * 32767.0f));
+
+        if (isUntexturedUV(vertex.uv)) {
+            result.uv[0] = COMPACT_UNTEXTURED_UV;
+            result.uv[1] = COMPACT_UNTEXTURED_UV;
+        } else {
+            result.uv[0] = floatToHalf(vertex.uv.x);
+            result.uv[1] = floatToHalf(vertex.uv.y);
+        }
+        return result;
+    }
+
+    Vertex dequantizeVertex(const CompactVertex& vertex, const PositionQuantization& quantization) {
+        Vertex result;
+        const glm::vec3 normalized(vertex.position[0] / 65535.0f, vertex.position[1] / 65535.0f, vertex.position[2] / 65535.0f);
+        result.position = quantization.origin + normalized * quantization.scale;
+        result.normal = octahedralDecode(glm::max(glm::vec2(vertex.normal[0], vertex.normal[1]) / 32767.0f, glm::vec2(-1.0f)));
+        result.uv = glm::vec2(halfToFloat(vertex.uv[0]), halfToFloat(vertex.uv[1]));
+        return result;
+    }
+
+    void quantizeVertices(const std::vector<Vertex>& vertices, const PositionQuantization& quantization, std::vector<CompactVertex>& out) {
+        out.resize(vertices.size());
+        for (size_t i = 0; i < vertices.size(); i++) {
+            out[i] = quantizeVertex(vertices[i], quantization);
+        }
+    }
+
+    void narrowIndices(const std::vector<uint32_t>& indices, std::vector<uint16_t>& out) {
+        out.resize(indices.size());
+        for (size_t i = 0; i < indices.size(); i++) {
+            out[i] = static_cast<uint16_t>(indices[i]);
+        }
+    }
+}
@@ -118,6 +118,8 @@ std::unique_ptr<VirtualFileSystem::FileData> VirtualFileSystem::load_file(const
         file_data->data.resize(entry->data_size);
         file_data->size = entry->data_size;
 
+        // Textures are decoded on worker threads, the shared stream has to be guarded
+        std::lock_guard<std::mutex> lock(stream_mutex);
         m_loaded_vpk->file_stream.seekg(m_loaded_vpk->header.data_offset + entry->data_offset);
         m_loaded_vpk->file_stream.read(
             reinterpret_cast<char*>(file_data->data.data()),
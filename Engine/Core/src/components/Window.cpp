@@ -1,12 +1,17 @@
 #include "Window.hpp"
 
 namespace vex {
-    Window::Window(std::string title, int resx, int resy){
+    Window::Window(std::string title, int resx, int resy, bool headless){
         log("Initializing SDL...");
 
-        #ifdef __linux__
-            SDL_SetHint(SDL_HINT_VIDEO_DRIVER, "wayland,x11");
-        #endif
+        if (headless) {
+            // SDL_VIDEO_DRIVER environment variable still wins over the hint.
+            SDL_SetHint(SDL_HINT_VIDEO_DRIVER, "offscreen,dummy");
+        } else {
+            #ifdef __linux__
+                SDL_SetHint(SDL_HINT_VIDEO_DRIVER, "wayland,x11");
+            #endif
+        }
 
         if (!SDL_Init(SDL_INIT_VIDEO)) {
             const char* error = SDL_GetError();
@@ -20,11 +25,15 @@ namespace vex {
         log("Creating window with resolution: %i X %i", resx, resy);
 
         log("Creating window...");
+        // Headless window only carries size and events, dummy driver would refuse a Vulkan window.
+        const SDL_WindowFlags flags = headless
+            ? SDL_WINDOW_HIDDEN
+            : SDL_WINDOW_VULKAN | SDL_WINDOW_HIGH_PIXEL_DENSITY | SDL_WINDOW_RESIZABLE; // currently vulkan hardcoded
         window = SDL_CreateWindow(
             title.c_str(),
             resx,
             resy,
-            SDL_WINDOW_VULKAN | SDL_WINDOW_HIGH_PIXEL_DENSITY | SDL_WINDOW_RESIZABLE // currently vulkan hardcoded
+            flags
         );
         if (!window) {
             throw_error(SDL_GetError());
@@ -24,11 +24,13 @@ namespace vex {
             /// @details Initializes SDL with Video and Gamepad subsystems.
             /// - On Linux, attempts to hint `wayland,x11` drivers.
             /// - Creates the window with flags: `SDL_WINDOW_VULKAN`, `SDL_WINDOW_HIGH_PIXEL_DENSITY`, and `SDL_WINDOW_RESIZABLE`.
+            /// - Headless window is hidden and prefers `offscreen` then `dummy` video driver, so it works without a display.
             /// @throws std::runtime_error - If SDL initialization or Window creation fails.
             /// @param std::string title - Title of the window.
             /// @param int resx - Width of the window in pixels (default: 480).
             /// @param int resy - Height of the window in pixels (default: 640).
-            Window(std::string title, int resx = 480, int resy = 640);
+            /// @param bool headless - Create hidden window for offscreen rendering.
+            Window(std::string title, int resx = 480, int resy = 640, bool headless = false);
             ~Window();
 
             /// @brief Getter for SDL_Window pointer.
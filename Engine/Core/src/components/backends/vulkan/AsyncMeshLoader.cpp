@@ -0,0 +1,131 @@
+#include "AsyncMeshLoader.hpp"
+#include "components/errorUtils.hpp"
+#include "limits.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+namespace vex {
+    AsyncMeshLoader::AsyncMeshLoader(ImportFunction import)
+        : m_import(std::move(import)) {
+        uint32_t threadCount = std::clamp(std::thread::hardware_concurrency(), 2u, MAX_MESH_IMPORT_THREADS + 1) - 1;
+        for (uint32_t i = 0; i < threadCount; i++) {
+            m_workers.emplace_back(&AsyncMeshLoader::workerLoop, this);
+        }
+
+        log("AsyncMeshLoader created with %u import threads", threadCount);
+    }
+
+    AsyncMeshLoader::~AsyncMeshLoader() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+            m_tickets.clear();
+            m_jobs.clear();
+        }
+        m_wakeCondition.notify_all();
+
+        for (auto& worker : m_workers) {
+            worker.join();
+        }
+    }
+
+    void AsyncMeshLoader::request(const std::string& path, const MeshLodSettings& settings) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            // Older finished result would otherwise be collected in place of this one and end it, a worker still importing is caught by its ticket.
+            if (m_tickets.contains(path)) {
+                dropRequests(path);
+                m_stats.replaced++;
+            }
+            uint64_t ticket = m_nextTicket++;
+            m_tickets[path] = ticket;
+            m_jobs.push_back({ ticket, path, settings });
+            m_stats.requested++;
+        }
+        m_wakeCondition.notify_one();
+    }
+
+    bool AsyncMeshLoader::cancel(const std::string& path) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_tickets.erase(path) == 0) {
+            return false;
+        }
+
+        dropRequests(path);
+        m_stats.cancelled++;
+        return true;
+    }
+
+    void AsyncMeshLoader::dropRequests(const std::string& path) {
+        std::erase_if(m_jobs, [&](const ImportJob& job) { return job.path == path; });
+        std::erase_if(m_finished, [&](const FinishedImport& finished) { return finished.mesh.path == path; });
+    }
+
+    bool AsyncMeshLoader::isPending(const std::string& path) const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_tickets.contains(path);
+    }
+
+    size_t AsyncMeshLoader::getPendingCount() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_tickets.size();
+    }
+
+    AsyncMeshLoader::Stats AsyncMeshLoader::getStats() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_stats;
+    }
+
+    bool AsyncMeshLoader::isCurrent(const std::string& path, uint64_t ticket) const {
+        auto it = m_tickets.find(path);
+        return it != m_tickets.end() && it->second == ticket;
+    }
+
+    void AsyncMeshLoader::collect(std::vector<LoadedMesh>& outLoaded, size_t maxCount) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        while (!m_finished.empty() && maxCount > 0) {
+            FinishedImport& finished = m_finished.front();
+            m_tickets.erase(finished.mesh.path);
+            outLoaded.push_back(std::move(finished.mesh));
+            m_finished.pop_front();
+            m_stats.collected++;
+            maxCount--;
+        }
+    }
+
+    void AsyncMeshLoader::workerLoop() {
+        while (true) {
+            ImportJob job;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_wakeCondition.wait(lock, [&] { return m_stop || !m_jobs.empty(); });
+                if (m_stop) return;
+
+                job = std::move(m_jobs.front());
+                m_jobs.pop_front();
+            }
+
+            FinishedImport finished;
+            finished.ticket = job.ticket;
+            finished.mesh.path = job.path;
+
+            auto start = std::chrono::steady_clock::now();
+            try {
+                finished.mesh.success = m_import(job.path, job.settings, finished.mesh.meshData, finished.mesh.bounds);
+            } catch (const std::exception& e) {
+                log(LogLevel::ERROR, "Failed to import mesh %s: %s", job.path.c_str(), e.what());
+                finished.mesh.success = false;
+            }
+            finished.mesh.importMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stats.imported++;
+            if (isCurrent(finished.mesh.path, finished.ticket)) {
+                m_finished.push_back(std::move(finished));
+            } else {
+                m_stats.discarded++;
+            }
+        }
+    }
+}
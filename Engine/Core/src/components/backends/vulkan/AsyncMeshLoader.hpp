@@ -0,0 +1,122 @@
+/**
+ *  @file   AsyncMeshLoader.hpp
+ *  @brief  This file defines AsyncMeshLoader class importing meshes on worker threads.
+ *  @author Eryk Roszkowski
+ ***********************************************/
+
+#pragma once
+#include "components/Mesh.hpp"
+#include "components/MeshCooker.hpp"
+#include "components/MeshSimplifier.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace vex {
+    /// @brief Mesh whose import finished on a worker thread, waiting for upload.
+    struct LoadedMesh {
+        std::string path;
+        MeshData meshData;
+        MeshBounds bounds;
+        bool success = false;
+        float importMs = 0.0f;
+    };
+
+    /// @brief Imports meshes without stalling the frame.
+    /// @details Only CPU work happens here: reading the cooked file or running Assimp and LOD generation. Results are handed back through
+    /// `collect` on the thread owning the loader, which does the GPU upload. Requests are keyed by mesh path, like `AsyncTextureLoader` keys by texture name.
+    class AsyncMeshLoader {
+    public:
+        /// @brief Function doing the actual import, called on worker threads so it can't touch anything not safe for concurrent use.
+        using ImportFunction = std::function<bool(const std::string& path, const MeshLodSettings& settings, MeshData& outMeshData, MeshBounds& outBounds)>;
+
+        /// @brief What happened to requests since the loader was created.
+        struct Stats {
+            uint64_t requested = 0; ///< Calls to `request`.
+            uint64_t replaced = 0;  ///< Requests dropped because the same path was requested again before it was collected.
+            uint64_t cancelled = 0; ///< Calls to `cancel` that found the mesh pending.
+            uint64_t imported = 0;  ///< Imports that ran to the end on a worker thread, failed ones included.
+            uint64_t discarded = 0; ///< Imports that finished after their request was cancelled or replaced, thrown away.
+            uint64_t collected = 0; ///< Meshes handed out by `collect`.
+        };
+
+        /// @brief Constructor for AsyncMeshLoader, starts import threads.
+        /// @param ImportFunction import - Function importing one mesh.
+        explicit AsyncMeshLoader(ImportFunction import);
+
+        /// @brief Stops import threads, waits for imports that already started.
+        ~AsyncMeshLoader();
+
+        AsyncMeshLoader(const AsyncMeshLoader&) = delete;
+        AsyncMeshLoader& operator=(const AsyncMeshLoader&) = delete;
+
+        /// @brief Queues mesh for import.
+        /// @param const std::string& path - Mesh path, requesting the same path again replaces the older request, even a finished one.
+        /// @param const MeshLodSettings& settings - Settings levels of detail are generated with.
+        void request(const std::string& path, const MeshLodSettings& settings);
+
+        /// @brief Drops a pending request, an import already running finishes but its result is thrown away.
+        /// @param const std::string& path - Mesh path.
+        /// @return bool - True if the mesh was pending.
+        bool cancel(const std::string& path);
+
+        /// @brief Returns true if mesh was requested and not collected yet.
+        /// @param const std::string& path - Mesh path.
+        /// @return bool
+        bool isPending(const std::string& path) const;
+
+        /// @brief Returns number of requested meshes that weren't collected yet.
+        /// @return size_t
+        size_t getPendingCount() const;
+
+        /// @brief Moves finished imports out of the loader, oldest first.
+        /// @param std::vector<LoadedMesh>& outLoaded - Receives finished imports, failed ones have `success` false.
+        /// @param size_t maxCount - Upper limit of meshes collected by this call.
+        void collect(std::vector<LoadedMesh>& outLoaded, size_t maxCount);
+
+        /// @brief Returns request counters, stress tests use them to see cancels and late finishing imports really happened.
+        /// @return Stats
+        Stats getStats() const;
+
+    private:
+        /// @brief Queued import.
+        struct ImportJob {
+            uint64_t ticket;
+            std::string path;
+            MeshLodSettings settings;
+        };
+
+        /// @brief Finished import with the ticket it was requested under.
+        struct FinishedImport {
+            uint64_t ticket;
+            LoadedMesh mesh;
+        };
+
+        /// @brief Import thread main loop.
+        void workerLoop();
+
+        /// @brief Returns true if ticket is the latest request for its path, caller holds the mutex.
+        bool isCurrent(const std::string& path, uint64_t ticket) const;
+
+        /// @brief Removes queued and finished imports of a path, caller holds the mutex.
+        void dropRequests(const std::string& path);
+
+        ImportFunction m_import;
+
+        mutable std::mutex m_mutex;
+        std::condition_variable m_wakeCondition;
+        std::deque<ImportJob> m_jobs;
+        std::deque<FinishedImport> m_finished;
+        std::unordered_map<std::string, uint64_t> m_tickets; // latest request of every pending path
+        uint64_t m_nextTicket = 1;
+        Stats m_stats;
+        bool m_stop = false;
+        std::vector<std::thread> m_workers;
+    };
+}
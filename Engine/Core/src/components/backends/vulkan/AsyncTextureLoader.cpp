@@ -0,0 +1,693 @@
+#include "AsyncTextureLoader.hpp"
+#include "components/errorUtils.hpp"
+#include "components/TextureContainer.hpp"
+#include "limits.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include "../../../../thirdparty/stb/stb_image.h"
+
+namespace vex {
+    namespace {
+        VkFormat toVkFormat(TextureEncoding encoding) {
+            switch (encoding) {
+                case TextureEncoding::BC1: return VK_FORMAT_BC1_RGBA_SRGB_BLOCK;
+                case TextureEncoding::BC3: return VK_FORMAT_BC3_SRGB_BLOCK;
+                case TextureEncoding::BC7: return VK_FORMAT_BC7_SRGB_BLOCK;
+                default: return VK_FORMAT_R8G8B8A8_SRGB;
+            }
+        }
+
+        uint64_t nowTicks() {
+            return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+        }
+
+        float ticksToMs(uint64_t ticks) {
+            return std::chrono::duration<float, std::milli>(std::chrono::steady_clock::duration(ticks)).count();
+        }
+    }
+
+    AsyncTextureLoader::AsyncTextureLoader(VulkanContext& context, VirtualFileSystem* vfs)
+        : m_r_context(context), m_vfs(vfs) {
+
+        m_dedicatedTransfer = m_r_context.transferQueueFamily != m_r_context.graphicsQueueFamily;
+
+        VkCommandPoolCreateInfo poolInfo{};
+        poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+        poolInfo.queueFamilyIndex = m_r_context.transferQueueFamily;
+
+        if (vkCreateCommandPool(m_r_context.device, &poolInfo, nullptr, &m_transferPool) != VK_SUCCESS) {
+            throw_error("Failed to create texture upload command pool");
+        }
+
+        if (m_dedicatedTransfer) {
+            poolInfo.queueFamilyIndex = m_r_context.graphicsQueueFamily;
+            if (vkCreateCommandPool(m_r_context.device, &poolInfo, nullptr, &m_acquirePool) != VK_SUCCESS) {
+                throw_error("Failed to create texture acquire command pool");
+            }
+        }
+
+        // Mips of plain image sources are blitted, formats without blit support keep a single level.
+        VkFormatProperties formatProperties;
+        vkGetPhysicalDeviceFormatProperties(m_r_context.physicalDevice, VK_FORMAT_R8G8B8A8_SRGB, &formatProperties);
+        const VkFormatFeatureFlags blitFeatures = VK_FORMAT_FEATURE_BLIT_SRC_BIT | VK_FORMAT_FEATURE_BLIT_DST_BIT;
+        m_canBlitMips = (formatProperties.optimalTilingFeatures & blitFeatures) == blitFeatures;
+        m_mipFilter = (formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT) ? VK_FILTER_LINEAR : VK_FILTER_NEAREST;
+
+        uint32_t threadCount = std::clamp(std::thread::hardware_concurrency(), 2u, MAX_TEXTURE_DECODE_THREADS + 1) - 1;
+        for (uint32_t i = 0; i < threadCount; i++) {
+            m_workers.emplace_back(&AsyncTextureLoader::workerLoop, this);
+        }
+
+        log("AsyncTextureLoader created with %u decode threads, uploads on %s queue", threadCount, m_dedicatedTransfer ? "dedicated transfer" : "graphics");
+    }
+
+    AsyncTextureLoader::~AsyncTextureLoader() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+            m_tickets.clear();
+        }
+        m_wakeCondition.notify_all();
+        for (auto& worker : m_workers) {
+            worker.join();
+        }
+
+        std::vector<ResidentTexture> unusedResident;
+        std::vector<FailedTexture> unusedFailed;
+        for (auto& batch : m_inFlight) {
+            vkWaitForFences(m_r_context.device, 1, &batch.fence, VK_TRUE, UINT64_MAX);
+            retireBatch(batch, unusedResident, unusedFailed);
+        }
+        m_inFlight.clear();
+
+        for (VkFence fence : m_freeFences) {
+            vkDestroyFence(m_r_context.device, fence, nullptr);
+        }
+        for (VkSemaphore semaphore : m_freeSemaphores) {
+            vkDestroySemaphore(m_r_context.device, semaphore, nullptr);
+        }
+
+        if (m_acquirePool != VK_NULL_HANDLE) {
+            vkDestroyCommandPool(m_r_context.device, m_acquirePool, nullptr);
+        }
+        if (m_transferPool != VK_NULL_HANDLE) {
+            vkDestroyCommandPool(m_r_context.device, m_transferPool, nullptr);
+        }
+    }
+
+    void AsyncTextureLoader::request(const std::string& path, const std::string& name, uint32_t textureIndex, uint32_t maxSize) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            uint64_t ticket = m_nextTicket++;
+            m_tickets[name] = ticket;
+            m_jobs.push_back({ ticket, path, name, textureIndex, maxSize });
+        }
+        m_wakeCondition.notify_one();
+    }
+
+    bool AsyncTextureLoader::cancel(const std::string& name) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_tickets.erase(name) == 0) {
+            return false;
+        }
+
+        std::erase_if(m_jobs, [&](const DecodeJob& job) { return job.name == name; });
+        std::erase_if(m_decoded, [&](const DecodedTexture& texture) { return texture.name == name; });
+        return true;
+    }
+
+    bool AsyncTextureLoader::isPending(const std::string& name) const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_tickets.contains(name);
+    }
+
+    size_t AsyncTextureLoader::getPendingCount() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_tickets.size();
+    }
+
+    bool AsyncTextureLoader::isCurrent(const std::string& name, uint64_t ticket) const {
+        auto it = m_tickets.find(name);
+        return it != m_tickets.end() && it->second == ticket;
+    }
+
+    void AsyncTextureLoader::workerLoop() {
+        while (true) {
+            DecodeJob job;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_wakeCondition.wait(lock, [&] { return m_stop || !m_jobs.empty(); });
+                if (m_stop) return;
+
+                job = std::move(m_jobs.front());
+                m_jobs.pop_front();
+            }
+
+            DecodedTexture decoded;
+            decoded.ticket = job.ticket;
+            decoded.name = job.name;
+            decoded.textureIndex = job.textureIndex;
+
+            uint64_t start = nowTicks();
+            try {
+                std::filesystem::path cookedPath = job.path;
+                if (cookedPath.extension() != TEXTURE_CONTAINER_EXTENSION) {
+                    cookedPath.replace_extension(TEXTURE_CONTAINER_EXTENSION);
+                }
+
+                bool loaded = m_vfs->file_exists(cookedPath.string()) && loadCooked(cookedPath.string(), job.maxSize, decoded);
+                if (!loaded && cookedPath.string() != job.path) {
+                    loaded = loadSource(job.path, decoded);
+                }
+                if (!loaded) {
+                    decoded.data = nullptr;
+                }
+            } catch (const std::exception& e) {
+                log(LogLevel::ERROR, "Failed to load image data for %s: %s", job.path.c_str(), e.what());
+                decoded.data = nullptr;
+            }
+            decoded.decodeMs = ticksToMs(nowTicks() - start);
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (isCurrent(decoded.name, decoded.ticket)) {
+                m_decoded.push_back(std::move(decoded));
+            }
+        }
+    }
+
+    bool AsyncTextureLoader::loadCooked(const std::string& path, uint32_t maxSize, DecodedTexture& decoded) {
+        auto fileData = m_vfs->load_file(path);
+        if (!fileData || !isTextureContainer(fileData->data.data(), fileData->size)) {
+            log(LogLevel::WARNING, "Cooked texture %s is missing or not a .vtex container", path.c_str());
+            return false;
+        }
+
+        TextureContainerHeader header;
+        std::memcpy(&header, fileData->data.data(), sizeof(header));
+
+        if (isBlockCompressed(header.encoding) && !m_r_context.supportsTextureCompressionBC) {
+            log(LogLevel::WARNING, "GPU can't sample BC textures, using source image instead of %s", path.c_str());
+            return false;
+        }
+
+        const uint64_t indexEnd = sizeof(header) + sizeof(TextureLevelIndex) * static_cast<uint64_t>(header.levelCount);
+        if (header.width == 0 || header.height == 0 || header.levelCount == 0 ||
+            header.levelCount > fullMipCount(header.width, header.height) || indexEnd > fileData->size) {
+            log(LogLevel::ERROR, "Cooked texture %s has invalid header", path.c_str());
+            return false;
+        }
+
+        decoded.levels.clear();
+        decoded.firstMip = 0;
+        uint32_t width = header.width;
+        uint32_t height = header.height;
+        for (uint32_t level = 0; level < header.levelCount; level++) {
+            TextureLevelIndex index;
+            std::memcpy(&index, fileData->data.data() + sizeof(header) + sizeof(TextureLevelIndex) * level, sizeof(index));
+
+            if (index.byteLength != textureLevelBytes(header.encoding, width, height) ||
+                index.byteOffset > fileData->size || index.byteLength > fileData->size - index.byteOffset) {
+                log(LogLevel::ERROR, "Cooked texture %s has corrupted level %u", path.c_str(), level);
+                return false;
+            }
+
+            // Streamed textures skip levels bigger than requested, the last level is always kept.
+            if (maxSize != 0 && std::max(width, height) > maxSize && level + 1 < header.levelCount) {
+                decoded.firstMip = level + 1;
+            } else {
+                decoded.levels.push_back({ index.byteOffset, index.byteLength });
+            }
+            width = std::max(width / 2, 1u);
+            height = std::max(height / 2, 1u);
+        }
+
+        decoded.format = toVkFormat(header.encoding);
+        decoded.width = std::max(header.width >> decoded.firstMip, 1u);
+        decoded.height = std::max(header.height >> decoded.firstMip, 1u);
+        decoded.mipLevels = header.levelCount - decoded.firstMip;
+        decoded.sourceWidth = header.width;
+        decoded.sourceHeight = header.height;
+        decoded.sourceMipLevels = header.levelCount;
+        decoded.cooked = true;
+        decoded.data = reinterpret_cast<const unsigned char*>(fileData->data.data());
+        decoded.file = std::move(fileData);
+        return true;
+    }
+
+    bool AsyncTextureLoader::loadSource(const std::string& path, DecodedTexture& decoded) {
+        auto fileData = m_vfs->load_file(path);
+        if (!fileData) {
+            log(LogLevel::ERROR, "VFS failed to load texture: %s", path.c_str());
+            return false;
+        }
+
+        int width = 0, height = 0, channels = 0;
+        stbi_uc* pixels = stbi_load_from_memory(
+            reinterpret_cast<const stbi_uc*>(fileData->data.data()),
+            static_cast<int>(fileData->size),
+            &width, &height, &channels, STBI_rgb_alpha
+        );
+
+        if (!pixels) {
+            log(LogLevel::ERROR, "STBI failed on %s: %s", path.c_str(), stbi_failure_reason());
+            return false;
+        }
+
+        decoded.format = VK_FORMAT_R8G8B8A8_SRGB;
+        decoded.width = static_cast<uint32_t>(width);
+        decoded.height = static_cast<uint32_t>(height);
+        decoded.mipLevels = m_canBlitMips ? fullMipCount(decoded.width, decoded.height) : 1;
+        decoded.firstMip = 0;
+        decoded.sourceWidth = decoded.width;
+        decoded.sourceHeight = decoded.height;
+        decoded.sourceMipLevels = decoded.mipLevels;
+        decoded.levels = { { 0, static_cast<uint64_t>(width) * height * 4 } };
+        decoded.cooked = false;
+        decoded.pixels = { pixels, stbi_image_free };
+        decoded.data = pixels;
+        return true;
+    }
+
+    void AsyncTextureLoader::update(std::vector<ResidentTexture>& outResident, std::vector<FailedTexture>& outFailed) {
+        for (size_t i = 0; i < m_inFlight.size();) {
+            if (vkGetFenceStatus(m_r_context.device, m_inFlight[i].fence) != VK_SUCCESS) {
+                i++;
+                continue;
+            }
+            retireBatch(m_inFlight[i], outResident, outFailed);
+            if (i + 1 != m_inFlight.size()) {
+                m_inFlight[i] = std::move(m_inFlight.back());
+            }
+            m_inFlight.pop_back();
+        }
+
+        std::vector<DecodedTexture> batch;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_decoded.empty()) return;
+
+            uint64_t batchBytes = 0;
+            auto it = m_decoded.begin();
+            for (; it != m_decoded.end(); ++it) {
+                if (!isCurrent(it->name, it->ticket)) continue;
+                if (!it->data) {
+                    m_tickets.erase(it->name);
+                    outFailed.push_back({ it->name, it->textureIndex });
+                    continue;
+                }
+
+                uint64_t bytes = it->uploadBytes();
+                if (!batch.empty() && batchBytes + bytes > TEXTURE_UPLOAD_BATCH_BYTES) break;
+                batchBytes += bytes;
+                batch.push_back(std::move(*it));
+            }
+            m_decoded.erase(m_decoded.begin(), it);
+        }
+
+        if (!batch.empty()) {
+            submitBatch(batch);
+        }
+    }
+
+    VkCommandBuffer AsyncTextureLoader::allocateCommands(VkCommandPool pool) {
+        VkCommandBufferAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandPool = pool;
+        allocInfo.commandBufferCount = 1;
+
+        VkCommandBuffer commandBuffer;
+        if (vkAllocateCommandBuffers(m_r_context.device, &allocInfo, &commandBuffer) != VK_SUCCESS) {
+            throw_error("Failed to allocate texture upload command buffer");
+        }
+
+        VkCommandBufferBeginInfo beginInfo{};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        vkBeginCommandBuffer(commandBuffer, &beginInfo);
+        return commandBuffer;
+    }
+
+    void AsyncTextureLoader::submitBatch(std::vector<DecodedTexture>& decoded) {
+        UploadBatch batch;
+
+        // Every level starts 16 byte aligned, enough for RGBA8 and for 8/16 byte compressed blocks.
+        std::vector<std::vector<VkDeviceSize>> offsets(decoded.size());
+        VkDeviceSize stagingSize = 0;
+        for (size_t i = 0; i < decoded.size(); i++) {
+            for (const auto& level : decoded[i].levels) {
+                offsets[i].push_back(stagingSize);
+                stagingSize += (level.size + 15) & ~VkDeviceSize(15);
+            }
+        }
+
+        VkBufferCreateInfo bufferInfo{};
+        bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        bufferInfo.size = stagingSize;
+        bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+
+        VmaAllocationCreateInfo stagingAllocInfo{};
+        stagingAllocInfo.usage = VMA_MEMORY_USAGE_CPU_ONLY;
+        stagingAllocInfo.flags = VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+        VmaAllocationInfo stagingInfo{};
+        if (vmaCreateBuffer(m_r_context.allocator, &bufferInfo, &stagingAllocInfo, &batch.staging, &batch.stagingAlloc, &stagingInfo) != VK_SUCCESS) {
+            log(LogLevel::ERROR, "Failed to create texture staging buffer (%llu bytes), retrying next frame", static_cast<unsigned long long>(stagingSize));
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (auto& texture : decoded) {
+                m_decoded.push_back(std::move(texture));
+            }
+            return;
+        }
+
+        auto* mapped = static_cast<unsigned char*>(stagingInfo.pMappedData);
+        for (size_t i = 0; i < decoded.size(); i++) {
+            for (size_t level = 0; level < decoded[i].levels.size(); level++) {
+                memcpy(mapped + offsets[i][level], decoded[i].data + decoded[i].levels[level].offset, static_cast<size_t>(decoded[i].levels[level].size));
+            }
+        }
+
+        std::vector<VkImageMemoryBarrier> toTransfer;
+        std::vector<VkImageMemoryBarrier> afterCopy;
+        std::vector<VkImageMemoryBarrier> acquire;
+        std::vector<std::vector<VkBufferImageCopy>> regions;
+        bool needsGraphicsWork = m_dedicatedTransfer;
+
+        for (size_t i = 0; i < decoded.size(); i++) {
+            auto& texture = decoded[i];
+            const bool generateMips = texture.mipLevels > texture.levels.size();
+
+            VkImageCreateInfo imageInfo{};
+            imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+            imageInfo.imageType = VK_IMAGE_TYPE_2D;
+            imageInfo.extent = {texture.width, texture.height, 1};
+            imageInfo.mipLevels = texture.mipLevels;
+            imageInfo.arrayLayers = 1;
+            imageInfo.format = texture.format;
+            imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+            imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+            imageInfo.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | (generateMips ? VK_IMAGE_USAGE_TRANSFER_SRC_BIT : 0);
+            imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+            imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+            VmaAllocationCreateInfo imageAllocInfo{};
+            imageAllocInfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
+
+            UploadedTexture uploaded{ texture.ticket, texture.name, texture.textureIndex, VK_NULL_HANDLE, VK_NULL_HANDLE, {} };
+            VmaAllocationInfo imageAllocation{};
+            if (vmaCreateImage(m_r_context.allocator, &imageInfo, &imageAllocInfo, &uploaded.image, &uploaded.allocation, &imageAllocation) != VK_SUCCESS) {
+                log(LogLevel::ERROR, "Failed to create image for texture '%s'", texture.name.c_str());
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (isCurrent(texture.name, texture.ticket)) {
+                    texture.data = nullptr;
+                    m_decoded.push_back(std::move(texture)); // reported as failed on next update
+                }
+                continue;
+            }
+
+            uploaded.info.format = texture.format;
+            uploaded.info.width = texture.width;
+            uploaded.info.height = texture.height;
+            uploaded.info.mipLevels = texture.mipLevels;
+            uploaded.info.firstMip = texture.firstMip;
+            uploaded.info.sourceWidth = texture.sourceWidth;
+            uploaded.info.sourceHeight = texture.sourceHeight;
+            uploaded.info.sourceMipLevels = texture.sourceMipLevels;
+            uploaded.info.cooked = texture.cooked;
+            uploaded.info.generatedMips = generateMips;
+            uploaded.info.gpuBytes = imageAllocation.size;
+            uploaded.info.decodeMs = texture.decodeMs;
+            for (uint32_t level = 0, width = texture.width, height = texture.height; level < texture.mipLevels; level++) {
+                uploaded.info.rgba8Bytes += textureLevelBytes(TextureEncoding::RGBA8, width, height);
+                width = std::max(width / 2, 1u);
+                height = std::max(height / 2, 1u);
+            }
+
+            VkImageMemoryBarrier barrier{};
+            barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+            barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+            barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+            barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.image = uploaded.image;
+            barrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, texture.mipLevels, 0, 1 };
+            barrier.srcAccessMask = 0;
+            barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            toTransfer.push_back(barrier);
+
+            // With dedicated transfer queue this is the release half of the ownership transfer, acquire repeats it on graphics queue.
+            // Images that still need mips stay in TRANSFER_DST, blits run on graphics queue only.
+            barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+            barrier.newLayout = generateMips ? VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+            barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+            if (m_dedicatedTransfer) {
+                barrier.srcQueueFamilyIndex = m_r_context.transferQueueFamily;
+                barrier.dstQueueFamilyIndex = m_r_context.graphicsQueueFamily;
+                barrier.dstAccessMask = 0;
+                afterCopy.push_back(barrier);
+
+                barrier.srcAccessMask = 0;
+                barrier.dstAccessMask = generateMips ? VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT : VK_ACCESS_SHADER_READ_BIT;
+                acquire.push_back(barrier);
+            } else if (!generateMips) {
+                afterCopy.push_back(barrier);
+            }
+            needsGraphicsWork |= generateMips;
+
+            std::vector<VkBufferImageCopy> textureRegions;
+            for (uint32_t level = 0, width = texture.width, height = texture.height; level < texture.levels.size(); level++) {
+                VkBufferImageCopy region{};
+                region.bufferOffset = offsets[i][level];
+                region.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, level, 0, 1 };
+                region.imageExtent = { width, height, 1 };
+                textureRegions.push_back(region);
+                width = std::max(width / 2, 1u);
+                height = std::max(height / 2, 1u);
+            }
+            regions.push_back(std::move(textureRegions));
+
+            batch.textures.push_back(std::move(uploaded));
+        }
+
+        for (auto& texture : decoded) {
+            texture.pixels.reset();
+            texture.file.reset();
+        }
+
+        if (batch.textures.empty()) {
+            vmaDestroyBuffer(m_r_context.allocator, batch.staging, batch.stagingAlloc);
+            return;
+        }
+
+        batch.transferCommands = allocateCommands(m_transferPool);
+
+        vkCmdPipelineBarrier(batch.transferCommands,
+            VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
+            0, nullptr, 0, nullptr,
+            static_cast<uint32_t>(toTransfer.size()), toTransfer.data());
+
+        for (size_t i = 0; i < batch.textures.size(); i++) {
+            vkCmdCopyBufferToImage(batch.transferCommands, batch.staging, batch.textures[i].image,
+                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, static_cast<uint32_t>(regions[i].size()), regions[i].data());
+        }
+
+        if (!afterCopy.empty()) {
+            vkCmdPipelineBarrier(batch.transferCommands,
+                VK_PIPELINE_STAGE_TRANSFER_BIT,
+                m_dedicatedTransfer ? VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT : VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0,
+                0, nullptr, 0, nullptr,
+                static_cast<uint32_t>(afterCopy.size()), afterCopy.data());
+        }
+
+        // Without dedicated transfer queue the pool belongs to graphics family, so blits are appended to the same command buffer.
+        VkCommandBuffer graphicsCommands = batch.transferCommands;
+        if (m_dedicatedTransfer) {
+            vkEndCommandBuffer(batch.transferCommands);
+            batch.acquireCommands = allocateCommands(m_acquirePool);
+            graphicsCommands = batch.acquireCommands;
+
+            vkCmdPipelineBarrier(graphicsCommands,
+                VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0,
+                0, nullptr, 0, nullptr,
+                static_cast<uint32_t>(acquire.size()), acquire.data());
+        }
+
+        if (needsGraphicsWork) {
+            for (const auto& texture : batch.textures) {
+                if (texture.info.generatedMips) {
+                    recordMipChain(graphicsCommands, texture.image, texture.info.width, texture.info.height, texture.info.mipLevels);
+                }
+            }
+        }
+
+        vkEndCommandBuffer(graphicsCommands);
+
+        if (!m_freeFences.empty()) {
+            batch.fence = m_freeFences.back();
+            m_freeFences.pop_back();
+        } else {
+            VkFenceCreateInfo fenceInfo{};
+            fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+            if (vkCreateFence(m_r_context.device, &fenceInfo, nullptr, &batch.fence) != VK_SUCCESS) {
+                throw_error("Failed to create texture upload fence");
+            }
+        }
+
+        VkSubmitInfo transferSubmit{};
+        transferSubmit.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        transferSubmit.commandBufferCount = 1;
+        transferSubmit.pCommandBuffers = &batch.transferCommands;
+
+        if (!m_dedicatedTransfer) {
+            if (vkQueueSubmit(m_r_context.graphicsQueue, 1, &transferSubmit, batch.fence) != VK_SUCCESS) {
+                throw_error("Failed to submit texture upload");
+            }
+        } else {
+            if (!m_freeSemaphores.empty()) {
+                batch.ownershipSemaphore = m_freeSemaphores.back();
+                m_freeSemaphores.pop_back();
+            } else {
+                VkSemaphoreCreateInfo semaphoreInfo{};
+                semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+                if (vkCreateSemaphore(m_r_context.device, &semaphoreInfo, nullptr, &batch.ownershipSemaphore) != VK_SUCCESS) {
+                    throw_error("Failed to create texture ownership semaphore");
+                }
+            }
+
+            transferSubmit.signalSemaphoreCount = 1;
+            transferSubmit.pSignalSemaphores = &batch.ownershipSemaphore;
+            if (vkQueueSubmit(m_r_context.transferQueue, 1, &transferSubmit, VK_NULL_HANDLE) != VK_SUCCESS) {
+                throw_error("Failed to submit texture upload");
+            }
+
+            VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+            VkSubmitInfo acquireSubmit{};
+            acquireSubmit.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+            acquireSubmit.waitSemaphoreCount = 1;
+            acquireSubmit.pWaitSemaphores = &batch.ownershipSemaphore;
+            acquireSubmit.pWaitDstStageMask = &waitStage;
+            acquireSubmit.commandBufferCount = 1;
+            acquireSubmit.pCommandBuffers = &batch.acquireCommands;
+
+            if (vkQueueSubmit(m_r_context.graphicsQueue, 1, &acquireSubmit, batch.fence) != VK_SUCCESS) {
+                throw_error("Failed to submit texture ownership acquire");
+            }
+        }
+
+        batch.submitTicks = nowTicks();
+        log("Submitted %zu texture uploads (%llu bytes)", batch.textures.size(), static_cast<unsigned long long>(stagingSize));
+        m_inFlight.push_back(std::move(batch));
+    }
+
+    void AsyncTextureLoader::recordMipChain(VkCommandBuffer commandBuffer, VkImage image, uint32_t width, uint32_t height, uint32_t mipLevels) {
+        VkImageMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = image;
+        barrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+
+        int32_t mipWidth = static_cast<int32_t>(width);
+        int32_t mipHeight = static_cast<int32_t>(height);
+
+        for (uint32_t level = 1; level < mipLevels; level++) {
+            barrier.subresourceRange.baseMipLevel = level - 1;
+            barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+            barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+            barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+            vkCmdPipelineBarrier(commandBuffer,
+                VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
+                0, nullptr, 0, nullptr, 1, &barrier);
+
+            int32_t nextWidth = std::max(mipWidth / 2, 1);
+            int32_t nextHeight = std::max(mipHeight / 2, 1);
+
+            VkImageBlit blit{};
+            blit.srcSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, level - 1, 0, 1 };
+            blit.srcOffsets[1] = { mipWidth, mipHeight, 1 };
+            blit.dstSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, level, 0, 1 };
+            blit.dstOffsets[1] = { nextWidth, nextHeight, 1 };
+            vkCmdBlitImage(commandBuffer,
+                image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                1, &blit, m_mipFilter);
+
+            barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+            barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+            barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+            barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+            vkCmdPipelineBarrier(commandBuffer,
+                VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0,
+                0, nullptr, 0, nullptr, 1, &barrier);
+
+            mipWidth = nextWidth;
+            mipHeight = nextHeight;
+        }
+
+        barrier.subresourceRange.baseMipLevel = mipLevels - 1;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        vkCmdPipelineBarrier(commandBuffer,
+            VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0,
+            0, nullptr, 0, nullptr, 1, &barrier);
+    }
+
+    void AsyncTextureLoader::retireBatch(UploadBatch& batch, std::vector<ResidentTexture>& outResident, std::vector<FailedTexture>& outFailed) {
+        const float uploadMs = ticksToMs(nowTicks() - batch.submitTicks);
+
+        for (auto& texture : batch.textures) {
+            bool wanted;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                wanted = isCurrent(texture.name, texture.ticket);
+                if (wanted) {
+                    m_tickets.erase(texture.name);
+                }
+            }
+
+            VkImageView view = VK_NULL_HANDLE;
+            if (wanted) {
+                VkImageViewCreateInfo viewInfo{};
+                viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+                viewInfo.image = texture.image;
+                viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+                viewInfo.format = texture.info.format;
+                viewInfo.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, texture.info.mipLevels, 0, 1 };
+
+                if (vkCreateImageView(m_r_context.device, &viewInfo, nullptr, &view) != VK_SUCCESS) {
+                    log(LogLevel::ERROR, "Failed to create texture image view for '%s'", texture.name.c_str());
+                    view = VK_NULL_HANDLE;
+                    outFailed.push_back({ texture.name, texture.textureIndex });
+                }
+            }
+
+            if (view == VK_NULL_HANDLE) {
+                vmaDestroyImage(m_r_context.allocator, texture.image, texture.allocation);
+                continue;
+            }
+
+            texture.info.uploadMs = uploadMs;
+            outResident.push_back({ texture.name, texture.textureIndex, texture.image, texture.allocation, view, texture.info });
+        }
+
+        vmaDestroyBuffer(m_r_context.allocator, batch.staging, batch.stagingAlloc);
+        vkFreeCommandBuffers(m_r_context.device, m_transferPool, 1, &batch.transferCommands);
+        if (batch.acquireCommands != VK_NULL_HANDLE) {
+            vkFreeCommandBuffers(m_r_context.device, m_acquirePool, 1, &batch.acquireCommands);
+        }
+        if (batch.ownershipSemaphore != VK_NULL_HANDLE) {
+            m_freeSemaphores.push_back(batch.ownershipSemaphore);
+        }
+
+        vkResetFences(m_r_context.device, 1, &batch.fence);
+        m_freeFences.push_back(batch.fence);
+    }
+}
@@ -0,0 +1,220 @@
+/**
+ *  @file   AsyncTextureLoader.hpp
+ *  @brief  This file defines AsyncTextureLoader class decoding textures on worker threads and uploading them on the transfer queue.
+ *  @author Eryk Roszkowski
+ ***********************************************/
+
+#pragma once
+#include "context.hpp"
+#include "components/VirtualFileSystem.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace vex {
+    /// @brief Per texture numbers reported when it becomes resident.
+    struct TextureLoadInfo {
+        VkFormat format = VK_FORMAT_UNDEFINED;
+        uint32_t width = 0;
+        uint32_t height = 0;
+        uint32_t mipLevels = 0;
+        uint32_t firstMip = 0;         ///< Levels of the file above the uploaded top level that were skipped.
+        uint32_t sourceWidth = 0;      ///< Size of level 0 in the file.
+        uint32_t sourceHeight = 0;
+        uint32_t sourceMipLevels = 0;  ///< Levels stored in the file, for source images the same as `mipLevels`.
+        bool cooked = false;         ///< Loaded from a `.vtex` container instead of decoding the source image.
+        bool generatedMips = false;  ///< Mip chain was blitted on the GPU.
+        uint64_t gpuBytes = 0;       ///< Size of the image allocation.
+        uint64_t rgba8Bytes = 0;     ///< Size the same mip chain would take as RGBA8.
+        float decodeMs = 0.0f;       ///< File read and decode on worker thread.
+        float uploadMs = 0.0f;       ///< From submit until the batch fence was seen signaled.
+    };
+
+    /// @brief Texture whose upload finished, ready to be written into its descriptor slot.
+    struct ResidentTexture {
+        std::string name;
+        uint32_t textureIndex;
+        VkImage image;
+        VmaAllocation allocation;
+        VkImageView view;
+        TextureLoadInfo info;
+    };
+
+    /// @brief Texture that couldn't be read or decoded, its slot has to be released.
+    struct FailedTexture {
+        std::string name;
+        uint32_t textureIndex;
+    };
+
+    /// @brief Loads textures without stalling the frame.
+    /// @details Files are read and decoded on a small worker pool. A cooked `.vtex` next to the source (see TextureContainer.hpp) is preferred,
+    /// its mip levels are uploaded as they are; plain PNG/JPG sources are decoded with stb_image and their mip chain is blitted on the graphics queue. `update`, called once per frame on the render thread,
+    /// copies everything decoded so far into one staging buffer and records all copies into a single command buffer.
+    /// If the device has a dedicated transfer queue family the copies run there and ownership of each image is released to the graphics family,
+    /// the matching acquire is submitted on the graphics queue waiting on a semaphore. Completion is polled with a fence per batch, nothing waits for the queue to go idle.
+    /// All Vulkan calls happen on the thread calling `update`, so queues and command pools need no extra locking.
+    class AsyncTextureLoader {
+    public:
+        /// @brief Constructor for AsyncTextureLoader, creates command pools and starts decode threads.
+        /// @param VulkanContext& context - Reference to the VulkanContext object.
+        /// @param VirtualFileSystem* vfs - VFS used by decode threads, has to be safe for concurrent `load_file`.
+        AsyncTextureLoader(VulkanContext& context, VirtualFileSystem* vfs);
+
+        /// @brief Stops decode threads, waits for in flight batches and destroys textures that were never handed over.
+        ~AsyncTextureLoader();
+
+        AsyncTextureLoader(const AsyncTextureLoader&) = delete;
+        AsyncTextureLoader& operator=(const AsyncTextureLoader&) = delete;
+
+        /// @brief Queues texture for decode and upload.
+        /// @param const std::string& path - VFS path of the image file.
+        /// @param const std::string& name - Texture key, requesting the same name again replaces the older request.
+        /// @param uint32_t textureIndex - Slot reserved for the texture, it's returned back through `update`.
+        /// @param uint32_t maxSize - Cooked textures start at the first level whose longer side fits, 0 uploads every level. Source images always load whole.
+        void request(const std::string& path, const std::string& name, uint32_t textureIndex, uint32_t maxSize = 0);
+
+        /// @brief Drops a pending request, a batch already on the GPU finishes but its image is destroyed instead of handed over.
+        /// @param const std::string& name - Texture key.
+        /// @return bool - True if the texture was pending.
+        bool cancel(const std::string& name);
+
+        /// @brief Returns true if texture was requested and isn't resident yet.
+        /// @param const std::string& name - Texture key.
+        /// @return bool
+        bool isPending(const std::string& name) const;
+
+        /// @brief Returns number of requested textures that aren't resident yet.
+        /// @return size_t
+        size_t getPendingCount() const;
+
+        /// @brief Collects finished batches and submits a new one from decoded textures.
+        /// @param std::vector<ResidentTexture>& outResident - Receives textures that are ready for sampling, ownership of image and view moves to caller.
+        /// @param std::vector<FailedTexture>& outFailed - Receives textures that failed to load.
+        void update(std::vector<ResidentTexture>& outResident, std::vector<FailedTexture>& outFailed);
+
+        /// @brief Returns true if uploads run on a queue family other than graphics.
+        /// @return bool
+        bool usesDedicatedTransferQueue() const { return m_dedicatedTransfer; }
+
+    private:
+        /// @brief Queued decode.
+        struct DecodeJob {
+            uint64_t ticket;
+            std::string path;
+            std::string name;
+            uint32_t textureIndex;
+            uint32_t maxSize;
+        };
+
+        /// @brief Level data inside `DecodedTexture::data`.
+        struct DecodedLevel {
+            uint64_t offset;
+            uint64_t size;
+        };
+
+        /// @brief Decode result waiting for upload, `data` is null if decode failed.
+        struct DecodedTexture {
+            uint64_t ticket;
+            std::string name;
+            uint32_t textureIndex;
+            VkFormat format = VK_FORMAT_R8G8B8A8_SRGB;
+            uint32_t width = 0;
+            uint32_t height = 0;
+            uint32_t mipLevels = 1;        // levels of the image, more than `levels.size()` if the rest is blitted
+            uint32_t firstMip = 0;
+            uint32_t sourceWidth = 0;
+            uint32_t sourceHeight = 0;
+            uint32_t sourceMipLevels = 1;
+            std::vector<DecodedLevel> levels;
+            bool cooked = false;
+            float decodeMs = 0.0f;
+            const unsigned char* data = nullptr;
+            std::unique_ptr<unsigned char, void(*)(void*)> pixels{ nullptr, nullptr };
+            std::unique_ptr<VirtualFileSystem::FileData> file;
+
+            uint64_t uploadBytes() const {
+                uint64_t bytes = 0;
+                for (const auto& level : levels) bytes += (level.size + 15) & ~15ull;
+                return bytes;
+            }
+        };
+
+        /// @brief Texture recorded into a batch.
+        struct UploadedTexture {
+            uint64_t ticket;
+            std::string name;
+            uint32_t textureIndex;
+            VkImage image;
+            VmaAllocation allocation;
+            TextureLoadInfo info;
+        };
+
+        /// @brief One submit of copies, alive until its fence signals.
+        struct UploadBatch {
+            VkFence fence = VK_NULL_HANDLE;
+            VkSemaphore ownershipSemaphore = VK_NULL_HANDLE;
+            VkCommandBuffer transferCommands = VK_NULL_HANDLE;
+            VkCommandBuffer acquireCommands = VK_NULL_HANDLE;
+            VkBuffer staging = VK_NULL_HANDLE;
+            VmaAllocation stagingAlloc = VK_NULL_HANDLE;
+            std::vector<UploadedTexture> textures;
+            uint64_t submitTicks = 0;
+        };
+
+        /// @brief Decode thread main loop.
+        void workerLoop();
+
+        /// @brief Reads a `.vtex` container, returns false if it's missing, malformed or its encoding can't be sampled on this device.
+        bool loadCooked(const std::string& path, uint32_t maxSize, DecodedTexture& decoded);
+
+        /// @brief Decodes a PNG/JPG/... source with stb_image.
+        bool loadSource(const std::string& path, DecodedTexture& decoded);
+
+        /// @brief Records blits filling levels 1..n from level 0 and leaves every level in `SHADER_READ_ONLY_OPTIMAL`.
+        void recordMipChain(VkCommandBuffer commandBuffer, VkImage image, uint32_t width, uint32_t height, uint32_t mipLevels);
+
+        /// @brief Records and submits copies of decoded textures.
+        /// @param std::vector<DecodedTexture>& decoded - Textures to upload, all with valid pixels.
+        void submitBatch(std::vector<DecodedTexture>& decoded);
+
+        /// @brief Releases batch resources, images are handed over or destroyed depending on their ticket.
+        /// @param UploadBatch& batch - Batch whose fence signaled.
+        /// @param std::vector<ResidentTexture>& outResident - Receives textures that are still wanted.
+        /// @param std::vector<FailedTexture>& outFailed - Receives wanted textures whose view couldn't be created.
+        void retireBatch(UploadBatch& batch, std::vector<ResidentTexture>& outResident, std::vector<FailedTexture>& outFailed);
+
+        /// @brief Returns true if ticket is the latest request for its name, caller holds the mutex.
+        bool isCurrent(const std::string& name, uint64_t ticket) const;
+
+        /// @brief Returns a command buffer allocated from pool.
+        VkCommandBuffer allocateCommands(VkCommandPool pool);
+
+        VulkanContext& m_r_context;
+        VirtualFileSystem* m_vfs;
+
+        bool m_dedicatedTransfer = false;
+        bool m_canBlitMips = false;
+        VkFilter m_mipFilter = VK_FILTER_NEAREST;
+        VkCommandPool m_transferPool = VK_NULL_HANDLE;
+        VkCommandPool m_acquirePool = VK_NULL_HANDLE;
+
+        std::vector<UploadBatch> m_inFlight;
+        std::vector<VkFence> m_freeFences;
+        std::vector<VkSemaphore> m_freeSemaphores;
+
+        mutable std::mutex m_mutex;
+        std::condition_variable m_wakeCondition;
+        std::deque<DecodeJob> m_jobs;
+        std::vector<DecodedTexture> m_decoded;
+        std::unordered_map<std::string, uint64_t> m_tickets; // latest request of every pending name
+        uint64_t m_nextTicket = 1;
+        bool m_stop = false;
+        std::vector<std::thread> m_workers;
+    };
+}
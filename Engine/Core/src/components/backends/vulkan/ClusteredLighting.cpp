@@ -0,0 +1,187 @@
+#include "ClusteredLighting.hpp"
+#include "components/errorUtils.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace vex {
+    LightClusterGrid::LightClusterGrid() {
+        m_bounds.resize(CLUSTER_COUNT);
+        m_clusters.resize(CLUSTER_COUNT);
+        m_lightIndices.reserve(MAX_CLUSTER_LIGHT_INDICES);
+    }
+
+    void LightClusterGrid::rebuildBounds(const glm::mat4& proj, float nearPlane, float farPlane) {
+        m_proj = proj;
+        m_nearPlane = nearPlane;
+        m_farPlane = farPlane;
+
+        const float logRatio = std::log(farPlane / nearPlane);
+        m_sliceScale = static_cast<float>(CLUSTER_GRID_Z) / logRatio;
+        m_sliceBias = -static_cast<float>(CLUSTER_GRID_Z) * std::log(nearPlane) / logRatio;
+
+        // ndc = (P00 * x + P20 * z) / -z, solved for x at given depth (same for y).
+        auto toView = [&](float ndcX, float ndcY, float depth) {
+            return glm::vec3((ndcX + proj[2][0]) * depth / proj[0][0],
+                             (ndcY + proj[2][1]) * depth / proj[1][1],
+                             -depth);
+        };
+
+        auto extend = [](ClusterBounds& bounds, int axis, float direction) {
+            if (direction > 0.0f) {
+                bounds.max[axis] = std::numeric_limits<float>::max();
+            } else if (direction < 0.0f) {
+                bounds.min[axis] = std::numeric_limits<float>::lowest();
+            }
+        };
+
+        // View space directions of growing NDC, y is negative with the Vulkan flip.
+        const float xDirection = proj[0][0] > 0.0f ? 1.0f : -1.0f;
+        const float yDirection = proj[1][1] > 0.0f ? 1.0f : -1.0f;
+
+        // NDC range of a tile, border tiles start as the frustum edge and are widened outward below.
+        auto tileRange = [](uint32_t tile, uint32_t tiles) {
+            const uint32_t first = tile == 0 ? 0 : std::min(tile - 1, tiles);
+            const uint32_t last = std::min(tile, tiles);
+            return glm::vec2(-1.0f + 2.0f * static_cast<float>(first) / tiles, -1.0f + 2.0f * static_cast<float>(last) / tiles);
+        };
+
+        for (uint32_t z = 0; z < GRID_Z; z++) {
+            // The near border reaches the camera, the far border starts at the far plane and is widened below.
+            float depthNear = z == 0 ? 0.0f : nearPlane * std::pow(farPlane / nearPlane, static_cast<float>(z - 1) / CLUSTER_GRID_Z);
+            float depthFar = z == GRID_Z - 1 ? farPlane : nearPlane * std::pow(farPlane / nearPlane, static_cast<float>(z) / CLUSTER_GRID_Z);
+
+            for (uint32_t y = 0; y < GRID_Y; y++) {
+                const glm::vec2 ndcY = tileRange(y, CLUSTER_GRID_Y);
+
+                for (uint32_t x = 0; x < GRID_X; x++) {
+                    const glm::vec2 ndcX = tileRange(x, CLUSTER_GRID_X);
+
+                    glm::vec3 corners[8] = {
+                        toView(ndcX.x, ndcY.x, depthNear), toView(ndcX.y, ndcY.x, depthNear),
+                        toView(ndcX.x, ndcY.y, depthNear), toView(ndcX.y, ndcY.y, depthNear),
+                        toView(ndcX.x, ndcY.x, depthFar),  toView(ndcX.y, ndcY.x, depthFar),
+                        toView(ndcX.x, ndcY.y, depthFar),  toView(ndcX.y, ndcY.y, depthFar)
+                    };
+
+                    ClusterBounds& bounds = m_bounds[x + y * GRID_X + z * GRID_X * GRID_Y];
+                    bounds.min = corners[0];
+                    bounds.max = corners[0];
+                    for (const auto& corner : corners) {
+                        bounds.min = glm::min(bounds.min, corner);
+                        bounds.max = glm::max(bounds.max, corner);
+                    }
+
+                    const bool borderX = x == 0 || x == GRID_X - 1;
+                    const bool borderY = y == 0 || y == GRID_Y - 1;
+                    if (borderX) extend(bounds, 0, x == 0 ? -xDirection : xDirection);
+                    if (borderY) extend(bounds, 1, y == 0 ? -yDirection : yDirection);
+
+                    // Positions behind the camera go to the near border corner on their side.
+                    if (z == 0 && borderX && borderY) extend(bounds, 2, 1.0f);
+
+                    // Past the far plane the tile keeps widening along its far corners.
+                    if (z == GRID_Z - 1) {
+                        for (uint32_t corner = 4; corner < 8; corner++) {
+                            extend(bounds, 0, corners[corner].x);
+                            extend(bounds, 1, corners[corner].y);
+                        }
+                        extend(bounds, 2, -1.0f);
+                    }
+                }
+            }
+        }
+    }
+
+    uint32_t LightClusterGrid::getSlice(float depth) const {
+        if (depth < m_nearPlane) return 0;
+        if (depth >= m_farPlane) return GRID_Z - 1;
+        float slice = std::floor(std::log(depth) * m_sliceScale + m_sliceBias);
+        return static_cast<uint32_t>(std::clamp(slice, 0.0f, static_cast<float>(CLUSTER_GRID_Z - 1))) + 1;
+    }
+
+    uint32_t LightClusterGrid::getClusterIndex(const glm::vec3& viewPos) const {
+        glm::vec4 clip = m_proj * glm::vec4(viewPos, 1.0f);
+        uint32_t x, y;
+        if (clip.w > 0.0f) {
+            glm::vec2 tile = glm::floor((glm::vec2(clip) / clip.w * 0.5f + 0.5f) * glm::vec2(CLUSTER_GRID_X, CLUSTER_GRID_Y)) + 1.0f;
+            x = static_cast<uint32_t>(std::clamp(tile.x, 0.0f, static_cast<float>(GRID_X - 1)));
+            y = static_cast<uint32_t>(std::clamp(tile.y, 0.0f, static_cast<float>(GRID_Y - 1)));
+        } else {
+            // Behind the camera there is no tile, the near border corner on the same side reaches back there.
+            x = viewPos.x * m_proj[0][0] < 0.0f ? 0 : GRID_X - 1;
+            y = viewPos.y * m_proj[1][1] < 0.0f ? 0 : GRID_Y - 1;
+        }
+        uint32_t z = getSlice(-viewPos.z);
+
+        return x + y * GRID_X + z * GRID_X * GRID_Y;
+    }
+
+    void LightClusterGrid::build(const glm::mat4& view, const glm::mat4& proj, float nearPlane, float farPlane, const std::vector<Light>& lights) {
+        nearPlane = std::max(nearPlane, 0.001f);
+        farPlane = std::max(farPlane, nearPlane * 1.01f);
+
+        if (proj != m_proj || nearPlane != m_nearPlane || farPlane != m_farPlane) [[unlikely]] {
+            rebuildBounds(proj, nearPlane, farPlane);
+        }
+
+        m_lightCount = static_cast<uint32_t>(std::min<size_t>(lights.size(), MAX_SCENE_LIGHTS));
+        m_hits.clear();
+        std::fill(m_clusters.begin(), m_clusters.end(), LightCluster{});
+
+        const uint32_t sliceSize = GRID_X * GRID_Y;
+
+        for (uint32_t i = 0; i < m_lightCount; i++) {
+            const Light& light = lights[i];
+            glm::vec3 center = glm::vec3(view * glm::vec4(glm::vec3(light.position), 1.0f));
+            float radius = light.position.w;
+            float depth = -center.z;
+
+            // Lights outside the near and far plane still reach the border slices.
+            if (radius <= 0.0f) continue;
+
+            uint32_t firstSlice = getSlice(depth - radius);
+            uint32_t lastSlice = getSlice(depth + radius);
+            float radiusSqr = radius * radius;
+
+            for (uint32_t z = firstSlice; z <= lastSlice; z++) {
+                for (uint32_t cluster = z * sliceSize; cluster < (z + 1) * sliceSize; cluster++) {
+                    const ClusterBounds& bounds = m_bounds[cluster];
+                    glm::vec3 closest = glm::clamp(center, bounds.min, bounds.max) - center;
+                    if (glm::dot(closest, closest) <= radiusSqr) {
+                        m_hits.emplace_back(cluster, i);
+                        m_clusters[cluster].count++;
+                    }
+                }
+            }
+        }
+
+        uint32_t offset = 0;
+        bool truncated = false;
+        for (auto& cluster : m_clusters) {
+            uint32_t count = std::min(cluster.count, MAX_DYNAMIC_LIGHTS);
+            count = std::min(count, MAX_CLUSTER_LIGHT_INDICES - offset);
+            truncated |= count != cluster.count;
+
+            cluster.offset = offset;
+            cluster.count = 0;
+            offset += count;
+        }
+
+        m_lightIndices.resize(offset);
+        for (const auto& [clusterIndex, lightIndex] : m_hits) {
+            LightCluster& cluster = m_clusters[clusterIndex];
+            uint32_t capacity = (&cluster == &m_clusters.back() ? offset : (&cluster + 1)->offset) - cluster.offset;
+            if (cluster.count < capacity) {
+                m_lightIndices[cluster.offset + cluster.count++] = lightIndex;
+            }
+        }
+
+        static bool warned = false;
+        if (truncated && !warned) [[unlikely]] {
+            log(LogLevel::WARNING, "Light cluster limit reached, some lights wont affect parts of the scene.");
+            warned = true;
+        }
+    }
+}
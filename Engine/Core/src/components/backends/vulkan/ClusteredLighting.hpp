@@ -0,0 +1,85 @@
+/**
+ *  @file   ClusteredLighting.hpp
+ *  @brief  This file defines LightClusterGrid class used for clustered forward light culling.
+ *  @author Eryk Roszkowski
+ ***********************************************/
+
+#pragma once
+#include "uniforms.hpp"
+#include "limits.hpp"
+
+#include <glm/glm.hpp>
+#include <vector>
+
+namespace vex {
+    /// @brief Splits the camera frustum into froxels and assigns scene lights to them on the CPU.
+    /// @details The view frustum is divided into `CLUSTER_GRID_X` x `CLUSTER_GRID_Y` screen tiles and `CLUSTER_GRID_Z` exponential depth slices.
+    /// Every frame each light sphere is tested against the view space AABBs of the clusters it can touch, producing a compact light index list.
+    /// Shaders find their cluster from view depth and screen position and only iterate the lights listed for it.
+    /// A border of clusters one wide on every side holds positions outside the frustum, beside the screen, before the near plane or
+    /// behind the camera and past the far plane, so vertices of partly visible triangles still get every light reaching them.
+    /// It does not touch Vulkan, so it can be built and inspected without a GPU.
+    class LightClusterGrid {
+    public:
+        LightClusterGrid();
+
+        /// @brief Assigns lights to clusters for the current camera.
+        /// @details Cluster bounds are only recalculated when projection or clip planes change. Lights in each cluster keep the order from `lights`.
+        /// @param const glm::mat4& view - Camera view matrix.
+        /// @param const glm::mat4& proj - Camera projection matrix (with Vulkan Y flip applied).
+        /// @param float nearPlane - Camera near plane.
+        /// @param float farPlane - Camera far plane.
+        /// @param const std::vector<Light>& lights - World space lights, position.w = radius.
+        void build(const glm::mat4& view, const glm::mat4& proj, float nearPlane, float farPlane, const std::vector<Light>& lights);
+
+        /// @brief Returns cluster index for a view space position, matches the lookup done in shaders.
+        /// @param const glm::vec3& viewPos - Position in view space.
+        /// @return uint32_t - Index into `getClusters()`.
+        uint32_t getClusterIndex(const glm::vec3& viewPos) const;
+
+        /// @brief Returns per cluster ranges into the light index list.
+        /// @return const std::vector<LightCluster>&
+        const std::vector<LightCluster>& getClusters() const { return m_clusters; }
+
+        /// @brief Returns shared light index list referenced by clusters.
+        /// @return const std::vector<uint32_t>&
+        const std::vector<uint32_t>& getLightIndices() const { return m_lightIndices; }
+
+        /// @brief Returns grid size including the border packed for SceneUBO, w is number of lights used in last build.
+        /// @return glm::uvec4
+        glm::uvec4 getGridSize() const { return glm::uvec4(GRID_X, GRID_Y, GRID_Z, m_lightCount); }
+
+        /// @brief Returns depth slicing parameters packed for SceneUBO (near, far, scale, bias).
+        /// @return glm::vec4
+        glm::vec4 getDepthParams() const { return glm::vec4(m_nearPlane, m_farPlane, m_sliceScale, m_sliceBias); }
+
+    private:
+        static constexpr uint32_t GRID_X = CLUSTER_GRID_X + 2;
+        static constexpr uint32_t GRID_Y = CLUSTER_GRID_Y + 2;
+        static constexpr uint32_t GRID_Z = CLUSTER_GRID_Z + 2;
+
+        /// @brief View space bounding box of a single cluster.
+        struct ClusterBounds {
+            glm::vec3 min;
+            glm::vec3 max;
+        };
+
+        /// @brief Recalculates view space AABB of every cluster.
+        void rebuildBounds(const glm::mat4& proj, float nearPlane, float farPlane);
+
+        /// @brief Returns depth slice for view depth, 0 before the near plane and `GRID_Z - 1` past the far plane.
+        uint32_t getSlice(float depth) const;
+
+        std::vector<ClusterBounds> m_bounds;
+        std::vector<LightCluster> m_clusters;
+        std::vector<uint32_t> m_lightIndices;
+        std::vector<std::pair<uint32_t, uint32_t>> m_hits;
+
+        glm::mat4 m_proj = glm::mat4(0.0f);
+        float m_nearPlane = 0.0f;
+        float m_farPlane = 0.0f;
+        float m_sliceScale = 0.0f;
+        float m_sliceBias = 0.0f;
+        uint32_t m_lightCount = 0;
+    };
+}
@@ -0,0 +1,166 @@
+#include "CommandRecorder.hpp"
+#include "components/errorUtils.hpp"
+#include "components/Profiler.hpp"
+
+#include <algorithm>
+
+namespace vex {
+    ParallelCommandRecorder::ParallelCommandRecorder(VulkanContext& context, uint32_t threadCount)
+        : m_r_context(context), m_threadCount(std::max(threadCount, 1u)) {
+
+        VkCommandPoolCreateInfo poolInfo{};
+        poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+        poolInfo.queueFamilyIndex = m_r_context.graphicsQueueFamily;
+
+        m_frames.resize(m_r_context.MAX_FRAMES_IN_FLIGHT);
+        for (auto& threads : m_frames) {
+            threads.resize(m_threadCount);
+            for (auto& threadFrame : threads) {
+                if (vkCreateCommandPool(m_r_context.device, &poolInfo, nullptr, &threadFrame.pool) != VK_SUCCESS) {
+                    throw_error("Failed to create secondary command pool");
+                }
+            }
+        }
+
+        for (uint32_t i = 1; i < m_threadCount; i++) {
+            m_workers.emplace_back(&ParallelCommandRecorder::workerLoop, this, i);
+        }
+
+        log("ParallelCommandRecorder created with %u threads", m_threadCount);
+    }
+
+    ParallelCommandRecorder::~ParallelCommandRecorder() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_wakeCondition.notify_all();
+        for (auto& worker : m_workers) {
+            worker.join();
+        }
+
+        for (auto& threads : m_frames) {
+            for (auto& threadFrame : threads) {
+                if (threadFrame.pool != VK_NULL_HANDLE) {
+                    vkDestroyCommandPool(m_r_context.device, threadFrame.pool, nullptr);
+                }
+            }
+        }
+    }
+
+    void ParallelCommandRecorder::beginFrame(uint32_t frameIndex) {
+        for (auto& threadFrame : m_frames[frameIndex]) {
+            vkResetCommandPool(m_r_context.device, threadFrame.pool, 0);
+            threadFrame.used = 0;
+        }
+    }
+
+    VkCommandBuffer ParallelCommandRecorder::acquire(ThreadFrame& threadFrame) {
+        if (threadFrame.used == threadFrame.buffers.size()) {
+            VkCommandBufferAllocateInfo allocInfo{};
+            allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+            allocInfo.commandPool = threadFrame.pool;
+            allocInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+            allocInfo.commandBufferCount = 1;
+
+            VkCommandBuffer buffer;
+            vkAllocateCommandBuffers(m_r_context.device, &allocInfo, &buffer);
+            threadFrame.buffers.push_back(buffer);
+        }
+        return threadFrame.buffers[threadFrame.used++];
+    }
+
+    void ParallelCommandRecorder::recordShare(uint32_t threadIndex) {
+        VEX_PROFILE_SCOPE("Record commands");
+        const auto& tasks = *m_p_tasks;
+        ThreadFrame& threadFrame = m_frames[m_frameIndex][threadIndex];
+
+        VkCommandBufferInheritanceInfo inheritance{};
+        inheritance.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+        inheritance.pNext = &m_renderingInfo;
+        inheritance.pipelineStatistics = m_pipelineStatistics;
+
+        VkCommandBufferBeginInfo beginInfo{};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+        beginInfo.pInheritanceInfo = &inheritance;
+
+        for (size_t i = 0; i < tasks.size(); i++) {
+            if (m_taskThreads[i] != threadIndex) continue;
+
+            VkCommandBuffer buffer = acquire(threadFrame);
+            vkBeginCommandBuffer(buffer, &beginInfo);
+            try {
+                tasks[i].record(buffer);
+            } catch (const std::exception& e) {
+                log(LogLevel::ERROR, "Secondary command buffer recording failed: %s", e.what());
+            }
+            vkEndCommandBuffer(buffer);
+
+            (*m_p_outBuffers)[i] = buffer;
+        }
+    }
+
+    void ParallelCommandRecorder::workerLoop(uint32_t threadIndex) {
+        uint64_t seenGeneration = 0;
+        Profiler::setThreadName(("Record worker " + std::to_string(threadIndex)).c_str());
+
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_wakeCondition.wait(lock, [&] { return m_stop || m_generation != seenGeneration; });
+                if (m_stop) return;
+                seenGeneration = m_generation;
+            }
+
+            recordShare(threadIndex);
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_busyWorkers--;
+            }
+            m_doneCondition.notify_one();
+        }
+    }
+
+    void ParallelCommandRecorder::record(uint32_t frameIndex, const VkCommandBufferInheritanceRenderingInfo& renderingInfo,
+                                         const std::vector<RecordTask>& tasks, std::vector<VkCommandBuffer>& outBuffers,
+                                         VkQueryPipelineStatisticFlags pipelineStatistics) {
+        outBuffers.assign(tasks.size(), VK_NULL_HANDLE);
+        if (tasks.empty()) return;
+
+        // Fixed round robin over tasks that may run anywhere, so the split only depends on task order.
+        m_taskThreads.resize(tasks.size());
+        uint32_t parallelIndex = 0;
+        for (size_t i = 0; i < tasks.size(); i++) {
+            m_taskThreads[i] = tasks[i].mainThreadOnly ? 0 : (parallelIndex++ % m_threadCount);
+        }
+
+        m_frameIndex = frameIndex;
+        m_p_tasks = &tasks;
+        m_renderingInfo = renderingInfo;
+        m_renderingInfo.pNext = nullptr;
+        m_pipelineStatistics = pipelineStatistics;
+        m_p_outBuffers = &outBuffers;
+
+        if (!m_workers.empty()) {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_busyWorkers = static_cast<uint32_t>(m_workers.size());
+                m_generation++;
+            }
+            m_wakeCondition.notify_all();
+        }
+
+        recordShare(0);
+
+        if (!m_workers.empty()) {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_doneCondition.wait(lock, [&] { return m_busyWorkers == 0; });
+        }
+
+        m_p_tasks = nullptr;
+        m_p_outBuffers = nullptr;
+    }
+}
@@ -0,0 +1,94 @@
+/**
+ *  @file   CommandRecorder.hpp
+ *  @brief  This file defines ParallelCommandRecorder class recording secondary command buffers on worker threads.
+ *  @author Eryk Roszkowski
+ ***********************************************/
+
+#pragma once
+#include "context.hpp"
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace vex {
+    /// @brief Single unit of work recorded into its own secondary command buffer.
+    struct RecordTask {
+        /// @brief Records commands into given secondary command buffer.
+        std::function<void(VkCommandBuffer)> record;
+        /// @brief Task touches state that is not thread safe (mesh registration, texture lazy loading, UI) and has to run on calling thread.
+        bool mainThreadOnly = false;
+    };
+
+    /// @brief Records secondary command buffers for dynamic rendering on a fixed set of threads.
+    /// @details Every thread owns one command pool per frame in flight, pools are reset in `beginFrame` once the frame fence was waited.
+    /// Tasks are assigned to threads by their index, so the same task list always gives the same command buffers in the same order,
+    /// no matter which thread finishes first. The calling thread works as thread 0.
+    class ParallelCommandRecorder {
+    public:
+        /// @brief Constructor for ParallelCommandRecorder, creates command pools and starts `threadCount - 1` workers.
+        /// @param VulkanContext& context - Reference to the VulkanContext object.
+        /// @param uint32_t threadCount - Number of recording threads including the calling thread.
+        ParallelCommandRecorder(VulkanContext& context, uint32_t threadCount);
+        ~ParallelCommandRecorder();
+
+        ParallelCommandRecorder(const ParallelCommandRecorder&) = delete;
+        ParallelCommandRecorder& operator=(const ParallelCommandRecorder&) = delete;
+
+        /// @brief Resets command pools of a frame, GPU must be done with it.
+        /// @param uint32_t frameIndex - Frame in flight index.
+        void beginFrame(uint32_t frameIndex);
+
+        /// @brief Records tasks into secondary command buffers inheriting current dynamic rendering.
+        /// @param uint32_t frameIndex - Frame in flight index.
+        /// @param const VkCommandBufferInheritanceRenderingInfo& renderingInfo - Attachment formats of the rendering the buffers will execute in.
+        /// @param const std::vector<RecordTask>& tasks - Tasks in execution order.
+        /// @param std::vector<VkCommandBuffer>& outBuffers - Receives one buffer per task, in task order.
+        /// @param VkQueryPipelineStatisticFlags pipelineStatistics - Statistics of a pipeline statistics query active while the buffers execute, 0 if none.
+        void record(uint32_t frameIndex, const VkCommandBufferInheritanceRenderingInfo& renderingInfo,
+                    const std::vector<RecordTask>& tasks, std::vector<VkCommandBuffer>& outBuffers,
+                    VkQueryPipelineStatisticFlags pipelineStatistics = 0);
+
+        /// @brief Returns number of recording threads including the calling thread.
+        /// @return uint32_t
+        uint32_t getThreadCount() const { return m_threadCount; }
+
+    private:
+        /// @brief Command pool and buffers of one thread for one frame.
+        struct ThreadFrame {
+            VkCommandPool pool = VK_NULL_HANDLE;
+            std::vector<VkCommandBuffer> buffers;
+            uint32_t used = 0;
+        };
+
+        /// @brief Worker main loop, waits for a new dispatch and records its share of tasks.
+        void workerLoop(uint32_t threadIndex);
+
+        /// @brief Records all tasks that belong to a thread.
+        void recordShare(uint32_t threadIndex);
+
+        /// @brief Returns next unused secondary command buffer of a thread, allocates more if needed.
+        VkCommandBuffer acquire(ThreadFrame& threadFrame);
+
+        VulkanContext& m_r_context;
+        uint32_t m_threadCount;
+        std::vector<std::vector<ThreadFrame>> m_frames;
+        std::vector<std::thread> m_workers;
+
+        std::mutex m_mutex;
+        std::condition_variable m_wakeCondition;
+        std::condition_variable m_doneCondition;
+        uint64_t m_generation = 0;
+        uint32_t m_busyWorkers = 0;
+        bool m_stop = false;
+
+        uint32_t m_frameIndex = 0;
+        const std::vector<RecordTask>* m_p_tasks = nullptr;
+        std::vector<uint32_t> m_taskThreads;
+        VkCommandBufferInheritanceRenderingInfo m_renderingInfo{};
+        VkQueryPipelineStatisticFlags m_pipelineStatistics = 0;
+        std::vector<VkCommandBuffer>* m_p_outBuffers = nullptr;
+    };
+}
@@ -0,0 +1,52 @@
+#include "DeferredDeletionQueue.hpp"
+
+namespace vex {
+    void DeferredDeletionQueue::push(std::function<void()> deleter) {
+        if (m_immediate) {
+            deleter();
+            return;
+        }
+        if (m_buckets.empty()) {
+            m_buckets.resize(1);
+        }
+        m_buckets[m_currentSlot].push_back(std::move(deleter));
+    }
+
+    void DeferredDeletionQueue::beginFrame(uint32_t frameIndex, uint32_t framesInFlight) {
+        if (m_buckets.size() < framesInFlight) {
+            m_buckets.resize(framesInFlight);
+        }
+
+        m_currentSlot = frameIndex;
+
+        // Swapped out first, deleters pushing new work must not touch the vector being iterated.
+        m_running.swap(m_buckets[frameIndex]);
+        for (auto& deleter : m_running) {
+            deleter();
+        }
+        m_running.clear();
+    }
+
+    void DeferredDeletionQueue::flushAll() {
+        bool ranAny = true;
+        while (ranAny) {
+            ranAny = false;
+            for (auto& bucket : m_buckets) {
+                m_running.swap(bucket);
+                for (auto& deleter : m_running) {
+                    deleter();
+                    ranAny = true;
+                }
+                m_running.clear();
+            }
+        }
+    }
+
+    size_t DeferredDeletionQueue::getPendingCount() const {
+        size_t count = 0;
+        for (const auto& bucket : m_buckets) {
+            count += bucket.size();
+        }
+        return count;
+    }
+}
@@ -0,0 +1,50 @@
+/**
+ *  @file   DeferredDeletionQueue.hpp
+ *  @brief  This file defines DeferredDeletionQueue class releasing GPU resources once no frame in flight can use them.
+ *  @author Eryk Roszkowski
+ ***********************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace vex {
+    /// @brief Destroys GPU resources after the frames that could still use them finished, instead of waiting for device idle.
+    /// @details There is one bucket per frame in flight. A deleter pushed while frame slot `n` is the last begun frame goes to bucket `n`
+    /// and runs the next time slot `n` begins, right after its fence was waited. Frames are submitted in order, so by then every frame
+    /// that was recorded before the push has finished too.
+    ///
+    /// Deleters run on the render thread, they may push new deleters (they end up in the current bucket).
+    class DeferredDeletionQueue {
+    public:
+        /// @brief Queues a deleter for the last begun frame.
+        /// @details Runs right away in immediate mode, see `setImmediate`.
+        /// @param std::function<void()> deleter - Function destroying the resource.
+        void push(std::function<void()> deleter);
+
+        /// @brief Runs deleters queued when this slot was used last time and makes it the current slot.
+        /// @details Must be called after the fence of `frameIndex` was waited.
+        /// @param uint32_t frameIndex - Frame in flight slot that is being begun.
+        /// @param uint32_t framesInFlight - Number of slots.
+        void beginFrame(uint32_t frameIndex, uint32_t framesInFlight);
+
+        /// @brief Runs every queued deleter, device has to be idle.
+        void flushAll();
+
+        /// @brief Makes `push` run deleters right away. Used during shutdown, after the device went idle for the last time.
+        /// @param bool immediate - New mode.
+        void setImmediate(bool immediate) { m_immediate = immediate; }
+
+        /// @brief Returns number of deleters waiting for their frame.
+        /// @return size_t
+        size_t getPendingCount() const;
+
+    private:
+        std::vector<std::vector<std::function<void()>>> m_buckets;
+        std::vector<std::function<void()>> m_running;
+        uint32_t m_currentSlot = 0;
+        bool m_immediate = false;
+    };
+}
@@ -0,0 +1,255 @@
+#include "GpuProfiler.hpp"
+#include "components/errorUtils.hpp"
+#include "limits.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace vex {
+    GpuProfiler::GpuProfiler(VulkanContext& context)
+        : m_r_context(context) {
+        VkPhysicalDeviceProperties properties;
+        vkGetPhysicalDeviceProperties(m_r_context.physicalDevice, &properties);
+
+        uint32_t familyCount = 0;
+        vkGetPhysicalDeviceQueueFamilyProperties(m_r_context.physicalDevice, &familyCount, nullptr);
+        std::vector<VkQueueFamilyProperties> families(familyCount);
+        vkGetPhysicalDeviceQueueFamilyProperties(m_r_context.physicalDevice, &familyCount, families.data());
+
+        const uint32_t validBits = m_r_context.graphicsQueueFamily < familyCount ? families[m_r_context.graphicsQueueFamily].timestampValidBits : 0;
+        m_timestampPeriod = properties.limits.timestampPeriod;
+        m_timestampMask = validBits >= 64 ? UINT64_MAX : (1ull << validBits) - 1;
+        m_supported = validBits > 0 && m_timestampPeriod > 0.0;
+
+        // Device is created with every supported core feature enabled, so support is all that has to be checked.
+        VkPhysicalDeviceFeatures features;
+        vkGetPhysicalDeviceFeatures(m_r_context.physicalDevice, &features);
+        m_statisticsSupported = m_supported && features.pipelineStatisticsQuery == VK_TRUE;
+        m_inheritedQueries = features.inheritedQueries == VK_TRUE;
+
+        if (m_supported) {
+            log("GPU profiler: %u bit timestamps, %.3f ns per tick, pipeline statistics %s", validBits, m_timestampPeriod,
+                m_statisticsSupported ? "supported" : "not supported");
+        } else {
+            log(LogLevel::WARNING, "GPU profiler disabled, graphics queue has no usable timestamps (valid bits: %u, period: %.3f)", validBits, m_timestampPeriod);
+        }
+    }
+
+    GpuProfiler::~GpuProfiler() {
+        for (auto& frame : m_frames) {
+            if (frame.timestampPool != VK_NULL_HANDLE) vkDestroyQueryPool(m_r_context.device, frame.timestampPool, nullptr);
+            if (frame.statisticsPool != VK_NULL_HANDLE) vkDestroyQueryPool(m_r_context.device, frame.statisticsPool, nullptr);
+        }
+    }
+
+    void GpuProfiler::beginFrame(VkCommandBuffer cmd, uint32_t frameIndex) {
+        m_p_current = nullptr;
+        m_frameScope = NO_SCOPE;
+        m_openScopes = 0;
+        m_statisticsOpen = false;
+        if (!m_supported) return;
+
+        if (frameIndex >= m_frames.size()) {
+            m_frames.resize(frameIndex + 1);
+        }
+
+        if (m_clearRequested) {
+            m_timings.clear();
+            m_histories.clear();
+            for (auto& frame : m_frames) {
+                frame.submitted = false;
+            }
+            m_clearRequested = false;
+        }
+
+        FrameQueries& frame = m_frames[frameIndex];
+        if (frame.submitted) {
+            collect(frame);
+        }
+        frame.scopes.clear();
+        frame.statisticsUsed = 0;
+        frame.submitted = false;
+
+        if (!m_enabled) return;
+
+        if (frame.timestampPool == VK_NULL_HANDLE) {
+            createPools(frame);
+            if (!m_supported) return;
+        }
+
+        vkCmdResetQueryPool(cmd, frame.timestampPool, 0, MAX_GPU_SCOPES * 2);
+        if (frame.statisticsPool != VK_NULL_HANDLE) {
+            vkCmdResetQueryPool(cmd, frame.statisticsPool, 0, MAX_GPU_SCOPES);
+        }
+
+        m_p_current = &frame;
+        m_frameScope = beginScope(cmd, "Frame");
+    }
+
+    void GpuProfiler::endFrame(VkCommandBuffer cmd) {
+        if (!m_p_current) return;
+
+        endScope(cmd, m_frameScope);
+        m_p_current->submitted = true;
+        m_p_current = nullptr;
+    }
+
+    uint32_t GpuProfiler::beginScope(VkCommandBuffer cmd, const char* name, bool statistics) {
+        const uint32_t scope = reserveScope(name);
+        if (scope == NO_SCOPE) return NO_SCOPE;
+
+        writeScopeBegin(cmd, scope);
+        if (statistics && m_p_current->statisticsPool != VK_NULL_HANDLE && !m_statisticsOpen) {
+            RecordedScope& recorded = m_p_current->scopes[scope];
+            recorded.statisticsQuery = m_p_current->statisticsUsed++;
+            vkCmdBeginQuery(cmd, m_p_current->statisticsPool, recorded.statisticsQuery, 0);
+            m_statisticsOpen = true;
+        }
+
+        m_openScopes++;
+        return scope;
+    }
+
+    void GpuProfiler::endScope(VkCommandBuffer cmd, uint32_t scope) {
+        if (scope == NO_SCOPE || !m_p_current) return;
+
+        const RecordedScope& recorded = m_p_current->scopes[scope];
+        if (recorded.statisticsQuery != NO_SCOPE) {
+            vkCmdEndQuery(cmd, m_p_current->statisticsPool, recorded.statisticsQuery);
+            m_statisticsOpen = false;
+        }
+
+        writeScopeEnd(cmd, scope);
+        m_openScopes--;
+    }
+
+    uint32_t GpuProfiler::reserveScope(const char* name) {
+        if (!m_p_current) return NO_SCOPE;
+
+        if (m_p_current->scopes.size() >= MAX_GPU_SCOPES) {
+            if (!m_warnedScopeLimit) {
+                log(LogLevel::WARNING, "More than %u GPU profiler scopes in a frame, the rest isn't measured", MAX_GPU_SCOPES);
+                m_warnedScopeLimit = true;
+            }
+            return NO_SCOPE;
+        }
+
+        m_p_current->scopes.push_back({ findTiming(name, m_openScopes) });
+        return static_cast<uint32_t>(m_p_current->scopes.size() - 1);
+    }
+
+    void GpuProfiler::writeScopeBegin(VkCommandBuffer cmd, uint32_t scope) const {
+        if (scope == NO_SCOPE || !m_p_current) return;
+        vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, m_p_current->timestampPool, scope * 2);
+    }
+
+    void GpuProfiler::writeScopeEnd(VkCommandBuffer cmd, uint32_t scope) const {
+        if (scope == NO_SCOPE || !m_p_current) return;
+        vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, m_p_current->timestampPool, scope * 2 + 1);
+    }
+
+    uint32_t GpuProfiler::findTiming(const char* name, uint32_t depth) {
+        for (uint32_t i = 0; i < m_timings.size(); i++) {
+            if (std::strcmp(m_timings[i].name.c_str(), name) == 0) {
+                m_timings[i].depth = depth;
+                return i;
+            }
+        }
+
+        GpuScopeTiming timing;
+        timing.name = name;
+        timing.depth = depth;
+        m_timings.push_back(std::move(timing));
+        m_histories.emplace_back();
+        return static_cast<uint32_t>(m_timings.size() - 1);
+    }
+
+    void GpuProfiler::createPools(FrameQueries& frame) {
+        VkQueryPoolCreateInfo poolInfo{};
+        poolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        poolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+        poolInfo.queryCount = MAX_GPU_SCOPES * 2;
+
+        if (vkCreateQueryPool(m_r_context.device, &poolInfo, nullptr, &frame.timestampPool) != VK_SUCCESS) {
+            log(LogLevel::WARNING, "Failed to create timestamp query pool, GPU profiler disabled");
+            frame.timestampPool = VK_NULL_HANDLE;
+            m_supported = false;
+            return;
+        }
+
+        if (m_statisticsSupported) {
+            poolInfo.queryType = VK_QUERY_TYPE_PIPELINE_STATISTICS;
+            poolInfo.queryCount = MAX_GPU_SCOPES;
+            poolInfo.pipelineStatistics = STATISTIC_FLAGS;
+
+            if (vkCreateQueryPool(m_r_context.device, &poolInfo, nullptr, &frame.statisticsPool) != VK_SUCCESS) {
+                log(LogLevel::WARNING, "Failed to create pipeline statistics query pool, only timestamps are measured");
+                frame.statisticsPool = VK_NULL_HANDLE;
+            }
+        }
+    }
+
+    void GpuProfiler::collect(FrameQueries& frame) {
+        const uint32_t scopeCount = static_cast<uint32_t>(frame.scopes.size());
+        if (scopeCount == 0) return;
+
+        // The frame fence was waited, so no WAIT flag. A scope left open (aborted frame) stays unavailable and drops the whole frame.
+        m_queryScratch.resize(scopeCount * 2);
+        VkResult result = vkGetQueryPoolResults(m_r_context.device, frame.timestampPool, 0, scopeCount * 2,
+                                                m_queryScratch.size() * sizeof(uint64_t), m_queryScratch.data(), sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+        if (result != VK_SUCCESS) {
+            m_droppedFrames++;
+            return;
+        }
+
+        bool hasStatistics = false;
+        if (frame.statisticsUsed > 0) {
+            m_statisticsScratch.resize(frame.statisticsUsed * STATISTIC_COUNT);
+            result = vkGetQueryPoolResults(m_r_context.device, frame.statisticsPool, 0, frame.statisticsUsed,
+                                           m_statisticsScratch.size() * sizeof(uint64_t), m_statisticsScratch.data(),
+                                           STATISTIC_COUNT * sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+            hasStatistics = result == VK_SUCCESS;
+        }
+
+        // Scopes with the same name recorded more than once in a frame count as one sample of their total.
+        m_frameTotals.assign(m_timings.size(), -1.0f);
+        for (uint32_t i = 0; i < scopeCount; i++) {
+            const RecordedScope& recorded = frame.scopes[i];
+            if (recorded.timing >= m_timings.size()) continue;
+
+            const uint64_t ticks = (m_queryScratch[i * 2 + 1] - m_queryScratch[i * 2]) & m_timestampMask;
+            const float ms = static_cast<float>(ticks * m_timestampPeriod / 1000000.0);
+            float& total = m_frameTotals[recorded.timing];
+            total = std::max(total, 0.0f) + ms;
+
+            GpuScopeTiming& timing = m_timings[recorded.timing];
+            if (hasStatistics && recorded.statisticsQuery != NO_SCOPE) {
+                // Values come in bit order of STATISTIC_FLAGS.
+                const uint64_t* values = &m_statisticsScratch[recorded.statisticsQuery * STATISTIC_COUNT];
+                timing.statistics = { values[0], values[1], values[2], values[3], values[4] };
+                timing.hasStatistics = true;
+            }
+        }
+
+        for (uint32_t i = 0; i < m_frameTotals.size(); i++) {
+            if (m_frameTotals[i] < 0.0f) continue;
+
+            TimingHistory& history = m_histories[i];
+            if (history.samples.size() < GPU_PROFILER_HISTORY) {
+                history.samples.push_back(m_frameTotals[i]);
+            } else {
+                history.samples[history.next] = m_frameTotals[i];
+            }
+            history.next = (history.next + 1) % GPU_PROFILER_HISTORY;
+
+            GpuScopeTiming& timing = m_timings[i];
+            timing.lastMs = m_frameTotals[i];
+            timing.minMs = *std::min_element(history.samples.begin(), history.samples.end());
+            timing.maxMs = *std::max_element(history.samples.begin(), history.samples.end());
+            float sum = 0.0f;
+            for (float sample : history.samples) sum += sample;
+            timing.avgMs = sum / history.samples.size();
+            timing.samples = static_cast<uint32_t>(history.samples.size());
+        }
+    }
+}
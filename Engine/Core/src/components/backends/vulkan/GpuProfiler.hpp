@@ -0,0 +1,216 @@
+/**
+ *  @file   GpuProfiler.hpp
+ *  @brief  This file defines GpuProfiler class measuring GPU time of named render scopes with timestamp queries.
+ *  @author Eryk Roszkowski
+ ***********************************************/
+
+#pragma once
+#include "context.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace vex {
+    /// @brief Pipeline statistics of one scope, all zero when the device can't count them.
+    struct GpuPipelineStatistics {
+        uint64_t inputVertices = 0;
+        uint64_t inputPrimitives = 0;
+        uint64_t vertexInvocations = 0;
+        uint64_t clippingPrimitives = 0;
+        uint64_t fragmentInvocations = 0;
+    };
+
+    /// @brief GPU time of one named scope over the last `GPU_PROFILER_HISTORY` frames it was recorded in.
+    struct GpuScopeTiming {
+        std::string name;
+        /// @brief Nesting level, 0 for the whole frame.
+        uint32_t depth = 0;
+        float lastMs = 0.0f;
+        float minMs = 0.0f;
+        float avgMs = 0.0f;
+        float maxMs = 0.0f;
+        /// @brief Frames in the history, at most `GPU_PROFILER_HISTORY`.
+        uint32_t samples = 0;
+        /// @brief True if `statistics` were counted for this scope.
+        bool hasStatistics = false;
+        /// @brief Statistics of the last frame.
+        GpuPipelineStatistics statistics;
+    };
+
+    /// @brief Measures GPU time of named scopes of the frame command buffer.
+    /// @details Every frame in flight has its own timestamp query pool (and pipeline statistics pool if supported). Results of a frame slot
+    /// are read in `beginFrame` once its fence was waited, so they are `MAX_FRAMES_IN_FLIGHT` frames old and reading never stalls.
+    /// Scopes are opened on the render thread, either directly with `beginScope`/`GpuScope` or reserved with `reserveScope` and written
+    /// from secondary command buffers. If the graphics queue has no timestamps or `timestampPeriod` is 0 every call does nothing.
+    class GpuProfiler {
+    public:
+        /// @brief Returned instead of a scope index when the scope isn't measured.
+        static constexpr uint32_t NO_SCOPE = UINT32_MAX;
+
+        /// @brief Constructor for GpuProfiler, checks timestamp support of the graphics queue. Query pools are created on first use.
+        /// @param VulkanContext& context - Reference to the VulkanContext object.
+        GpuProfiler(VulkanContext& context);
+        ~GpuProfiler();
+
+        GpuProfiler(const GpuProfiler&) = delete;
+        GpuProfiler& operator=(const GpuProfiler&) = delete;
+
+        /// @brief Collects finished results of a frame slot, resets its queries and opens the "Frame" scope.
+        /// @param VkCommandBuffer cmd - Frame command buffer, outside of any rendering.
+        /// @param uint32_t frameIndex - Frame in flight index, its fence must be signaled.
+        void beginFrame(VkCommandBuffer cmd, uint32_t frameIndex);
+
+        /// @brief Closes the "Frame" scope, call right before the command buffer ends.
+        /// @param VkCommandBuffer cmd - Frame command buffer.
+        void endFrame(VkCommandBuffer cmd);
+
+        /// @brief Opens a scope and writes its start timestamp.
+        /// @param VkCommandBuffer cmd - Frame command buffer.
+        /// @param const char* name - Scope name, scopes with the same name share their history.
+        /// @param bool statistics - Also count pipeline statistics. Only one such scope can be open at a time and it has to begin and end outside of rendering.
+        /// @return uint32_t - Scope index for `endScope`, `NO_SCOPE` if not measured.
+        uint32_t beginScope(VkCommandBuffer cmd, const char* name, bool statistics = false);
+
+        /// @brief Writes end timestamp of a scope opened by `beginScope`.
+        /// @param VkCommandBuffer cmd - Frame command buffer.
+        /// @param uint32_t scope - Index returned by `beginScope`.
+        void endScope(VkCommandBuffer cmd, uint32_t scope);
+
+        /// @brief Reserves a timestamp scope nested in the currently open ones without writing anything.
+        /// @details For work recorded later or on other threads, the recording code calls `writeScopeBegin` and `writeScopeEnd`.
+        /// Both have to end up in the frame command buffer or secondary buffers executed by it, in that order.
+        /// @param const char* name - Scope name.
+        /// @return uint32_t - Scope index, `NO_SCOPE` if not measured.
+        uint32_t reserveScope(const char* name);
+
+        /// @brief Writes start timestamp of a reserved scope. Thread safe.
+        /// @param VkCommandBuffer cmd - Primary or secondary command buffer.
+        /// @param uint32_t scope - Index returned by `reserveScope`.
+        void writeScopeBegin(VkCommandBuffer cmd, uint32_t scope) const;
+
+        /// @brief Writes end timestamp of a reserved scope. Thread safe.
+        /// @param VkCommandBuffer cmd - Primary or secondary command buffer.
+        /// @param uint32_t scope - Index returned by `reserveScope`.
+        void writeScopeEnd(VkCommandBuffer cmd, uint32_t scope) const;
+
+        /// @brief Returns pipeline statistics counted by statistics scopes, secondary command buffers executed inside them have to inherit it.
+        /// @return VkQueryPipelineStatisticFlags - 0 if none are counted this frame.
+        VkQueryPipelineStatisticFlags getInheritedStatistics() const { return m_statisticsOpen ? STATISTIC_FLAGS : 0; }
+
+        /// @brief Returns per scope timings in the order scopes were first seen.
+        /// @return const std::vector<GpuScopeTiming>&
+        const std::vector<GpuScopeTiming>& getTimings() const { return m_timings; }
+
+        /// @brief Forgets all timings and results still in flight, applied at the start of the next frame.
+        void clearHistory() { m_clearRequested = true; }
+
+        /// @brief Enables or disables measuring, applied from the next frame.
+        /// @param bool enabled
+        void setEnabled(bool enabled) { m_enabled = enabled; }
+
+        /// @brief Returns true if measuring is enabled, even when unsupported.
+        /// @return bool
+        bool isEnabled() const { return m_enabled; }
+
+        /// @brief Returns true if the device can write timestamps on the graphics queue.
+        /// @return bool
+        bool isSupported() const { return m_supported; }
+
+        /// @brief Returns true if the device can count pipeline statistics.
+        /// @return bool
+        bool supportsStatistics() const { return m_statisticsSupported; }
+
+        /// @brief Returns true if statistics scopes can stay open while secondary command buffers execute (`inheritedQueries` feature).
+        /// @return bool
+        bool supportsInheritedStatistics() const { return m_statisticsSupported && m_inheritedQueries; }
+
+        /// @brief Returns frames whose results weren't available when their slot came around again, they are skipped.
+        /// @return uint64_t
+        uint64_t getDroppedFrames() const { return m_droppedFrames; }
+
+    private:
+        static constexpr VkQueryPipelineStatisticFlags STATISTIC_FLAGS =
+            VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_VERTICES_BIT |
+            VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_PRIMITIVES_BIT |
+            VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT |
+            VK_QUERY_PIPELINE_STATISTIC_CLIPPING_PRIMITIVES_BIT |
+            VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT;
+        static constexpr uint32_t STATISTIC_COUNT = 5;
+
+        /// @brief Scope recorded in a frame, its timestamps are queries `2 * index` and `2 * index + 1`.
+        struct RecordedScope {
+            uint32_t timing;
+            uint32_t statisticsQuery = NO_SCOPE;
+        };
+
+        /// @brief Query pools of one frame in flight and scopes recorded into them.
+        struct FrameQueries {
+            VkQueryPool timestampPool = VK_NULL_HANDLE;
+            VkQueryPool statisticsPool = VK_NULL_HANDLE;
+            std::vector<RecordedScope> scopes;
+            uint32_t statisticsUsed = 0;
+            bool submitted = false;
+        };
+
+        /// @brief Rolling history of one scope name.
+        struct TimingHistory {
+            std::vector<float> samples;
+            uint32_t next = 0;
+        };
+
+        /// @brief Returns timing entry of a name, adds it if new.
+        uint32_t findTiming(const char* name, uint32_t depth);
+
+        /// @brief Creates query pools of a frame slot.
+        void createPools(FrameQueries& frame);
+
+        /// @brief Reads results of a submitted frame slot into timings.
+        void collect(FrameQueries& frame);
+
+        VulkanContext& m_r_context;
+        bool m_supported = false;
+        bool m_statisticsSupported = false;
+        bool m_inheritedQueries = false;
+        bool m_enabled = true;
+        bool m_clearRequested = false;
+        double m_timestampPeriod = 0.0; // nanoseconds per tick
+        uint64_t m_timestampMask = 0;
+
+        std::vector<FrameQueries> m_frames;
+        FrameQueries* m_p_current = nullptr; // null while not measuring
+        uint32_t m_frameScope = NO_SCOPE;
+        uint32_t m_openScopes = 0;
+        bool m_statisticsOpen = false;
+        bool m_warnedScopeLimit = false;
+        uint64_t m_droppedFrames = 0;
+
+        std::vector<GpuScopeTiming> m_timings;
+        std::vector<TimingHistory> m_histories;
+        std::vector<uint64_t> m_queryScratch;
+        std::vector<uint64_t> m_statisticsScratch;
+        std::vector<float> m_frameTotals;
+    };
+
+    /// @brief Measures GPU time between its construction and destruction, see `GpuProfiler::beginScope`.
+    class GpuScope {
+    public:
+        /// @brief Opens a scope.
+        /// @param GpuProfiler& profiler - Profiler of the renderer.
+        /// @param VkCommandBuffer cmd - Frame command buffer.
+        /// @param const char* name - Scope name.
+        /// @param bool statistics - Also count pipeline statistics, see `GpuProfiler::beginScope`.
+        GpuScope(GpuProfiler& profiler, VkCommandBuffer cmd, const char* name, bool statistics = false)
+            : m_r_profiler(profiler), m_cmd(cmd), m_scope(profiler.beginScope(cmd, name, statistics)) {}
+
+        ~GpuScope() { m_r_profiler.endScope(m_cmd, m_scope); }
+
+        GpuScope(const GpuScope&) = delete;
+        GpuScope& operator=(const GpuScope&) = delete;
+
+    private:
+        GpuProfiler& m_r_profiler;
+        VkCommandBuffer m_cmd;
+        uint32_t m_scope;
+    };
+}
@@ -9,30 +9,43 @@
 #include <algorithm>
 #include <set>
 #include <fstream>
+#include <cstring>
 
 #include <immintrin.h>
 #include "../../HardwareInfo.hpp"
+#include "components/ImageWriter.hpp"
 
 namespace vex {
-    Interface::Interface(SDL_Window* window, glm::uvec2 initialResolution, GameInfo gInfo, VirtualFileSystem* vfs) : m_p_window(window), m_vfs(vfs) {
+    Interface::Interface(SDL_Window* window, glm::uvec2 initialResolution, GameInfo gInfo, VirtualFileSystem* vfs, bool headless) : m_p_window(window), m_vfs(vfs) {
         constexpr uint32_t apiVersion = VK_API_VERSION_1_3;
 
         m_context.currentRenderResolution = initialResolution;
+        m_context.headless = headless;
 
         try {
 
         log("Loading Vulkan library...");
-        if (!SDL_Vulkan_LoadLibrary(nullptr)) {
+        m_sdlVulkanLoaded = SDL_Vulkan_LoadLibrary(nullptr);
+        if (m_sdlVulkanLoaded) {
+            log("Initializing Volk...");
+            volkInitializeCustom(reinterpret_cast<PFN_vkGetInstanceProcAddr>(SDL_Vulkan_GetVkGetInstanceProcAddr()));
+        } else if (headless) {
+            // SDL's dummy video driver has no Vulkan support, nothing is presented so the system loader is enough.
+            log("SDL could not load Vulkan (%s), initializing Volk with the system loader...", SDL_GetError());
+            if (volkInitialize() != VK_SUCCESS) {
+                throw_error("Failed to load Vulkan library");
+            }
+        } else {
             throw_error(SDL_GetError());
         }
 
-        log("Initializing Volk...");
-        volkInitializeCustom(reinterpret_cast<PFN_vkGetInstanceProcAddr>(SDL_Vulkan_GetVkGetInstanceProcAddr()));
-
         log("Creating Vulkan instance...");
-        uint32_t sdlExtensionCount = 0;
-        const char* const* sdlExtensions = SDL_Vulkan_GetInstanceExtensions(&sdlExtensionCount);
-        std::vector<const char*> extensions(sdlExtensions, sdlExtensions + sdlExtensionCount);
+        std::vector<const char*> extensions;
+        if (!headless) {
+            uint32_t sdlExtensionCount = 0;
+            const char* const* sdlExtensions = SDL_Vulkan_GetInstanceExtensions(&sdlExtensionCount);
+            extensions.assign(sdlExtensions, sdlExtensions + sdlExtensionCount);
+        }
 
         extensions.push_back(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME);
 #ifdef __APPLE__
@@ -73,9 +86,13 @@ namespace vex {
 
         volkLoadInstance(m_context.instance);
 
-        log("Binding window...");
-        if (!SDL_Vulkan_CreateSurface(window, m_context.instance, nullptr, &m_context.surface)) {
-            throw_error("Failed to create Vulkan surface: " + std::string(SDL_GetError()));
+        if (headless) {
+            log("Headless mode, rendering into offscreen images");
+        } else {
+            log("Binding window...");
+            if (!SDL_Vulkan_CreateSurface(window, m_context.instance, nullptr, &m_context.surface)) {
+                throw_error("Failed to create Vulkan surface: " + std::string(SDL_GetError()));
+            }
         }
 
         uint32_t deviceCount = 0;
@@ -116,7 +133,12 @@ namespace vex {
                 }
 
                 VkBool32 presentSupport = false;
-                vkGetPhysicalDeviceSurfaceSupportKHR(device, i, m_context.surface, &presentSupport);
+                if (headless) {
+                    // Nothing is presented, present queue is just an alias of the graphics one.
+                    presentSupport = graphicsIdx == static_cast<uint32_t>(i);
+                } else {
+                    vkGetPhysicalDeviceSurfaceSupportKHR(device, i, m_context.surface, &presentSupport);
+                }
 
                 if (presentSupport) {
                     presentIdx = i;
@@ -149,6 +171,27 @@ namespace vex {
             log("Selected GPU: %s", deviceProperties.deviceName);
 
             m_context.physicalDevice = selectedDevice;
+
+            uint32_t queueFamilyCount = 0;
+            vkGetPhysicalDeviceQueueFamilyProperties(selectedDevice, &queueFamilyCount, nullptr);
+            std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+            vkGetPhysicalDeviceQueueFamilyProperties(selectedDevice, &queueFamilyCount, queueFamilies.data());
+
+            // Prefer transfer only family (DMA engine), then any non graphics family that can copy.
+            m_context.transferQueueFamily = m_context.graphicsQueueFamily;
+            int bestTransferScore = 0;
+            for (uint32_t i = 0; i < queueFamilyCount; i++) {
+                VkQueueFlags flags = queueFamilies[i].queueFlags;
+                if (!(flags & VK_QUEUE_TRANSFER_BIT) || (flags & VK_QUEUE_GRAPHICS_BIT) || queueFamilies[i].queueCount == 0) continue;
+
+                int transferScore = (flags & VK_QUEUE_COMPUTE_BIT) ? 1 : 2;
+                if (transferScore > bestTransferScore) {
+                    bestTransferScore = transferScore;
+                    m_context.transferQueueFamily = i;
+                }
+            }
+            log("Transfer queue family: %u%s", m_context.transferQueueFamily,
+                m_context.transferQueueFamily == m_context.graphicsQueueFamily ? " (shared with graphics)" : "");
         }
 
         if (m_context.physicalDevice == VK_NULL_HANDLE) {
@@ -156,7 +199,7 @@ namespace vex {
         }
 
         std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
-        std::set<uint32_t> uniqueQueueFamilies = {m_context.graphicsQueueFamily, m_context.presentQueueFamily};
+        std::set<uint32_t> uniqueQueueFamilies = {m_context.graphicsQueueFamily, m_context.presentQueueFamily, m_context.transferQueueFamily};
 
         float queuePriority = 1.0f;
         for (uint32_t queueFamily : uniqueQueueFamilies) {
@@ -169,13 +212,15 @@ namespace vex {
         }
 
         std::vector<const char*> deviceExtensions = {
-            VK_KHR_SWAPCHAIN_EXTENSION_NAME,
             VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME,
             VK_EXT_EXTENDED_DYNAMIC_STATE_2_EXTENSION_NAME
 #ifdef __APPLE__
             , VK_KHR_PORTABILITY_SUBSET_EXTENSION_NAME
 #endif
         };
+        if (!headless) {
+            deviceExtensions.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+        }
 
         VkPhysicalDeviceFeatures2 deviceFeatures2 = { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2 };
         VkPhysicalDeviceVulkan11Features features11 = { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_1_FEATURES };
@@ -199,7 +244,11 @@ namespace vex {
             log(LogLevel::WARNING, "Sampler Anisotropy not supported.");
         }
 
-        if (deviceFeatures2.features.multiDrawIndirect) {
+        // Cooked .vtex textures are BC encoded, without it loader falls back to source images.
+        m_context.supportsTextureCompressionBC = deviceFeatures2.features.textureCompressionBC == VK_TRUE;
+
+        // Indirect draws address their DrawData through firstInstance, so both are required.
+        if (deviceFeatures2.features.multiDrawIndirect && deviceFeatures2.features.drawIndirectFirstInstance) {
             m_context.supportsIndirectDraw = true;
             VkPhysicalDeviceProperties properties;
             vkGetPhysicalDeviceProperties(m_context.physicalDevice, &properties);
@@ -207,6 +256,7 @@ namespace vex {
         } else {
             m_context.supportsIndirectDraw = false;
             deviceFeatures2.features.multiDrawIndirect = VK_FALSE;
+            deviceFeatures2.features.drawIndirectFirstInstance = VK_FALSE;
         }
 
         if (features11.shaderDrawParameters) {
@@ -262,6 +312,19 @@ namespace vex {
             multiDrawFeatures.multiDraw = VK_FALSE;
         }
 
+        // Real heap budgets from the driver let texture streaming react to other processes, without it VMA estimates them.
+        uint32_t extensionCount = 0;
+        vkEnumerateDeviceExtensionProperties(m_context.physicalDevice, nullptr, &extensionCount, nullptr);
+        std::vector<VkExtensionProperties> availableExtensions(extensionCount);
+        vkEnumerateDeviceExtensionProperties(m_context.physicalDevice, nullptr, &extensionCount, availableExtensions.data());
+        for (const auto& extension : availableExtensions) {
+            if (strcmp(extension.extensionName, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME) == 0) {
+                m_context.supportsMemoryBudget = true;
+                deviceExtensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+                break;
+            }
+        }
+
         if (extendedDynamicState2Features.extendedDynamicState2) {
             extendedDynamicState2Features.extendedDynamicState2 = VK_TRUE;
         } else {
@@ -285,12 +348,19 @@ namespace vex {
             throw_error("Failed to create logical device");
         }
 
+        VkPhysicalDeviceProperties selectedProperties;
+        vkGetPhysicalDeviceProperties(m_context.physicalDevice, &selectedProperties);
+        m_context.supportsPipelineFeedback = selectedProperties.apiVersion >= VK_API_VERSION_1_3;
+
         log(" ======= Supported Features =======");
         log("GPU:");
         log("supportsMultiDraw: %s", m_context.supportsMultiDraw ? "true" : "false");
         log("supportsIndirectDraw: %s", m_context.supportsIndirectDraw ? "true" : "false");
         log("supportsBindlessTextures: %s", m_context.supportsBindlessTextures ? "true" : "false");
         log("supportsShaderDrawParameters: %s", m_context.supportsShaderDrawParameters ? "true" : "false");
+        log("supportsPipelineFeedback: %s", m_context.supportsPipelineFeedback ? "true" : "false");
+        log("supportsTextureCompressionBC: %s", m_context.supportsTextureCompressionBC ? "true" : "false");
+        log("supportsMemoryBudget: %s", m_context.supportsMemoryBudget ? "true" : "false");
         log("CPU:");
         log("supports AVX2: %s", HardwareInfo::HasAVX2() ? "true" : "false");
         log(" ==================================");
@@ -299,6 +369,7 @@ namespace vex {
 
         vkGetDeviceQueue(m_context.device, m_context.graphicsQueueFamily, 0, &m_context.graphicsQueue);
         vkGetDeviceQueue(m_context.device, m_context.presentQueueFamily, 0, &m_context.presentQueue);
+        vkGetDeviceQueue(m_context.device, m_context.transferQueueFamily, 0, &m_context.transferQueue);
 
         VmaVulkanFunctions vmaFuncs = {};
         vmaFuncs.vkGetInstanceProcAddr = vkGetInstanceProcAddr;
@@ -327,6 +398,9 @@ namespace vex {
         allocatorInfo.instance = m_context.instance;
         allocatorInfo.vulkanApiVersion = apiVersion;
         allocatorInfo.pVulkanFunctions = &vmaFuncs;
+        if (m_context.supportsMemoryBudget) {
+            allocatorInfo.flags |= VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT;
+        }
 
         if (vmaCreateAllocator(&allocatorInfo, &m_context.allocator) != VK_SUCCESS) {
             throw_error("Failed to create VMA allocator");
@@ -342,6 +416,9 @@ namespace vex {
         log("Initializing Mesh Manager...");
         m_p_meshManager = std::make_unique<MeshManager>(m_context, m_p_resources, m_vfs);
 
+        log("Initializing Pipeline Cache...");
+        m_p_pipelineCache = std::make_unique<PipelineCacheManager>(m_context, GetUserDataDir(gInfo.projectName) / "pipeline_cache.bin");
+
         log("Initializing Pipeline...");
         m_p_pipeline = std::make_unique<VulkanPipeline>(m_context);
 
@@ -394,6 +471,30 @@ namespace vex {
             attributes
         );
 
+        log("Initializing Compact Vertex Pipelines...");
+        VkVertexInputBindingDescription compactBindingDesc{};
+        compactBindingDesc.binding = 0;
+        compactBindingDesc.stride = sizeof(CompactVertex);
+        compactBindingDesc.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+
+        // Shaders still read float3 / float3 / float2, missing normal z is filled with 0 and decoded from xy.
+        std::vector<VkVertexInputAttributeDescription> compactAttributes(3);
+        compactAttributes[0] = {0, 0, VK_FORMAT_R16G16B16A16_UNORM, offsetof(CompactVertex, position)};
+        compactAttributes[1] = {1, 0, VK_FORMAT_R16G16_SNORM, offsetof(CompactVertex, normal)};
+        compactAttributes[2] = {2, 0, VK_FORMAT_R16G16_SFLOAT, offsetof(CompactVertex, uv)};
+
+        m_p_compactPipeline = std::make_unique<VulkanPipeline>(m_context);
+        m_p_compactPipeline->setCompactVertices(true);
+        m_p_compactPipeline->createGraphicsPipeline("Engine/shaders/OpaqueVert.spv", opaqueFrag, compactBindingDesc, compactAttributes);
+
+        m_p_compactMaskPipeline = std::make_unique<VulkanPipeline>(m_context);
+        m_p_compactMaskPipeline->setCompactVertices(true);
+        m_p_compactMaskPipeline->createMaskedPipeline("Engine/shaders/MaskedVert.spv", maskedFrag, compactBindingDesc, compactAttributes);
+
+        m_p_compactTransPipeline = std::make_unique<VulkanPipeline>(m_context);
+        m_p_compactTransPipeline->setCompactVertices(true);
+        m_p_compactTransPipeline->createTransparentPipeline("Engine/shaders/TransparentVert.spv", transFrag, compactBindingDesc, compactAttributes);
+
         log("Initializing UI Pipeline...");
         m_p_uiPipeline = std::make_unique<VulkanPipeline>(m_context);
 
@@ -441,6 +542,9 @@ namespace vex {
             m_p_pipeline,
             m_p_transPipeline,
             m_p_maskPipeline,
+            m_p_compactPipeline,
+            m_p_compactTransPipeline,
+            m_p_compactMaskPipeline,
             m_p_uiPipeline,
             m_p_fullscreenPipeline,
             m_p_swapchainManager,
@@ -451,6 +555,29 @@ namespace vex {
             m_p_renderer->setDebugPipeline(&m_p_debugPipeline);
         #endif
 
+        auto& permutations = m_p_renderer->getPipelinePermutations();
+        permutations.setRecipe(PipelinePass::OPAQUE, [=](VulkanPipeline& pipeline) {
+            pipeline.createGraphicsPipeline("Engine/shaders/OpaqueVert.spv", opaqueFrag, bindingDesc, attributes);
+        });
+        permutations.setRecipe(PipelinePass::MASKED, [=](VulkanPipeline& pipeline) {
+            pipeline.createMaskedPipeline("Engine/shaders/MaskedVert.spv", maskedFrag, bindingDesc, attributes);
+        });
+        permutations.setRecipe(PipelinePass::TRANSPARENT, [=](VulkanPipeline& pipeline) {
+            pipeline.createTransparentPipeline("Engine/shaders/TransparentVert.spv", transFrag, bindingDesc, attributes);
+        });
+        permutations.setRecipe(PipelinePass::OPAQUE_COMPACT, [=](VulkanPipeline& pipeline) {
+            pipeline.setCompactVertices(true);
+            pipeline.createGraphicsPipeline("Engine/shaders/OpaqueVert.spv", opaqueFrag, compactBindingDesc, compactAttributes);
+        });
+        permutations.setRecipe(PipelinePass::MASKED_COMPACT, [=](VulkanPipeline& pipeline) {
+            pipeline.setCompactVertices(true);
+            pipeline.createMaskedPipeline("Engine/shaders/MaskedVert.spv", maskedFrag, compactBindingDesc, compactAttributes);
+        });
+        permutations.setRecipe(PipelinePass::TRANSPARENT_COMPACT, [=](VulkanPipeline& pipeline) {
+            pipeline.setCompactVertices(true);
+            pipeline.createTransparentPipeline("Engine/shaders/TransparentVert.spv", transFrag, compactBindingDesc, compactAttributes);
+        });
+
         log("Vulkan interface initialized successfully");
 
         } catch (const std::exception& e) {
@@ -459,7 +586,10 @@ namespace vex {
     }
 
     Interface::~Interface() {
-        vkDeviceWaitIdle(m_context.device);
+        m_context.waitIdle();
+        // Nothing is in flight anymore, whatever is still queued or released from now on can go right away.
+        m_context.deletionQueue.flushAll();
+        m_context.deletionQueue.setImmediate(true);
 
         m_p_renderer.reset();
         m_p_meshManager.reset();
@@ -467,12 +597,16 @@ namespace vex {
         m_p_pipeline.reset();
         m_p_transPipeline.reset();
         m_p_maskPipeline.reset();
+        m_p_compactPipeline.reset();
+        m_p_compactTransPipeline.reset();
+        m_p_compactMaskPipeline.reset();
         m_p_uiPipeline.reset();
         m_p_fullscreenPipeline.reset();
         #if DEBUG
         m_p_debugPipeline.reset();
         m_p_physicsDebug.reset();
         #endif
+        m_p_pipelineCache.reset();
         m_p_swapchainManager->cleanupSwapchain();
         m_p_swapchainManager.reset();
 
@@ -505,7 +639,9 @@ namespace vex {
             m_context.instance = VK_NULL_HANDLE;
         }
 
-        SDL_Vulkan_UnloadLibrary();
+        if (m_sdlVulkanLoaded) {
+            SDL_Vulkan_UnloadLibrary();
+        }
     }
 
     void Interface::createDefaultTexture() {
@@ -513,19 +649,19 @@ namespace vex {
     }
 
     void Interface::WaitForGPUToFinish() {
-        vkDeviceWaitIdle(m_context.device);
+        m_context.waitIdle();
     }
 
     void Interface::setVSync(bool enabled) {
         m_p_swapchainManager->setVSync(enabled);
-        vkDeviceWaitIdle(m_context.device);
+        // Recreation waits for the device itself.
         m_context.requestSwapchainRecreation = true;
         //m_p_swapchainManager->recreateSwapchain();
     }
 
     void Interface::bindWindow(SDL_Window *m_p_window) {
         log("Binding window...");
-        if (m_context.surface) return;
+        if (m_context.surface || m_context.headless) return;
 
         if (!SDL_Vulkan_CreateSurface(m_p_window, m_context.instance, nullptr, &m_context.surface)) {
             throw_error("Failed to create Vulkan surface: " + std::string(SDL_GetError()));
@@ -538,12 +674,97 @@ namespace vex {
     }
 
     void Interface::unbindWindow() {
-        if (!m_context.surface) return;
+        if (!m_context.surface || m_context.headless) return;
 
-        vkDeviceWaitIdle(m_context.device);
+        m_context.waitIdle();
         m_p_swapchainManager->cleanupSwapchain();
 
         vkDestroySurfaceKHR(m_context.instance, m_context.surface, nullptr);
         m_context.surface = VK_NULL_HANDLE;
     }
+
+    bool Interface::readbackFrame(std::vector<uint8_t>& outPixels, glm::uvec2& outSize) {
+        if (!m_context.headless || m_context.swapchainImages.empty()) {
+            log(LogLevel::WARNING, "Frame readback is only available in headless mode");
+            return false;
+        }
+
+        // Last submitted frame has to finish, readback is for tests and benchmarks so the stall doesn't matter.
+        m_context.waitIdle();
+
+        const VkExtent2D extent = m_context.swapchainExtent;
+        const VkDeviceSize size = static_cast<VkDeviceSize>(extent.width) * extent.height * 4;
+        const VkImage image = m_context.swapchainImages[m_context.currentImageIndex];
+
+        VkBufferCreateInfo bufferInfo{};
+        bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        bufferInfo.size = size;
+        bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+        bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+        VmaAllocationCreateInfo allocInfo{};
+        allocInfo.usage = VMA_MEMORY_USAGE_GPU_TO_CPU;
+
+        VkBuffer buffer = VK_NULL_HANDLE;
+        VmaAllocation allocation = VK_NULL_HANDLE;
+        if (vmaCreateBuffer(m_context.allocator, &bufferInfo, &allocInfo, &buffer, &allocation, nullptr) != VK_SUCCESS) {
+            log(LogLevel::ERROR, "Failed to create readback buffer");
+            return false;
+        }
+
+        VkCommandBuffer cmd = m_context.beginSingleTimeCommands();
+
+        // Composition left the image in transfer source layout, only its writes have to become visible to the copy.
+        VkImageMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = image;
+        barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        barrier.subresourceRange.levelCount = 1;
+        barrier.subresourceRange.layerCount = 1;
+        vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+        VkBufferImageCopy region{};
+        region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        region.imageSubresource.layerCount = 1;
+        region.imageExtent = {extent.width, extent.height, 1};
+        vkCmdCopyImageToBuffer(cmd, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, buffer, 1, &region);
+
+        m_context.endSingleTimeCommands(cmd);
+
+        bool success = false;
+        void* mapped = nullptr;
+        if (vmaMapMemory(m_context.allocator, allocation, &mapped) == VK_SUCCESS) {
+            vmaInvalidateAllocation(m_context.allocator, allocation, 0, VK_WHOLE_SIZE);
+            outPixels.resize(size);
+            memcpy(outPixels.data(), mapped, size);
+            vmaUnmapMemory(m_context.allocator, allocation);
+            outSize = {extent.width, extent.height};
+            success = true;
+        } else {
+            log(LogLevel::ERROR, "Failed to map readback buffer");
+        }
+
+        vmaDestroyBuffer(m_context.allocator, buffer, allocation);
+        return success;
+    }
+
+    bool Interface::saveFrame(const std::string& path) {
+        std::vector<uint8_t> pixels;
+        glm::uvec2 size;
+        if (!readbackFrame(pixels, size)) {
+            return false;
+        }
+
+        if (!writePng(path, pixels.data(), size.x, size.y)) {
+            log(LogLevel::ERROR, "Failed to write frame to %s", path.c_str());
+            return false;
+        }
+        return true;
+    }
 }
@@ -14,6 +14,7 @@
 #include "PhysicsDebug.hpp"
 #include "Resources.hpp"
 #include "Pipeline.hpp"
+#include "PipelineCacheManager.hpp"
 #include "MeshManager.hpp"
 #include "Renderer.hpp"
 #include <SDL3/SDL.h>
@@ -34,18 +35,21 @@ namespace vex {
     public:
         /// @brief Constructor for Interface class.
         /// @details Initializes the Vulkan loader, creates an Instance with required extensions (including Portability for macOS), picks a physical device, creates a logical device with VMA allocator, and initializes all subsystems (Resources, MeshManager, Pipelines, Renderer).
-        /// @param SDL_Window* window - Pointer to the SDL_Window to bind to.
+        /// Headless interface creates no surface and no swapchain, frames are rendered into offscreen images at render resolution and can be read back with `readbackFrame`.
+        /// It works with SDL's offscreen and dummy video drivers, with the latter Vulkan is loaded without SDL.
+        /// @param SDL_Window* window - Pointer to the SDL_Window to bind to. Not used for rendering when headless.
         /// @param glm::uvec2 initialResolution - Initial rendering resolution.
         /// @param GameInfo gInfo - Game metadata used for application info in Vulkan.
         /// @param VirtualFileSystem* vfs - Pointer to the virtual file system for asset loading.
-        Interface(SDL_Window* window, glm::uvec2 initialResolution, GameInfo gInfo, VirtualFileSystem* vfs);
+        /// @param bool headless - Render offscreen instead of presenting to the window.
+        Interface(SDL_Window* window, glm::uvec2 initialResolution, GameInfo gInfo, VirtualFileSystem* vfs, bool headless = false);
 
         /// @brief Simple destructor cleaning up resources.
         /// @details Waits for the device to idle, then destroys subsystems in reverse dependency order (Renderer -> Pipelines -> Resources -> Swapchain -> Device -> Instance).
         ~Interface();
 
         /// @brief Binds the backend to a window.
-        /// @details Creates a Vulkan surface using `SDL_Vulkan_CreateSurface` and initializes the swapchain.
+        /// @details Creates a Vulkan surface using `SDL_Vulkan_CreateSurface` and initializes the swapchain. Does nothing when headless.
         /// @param SDL_Window* window - Pointer to the SDL_Window.
         void bindWindow(SDL_Window* window);
 
@@ -83,7 +87,8 @@ namespace vex {
         enviroment getEnvironment() { return m_context.m_enviroment;}
 
         /// @brief Helper function to wait for GPU to finish.
-        /// @details Calls `vkDeviceWaitIdle`. Should be used before resizing or shutting down to prevent resource hazards.
+        /// @details Calls `VulkanContext::waitIdle`, so it shows up in `RenderStats::idleWaits`. Should be used before resizing or shutting down to prevent resource hazards.
+        /// Destroying meshes, textures or UI does not need it, their GPU objects go through `VulkanContext::deletionQueue`.
         void WaitForGPUToFinish();
 
         /// @brief Sets VSync (Vertical Synchronization).
@@ -91,6 +96,22 @@ namespace vex {
         /// @param bool enabled - True to enable VSync (FIFO), false to disable (IMMEDIATE/MAILBOX).
         void setVSync(bool enabled);
 
+        /// @brief Returns true if frames are rendered into offscreen images instead of a window.
+        /// @return bool
+        bool isHeadless() const { return m_context.headless; }
+
+        /// @brief Copies the last rendered frame into host memory.
+        /// @details Waits for the GPU to go idle, so it's meant for tests and benchmarks, not for every frame. Only available in headless mode.
+        /// @param std::vector<uint8_t>& outPixels - Receives tightly packed sRGB encoded RGBA8 rows, top row first.
+        /// @param glm::uvec2& outSize - Receives width and height of the frame.
+        /// @return bool - False if the interface isn't headless or the copy failed.
+        bool readbackFrame(std::vector<uint8_t>& outPixels, glm::uvec2& outSize);
+
+        /// @brief Reads back the last rendered frame and writes it to a PNG file.
+        /// @param const std::string& path - Output file path.
+        /// @return bool - False if readback or writing failed.
+        bool saveFrame(const std::string& path);
+
         #if DEBUG
         /// @brief Getter for Physics Debug Renderer.
         /// @return VulkanPhysicsDebug* - Pointer to the debug renderer instance.
@@ -100,11 +121,16 @@ namespace vex {
         VulkanContext m_context;
         SDL_Window* m_p_window;
         VirtualFileSystem* m_vfs;
+        bool m_sdlVulkanLoaded = false;
         std::unique_ptr<VulkanSwapchainManager> m_p_swapchainManager;
         std::unique_ptr<VulkanResources> m_p_resources;
+        std::unique_ptr<PipelineCacheManager> m_p_pipelineCache;
         std::unique_ptr<VulkanPipeline> m_p_pipeline;
         std::unique_ptr<VulkanPipeline> m_p_transPipeline;
         std::unique_ptr<VulkanPipeline> m_p_maskPipeline;
+        std::unique_ptr<VulkanPipeline> m_p_compactPipeline;
+        std::unique_ptr<VulkanPipeline> m_p_compactTransPipeline;
+        std::unique_ptr<VulkanPipeline> m_p_compactMaskPipeline;
         std::unique_ptr<VulkanPipeline> m_p_uiPipeline;
         std::unique_ptr<VulkanPipeline> m_p_fullscreenPipeline;
         std::unique_ptr<MeshManager> m_p_meshManager;
@@ -0,0 +1,343 @@
+#include "MeshArena.hpp"
+#include "components/Mesh.hpp"
+#include "components/errorUtils.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace vex {
+    MeshArena::MeshArena(VulkanContext& context, uint64_t vertexBytes, uint64_t indexBytes, uint64_t stagingBytes)
+        : m_r_context(context), m_vertexAllocator(vertexBytes), m_indexAllocator(indexBytes), m_stagingCapacity(stagingBytes) {
+
+        VkBufferCreateInfo bufferInfo{};
+        bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+        VmaAllocationCreateInfo allocInfo{};
+        allocInfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
+
+        bufferInfo.size = vertexBytes;
+        bufferInfo.usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+        if (vmaCreateBuffer(m_r_context.allocator, &bufferInfo, &allocInfo, &m_vertexBuffer, &m_vertexAlloc, nullptr) != VK_SUCCESS) {
+            throw_error("Failed to create mesh arena vertex buffer");
+        }
+
+        bufferInfo.size = indexBytes;
+        bufferInfo.usage = VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+        if (vmaCreateBuffer(m_r_context.allocator, &bufferInfo, &allocInfo, &m_indexBuffer, &m_indexAlloc, nullptr) != VK_SUCCESS) {
+            throw_error("Failed to create mesh arena index buffer");
+        }
+
+        // Compaction copies arena ranges into the ring and back out.
+        bufferInfo.size = stagingBytes;
+        bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+        allocInfo.usage = VMA_MEMORY_USAGE_CPU_ONLY;
+        if (vmaCreateBuffer(m_r_context.allocator, &bufferInfo, &allocInfo, &m_stagingBuffer, &m_stagingAlloc, nullptr) != VK_SUCCESS) {
+            throw_error("Failed to create mesh arena staging buffer");
+        }
+
+        void* mapped = nullptr;
+        vmaMapMemory(m_r_context.allocator, m_stagingAlloc, &mapped);
+        m_stagingMapped = static_cast<uint8_t*>(mapped);
+
+        VkCommandPoolCreateInfo poolInfo{};
+        poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+        poolInfo.queueFamilyIndex = m_r_context.graphicsQueueFamily;
+        if (vkCreateCommandPool(m_r_context.device, &poolInfo, nullptr, &m_commandPool) != VK_SUCCESS) {
+            throw_error("Failed to create mesh arena command pool");
+        }
+
+        log("MeshArena created (vertex: %llu MB, index: %llu MB, staging: %llu MB)",
+            static_cast<unsigned long long>(vertexBytes >> 20),
+            static_cast<unsigned long long>(indexBytes >> 20),
+            static_cast<unsigned long long>(stagingBytes >> 20));
+    }
+
+    MeshArena::~MeshArena() {
+        flush();
+        for (auto& submission : m_submissions) {
+            vkWaitForFences(m_r_context.device, 1, &submission.fence, VK_TRUE, UINT64_MAX);
+            vkDestroyFence(m_r_context.device, submission.fence, nullptr);
+        }
+        m_submissions.clear();
+
+        if (m_commandPool != VK_NULL_HANDLE) {
+            vkDestroyCommandPool(m_r_context.device, m_commandPool, nullptr);
+        }
+        if (m_stagingMapped) {
+            vmaUnmapMemory(m_r_context.allocator, m_stagingAlloc);
+        }
+        if (m_stagingBuffer != VK_NULL_HANDLE) {
+            vmaDestroyBuffer(m_r_context.allocator, m_stagingBuffer, m_stagingAlloc);
+        }
+        if (m_indexBuffer != VK_NULL_HANDLE) {
+            vmaDestroyBuffer(m_r_context.allocator, m_indexBuffer, m_indexAlloc);
+        }
+        if (m_vertexBuffer != VK_NULL_HANDLE) {
+            vmaDestroyBuffer(m_r_context.allocator, m_vertexBuffer, m_vertexAlloc);
+        }
+        log("MeshArena destroyed");
+    }
+
+    bool MeshArena::allocate(size_t vertexCount, uint32_t vertexStride, size_t indexCount, uint32_t indexSize, Allocation& out) {
+        out = Allocation{};
+        if (vertexCount == 0 || indexCount == 0) return false;
+
+        // vertexOffset and firstIndex are element indices, so allocations must start on element boundaries.
+        uint64_t vertexOffset = m_vertexAllocator.allocate(vertexCount * vertexStride, vertexStride);
+        if (vertexOffset == RangeAllocator::INVALID_OFFSET) return false;
+
+        uint64_t indexOffset = m_indexAllocator.allocate(indexCount * indexSize, indexSize);
+        if (indexOffset == RangeAllocator::INVALID_OFFSET) {
+            m_vertexAllocator.free(vertexOffset);
+            return false;
+        }
+
+        out.vertexByteOffset = vertexOffset;
+        out.indexByteOffset = indexOffset;
+        out.vertexOffset = static_cast<int32_t>(vertexOffset / vertexStride);
+        out.firstIndex = static_cast<uint32_t>(indexOffset / indexSize);
+        out.vertexStride = vertexStride;
+        out.indexSize = indexSize;
+        return true;
+    }
+
+    void MeshArena::free(Allocation& allocation) {
+        if (!allocation.valid()) return;
+        m_vertexAllocator.free(allocation.vertexByteOffset);
+        m_indexAllocator.free(allocation.indexByteOffset);
+        allocation = Allocation{};
+        m_freedSinceCompact = true;
+    }
+
+    void MeshArena::pin(const Allocation& allocation) {
+        if (!allocation.valid()) return;
+        m_vertexAllocator.pin(allocation.vertexByteOffset);
+        m_indexAllocator.pin(allocation.indexByteOffset);
+    }
+
+    bool MeshArena::isFragmented() const {
+        if (!m_freedSinceCompact) return false;
+
+        auto fragmented = [](const RangeAllocator& allocator) {
+            const uint64_t freeBytes = allocator.getCapacity() - allocator.getUsedBytes();
+            return allocator.getFreeBlockCount() > 1 &&
+                   static_cast<double>(allocator.getLargestFreeBlock()) < static_cast<double>(freeBytes) * MESH_ARENA_COMPACT_FRAGMENTATION;
+        };
+        return fragmented(m_vertexAllocator) || fragmented(m_indexAllocator);
+    }
+
+    MeshArena::Relocation MeshArena::compact() {
+        Relocation relocation;
+        // Uploads queued so far target the old offsets.
+        flush();
+
+        auto queueMoves = [&](RangeAllocator& allocator, VkBuffer buffer, std::unordered_map<uint64_t, uint64_t>& offsets) {
+            uint64_t movedBytes = 0;
+            for (const auto& move : allocator.compact()) {
+                offsets.emplace(move.from, move.to);
+                movedBytes += move.size;
+
+                // Both halves of a chunk always land in the same submit, acquireStaging flushes before it returns a new region.
+                for (uint64_t done = 0; done < move.size;) {
+                    const uint64_t chunk = std::min(move.size - done, m_stagingCapacity);
+                    const uint64_t stagingOffset = acquireStaging(chunk);
+                    m_pendingReads.push_back({ buffer, VkBufferCopy{ move.from + done, stagingOffset, chunk } });
+                    m_pendingCopies.push_back({ buffer, VkBufferCopy{ stagingOffset, move.to + done, chunk } });
+                    done += chunk;
+                }
+            }
+            return movedBytes;
+        };
+
+        const uint64_t vertexBytes = queueMoves(m_vertexAllocator, m_vertexBuffer, relocation.vertexOffsets);
+        const uint64_t indexBytes = queueMoves(m_indexAllocator, m_indexBuffer, relocation.indexOffsets);
+        flush();
+        m_freedSinceCompact = false;
+
+        log("MeshArena compacted, moved %zu vertex ranges (%llu KB) and %zu index ranges (%llu KB)",
+            relocation.vertexOffsets.size(), static_cast<unsigned long long>(vertexBytes >> 10),
+            relocation.indexOffsets.size(), static_cast<unsigned long long>(indexBytes >> 10));
+        return relocation;
+    }
+
+    bool MeshArena::Relocation::apply(Allocation& allocation) const {
+        if (!allocation.valid()) return false;
+
+        bool moved = false;
+        if (auto it = vertexOffsets.find(allocation.vertexByteOffset); it != vertexOffsets.end()) {
+            allocation.vertexByteOffset = it->second;
+            allocation.vertexOffset = static_cast<int32_t>(it->second / allocation.vertexStride);
+            moved = true;
+        }
+        if (auto it = indexOffsets.find(allocation.indexByteOffset); it != indexOffsets.end()) {
+            allocation.indexByteOffset = it->second;
+            allocation.firstIndex = static_cast<uint32_t>(it->second / allocation.indexSize);
+            moved = true;
+        }
+        return moved;
+    }
+
+    void MeshArena::upload(const Allocation& allocation, const void* vertices, size_t vertexBytes, const void* indices, size_t indexBytes) {
+        if (!allocation.valid()) [[unlikely]] {
+            throw_error("MeshArena: upload to invalid allocation");
+        }
+        stage(m_vertexBuffer, allocation.vertexByteOffset, vertices, vertexBytes);
+        stage(m_indexBuffer, allocation.indexByteOffset, indices, indexBytes);
+    }
+
+    void MeshArena::stage(VkBuffer dst, uint64_t dstOffset, const void* src, size_t size) {
+        const uint8_t* srcBytes = static_cast<const uint8_t*>(src);
+
+        while (size > 0) {
+            uint64_t chunk = std::min<uint64_t>(size, m_stagingCapacity);
+            uint64_t stagingOffset = acquireStaging(chunk);
+
+            std::memcpy(m_stagingMapped + stagingOffset, srcBytes, chunk);
+            vmaFlushAllocation(m_r_context.allocator, m_stagingAlloc, stagingOffset, chunk);
+
+            m_pendingCopies.push_back({ dst, VkBufferCopy{ stagingOffset, dstOffset, chunk } });
+
+            srcBytes += chunk;
+            dstOffset += chunk;
+            size -= chunk;
+        }
+    }
+
+    uint64_t MeshArena::acquireStaging(uint64_t size) {
+        const uint64_t alignedSize = (size + 15) & ~uint64_t(15);
+
+        while (true) {
+            if (m_ringLiveBytes == 0) {
+                m_ringHead = 0;
+                m_ringTail = 0;
+            }
+
+            uint64_t offset = RangeAllocator::INVALID_OFFSET;
+            uint64_t consumed = 0;
+
+            if (m_ringLiveBytes == 0 || m_ringHead > m_ringTail) {
+                // Live region is [tail, head), free space is [head, end) and [0, tail).
+                if (m_ringHead + alignedSize <= m_stagingCapacity) {
+                    offset = m_ringHead;
+                    consumed = alignedSize;
+                } else if (alignedSize <= m_ringTail) {
+                    offset = 0;
+                    consumed = (m_stagingCapacity - m_ringHead) + alignedSize;
+                }
+            } else if (m_ringHead < m_ringTail && m_ringHead + alignedSize <= m_ringTail) {
+                offset = m_ringHead;
+                consumed = alignedSize;
+            }
+
+            if (offset != RangeAllocator::INVALID_OFFSET) {
+                m_ringHead = (offset + alignedSize) % m_stagingCapacity;
+                m_ringLiveBytes += consumed;
+                m_ringPendingBytes += consumed;
+                return offset;
+            }
+
+            // Ring is full, push out what we have and wait for the oldest submit to free its region.
+            flush();
+            if (m_submissions.empty()) [[unlikely]] {
+                throw_error("MeshArena: staging ring too small for upload");
+            }
+            retireSubmissions(true);
+        }
+    }
+
+    void MeshArena::retireSubmissions(bool waitOldest) {
+        if (waitOldest && !m_submissions.empty()) {
+            vkWaitForFences(m_r_context.device, 1, &m_submissions.front().fence, VK_TRUE, UINT64_MAX);
+        }
+
+        while (!m_submissions.empty()) {
+            Submission& submission = m_submissions.front();
+            if (vkGetFenceStatus(m_r_context.device, submission.fence) != VK_SUCCESS) break;
+
+            m_ringTail = submission.ringEnd;
+            m_ringLiveBytes -= submission.ringBytes;
+
+            vkDestroyFence(m_r_context.device, submission.fence, nullptr);
+            vkFreeCommandBuffers(m_r_context.device, m_commandPool, 1, &submission.cmd);
+            m_submissions.pop_front();
+        }
+    }
+
+    void MeshArena::flush() {
+        retireSubmissions(false);
+        if (m_pendingCopies.empty()) return;
+
+        VkCommandBufferAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandPool = m_commandPool;
+        allocInfo.commandBufferCount = 1;
+
+        VkCommandBuffer cmd;
+        vkAllocateCommandBuffers(m_r_context.device, &allocInfo, &cmd);
+
+        VkCommandBufferBeginInfo beginInfo{};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        vkBeginCommandBuffer(cmd, &beginInfo);
+
+        // Compaction frees ranges that frames in flight may still draw from and reads ranges earlier uploads wrote,
+        // so nothing here touches the arena before earlier submits are done with it.
+        VkMemoryBarrier before{};
+        before.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        before.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        before.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+        vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                             0, 1, &before, 0, nullptr, 0, nullptr);
+
+        if (!m_pendingReads.empty()) {
+            for (const auto& read : m_pendingReads) {
+                vkCmdCopyBuffer(cmd, read.arenaBuffer, m_stagingBuffer, 1, &read.region);
+            }
+
+            // All moved ranges are in staging before any is written back, so a range can move over its own old bytes.
+            VkMemoryBarrier between{};
+            between.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+            between.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            between.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+            vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                 0, 1, &between, 0, nullptr, 0, nullptr);
+        }
+
+        for (const auto& copy : m_pendingCopies) {
+            vkCmdCopyBuffer(cmd, m_stagingBuffer, copy.arenaBuffer, 1, &copy.region);
+        }
+
+        VkMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT;
+        vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+                             0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+        vkEndCommandBuffer(cmd);
+
+        VkFenceCreateInfo fenceInfo{};
+        fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+        VkFence fence;
+        vkCreateFence(m_r_context.device, &fenceInfo, nullptr, &fence);
+
+        VkSubmitInfo submitInfo{};
+        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submitInfo.commandBufferCount = 1;
+        submitInfo.pCommandBuffers = &cmd;
+
+        if (vkQueueSubmit(m_r_context.graphicsQueue, 1, &submitInfo, fence) != VK_SUCCESS) [[unlikely]] {
+            vkDestroyFence(m_r_context.device, fence, nullptr);
+            vkFreeCommandBuffers(m_r_context.device, m_commandPool, 1, &cmd);
+            throw_error("MeshArena: failed to submit upload");
+        }
+
+        m_submissions.push_back({ fence, cmd, m_ringHead, m_ringPendingBytes });
+        m_ringPendingBytes = 0;
+        m_pendingReads.clear();
+        m_pendingCopies.clear();
+    }
+}
@@ -0,0 +1,171 @@
+/**
+ *  @file   MeshArena.hpp
+ *  @brief  This file defines MeshArena class holding geometry of all meshes in shared device local buffers.
+ *  @author Eryk Roszkowski
+ ***********************************************/
+
+#pragma once
+#include "context.hpp"
+#include "limits.hpp"
+#include "RangeAllocator.hpp"
+
+#include <cstdint>
+#include <deque>
+#include <unordered_map>
+#include <vector>
+
+namespace vex {
+    /// @brief Shared device local vertex and index buffers for all meshes.
+    /// @details Geometry is sub-allocated from two big `GPU_ONLY` buffers and addressed with `vertexOffset` / `firstIndex`,
+    /// so submeshes don't need buffers of their own and can be drawn without rebinding.
+    /// Data is copied through a persistently mapped staging ring, regions of the ring are reused once the fence of the submit that read them is signaled.
+    /// Once frees fragment the arenas `compact` moves live ranges together through the same ring, owners update their offsets from the returned `Relocation`.
+    class MeshArena {
+    public:
+        /// @brief Location of a single submesh inside the arena.
+        struct Allocation {
+            uint64_t vertexByteOffset = RangeAllocator::INVALID_OFFSET;
+            uint64_t indexByteOffset = RangeAllocator::INVALID_OFFSET;
+            int32_t vertexOffset = 0;
+            uint32_t firstIndex = 0;
+            uint32_t vertexStride = 0;
+            uint32_t indexSize = 0;
+
+            bool valid() const { return vertexByteOffset != RangeAllocator::INVALID_OFFSET && indexByteOffset != RangeAllocator::INVALID_OFFSET; }
+        };
+
+        /// @brief New byte offsets of ranges moved by `compact`.
+        struct Relocation {
+            std::unordered_map<uint64_t, uint64_t> vertexOffsets; // old byte offset -> new byte offset
+            std::unordered_map<uint64_t, uint64_t> indexOffsets;  // old byte offset -> new byte offset
+
+            /// @brief Returns true if nothing moved.
+            /// @return bool
+            bool empty() const { return vertexOffsets.empty() && indexOffsets.empty(); }
+
+            /// @brief Moves allocation to its new offsets.
+            /// @param Allocation& allocation - Allocation made before `compact`, unchanged if it didn't move.
+            /// @return bool - True if allocation moved.
+            bool apply(Allocation& allocation) const;
+        };
+
+        /// @brief Constructor for MeshArena, creates arena buffers, staging ring and command pool.
+        /// @param VulkanContext& context - Reference to the VulkanContext object.
+        /// @param uint64_t vertexBytes - Size of vertex arena.
+        /// @param uint64_t indexBytes - Size of index arena.
+        /// @param uint64_t stagingBytes - Size of staging ring.
+        MeshArena(VulkanContext& context, uint64_t vertexBytes = MESH_ARENA_VERTEX_BYTES, uint64_t indexBytes = MESH_ARENA_INDEX_BYTES, uint64_t stagingBytes = MESH_ARENA_STAGING_BYTES);
+        ~MeshArena();
+
+        MeshArena(const MeshArena&) = delete;
+        MeshArena& operator=(const MeshArena&) = delete;
+
+        /// @brief Reserves space for a submesh.
+        /// @details Different vertex formats and index types share the arena, offsets are aligned to the element size so they stay addressable with `vertexOffset` / `firstIndex`.
+        /// @param size_t vertexCount - Number of vertices.
+        /// @param uint32_t vertexStride - Size of a single vertex in bytes.
+        /// @param size_t indexCount - Number of indices.
+        /// @param uint32_t indexSize - Size of a single index in bytes, 2 or 4.
+        /// @param Allocation& out - Filled on success.
+        /// @return bool - False if arena is out of space, caller should fall back to its own buffers.
+        bool allocate(size_t vertexCount, uint32_t vertexStride, size_t indexCount, uint32_t indexSize, Allocation& out);
+
+        /// @brief Releases space of a submesh, GPU must not use it anymore.
+        /// @param Allocation& allocation - Allocation returned by `allocate`, reset to invalid.
+        void free(Allocation& allocation);
+
+        /// @brief Queues copy of submesh data into its allocation.
+        /// @details Data goes to the staging ring right away, the copy is recorded and submitted in `flush`.
+        /// @param const Allocation& allocation - Target allocation.
+        /// @param const void* vertices - Vertex data.
+        /// @param size_t vertexBytes - Size of vertex data.
+        /// @param const void* indices - Index data.
+        /// @param size_t indexBytes - Size of index data.
+        void upload(const Allocation& allocation, const void* vertices, size_t vertexBytes, const void* indices, size_t indexBytes);
+
+        /// @brief Submits all queued copies to the graphics queue without waiting for them.
+        /// @details Queue submission order guarantees frames submitted later see the data.
+        void flush();
+
+        /// @brief Keeps allocation in place during `compact`.
+        /// @details For allocations whose offsets can't be updated anymore, like ones waiting in the deletion queue.
+        /// @param const Allocation& allocation - Allocation returned by `allocate`.
+        void pin(const Allocation& allocation);
+
+        /// @brief Returns true if a range was freed since last `compact` and free space is split so much that the biggest free block
+        /// is smaller than `MESH_ARENA_COMPACT_FRAGMENTATION` of free bytes in vertex or index arena.
+        /// @return bool
+        bool isFragmented() const;
+
+        /// @brief Moves all live ranges that aren't pinned toward the start of the arenas, so free space becomes one block.
+        /// @details Ranges are copied to the staging ring and back on the graphics queue, after frames submitted earlier stopped reading them.
+        /// Commands recorded after this must use offsets updated with the returned relocation.
+        /// @return Relocation - New offsets of moved ranges.
+        Relocation compact();
+
+        /// @brief Returns shared vertex buffer.
+        /// @return VkBuffer
+        VkBuffer getVertexBuffer() const { return m_vertexBuffer; }
+
+        /// @brief Returns shared index buffer.
+        /// @return VkBuffer
+        VkBuffer getIndexBuffer() const { return m_indexBuffer; }
+
+        /// @brief Returns vertex range allocator, for stats.
+        /// @return const RangeAllocator&
+        const RangeAllocator& getVertexAllocator() const { return m_vertexAllocator; }
+
+        /// @brief Returns index range allocator, for stats.
+        /// @return const RangeAllocator&
+        const RangeAllocator& getIndexAllocator() const { return m_indexAllocator; }
+
+    private:
+        /// @brief Single submit reading from the staging ring.
+        struct Submission {
+            VkFence fence;
+            VkCommandBuffer cmd;
+            uint64_t ringEnd;
+            uint64_t ringBytes;
+        };
+
+        /// @brief Single queued copy between staging ring and arena.
+        struct PendingCopy {
+            VkBuffer arenaBuffer;
+            VkBufferCopy region;
+        };
+
+        /// @brief Copies data to staging ring in chunks and queues copies to `dst`.
+        void stage(VkBuffer dst, uint64_t dstOffset, const void* src, size_t size);
+
+        /// @brief Reserves contiguous region of the staging ring, waits for older submits if it's full.
+        uint64_t acquireStaging(uint64_t size);
+
+        /// @brief Frees staging regions of finished submits.
+        /// @param bool waitOldest - Block until the oldest submit finishes.
+        void retireSubmissions(bool waitOldest);
+
+        VulkanContext& m_r_context;
+
+        VkBuffer m_vertexBuffer = VK_NULL_HANDLE;
+        VmaAllocation m_vertexAlloc = VK_NULL_HANDLE;
+        VkBuffer m_indexBuffer = VK_NULL_HANDLE;
+        VmaAllocation m_indexAlloc = VK_NULL_HANDLE;
+        RangeAllocator m_vertexAllocator;
+        RangeAllocator m_indexAllocator;
+
+        VkBuffer m_stagingBuffer = VK_NULL_HANDLE;
+        VmaAllocation m_stagingAlloc = VK_NULL_HANDLE;
+        uint8_t* m_stagingMapped = nullptr;
+        uint64_t m_stagingCapacity = 0;
+        uint64_t m_ringHead = 0;
+        uint64_t m_ringTail = 0;
+        uint64_t m_ringLiveBytes = 0;
+        uint64_t m_ringPendingBytes = 0;
+
+        VkCommandPool m_commandPool = VK_NULL_HANDLE;
+        std::vector<PendingCopy> m_pendingReads;    // arena -> staging, recorded before all m_pendingCopies
+        std::vector<PendingCopy> m_pendingCopies;   // staging -> arena
+        bool m_freedSinceCompact = false;
+        std::deque<Submission> m_submissions;
+    };
+}
@@ -2,6 +2,7 @@
 #include "components/GameComponents/BasicComponents.hpp"
 #include "components/PhysicsSystem.hpp"
 #include "components/Mesh.hpp"
+#include "components/MeshSimplifier.hpp"
 #include "components/errorUtils.hpp"
 #include "entt/entity/entity.hpp"
 #include "entt/entity/fwd.hpp"
@@ -13,175 +14,406 @@
 
 #include <filesystem>
 #include <algorithm>
+#include <chrono>
+#include <thread>
 
 namespace vex {
     MeshManager::MeshManager(VulkanContext& context, std::unique_ptr<VulkanResources>& resources, VirtualFileSystem* vfs)
         : m_r_context(context), m_p_resources(resources), m_vfs(vfs) {
+        m_p_meshArena = std::make_unique<MeshArena>(m_r_context);
+        m_p_meshLoader = std::make_unique<AsyncMeshLoader>([this](const std::string& path, const MeshLodSettings& settings, MeshData& meshData, MeshBounds& bounds) {
+            return importMesh(path, settings, meshData, bounds);
+        });
         log("MeshManager initialized");
     }
 
     MeshManager::~MeshManager() {
+        // Import threads call back into this manager, they have to be gone first.
+        m_p_meshLoader.reset();
+        m_pendingMeshes.clear();
+        m_meshAssets.clear();
+        m_meshHandles.clear();
         m_vulkanMeshes.clear();
+        m_p_meshArena.reset();
         log("MeshManager destroyed");
     }
 
     ModelObject* MeshManager::createModel(const std::string& name, MeshComponent meshComponent, TransformComponent transformComponent, entt::entity parent = entt::null){
         log("Constructing model: %s...", name.c_str());
 
-        std::string tempName = name;
+        ModelObject* modelObject = new ModelObject(*m_p_engine, name, std::move(meshComponent), transformComponent);
+        return modelObject;
+    }
 
-        uint32_t newId;
-        if (!m_freeModelIds.empty()) {
-            newId = m_freeModelIds.back();
-            m_freeModelIds.pop_back();
-        } else {
-            newId = m_nextModelId++;
-            if (newId >= MAX_MODELS) {
-                throw_error("Maximum model count exceeded");
+    MeshComponent MeshManager::loadMesh(const std::string& path, VertexFormat format) {
+        MeshComponent meshComponent;
+        meshComponent.meshData.meshPath = path;
+        meshComponent.meshData.vertexFormat = format;
+
+        // Uploaded and loading meshes only need bounds.
+        if (!m_meshHandles.contains(path) && !m_pendingMeshes.contains(path)) {
+            holdMeshData(path);
+        }
+
+        auto asset = m_meshAssets.find(path);
+        if (asset != m_meshAssets.end()) {
+            meshComponent.localCenter = asset->second.bounds.center;
+            meshComponent.localRadius = asset->second.bounds.radius;
+        }
+        return meshComponent;
+    }
+
+    std::shared_ptr<const MeshData> MeshManager::getMeshData(const std::string& path) {
+        auto asset = m_meshAssets.find(path);
+        if (asset != m_meshAssets.end()) {
+            if (auto meshData = asset->second.data.lock()) {
+                return meshData;
             }
         }
-        meshComponent.id = newId;
-        meshComponent.textureNames.clear();
 
-                for (const auto& submesh : meshComponent.meshData.submeshes) {
-                    if (!submesh.texturePath.empty()) {
-                        meshComponent.textureNames.push_back(submesh.texturePath);
-                    }
+        std::shared_ptr<const MeshData> meshData = importMeshData(path);
+        releaseMeshData(path);
+        return meshData;
+    }
+
+    void MeshManager::setRetainMeshData(bool retain) {
+        m_retainMeshData = retain;
+        if (retain) return;
+
+        for (auto&& [path, asset] : m_meshAssets) {
+            releaseUploadedMeshData(path);
+        }
+    }
+
+    std::vector<MeshMemoryInfo> MeshManager::getMeshMemoryInfo() const {
+        std::vector<MeshMemoryInfo> infos;
+        infos.reserve(m_meshAssets.size());
+
+        for (const auto& [path, asset] : m_meshAssets) {
+            MeshMemoryInfo info;
+            info.path = path;
+            if (auto meshData = asset.data.lock()) {
+                info.cpuBytes = meshData->getMemoryBytes();
+            }
+
+            auto handle = m_meshHandles.find(path);
+            if (handle != m_meshHandles.end()) {
+                if (const VulkanMesh* vulkanMesh = getVulkanMesh(handle->second)) {
+                    info.sortingBytes = vulkanMesh->getTriangleCenterBytes();
+                    info.gpuBytes = vulkanMesh->getGeometryBytes();
+                    info.instances = vulkanMesh->getNumOfInstances();
                 }
-        try {
-            log("Creating Vulkan mesh for %s", tempName.c_str());
-            if(m_vulkanMeshes.find(meshComponent.meshData.meshPath) == m_vulkanMeshes.end()){
-                m_vulkanMeshes.emplace(meshComponent.meshData.meshPath, std::make_unique<VulkanMesh>(m_r_context));
-                m_vulkanMeshes.at(meshComponent.meshData.meshPath)->upload(meshComponent.meshData);
-                m_vulkanMeshes.at(meshComponent.meshData.meshPath)->addInstance();
-            }else{
-                m_vulkanMeshes.at(meshComponent.meshData.meshPath)->addInstance();
-                log("Reusing same mesh model");
             }
-            //m_vulkanMeshes.push_back(std::make_unique<VulkanMesh>(m_r_context));
-            //log("vulkanMesh id: %i", m_vulkanMeshes.size());
-            log("Mesh upload successful");
+            infos.push_back(std::move(info));
+        }
+        return infos;
+    }
+
+    uint64_t MeshManager::getMeshCpuBytes() const {
+        uint64_t bytes = 0;
+        for (const auto& info : getMeshMemoryInfo()) {
+            bytes += info.cpuBytes + info.sortingBytes;
+        }
+        return bytes;
+    }
+
+    std::shared_ptr<const MeshData> MeshManager::importMeshData(const std::string& path) {
+        if (path.empty() || path == GetAssetDir()) {
+            return nullptr;
+        }
+
+        MeshData meshData;
+        MeshBounds bounds;
+        try {
+            importMesh(path, m_lodSettings, meshData, bounds);
         } catch (const std::exception& e) {
-            log(LogLevel::ERROR, "Mesh upload failed");
-            m_vulkanMeshes.erase(meshComponent.meshData.meshPath);
+            log(LogLevel::ERROR, "Mesh load failed: %s", path.c_str());
             handle_exception(e);
+            return nullptr;
         }
+        return cacheMeshData(path, std::move(meshData), bounds);
+    }
 
-        //entt::entity modelEntity = m_p_engine->getRegistry().create();
-        ModelObject* modelObject = new ModelObject(*m_p_engine, tempName, meshComponent, transformComponent);
-        //modelObject->cleanup = [this](std::string& tempName, const MeshComponent& meshComponent) { destroyModel(tempName, meshComponent); };
-        return modelObject;
+    std::shared_ptr<const MeshData> MeshManager::cacheMeshData(const std::string& path, MeshData&& meshData, const MeshBounds& bounds) {
+        meshData.meshPath = path;
+        auto shared = std::make_shared<const MeshData>(std::move(meshData));
+
+        MeshAsset& asset = m_meshAssets[path];
+        asset.data = shared;
+        asset.retained = shared;
+        asset.bounds = bounds;
+        return shared;
     }
 
-    MeshComponent MeshManager::loadMesh(const std::string& path) {
-        MeshData meshData;
-        MeshComponent meshComponent;
+    std::shared_ptr<const MeshData> MeshManager::holdMeshData(const std::string& path) {
+        auto asset = m_meshAssets.find(path);
+        if (asset != m_meshAssets.end()) {
+            if (auto meshData = asset->second.data.lock()) {
+                asset->second.retained = meshData;
+                return meshData;
+            }
+        }
+        return importMeshData(path);
+    }
+
+    void MeshManager::releaseMeshData(const std::string& path) {
+        auto asset = m_meshAssets.find(path);
+        if (asset != m_meshAssets.end() && !asset->second.keep && !m_retainMeshData) {
+            asset->second.retained.reset();
+        }
+    }
+
+    void MeshManager::releaseUploadedMeshData(const std::string& path) {
+        // Meshes not uploaded yet still need the data, their upload releases it.
+        if (m_meshHandles.contains(path) && !m_pendingMeshes.contains(path)) {
+            releaseMeshData(path);
+        }
+    }
+
+    bool MeshManager::importMesh(const std::string& path, const MeshLodSettings& settings, MeshData& meshData, MeshBounds& bounds) {
         std::string realPath = GetAssetPath(path);
+        log("Loading mesh data from: %s", realPath.c_str());
 
-        try {
-            log("Loading mesh data from: %s", realPath.c_str());
+        if (!m_vfs->file_exists(realPath)) {
+            throw_error("File not found: " + realPath);
+        }
 
-            if (!m_vfs->file_exists(realPath)) {
-                throw_error("File not found: " + realPath);
+        if (!loadCookedMesh(realPath, settings, meshData, bounds)) {
+            meshData.loadFromFile(realPath, m_vfs);
+
+            generateLods(meshData, settings);
+            for (size_t i = 0; i < meshData.submeshes.size(); i++) {
+                const auto& submesh = meshData.submeshes[i];
+                for (size_t level = 0; level < submesh.lods.size(); level++) {
+                    log("Submesh %zu LOD %zu: %zu -> %zu triangles, error %f",
+                        i, level + 1, submesh.indices.size() / 3, submesh.lods[level].indices.size() / 3, submesh.lods[level].error);
+                }
             }
 
-            meshData.loadFromFile(realPath, m_vfs);
-            meshData.meshPath = path;
-        } catch (const std::exception& e) {
-            log(LogLevel::ERROR, "Mesh load failed: %s", path.c_str());
-            handle_exception(e);
+            bounds = computeMeshBounds(meshData);
         }
+        return !meshData.submeshes.empty();
+    }
+
+    MeshComponent MeshManager::loadMeshAsync(const std::string& path, VertexFormat format) {
+        MeshComponent meshComponent;
+        meshComponent.meshData.meshPath = path;
+        meshComponent.meshData.vertexFormat = format;
+
+        if (m_meshHandles.contains(path)) {
+            registerVulkanMesh(meshComponent);
+            return meshComponent;
+        }
+
+        if (!m_pendingMeshes.contains(path)) {
+            log("Loading mesh asynchronously: %s", path.c_str());
+            m_pendingMeshes[path] = PendingMesh{ {}, format };
+            m_p_meshLoader->request(path, m_lodSettings);
+        }
+        return meshComponent;
+    }
+
+    void MeshManager::updateMeshLoads() {
+        if (m_pendingMeshes.empty()) [[likely]] return;
+
+        m_loadedMeshes.clear();
+        m_p_meshLoader->collect(m_loadedMeshes, MESH_UPLOADS_PER_FRAME);
+
+        for (auto& loaded : m_loadedMeshes) {
+            auto pending = m_pendingMeshes.find(loaded.path);
+            if (pending == m_pendingMeshes.end()) continue;
+
+            const PendingMesh request = std::move(pending->second);
+            m_pendingMeshes.erase(pending);
+            const int instances = static_cast<int>(request.entities.size());
+
+            if (!loaded.success) {
+                // Uploaded empty like a failed synchronous load, so components waiting for it don't request it again every frame.
+                log(LogLevel::ERROR, "Mesh load failed: %s", loaded.path.c_str());
+                loaded.meshData.clear();
+                loaded.bounds = MeshBounds{};
+            } else {
+                log("Imported mesh %s on worker thread in %.2f ms", loaded.path.c_str(), loaded.importMs);
+            }
+
+            // Loaded synchronously while the import was running, waiting components only become its instances.
+            std::shared_ptr<const MeshData> meshData;
+            MeshHandle handle;
+            if (VulkanMesh* existingMesh = findVulkanMesh(loaded.path)) {
+                for (int i = 0; i < instances; i++) {
+                    existingMesh->addInstance();
+                }
+                handle = m_meshHandles.at(loaded.path);
+            } else {
+                meshData = cacheMeshData(loaded.path, std::move(loaded.meshData), loaded.bounds);
+                handle = createVulkanMesh(loaded.path, *meshData, instances, request.format);
+            }
+            VulkanMesh* vulkanMesh = getVulkanMesh(handle);
+
+            // Waiting components get bounds now, not on their first draw, culling would never draw them with the zero radius they have until then.
+            auto& registry = m_p_engine->getRegistry();
+            for (auto entity : request.entities) {
+                auto& meshComponent = registry.get<MeshComponent>(entity);
 
-        meshComponent.meshData = std::move(meshData);
+                meshComponent.meshHandle = handle;
+                meshComponent.localCenter = loaded.bounds.center;
+                meshComponent.localRadius = loaded.bounds.radius;
+                meshComponent.forceRefresh();
 
-        glm::vec3 min = glm::vec3(FLT_MAX);
-        glm::vec3 max = glm::vec3(-FLT_MAX);
+                if (meshData && vulkanMesh && meshComponent.renderType == RenderType::TRANSPARENT && !vulkanMesh->hasTriangleCenters()) {
+                    vulkanMesh->buildTriangleCenters(*meshData);
+                }
+            }
 
-        for(auto& submesh : meshComponent.meshData.submeshes) {
-            for(auto& vertex : submesh.vertices) {
-                min = glm::min(min, vertex.position);
-                max = glm::max(max, vertex.position);
+            if (meshData) {
+                releaseMeshData(loaded.path);
             }
         }
+    }
 
-        glm::vec3 center = (min + max) * 0.5f;
-        float radius = glm::length(max - center);
+    MeshArena::Relocation MeshManager::compactMeshArena() {
+        if (!m_p_meshArena || !m_p_meshArena->isFragmented()) [[likely]] return {};
 
-        meshComponent.localCenter = center;
-        meshComponent.localRadius = radius;
+        MeshArena::Relocation relocation = m_p_meshArena->compact();
+        if (relocation.empty()) return relocation;
 
-        return meshComponent;
+        for (const auto& [path, handle] : m_meshHandles) {
+            if (VulkanMesh* vulkanMesh = getVulkanMesh(handle)) {
+                vulkanMesh->relocate(relocation);
+            }
+        }
+        return relocation;
+    }
+
+    void MeshManager::finishMeshLoads() {
+        while (!m_pendingMeshes.empty()) {
+            updateMeshLoads();
+            if (!m_pendingMeshes.empty()) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
     }
 
-    std::unique_ptr<VulkanMesh>& MeshManager::getVulkanMeshByMesh(MeshComponent& meshComponent) {
+    bool MeshManager::loadCookedMesh(const std::string& realPath, const MeshLodSettings& settings, MeshData& meshData, MeshBounds& bounds) {
+        const std::string cookedPath = cookedMeshPath(realPath);
+        if (!m_vfs->file_exists(cookedPath)) {
+            return false;
+        }
+
+        auto cookedFile = m_vfs->load_file(cookedPath);
+        uint64_t cookedHash = 0;
+        if (!cookedFile || !readCookedMesh(cookedFile->data.data(), cookedFile->size, realPath, meshData, bounds, cookedHash)) {
+            log(LogLevel::WARNING, "Cooked mesh %s is invalid, importing source instead", cookedPath.c_str());
+            return false;
+        }
+
+        #ifndef DIST_BUILD
+        auto sourceFile = m_vfs->load_file(realPath);
+        if (sourceFile && hashMeshSource(sourceFile->data.data(), sourceFile->size, settings) != cookedHash) {
+            log(LogLevel::WARNING, "Cooked mesh %s is out of date, importing source instead", cookedPath.c_str());
+            meshData.clear();
+            return false;
+        }
+        #endif
+
+        log("Loaded cooked mesh: %s", cookedPath.c_str());
+        return true;
+    }
+
+    VulkanMesh* MeshManager::bindMesh(entt::entity entity, MeshComponent& meshComponent) {
+        if (meshComponent.id >= m_installedPaths.size()) [[unlikely]] {
+            // Component that was never added to the registry, it has no installed mesh to swap.
+            if (meshComponent.id == UINT32_MAX) return findVulkanMesh(meshComponent.meshData.meshPath);
+            m_installedPaths.resize(meshComponent.id + 1);
+        }
         std::string& installedPath = m_installedPaths[meshComponent.id];
-        std::string requestedPath = meshComponent.meshData.meshPath;
+        const std::string& requestedPath = meshComponent.meshData.meshPath;
 
+        // Size is compared first, an unchanged path costs no hashing and usually no character compare.
         if (installedPath != requestedPath) [[unlikely]] {
             log("Swapping mesh %s -> %s", installedPath.c_str(), requestedPath.c_str());
 
-            releaseMeshReference(installedPath, meshComponent);
+            releaseMeshReference(installedPath, entity);
 
             installedPath = requestedPath;
+            meshComponent.meshHandle = {};
 
-            bool alreadyExisted = m_vulkanMeshes.count(requestedPath) > 0;
-
-            registerVulkanMesh(meshComponent);
+            acquireMesh(entity, meshComponent, m_asyncLoading);
+        }
 
-            if (alreadyExisted && m_vulkanMeshes.count(requestedPath)) {
-                m_vulkanMeshes.at(requestedPath)->addInstance();
+        VulkanMesh* vulkanMesh = getVulkanMesh(meshComponent.meshHandle);
+        if (!vulkanMesh) [[unlikely]] {
+            // Not bound yet, or its mesh was destroyed. Path lookup happens only here.
+            if (requestedPath.empty() || m_pendingMeshes.contains(requestedPath)) {
+                return nullptr;
             }
-        } else [[likely]] {
             registerVulkanMesh(meshComponent);
+
+            vulkanMesh = getVulkanMesh(meshComponent.meshHandle);
+            if (!vulkanMesh) return nullptr;
         }
 
-        if (m_vulkanMeshes.count(requestedPath)) {
-            return m_vulkanMeshes.at(requestedPath);
+        // Component turned transparent after its mesh was uploaded, released data has to be imported again.
+        if (meshComponent.renderType == RenderType::TRANSPARENT && !vulkanMesh->hasTriangleCenters()) [[unlikely]] {
+            if (std::shared_ptr<const MeshData> meshData = getMeshData(requestedPath)) {
+                vulkanMesh->buildTriangleCenters(*meshData);
+            } else {
+                vulkanMesh->buildTriangleCenters(MeshData{});
+            }
         }
 
-        static std::unique_ptr<VulkanMesh> nullMesh = nullptr;
-        return nullMesh;
+        vulkanMesh->refreshTextureHandles(*m_p_resources);
+        return vulkanMesh;
+    }
+
+    VulkanMesh* MeshManager::findVulkanMesh(const std::string& path) {
+        auto it = m_meshHandles.find(path);
+        return it != m_meshHandles.end() ? getVulkanMesh(it->second) : nullptr;
+    }
+
+    void MeshManager::eraseVulkanMesh(const std::string& path) {
+        auto it = m_meshHandles.find(path);
+        if (it == m_meshHandles.end()) return;
+
+        m_vulkanMeshes.erase(it->second);
+        m_meshHandles.erase(it);
     }
 
     void MeshManager::registerVulkanMesh(MeshComponent& meshComponent) {
         const std::string& path = meshComponent.meshData.meshPath;
-        if (m_vulkanMeshes.count(path)) {
-            if (m_meshBoundsCache.count(path)) {
-                auto& bounds = m_meshBoundsCache[path];
-                meshComponent.localCenter = bounds.first;
-                meshComponent.localRadius = bounds.second;
-                meshComponent.forceRefresh();
-            }
-            return;
-        }
-        if (!(meshComponent.meshData.meshPath == "" || meshComponent.meshData.meshPath.empty() || path == GetAssetDir())) [[unlikely]] {
-            #if DEBUG
-            if (meshComponent.meshData.meshPath.empty() || path == GetAssetDir() || !m_vfs->file_exists(GetAssetPath(path))) {
-                log(LogLevel::WARNING, "Skipping registration for invalid path: %s", path.c_str());
+        auto existing = m_meshHandles.find(path);
+        if (existing != m_meshHandles.end()) {
+            meshComponent.meshHandle = existing->second;
+        } else {
+            if (path.empty() || path == GetAssetDir()) [[unlikely]] {
                 return;
             }
-            #endif
-            MeshComponent loadedAsset = loadMesh(path);
 
-            meshComponent.meshData = std::move(loadedAsset.meshData);
-            meshComponent.localCenter = loadedAsset.localCenter;
-            meshComponent.localRadius = loadedAsset.localRadius;
-            meshComponent.forceRefresh();
+            // Data cached by loadMesh or built by hand is uploaded as is, anything else is imported now. Failed loads are uploaded empty, so they aren't retried every frame.
+            const MeshData emptyMesh;
+            std::shared_ptr<const MeshData> meshData = holdMeshData(path);
+            meshComponent.meshHandle = createVulkanMesh(path, meshData ? *meshData : emptyMesh, 1, meshComponent.meshData.vertexFormat);
 
-            m_meshBoundsCache[path] = { loadedAsset.localCenter, loadedAsset.localRadius };
+            VulkanMesh* vulkanMesh = getVulkanMesh(meshComponent.meshHandle);
+            if (meshData && vulkanMesh && meshComponent.renderType == RenderType::TRANSPARENT) {
+                vulkanMesh->buildTriangleCenters(*meshData);
+            }
+            releaseMeshData(path);
+        }
 
-            meshComponent.textureNames = std::move(loadedAsset.textureNames);
-        }else [[likely]] {
-            return;
+        auto asset = m_meshAssets.find(path);
+        if (asset != m_meshAssets.end()) {
+            meshComponent.localCenter = asset->second.bounds.center;
+            meshComponent.localRadius = asset->second.bounds.radius;
+            meshComponent.forceRefresh();
         }
+    }
 
-        meshComponent.textureNames.clear();
+    MeshHandle MeshManager::createVulkanMesh(const std::string& path, const MeshData& meshData, int instances, VertexFormat format) {
         std::unordered_set<std::string> uniqueTextures;
-
-        for (const auto& submesh : meshComponent.meshData.submeshes) {
+        for (const auto& submesh : meshData.submeshes) {
             if (!submesh.texturePath.empty()) {
                 uniqueTextures.insert(submesh.texturePath);
-                 meshComponent.textureNames.push_back(submesh.texturePath);
             }
         }
 
@@ -190,7 +422,7 @@ namespace vex {
         for (const auto& texPath : uniqueTextures) {
             if (!m_p_resources->textureExists(texPath)) {
                 try {
-                    m_p_resources->loadTexture(texPath, texPath);
+                    m_p_resources->loadTexture(texPath, texPath, true);
                     log("Loaded texture: %s", texPath.c_str());
                 } catch (const std::exception& e) {
                     log(LogLevel::ERROR, "Failed to load texture %s", texPath.c_str());
@@ -201,17 +433,71 @@ namespace vex {
         try {
             log("Initializing Vulkan mesh for: %s", path.c_str());
 
-            auto newVulkanMesh = std::make_unique<VulkanMesh>(m_r_context);
-            newVulkanMesh->upload(meshComponent.meshData);
-            newVulkanMesh->addInstance();
+            auto newVulkanMesh = std::make_unique<VulkanMesh>(m_r_context, m_p_meshArena.get());
+            newVulkanMesh->upload(meshData, format);
+            for (int i = 0; i < instances; i++) {
+                newVulkanMesh->addInstance();
+            }
 
-            m_vulkanMeshes.emplace(path, std::move(newVulkanMesh));
+            MeshHandle handle = m_vulkanMeshes.insert(std::move(newVulkanMesh));
+            m_meshHandles[path] = handle;
 
             log("Successfully registered mesh: %s", path.c_str());
+            return handle;
 
         } catch (const std::exception& e) {
             log(LogLevel::ERROR, "Failed to register VulkanMesh: %s", path.c_str());
         }
+        return {};
+    }
+
+    void MeshManager::updateMeshBounds(entt::entity entity, const glm::vec3& center, float radius) {
+        auto index = entt::to_entity(entity);
+        if (index >= m_spatialProxies.size()) {
+            m_spatialProxies.resize(index + 1, DynamicAABBTree::NULL_NODE);
+        }
+
+        AABB bounds = AABB::fromSphere(center, radius);
+        int32_t& proxy = m_spatialProxies[index];
+        if (proxy == DynamicAABBTree::NULL_NODE) [[unlikely]] {
+            proxy = m_spatialTree.createProxy(bounds, entt::to_integral(entity));
+        } else {
+            m_spatialTree.moveProxy(proxy, bounds);
+        }
+    }
+
+    void MeshManager::removeMeshBounds(entt::entity entity) {
+        auto index = entt::to_entity(entity);
+        if (index < m_spatialProxies.size() && m_spatialProxies[index] != DynamicAABBTree::NULL_NODE) {
+            m_spatialTree.destroyProxy(m_spatialProxies[index]);
+            m_spatialProxies[index] = DynamicAABBTree::NULL_NODE;
+        }
+    }
+
+    void MeshManager::acquireMesh(entt::entity entity, MeshComponent& meshComponent, bool allowAsync) {
+        const std::string& path = meshComponent.meshData.meshPath;
+
+        auto pending = m_pendingMeshes.find(path);
+        if (pending != m_pendingMeshes.end()) {
+            pending->second.entities.push_back(entity);
+            return;
+        }
+
+        bool alreadyExisted = m_meshHandles.contains(path);
+        if (!alreadyExisted && allowAsync && !path.empty() && path != GetAssetDir()) {
+            log("Loading mesh asynchronously: %s", path.c_str());
+            m_pendingMeshes[path] = PendingMesh{ { entity }, meshComponent.meshData.vertexFormat };
+            m_p_meshLoader->request(path, m_lodSettings);
+            return;
+        }
+
+        registerVulkanMesh(meshComponent);
+
+        if (alreadyExisted) {
+            if (VulkanMesh* vulkanMesh = getVulkanMesh(meshComponent.meshHandle)) {
+                vulkanMesh->addInstance();
+            }
+        }
     }
 
     void MeshManager::onMeshComponentConstruct(entt::registry& registry, entt::entity entity) {
@@ -224,84 +510,124 @@ namespace vex {
             meshComponent.id = m_nextModelId++;
         }
 
+        if (meshComponent.id >= m_installedPaths.size()) {
+            m_installedPaths.resize(meshComponent.id + 1);
+        }
         m_installedPaths[meshComponent.id] = meshComponent.meshData.meshPath;
-        const std::string& path = meshComponent.meshData.meshPath;
-
-        bool alreadyExisted = m_vulkanMeshes.count(path) > 0;
-
-        registerVulkanMesh(meshComponent);
+        meshComponent.meshHandle = {};
+
+        // Data built by hand moves into the cache, it can't be imported again so it's never released.
+        const std::string path = meshComponent.meshData.meshPath;
+        bool adopted = false;
+        if (!meshComponent.meshData.submeshes.empty()) {
+            if (!m_meshHandles.contains(path) && !m_pendingMeshes.contains(path)) {
+                MeshBounds bounds = computeMeshBounds(meshComponent.meshData);
+                cacheMeshData(path, std::move(meshComponent.meshData), bounds);
+                m_meshAssets[path].keep = true;
+                adopted = true;
+            }
 
-        if (alreadyExisted) {
-            m_vulkanMeshes.at(path)->addInstance();
+            const VertexFormat format = meshComponent.meshData.vertexFormat;
+            meshComponent.meshData = MeshData{};
+            meshComponent.meshData.meshPath = path;
+            meshComponent.meshData.vertexFormat = format;
         }
 
-        if(registry.any_of<PhysicsComponent>(entity)) {
-            auto& oldPC = registry.get<PhysicsComponent>(entity);
-            if(oldPC.shape == ShapeType::MESH){
-                PhysicsComponent newPC = PhysicsComponent::Mesh(meshComponent, oldPC.bodyType, oldPC.mass, oldPC.friction, oldPC.bounce);
-                registry.replace<PhysicsComponent>(entity, newPC);
+        // Mesh physics shapes are built from vertices, those entities can't wait for the import.
+        std::shared_ptr<const MeshData> physicsData;
+        if (const auto* physicsComponent = registry.try_get<PhysicsComponent>(entity)) {
+            if (physicsComponent->shape == ShapeType::MESH) {
+                physicsData = holdMeshData(path);
             }
+        }
 
+        acquireMesh(entity, meshComponent, m_asyncLoading && !physicsData && !adopted);
+
+        if (physicsData) {
+            auto& oldPC = registry.get<PhysicsComponent>(entity);
+            PhysicsComponent newPC = PhysicsComponent::Mesh(*physicsData, oldPC.bodyType, oldPC.mass, oldPC.friction, oldPC.bounce);
+            registry.replace<PhysicsComponent>(entity, newPC);
+            releaseUploadedMeshData(path);
         }
     }
 
     void MeshManager::onMeshComponentDestroy(entt::registry& registry, entt::entity entity) {
         auto& meshComponent = registry.get<MeshComponent>(entity);
 
-        m_freeModelIds.push_back(meshComponent.id);
-
-        if (m_vulkanMeshes.count(meshComponent.meshData.meshPath)) {
-            auto& vulkanMesh = m_vulkanMeshes.at(meshComponent.meshData.meshPath);
-            vulkanMesh->removeInstance();
+        removeMeshBounds(entity);
 
-            log("Reference count decreased for: %s (Total: %d)", meshComponent.meshData.meshPath.c_str(), vulkanMesh->getNumOfInstances());
+        m_freeModelIds.push_back(meshComponent.id);
 
-            if (vulkanMesh->getNumOfInstances() <= 0) {
-                log("Cleaning up unused mesh: %s", meshComponent.meshData.meshPath.c_str());
+        // Installed path, a swap not picked up by the renderer yet still holds the old mesh.
+        if (meshComponent.id < m_installedPaths.size()) {
+            releaseMeshReference(m_installedPaths[meshComponent.id], entity);
+            m_installedPaths[meshComponent.id].clear();
+        }
+    }
 
-                for (const auto& tex : meshComponent.textureNames) {
-                    m_p_resources->unloadTexture(tex);
-                }
+    void MeshManager::onPhysicsComponentConstruct(entt::registry& registry, entt::entity entity) {
+        auto& physicsComponent = registry.get<PhysicsComponent>(entity);
+        const auto* meshComponent = registry.try_get<MeshComponent>(entity);
+        if (physicsComponent.shape != ShapeType::MESH || !physicsComponent.meshVertices.empty() || !meshComponent) {
+            return;
+        }
 
-                m_vulkanMeshes.erase(meshComponent.meshData.meshPath);
-            }
+        const std::string& path = meshComponent->meshData.meshPath;
+        if (std::shared_ptr<const MeshData> meshData = holdMeshData(path)) {
+            PhysicsComponent shape = PhysicsComponent::Mesh(*meshData);
+            physicsComponent.meshVertices = std::move(shape.meshVertices);
+            physicsComponent.meshIndices = std::move(shape.meshIndices);
         }
+        releaseUploadedMeshData(path);
     }
 
-    void MeshManager::releaseMeshReference(const std::string& path, MeshComponent& ownerComp) {
+    void MeshManager::releaseMeshReference(const std::string& path, entt::entity entity) {
         if (path.empty()) return;
 
-        if (m_vulkanMeshes.count(path)) {
-            auto& vulkanMesh = m_vulkanMeshes.at(path);
+        auto pending = m_pendingMeshes.find(path);
+        if (pending != m_pendingMeshes.end()) {
+            auto& entities = pending->second.entities;
+            auto waiting = std::find(entities.begin(), entities.end(), entity);
+            if (waiting == entities.end()) return;
+
+            *waiting = entities.back();
+            entities.pop_back();
+            if (entities.empty()) {
+                log("Cancelling load of unused mesh: %s", path.c_str());
+                m_p_meshLoader->cancel(path);
+                m_pendingMeshes.erase(pending);
+            }
+            return;
+        }
+
+        if (VulkanMesh* vulkanMesh = findVulkanMesh(path)) {
             vulkanMesh->removeInstance();
 
             log("Ref count decreased for: %s (Remaining: %d)", path.c_str(), vulkanMesh->getNumOfInstances());
 
             if (vulkanMesh->getNumOfInstances() <= 0) {
-                log("Cleaning up unused mesh: %s", path.c_str());
-
-                for (const auto& tex : ownerComp.textureNames) {
-                    m_p_resources->unloadTexture(tex);
-                }
-                ownerComp.textureNames.clear();
-                m_vulkanMeshes.erase(path);
+                destroyVulkanMesh(path);
             }
         }
     }
 
-    void MeshManager::destroyModel(std::string& name, MeshComponent meshComponent) {
-        log("Freed model id");
-        m_freeModelIds.push_back(meshComponent.id);
+    void MeshManager::destroyVulkanMesh(const std::string& path) {
+        log("Cleaning up unused mesh: %s", path.c_str());
 
-        if(getVulkanMeshByMesh(meshComponent)->getNumOfInstances() <= 1){
-            log("Erased VulkanMesh data");
-            m_vulkanMeshes.erase(meshComponent.meshData.meshPath);
-            for(size_t i = 0; i < meshComponent.textureNames.size(); i++){
-                m_p_resources->unloadTexture(meshComponent.textureNames[i]);
+        // Textures come from the mesh itself, components that didn't trigger the load don't list them.
+        std::unordered_set<std::string> uniqueTextures;
+        for (const auto& texture : findVulkanMesh(path)->getSubmeshTextures()) {
+            if (!texture.empty() && uniqueTextures.insert(texture).second) {
+                m_p_resources->unloadTexture(texture);
             }
-            log("Unloaded textures");
-        }else{
-            getVulkanMeshByMesh(meshComponent)->removeInstance();
+        }
+
+        eraseVulkanMesh(path);
+
+        // Data built by hand has no file to import it from again, it stays for the next component using its path.
+        auto asset = m_meshAssets.find(path);
+        if (asset != m_meshAssets.end() && !asset->second.keep) {
+            m_meshAssets.erase(asset);
         }
     }
 }
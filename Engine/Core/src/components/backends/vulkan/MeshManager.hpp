@@ -1,9 +1,14 @@
 #pragma once
 
 #include "VulkanMesh.hpp"
+#include "AsyncMeshLoader.hpp"
 #include "components/GameComponents/BasicComponents.hpp"
 #include "components/GameObjects/ModelObject.hpp"
 #include "components/Mesh.hpp"
+#include "components/MeshSimplifier.hpp"
+#include "components/MeshCooker.hpp"
+#include "components/DynamicAABBTree.hpp"
+#include "components/Handle.hpp"
 #include "components/VirtualFileSystem.hpp"
 #include "entt/entity/fwd.hpp"
 #include "Engine.hpp"
@@ -19,6 +24,15 @@
 #include <algorithm>
 
 namespace vex {
+    /// @brief Memory used by one mesh asset, reported by `MeshManager::getMeshMemoryInfo`.
+    struct MeshMemoryInfo {
+        std::string path;
+        uint64_t cpuBytes = 0;     // cached MeshData, 0 once it was released
+        uint64_t sortingBytes = 0; // triangle centers kept for transparency sorting, also CPU memory
+        uint64_t gpuBytes = 0;     // uploaded vertices and indices
+        int instances = 0;         // mesh components using the uploaded mesh
+    };
+
     class MeshManager {
     public:
         /// @brief Constructor for MeshManager.
@@ -36,14 +50,91 @@ namespace vex {
             auto& registry = m_p_engine->getRegistry();
             registry.on_construct<MeshComponent>().connect<&MeshManager::onMeshComponentConstruct>(this);
             registry.on_destroy<MeshComponent>().connect<&MeshManager::onMeshComponentDestroy>(this);
+            registry.on_construct<PhysicsComponent>().connect<&MeshManager::onPhysicsComponentConstruct>(this);
         }
 
-        /// @brief Loads mesh from a file, creates vulkan mesh and returns a MeshComponent.
+        /// @brief Loads mesh from a file and returns a MeshComponent holding its path and bounds.
+        /// @details Meshes are shared by path, format of the first load of a path is the one that gets uploaded. A cooked `.vmesh` sibling is used
+        /// when it matches the source, otherwise the source is imported with Assimp and levels of detail are generated with current `MeshLodSettings`.
+        /// Loaded data is cached until the mesh is uploaded, a mesh that is already uploaded or loading isn't imported again.
         /// @param const std::string& path
+        /// @param VertexFormat format - Vertex layout used on the GPU.
         /// @return MeshComponent
-        MeshComponent loadMesh(const std::string& path);
+        MeshComponent loadMesh(const std::string& path, VertexFormat format = VertexFormat::STANDARD);
+
+        /// @brief Starts loading a mesh on worker threads and returns right away.
+        /// @details Returned component only holds the path and format, it can be added to entities immediately. Such entities aren't drawn
+        /// until the mesh is uploaded, which happens in `updateMeshLoads` a few frames later. Calling it for a mesh that is already loaded just returns its component.
+        /// @param const std::string& path
+        /// @param VertexFormat format - Vertex layout used on the GPU.
+        /// @return MeshComponent
+        MeshComponent loadMeshAsync(const std::string& path, VertexFormat format = VertexFormat::STANDARD);
+
+        /// @brief Uploads meshes whose import finished, called by the renderer every frame.
+        void updateMeshLoads();
+
+        /// @brief Compacts mesh arena once frees fragmented it and moves all meshes of this manager to their new offsets, called by the renderer before recording a frame.
+        /// @return MeshArena::Relocation - Empty if nothing moved, meshes created outside the manager on the same arena have to be relocated by their owner.
+        MeshArena::Relocation compactMeshArena();
+
+        /// @brief Blocks until every mesh that is loading asynchronously is uploaded, useful after loading a scene to avoid pop in.
+        void finishMeshLoads();
+
+        /// @brief Returns true while mesh is imported on a worker thread or waits for upload.
+        /// @param const std::string& path
+        /// @return bool
+        bool isMeshLoading(const std::string& path) const { return m_pendingMeshes.contains(path); }
+
+        /// @brief Returns number of meshes being loaded asynchronously.
+        /// @return size_t
+        size_t getLoadingMeshCount() const { return m_pendingMeshes.size(); }
+
+        /// @brief Returns counters of the asynchronous loader, how many loads were cancelled or finished too late to be used.
+        /// @return AsyncMeshLoader::Stats
+        AsyncMeshLoader::Stats getMeshLoadStats() const { return m_p_meshLoader->getStats(); }
+
+        /// @brief Sets if mesh components added with only a path load asynchronously, enabled by default.
+        /// @details When disabled they are loaded on first draw, stalling that frame. Components carrying mesh data or added together with a mesh `PhysicsComponent` always load right away.
+        /// @param bool enabled
+        void setAsyncLoading(bool enabled) { m_asyncLoading = enabled; }
+
+        /// @brief Returns true if mesh components added with only a path load asynchronously.
+        /// @return bool
+        bool isAsyncLoading() const { return m_asyncLoading; }
+
+        /// @brief Returns CPU side data of a mesh, one copy shared by every user of the path.
+        /// @details Once a mesh is uploaded the cache lets go of its data unless it's kept: with `setRetainMeshData`, or when the data came with a component
+        /// built by hand. Mesh physics shapes copy the vertices they need and don't keep it. Released data lives as long as returned pointers do, after that asking for it imports the mesh again.
+        /// @param const std::string& path
+        /// @return std::shared_ptr<const MeshData> - nullptr if the mesh can't be loaded.
+        std::shared_ptr<const MeshData> getMeshData(const std::string& path);
+
+        /// @brief Sets if CPU data of every mesh stays cached after upload, disabled by default. The editor enables it, picking tests mesh triangles.
+        /// @param bool retain
+        void setRetainMeshData(bool retain);
+
+        /// @brief Returns true if CPU data of every mesh stays cached after upload.
+        /// @return bool
+        bool isRetainingMeshData() const { return m_retainMeshData; }
+
+        /// @brief Returns memory used by every mesh asset that is cached or uploaded.
+        /// @return std::vector<MeshMemoryInfo>
+        std::vector<MeshMemoryInfo> getMeshMemoryInfo() const;
+
+        /// @brief Returns CPU memory used by all mesh assets, cached data plus triangle centers.
+        /// @return uint64_t
+        uint64_t getMeshCpuBytes() const;
+
+        /// @brief Sets how levels of detail are generated for meshes loaded from now on.
+        /// @param const MeshLodSettings& settings
+        void setLodSettings(const MeshLodSettings& settings) { m_lodSettings = settings; }
+
+        /// @brief Returns settings used to generate levels of detail.
+        /// @return const MeshLodSettings&
+        const MeshLodSettings& getLodSettings() const { return m_lodSettings; }
 
         /// @brief Creates a model object from a mesh component, transform component, and parent entity.
+        /// @details Mesh is uploaded, or shared with other components of the same path, when the component is added to the model entity.
         /// @param const std::string& name
         /// @param MeshComponent meshComponent
         /// @param TransformComponent transformComponent
@@ -51,31 +142,86 @@ namespace vex {
         /// @return ModelObject*
         ModelObject* createModel(const std::string& name, MeshComponent meshComponent, TransformComponent transformComponent, entt::entity parent);
 
-        /// @brief Destroys a model object by name and mesh component.
-        /// @param std::string& name
-        /// @param MeshComponent meshComponent
-        void destroyModel(std::string& name, MeshComponent meshComponent);
-
         /// @brief Registers a Vulkan mesh component.
         /// @param MeshComponent& meshComponent
         void registerVulkanMesh(MeshComponent& meshComponent);
 
-        /// @brief Retrieves a Vulkan mesh by mesh component.
+        /// @brief Binds component to its Vulkan mesh and returns it, called by the renderer once per visible entity each frame.
+        /// @details Swaps meshes when `meshData.meshPath` changed and resolves `MeshComponent::meshHandle` on first use, later calls only check the handle.
+        /// Refreshes texture handles of the mesh, so drawing it afterwards needs no name lookups.
+        /// @param entt::entity entity - Entity owning the component.
         /// @param MeshComponent& meshComponent
-        /// @return std::unique_ptr<VulkanMesh>&
-        std::unique_ptr<VulkanMesh>& getVulkanMeshByMesh(MeshComponent& meshComponent);
+        /// @return VulkanMesh* - nullptr while the mesh is loading or if it can't be loaded.
+        VulkanMesh* bindMesh(entt::entity entity, MeshComponent& meshComponent);
+
+        /// @brief Returns Vulkan mesh a handle points to, one array access. Safe to call from recording threads.
+        /// @param MeshHandle handle - Usually `MeshComponent::meshHandle` resolved by `bindMesh`.
+        /// @return VulkanMesh* - nullptr if handle is null or its mesh was destroyed.
+        VulkanMesh* getVulkanMesh(MeshHandle handle) const {
+            const auto* vulkanMesh = m_vulkanMeshes.get(handle);
+            return vulkanMesh ? vulkanMesh->get() : nullptr;
+        }
+
+        /// @brief Returns arena holding geometry of all meshes created by this manager.
+        /// @return MeshArena*
+        MeshArena* getMeshArena() { return m_p_meshArena.get(); }
+
+        /// @brief Updates world bounds of a mesh entity in the spatial tree, inserts it on first call.
+        /// @details Called by the renderer only for entities whose transform or mesh changed, proxies are removed when MeshComponent is destroyed.
+        /// @param entt::entity entity
+        /// @param const glm::vec3& center - World space bounding sphere center.
+        /// @param float radius - World space bounding sphere radius.
+        void updateMeshBounds(entt::entity entity, const glm::vec3& center, float radius);
+
+        /// @brief Returns true if entity already has bounds in the spatial tree.
+        /// @param entt::entity entity
+        /// @return bool
+        bool hasMeshBounds(entt::entity entity) const {
+            auto index = entt::to_entity(entity);
+            return index < m_spatialProxies.size() && m_spatialProxies[index] != DynamicAABBTree::NULL_NODE;
+        }
+
+        /// @brief Returns bounding volume hierarchy of world bounds of all rendered mesh entities.
+        /// @details User data of proxies is `entt::to_integral(entity)`. Bounds are refreshed during rendering, so queries made in update see last frame positions.
+        /// @return const DynamicAABBTree&
+        const DynamicAABBTree& getSpatialTree() const { return m_spatialTree; }
 
     private:
         VulkanContext& m_r_context;
         Engine* m_p_engine = nullptr;
         VirtualFileSystem* m_vfs;
         std::unique_ptr<VulkanResources>& m_p_resources;
-        vex_map<std::string, std::unique_ptr<VulkanMesh>> m_vulkanMeshes;
+        std::unique_ptr<MeshArena> m_p_meshArena;
+        HandlePool<std::unique_ptr<VulkanMesh>, MeshHandleTag> m_vulkanMeshes;
+        vex_map<std::string, MeshHandle> m_meshHandles; // only used when components are bound, never per draw
         std::vector<uint32_t> m_freeModelIds;
         uint32_t m_nextModelId = 0;
 
-        std::unordered_map<uint32_t, std::string> m_installedPaths;
-        std::unordered_map<std::string, std::pair<glm::vec3, float>> m_meshBoundsCache;
+        std::vector<std::string> m_installedPaths; // indexed by MeshComponent::id
+        MeshLodSettings m_lodSettings;
+
+        /// @brief CPU side of a mesh asset, one per path no matter how many components use it.
+        struct MeshAsset {
+            std::weak_ptr<const MeshData> data;       // alive while the cache or anyone else holds it
+            std::shared_ptr<const MeshData> retained; // cache's own reference, dropped after upload unless the data is kept
+            MeshBounds bounds;
+            bool keep = false; // built by hand, there is no file to import it from again
+        };
+        vex_map<std::string, MeshAsset> m_meshAssets;
+        bool m_retainMeshData = false;
+
+        /// @brief Mesh waiting for its asynchronous import.
+        struct PendingMesh {
+            std::vector<entt::entity> entities; // entities whose mesh component waits for it, they become instances once it is uploaded
+            VertexFormat format = VertexFormat::STANDARD;
+        };
+        std::unique_ptr<AsyncMeshLoader> m_p_meshLoader;
+        vex_map<std::string, PendingMesh> m_pendingMeshes;
+        std::vector<LoadedMesh> m_loadedMeshes;
+        bool m_asyncLoading = true;
+
+        DynamicAABBTree m_spatialTree;
+        std::vector<int32_t> m_spatialProxies; // indexed by entt::to_entity
 
         /// @brief Internally handles the construction of a mesh component called by entt callbacks.
         void onMeshComponentConstruct(entt::registry& registry, entt::entity entity);
@@ -83,7 +229,80 @@ namespace vex {
         /// @brief Internally handles the destruction of a mesh component called by entt callbacks.
         void onMeshComponentDestroy(entt::registry& registry, entt::entity entity);
 
+        /// @brief Fills vertices of a mesh physics shape added to an entity that already has a mesh component, called by entt callbacks.
+        void onPhysicsComponentConstruct(entt::registry& registry, entt::entity entity);
+
+        /// @brief CPU part of loading a mesh, touches nothing but the file system so it also runs on import threads.
+        /// @param const std::string& path - Mesh path, relative to the asset folder.
+        /// @param const MeshLodSettings& settings - Settings levels of detail are generated with.
+        /// @param MeshData& meshData - Receives the mesh.
+        /// @param MeshBounds& bounds - Receives mesh bounds.
+        /// @return bool - false if the mesh has no submeshes.
+        bool importMesh(const std::string& path, const MeshLodSettings& settings, MeshData& meshData, MeshBounds& bounds);
+
+        /// @brief Loads cooked sibling of a mesh source, if there is one and it was cooked from the same source with the same `MeshLodSettings`.
+        /// @details Distribution builds skip the source hash check, their cooked files are made together with the asset pack.
+        /// @param const std::string& realPath - Resolved path of the source mesh.
+        /// @param const MeshLodSettings& settings - Settings the cooked file has to match.
+        /// @param MeshData& meshData - Receives the mesh.
+        /// @param MeshBounds& bounds - Receives mesh bounds.
+        /// @return bool - false if the source has to be imported.
+        bool loadCookedMesh(const std::string& realPath, const MeshLodSettings& settings, MeshData& meshData, MeshBounds& bounds);
+
+        /// @brief Imports a mesh and puts its data into the cache, holding it until `releaseMeshData`.
+        /// @param const std::string& path
+        /// @return std::shared_ptr<const MeshData> - nullptr if the mesh can't be loaded.
+        std::shared_ptr<const MeshData> importMeshData(const std::string& path);
+
+        /// @brief Stores mesh data in the cache, held until `releaseMeshData`.
+        /// @param const std::string& path
+        /// @param MeshData&& meshData
+        /// @param const MeshBounds& bounds
+        /// @return std::shared_ptr<const MeshData>
+        std::shared_ptr<const MeshData> cacheMeshData(const std::string& path, MeshData&& meshData, const MeshBounds& bounds);
+
+        /// @brief Returns cached data of a mesh, importing it if it was released, and holds it until `releaseMeshData`.
+        /// @param const std::string& path
+        /// @return std::shared_ptr<const MeshData> - nullptr if the mesh can't be loaded.
+        std::shared_ptr<const MeshData> holdMeshData(const std::string& path);
+
+        /// @brief Drops the cache's own reference to mesh data, unless it has to be kept.
+        /// @param const std::string& path
+        void releaseMeshData(const std::string& path);
+
+        /// @brief Same as `releaseMeshData`, but only once the mesh is uploaded.
+        /// @param const std::string& path
+        void releaseUploadedMeshData(const std::string& path);
+
+        /// @brief Registers mesh of a newly added or swapped component as one more instance, starting an asynchronous load when allowed.
+        /// @param entt::entity entity - Entity owning the component, updated once an asynchronous load finishes.
+        /// @param MeshComponent& meshComponent
+        /// @param bool allowAsync - false if the caller needs mesh data right away.
+        void acquireMesh(entt::entity entity, MeshComponent& meshComponent, bool allowAsync);
+
+        /// @brief Loads textures of a mesh and uploads it.
+        /// @param const std::string& path - Mesh path, key of the new VulkanMesh.
+        /// @param const MeshData& meshData - Mesh to upload.
+        /// @param int instances - Mesh components already using the mesh.
+        /// @param VertexFormat format - Vertex layout requested by the component that loaded the mesh.
+        /// @return MeshHandle - Null if upload failed.
+        MeshHandle createVulkanMesh(const std::string& path, const MeshData& meshData, int instances, VertexFormat format);
+
+        /// @brief Returns Vulkan mesh uploaded for a path, nullptr if there is none.
+        VulkanMesh* findVulkanMesh(const std::string& path);
+
+        /// @brief Destroys Vulkan mesh of a path, handles pointing at it become stale.
+        void eraseVulkanMesh(const std::string& path);
+
+        /// @brief Unloads textures, geometry and cached data of a mesh no component uses anymore.
+        void destroyVulkanMesh(const std::string& path);
+
+        /// @brief Removes entity bounds from the spatial tree.
+        void removeMeshBounds(entt::entity entity);
+
         /// @brief Internally handles the release of a mesh reference called by entt callbacks.
-        void releaseMeshReference(const std::string& path, MeshComponent& ownerComp);
+        /// @param const std::string& path
+        /// @param entt::entity entity - Entity that held the reference, no longer waiting for the mesh if it's loading.
+        void releaseMeshReference(const std::string& path, entt::entity entity);
     };
 }
@@ -1,4 +1,6 @@
 #include "Pipeline.hpp"
+#include <chrono>
+#include <cstddef>
 #include <fstream>
 #include <vulkan/vulkan_core.h>
 
@@ -32,6 +34,69 @@ namespace vex {
         return buffer;
     }
 
+    void VulkanPipeline::setSpecialization(int effectMask) {
+        m_specializationData.effectMask = effectMask;
+        updateSpecializationInfo();
+    }
+
+    void VulkanPipeline::setCompactVertices(bool compact) {
+        m_specializationData.compactVertices = compact ? 1 : 0;
+        updateSpecializationInfo();
+    }
+
+    void VulkanPipeline::updateSpecializationInfo() {
+        m_specialized = true;
+
+        m_specializationEntries[0] = { 0, offsetof(SpecializationData, effectMask), sizeof(int32_t) };
+        m_specializationEntries[1] = { 1, offsetof(SpecializationData, compactVertices), sizeof(int32_t) };
+
+        m_specializationInfo.mapEntryCount = static_cast<uint32_t>(m_specializationEntries.size());
+        m_specializationInfo.pMapEntries = m_specializationEntries.data();
+        m_specializationInfo.dataSize = sizeof(SpecializationData);
+        m_specializationInfo.pData = &m_specializationData;
+    }
+
+    VkResult VulkanPipeline::createPipeline(VkGraphicsPipelineCreateInfo& pipelineInfo, const char* name) {
+        std::vector<VkPipelineShaderStageCreateInfo> stages;
+        const VkPipelineShaderStageCreateInfo* originalStages = pipelineInfo.pStages;
+        if (m_specialized) {
+            stages.assign(pipelineInfo.pStages, pipelineInfo.pStages + pipelineInfo.stageCount);
+            for (auto& stage : stages) {
+                stage.pSpecializationInfo = &m_specializationInfo;
+            }
+            pipelineInfo.pStages = stages.data();
+        }
+
+        VkPipelineCreationFeedback pipelineFeedback{};
+        VkPipelineCreationFeedbackCreateInfo feedbackInfo{};
+        feedbackInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CREATION_FEEDBACK_CREATE_INFO;
+        feedbackInfo.pPipelineCreationFeedback = &pipelineFeedback;
+
+        if (m_r_context.supportsPipelineFeedback) {
+            feedbackInfo.pNext = pipelineInfo.pNext;
+            pipelineInfo.pNext = &feedbackInfo;
+        }
+
+        auto start = std::chrono::high_resolution_clock::now();
+        VkResult result = vkCreateGraphicsPipelines(m_r_context.device, m_r_context.pipelineCache, 1, &pipelineInfo, nullptr, &m_pipeline);
+        auto end = std::chrono::high_resolution_clock::now();
+
+        if (m_r_context.supportsPipelineFeedback) {
+            pipelineInfo.pNext = feedbackInfo.pNext;
+        }
+        pipelineInfo.pStages = originalStages;
+
+        double ms = std::chrono::duration<double, std::milli>(end - start).count();
+        if (pipelineFeedback.flags & VK_PIPELINE_CREATION_FEEDBACK_VALID_BIT) {
+            bool hit = pipelineFeedback.flags & VK_PIPELINE_CREATION_FEEDBACK_APPLICATION_PIPELINE_CACHE_HIT_BIT;
+            log("%s pipeline created in %.2f ms (cache %s)", name, ms, hit ? "hit" : "miss");
+        } else {
+            log("%s pipeline created in %.2f ms", name, ms);
+        }
+
+        return result;
+    }
+
     void VulkanPipeline::updateViewport(glm::uvec2 resolution) {
         m_currentRenderResolution = resolution;
     }
@@ -217,7 +282,7 @@ namespace vex {
         pipelineInfo.layout = m_layout;
         pipelineInfo.pNext = &renderingCreateInfo;
 
-        if (vkCreateGraphicsPipelines(m_r_context.device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_pipeline) != VK_SUCCESS) {
+        if (createPipeline(pipelineInfo, "Opaque") != VK_SUCCESS) {
             throw_error("Failed to create graphics pipeline");
         }
 
@@ -407,7 +472,7 @@ namespace vex {
         pipelineInfo.layout = m_layout;
         pipelineInfo.pNext = &renderingCreateInfo;
 
-        if (vkCreateGraphicsPipelines(m_r_context.device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_pipeline) != VK_SUCCESS) {
+        if (createPipeline(pipelineInfo, "Transparent") != VK_SUCCESS) {
             throw_error("Failed to create graphics pipeline");
         }
 
@@ -597,7 +662,7 @@ namespace vex {
             pipelineInfo.layout = m_layout;
             pipelineInfo.pNext = &renderingCreateInfo;
 
-            if (vkCreateGraphicsPipelines(m_r_context.device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_pipeline) != VK_SUCCESS) {
+            if (createPipeline(pipelineInfo, "Masked") != VK_SUCCESS) {
                 throw_error("Failed to create graphics pipeline");
             }
 
@@ -753,8 +818,7 @@ namespace vex {
         pipelineInfo.layout              = m_layout;
         pipelineInfo.pNext               = &renderingCreateInfo;
 
-        if (vkCreateGraphicsPipelines(m_r_context.device, VK_NULL_HANDLE, 1,
-                                      &pipelineInfo, nullptr, &m_pipeline) != VK_SUCCESS) {
+        if (createPipeline(pipelineInfo, "UI") != VK_SUCCESS) {
             throw_error("Failed to create UI graphics pipeline");
         }
 
@@ -862,7 +926,7 @@ namespace vex {
         pipelineInfo.pDynamicState = &dynamicState;
         pipelineInfo.layout = m_layout;
 
-        if (vkCreateGraphicsPipelines(m_r_context.device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_pipeline) != VK_SUCCESS) {
+        if (createPipeline(pipelineInfo, "Fullscreen") != VK_SUCCESS) {
             throw_error("Failed to create fullscreen pipeline");
         }
 
@@ -997,7 +1061,7 @@ namespace vex {
             pipelineInfo.subpass = 0;
             pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
 
-            if (vkCreateGraphicsPipelines(m_r_context.device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_pipeline) != VK_SUCCESS) {
+            if (createPipeline(pipelineInfo, "Debug") != VK_SUCCESS) {
                 throw_error("Failed to create debug graphics pipeline");
             }
 
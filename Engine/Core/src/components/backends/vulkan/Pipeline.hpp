@@ -83,6 +83,16 @@ namespace vex {
             const std::string& vertPath,
             const std::string& fragPath);
 
+        /// @brief Bakes PS1 effect mask into shaders as specialization constant 0, must be called before `create*Pipeline`.
+        /// @details Without it shaders read the mask from SceneUBO at runtime (uber shader).
+        /// @param int effectMask - Combination of `PS1Effects` flags.
+        void setSpecialization(int effectMask);
+
+        /// @brief Makes shaders decode octahedral normals of `CompactVertex` (specialization constant 1), must be called before `create*Pipeline`.
+        /// @details Vertex input passed to `create*Pipeline` has to describe `CompactVertex` too.
+        /// @param bool compact - True for pipelines drawing `VertexFormat::COMPACT` meshes.
+        void setCompactVertices(bool compact);
+
         /// @brief Returns the VkPipeline handle.
         /// @return VkPipeline - The created pipeline.
         VkPipeline get() const { return m_pipeline; }
@@ -110,6 +120,26 @@ namespace vex {
 
         glm::uvec2 m_currentRenderResolution;
 
+        /// @brief Specialization constant values, layout matches `m_specializationEntries`.
+        struct SpecializationData {
+            int32_t effectMask = -1;
+            int32_t compactVertices = 0;
+        };
+
+        /// @brief Fills `m_specializationInfo` from `m_specializationData`.
+        void updateSpecializationInfo();
+
+        bool m_specialized = false;
+        SpecializationData m_specializationData{};
+        std::array<VkSpecializationMapEntry, 2> m_specializationEntries{};
+        VkSpecializationInfo m_specializationInfo{};
+
+        /// @brief Creates `m_pipeline` through the shared pipeline cache and logs creation time and cache hit or miss.
+        /// @param VkGraphicsPipelineCreateInfo& pipelineInfo - Create info, its pNext chain is restored before returning.
+        /// @param const char* name - Pipeline name used in the log.
+        /// @return VkResult
+        VkResult createPipeline(VkGraphicsPipelineCreateInfo& pipelineInfo, const char* name);
+
         /// @brief Reads a file and returns its contents as a vector of characters.
         /// @param const std::string& filename - The path to the file to read.
         /// @return std::vector<char> - The contents of the file.
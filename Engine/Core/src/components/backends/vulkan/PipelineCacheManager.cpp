@@ -0,0 +1,112 @@
+#include "PipelineCacheManager.hpp"
+#include "components/errorUtils.hpp"
+
+#include <cstring>
+#include <fstream>
+
+namespace vex {
+    PipelineCacheManager::PipelineCacheManager(VulkanContext& context, const std::filesystem::path& cacheFile)
+        : m_r_context(context), m_cacheFile(cacheFile) {
+
+        std::vector<char> initialData = loadValidated();
+        m_loadedFromDisk = !initialData.empty();
+
+        VkPipelineCacheCreateInfo cacheInfo{};
+        cacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+        cacheInfo.initialDataSize = initialData.size();
+        cacheInfo.pInitialData = initialData.empty() ? nullptr : initialData.data();
+
+        if (vkCreatePipelineCache(m_r_context.device, &cacheInfo, nullptr, &m_cache) != VK_SUCCESS) {
+            log(LogLevel::WARNING, "Failed to create pipeline cache from %s, starting empty", m_cacheFile.string().c_str());
+            cacheInfo.initialDataSize = 0;
+            cacheInfo.pInitialData = nullptr;
+            m_loadedFromDisk = false;
+            if (vkCreatePipelineCache(m_r_context.device, &cacheInfo, nullptr, &m_cache) != VK_SUCCESS) {
+                throw_error("Failed to create pipeline cache");
+            }
+        }
+
+        m_r_context.pipelineCache = m_cache;
+        log("Pipeline cache %s (%zu bytes)", m_loadedFromDisk ? "loaded" : "created empty", initialData.size());
+    }
+
+    PipelineCacheManager::~PipelineCacheManager() {
+        save();
+        m_r_context.pipelineCache = VK_NULL_HANDLE;
+        vkDestroyPipelineCache(m_r_context.device, m_cache, nullptr);
+    }
+
+    std::vector<char> PipelineCacheManager::loadValidated() {
+        std::ifstream file(m_cacheFile, std::ios::binary | std::ios::ate);
+        if (!file.is_open()) {
+            log("No pipeline cache at %s", m_cacheFile.string().c_str());
+            return {};
+        }
+
+        std::streamsize size = file.tellg();
+        if (size < static_cast<std::streamsize>(sizeof(VkPipelineCacheHeaderVersionOne))) {
+            log(LogLevel::WARNING, "Pipeline cache %s is truncated, ignoring it", m_cacheFile.string().c_str());
+            return {};
+        }
+
+        std::vector<char> data(static_cast<size_t>(size));
+        file.seekg(0);
+        if (!file.read(data.data(), size)) {
+            log(LogLevel::WARNING, "Failed to read pipeline cache %s", m_cacheFile.string().c_str());
+            return {};
+        }
+
+        VkPipelineCacheHeaderVersionOne header;
+        std::memcpy(&header, data.data(), sizeof(header));
+
+        VkPhysicalDeviceProperties properties;
+        vkGetPhysicalDeviceProperties(m_r_context.physicalDevice, &properties);
+
+        if (header.headerVersion != VK_PIPELINE_CACHE_HEADER_VERSION_ONE ||
+            header.headerSize < sizeof(VkPipelineCacheHeaderVersionOne) || header.headerSize > data.size() ||
+            header.vendorID != properties.vendorID ||
+            header.deviceID != properties.deviceID ||
+            std::memcmp(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE) != 0) {
+            log(LogLevel::WARNING, "Pipeline cache %s belongs to another GPU or driver, rebuilding it", m_cacheFile.string().c_str());
+            return {};
+        }
+
+        return data;
+    }
+
+    bool PipelineCacheManager::save() {
+        size_t size = 0;
+        if (vkGetPipelineCacheData(m_r_context.device, m_cache, &size, nullptr) != VK_SUCCESS || size == 0) {
+            return false;
+        }
+
+        std::vector<char> data(size);
+        if (vkGetPipelineCacheData(m_r_context.device, m_cache, &size, data.data()) != VK_SUCCESS) {
+            log(LogLevel::WARNING, "Failed to retrieve pipeline cache data");
+            return false;
+        }
+
+        std::filesystem::path tempFile = m_cacheFile;
+        tempFile += ".tmp";
+
+        try {
+            std::filesystem::create_directories(m_cacheFile.parent_path());
+            {
+                std::ofstream file(tempFile, std::ios::binary | std::ios::trunc);
+                if (!file.write(data.data(), static_cast<std::streamsize>(size)) || !file.flush()) {
+                    log(LogLevel::WARNING, "Failed to write pipeline cache %s", tempFile.string().c_str());
+                    return false;
+                }
+            }
+            std::filesystem::rename(tempFile, m_cacheFile);
+        } catch (const std::exception& e) {
+            log(LogLevel::WARNING, "Failed to save pipeline cache: %s", e.what());
+            std::error_code ec;
+            std::filesystem::remove(tempFile, ec);
+            return false;
+        }
+
+        log("Pipeline cache saved to %s (%zu bytes)", m_cacheFile.string().c_str(), size);
+        return true;
+    }
+}
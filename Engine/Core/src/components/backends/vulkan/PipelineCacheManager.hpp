@@ -0,0 +1,52 @@
+/**
+ *  @file   PipelineCacheManager.hpp
+ *  @brief  This file defines PipelineCacheManager class persisting VkPipelineCache between runs.
+ *  @author Eryk Roszkowski
+ ***********************************************/
+
+#pragma once
+#include "context.hpp"
+
+#include <filesystem>
+#include <vector>
+
+namespace vex {
+    /// @brief Owns the VkPipelineCache used for all pipeline creation and keeps it on disk.
+    /// @details On construction the cache blob is read and its header (vendor, device, pipelineCacheUUID) is compared with the current GPU,
+    /// blobs from another GPU or driver are ignored instead of handed to the driver.
+    /// `save` writes to a temporary file and renames it over the old one, so a crash mid-write never leaves a truncated cache.
+    class PipelineCacheManager {
+    public:
+        /// @brief Constructor for PipelineCacheManager, loads cache blob and creates VkPipelineCache.
+        /// @param VulkanContext& context - Reference to the VulkanContext object, `context.pipelineCache` is set.
+        /// @param const std::filesystem::path& cacheFile - Location of cache blob.
+        PipelineCacheManager(VulkanContext& context, const std::filesystem::path& cacheFile);
+
+        /// @brief Saves cache to disk and destroys it, device must still be alive.
+        ~PipelineCacheManager();
+
+        PipelineCacheManager(const PipelineCacheManager&) = delete;
+        PipelineCacheManager& operator=(const PipelineCacheManager&) = delete;
+
+        /// @brief Writes current cache contents to disk.
+        /// @return bool - False if data couldn't be retrieved or written.
+        bool save();
+
+        /// @brief Returns cache handle.
+        /// @return VkPipelineCache
+        VkPipelineCache get() const { return m_cache; }
+
+        /// @brief Returns true if a valid blob was loaded from disk.
+        /// @return bool
+        bool loadedFromDisk() const { return m_loadedFromDisk; }
+
+    private:
+        /// @brief Reads blob and returns it if its header matches current device, empty otherwise.
+        std::vector<char> loadValidated();
+
+        VulkanContext& m_r_context;
+        std::filesystem::path m_cacheFile;
+        VkPipelineCache m_cache = VK_NULL_HANDLE;
+        bool m_loadedFromDisk = false;
+    };
+}
@@ -0,0 +1,64 @@
+#include "PipelinePermutations.hpp"
+#include "components/errorUtils.hpp"
+
+namespace vex {
+    PipelinePermutationCache::PipelinePermutationCache(VulkanContext& context) : m_r_context(context) {
+        m_worker = std::thread(&PipelinePermutationCache::workerLoop, this);
+    }
+
+    PipelinePermutationCache::~PipelinePermutationCache() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_wakeCondition.notify_all();
+        m_worker.join();
+    }
+
+    void PipelinePermutationCache::setRecipe(PipelinePass pass, PipelineRecipe recipe) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_recipes[static_cast<size_t>(pass)] = std::move(recipe);
+    }
+
+    VulkanPipeline* PipelinePermutationCache::get(PipelinePass pass, int effectMask) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        auto [it, inserted] = m_pipelines.try_emplace(key(pass, effectMask));
+        if (inserted) [[unlikely]] {
+            if (!m_recipes[static_cast<size_t>(pass)]) {
+                return nullptr;
+            }
+            m_requests.push_back({ pass, effectMask });
+            m_wakeCondition.notify_one();
+        }
+        return it->second.get();
+    }
+
+    void PipelinePermutationCache::workerLoop() {
+        while (true) {
+            Request request;
+            PipelineRecipe recipe;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_wakeCondition.wait(lock, [&] { return m_stop || !m_requests.empty(); });
+                if (m_stop) return;
+
+                request = m_requests.front();
+                m_requests.pop_front();
+                recipe = m_recipes[static_cast<size_t>(request.pass)];
+            }
+
+            auto pipeline = std::make_unique<VulkanPipeline>(m_r_context);
+            pipeline->setSpecialization(request.effectMask);
+            try {
+                recipe(*pipeline);
+            } catch (const std::exception& e) {
+                log(LogLevel::WARNING, "Specialized pipeline for effects 0x%x failed, staying on uber shader: %s", request.effectMask, e.what());
+                continue;
+            }
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_pipelines[key(request.pass, request.effectMask)] = std::move(pipeline);
+        }
+    }
+}
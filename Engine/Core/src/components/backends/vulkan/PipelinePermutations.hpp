@@ -0,0 +1,97 @@
+/**
+ *  @file   PipelinePermutations.hpp
+ *  @brief  This file defines PipelinePermutationCache class building PS1 effect specialized pipelines in background.
+ *  @author Eryk Roszkowski
+ ***********************************************/
+
+#pragma once
+#include "context.hpp"
+#include "Pipeline.hpp"
+#include "components/Mesh.hpp"
+
+#include <array>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace vex {
+    /// @brief Scene passes that have effect specialized permutations.
+    /// @details `*_COMPACT` passes draw the same materials from `VertexFormat::COMPACT` vertices, they follow the standard ones in the same order.
+    enum class PipelinePass : uint32_t {
+        OPAQUE,
+        MASKED,
+        TRANSPARENT,
+        OPAQUE_COMPACT,
+        MASKED_COMPACT,
+        TRANSPARENT_COMPACT,
+        COUNT
+    };
+
+    /// @brief Returns pass drawing meshes of `format` with the material of `pass`.
+    /// @param PipelinePass pass - Standard vertex pass.
+    /// @param VertexFormat format - Vertex format of drawn mesh.
+    /// @return PipelinePass
+    inline PipelinePass passForVertexFormat(PipelinePass pass, VertexFormat format) {
+        if (format == VertexFormat::STANDARD) return pass;
+        return static_cast<PipelinePass>(static_cast<uint32_t>(pass) + static_cast<uint32_t>(PipelinePass::OPAQUE_COMPACT));
+    }
+
+    /// @brief Calls one of `VulkanPipeline::create*Pipeline` with the shaders and vertex layout of a pass.
+    using PipelineRecipe = std::function<void(VulkanPipeline&)>;
+
+    /// @brief Lazily built pipelines with PS1 effect mask baked in as specialization constant.
+    /// @details The first `get` for a pass and mask queues a compile on a worker thread and returns null,
+    /// the caller keeps drawing with the uber shader pipeline until the specialized one is ready.
+    /// Built pipelines are kept for the lifetime of the cache, so toggling effects back and forth doesn't recompile.
+    class PipelinePermutationCache {
+    public:
+        /// @brief Constructor for PipelinePermutationCache, starts the compile thread.
+        /// @param VulkanContext& context - Reference to the VulkanContext object.
+        PipelinePermutationCache(VulkanContext& context);
+
+        /// @brief Stops the compile thread, GPU must not use any cached pipeline anymore.
+        ~PipelinePermutationCache();
+
+        PipelinePermutationCache(const PipelinePermutationCache&) = delete;
+        PipelinePermutationCache& operator=(const PipelinePermutationCache&) = delete;
+
+        /// @brief Sets how pipelines of a pass are built, drops nothing already built.
+        /// @param PipelinePass pass - Target pass.
+        /// @param PipelineRecipe recipe - Builder called on the compile thread.
+        void setRecipe(PipelinePass pass, PipelineRecipe recipe);
+
+        /// @brief Returns specialized pipeline or null if it's not built yet (and queues its build).
+        /// @param PipelinePass pass - Target pass.
+        /// @param int effectMask - Combination of `PS1Effects` flags.
+        /// @return VulkanPipeline*
+        VulkanPipeline* get(PipelinePass pass, int effectMask);
+
+    private:
+        /// @brief Single queued build.
+        struct Request {
+            PipelinePass pass;
+            int effectMask;
+        };
+
+        /// @brief Compile thread main loop.
+        void workerLoop();
+
+        static uint64_t key(PipelinePass pass, int effectMask) {
+            return (static_cast<uint64_t>(pass) << 32) | static_cast<uint32_t>(effectMask);
+        }
+
+        VulkanContext& m_r_context;
+        std::array<PipelineRecipe, static_cast<size_t>(PipelinePass::COUNT)> m_recipes;
+
+        std::mutex m_mutex;
+        std::condition_variable m_wakeCondition;
+        std::deque<Request> m_requests;
+        std::unordered_map<uint64_t, std::unique_ptr<VulkanPipeline>> m_pipelines; // null while building or if build failed
+        bool m_stop = false;
+        std::thread m_worker;
+    };
+}
@@ -0,0 +1,129 @@
+#include "RangeAllocator.hpp"
+#include "components/errorUtils.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+namespace vex {
+    RangeAllocator::RangeAllocator(uint64_t capacity) {
+        reset(capacity);
+    }
+
+    void RangeAllocator::reset(uint64_t capacity) {
+        m_capacity = capacity;
+        m_usedBytes = 0;
+        m_freeBlocks.clear();
+        m_allocations.clear();
+        if (capacity > 0) {
+            m_freeBlocks.emplace(0, capacity);
+        }
+    }
+
+    uint64_t RangeAllocator::allocate(uint64_t size, uint64_t alignment) {
+        if (size == 0) return INVALID_OFFSET;
+        alignment = std::max<uint64_t>(alignment, 1);
+
+        auto best = m_freeBlocks.end();
+        uint64_t bestAligned = 0;
+        for (auto it = m_freeBlocks.begin(); it != m_freeBlocks.end(); ++it) {
+            uint64_t aligned = (it->first + alignment - 1) / alignment * alignment;
+            uint64_t padding = aligned - it->first;
+            if (it->second < padding + size) continue;
+            if (best == m_freeBlocks.end() || it->second < best->second) {
+                best = it;
+                bestAligned = aligned;
+                if (it->second == padding + size) break;
+            }
+        }
+
+        if (best == m_freeBlocks.end()) return INVALID_OFFSET;
+
+        uint64_t blockOffset = best->first;
+        uint64_t blockEnd = best->first + best->second;
+        m_freeBlocks.erase(best);
+
+        // Alignment padding in front stays free, so it can be merged back later.
+        if (bestAligned > blockOffset) {
+            m_freeBlocks.emplace(blockOffset, bestAligned - blockOffset);
+        }
+        if (bestAligned + size < blockEnd) {
+            m_freeBlocks.emplace(bestAligned + size, blockEnd - (bestAligned + size));
+        }
+
+        m_allocations.emplace(bestAligned, Allocation{ size, alignment });
+        m_usedBytes += size;
+        return bestAligned;
+    }
+
+    void RangeAllocator::free(uint64_t offset) {
+        auto allocIt = m_allocations.find(offset);
+        if (allocIt == m_allocations.end()) [[unlikely]] {
+            log(LogLevel::WARNING, "RangeAllocator: freeing unknown offset %llu", static_cast<unsigned long long>(offset));
+            return;
+        }
+
+        uint64_t size = allocIt->second.size;
+        m_allocations.erase(allocIt);
+        m_usedBytes -= size;
+
+        auto next = m_freeBlocks.lower_bound(offset);
+        if (next != m_freeBlocks.end() && next->first == offset + size) {
+            size += next->second;
+            next = m_freeBlocks.erase(next);
+        }
+
+        if (next != m_freeBlocks.begin()) {
+            auto prev = std::prev(next);
+            if (prev->first + prev->second == offset) {
+                prev->second += size;
+                return;
+            }
+        }
+
+        m_freeBlocks.emplace(offset, size);
+    }
+
+    void RangeAllocator::pin(uint64_t offset) {
+        auto allocIt = m_allocations.find(offset);
+        if (allocIt == m_allocations.end()) [[unlikely]] {
+            log(LogLevel::WARNING, "RangeAllocator: pinning unknown offset %llu", static_cast<unsigned long long>(offset));
+            return;
+        }
+        allocIt->second.pinned = true;
+    }
+
+    std::vector<RangeAllocator::Move> RangeAllocator::compact() {
+        std::vector<std::pair<uint64_t, Allocation>> allocations(m_allocations.begin(), m_allocations.end());
+        std::sort(allocations.begin(), allocations.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+        std::vector<Move> moves;
+        m_allocations.clear();
+        m_freeBlocks.clear();
+
+        // Every allocation starts at or after the end of the one before it, so its aligned target is never above its offset.
+        uint64_t cursor = 0;
+        for (const auto& [offset, allocation] : allocations) {
+            const uint64_t target = allocation.pinned ? offset : (cursor + allocation.alignment - 1) / allocation.alignment * allocation.alignment;
+            if (target > cursor) {
+                m_freeBlocks.emplace(cursor, target - cursor);
+            }
+            if (target != offset) {
+                moves.push_back({ offset, target, allocation.size });
+            }
+            m_allocations.emplace(target, allocation);
+            cursor = target + allocation.size;
+        }
+        if (cursor < m_capacity) {
+            m_freeBlocks.emplace(cursor, m_capacity - cursor);
+        }
+        return moves;
+    }
+
+    uint64_t RangeAllocator::getLargestFreeBlock() const {
+        uint64_t largest = 0;
+        for (const auto& [offset, size] : m_freeBlocks) {
+            largest = std::max(largest, size);
+        }
+        return largest;
+    }
+}
@@ -0,0 +1,91 @@
+/**
+ *  @file   RangeAllocator.hpp
+ *  @brief  This file defines RangeAllocator class doing free-list bookkeeping of a linear range of bytes.
+ *  @author Eryk Roszkowski
+ ***********************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+namespace vex {
+    /// @brief Free-list sub-allocator over a linear range of bytes.
+    /// @details Picks the smallest free block that fits (best fit) and merges neighbouring blocks on free.
+    /// It only does bookkeeping and never touches Vulkan, so it can be used for any backing store.
+    class RangeAllocator {
+    public:
+        /// @brief Returned by `allocate` when no free block is big enough.
+        static constexpr uint64_t INVALID_OFFSET = UINT64_MAX;
+
+        /// @brief Allocation moved by `compact`, the caller copies its bytes.
+        struct Move {
+            uint64_t from;
+            uint64_t to;
+            uint64_t size;
+        };
+
+        /// @brief Constructor for RangeAllocator.
+        /// @param uint64_t capacity - Size of managed range in bytes.
+        explicit RangeAllocator(uint64_t capacity = 0);
+
+        /// @brief Drops all allocations and makes whole range free.
+        /// @param uint64_t capacity - New size of managed range in bytes.
+        void reset(uint64_t capacity);
+
+        /// @brief Allocates `size` bytes with start aligned to `alignment` (does not have to be a power of two).
+        /// @param uint64_t size - Size in bytes.
+        /// @param uint64_t alignment - Required alignment of returned offset, kept when `compact` moves the allocation.
+        /// @return uint64_t - Offset of allocation or `INVALID_OFFSET`.
+        uint64_t allocate(uint64_t size, uint64_t alignment = 1);
+
+        /// @brief Frees allocation previously returned by `allocate`.
+        /// @param uint64_t offset - Offset of the allocation.
+        void free(uint64_t offset);
+
+        /// @brief Keeps an allocation where it is during `compact`, for allocations whose offset is held somewhere that can't be updated anymore.
+        /// @param uint64_t offset - Offset of the allocation.
+        void pin(uint64_t offset);
+
+        /// @brief Slides allocations toward offset 0 so free space ends up in as few blocks as possible, pinned allocations stay in place.
+        /// @details Allocations keep their order and alignment, so every move goes to a lower offset and never lands on bytes a later
+        /// move still has to read. A move may overlap its own source.
+        /// @return std::vector<Move> - Moves in ascending offset order.
+        std::vector<Move> compact();
+
+        /// @brief Returns size of managed range.
+        /// @return uint64_t
+        uint64_t getCapacity() const { return m_capacity; }
+
+        /// @brief Returns number of allocated bytes.
+        /// @return uint64_t
+        uint64_t getUsedBytes() const { return m_usedBytes; }
+
+        /// @brief Returns size of the biggest free block, biggest allocation that can still succeed (ignoring alignment).
+        /// @return uint64_t
+        uint64_t getLargestFreeBlock() const;
+
+        /// @brief Returns number of free blocks, more than one means free space is fragmented.
+        /// @return size_t
+        size_t getFreeBlockCount() const { return m_freeBlocks.size(); }
+
+        /// @brief Returns number of live allocations.
+        /// @return size_t
+        size_t getAllocationCount() const { return m_allocations.size(); }
+
+    private:
+        struct Allocation {
+            uint64_t size;
+            uint64_t alignment;
+            bool pinned = false;
+        };
+
+        uint64_t m_capacity = 0;
+        uint64_t m_usedBytes = 0;
+        std::map<uint64_t, uint64_t> m_freeBlocks;                 // offset -> size, ordered so neighbours can be merged
+        std::unordered_map<uint64_t, Allocation> m_allocations;    // offset -> allocation
+    };
+}
@@ -1,9 +1,13 @@
 #include "Renderer.hpp"
 #include "components/backends/vulkan/Pipeline.hpp"
 #include "components/backends/vulkan/uniforms.hpp"
+#include "components/Profiler.hpp"
 #include "entt/entity/fwd.hpp"
+#include <algorithm>
 #include <cstdint>
+#include <functional>
 #include <memory>
+#include <thread>
 #define SDL_MAIN_HANDLED
 #include <SDL3/SDL.h>
 #include <entt/entt.hpp>
@@ -56,6 +60,9 @@ namespace vex {
                            std::unique_ptr<VulkanPipeline>& pipeline,
                            std::unique_ptr<VulkanPipeline>& transPipeline,
                            std::unique_ptr<VulkanPipeline>& maskPipeline,
+                           std::unique_ptr<VulkanPipeline>& compactPipeline,
+                           std::unique_ptr<VulkanPipeline>& compactTransPipeline,
+                           std::unique_ptr<VulkanPipeline>& compactMaskPipeline,
                            std::unique_ptr<VulkanPipeline>& uiPipeline,
                            std::unique_ptr<VulkanPipeline>& fullscreenPipeline,
                            std::unique_ptr<VulkanSwapchainManager>& swapchainManager,
@@ -65,6 +72,9 @@ namespace vex {
               m_p_pipeline(pipeline),
               m_p_transPipeline(transPipeline),
               m_p_maskPipeline(maskPipeline),
+              m_p_compactPipeline(compactPipeline),
+              m_p_compactTransPipeline(compactTransPipeline),
+              m_p_compactMaskPipeline(compactMaskPipeline),
               m_p_uiPipeline(uiPipeline),
               m_p_fullscreenPipeline(fullscreenPipeline),
               m_p_swapchainManager(swapchainManager),
@@ -104,7 +114,7 @@ namespace vex {
                 vkAllocateDescriptorSets(m_r_context.device, &allocInfo, &m_screenDescriptorSet);
 
                 #if DEBUG
-                    m_editorCameraVulkanMesh = std::make_unique<VulkanMesh>(m_r_context);
+                    m_editorCameraVulkanMesh = std::make_unique<VulkanMesh>(m_r_context, m_p_meshManager->getMeshArena());
 
                     m_debugBuffers.resize(m_r_context.MAX_FRAMES_IN_FLIGHT);
                     m_debugAllocations.resize(m_r_context.MAX_FRAMES_IN_FLIGHT);
@@ -122,12 +132,19 @@ namespace vex {
                 #endif
                 m_garbageDescriptors.resize(m_r_context.MAX_FRAMES_IN_FLIGHT);
 
+                m_p_permutations = std::make_unique<PipelinePermutationCache>(m_r_context);
+                m_p_gpuProfiler = std::make_unique<GpuProfiler>(m_r_context);
+
+                // Per draw textures need bindless, without it every submesh has to rebind its texture set.
+                m_useIndirectDraw = m_r_context.supportsIndirectDraw && m_r_context.supportsBindlessTextures;
+
                 if (m_r_context.supportsIndirectDraw) {
                         m_indirectBuffers.resize(m_r_context.MAX_FRAMES_IN_FLIGHT);
                         m_indirectAllocations.resize(m_r_context.MAX_FRAMES_IN_FLIGHT);
+                        m_indirectMapped.resize(m_r_context.MAX_FRAMES_IN_FLIGHT);
 
                         VkBufferCreateInfo bufferInfo = { VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
-                        bufferInfo.size = 10000 * sizeof(VkDrawIndexedIndirectCommand);
+                        bufferInfo.size = MAX_INDIRECT_DRAWS * sizeof(VkDrawIndexedIndirectCommand);
                         bufferInfo.usage = VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
 
                         VmaAllocationCreateInfo allocInfo = {};
@@ -135,13 +152,24 @@ namespace vex {
 
                         for(size_t i=0; i<m_r_context.MAX_FRAMES_IN_FLIGHT; i++) {
                             vmaCreateBuffer(m_r_context.allocator, &bufferInfo, &allocInfo, &m_indirectBuffers[i], &m_indirectAllocations[i], nullptr);
+                            vmaMapMemory(m_r_context.allocator, m_indirectAllocations[i], &m_indirectMapped[i]);
                         }
+
                     }
 
+                m_indirectCommands.reserve(MAX_INDIRECT_DRAWS);
+                m_drawData.reserve(MAX_INDIRECT_DRAWS);
+
+                uint32_t hardwareThreads = std::thread::hardware_concurrency();
+                setRecordThreadCount(std::min(DEFAULT_RECORD_THREADS, hardwareThreads > 1 ? hardwareThreads - 1 : 1u));
+
         log("Renderer initialized successfully");
     }
 
     Renderer::~Renderer() {
+        m_p_recorder.reset();
+        m_p_permutations.reset();
+        m_p_gpuProfiler.reset();
         if (m_screenSampler) vkDestroySampler(m_r_context.device, m_screenSampler, nullptr);
         if (m_localPool) vkDestroyDescriptorPool(m_r_context.device, m_localPool, nullptr);
 
@@ -154,6 +182,7 @@ namespace vex {
         if (!m_indirectBuffers.empty()) {
             for(size_t i=0; i < m_indirectBuffers.size(); i++) {
                 if(m_indirectBuffers[i] != VK_NULL_HANDLE) {
+                    vmaUnmapMemory(m_r_context.allocator, m_indirectAllocations[i]);
                     vmaDestroyBuffer(m_r_context.allocator, m_indirectBuffers[i], m_indirectAllocations[i]);
                 }
             }
@@ -179,8 +208,7 @@ namespace vex {
 
         VkDescriptorSet sceneSet = m_p_resources->getUBODescriptorSet(frameIndex);
 
-        uint32_t dynamicOffset = 0;
-        vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, (*m_pp_debugPipeline)->layout(), 0, 1, &sceneSet, 1, &dynamicOffset);
+        vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, (*m_pp_debugPipeline)->layout(), 0, 1, &sceneSet, 0, nullptr);
 
         VkBuffer vBuffers[] = { m_debugBuffers[frameIndex] };
         VkDeviceSize offsets[] = { 0 };
@@ -213,26 +241,47 @@ namespace vex {
 
             vkWaitForFences(m_r_context.device, 1, &m_r_context.inFlightFences[m_r_context.currentFrame], VK_TRUE, UINT64_MAX);
 
-            VkResult result = vkAcquireNextImageKHR(
-                m_r_context.device,
-                m_r_context.swapchain,
-                UINT64_MAX,
-                m_r_context.imageAvailableSemaphores[m_r_context.currentFrame],
-                VK_NULL_HANDLE,
-                &m_r_context.currentImageIndex
-            );
+            if (m_r_context.headless) {
+                // Every frame slot owns one offscreen image, its fence already proves the image is free.
+                m_r_context.currentImageIndex = m_r_context.currentFrame;
+            } else {
+                VkResult result = vkAcquireNextImageKHR(
+                    m_r_context.device,
+                    m_r_context.swapchain,
+                    UINT64_MAX,
+                    m_r_context.imageAvailableSemaphores[m_r_context.currentFrame],
+                    VK_NULL_HANDLE,
+                    &m_r_context.currentImageIndex
+                );
 
-            if (result == VK_ERROR_OUT_OF_DATE_KHR) {
-                m_p_swapchainManager->recreateSwapchain();
-                outData.isSwapchainValid = false;
-                log(LogLevel::WARNING, "Swapchain out of date");
-                return false;
-            } else if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR) {
-                throw_error("Failed to acquire swap chain image!");
+                if (result == VK_ERROR_OUT_OF_DATE_KHR) {
+                    m_p_swapchainManager->recreateSwapchain();
+                    outData.isSwapchainValid = false;
+                    log(LogLevel::WARNING, "Swapchain out of date");
+                    return false;
+                } else if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR) {
+                    throw_error("Failed to acquire swap chain image!");
+                }
             }
 
             vkResetFences(m_r_context.device, 1, &m_r_context.inFlightFences[m_r_context.currentFrame]);
+            // Only once the frame is really going to be submitted, a slot whose acquire failed keeps its old fence
+            // and would not prove that deleters pushed since its last use are safe to run.
+            m_r_context.deletionQueue.beginFrame(m_r_context.currentFrame, m_r_context.MAX_FRAMES_IN_FLIGHT);
+            m_lastIdleWaits = m_r_context.idleWaitsThisFrame;
+            m_r_context.idleWaitsThisFrame = 0;
             vkResetCommandPool(m_r_context.device, m_r_context.commandPools[m_r_context.currentFrame], 0);
+            if (m_p_recorder) {
+                m_p_recorder->beginFrame(m_r_context.currentFrame);
+            }
+            m_p_meshManager->updateMeshLoads();
+            const MeshArena::Relocation relocation = m_p_meshManager->compactMeshArena();
+            #if DEBUG
+                if (!relocation.empty() && m_editorCameraVulkanMesh) {
+                    m_editorCameraVulkanMesh->relocate(relocation);
+                }
+            #endif
+            m_p_resources->updateTextureUploads(m_r_context.currentFrame);
 
             outData.commandBuffer = m_r_context.commandBuffers[m_r_context.currentFrame];
             outData.frameIndex = m_r_context.currentFrame;
@@ -242,6 +291,7 @@ namespace vex {
             VkCommandBufferBeginInfo beginInfo{};
             beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
             vkBeginCommandBuffer(outData.commandBuffer, &beginInfo);
+            m_p_gpuProfiler->beginFrame(outData.commandBuffer, outData.frameIndex);
 
             return true;
         } catch (const std::exception& e) {
@@ -252,7 +302,10 @@ namespace vex {
     }
 
         void Renderer::renderScene(SceneRenderData& data, const entt::entity cameraEntity, entt::registry& registry, int frame, const std::vector<DebugVertex>* debugLines, bool isEditorMode) {
+            VEX_PROFILE_SCOPE("Renderer::renderScene");
             VkCommandBuffer cmd = data.commandBuffer;
+            // Statistics query stays open around the secondary buffers, which needs them to inherit it.
+            GpuScope sceneScope(*m_p_gpuProfiler, cmd, "Scene", !m_p_recorder || m_p_gpuProfiler->supportsInheritedStatistics());
 
             auto now = std::chrono::high_resolution_clock::now();
             currentTime = std::chrono::duration<float>(now - startTime).count();
@@ -328,6 +381,9 @@ namespace vex {
             renderingInfo.colorAttachmentCount = 1;
             renderingInfo.pColorAttachments = &colorAttachment;
             renderingInfo.pDepthAttachment = &depthAttachment;
+            if (m_p_recorder) {
+                renderingInfo.flags = VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT;
+            }
 
             try {
                 vkCmdBeginRendering(cmd, &renderingInfo);
@@ -336,17 +392,9 @@ namespace vex {
                 return;
             }
 
-            VkViewport viewport{};
-            viewport.width = (float)m_r_context.currentRenderResolution.x;
-            viewport.height = (float)m_r_context.currentRenderResolution.y;
-            viewport.minDepth = 0.0f; viewport.maxDepth = 1.0f;
-            vkCmdSetViewport(cmd, 0, 1, &viewport);
-
-            //std::cout << "textureView x:" << viewport.width << ", y:" << viewport.height << std::endl;
-
-            VkRect2D scissor{};
-            scissor.extent = {m_r_context.currentRenderResolution.x, m_r_context.currentRenderResolution.y};
-            vkCmdSetScissor(cmd, 0, 1, &scissor);
+            if (!m_p_recorder) {
+                bindSceneState(cmd);
+            }
 
             glm::mat4 view = glm::mat4(1.0f);
             glm::mat4 proj = glm::mat4(1.0f);
@@ -404,6 +452,20 @@ namespace vex {
                 m_sceneUBO.enablePS1Effects |= PS1Effects::SCREEN_DITHER;
             }
 
+            // Uber shader pipelines stay in use until the permutation for this mask finishes compiling.
+            m_activePipelines = { m_p_pipeline.get(), m_p_maskPipeline.get(), m_p_transPipeline.get(),
+                                  m_p_compactPipeline.get(), m_p_compactMaskPipeline.get(), m_p_compactTransPipeline.get() };
+            uint32_t specializedPasses = 0;
+            if (m_useSpecializedPipelines) [[likely]] {
+                for (size_t pass = 0; pass < m_activePipelines.size(); pass++) {
+                    if (pass >= static_cast<size_t>(PipelinePass::OPAQUE_COMPACT) && !m_drewCompactGeometry) break;
+                    if (VulkanPipeline* specialized = m_p_permutations->get(static_cast<PipelinePass>(pass), m_sceneUBO.enablePS1Effects)) {
+                        m_activePipelines[pass] = specialized;
+                        specializedPasses++;
+                    }
+                }
+            }
+
             m_sceneUBO.renderResolution = m_r_context.currentRenderResolution;
             m_sceneUBO.windowResolution = {m_r_context.swapchainExtent.width, m_r_context.swapchainExtent.height};
             m_sceneUBO.time = currentTime;
@@ -415,15 +477,41 @@ namespace vex {
             m_sceneUBO.sunLight = glm::vec4(m_r_context.m_enviroment.sunLight,1.0f);
             m_sceneUBO.sunDirection = glm::vec4(m_r_context.m_enviroment.sunDirection,1.0f);
 
-            m_p_resources->updateSceneUBO(m_sceneUBO);
+            m_sceneLights.clear();
+            auto lightView = registry.view<TransformComponent, LightComponent>();
+            for (auto lightEntity : lightView) {
+                if (m_sceneLights.size() >= MAX_SCENE_LIGHTS) [[unlikely]] {
+                    log(LogLevel::WARNING, "Limit reached of scene dynamic lights, rest of the lights wont be rendered.");
+                    break;
+                }
+
+                auto& light = lightView.get<LightComponent>(lightEntity);
+                auto& lightTransform = lightView.get<TransformComponent>(lightEntity);
+
+                if(!lightTransform.isReady()){
+                    lightTransform.setRegistry(registry);
+                }
+
+                Light& targetLight = m_sceneLights.emplace_back();
+                targetLight.position = glm::vec4(lightTransform.getWorldPosition(), light.radius);
+                targetLight.color = glm::vec4(light.color, light.intensity);
+            }
 
-            vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, m_p_pipeline->get());
+            m_lightClusters.build(view, proj, camera.nearPlane, camera.farPlane, m_sceneLights);
+            m_p_resources->updateClusteredLights(m_r_context.currentFrame, m_sceneLights, m_lightClusters);
+
+            m_sceneUBO.clusterGrid = m_lightClusters.getGridSize();
+            m_sceneUBO.clusterDepth = m_lightClusters.getDepthParams();
+
+            m_p_resources->updateSceneUBO(m_sceneUBO);
 
             glm::vec3 cameraPos = extractCameraPosition(view);
+            m_cameraPosition = cameraPos;
+            m_projectedSizeScale = std::abs(proj[1][1]) * static_cast<float>(m_r_context.currentRenderResolution.y);
             Frustum camFrustum;
             camFrustum.update(proj * view);
 
-            m_transparentTriangles.clear();
+            m_transparentObjects.clear();
             trnasMatrixes.clear();
             uint32_t modelIndex = 0;
 
@@ -440,6 +528,8 @@ namespace vex {
             auto it = modelView.begin();
             auto end = modelView.end();
 
+            // Refit pass, only entities that moved (or have no bounds yet) touch the spatial tree.
+            m_visibleEntities.clear();
             for (; it != end; ++it) {
                 const auto entity = *it;
 
@@ -457,13 +547,14 @@ namespace vex {
 
                 auto& transform = modelView.get<TransformComponent>(entity);
                 auto& mesh = modelView.get<MeshComponent>(entity);
-                glm::mat4 modelMatrix = transform.matrix();
 
                 if(!transform.isReady()){
                     transform.setRegistry(registry);
                 }
 
-                if(transform.transformedLately() || mesh.getIsFresh() || transform.isPhysicsAffected() || isEditorMode || mesh.worldRadius <= 0.0f){
+                if(transform.transformedLately() || mesh.getIsFresh() || transform.isPhysicsAffected() || isEditorMode || mesh.worldRadius <= 0.0f ||
+                   !m_p_meshManager->hasMeshBounds(entity)){
+                    const glm::mat4& modelMatrix = transform.getWorldMatrix();
                     float scaleX = glm::length(glm::vec3(modelMatrix[0]));
                     float scaleY = glm::length(glm::vec3(modelMatrix[1]));
                     float scaleZ = glm::length(glm::vec3(modelMatrix[2]));
@@ -472,6 +563,7 @@ namespace vex {
 
                     mesh.worldRadius = mesh.localRadius * maxScale;
                     mesh.worldCenter = (modelMatrix * glm::vec4(mesh.localCenter, 1.0f));
+                    m_p_meshManager->updateMeshBounds(entity, mesh.worldCenter, mesh.worldRadius);
 
                     #if DEBUG
                     if(isEditorMode && frame > 0){
@@ -483,216 +575,208 @@ namespace vex {
                     #endif
                 }
 
-                if(!mesh.getIsFresh()) [[unlikely]]{
+                // Fresh meshes are drawn once regardless of culling.
+                if(mesh.getIsFresh()) [[unlikely]] {
+                    m_visibleEntities.push_back(entity);
+                }
+            }
+
+            // Hierarchical culling, subtrees fully inside the frustum skip per object tests.
+            m_p_meshManager->getSpatialTree().queryPlanes(camFrustum.getPlanes(), [&](uint32_t userData, bool fullyInside) {
+                const auto entity = static_cast<entt::entity>(userData);
+                if (!modelView.contains(entity)) [[unlikely]] return true;
+
+                const auto& mesh = modelView.get<MeshComponent>(entity);
+                if (mesh.getIsFresh()) [[unlikely]] return true;
+
+                if (!fullyInside) {
                     bool visible;
                     if (useAVX) [[likely]] {
                         visible = frustumSimd.testSphereAVX(mesh.worldCenter, mesh.worldRadius);
                     } else {
                         visible = camFrustum.testSphere(mesh.worldCenter, mesh.worldRadius);
                     }
-
-                    if (!visible) continue;
+                    if (!visible) return true;
                 }
 
-                auto lightView = registry.view<TransformComponent, LightComponent>();
-
-                SceneLightsUBO lightUBO;
-                lightUBO.lightCount = 0;
-
-                for(auto lightEntity : lightView){
+                m_visibleEntities.push_back(entity);
+                return true;
+            });
 
-                    if (lightUBO.lightCount >= MAX_DYNAMIC_LIGHTS) {
-                        lightUBO.lightCount = MAX_DYNAMIC_LIGHTS;
-                        log(LogLevel::WARNING, "Limit reached of per object dynamic lights, rest of the light wont affect this mesh.");
-                        break;
-                    }
-
-                    auto& light = lightView.get<LightComponent>(lightEntity);
-                    auto& transform = lightView.get<TransformComponent>(lightEntity);
-
-                    if(!transform.isReady()){
-                        transform.setRegistry(registry);
-                    }
-
-                    float dist = glm::distance(transform.getWorldPosition(), mesh.worldCenter);
-                    if (dist < (light.radius + mesh.worldRadius)) {
-                        auto& targetLight = lightUBO.lights[lightUBO.lightCount];
-                        targetLight.position = glm::vec4(transform.getWorldPosition(), light.radius);
-                        targetLight.color = glm::vec4(light.color, light.intensity);
-                        lightUBO.lightCount++;
+            // Meshes are bound here, once per entity and frame. Draw paths below, some on recording threads, only follow `MeshComponent::meshHandle`.
+            for (const auto entity : m_visibleEntities) {
+                auto& transform = modelView.get<TransformComponent>(entity);
+                auto& mesh = modelView.get<MeshComponent>(entity);
+                // Null while the mesh is still loading.
+                VulkanMesh* vulkanMesh = m_p_meshManager->bindMesh(entity, mesh);
+
+                if (vulkanMesh) [[likely]] {
+                    if (mesh.renderType == RenderType::OPAQUE) {
+                        opaqueQueue.push_back({entity, modelIndex});
+                    } else if (mesh.renderType == RenderType::MASKED) {
+                        maskedQueue.push_back({entity, modelIndex});
+                    } else if (mesh.renderType == RenderType::TRANSPARENT) {
+                        const glm::mat4& modelMatrix = transform.getWorldMatrix();
+                        m_transparentObjects.push_back({ vulkanMesh, entity, modelIndex, modelMatrix });
+                        trnasMatrixes[modelIndex] = modelMatrix;
                     }
                 }
-                m_p_resources->updateLightUBO(m_r_context.currentFrame, modelIndex, lightUBO);
-
-                if (mesh.renderType == RenderType::OPAQUE) {
-                    opaqueQueue.push_back({entity, modelIndex});
-                    /* auto& vulkanMesh = m_p_meshManager->getVulkanMeshByMesh(mesh);
-                    if (vulkanMesh) {
-                        vulkanMesh->draw(cmd, m_p_pipeline->layout(), *m_p_resources, data.frameIndex, modelIndex, modelMatrix, mesh.color);
-                    } */
-                } else if (mesh.renderType == RenderType::MASKED) {
-                    maskedQueue.push_back({entity, modelIndex});
-                    /* auto& vulkanMesh = m_p_meshManager->getVulkanMeshByMesh(mesh);
-                    if (vulkanMesh) {
-                        vulkanMesh->draw(cmd, m_p_maskPipeline->layout(), *m_p_resources, data.frameIndex, modelIndex, modelMatrix, mesh.color);
-                    } */
-                } else if (mesh.renderType == RenderType::TRANSPARENT) {
-                     auto& vulkanMesh = m_p_meshManager->getVulkanMeshByMesh(mesh);
-
-                     if (vulkanMesh) {
-                         vulkanMesh->extractTransparentTriangles(
-                             modelMatrix,
-                             cameraPos,
-                             modelIndex,
-                             m_r_context.currentFrame,
-                             entity,
-                             m_transparentTriangles
-                         );
-                         trnasMatrixes[modelIndex] = modelMatrix;
-                     }
-                }
                 modelIndex++;
                 if(mesh.getIsFresh()) mesh.setRendered();
             }
 
-            for (const auto& item : opaqueQueue) {
-                auto& mesh = registry.get<MeshComponent>(item.entity);
-                auto& transform = registry.get<TransformComponent>(item.entity);
-                auto& vulkanMesh = m_p_meshManager->getVulkanMeshByMesh(mesh);
+            m_transparencySorter.sort(m_transparentObjects, cameraPos, m_r_context.currentFrame,
+                                      m_r_context.m_enviroment.perTriangleTransparency, m_transparentTriangles);
 
-                if (vulkanMesh) {
-                    vulkanMesh->draw(cmd, m_p_pipeline->layout(), *m_p_resources, data.frameIndex, item.modelIndex, transform.matrix(), mesh);
-                }
-            }
+            m_stats = RenderStats{};
+            m_stats.visibleObjects = modelIndex;
+            m_stats.transparentTriangles = static_cast<uint32_t>(m_transparentTriangles.size());
+            m_stats.transparentOrderReused = m_transparencySorter.reusedLastOrder();
+            m_stats.specializedPasses = specializedPasses;
+            m_stats.idleWaits = m_lastIdleWaits;
 
-            #if DEBUG
-            if(isEditorMode){
-                auto modelView = registry.view<TransformComponent, CameraComponent>();
-                for (auto entity : modelView) {
-                    if(cameraEntity == entity){
-                        break;
-                    }
-                    auto& transform = modelView.get<TransformComponent>(entity);
-                    glm::vec3 worldScale = transform.getWorldScale();
-                    transform.setWorldScale(glm::vec3(1.f));
-                    if(m_editorCameraVulkanMesh->getNumOfInstances() <= 0){
-                        m_editorCameraMesh.loadFromRawFile("../Assets/meshes/editorCamera.obj");
-                        m_editorCameraVulkanMesh->upload(m_editorCameraMesh);
-                        m_editorCameraVulkanMesh->addInstance();
-                    }else{
-                        auto mc = MeshComponent{};
-                        mc.color = glm::vec4(0.3f, 1.0f, 0.5f, 1.0f);
-                        m_editorCameraVulkanMesh->draw(cmd, m_p_pipeline->layout(), *m_p_resources, data.frameIndex, 0, transform.matrix(), mc);
-                    }
-                    transform.setWorldScale(worldScale);
-                }
-            }
-            #endif
+            IndirectBucket opaqueBucket;
+            IndirectBucket maskedBucket;
 
-            if (!maskedQueue.empty()) {
-                vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, m_p_maskPipeline->get());
+            m_indirectCommands.clear();
+            m_indirectBatches.clear();
+            m_drawData.clear();
+            m_drewCompactGeometry = false;
 
-                for (const auto& item : maskedQueue) {
-                    auto& mesh = registry.get<MeshComponent>(item.entity);
-                    auto& transform = registry.get<TransformComponent>(item.entity);
-                    auto& vulkanMesh = m_p_meshManager->getVulkanMeshByMesh(mesh);
+            bool useInstancing = buildInstanceBucket(opaqueQueue, registry, opaqueBucket) &&
+                                 buildInstanceBucket(maskedQueue, registry, maskedBucket);
 
-                    if (vulkanMesh) {
-                        vulkanMesh->draw(cmd, m_p_maskPipeline->layout(), *m_p_resources, data.frameIndex, item.modelIndex, transform.matrix(), mesh);
-                    }
+            if (useInstancing) [[likely]] {
+                if (m_useIndirectDraw) [[likely]] {
+                    memcpy(m_indirectMapped[data.frameIndex], m_indirectCommands.data(), m_indirectCommands.size() * sizeof(VkDrawIndexedIndirectCommand));
+                    vmaFlushAllocation(m_r_context.allocator, m_indirectAllocations[data.frameIndex], 0, m_indirectCommands.size() * sizeof(VkDrawIndexedIndirectCommand));
                 }
-            }
-
-            if (!m_transparentTriangles.empty()) {
-                std::sort(m_transparentTriangles.begin(), m_transparentTriangles.end(),
-                          [](const auto& a, const auto& b) {
-                              if (a.distanceToCamera != b.distanceToCamera) {
-                                  return a.distanceToCamera > b.distanceToCamera;
-                              }
-
-                              if (a.modelIndex != b.modelIndex) {
-                                  return a.modelIndex < b.modelIndex;
-                              }
-
-                              return a.submeshIndex < b.submeshIndex;
-                          });
-
-                vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, m_p_transPipeline->get());
-
-                VulkanMesh* batchMesh = nullptr;
-                uint32_t batchSubmeshIndex = UINT32_MAX;
-                uint32_t batchModelIndex = UINT32_MAX;
-                const auto& [key, value] = *trnasMatrixes.begin();
-                glm::mat4 batchModelMatrix = value;
+                m_p_resources->updateDrawData(data.frameIndex, m_drawData);
 
-                entt::entity batchEntity = entt::null;
-
-                for (const auto& tri : m_transparentTriangles) {
-                    bool stateChange = (tri.mesh != batchMesh ||
-                                        tri.submeshIndex != batchSubmeshIndex ||
-                                        tri.modelIndex != batchModelIndex);
-
-                    if (stateChange && !m_multiDrawInfos.empty()) {
-                        batchMesh->bindAndDrawBatched(
-                            cmd,
-                            m_p_transPipeline->layout(),
-                            *m_p_resources,
-                            m_r_context.currentFrame,
-                            batchModelIndex,
-                            batchSubmeshIndex,
-                            batchModelMatrix,
-                            true,
-                            tri.submeshIndex != batchSubmeshIndex,
-                            registry.get<MeshComponent>(batchEntity)
-
-                        );
+                m_stats.drawsBeforeBatching = static_cast<uint32_t>(m_drawData.size());
+                m_stats.drawsAfterBatching = static_cast<uint32_t>(m_indirectCommands.size());
+            } else {
+                static bool warned = false;
+                if (!warned) {
+                    log(LogLevel::WARNING, "Instance limit (%u) exceeded, falling back to per object draws.", MAX_INDIRECT_DRAWS);
+                    warned = true;
+                }
+            }
 
-                        issueMultiDrawIndexed(cmd, m_multiDrawInfos);
-                        m_multiDrawInfos.clear();
+            buildTransparentBatches(registry);
+
+            // Everything below only appends record tasks, they are recorded in this order either inline or into secondary command buffers.
+            m_recordTasks.clear();
+
+            // Pass scopes wrap first and last task of the pass, so they measure it whether tasks are recorded inline or into secondary buffers.
+            auto addPassScope = [&](const char* name, size_t firstTask) {
+                if (firstTask == m_recordTasks.size()) return;
+                uint32_t scope = m_p_gpuProfiler->reserveScope(name);
+                if (scope == GpuProfiler::NO_SCOPE) return;
+
+                auto& first = m_recordTasks[firstTask].record;
+                first = [this, scope, record = std::move(first)](VkCommandBuffer c) {
+                    m_p_gpuProfiler->writeScopeBegin(c, scope);
+                    record(c);
+                };
+                auto& last = m_recordTasks.back().record;
+                last = [this, scope, record = std::move(last)](VkCommandBuffer c) {
+                    record(c);
+                    m_p_gpuProfiler->writeScopeEnd(c, scope);
+                };
+            };
+
+            auto addInstanceTasks = [&](PipelinePass pass, const IndirectBucket& bucket) {
+                if (bucket.commandCount == 0) return;
+                // Indirect buckets are only a few calls, splitting them would cost more than it saves.
+                uint32_t chunks = m_useIndirectDraw ? 1 : getRecordChunkCount(bucket.commandCount);
+                for (uint32_t chunk = 0; chunk < chunks; chunk++) {
+                    uint32_t first = bucket.firstCommand + static_cast<uint32_t>(uint64_t(bucket.commandCount) * chunk / chunks);
+                    uint32_t last = bucket.firstCommand + static_cast<uint32_t>(uint64_t(bucket.commandCount) * (chunk + 1) / chunks);
+                    m_recordTasks.push_back({ [this, pass, &bucket, first, last, frameIndex = data.frameIndex](VkCommandBuffer c) {
+                        recordInstanceBucket(c, pass, frameIndex, bucket, first, last - first);
+                    }, false });
+                }
+            };
+
+            auto addObjectTask = [&](PipelinePass pass, const std::vector<RenderItem>& queue) {
+                if (queue.empty()) return;
+                m_recordTasks.push_back({ [this, pass, &queue, &registry, frameIndex = data.frameIndex](VkCommandBuffer c) {
+                    VulkanPipeline* boundPipeline = nullptr;
+                    for (const auto& item : queue) {
+                        auto& mesh = registry.get<MeshComponent>(item.entity);
+                        auto& transform = registry.get<TransformComponent>(item.entity);
+                        VulkanMesh* vulkanMesh = m_p_meshManager->getVulkanMesh(mesh.meshHandle);
+
+                        if (vulkanMesh) {
+                            VulkanPipeline* pipeline = m_activePipelines[static_cast<size_t>(passForVertexFormat(pass, vulkanMesh->getVertexFormat()))];
+                            if (pipeline != boundPipeline) {
+                                vkCmdBindPipeline(c, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline->get());
+                                boundPipeline = pipeline;
+                            }
+                            vulkanMesh->draw(c, pipeline->layout(), *m_p_resources, frameIndex, item.modelIndex, transform.getWorldMatrix(), mesh);
+                            m_stats.drawsBeforeBatching += static_cast<uint32_t>(vulkanMesh->getSubmeshCount());
+                        }
                     }
+                }, true });
+            };
 
-                    if (stateChange) {
-                        batchMesh = tri.mesh;
-                        batchSubmeshIndex = tri.submeshIndex;
-                        batchModelIndex = tri.modelIndex;
-                        batchModelMatrix = trnasMatrixes[tri.modelIndex];
-                        batchEntity = tri.entity;
-                    }
+            size_t passStart = m_recordTasks.size();
+            if (useInstancing) [[likely]] {
+                addInstanceTasks(PipelinePass::OPAQUE, opaqueBucket);
+            } else {
+                addObjectTask(PipelinePass::OPAQUE, opaqueQueue);
+            }
+            addPassScope("Opaque", passStart);
 
-                    bool canMerge = !m_multiDrawInfos.empty() && !stateChange;
-                    if (canMerge) {
-                        auto& lastDraw = m_multiDrawInfos.back();
-                        if (tri.firstIndex == (lastDraw.firstIndex + lastDraw.indexCount)) {
-                            lastDraw.indexCount += 3;
-                            continue;
+            #if DEBUG
+            if(isEditorMode){
+                m_recordTasks.push_back({ [this, &registry, cameraEntity, frameIndex = data.frameIndex](VkCommandBuffer c) {
+                    vkCmdBindPipeline(c, VK_PIPELINE_BIND_POINT_GRAPHICS, m_p_pipeline->get());
+                    auto modelView = registry.view<TransformComponent, CameraComponent>();
+                    for (auto entity : modelView) {
+                        if(cameraEntity == entity){
+                            break;
+                        }
+                        auto& transform = modelView.get<TransformComponent>(entity);
+                        glm::vec3 worldScale = transform.getWorldScale();
+                        transform.setWorldScale(glm::vec3(1.f));
+                        if(m_editorCameraVulkanMesh->getNumOfInstances() <= 0){
+                            m_editorCameraMesh.loadFromRawFile("../Assets/meshes/editorCamera.obj");
+                            m_editorCameraVulkanMesh->upload(m_editorCameraMesh);
+                            m_editorCameraVulkanMesh->addInstance();
+                        }else{
+                            auto mc = MeshComponent{};
+                            mc.color = glm::vec4(0.3f, 1.0f, 0.5f, 1.0f);
+                            m_editorCameraVulkanMesh->draw(c, m_p_pipeline->layout(), *m_p_resources, frameIndex, 0, transform.matrix(), mc);
                         }
+                        transform.setWorldScale(worldScale);
                     }
+                }, true });
+            }
+            #endif
 
-                    VkMultiDrawIndexedInfoEXT drawInfo{};
-                    drawInfo.firstIndex = tri.firstIndex;
-                    drawInfo.indexCount = 3;
-                    drawInfo.vertexOffset = 0;
-                    m_multiDrawInfos.push_back(drawInfo);
-                }
-
-                if (!m_multiDrawInfos.empty() && batchMesh != nullptr) {
-                    batchMesh->bindAndDrawBatched(
-                        cmd,
-                        m_p_transPipeline->layout(),
-                        *m_p_resources,
-                        m_r_context.currentFrame,
-                        batchModelIndex,
-                        batchSubmeshIndex,
-                        batchModelMatrix,
-                        true,
-                        true,
-                        registry.get<MeshComponent>(batchEntity)
-                    );
-                    issueMultiDrawIndexed(cmd, m_multiDrawInfos);
+            passStart = m_recordTasks.size();
+            if (useInstancing) [[likely]] {
+                addInstanceTasks(PipelinePass::MASKED, maskedBucket);
+            } else {
+                addObjectTask(PipelinePass::MASKED, maskedQueue);
+            }
+            addPassScope("Masked", passStart);
+
+            passStart = m_recordTasks.size();
+            if (!m_transparentBatches.empty()) {
+                const uint32_t batchCount = static_cast<uint32_t>(m_transparentBatches.size());
+                const uint32_t chunks = getRecordChunkCount(batchCount);
+                for (uint32_t chunk = 0; chunk < chunks; chunk++) {
+                    uint32_t first = static_cast<uint32_t>(uint64_t(batchCount) * chunk / chunks);
+                    uint32_t last = static_cast<uint32_t>(uint64_t(batchCount) * (chunk + 1) / chunks);
+                    m_recordTasks.push_back({ [this, &registry, first, last, frameIndex = data.frameIndex](VkCommandBuffer c) {
+                        recordTransparentBatches(c, frameIndex, registry, first, last - first);
+                    }, false });
                 }
-
-                m_multiDrawInfos.clear();
             }
+            addPassScope("Transparent", passStart);
 
             if (frame != 0) {
                 m_uiObjects.clear();
@@ -702,19 +786,61 @@ namespace vex {
                         m_uiObjects.emplace_back(uiView.get<UiComponent>(entity));
                 }
                 std::sort(m_uiObjects.begin(), m_uiObjects.end(), [](const UiComponent &f, const UiComponent &s) { return f.m_vexUI->getZIndex() < s.m_vexUI->getZIndex(); });
+            }
+
+            bool hasDebugLines = false;
+            #if DEBUG
+                hasDebugLines = debugLines && !debugLines->empty();
+            #endif
 
-                for(const auto& uiObject : m_uiObjects) {
-                    if(uiObject.visible){
-                        uiObject.m_vexUI->render(cmd, m_p_uiPipeline->get(), m_p_uiPipeline->layout(), data.frameIndex);
+            if (!m_uiObjects.empty() || hasDebugLines) {
+                passStart = m_recordTasks.size();
+                m_recordTasks.push_back({ [this, debugLines, frameIndex = data.frameIndex](VkCommandBuffer c) {
+                    for(const auto& uiObject : m_uiObjects) {
+                        if(uiObject.visible){
+                            uiObject.m_vexUI->render(c, m_p_uiPipeline->get(), m_p_uiPipeline->layout(), frameIndex);
+                        }
                     }
-                }
+
+                    #if DEBUG
+                        if(debugLines && !debugLines->empty()) {
+                            renderDebug(c, frameIndex, *debugLines);
+                        }
+                    #endif
+                }, true });
+                addPassScope("UI", passStart);
             }
 
-            #if DEBUG
-                if(debugLines && !debugLines->empty()) {
-                    renderDebug(cmd, data.frameIndex, *debugLines);
+            if (m_p_recorder) {
+                VkFormat colorFormat = m_r_context.lowResColorFormat;
+                VkCommandBufferInheritanceRenderingInfo inheritanceRendering{};
+                inheritanceRendering.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_RENDERING_INFO;
+                inheritanceRendering.colorAttachmentCount = 1;
+                inheritanceRendering.pColorAttachmentFormats = &colorFormat;
+                inheritanceRendering.depthAttachmentFormat = m_r_context.depthFormat;
+                inheritanceRendering.stencilAttachmentFormat = VK_FORMAT_UNDEFINED;
+                inheritanceRendering.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+                for (auto& task : m_recordTasks) {
+                    task.record = [this, record = std::move(task.record)](VkCommandBuffer c) {
+                        bindSceneState(c);
+                        record(c);
+                    };
                 }
-            #endif
+
+                m_p_recorder->record(data.frameIndex, inheritanceRendering, m_recordTasks, m_secondaryBuffers, m_p_gpuProfiler->getInheritedStatistics());
+                if (!m_secondaryBuffers.empty()) {
+                    vkCmdExecuteCommands(cmd, static_cast<uint32_t>(m_secondaryBuffers.size()), m_secondaryBuffers.data());
+                }
+            } else {
+                for (const auto& task : m_recordTasks) {
+                    task.record(cmd);
+                }
+            }
+
+            if (!useInstancing) [[unlikely]] {
+                m_stats.drawsAfterBatching = m_stats.drawsBeforeBatching;
+            }
 
             vkCmdEndRendering(cmd);
 
@@ -754,6 +880,7 @@ namespace vex {
 
         void Renderer::composeFrame(SceneRenderData& data, ImGUIWrapper& ui, bool isEditorMode) {
             VkCommandBuffer cmd = data.commandBuffer;
+            GpuScope composeScope(*m_p_gpuProfiler, cmd, "Compose", true);
 
             transitionImageLayout(cmd, m_r_context.swapchainImages[data.imageIndex],
                                  VK_IMAGE_LAYOUT_UNDEFINED,
@@ -810,7 +937,6 @@ namespace vex {
                 vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, m_p_fullscreenPipeline->get());
 
                 VkDescriptorSet sceneSet = m_p_resources->getUBODescriptorSet(data.frameIndex);
-                uint32_t dynamicOffset = 0;
 
                 vkCmdBindDescriptorSets(
                         cmd,
@@ -819,8 +945,8 @@ namespace vex {
                         0,
                         1,
                         &sceneSet,//&m_r_context.descriptorSets[data.frameIndex],
-                        1,
-                        &dynamicOffset
+                        0,
+                        nullptr
                     );
 
                 vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, m_p_fullscreenPipeline->layout(),
@@ -833,7 +959,7 @@ namespace vex {
 
             transitionImageLayout(cmd, m_r_context.swapchainImages[data.imageIndex],
                                  VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
-                                 VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+                                 m_r_context.getFinalImageLayout(),
                                  VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
                                  0,
                                  VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
@@ -846,6 +972,7 @@ namespace vex {
             //std::cout << "IsValid: " << data.isSwapchainValid << std::endl;
             if (!data.isSwapchainValid) return;
 
+            m_p_gpuProfiler->endFrame(data.commandBuffer);
             vkEndCommandBuffer(data.commandBuffer);
 
             VkSubmitInfo submitInfo{};
@@ -853,37 +980,42 @@ namespace vex {
 
             VkSemaphore waitSemaphores[] = {m_r_context.imageAvailableSemaphores[data.frameIndex]};
             VkPipelineStageFlags waitStages[] = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
-            submitInfo.waitSemaphoreCount = 1;
-            submitInfo.pWaitSemaphores = waitSemaphores;
-            submitInfo.pWaitDstStageMask = waitStages;
+            VkSemaphore signalSemaphores[] = {m_r_context.renderFinishedSemaphores[data.imageIndex]};
             submitInfo.commandBufferCount = 1;
             submitInfo.pCommandBuffers = &data.commandBuffer;
 
-            VkSemaphore signalSemaphores[] = {m_r_context.renderFinishedSemaphores[data.imageIndex]};
-            submitInfo.signalSemaphoreCount = 1;
-            submitInfo.pSignalSemaphores = signalSemaphores;
+            // Headless frames were never acquired and are not presented, the fence is all that tracks them.
+            if (!m_r_context.headless) {
+                submitInfo.waitSemaphoreCount = 1;
+                submitInfo.pWaitSemaphores = waitSemaphores;
+                submitInfo.pWaitDstStageMask = waitStages;
+                submitInfo.signalSemaphoreCount = 1;
+                submitInfo.pSignalSemaphores = signalSemaphores;
+            }
 
             try {
                 if (vkQueueSubmit(m_r_context.graphicsQueue, 1, &submitInfo, m_r_context.inFlightFences[m_r_context.currentFrame]) != VK_SUCCESS) {
                     throw_error("Failed to submit draw command buffer!");
                 }
 
-                VkPresentInfoKHR presentInfo{};
-                presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
-                presentInfo.waitSemaphoreCount = 1;
-                presentInfo.pWaitSemaphores = signalSemaphores;
+                if (!m_r_context.headless) {
+                    VkPresentInfoKHR presentInfo{};
+                    presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
+                    presentInfo.waitSemaphoreCount = 1;
+                    presentInfo.pWaitSemaphores = signalSemaphores;
 
-                VkSwapchainKHR swapchains[] = {m_r_context.swapchain};
-                presentInfo.swapchainCount = 1;
-                presentInfo.pSwapchains = swapchains;
-                presentInfo.pImageIndices = &m_r_context.currentImageIndex;
+                    VkSwapchainKHR swapchains[] = {m_r_context.swapchain};
+                    presentInfo.swapchainCount = 1;
+                    presentInfo.pSwapchains = swapchains;
+                    presentInfo.pImageIndices = &m_r_context.currentImageIndex;
 
-                VkResult result = vkQueuePresentKHR(m_r_context.presentQueue, &presentInfo);
+                    VkResult result = vkQueuePresentKHR(m_r_context.presentQueue, &presentInfo);
 
-                if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR) {
-                    m_p_swapchainManager->recreateSwapchain();
-                } else if (result != VK_SUCCESS) {
-                    throw_error("Failed to present swap chain image!");
+                    if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR) {
+                        m_p_swapchainManager->recreateSwapchain();
+                    } else if (result != VK_SUCCESS) {
+                        throw_error("Failed to present swap chain image!");
+                    }
                 }
             } catch (const std::exception& e) {
                 log(LogLevel::ERROR, "Queue Submit/Present failed");
@@ -949,12 +1081,301 @@ namespace vex {
         );
     }
 
-    void Renderer::issueMultiDrawIndexed(VkCommandBuffer cmd, const std::vector<VkMultiDrawIndexedInfoEXT>& commands) {
-        if (commands.empty()) return;
+    bool Renderer::buildInstanceBucket(const std::vector<RenderItem>& queue, entt::registry& registry, IndirectBucket& outBucket) {
+        m_indirectScratch.clear();
+        TextureStreamer& streamer = m_p_resources->getTextureStreamer();
+
+        for (const auto& item : queue) {
+            auto& mesh = registry.get<MeshComponent>(item.entity);
+            auto& transform = registry.get<TransformComponent>(item.entity);
+            VulkanMesh* vulkanMesh = m_p_meshManager->getVulkanMesh(mesh.meshHandle);
+
+            if (!vulkanMesh) continue;
+
+            const glm::mat4& modelMatrix = transform.getWorldMatrix();
+            const float screenSize = projectedSize(mesh);
+            mesh.lod = selectLod(mesh, *vulkanMesh);
+            for (size_t i = 0; i < vulkanMesh->getSubmeshCount(); i++) {
+                const auto info = vulkanMesh->getSubmeshDrawInfo(i, mesh.lod);
+                if (info.indexCount == 0) continue;
+
+                m_stats.triangles += info.indexCount / 3;
+                m_stats.trianglesFullDetail += vulkanMesh->getSubmeshDrawInfo(i).indexCount / 3;
+
+                IndirectDraw& draw = m_indirectScratch.emplace_back();
+                draw.vertexBuffer = info.vertexBuffer;
+                draw.indexBuffer = info.indexBuffer;
+                draw.format = vulkanMesh->getVertexFormat();
+                draw.indexType = info.indexType;
+                draw.command = { info.indexCount, 1, info.firstIndex, info.vertexOffset, 0 };
+                draw.data.model = vulkanMesh->getDrawMatrix(i, modelMatrix);
+                draw.data.color = mesh.color;
+                draw.data.textureID = static_cast<int>(vulkanMesh->resolveTextureIndex(*m_p_resources, i, mesh));
+                streamer.noteTextureUse(static_cast<uint32_t>(draw.data.textureID), screenSize);
+                m_drewCompactGeometry |= draw.format == VertexFormat::COMPACT;
+            }
+        }
+
+        if (m_drawData.size() + m_indirectScratch.size() > MAX_INDIRECT_DRAWS) [[unlikely]] {
+            return false;
+        }
+
+        // Opaque/masked order doesn't matter thanks to depth testing, so identical geometry can be made adjacent and drawn as instances.
+        // Format goes first so each pass switches between standard and compact pipeline at most once.
+        const bool splitByTexture = !m_r_context.supportsBindlessTextures;
+        std::stable_sort(m_indirectScratch.begin(), m_indirectScratch.end(), [splitByTexture](const IndirectDraw& a, const IndirectDraw& b) {
+            if (a.format != b.format) return a.format < b.format;
+            if (a.vertexBuffer != b.vertexBuffer) return std::less<VkBuffer>{}(a.vertexBuffer, b.vertexBuffer);
+            if (a.indexBuffer != b.indexBuffer) return std::less<VkBuffer>{}(a.indexBuffer, b.indexBuffer);
+            if (a.indexType != b.indexType) return a.indexType < b.indexType;
+            if (a.command.firstIndex != b.command.firstIndex) return a.command.firstIndex < b.command.firstIndex;
+            if (a.command.vertexOffset != b.command.vertexOffset) return a.command.vertexOffset < b.command.vertexOffset;
+            if (a.command.indexCount != b.command.indexCount) return a.command.indexCount < b.command.indexCount;
+            return splitByTexture && a.data.textureID < b.data.textureID;
+        });
+
+        outBucket.firstBatch = static_cast<uint32_t>(m_indirectBatches.size());
+        outBucket.batchCount = 0;
+        outBucket.firstCommand = static_cast<uint32_t>(m_indirectCommands.size());
+
+        for (auto& draw : m_indirectScratch) {
+            const uint32_t instance = static_cast<uint32_t>(m_drawData.size());
+            m_drawData.push_back(draw.data);
+
+            // Offsets of different formats and index types index different elements, they can't share a batch even in the same arena buffers.
+            if (outBucket.batchCount > 0 &&
+                m_indirectBatches.back().vertexBuffer == draw.vertexBuffer &&
+                m_indirectBatches.back().indexBuffer == draw.indexBuffer &&
+                m_indirectBatches.back().format == draw.format &&
+                m_indirectBatches.back().indexType == draw.indexType) {
+                VkDrawIndexedIndirectCommand& last = m_indirectCommands.back();
+                if (last.firstIndex == draw.command.firstIndex &&
+                    last.vertexOffset == draw.command.vertexOffset &&
+                    last.indexCount == draw.command.indexCount &&
+                    (!splitByTexture || m_drawData[last.firstInstance].textureID == draw.data.textureID)) {
+                    last.instanceCount++;
+                    continue;
+                }
+            } else {
+                m_indirectBatches.push_back({ draw.vertexBuffer, draw.indexBuffer, draw.format, draw.indexType, static_cast<uint32_t>(m_indirectCommands.size()), 0 });
+                outBucket.batchCount++;
+            }
+
+            draw.command.firstInstance = instance;
+            m_indirectCommands.push_back(draw.command);
+            m_indirectBatches.back().drawCount++;
+        }
+
+        outBucket.commandCount = static_cast<uint32_t>(m_indirectCommands.size()) - outBucket.firstCommand;
+        return true;
+    }
+
+    void Renderer::recordInstanceBucket(VkCommandBuffer cmd, PipelinePass pass, uint32_t frameIndex, const IndirectBucket& bucket, uint32_t firstCommand, uint32_t commandCount) {
+        if (bucket.batchCount == 0 || commandCount == 0) return;
+
+        // Standard and compact pipelines of a pass share the layout, so descriptors and push constants survive pipeline switches.
+        const VkPipelineLayout pipelineLayout = m_activePipelines[static_cast<size_t>(pass)]->layout();
+        VulkanPipeline* boundPipeline = nullptr;
+
+        VkDescriptorSet globalSet = m_p_resources->getDescriptorSet(frameIndex);
+        vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1, &globalSet, 0, nullptr);
+
+        PushConstants drawPush{};
+        drawPush.useDrawData = 1;
+        vkCmdPushConstants(cmd, pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(PushConstants), &drawPush);
+
+        const uint32_t stride = sizeof(VkDrawIndexedIndirectCommand);
+        const uint32_t maxCount = std::max(m_r_context.maxDrawIndirectCount, 1u);
+        const uint32_t endCommand = firstCommand + commandCount;
+        int currentTexture = -1;
+
+        for (uint32_t b = bucket.firstBatch; b < bucket.firstBatch + bucket.batchCount; b++) {
+            const IndirectBatch& batch = m_indirectBatches[b];
+            const uint32_t batchBegin = std::max(batch.firstCommand, firstCommand);
+            const uint32_t batchEnd = std::min(batch.firstCommand + batch.drawCount, endCommand);
+            if (batchBegin >= batchEnd) continue;
+
+            VulkanPipeline* pipeline = m_activePipelines[static_cast<size_t>(passForVertexFormat(pass, batch.format))];
+            if (pipeline != boundPipeline) {
+                vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline->get());
+                boundPipeline = pipeline;
+            }
+
+            VkDeviceSize offset = 0;
+            vkCmdBindVertexBuffers(cmd, 0, 1, &batch.vertexBuffer, &offset);
+            vkCmdBindIndexBuffer(cmd, batch.indexBuffer, 0, batch.indexType);
+
+            if (m_useIndirectDraw) [[likely]] {
+                uint32_t first = batchBegin;
+                uint32_t remaining = batchEnd - batchBegin;
+                while (remaining > 0) {
+                    uint32_t count = std::min(remaining, maxCount);
+                    vkCmdDrawIndexedIndirect(cmd, m_indirectBuffers[frameIndex], static_cast<VkDeviceSize>(first) * stride, count, stride);
+                    first += count;
+                    remaining -= count;
+                }
+                continue;
+            }
+
+            for (uint32_t c = batchBegin; c < batchEnd; c++) {
+                const VkDrawIndexedIndirectCommand& command = m_indirectCommands[c];
+
+                if (!m_r_context.supportsBindlessTextures) {
+                    int textureIndex = m_drawData[command.firstInstance].textureID;
+                    if (textureIndex != currentTexture) {
+                        VkDescriptorSet texSet = m_p_resources->getTextureDescriptorSet(frameIndex, static_cast<uint32_t>(textureIndex));
+                        vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 1, 1, &texSet, 0, nullptr);
+                        currentTexture = textureIndex;
+                    }
+                }
+
+                vkCmdDrawIndexed(cmd, command.indexCount, command.instanceCount, command.firstIndex, command.vertexOffset, command.firstInstance);
+            }
+        }
+    }
+
+    float Renderer::projectedSize(const MeshComponent& mesh) const {
+        const float distance = glm::length(mesh.worldCenter - m_cameraPosition);
+        return mesh.worldRadius / std::max({ distance, mesh.worldRadius, 0.001f }) * m_projectedSizeScale;
+    }
+
+    uint32_t Renderer::selectLod(const MeshComponent& mesh, const VulkanMesh& vulkanMesh) const {
+        const uint32_t lodCount = vulkanMesh.getLodCount();
+        const float threshold = m_r_context.m_enviroment.lodErrorPixels;
+        if (lodCount <= 1 || threshold <= 0.0f || mesh.localRadius <= 0.0f) return 0;
+
+        // Errors are in mesh units, they scale to world and onto the screen exactly like the bounding radius does.
+        const float pixelsPerUnit = projectedSize(mesh) * 0.5f / mesh.localRadius;
+        auto errorPixels = [&](uint32_t lod) { return vulkanMesh.getLodError(lod) * pixelsPerUnit; };
+
+        uint32_t lod = std::min(mesh.lod, lodCount - 1);
+        while (lod > 0 && errorPixels(lod) > threshold) {
+            lod--;
+        }
+        while (lod + 1 < lodCount && errorPixels(lod + 1) <= threshold * (1.0f - LOD_HYSTERESIS)) {
+            lod++;
+        }
+        return lod;
+    }
+
+    void Renderer::buildTransparentBatches(entt::registry& registry) {
+        m_transparentBatches.clear();
+        m_multiDrawInfos.clear();
+
+        for (const auto& tri : m_transparentTriangles) {
+            // Transparent meshes always use full detail, they are sorted with the CPU copy of its triangles.
+            m_stats.triangles += tri.indexCount / 3;
+            m_stats.trianglesFullDetail += tri.indexCount / 3;
+
+            bool stateChange = m_transparentBatches.empty() ||
+                               tri.mesh != m_transparentBatches.back().mesh ||
+                               tri.submeshIndex != m_transparentBatches.back().submeshIndex ||
+                               tri.modelIndex != m_transparentBatches.back().modelIndex;
+
+            if (stateChange) {
+                TransparentBatch& batch = m_transparentBatches.emplace_back();
+                batch.mesh = tri.mesh;
+                batch.submeshIndex = tri.submeshIndex;
+                batch.modelIndex = tri.modelIndex;
+                batch.entity = tri.entity;
+                batch.modelMatrix = trnasMatrixes[tri.modelIndex];
+                const auto& meshComponent = registry.get<MeshComponent>(tri.entity);
+                batch.textureIndex = tri.mesh->resolveTextureIndex(*m_p_resources, tri.submeshIndex, meshComponent);
+                m_p_resources->getTextureStreamer().noteTextureUse(batch.textureIndex, projectedSize(meshComponent));
+                m_drewCompactGeometry |= tri.mesh->getVertexFormat() == VertexFormat::COMPACT;
+                batch.firstDraw = static_cast<uint32_t>(m_multiDrawInfos.size());
+                batch.drawCount = 0;
+            } else {
+                auto& lastDraw = m_multiDrawInfos.back();
+                if (tri.firstIndex == (lastDraw.firstIndex + lastDraw.indexCount)) {
+                    lastDraw.indexCount += tri.indexCount;
+                    continue;
+                }
+            }
+
+            VkMultiDrawIndexedInfoEXT drawInfo{};
+            drawInfo.firstIndex = tri.firstIndex;
+            drawInfo.indexCount = tri.indexCount;
+            drawInfo.vertexOffset = tri.mesh->getSubmeshDrawInfo(tri.submeshIndex).vertexOffset;
+            m_multiDrawInfos.push_back(drawInfo);
+            m_transparentBatches.back().drawCount++;
+        }
+    }
+
+    void Renderer::recordTransparentBatches(VkCommandBuffer cmd, uint32_t frameIndex, entt::registry& registry, uint32_t firstBatch, uint32_t batchCount) {
+        if (batchCount == 0) return;
+
+        VulkanPipeline* boundPipeline = nullptr;
+
+        for (uint32_t b = firstBatch; b < firstBatch + batchCount; b++) {
+            const TransparentBatch& batch = m_transparentBatches[b];
+
+            VulkanPipeline* pipeline = m_activePipelines[static_cast<size_t>(passForVertexFormat(PipelinePass::TRANSPARENT, batch.mesh->getVertexFormat()))];
+            if (pipeline != boundPipeline) {
+                vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline->get());
+                boundPipeline = pipeline;
+            }
+
+            batch.mesh->bindAndDrawBatched(
+                cmd,
+                pipeline->layout(),
+                *m_p_resources,
+                frameIndex,
+                batch.modelIndex,
+                batch.submeshIndex,
+                batch.textureIndex,
+                batch.modelMatrix,
+                true,
+                b == firstBatch || batch.submeshIndex != m_transparentBatches[b - 1].submeshIndex,
+                registry.get<MeshComponent>(batch.entity)
+            );
+
+            issueMultiDrawIndexed(cmd, m_multiDrawInfos.data() + batch.firstDraw, batch.drawCount);
+        }
+    }
+
+    void Renderer::bindSceneState(VkCommandBuffer cmd) {
+        VkViewport viewport{};
+        viewport.width = (float)m_r_context.currentRenderResolution.x;
+        viewport.height = (float)m_r_context.currentRenderResolution.y;
+        viewport.minDepth = 0.0f; viewport.maxDepth = 1.0f;
+        vkCmdSetViewport(cmd, 0, 1, &viewport);
+
+        VkRect2D scissor{};
+        scissor.extent = {m_r_context.currentRenderResolution.x, m_r_context.currentRenderResolution.y};
+        vkCmdSetScissor(cmd, 0, 1, &scissor);
+
+        if (m_r_context.supportsBindlessTextures) {
+            VkDescriptorSet bindlessSet = m_p_resources->getBindlessDescriptorSet();
+            vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, m_p_pipeline->layout(),
+                                    1, 1, &bindlessSet, 0, nullptr);
+        }
+    }
+
+    uint32_t Renderer::getRecordChunkCount(uint32_t itemCount) const {
+        if (!m_p_recorder) return 1;
+        uint32_t chunks = (itemCount + MIN_DRAWS_PER_RECORD_TASK - 1) / MIN_DRAWS_PER_RECORD_TASK;
+        return std::clamp(chunks, 1u, m_p_recorder->getThreadCount());
+    }
+
+    void Renderer::setRecordThreadCount(uint32_t count) {
+        count = std::clamp(count, 1u, MAX_RECORD_THREADS);
+        if (count == getRecordThreadCount()) return;
+
+        m_r_context.waitIdle();
+        m_p_recorder.reset();
+        if (count > 1) {
+            m_p_recorder = std::make_unique<ParallelCommandRecorder>(m_r_context, count);
+        }
+        log("Scene recording threads: %u", count);
+    }
+
+    void Renderer::issueMultiDrawIndexed(VkCommandBuffer cmd, const VkMultiDrawIndexedInfoEXT* commands, uint32_t commandCount) {
+        if (commandCount == 0) return;
 
         if (m_r_context.supportsMultiDraw && m_r_context.maxMultiDrawCount > 0) [[likely]] {
             const uint32_t limit = m_r_context.maxMultiDrawCount;
-            size_t remaining = commands.size();
+            size_t remaining = commandCount;
             size_t offset = 0;
 
             while (remaining > 0) {
@@ -963,7 +1384,7 @@ namespace vex {
                 vkCmdDrawMultiIndexedEXT(
                     cmd,
                     count,
-                    commands.data() + offset,
+                    commands + offset,
                     1,
                     0,
                     static_cast<uint32_t>(sizeof(VkMultiDrawIndexedInfoEXT)),
@@ -976,12 +1397,12 @@ namespace vex {
             return;
         }
 
-        if(basicDiag) [[unlikely]] {
-            log(LogLevel::WARNING, "MultiDraw fallback active. Count: %zu", commands.size());
-            basicDiag = false;
+        if(basicDiag.exchange(false)) [[unlikely]] {
+            log(LogLevel::WARNING, "MultiDraw fallback active. Count: %u", commandCount);
         }
 
-        for (const auto& draw : commands) {
+        for (uint32_t i = 0; i < commandCount; i++) {
+            const auto& draw = commands[i];
             vkCmdDrawIndexed(cmd, draw.indexCount, 1, draw.firstIndex, draw.vertexOffset, 0);
         }
     }
@@ -16,9 +16,15 @@
 #include "components/UI/VexUI.hpp"
 #include "MeshManager.hpp"
 #include "PhysicsDebug.hpp"
+#include "ClusteredLighting.hpp"
+#include "CommandRecorder.hpp"
+#include "TransparencySorter.hpp"
+#include "PipelinePermutations.hpp"
+#include "GpuProfiler.hpp"
 #include "entt/entity/fwd.hpp"
 #include <glm/glm.hpp>
 #include <chrono>
+#include <atomic>
 #include <components/GameComponents/UiComponent.hpp>
 
 namespace vex {
@@ -28,6 +34,58 @@ namespace vex {
         uint32_t modelIndex;
     };
 
+    /// @brief Range of instanced draw commands sharing the same vertex and index buffer, vertex format and index type.
+    struct IndirectBatch {
+        VkBuffer vertexBuffer;
+        VkBuffer indexBuffer;
+        VertexFormat format;
+        VkIndexType indexType;
+        uint32_t firstCommand;
+        uint32_t drawCount;
+    };
+
+    /// @brief Range of indirect batches recorded with the pipelines of a single pass.
+    struct IndirectBucket {
+        uint32_t firstBatch = 0;
+        uint32_t batchCount = 0;
+        uint32_t firstCommand = 0;
+        uint32_t commandCount = 0;
+    };
+
+    /// @brief Run of sorted transparent triangles drawn with the same mesh, submesh and model.
+    struct TransparentBatch {
+        VulkanMesh* mesh;
+        uint32_t submeshIndex;
+        uint32_t modelIndex;
+        uint32_t textureIndex;
+        entt::entity entity;
+        glm::mat4 modelMatrix;
+        uint32_t firstDraw;
+        uint32_t drawCount;
+    };
+
+    /// @brief Draw counters of the last rendered frame.
+    struct RenderStats {
+        /// @brief Opaque, masked and transparent entities that passed frustum culling.
+        uint32_t visibleObjects = 0;
+        /// @brief Opaque and masked submesh draws before instancing, one per visible submesh.
+        uint32_t drawsBeforeBatching = 0;
+        /// @brief Opaque and masked draws after identical geometry was merged into instanced draws.
+        uint32_t drawsAfterBatching = 0;
+        /// @brief Transparent entries sorted this frame, triangles or whole submeshes depending on `enviroment::perTriangleTransparency`.
+        uint32_t transparentTriangles = 0;
+        /// @brief Transparent order was refined from last frame instead of sorted from scratch.
+        bool transparentOrderReused = false;
+        /// @brief Scene passes drawn with pipelines specialized for current PS1 effect mask.
+        uint32_t specializedPasses = 0;
+        /// @brief Device or queue idle waits since the previous frame began, should stay 0 while nothing is loaded or resized.
+        uint32_t idleWaits = 0;
+        /// @brief Triangles submitted by scene passes, after level of detail selection.
+        uint32_t triangles = 0;
+        /// @brief Triangles the same draws would have submitted at full detail.
+        uint32_t trianglesFullDetail = 0;
+    };
+
     /// @brief Data structure to pass state between render stages
         struct SceneRenderData {
             VkCommandBuffer commandBuffer;
@@ -47,6 +105,9 @@ namespace vex {
         /// @param std::unique_ptr<VulkanPipeline>& pipeline - Standard Opaque pipeline.
         /// @param std::unique_ptr<VulkanPipeline>& transPipeline - Transparent pipeline.
         /// @param std::unique_ptr<VulkanPipeline>& maskPipeline - Masked pipeline (alpha cutout).
+        /// @param std::unique_ptr<VulkanPipeline>& compactPipeline - Opaque pipeline for `VertexFormat::COMPACT` meshes.
+        /// @param std::unique_ptr<VulkanPipeline>& compactTransPipeline - Transparent pipeline for `VertexFormat::COMPACT` meshes.
+        /// @param std::unique_ptr<VulkanPipeline>& compactMaskPipeline - Masked pipeline for `VertexFormat::COMPACT` meshes.
         /// @param std::unique_ptr<VulkanPipeline>& uiPipeline - User Interface pipeline.
         /// @param std::unique_ptr<VulkanPipeline>& fullscreenPipeline - Fullscreen/Post-process pipeline.
         /// @param std::unique_ptr<VulkanSwapchainManager>& swapchainManager - Swapchain manager.
@@ -56,6 +117,9 @@ namespace vex {
                  std::unique_ptr<VulkanPipeline>& pipeline,
                  std::unique_ptr<VulkanPipeline>& transPipeline,
                  std::unique_ptr<VulkanPipeline>& maskPipeline,
+                 std::unique_ptr<VulkanPipeline>& compactPipeline,
+                 std::unique_ptr<VulkanPipeline>& compactTransPipeline,
+                 std::unique_ptr<VulkanPipeline>& compactMaskPipeline,
                  std::unique_ptr<VulkanPipeline>& uiPipeline,
                  std::unique_ptr<VulkanPipeline>& fullscreenPipeline,
                  std::unique_ptr<VulkanSwapchainManager>& swapchainManager,
@@ -67,6 +131,7 @@ namespace vex {
 
         /// @brief Prepares the frame for rendering.
         /// @details handles Swapchain recreation (if resolution changed), waits for fences, acquires the next image, and begins the command buffer.
+        /// In headless mode nothing is acquired, the frame slot renders into its own offscreen image.
         /// @param glm::uvec2 renderResolution - The desired resolution for the low-res render target.
         /// @param SceneRenderData& outData - Output struct filled with current frame context (cmd buffer, frame index).
         /// @return bool - True if frame acquisition was successful, False if swapchain needs regeneration.
@@ -76,9 +141,9 @@ namespace vex {
         /// @details
         /// 1. Updates Scene UBO (View/Proj, PS1 effects like jitter/snapping).
         /// 2. Performs frustum culling on objects.
-        /// 3. Updates Light UBOs for visible objects.
+        /// 3. Uploads scene lights once and assigns them to light clusters.
         /// 4. Sorts objects into Opaque, Masked, and Transparent queues.
-        /// 5. Executes draw calls (using MultiDraw for transparency if supported).
+        /// 5. Executes draw calls (instanced for opaque/masked, MultiDraw for transparency if supported).
         /// 6. Renders UI components on top.
         /// @param SceneRenderData& data - Frame context data.
         /// @param const entt::entity cameraEntity - The active camera entity.
@@ -112,9 +177,39 @@ namespace vex {
 
         /// @brief Submits the command buffer and presents the image.
         /// @details Submits to the Graphics Queue and calls `vkQueuePresentKHR`. Handles `VK_ERROR_OUT_OF_DATE_KHR` by triggering swapchain recreation.
+        /// In headless mode the frame is only submitted and its image is left in transfer source layout for `Interface::readbackFrame`.
         /// @param SceneRenderData& data - Frame context data.
         void endFrame(SceneRenderData& data);
 
+        /// @brief Sets number of threads recording scene draws.
+        /// @details With more than one thread opaque, masked and transparent draws are split into chunks recorded into secondary command buffers
+        /// and executed in a fixed order, so the result doesn't depend on thread timing. One records everything inline into the primary command buffer.
+        /// Waits for the GPU to go idle if the count changes.
+        /// @param uint32_t count - Thread count including the render thread, clamped to `MAX_RECORD_THREADS`.
+        void setRecordThreadCount(uint32_t count);
+
+        /// @brief Returns number of threads recording scene draws.
+        /// @return uint32_t
+        uint32_t getRecordThreadCount() const { return m_p_recorder ? m_p_recorder->getThreadCount() : 1; }
+
+        /// @brief Returns cache of PS1 effect specialized pipelines, Interface registers pass recipes in it.
+        /// @return PipelinePermutationCache&
+        PipelinePermutationCache& getPipelinePermutations() { return *m_p_permutations; }
+
+        /// @brief Enables drawing opaque, masked and transparent passes with pipelines specialized for current PS1 effect mask.
+        /// @details Specialized pipelines are built in background on first use of a mask, until then the uber shader pipelines are used.
+        /// @param bool enabled
+        void setShaderSpecialization(bool enabled) { m_useSpecializedPipelines = enabled; }
+
+        /// @brief Returns draw counters of the last rendered frame.
+        /// @return const RenderStats&
+        const RenderStats& getStats() const { return m_stats; }
+
+        /// @brief Returns GPU profiler measuring frame, scene passes and compose.
+        /// @details Timings trail the rendered frame by `MAX_FRAMES_IN_FLIGHT` frames.
+        /// @return GpuProfiler&
+        GpuProfiler& getGpuProfiler() { return *m_p_gpuProfiler; }
+
         #if DEBUG
             /// @brief Sets the debug pipeline used for wireframe/line rendering.
             /// @param std::unique_ptr<VulkanPipeline>* pipeline - Pointer to the pipeline pointer.
@@ -146,8 +241,63 @@ namespace vex {
 
         /// @brief Issues a multi-draw indexed command used by transparent meshes since they are drawn triangle by triangle.
         /// @param VkCommandBuffer cmd - Command buffer.
-        /// @param const std::vector<VkMultiDrawIndexedInfoEXT>& commands - Vector of multi-draw indexed commands.
-        void issueMultiDrawIndexed(VkCommandBuffer cmd, const std::vector<VkMultiDrawIndexedInfoEXT>& commands);
+        /// @param const VkMultiDrawIndexedInfoEXT* commands - Multi-draw indexed commands.
+        /// @param uint32_t count - Number of commands.
+        void issueMultiDrawIndexed(VkCommandBuffer cmd, const VkMultiDrawIndexedInfoEXT* commands, uint32_t count);
+
+        /// @brief Builds instanced draw commands and per instance draw data for every submesh in a render queue.
+        /// @details Submeshes with the same geometry are merged into one command, its instances get consecutive `DrawData` starting at firstInstance.
+        /// Without bindless textures the texture is part of the key too, since it's bound per draw. Commands are then grouped by geometry buffers.
+        /// @param const std::vector<RenderItem>& queue - Visible items of one pipeline bucket.
+        /// @param entt::registry& registry - ECS registry.
+        /// @param IndirectBucket& outBucket - Range of batches written for this queue.
+        /// @return bool - False if `MAX_INDIRECT_DRAWS` instances were exceeded.
+        bool buildInstanceBucket(const std::vector<RenderItem>& queue, entt::registry& registry, IndirectBucket& outBucket);
+
+        /// @brief Records part of a bucket built by `buildInstanceBucket`.
+        /// @details Binds the active pipeline of `pass` matching vertex format of each batch. Uses `vkCmdDrawIndexedIndirect` when available, otherwise one instanced `vkCmdDrawIndexed` per command.
+        /// Only reads prepared data, so different ranges can be recorded from different threads.
+        /// @param VkCommandBuffer cmd - Command buffer.
+        /// @param PipelinePass pass - Standard vertex pass of the bucket.
+        /// @param uint32_t frameIndex - Current frame index.
+        /// @param const IndirectBucket& bucket - Batches to draw.
+        /// @param uint32_t firstCommand - First command to record (absolute index).
+        /// @param uint32_t commandCount - Number of commands to record.
+        void recordInstanceBucket(VkCommandBuffer cmd, PipelinePass pass, uint32_t frameIndex, const IndirectBucket& bucket, uint32_t firstCommand, uint32_t commandCount);
+
+        /// @brief Returns approximate diameter of a mesh on screen in pixels, reported to `TextureStreamer` for every textured draw.
+        /// @param const MeshComponent& mesh - Mesh with up to date world bounds.
+        /// @return float
+        float projectedSize(const MeshComponent& mesh) const;
+
+        /// @brief Picks level of detail of a mesh, the coarsest one whose error projects under `enviroment::lodErrorPixels`.
+        /// @details Starts from `MeshComponent::lod` of last frame, refines as soon as its error is over the threshold but coarsens only
+        /// when the next level is `LOD_HYSTERESIS` below it, so meshes near the boundary don't switch back and forth.
+        /// @param const MeshComponent& mesh - Mesh with up to date world bounds.
+        /// @param const VulkanMesh& vulkanMesh - Its uploaded geometry.
+        /// @return uint32_t
+        uint32_t selectLod(const MeshComponent& mesh, const VulkanMesh& vulkanMesh) const;
+
+        /// @brief Groups sorted transparent triangles into `m_transparentBatches` and `m_multiDrawInfos`, resolving textures on the render thread.
+        /// @param entt::registry& registry - ECS registry.
+        void buildTransparentBatches(entt::registry& registry);
+
+        /// @brief Records a range of transparent batches, binds the transparent pipeline matching vertex format of each batch.
+        /// @param VkCommandBuffer cmd - Command buffer.
+        /// @param uint32_t frameIndex - Current frame index.
+        /// @param entt::registry& registry - ECS registry (read only).
+        /// @param uint32_t firstBatch - First batch to record.
+        /// @param uint32_t batchCount - Number of batches to record.
+        void recordTransparentBatches(VkCommandBuffer cmd, uint32_t frameIndex, entt::registry& registry, uint32_t firstBatch, uint32_t batchCount);
+
+        /// @brief Sets viewport, scissor and bindless textures, needed at the start of every secondary command buffer.
+        /// @param VkCommandBuffer cmd - Command buffer.
+        void bindSceneState(VkCommandBuffer cmd);
+
+        /// @brief Returns into how many record tasks `itemCount` draws should be split.
+        /// @param uint32_t itemCount - Number of draws or batches.
+        /// @return uint32_t
+        uint32_t getRecordChunkCount(uint32_t itemCount) const;
 
         /// @brief Updates the screen descriptor.
         /// @param VkImageView view - Image view.
@@ -158,6 +308,9 @@ namespace vex {
         std::unique_ptr<VulkanPipeline>& m_p_pipeline;
         std::unique_ptr<VulkanPipeline>& m_p_transPipeline;
         std::unique_ptr<VulkanPipeline>& m_p_maskPipeline;
+        std::unique_ptr<VulkanPipeline>& m_p_compactPipeline;
+        std::unique_ptr<VulkanPipeline>& m_p_compactTransPipeline;
+        std::unique_ptr<VulkanPipeline>& m_p_compactMaskPipeline;
         std::unique_ptr<VulkanPipeline>& m_p_uiPipeline;
         std::unique_ptr<VulkanPipeline>& m_p_fullscreenPipeline;
         std::unique_ptr<VulkanSwapchainManager>& m_p_swapchainManager;
@@ -166,16 +319,22 @@ namespace vex {
         std::chrono::high_resolution_clock::time_point startTime;
         float currentTime = 0.0f;
 
-        bool basicDiag = true;
+        std::atomic<bool> basicDiag = true;
 
+        std::vector<TransparentObject> m_transparentObjects;
+        TransparencySorter m_transparencySorter;
         std::vector<TransparentTriangle> m_transparentTriangles;
         std::map<uint32_t, glm::mat4> trnasMatrixes;
         std::vector<UiComponent> m_uiObjects;
         std::vector<VkMultiDrawIndexedInfoEXT> m_multiDrawInfos;
+        std::vector<TransparentBatch> m_transparentBatches;
         size_t approxTriangles = 0;
 
         SceneUBO m_sceneUBO;
 
+        std::vector<Light> m_sceneLights;
+        LightClusterGrid m_lightClusters;
+
         VkDescriptorSet m_screenDescriptorSet = VK_NULL_HANDLE;
         VkSampler m_screenSampler = VK_NULL_HANDLE;
         VkImageView m_lastUsedView = VK_NULL_HANDLE;
@@ -183,11 +342,45 @@ namespace vex {
         std::vector<std::vector<VkDescriptorSet>> m_garbageDescriptors;
         VkDescriptorPool m_localPool = VK_NULL_HANDLE;
 
+        std::vector<entt::entity> m_visibleEntities;
+        glm::vec3 m_cameraPosition = glm::vec3(0.0f);
+        float m_projectedSizeScale = 0.0f; // render height / tan(fov / 2), set every renderScene
         std::vector<RenderItem> opaqueQueue;
         std::vector<RenderItem> maskedQueue;
 
         std::vector<VkBuffer> m_indirectBuffers;
         std::vector<VmaAllocation> m_indirectAllocations;
+        std::vector<void*> m_indirectMapped;
+
+        /// @brief Submesh draw waiting to be merged into instanced commands.
+        struct IndirectDraw {
+            VkBuffer vertexBuffer;
+            VkBuffer indexBuffer;
+            VertexFormat format;
+            VkIndexType indexType;
+            VkDrawIndexedIndirectCommand command;
+            DrawData data;
+        };
+
+        bool m_useIndirectDraw = false;
+        std::vector<IndirectDraw> m_indirectScratch;
+        std::vector<VkDrawIndexedIndirectCommand> m_indirectCommands;
+        std::vector<IndirectBatch> m_indirectBatches;
+        std::vector<DrawData> m_drawData;
+
+        RenderStats m_stats;
+        uint32_t m_lastIdleWaits = 0;
+
+        std::unique_ptr<PipelinePermutationCache> m_p_permutations;
+        bool m_useSpecializedPipelines = true;
+        std::array<VulkanPipeline*, static_cast<size_t>(PipelinePass::COUNT)> m_activePipelines{};
+        bool m_drewCompactGeometry = false; // compact permutations are only requested once compact meshes are on screen
+
+        std::unique_ptr<GpuProfiler> m_p_gpuProfiler;
+
+        std::unique_ptr<ParallelCommandRecorder> m_p_recorder;
+        std::vector<RecordTask> m_recordTasks;
+        std::vector<VkCommandBuffer> m_secondaryBuffers;
 
         #if DEBUG
             std::vector<VkBuffer> m_debugBuffers;
@@ -4,6 +4,7 @@
 #include <vk_mem_alloc.h>
 #include <SDL3/SDL_vulkan.h>
 #include <algorithm>
+#include <thread>
 #include "components/backends/vulkan/uniforms.hpp"
 #include "components/pathUtils.hpp"
 #include "limits.hpp"
@@ -13,14 +14,19 @@
 
 namespace vex {
     VulkanResources::VulkanResources(VulkanContext& context, VirtualFileSystem* vfs) : m_r_context(context), m_vfs(vfs) {
+        m_textureGenerations.assign(MAX_TEXTURES, 0);
         createDefaultTexture();
         createTextureSampler();
         createUniformBuffers();
         createDescriptorResources();
+        m_p_textureLoader = std::make_unique<AsyncTextureLoader>(m_r_context, m_vfs);
+        m_p_textureStreamer = std::make_unique<TextureStreamer>(m_r_context);
     }
 
     VulkanResources::~VulkanResources() {
-        vkDeviceWaitIdle(m_r_context.device);
+        m_r_context.waitIdle();
+        m_p_textureLoader.reset();
+        m_p_textureStreamer.reset();
 
         if (m_textureSampler != VK_NULL_HANDLE) {
             vkDestroySampler(m_r_context.device, m_textureSampler, nullptr);
@@ -33,9 +39,25 @@ namespace vex {
                 m_sceneBuffers[i] = VK_NULL_HANDLE;
             }
             if (m_lightBuffers[i] != VK_NULL_HANDLE) {
+                vmaUnmapMemory(m_r_context.allocator, m_lightAllocs[i]);
                 vmaDestroyBuffer(m_r_context.allocator, m_lightBuffers[i], m_lightAllocs[i]);
                 m_lightBuffers[i] = VK_NULL_HANDLE;
             }
+            if (m_clusterBuffers[i] != VK_NULL_HANDLE) {
+                vmaUnmapMemory(m_r_context.allocator, m_clusterAllocs[i]);
+                vmaDestroyBuffer(m_r_context.allocator, m_clusterBuffers[i], m_clusterAllocs[i]);
+                m_clusterBuffers[i] = VK_NULL_HANDLE;
+            }
+            if (m_clusterIndexBuffers[i] != VK_NULL_HANDLE) {
+                vmaUnmapMemory(m_r_context.allocator, m_clusterIndexAllocs[i]);
+                vmaDestroyBuffer(m_r_context.allocator, m_clusterIndexBuffers[i], m_clusterIndexAllocs[i]);
+                m_clusterIndexBuffers[i] = VK_NULL_HANDLE;
+            }
+            if (m_drawDataBuffers[i] != VK_NULL_HANDLE) {
+                vmaUnmapMemory(m_r_context.allocator, m_drawDataAllocs[i]);
+                vmaDestroyBuffer(m_r_context.allocator, m_drawDataBuffers[i], m_drawDataAllocs[i]);
+                m_drawDataBuffers[i] = VK_NULL_HANDLE;
+            }
         }
 
         for (auto const& [name, image] : m_textureImages) {
@@ -232,6 +254,16 @@ namespace vex {
         m_sceneAllocs.resize(m_r_context.MAX_FRAMES_IN_FLIGHT);
         m_lightBuffers.resize(m_r_context.MAX_FRAMES_IN_FLIGHT);
         m_lightAllocs.resize(m_r_context.MAX_FRAMES_IN_FLIGHT);
+        m_lightMapped.resize(m_r_context.MAX_FRAMES_IN_FLIGHT);
+        m_clusterBuffers.resize(m_r_context.MAX_FRAMES_IN_FLIGHT);
+        m_clusterAllocs.resize(m_r_context.MAX_FRAMES_IN_FLIGHT);
+        m_clusterMapped.resize(m_r_context.MAX_FRAMES_IN_FLIGHT);
+        m_clusterIndexBuffers.resize(m_r_context.MAX_FRAMES_IN_FLIGHT);
+        m_clusterIndexAllocs.resize(m_r_context.MAX_FRAMES_IN_FLIGHT);
+        m_clusterIndexMapped.resize(m_r_context.MAX_FRAMES_IN_FLIGHT);
+        m_drawDataBuffers.resize(m_r_context.MAX_FRAMES_IN_FLIGHT);
+        m_drawDataAllocs.resize(m_r_context.MAX_FRAMES_IN_FLIGHT);
+        m_drawDataMapped.resize(m_r_context.MAX_FRAMES_IN_FLIGHT);
 
         VkBufferCreateInfo bufferInfo{};
         bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
@@ -245,24 +277,48 @@ namespace vex {
             vmaCreateBuffer(m_r_context.allocator, &bufferInfo, &allocInfo,
                           &m_sceneBuffers[i], &m_sceneAllocs[i], nullptr);
 
-            bufferInfo.size = sizeof(SceneLightsUBO) * MAX_MODELS;
+        }
+
+        // Lights and clusters are rewritten every frame, so they stay mapped for the whole lifetime.
+        bufferInfo.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+        for (size_t i = 0; i < m_r_context.MAX_FRAMES_IN_FLIGHT; i++) {
+            bufferInfo.size = sizeof(Light) * MAX_SCENE_LIGHTS;
             vmaCreateBuffer(m_r_context.allocator, &bufferInfo, &allocInfo,
                             &m_lightBuffers[i], &m_lightAllocs[i], nullptr);
+            vmaMapMemory(m_r_context.allocator, m_lightAllocs[i], &m_lightMapped[i]);
+
+            bufferInfo.size = sizeof(LightCluster) * CLUSTER_COUNT;
+            vmaCreateBuffer(m_r_context.allocator, &bufferInfo, &allocInfo,
+                            &m_clusterBuffers[i], &m_clusterAllocs[i], nullptr);
+            vmaMapMemory(m_r_context.allocator, m_clusterAllocs[i], &m_clusterMapped[i]);
+
+            bufferInfo.size = sizeof(uint32_t) * MAX_CLUSTER_LIGHT_INDICES;
+            vmaCreateBuffer(m_r_context.allocator, &bufferInfo, &allocInfo,
+                            &m_clusterIndexBuffers[i], &m_clusterIndexAllocs[i], nullptr);
+            vmaMapMemory(m_r_context.allocator, m_clusterIndexAllocs[i], &m_clusterIndexMapped[i]);
+
+            bufferInfo.size = sizeof(DrawData) * MAX_INDIRECT_DRAWS;
+            vmaCreateBuffer(m_r_context.allocator, &bufferInfo, &allocInfo,
+                            &m_drawDataBuffers[i], &m_drawDataAllocs[i], nullptr);
+            vmaMapMemory(m_r_context.allocator, m_drawDataAllocs[i], &m_drawDataMapped[i]);
         }
     }
 
     void VulkanResources::createDescriptorResources() {
         log("Setting up VkDescriptorSetLayoutBinding...");
-        std::array<VkDescriptorSetLayoutBinding, 2> uboBindings{};
+        std::array<VkDescriptorSetLayoutBinding, 5> uboBindings{};
         uboBindings[0].binding = 0;
         uboBindings[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
         uboBindings[0].descriptorCount = 1;
         uboBindings[0].stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
 
-        uboBindings[1].binding = 1;
-        uboBindings[1].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
-        uboBindings[1].descriptorCount = 1;
-        uboBindings[1].stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+        // 1 = scene lights, 2 = light clusters, 3 = cluster light indices, 4 = indirect draw data
+        for (uint32_t binding = 1; binding < uboBindings.size(); binding++) {
+            uboBindings[binding].binding = binding;
+            uboBindings[binding].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            uboBindings[binding].descriptorCount = 1;
+            uboBindings[binding].stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+        }
 
         VkDescriptorSetLayoutCreateInfo uboLayoutInfo{};
         uboLayoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
@@ -347,9 +403,9 @@ namespace vex {
         poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
         poolSizes[0].descriptorCount = m_r_context.MAX_FRAMES_IN_FLIGHT;
 
-        // Light UBO (dynamic)
-        poolSizes[1].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
-        poolSizes[1].descriptorCount = m_r_context.MAX_FRAMES_IN_FLIGHT * MAX_MODELS;
+        // Lights, clusters and draw data
+        poolSizes[1].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        poolSizes[1].descriptorCount = m_r_context.MAX_FRAMES_IN_FLIGHT * 4;
 
         // Textures
         poolSizes[2].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
@@ -381,7 +437,7 @@ namespace vex {
 
         createPerMeshTextureSets();
         for (size_t i = 0; i < m_r_context.MAX_FRAMES_IN_FLIGHT; i++) {
-            std::array<VkWriteDescriptorSet, 2> uboWrites{};
+            std::array<VkWriteDescriptorSet, 5> uboWrites{};
 
             // Scene UBO
             VkDescriptorBufferInfo sceneBufferInfo{};
@@ -395,17 +451,25 @@ namespace vex {
             uboWrites[0].descriptorCount = 1;
             uboWrites[0].pBufferInfo = &sceneBufferInfo;
 
-            // Light UBO
-            VkDescriptorBufferInfo lightInfo{};
-            lightInfo.buffer = m_lightBuffers[i];
-            lightInfo.range = sizeof(SceneLightsUBO);
-
-            uboWrites[1] = {VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
-            uboWrites[1].dstSet = m_descriptorSets[i];
-            uboWrites[1].dstBinding = 1;
-            uboWrites[1].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
-            uboWrites[1].descriptorCount = 1;
-            uboWrites[1].pBufferInfo = &lightInfo;
+            // Lights, clusters and draw data
+            std::array<VkDescriptorBufferInfo, 4> storageInfos{};
+            storageInfos[0].buffer = m_lightBuffers[i];
+            storageInfos[0].range = VK_WHOLE_SIZE;
+            storageInfos[1].buffer = m_clusterBuffers[i];
+            storageInfos[1].range = VK_WHOLE_SIZE;
+            storageInfos[2].buffer = m_clusterIndexBuffers[i];
+            storageInfos[2].range = VK_WHOLE_SIZE;
+            storageInfos[3].buffer = m_drawDataBuffers[i];
+            storageInfos[3].range = VK_WHOLE_SIZE;
+
+            for (uint32_t binding = 1; binding < uboWrites.size(); binding++) {
+                uboWrites[binding] = {VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
+                uboWrites[binding].dstSet = m_descriptorSets[i];
+                uboWrites[binding].dstBinding = binding;
+                uboWrites[binding].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+                uboWrites[binding].descriptorCount = 1;
+                uboWrites[binding].pBufferInfo = &storageInfos[binding - 1];
+            }
 
             vkUpdateDescriptorSets(m_r_context.device, uboWrites.size(), uboWrites.data(), 0, nullptr);
         }
@@ -417,23 +481,35 @@ namespace vex {
     }
 
     void VulkanResources::updateTextureDescriptor(uint32_t frameIndex, VkImageView textureView, uint32_t textureIndex){
+        writeBindlessTexture(textureIndex, textureView);
+        writeFrameTexture(frameIndex, textureIndex, textureView);
+    }
+
+    void VulkanResources::writeBindlessTexture(uint32_t textureIndex, VkImageView textureView) {
+        if (!m_r_context.supportsBindlessTextures) return;
+
         VkDescriptorImageInfo imageInfo{};
         imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
         imageInfo.imageView = textureView;
         imageInfo.sampler = m_textureSampler;
 
-        if (m_r_context.supportsBindlessTextures) {
-            VkWriteDescriptorSet bindlessWrite{};
-            bindlessWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-            bindlessWrite.dstSet = m_r_context.bindlessDescriptorSet;
-            bindlessWrite.dstBinding = 0;
-            bindlessWrite.dstArrayElement = textureIndex;
-            bindlessWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-            bindlessWrite.descriptorCount = 1;
-            bindlessWrite.pImageInfo = &imageInfo;
+        VkWriteDescriptorSet bindlessWrite{};
+        bindlessWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        bindlessWrite.dstSet = m_r_context.bindlessDescriptorSet;
+        bindlessWrite.dstBinding = 0;
+        bindlessWrite.dstArrayElement = textureIndex;
+        bindlessWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        bindlessWrite.descriptorCount = 1;
+        bindlessWrite.pImageInfo = &imageInfo;
 
-            vkUpdateDescriptorSets(m_r_context.device, 1, &bindlessWrite, 0, nullptr);
-        }
+        vkUpdateDescriptorSets(m_r_context.device, 1, &bindlessWrite, 0, nullptr);
+    }
+
+    void VulkanResources::writeFrameTexture(uint32_t frameIndex, uint32_t textureIndex, VkImageView textureView) {
+        VkDescriptorImageInfo imageInfo{};
+        imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        imageInfo.imageView = textureView;
+        imageInfo.sampler = m_textureSampler;
 
         VkWriteDescriptorSet write{};
         write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
@@ -446,27 +522,6 @@ namespace vex {
         vkUpdateDescriptorSets(m_r_context.device, 1, &write, 0, nullptr);
     }
 
-    void VulkanResources::updateSceneUBO(const SceneUBO& data) {
-        void* mapped;
-        vmaMapMemory(m_r_context.allocator, m_sceneAllocs[m_r_context.currentFrame], &mapped);
-        memcpy(mapped, &data, sizeof(data));
-        vmaUnmapMemory(m_r_context.allocator, m_sceneAllocs[m_r_context.currentFrame]);
-    }
-
-    void VulkanResources::updateLightUBO(uint32_t frameIndex, uint32_t modelIndex, const SceneLightsUBO& data) {
-        if (modelIndex >= MAX_MODELS) {
-            SDL_LogError(SDL_LOG_CATEGORY_ERROR,
-                         "Model index %u exceeds MAX_MODELS (%u)",
-                         modelIndex, MAX_MODELS);
-            return;
-        }
-        void* mapped;
-        vmaMapMemory(m_r_context.allocator, m_lightAllocs[frameIndex], &mapped);
-        char* lightData = static_cast<char*>(mapped) + modelIndex * sizeof(SceneLightsUBO);
-        memcpy(lightData, &data, sizeof(SceneLightsUBO));
-        vmaUnmapMemory(m_r_context.allocator, m_lightAllocs[frameIndex]);
-    }
-
     void VulkanResources::createDefaultTexture() {
         // Create a 1x1 white pixel texture
         const unsigned char pixels[] = {255, 255, 255, 255};
@@ -617,6 +672,8 @@ namespace vex {
             samplerInfo.compareEnable = VK_FALSE;
             samplerInfo.compareOp = VK_COMPARE_OP_ALWAYS;
             samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+            samplerInfo.minLod = 0.0f;
+            samplerInfo.maxLod = VK_LOD_CLAMP_NONE;
 
             log("Creating texture sampler...");
             vkCreateSampler(m_r_context.device, &samplerInfo, nullptr, &m_textureSampler);
@@ -637,9 +694,22 @@ namespace vex {
             return 0;
         }
 
-        bool VulkanResources::loadTexture(const std::string& path, const std::string& name) {
-            std::string fullPath = path;//"Assets/" + std::string(path.c_str());
+        TextureHandle VulkanResources::getTextureHandle(const std::string& name) {
+            uint32_t textureIndex = getTextureIndex(name);
+            if (textureIndex >= m_textureGenerations.size()) {
+                textureIndex = 0;
+            }
+            return { textureIndex, m_textureGenerations[textureIndex] };
+        }
 
+        void VulkanResources::retireTextureHandle(uint32_t textureIndex) {
+            if (textureIndex < m_textureGenerations.size()) {
+                m_textureGenerations[textureIndex]++;
+            }
+            m_textureHandleEpoch++;
+        }
+
+        bool VulkanResources::loadTexture(const std::string& path, const std::string& name, bool streamed) {
             if (m_r_context.textureIndices.contains(name)) {
                 log("Texture '%s' already exists at index %u", name.c_str(), m_r_context.textureIndices[name]);
                 return true;
@@ -650,45 +720,11 @@ namespace vex {
                 return false;
             }
 
-            stbi_uc* pixels = nullptr;
-            int texWidth, texHeight, texChannels;
-
-            try {
-                // Use VFS to check if file exists and get data
-                if (!m_vfs->file_exists(fullPath)) {
-                    log(LogLevel::ERROR, "Texture file not found in VFS: %s", fullPath.c_str());
-                    return false;
-                }
-
-                log("VFS loading image...");
-                //int texWidth, texHeight, texChannels;
-
-                // Load file data through VFS
-                auto fileData = m_vfs->load_file(fullPath);  // This returns std::unique_ptr<FileData>
-                if (!fileData) {
-                    log(LogLevel::ERROR, "VFS failed to load texture: %s", fullPath.c_str());
-                    return false;
-                }
-
-                // Use stbi_load_from_memory instead of stbi_load
-                pixels = stbi_load_from_memory(
-                    reinterpret_cast<const stbi_uc*>(fileData->data.data()),  // fileData is a pointer
-                    static_cast<int>(fileData->size),                         // fileData->size is member
-                    &texWidth, &texHeight, &texChannels, STBI_rgb_alpha
-                );
-
-                if (!pixels) {
-                    log(LogLevel::ERROR, "STBI failed: %s", stbi_failure_reason());
-                    return false;
-                }
-            } catch (const std::exception& e) {
-                log(LogLevel::ERROR, "Failed to load image data for %s", fullPath.c_str());
-                if (pixels) stbi_image_free(pixels);
+            if (!m_vfs->file_exists(path)) {
+                log(LogLevel::ERROR, "Texture file not found in VFS: %s", path.c_str());
                 return false;
             }
 
-            log("Image loaded from VFS: %dx%d, %d channels", texWidth, texHeight, texChannels);
-
             uint32_t assignedIndex = 0;
 
             if (!m_r_context.recycledTextureIndices.empty()) {
@@ -698,243 +734,174 @@ namespace vex {
             } else {
                 if (m_r_context.nextTextureIndex >= MAX_TEXTURES) {
                     log(LogLevel::ERROR, "Maximum texture count (%u) reached!", MAX_TEXTURES);
-                    if (pixels) stbi_image_free(pixels);
                     return false;
                 }
                 assignedIndex = m_r_context.nextTextureIndex++;
                 log("Assigning new texture index: %u for '%s'", assignedIndex, name.c_str());
             }
 
-            VkDeviceSize imageSize = texWidth * texHeight * 4;
+            m_r_context.textureIndices[name] = assignedIndex;
 
-            if (!pixels) {
-                log(LogLevel::ERROR, "Failed to load texture: %s", fullPath.c_str());
-                return false;
+            // Slot samples the default texture until the upload lands. Per frame sets of fresh and recycled slots already point at it,
+            // bindless slots past the last loaded texture were never written.
+            writeBindlessTexture(assignedIndex, getTextureView(defaultTextureName));
+
+            uint32_t maxSize = 0;
+            if (streamed && m_p_textureStreamer->isEnabled()) {
+                m_p_textureStreamer->track(name, path, assignedIndex);
+                maxSize = TEXTURE_STREAMING_MIN_SIZE;
             }
+            m_p_textureLoader->request(path, name, assignedIndex, maxSize);
+            return true;
+        }
 
-            log("Creating staging buffer (%zu bytes)...",
-                  static_cast<size_t>(texWidth * texHeight * 4));
-            VkBuffer stagingBuffer;
-            VmaAllocation stagingAlloc;
-            VkBufferCreateInfo bufferInfo{};
-            bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-            bufferInfo.size = imageSize;
-            bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
-
-            VmaAllocationCreateInfo allocInfo{};
-            allocInfo.usage = VMA_MEMORY_USAGE_CPU_TO_GPU;
-
-            vmaCreateBuffer(m_r_context.allocator, &bufferInfo, &allocInfo, &stagingBuffer, &stagingAlloc, nullptr);
-
-            void* data;
-            vmaMapMemory(m_r_context.allocator, stagingAlloc, &data);
-            memcpy(data, pixels, static_cast<size_t>(imageSize));
-            vmaUnmapMemory(m_r_context.allocator, stagingAlloc);
-            stbi_image_free(pixels);
-
-            log("Creating Vulkan image...");
-            VkImageCreateInfo imageInfo{};
-            imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
-            imageInfo.imageType = VK_IMAGE_TYPE_2D;
-            imageInfo.extent = {static_cast<uint32_t>(texWidth), static_cast<uint32_t>(texHeight), 1};
-            imageInfo.mipLevels = 1;
-            imageInfo.arrayLayers = 1;
-            imageInfo.format = VK_FORMAT_R8G8B8A8_SRGB;
-            imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
-            imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-            imageInfo.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
-            imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
-
-            VmaAllocationCreateInfo imageAllocInfo{};
-            imageAllocInfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
-
-            VkImage textureImage;
-            VmaAllocation textureAlloc;
-            vmaCreateImage(m_r_context.allocator, &imageInfo, &imageAllocInfo, &textureImage, &textureAlloc, nullptr);
-
-            VkCommandBuffer commandBuffer = m_r_context.beginSingleTimeCommands();
-
-            VkImageMemoryBarrier barrier{};
-            barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-            barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-            barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-            barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-            barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-            barrier.image = textureImage;
-            barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-            barrier.subresourceRange.baseMipLevel = 0;
-            barrier.subresourceRange.levelCount = 1;
-            barrier.subresourceRange.baseArrayLayer = 0;
-            barrier.subresourceRange.layerCount = 1;
-            barrier.srcAccessMask = 0;
-            barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-
-
-            vkCmdPipelineBarrier(commandBuffer,
-                VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
-                VK_PIPELINE_STAGE_TRANSFER_BIT,
-                0,
-                0, nullptr,
-                0, nullptr,
-                1, &barrier);
-
-            VkBufferImageCopy region{};
-            region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-            region.imageSubresource.mipLevel = 0;
-            region.imageSubresource.baseArrayLayer = 0;
-            region.imageSubresource.layerCount = 1;
-            region.imageExtent = imageInfo.extent;
-
-
-            vkCmdCopyBufferToImage(commandBuffer,
-                stagingBuffer,
-                textureImage,
-                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                1,
-                &region);
-
-            barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-            barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-            barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-            barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-
-            vkCmdPipelineBarrier(commandBuffer,
-                VK_PIPELINE_STAGE_TRANSFER_BIT,
-                VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
-                0,
-                0, nullptr,
-                0, nullptr,
-                1, &barrier);
-
-            m_r_context.endSingleTimeCommands(commandBuffer);
-
-            vkDeviceWaitIdle(m_r_context.device);
-
-            vmaDestroyBuffer(m_r_context.allocator, stagingBuffer, stagingAlloc);
-
-            VkImageViewCreateInfo viewInfo{};
-            viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
-            viewInfo.image = textureImage;
-            viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
-            viewInfo.format = VK_FORMAT_R8G8B8A8_SRGB;
-            viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-            viewInfo.subresourceRange.levelCount = 1;
-            viewInfo.subresourceRange.layerCount = 1;
-
-            VkImageView textureView;
-            log("Creating vulkan texture view...");
-            if (vkCreateImageView(m_r_context.device, &viewInfo, nullptr, &textureView) != VK_SUCCESS) {
-                log(LogLevel::ERROR, "Failed to create texture image view!");
-                return false;
+        void VulkanResources::updateTextureUploads(uint32_t frameIndex) {
+            publishTextureUploads();
+
+            m_p_textureStreamer->update(m_streamRequests);
+            for (const auto& request : m_streamRequests) {
+                m_p_textureLoader->request(request.path, request.name, request.textureIndex, request.maxSize);
             }
 
-            m_r_context.textureIndices[name] = assignedIndex;
-            log("Assigned texture '%s' to index %u", name.c_str(), m_r_context.textureIndices[name]);
-
-            m_textures[name] = textureView;
-            m_textureImages[name] = textureImage;
-            m_textureAllocations[name] = textureAlloc;
-            m_textureViews[name] = textureView;
-
-            if (m_r_context.supportsBindlessTextures) {
-                    VkDescriptorImageInfo imageInfo{};
-                    imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-                    imageInfo.imageView = textureView;
-                    imageInfo.sampler = m_textureSampler;
-
-                    VkWriteDescriptorSet write{};
-                    write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-                    write.dstSet = m_r_context.bindlessDescriptorSet;
-                    write.dstBinding = 0;
-                    write.dstArrayElement = assignedIndex;
-                    write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-                    write.descriptorCount = 1;
-                    write.pImageInfo = &imageInfo;
-
-                    vkUpdateDescriptorSets(m_r_context.device, 1, &write, 0, nullptr);
+            // Per frame sets may still be read by frames in flight, each one is rewritten only after its own fence was waited.
+            const uint32_t frameBit = 1u << frameIndex;
+            std::erase_if(m_pendingTextureWrites, [&](PendingTextureWrite& write) {
+                if (write.frameMask & frameBit) {
+                    writeFrameTexture(frameIndex, write.textureIndex, write.view);
+                    write.frameMask &= ~frameBit;
                 }
+                return write.frameMask == 0;
+            });
+        }
 
-                VkDescriptorImageInfo imageDescInfo{};
-                imageDescInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-                imageDescInfo.sampler = m_textureSampler;
-                imageDescInfo.imageView = textureView;
+        void VulkanResources::finishTextureUploads() {
+            while (m_p_textureLoader->getPendingCount() > 0) {
+                publishTextureUploads();
+                std::this_thread::yield();
+            }
+            publishTextureUploads();
+
+            if (m_pendingTextureWrites.empty()) return;
 
+            m_r_context.waitIdle();
+            for (const auto& write : m_pendingTextureWrites) {
                 for (uint32_t frame = 0; frame < m_r_context.MAX_FRAMES_IN_FLIGHT; ++frame) {
-                    VkWriteDescriptorSet write{};
-                    write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-                    write.dstSet = getTextureDescriptorSet(frame, m_r_context.textureIndices[name]);
-                    write.dstBinding = 0;
-                    write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-                    write.descriptorCount = 1;
-                    write.pImageInfo = &imageDescInfo;
-
-                    vkUpdateDescriptorSets(m_r_context.device, 1, &write, 0, nullptr);
+                    writeFrameTexture(frame, write.textureIndex, write.view);
                 }
-                log("Updated texture descriptors for '%s'", name.c_str());
-                return true;
+            }
+            m_pendingTextureWrites.clear();
+        }
+
+        void VulkanResources::publishTextureUploads() {
+            m_residentTextures.clear();
+            m_failedTextures.clear();
+            m_p_textureLoader->update(m_residentTextures, m_failedTextures);
+
+            const uint32_t allFrames = (1u << m_r_context.MAX_FRAMES_IN_FLIGHT) - 1;
+            for (const auto& texture : m_residentTextures) {
+                // Streamed reload replaces an image that frames in flight and not yet rewritten per frame sets may still use.
+                // The deleter runs when this frame slot comes around again, by then every per frame set was rewritten.
+                auto previous = m_textureImages.find(texture.name);
+                if (previous != m_textureImages.end() && previous->second != VK_NULL_HANDLE) {
+                    retireTexture(previous->second, m_textureAllocations[texture.name], m_textureViews[texture.name]);
+                    std::erase_if(m_pendingTextureWrites, [&](const PendingTextureWrite& write) { return write.textureIndex == texture.textureIndex; });
+                }
+                m_p_textureStreamer->onResident(texture.name, texture.info);
+
+                m_textures[texture.name] = texture.view;
+                m_textureImages[texture.name] = texture.image;
+                m_textureAllocations[texture.name] = texture.allocation;
+                m_textureViews[texture.name] = texture.view;
+                m_textureInfo[texture.name] = texture.info;
+
+                writeBindlessTexture(texture.textureIndex, texture.view);
+                m_pendingTextureWrites.push_back({ texture.textureIndex, texture.view, allFrames });
+
+                const auto& info = texture.info;
+                const double saved = info.rgba8Bytes ? 100.0 - 100.0 * static_cast<double>(info.gpuBytes) / static_cast<double>(info.rgba8Bytes) : 0.0;
+                log("Texture '%s' resident at index %u: %ux%u %s, %u mips%s, %llu KiB (RGBA8 %llu KiB, saved %.0f%%), decode %.2f ms, upload %.2f ms",
+                    texture.name.c_str(), texture.textureIndex, info.width, info.height,
+                    info.cooked ? "cooked" : "source", info.mipLevels, info.generatedMips ? " (blitted)" : "",
+                    static_cast<unsigned long long>(info.gpuBytes / 1024), static_cast<unsigned long long>(info.rgba8Bytes / 1024),
+                    saved, info.decodeMs, info.uploadMs);
+            }
+
+            for (const auto& texture : m_failedTextures) {
+                if (m_textures.contains(texture.name)) {
+                    // Only a streamed reload failed, the current image stays.
+                    m_p_textureStreamer->onRequestFailed(texture.name);
+                    continue;
+                }
+                m_p_textureStreamer->untrack(texture.name);
+                m_r_context.textureIndices.erase(texture.name);
+                retireTextureHandle(texture.textureIndex);
+                m_r_context.recycledTextureIndices.push(texture.textureIndex);
+                m_ignoredTexturePaths.push_back(texture.name);
+                log(LogLevel::WARNING, "Texture '%s' could not be loaded!", texture.name.c_str());
+            }
         }
+
+        size_t VulkanResources::getPendingTextureCount() const {
+            return m_p_textureLoader->getPendingCount();
+        }
+
+        void VulkanResources::retireTexture(VkImage image, VmaAllocation allocation, VkImageView view) {
+            m_r_context.deletionQueue.push([device = m_r_context.device, allocator = m_r_context.allocator, image, allocation, view]() {
+                if (view != VK_NULL_HANDLE) vkDestroyImageView(device, view, nullptr);
+                if (image != VK_NULL_HANDLE && allocation != VK_NULL_HANDLE) vmaDestroyImage(allocator, image, allocation);
+            });
+        }
+
+        const TextureLoadInfo* VulkanResources::getTextureLoadInfo(const std::string& name) const {
+            auto it = m_textureInfo.find(name);
+            return it != m_textureInfo.end() ? &it->second : nullptr;
+        }
+
         void VulkanResources::unloadTexture(const std::string& name) {
             if (name == "default") return;
 
             auto it = m_textures.find(name);
             if (it == m_textures.end()){
+                if (m_p_textureLoader->cancel(name)) {
+                    m_p_textureStreamer->untrack(name);
+                    // Slot still points at the default texture, it can be handed out again right away.
+                    retireTextureHandle(m_r_context.textureIndices[name]);
+                    m_r_context.recycledTextureIndices.push(m_r_context.textureIndices[name]);
+                    m_r_context.textureIndices.erase(name);
+                    log("Texture %s unloaded before upload finished", name.c_str());
+                    return;
+                }
                 log("Texture %s not loaded", name.c_str());
                 return;
             }
 
-            uint32_t textureIndex = m_r_context.textureIndices[name];
-
-            vkDeviceWaitIdle(m_r_context.device);
+            m_p_textureLoader->cancel(name);
+            m_p_textureStreamer->untrack(name);
 
-            if (m_textureViews[name] != VK_NULL_HANDLE) {
-                vkDestroyImageView(m_r_context.device, m_textureViews[name], nullptr);
-                m_textureViews[name] = VK_NULL_HANDLE;
-            }
-
-            if (m_textureImages[name] != VK_NULL_HANDLE && m_textureAllocations[name] != VK_NULL_HANDLE) {
-                vmaDestroyImage(m_r_context.allocator, m_textureImages[name], m_textureAllocations[name]);
-                m_textureImages[name] = VK_NULL_HANDLE;
-            }
+            uint32_t textureIndex = m_r_context.textureIndices[name];
+            retireTextureHandle(textureIndex);
+            std::erase_if(m_pendingTextureWrites, [&](const PendingTextureWrite& write) { return write.textureIndex == textureIndex; });
 
             VkImageView defaultView = getTextureView("default");
 
-            VkDescriptorImageInfo imageInfo{};
-            imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-            imageInfo.imageView = defaultView;
-            imageInfo.sampler = m_textureSampler;
-
-            if (m_r_context.supportsBindlessTextures) {
-                VkWriteDescriptorSet bindlessWrite{};
-                bindlessWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-                bindlessWrite.dstSet = m_r_context.bindlessDescriptorSet;
-                bindlessWrite.dstBinding = 0;
-                bindlessWrite.dstArrayElement = textureIndex;
-                bindlessWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-                bindlessWrite.descriptorCount = 1;
-                bindlessWrite.pImageInfo = &imageInfo;
-
-                vkUpdateDescriptorSets(m_r_context.device, 1, &bindlessWrite, 0, nullptr);
-            }
+            // Frames in flight may still sample the image through its bindless slot. Slot is reset and recycled only when
+            // they are done, so a texture loaded in the meantime cannot get it and be overwritten by the placeholder.
+            m_r_context.deletionQueue.push([this, textureIndex, defaultView]() {
+                writeBindlessTexture(textureIndex, defaultView);
+                m_r_context.recycledTextureIndices.push(textureIndex);
+            });
+            retireTexture(m_textureImages[name], m_textureAllocations[name], m_textureViews[name]);
 
-            for (uint32_t frame = 0; frame < m_r_context.MAX_FRAMES_IN_FLIGHT; ++frame) {
-                VkWriteDescriptorSet write{};
-                write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-                write.dstSet = getTextureDescriptorSet(frame, textureIndex);
-                write.dstBinding = 0;
-                write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-                write.descriptorCount = 1;
-                write.pImageInfo = &imageInfo;
-
-                vkUpdateDescriptorSets(m_r_context.device, 1, &write, 0, nullptr);
-            }
+            // Per frame sets are pointed back at the placeholder as their frames come up, same as after an upload.
+            m_pendingTextureWrites.push_back({ textureIndex, defaultView, (1u << m_r_context.MAX_FRAMES_IN_FLIGHT) - 1 });
 
             m_textures.erase(name);
+            m_textureInfo.erase(name);
             m_textureImages.erase(name);
             m_textureAllocations.erase(name);
             m_textureViews.erase(name);
 
             m_r_context.textureIndices.erase(name);
-            m_r_context.recycledTextureIndices.push(textureIndex);
 
             log("Texture %s unloaded", name.c_str());
         }
@@ -7,14 +7,19 @@
 #pragma once
 #include "uniforms.hpp"
 #include "context.hpp"
+#include "ClusteredLighting.hpp"
+#include "AsyncTextureLoader.hpp"
+#include "TextureStreamer.hpp"
 #include "components/errorUtils.hpp"
 #include "components/VirtualFileSystem.hpp"
+#include "components/Handle.hpp"
 
 #include <components/types.hpp>
 #include <string>
 #include <array>
 #include <vector>
 #include <fstream>
+#include <memory>
 
 namespace vex {
     /// @brief This class manages resources like textures, descriptor sets, and uniform buffers.
@@ -31,7 +36,7 @@ namespace vex {
         ~VulkanResources();
 
         /// @brief Creates uniform buffers.
-        /// @details Allocates Scene and Light UBOs for each frame in flight using VMA.
+        /// @details Allocates Scene UBO and persistently mapped light/cluster storage buffers for each frame in flight using VMA.
         void createUniformBuffers();
 
         /// @brief Updates the scene uniform buffer.
@@ -39,12 +44,18 @@ namespace vex {
         /// @param const SceneUBO& data - The data to update.
         void updateSceneUBO(const SceneUBO& data);
 
-        /// @brief Updates the light uniform buffer for a specific model.
-        /// @details Updates the dynamic UBO section corresponding to a specific model index.
+        /// @brief Uploads all scene lights and their cluster assignment for a frame.
+        /// @details Copies lights, cluster ranges and light index list into persistently mapped storage buffers, done once per frame.
         /// @param uint32_t frameIndex - Current frame.
-        /// @param uint32_t modelIndex - Index of the model to update lights for.
-        /// @param const SceneLightsUBO& data - Light data.
-        void updateLightUBO(uint32_t frameIndex, uint32_t modelIndex, const SceneLightsUBO& data);
+        /// @param const std::vector<Light>& lights - World space scene lights.
+        /// @param const LightClusterGrid& clusters - Cluster assignment built for the same lights.
+        void updateClusteredLights(uint32_t frameIndex, const std::vector<Light>& lights, const LightClusterGrid& clusters);
+
+        /// @brief Uploads per draw data used by indirect draws.
+        /// @details Copies up to `MAX_INDIRECT_DRAWS` entries into the persistently mapped storage buffer bound at set 0, binding 4.
+        /// @param uint32_t frameIndex - Current frame.
+        /// @param const std::vector<DrawData>& draws - Draw data, indexed by firstInstance of each indirect command.
+        void updateDrawData(uint32_t frameIndex, const std::vector<DrawData>& draws);
 
         /// @brief Creates a default texture.
         /// @details Generates a 1x1 white pixel texture, transitions it to `SHADER_READ_ONLY`, and assigns it to the "default" key.
@@ -69,14 +80,41 @@ namespace vex {
         VkDescriptorSet getUBODescriptorSet(uint32_t frameIndex) const;
 
         /// @brief Loads a texture from a file.
-        /// @details Uses `stbi_load_from_memory` via VFS. Creates Vulkan Image, View, and uploads data via staging buffer. Recycles texture indices if available.
+        /// @details Reserves a texture index (recycled if available) and queues decode and upload on `AsyncTextureLoader`.
+        /// The index is valid right away and samples the default texture until `updateTextureUploads` makes the real one resident.
         /// @param const std::string& path - File path.
         /// @param const std::string& name - Unique identifier key.
-        /// @return bool - True if loaded successfully or already exists.
-        bool loadTexture(const std::string& path, const std::string& name) ;
+        /// @param bool streamed - Let `TextureStreamer` pick resident mips of a cooked texture, only for textures the renderer reports use of.
+        /// @return bool - True if queued or already exists, false if the file doesn't exist or no index is free.
+        bool loadTexture(const std::string& path, const std::string& name, bool streamed = false);
+
+        /// @brief Publishes textures whose upload finished and releases slots of textures that failed.
+        /// @details Called once per frame after the frame fence was waited. Bindless slots are updated immediately,
+        /// per frame texture sets of `frameIndex` are written now and the other frames when their turn comes.
+        /// Afterwards streamed textures are planned and re-requested, images they replaced are destroyed once no frame in flight can use them.
+        /// @param uint32_t frameIndex - Frame whose command buffers are no longer in use.
+        void updateTextureUploads(uint32_t frameIndex);
+
+        /// @brief Blocks until every queued texture is resident or failed.
+        /// @details For tools that need the real image view right away (e.g. editor icons handed to ImGui), waits for device idle if any per frame set has to be rewritten.
+        void finishTextureUploads();
+
+        /// @brief Returns number of textures still decoding or uploading.
+        /// @return size_t
+        size_t getPendingTextureCount() const;
+
+        /// @brief Returns format, mip count, memory and timing numbers of a resident texture.
+        /// @param const std::string& name - The texture identifier.
+        /// @return const TextureLoadInfo* - nullptr if the texture isn't resident.
+        const TextureLoadInfo* getTextureLoadInfo(const std::string& name) const;
+
+        /// @brief Returns texture streamer, used to report texture use, set the budget and draw its debug overlay.
+        /// @return TextureStreamer&
+        TextureStreamer& getTextureStreamer() { return *m_p_textureStreamer; }
 
         /// @brief Unloads a texture.
         /// @details Destroys the image/view and pushes the index to the recycled queue. Resets descriptors to the default texture.
+        /// Texture that is still loading is cancelled instead.
         /// @param const std::string& name - Identifier of the texture to unload.
         void unloadTexture(const std::string& name);
 
@@ -142,6 +180,23 @@ namespace vex {
         /// @return uint32_t - The texture index, or 0 (default) if loading fails.
         uint32_t getTextureIndex(const std::string& name);
 
+        /// @brief Returns handle of a texture, loading it the same way `getTextureIndex` does.
+        /// @param const std::string& name - Texture path/name.
+        /// @return TextureHandle - Handle of the texture slot, points at the default texture if loading fails.
+        TextureHandle getTextureHandle(const std::string& name);
+
+        /// @brief Returns true if the slot of a handle still holds the texture it was resolved for.
+        /// @details Doesn't touch any map, so it can be called per draw and from recording threads.
+        /// @param TextureHandle handle
+        /// @return bool
+        bool isTextureHandleValid(TextureHandle handle) const {
+            return handle.index < m_textureGenerations.size() && m_textureGenerations[handle.index] == handle.generation;
+        }
+
+        /// @brief Returns counter increased every time a texture slot is released, handles resolved at an older value may be stale.
+        /// @return uint64_t
+        uint64_t getTextureHandleEpoch() const { return m_textureHandleEpoch; }
+
         /// @brief Returns the texture sampler.
         /// @return VkSampler - The texture sampler.
         VkSampler getTextureSampler() const { return m_textureSampler; }
@@ -161,9 +216,20 @@ namespace vex {
         VirtualFileSystem* m_vfs;
 
         std::vector<VkBuffer> m_sceneBuffers;
-        std::vector<VkBuffer> m_lightBuffers;
         std::vector<VmaAllocation> m_sceneAllocs;
+
+        std::vector<VkBuffer> m_lightBuffers;
         std::vector<VmaAllocation> m_lightAllocs;
+        std::vector<void*> m_lightMapped;
+        std::vector<VkBuffer> m_clusterBuffers;
+        std::vector<VmaAllocation> m_clusterAllocs;
+        std::vector<void*> m_clusterMapped;
+        std::vector<VkBuffer> m_clusterIndexBuffers;
+        std::vector<VmaAllocation> m_clusterIndexAllocs;
+        std::vector<void*> m_clusterIndexMapped;
+        std::vector<VkBuffer> m_drawDataBuffers;
+        std::vector<VmaAllocation> m_drawDataAllocs;
+        std::vector<void*> m_drawDataMapped;
 
         VkDescriptorSetLayout m_descriptorSetLayout;
         std::vector<VkDescriptorSet> m_descriptorSets;
@@ -176,14 +242,43 @@ namespace vex {
         vex_map<std::string, VkImage> m_textureImages;
         vex_map<std::string, VmaAllocation> m_textureAllocations;
         vex_map<std::string, VkImageView> m_textureViews;
+        vex_map<std::string, TextureLoadInfo> m_textureInfo;
 
         std::vector<std::string> m_ignoredTexturePaths;
 
+        std::vector<uint32_t> m_textureGenerations; // indexed by texture index, bumped whenever the slot is released
+        uint64_t m_textureHandleEpoch = 0;
+
+        /// @brief Invalidates handles of a texture slot that is being released.
+        void retireTextureHandle(uint32_t textureIndex);
+
+        /// @brief Per frame texture set that still points at the placeholder, one bit per frame in flight.
+        struct PendingTextureWrite {
+            uint32_t textureIndex;
+            VkImageView view;
+            uint32_t frameMask;
+        };
+
+        std::unique_ptr<AsyncTextureLoader> m_p_textureLoader;
+        std::unique_ptr<TextureStreamer> m_p_textureStreamer;
+        std::vector<TextureStreamer::StreamRequest> m_streamRequests;
+        std::vector<PendingTextureWrite> m_pendingTextureWrites;
+        std::vector<ResidentTexture> m_residentTextures;
+        std::vector<FailedTexture> m_failedTextures;
+
         /// @brief Internal function to create descriptor resources.
         void createDescriptorResources();
         /// @brief Internal function to create texture sampler.
         void createTextureSampler();
         /// @brief Internal function to create per-mesh texture sets.
         void createPerMeshTextureSets();
+        /// @brief Collects finished uploads from the loader, registers them and updates their bindless slots.
+        void publishTextureUploads();
+        /// @brief Hands image and view over to the deferred deletion queue, frames in flight may still sample them.
+        void retireTexture(VkImage image, VmaAllocation allocation, VkImageView view);
+        /// @brief Points bindless slot at a view, does nothing without bindless support.
+        void writeBindlessTexture(uint32_t textureIndex, VkImageView textureView);
+        /// @brief Points texture set of one frame at a view.
+        void writeFrameTexture(uint32_t frameIndex, uint32_t textureIndex, VkImageView textureView);
     };
 }
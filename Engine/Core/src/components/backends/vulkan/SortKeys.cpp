@@ -0,0 +1,84 @@
+#include "SortKeys.hpp"
+
+#include <array>
+#include <cstring>
+#include <utility>
+
+namespace vex {
+    uint32_t floatToSortable(float value) {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits ^ ((bits >> 31) ? 0xFFFFFFFFu : 0x80000000u);
+    }
+
+    uint64_t packFarthestFirst(float distance, uint32_t payload) {
+        return (static_cast<uint64_t>(~floatToSortable(distance)) << 32) | payload;
+    }
+
+    void radixSortKeys(std::vector<uint64_t>& values, std::vector<uint64_t>& scratch) {
+        const size_t count = values.size();
+        if (count < 2) return;
+
+        std::array<std::array<uint32_t, 256>, 4> histograms{};
+        for (uint64_t value : values) {
+            uint32_t key = static_cast<uint32_t>(value >> 32);
+            histograms[0][key & 0xFF]++;
+            histograms[1][(key >> 8) & 0xFF]++;
+            histograms[2][(key >> 16) & 0xFF]++;
+            histograms[3][key >> 24]++;
+        }
+
+        scratch.resize(count);
+        uint64_t* src = values.data();
+        uint64_t* dst = scratch.data();
+
+        for (uint32_t pass = 0; pass < 4; pass++) {
+            auto& histogram = histograms[pass];
+            const uint32_t shift = 32 + pass * 8;
+
+            if (histogram[(src[0] >> shift) & 0xFF] == count) continue;
+
+            uint32_t offset = 0;
+            for (auto& bucket : histogram) {
+                uint32_t bucketCount = bucket;
+                bucket = offset;
+                offset += bucketCount;
+            }
+
+            for (size_t i = 0; i < count; i++) {
+                dst[histogram[(src[i] >> shift) & 0xFF]++] = src[i];
+            }
+            std::swap(src, dst);
+        }
+
+        if (src != values.data()) {
+            std::memcpy(values.data(), src, count * sizeof(uint64_t));
+        }
+    }
+
+    bool insertionSortKeys(std::vector<uint64_t>& values, size_t moveBudget, size_t* movesUsed) {
+        const size_t count = values.size();
+        size_t totalMoves = 0;
+        bool finished = true;
+        for (size_t i = 1; i < count; i++) {
+            uint64_t value = values[i];
+            size_t j = i;
+            while (j > 0 && values[j - 1] > value) {
+                values[j] = values[j - 1];
+                j--;
+            }
+            values[j] = value;
+
+            size_t moves = i - j;
+            totalMoves += moves;
+            if (moves > moveBudget) {
+                finished = false;
+                break;
+            }
+            moveBudget -= moves;
+        }
+
+        if (movesUsed) *movesUsed = totalMoves;
+        return finished;
+    }
+}
@@ -0,0 +1,38 @@
+/**
+ *  @file   SortKeys.hpp
+ *  @brief  This file defines sorting of packed float keys used to order transparent geometry.
+ *  @author Eryk Roszkowski
+ ***********************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace vex {
+    /// @brief Maps float to uint32 with the same ordering, negative values included.
+    /// @param float value
+    /// @return uint32_t
+    uint32_t floatToSortable(float value);
+
+    /// @brief Packs `(key << 32) | payload` so ascending order means largest distance first, payload breaks ties.
+    /// @param float distance - Sort key, the full float is kept so ordering is exact for the distance as it was computed.
+    /// @param uint32_t payload - Usually index of the item.
+    /// @return uint64_t
+    uint64_t packFarthestFirst(float distance, uint32_t payload);
+
+    /// @brief Stable LSD radix sort of packed `(key << 32) | payload` values by their upper 32 bits.
+    /// @details Passes where all values share the same byte are skipped, so narrow key ranges cost less.
+    /// @param std::vector<uint64_t>& values - Values to sort, sorted in place.
+    /// @param std::vector<uint64_t>& scratch - Temporary storage, resized as needed.
+    void radixSortKeys(std::vector<uint64_t>& values, std::vector<uint64_t>& scratch);
+
+    /// @brief Insertion sort of packed values that gives up once it moved elements more than `moveBudget` places in total.
+    /// @details Cost is linear in count plus moves, cheap when values are nearly sorted (last frame's order).
+    /// @param std::vector<uint64_t>& values - Values to sort, partially sorted when it gives up.
+    /// @param size_t moveBudget - Total element moves allowed.
+    /// @param size_t* movesUsed - Optional, receives moves made until it finished or gave up.
+    /// @return bool - False if budget ran out, values then have to be sorted another way.
+    bool insertionSortKeys(std::vector<uint64_t>& values, size_t moveBudget, size_t* movesUsed = nullptr);
+}
@@ -9,6 +9,11 @@
 #include "limits.hpp"
 
 namespace vex {
+    namespace {
+        // Required to be renderable everywhere, and read back bytes are already in PNG channel order.
+        constexpr VkFormat HEADLESS_COLOR_FORMAT = VK_FORMAT_R8G8B8A8_SRGB;
+    }
+
     VulkanSwapchainManager::VulkanSwapchainManager(VulkanContext& context, SDL_Window* window) : m_r_context(context) {
         m_p_window = window;
     }
@@ -18,6 +23,12 @@ namespace vex {
     }
 
     void VulkanSwapchainManager::createSwapchain() {
+        if (m_r_context.headless) {
+            createOffscreenImages();
+            createSwapchainResources();
+            return;
+        }
+
         log("Creating Swapchain");
         VkSurfaceCapabilitiesKHR capabilities;
         if (vkGetPhysicalDeviceSurfaceCapabilitiesKHR(m_r_context.physicalDevice, m_r_context.surface, &capabilities) != VK_SUCCESS) {
@@ -103,6 +114,10 @@ namespace vex {
         m_r_context.swapchainImageFormat = surfaceFormat.format;
         m_r_context.swapchainExtent = extent;
 
+        createSwapchainResources();
+    }
+
+    void VulkanSwapchainManager::createSwapchainResources() {
         for (auto &view : m_r_context.swapchainImageViews)
         {
             if (view != VK_NULL_HANDLE)
@@ -122,7 +137,7 @@ namespace vex {
             VkImageMemoryBarrier barrier{};
             barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
             barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-            barrier.newLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+            barrier.newLayout = m_r_context.getFinalImageLayout();
             barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
             barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
             barrier.image = image;
@@ -144,6 +159,64 @@ namespace vex {
         m_r_context.endSingleTimeCommands(cmd);
     }
 
+    void VulkanSwapchainManager::createOffscreenImages() {
+        log("Creating offscreen images");
+        destroyOffscreenImages();
+
+        // There is no window to upscale to, so the final image matches render resolution.
+        VkExtent2D extent = {m_r_context.currentRenderResolution.x, m_r_context.currentRenderResolution.y};
+        if (extent.width == 0 || extent.height == 0) {
+            throw_error("Invalid render resolution for offscreen images");
+        }
+
+        m_r_context.MAX_FRAMES_IN_FLIGHT = HEADLESS_IMAGE_COUNT;
+        m_r_context.swapchainImages.resize(HEADLESS_IMAGE_COUNT, VK_NULL_HANDLE);
+        m_r_context.offscreenAllocations.resize(HEADLESS_IMAGE_COUNT, VK_NULL_HANDLE);
+
+        VkImageCreateInfo imageInfo{};
+        imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        imageInfo.imageType = VK_IMAGE_TYPE_2D;
+        imageInfo.extent = {extent.width, extent.height, 1};
+        imageInfo.mipLevels = 1;
+        imageInfo.arrayLayers = 1;
+        imageInfo.format = HEADLESS_COLOR_FORMAT;
+        imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+        imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        imageInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+        imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+        imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+        VmaAllocationCreateInfo allocInfo{};
+        allocInfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
+
+        for (uint32_t i = 0; i < HEADLESS_IMAGE_COUNT; i++) {
+            if (vmaCreateImage(m_r_context.allocator, &imageInfo, &allocInfo,
+                              &m_r_context.swapchainImages[i], &m_r_context.offscreenAllocations[i], nullptr) != VK_SUCCESS) {
+                throw_error("Failed to create offscreen image");
+            }
+        }
+
+        m_r_context.swapchainImageFormat = HEADLESS_COLOR_FORMAT;
+        m_r_context.swapchainExtent = extent;
+    }
+
+    void VulkanSwapchainManager::destroyOffscreenImages() {
+        if (m_r_context.offscreenAllocations.empty()) return;
+
+        for (auto& view : m_r_context.swapchainImageViews) {
+            if (view != VK_NULL_HANDLE) vkDestroyImageView(m_r_context.device, view, nullptr);
+        }
+        m_r_context.swapchainImageViews.clear();
+
+        for (size_t i = 0; i < m_r_context.offscreenAllocations.size(); i++) {
+            if (m_r_context.swapchainImages[i] != VK_NULL_HANDLE) {
+                vmaDestroyImage(m_r_context.allocator, m_r_context.swapchainImages[i], m_r_context.offscreenAllocations[i]);
+            }
+        }
+        m_r_context.swapchainImages.clear();
+        m_r_context.offscreenAllocations.clear();
+    }
+
     void VulkanSwapchainManager::createDepthResources() {
         if (m_r_context.depthImage != VK_NULL_HANDLE) {
             vmaDestroyImage(m_r_context.allocator, m_r_context.depthImage, m_r_context.depthAllocation);
@@ -405,6 +478,7 @@ namespace vex {
             vkDestroyImageView(m_r_context.device, imageView, nullptr);
         }
         m_r_context.swapchainImageViews.clear();
+        destroyOffscreenImages();
 
         if (m_r_context.swapchain) {
             vkDestroySwapchainKHR(m_r_context.device, m_r_context.swapchain, nullptr);
@@ -437,28 +511,30 @@ namespace vex {
     }
 
     void VulkanSwapchainManager::recreateSwapchain() {
-        int width = 0, height = 0;
-        SDL_GetWindowSizeInPixels(m_p_window, &width, &height);
+        if (!m_r_context.headless) {
+            int width = 0, height = 0;
+            SDL_GetWindowSizeInPixels(m_p_window, &width, &height);
 
-        if (width == 0 || height == 0) {
-            return;
-        }
+            if (width == 0 || height == 0) {
+                return;
+            }
 
-        if (m_r_context.surface == VK_NULL_HANDLE) {
-            return;
-        }
+            if (m_r_context.surface == VK_NULL_HANDLE) {
+                return;
+            }
 
-        VkSurfaceCapabilitiesKHR capabilities;
-        if (vkGetPhysicalDeviceSurfaceCapabilitiesKHR(m_r_context.physicalDevice, m_r_context.surface, &capabilities) != VK_SUCCESS) {
-            return;
-        }
+            VkSurfaceCapabilitiesKHR capabilities;
+            if (vkGetPhysicalDeviceSurfaceCapabilitiesKHR(m_r_context.physicalDevice, m_r_context.surface, &capabilities) != VK_SUCCESS) {
+                return;
+            }
 
-        if (capabilities.currentExtent.width == 0 || capabilities.currentExtent.height == 0) {
-            return;
+            if (capabilities.currentExtent.width == 0 || capabilities.currentExtent.height == 0) {
+                return;
+            }
         }
 
         log("recreating swapchains");
-        vkDeviceWaitIdle(m_r_context.device);
+        m_r_context.waitIdle();
         log("cleanupSwapchain");
         cleanupLowResResources();
         cleanupSyncObjects();
@@ -30,6 +30,7 @@ namespace vex {
 
         /// @brief Creates or recreates the swapchain.
         /// @details Selects surface format, present mode (FIFO/Mailbox), and extent. Creates Swapchain, Image Views, Depth Resources, and Low-Res offscreen resources.
+        /// In headless mode (`VulkanContext::headless`) offscreen images at render resolution take the place of swapchain images.
         void createSwapchain();
 
         /// @brief Cleans up swapchain resources.
@@ -49,6 +50,15 @@ namespace vex {
         /// @param bool enabled - True for VSync (FIFO), False for Uncapped (Immediate/Mailbox).
         void setVSync(bool enabled);
     private:
+        /// @brief Helper function creating everything that depends on swapchain images: views, depth, command pools, sync objects and initial layouts.
+        void createSwapchainResources();
+
+        /// @brief Helper function to create `HEADLESS_IMAGE_COUNT` offscreen color images used instead of swapchain images in headless mode.
+        void createOffscreenImages();
+
+        /// @brief Helper function to destroy offscreen images and their views, does nothing with a real swapchain.
+        void destroyOffscreenImages();
+
         /// @brief Helper function to create image views for swapchain images.
         void createImageViews();
 
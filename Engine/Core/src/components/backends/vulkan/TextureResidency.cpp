@@ -0,0 +1,89 @@
+#include "TextureResidency.hpp"
+
+#include <algorithm>
+
+namespace vex {
+    namespace {
+        uint64_t usageOf(const TextureResidencyEntry& entry) {
+            return entry.chainBytes[std::min(entry.residentMip, entry.pendingMip)];
+        }
+    }
+
+    uint64_t planTextureResidency(const std::vector<TextureResidencyEntry>& entries, uint64_t budgetBytes, uint32_t maxChanges,
+                                  std::vector<TextureResidencyChange>& outChanges) {
+        outChanges.clear();
+
+        uint64_t usage = 0;
+        for (const auto& entry : entries) {
+            usage += usageOf(entry);
+        }
+
+        std::vector<const TextureResidencyEntry*> order;
+        order.reserve(entries.size());
+
+        if (usage > budgetBytes) {
+            for (const auto& entry : entries) {
+                if (entry.pendingMip == entry.residentMip && entry.residentMip < entry.floorMip) {
+                    order.push_back(&entry);
+                }
+            }
+            std::sort(order.begin(), order.end(), [](const TextureResidencyEntry* a, const TextureResidencyEntry* b) {
+                if (a->lastUsedFrame != b->lastUsedFrame) return a->lastUsedFrame < b->lastUsedFrame;
+                if (a->priority != b->priority) return a->priority < b->priority;
+                return a->id < b->id;
+            });
+
+            // Target per candidate, detail nobody looks at goes first, then detail that is visible but doesn't fit.
+            std::vector<uint32_t> targets(order.size());
+            for (size_t i = 0; i < order.size(); i++) {
+                targets[i] = order[i]->residentMip;
+            }
+            for (int pass = 0; pass < 2 && usage > budgetBytes; pass++) {
+                for (size_t i = 0; i < order.size() && usage > budgetBytes; i++) {
+                    const auto& entry = *order[i];
+                    const uint32_t limit = pass == 0 ? std::max(entry.wantedMip, entry.residentMip) : entry.floorMip;
+                    while (usage > budgetBytes && targets[i] < limit) {
+                        usage -= entry.chainBytes[targets[i]] - entry.chainBytes[targets[i] + 1];
+                        targets[i]++;
+                    }
+                }
+            }
+
+            for (size_t i = 0; i < order.size(); i++) {
+                if (targets[i] == order[i]->residentMip) continue;
+                if (outChanges.size() == maxChanges) {
+                    // Not started this frame, its levels are still resident.
+                    usage += order[i]->chainBytes[order[i]->residentMip] - order[i]->chainBytes[targets[i]];
+                    continue;
+                }
+                outChanges.push_back({ order[i]->id, targets[i] });
+            }
+            return usage;
+        }
+
+        for (const auto& entry : entries) {
+            if (entry.pendingMip == entry.residentMip && entry.wantedMip < entry.residentMip) {
+                order.push_back(&entry);
+            }
+        }
+        std::sort(order.begin(), order.end(), [](const TextureResidencyEntry* a, const TextureResidencyEntry* b) {
+            if (a->priority != b->priority) return a->priority > b->priority;
+            if (a->lastUsedFrame != b->lastUsedFrame) return a->lastUsedFrame > b->lastUsedFrame;
+            return a->id < b->id;
+        });
+
+        for (const auto* entry : order) {
+            if (outChanges.size() == maxChanges) break;
+
+            uint32_t target = entry->wantedMip;
+            while (target < entry->residentMip && usage + entry->chainBytes[target] - entry->chainBytes[entry->residentMip] > budgetBytes) {
+                target++;
+            }
+            if (target == entry->residentMip) continue;
+
+            usage += entry->chainBytes[target] - entry->chainBytes[entry->residentMip];
+            outChanges.push_back({ entry->id, target });
+        }
+        return usage;
+    }
+}
@@ -0,0 +1,50 @@
+/**
+ *  @file   TextureResidency.hpp
+ *  @brief  This file defines planTextureResidency deciding which streamed textures gain or lose mips within a memory budget.
+ *  @author Eryk Roszkowski
+ ***********************************************/
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace vex {
+    /// @brief Highest mip count a streamed texture can have (65536 texels on the longer side).
+    constexpr uint32_t MAX_STREAMED_MIPS = 17;
+
+    /// @brief Residency state of one texture as seen by `planTextureResidency`, no GPU objects involved.
+    struct TextureResidencyEntry {
+        uint32_t id = 0;
+        uint32_t mipCount = 1;
+        /// @brief `chainBytes[m]` is the size of levels `m..mipCount-1`, entry at `mipCount` is 0.
+        std::array<uint64_t, MAX_STREAMED_MIPS + 1> chainBytes{};
+        uint32_t residentMip = 0;   ///< Finest level currently resident.
+        uint32_t pendingMip = 0;    ///< Finest level of an upload in flight, equal to `residentMip` when idle.
+        uint32_t wantedMip = 0;     ///< Finest level worth having for current screen size.
+        uint32_t floorMip = 0;      ///< Coarsest level the texture is ever reduced to.
+        uint64_t lastUsedFrame = 0;
+        float priority = 0.0f;      ///< Screen size in pixels, bigger gets detail first.
+    };
+
+    /// @brief Requested move of a texture to a new finest resident mip.
+    struct TextureResidencyChange {
+        uint32_t id;
+        uint32_t targetMip;
+    };
+
+    /// @brief Decides which textures gain or lose mips this frame.
+    /// @details Usage counts every texture at the finer of its resident and pending level. When it exceeds the budget, idle entries
+    /// are reduced in least recently used order (then lowest priority, then id): first detail above `wantedMip` is dropped, then
+    /// detail down to `floorMip`, one level at a time until usage fits. Only when nothing had to be evicted, textures wanting more
+    /// detail are raised in priority order as far as the remaining budget allows. Entries with an upload in flight are left alone.
+    /// The result depends only on the arguments, so the same input always gives the same changes.
+    /// @param const std::vector<TextureResidencyEntry>& entries - Streamed textures.
+    /// @param uint64_t budgetBytes - Bytes the entries may use together.
+    /// @param uint32_t maxChanges - Upper limit of emitted changes.
+    /// @param std::vector<TextureResidencyChange>& outChanges - Receives changes, cleared first.
+    /// @return uint64_t - Usage after the changes are applied.
+    uint64_t planTextureResidency(const std::vector<TextureResidencyEntry>& entries, uint64_t budgetBytes, uint32_t maxChanges,
+                                  std::vector<TextureResidencyChange>& outChanges);
+}
@@ -0,0 +1,228 @@
+#include "TextureStreamer.hpp"
+#include "components/errorUtils.hpp"
+#include "components/TextureContainer.hpp"
+#include "limits.hpp"
+
+#include <algorithm>
+#include <imgui.h>
+
+namespace vex {
+    namespace {
+        TextureEncoding encodingOf(VkFormat format) {
+            switch (format) {
+                case VK_FORMAT_BC1_RGBA_SRGB_BLOCK: return TextureEncoding::BC1;
+                case VK_FORMAT_BC3_SRGB_BLOCK: return TextureEncoding::BC3;
+                case VK_FORMAT_BC7_SRGB_BLOCK: return TextureEncoding::BC7;
+                default: return TextureEncoding::RGBA8;
+            }
+        }
+
+        uint32_t levelSize(uint32_t width, uint32_t height, uint32_t mip) {
+            return std::max(std::max(width >> mip, height >> mip), 1u);
+        }
+    }
+
+    TextureStreamer::TextureStreamer(VulkanContext& context) : m_r_context(context) {
+        m_frameUse.assign(MAX_TEXTURES, 0.0f);
+    }
+
+    void TextureStreamer::track(const std::string& name, const std::string& path, uint32_t textureIndex) {
+        TextureState& state = m_textures[name];
+        state = TextureState{};
+        state.name = name;
+        state.path = path;
+        state.textureIndex = textureIndex;
+        state.lastUsedFrame = m_frame;
+    }
+
+    void TextureStreamer::untrack(const std::string& name) {
+        m_textures.erase(name);
+    }
+
+    void TextureStreamer::onResident(const std::string& name, const TextureLoadInfo& info) {
+        auto it = m_textures.find(name);
+        if (it == m_textures.end()) return;
+
+        TextureState& state = it->second;
+        state.resident = true;
+        state.format = info.format;
+        state.width = info.sourceWidth;
+        state.height = info.sourceHeight;
+        state.mipCount = info.sourceMipLevels;
+        state.residentMip = info.firstMip;
+        state.pendingMip = info.firstMip;
+        state.residentBytes = info.gpuBytes;
+        state.streamable = info.cooked && info.sourceMipLevels > 1 && info.sourceMipLevels <= MAX_STREAMED_MIPS;
+        if (!state.streamable) {
+            state.wantedMip = 0;
+        }
+    }
+
+    void TextureStreamer::onRequestFailed(const std::string& name) {
+        auto it = m_textures.find(name);
+        if (it != m_textures.end()) {
+            it->second.pendingMip = it->second.residentMip;
+        }
+    }
+
+    void TextureStreamer::noteTextureUse(uint32_t textureIndex, float screenPixels) {
+        if (textureIndex < m_frameUse.size()) {
+            m_frameUse[textureIndex] = std::max(m_frameUse[textureIndex], std::max(screenPixels, 1.0f));
+        }
+    }
+
+    uint64_t TextureStreamer::queryBudget() const {
+        VmaBudget budgets[VK_MAX_MEMORY_HEAPS];
+        vmaGetHeapBudgets(m_r_context.allocator, budgets);
+
+        const VkPhysicalDeviceMemoryProperties* memoryProperties = nullptr;
+        vmaGetMemoryProperties(m_r_context.allocator, &memoryProperties);
+
+        // Textures live in the biggest device local heap, everything else allocated there keeps its share.
+        uint32_t heap = 0;
+        for (uint32_t i = 0; i < memoryProperties->memoryHeapCount; i++) {
+            if ((memoryProperties->memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) &&
+                memoryProperties->memoryHeaps[i].size > memoryProperties->memoryHeaps[heap].size) {
+                heap = i;
+            }
+        }
+
+        const uint64_t usable = static_cast<uint64_t>(static_cast<double>(budgets[heap].budget) * TEXTURE_STREAMING_HEAP_FRACTION);
+        const uint64_t others = budgets[heap].usage > m_residentBytes ? budgets[heap].usage - m_residentBytes : 0;
+        const uint64_t available = usable > others ? usable - others : 0;
+
+        return m_configuredBudget != 0 ? std::min(m_configuredBudget, available) : available;
+    }
+
+    void TextureStreamer::update(std::vector<StreamRequest>& outRequests) {
+        outRequests.clear();
+        m_frame++;
+
+        m_entries.clear();
+        m_entryStates.clear();
+        m_residentBytes = 0;
+        uint64_t fixedBytes = 0;
+
+        for (auto& [name, state] : m_textures) {
+            if (!state.resident) continue;
+            m_residentBytes += state.residentBytes;
+
+            const float used = m_frameUse[state.textureIndex];
+            if (used > 0.0f) {
+                state.lastUsedFrame = m_frame;
+                state.screenPixels = used;
+            }
+
+            if (!state.streamable) {
+                fixedBytes += state.residentBytes;
+                continue;
+            }
+
+            TextureResidencyEntry entry;
+            entry.id = static_cast<uint32_t>(m_entries.size());
+            entry.mipCount = state.mipCount;
+            const TextureEncoding encoding = encodingOf(state.format);
+            for (uint32_t mip = state.mipCount; mip-- > 0;) {
+                entry.chainBytes[mip] = entry.chainBytes[mip + 1] +
+                    textureLevelBytes(encoding, std::max(state.width >> mip, 1u), std::max(state.height >> mip, 1u));
+            }
+
+            entry.floorMip = 0;
+            while (entry.floorMip + 1 < state.mipCount && levelSize(state.width, state.height, entry.floorMip) > TEXTURE_STREAMING_MIN_SIZE) {
+                entry.floorMip++;
+            }
+
+            if (used > 0.0f) {
+                // Finest mip still needed when the whole texture spans `used` pixels.
+                state.wantedMip = 0;
+                while (state.wantedMip < entry.floorMip && static_cast<float>(levelSize(state.width, state.height, state.wantedMip + 1)) >= used) {
+                    state.wantedMip++;
+                }
+            } else if (m_frame - state.lastUsedFrame > TEXTURE_STREAMING_IDLE_FRAMES) {
+                state.wantedMip = entry.floorMip;
+            }
+
+            entry.residentMip = state.residentMip;
+            entry.pendingMip = state.pendingMip;
+            entry.wantedMip = std::min(state.wantedMip, entry.floorMip);
+            entry.lastUsedFrame = state.lastUsedFrame;
+            entry.priority = state.screenPixels;
+
+            m_entries.push_back(entry);
+            m_entryStates.push_back(&state);
+        }
+
+        std::fill(m_frameUse.begin(), m_frameUse.end(), 0.0f);
+
+        m_budget = queryBudget();
+        if (!m_enabled || m_entries.empty()) return;
+
+        const uint64_t streamedBudget = m_budget > fixedBytes ? m_budget - fixedBytes : 0;
+        planTextureResidency(m_entries, streamedBudget, TEXTURE_STREAMING_MAX_REQUESTS, m_changes);
+
+        for (const auto& change : m_changes) {
+            TextureState& state = *m_entryStates[change.id];
+            state.pendingMip = change.targetMip;
+            outRequests.push_back({ state.name, state.path, state.textureIndex, levelSize(state.width, state.height, change.targetMip) });
+        }
+    }
+
+    void TextureStreamer::drawDebugOverlay() const {
+        ImGui::SetNextWindowSize(ImVec2(520, 360), ImGuiCond_FirstUseEver);
+        if (!ImGui::Begin("Texture Streaming")) {
+            ImGui::End();
+            return;
+        }
+
+        const float fraction = m_budget ? static_cast<float>(static_cast<double>(m_residentBytes) / static_cast<double>(m_budget)) : 1.0f;
+        char overlay[64];
+        snprintf(overlay, sizeof(overlay), "%.1f / %.1f MiB", m_residentBytes / (1024.0 * 1024.0), m_budget / (1024.0 * 1024.0));
+        ImGui::ProgressBar(std::min(fraction, 1.0f), ImVec2(-1.0f, 0.0f), overlay);
+        ImGui::Text("Streaming: %s, %zu textures", m_enabled ? "on" : "off", m_textures.size());
+
+        std::vector<const TextureState*> sorted;
+        sorted.reserve(m_textures.size());
+        for (const auto& [name, state] : m_textures) {
+            sorted.push_back(&state);
+        }
+        std::sort(sorted.begin(), sorted.end(), [](const TextureState* a, const TextureState* b) {
+            if (a->residentBytes != b->residentBytes) return a->residentBytes > b->residentBytes;
+            return a->name < b->name;
+        });
+
+        if (ImGui::BeginTable("TextureResidency", 5, ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY | ImGuiTableFlags_Resizable)) {
+            ImGui::TableSetupScrollFreeze(0, 1);
+            ImGui::TableSetupColumn("Texture");
+            ImGui::TableSetupColumn("KiB");
+            ImGui::TableSetupColumn("Top mip");
+            ImGui::TableSetupColumn("Wanted");
+            ImGui::TableSetupColumn("Last used");
+            ImGui::TableHeadersRow();
+
+            for (const TextureState* state : sorted) {
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(state->name.c_str());
+                ImGui::TableNextColumn();
+                ImGui::Text("%llu", static_cast<unsigned long long>(state->residentBytes / 1024));
+                ImGui::TableNextColumn();
+                if (!state->resident) {
+                    ImGui::TextUnformatted("loading");
+                } else if (!state->streamable) {
+                    ImGui::TextUnformatted("whole");
+                } else {
+                    const uint32_t size = levelSize(state->width, state->height, state->residentMip);
+                    ImGui::Text(state->pendingMip != state->residentMip ? "%u (%upx) -> %u" : "%u (%upx)", state->residentMip, size, state->pendingMip);
+                }
+                ImGui::TableNextColumn();
+                if (state->streamable) {
+                    ImGui::Text("%u", state->wantedMip);
+                }
+                ImGui::TableNextColumn();
+                ImGui::Text("%llu", static_cast<unsigned long long>(m_frame - std::min(m_frame, state->lastUsedFrame)));
+            }
+            ImGui::EndTable();
+        }
+        ImGui::End();
+    }
+}
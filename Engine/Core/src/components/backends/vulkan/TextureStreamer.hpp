@@ -0,0 +1,129 @@
+/**
+ *  @file   TextureStreamer.hpp
+ *  @brief  This file defines TextureStreamer class keeping texture mip residency inside a memory budget.
+ *  @author Eryk Roszkowski
+ ***********************************************/
+
+#pragma once
+#include "context.hpp"
+#include "AsyncTextureLoader.hpp"
+#include "TextureResidency.hpp"
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace vex {
+    /// @brief Streams mip levels of cooked textures in and out based on screen size and a memory budget.
+    /// @details Cooked `.vtex` textures are first loaded from a small mip (see `TEXTURE_STREAMING_MIN_SIZE`). The renderer reports
+    /// the screen size of every textured draw through `noteTextureUse`, once per frame `update` turns that into wanted mips, runs
+    /// `planTextureResidency` and returns which textures have to be requested again with a different top level.
+    /// Source images have no stored mips to pick from, they are loaded whole and only counted against the budget.
+    class TextureStreamer {
+    public:
+        /// @brief Residency of one texture, exposed for the debug overlay.
+        struct TextureState {
+            std::string name;
+            std::string path;
+            uint32_t textureIndex = 0;
+            bool streamable = false;
+            bool resident = false;
+            VkFormat format = VK_FORMAT_UNDEFINED;
+            uint32_t width = 0;          ///< Size of level 0 in the file.
+            uint32_t height = 0;
+            uint32_t mipCount = 0;       ///< Levels stored in the file.
+            uint32_t residentMip = 0;
+            uint32_t pendingMip = 0;
+            uint32_t wantedMip = 0;
+            uint64_t residentBytes = 0;  ///< Size of the current image allocation.
+            uint64_t lastUsedFrame = 0;
+            float screenPixels = 0.0f;   ///< Largest screen size reported in the last frame it was drawn.
+        };
+
+        /// @brief Texture that has to be requested from the loader again.
+        struct StreamRequest {
+            std::string name;
+            std::string path;
+            uint32_t textureIndex;
+            uint32_t maxSize;            ///< Longer side of the new top level.
+        };
+
+        explicit TextureStreamer(VulkanContext& context);
+
+        /// @brief Registers a texture right before its first request.
+        /// @param const std::string& name - Texture name.
+        /// @param const std::string& path - VFS path it is loaded from.
+        /// @param uint32_t textureIndex - Descriptor slot.
+        void track(const std::string& name, const std::string& path, uint32_t textureIndex);
+
+        /// @brief Forgets a texture, called on unload or failed first load.
+        /// @param const std::string& name - Texture name.
+        void untrack(const std::string& name);
+
+        /// @brief Stores result of a finished upload.
+        /// @param const std::string& name - Texture name.
+        /// @param const TextureLoadInfo& info - Numbers reported by the loader.
+        void onResident(const std::string& name, const TextureLoadInfo& info);
+
+        /// @brief Clears the pending level of a texture whose re-request failed, the old image stays in use.
+        /// @param const std::string& name - Texture name.
+        void onRequestFailed(const std::string& name);
+
+        /// @brief Reports that a texture was drawn this frame covering about `screenPixels` pixels on the longer side.
+        /// @param uint32_t textureIndex - Descriptor slot used by the draw.
+        /// @param float screenPixels - Projected size of the drawn object.
+        void noteTextureUse(uint32_t textureIndex, float screenPixels);
+
+        /// @brief Plans residency for the next frame.
+        /// @param std::vector<StreamRequest>& outRequests - Receives textures to request again, cleared first.
+        void update(std::vector<StreamRequest>& outRequests);
+
+        /// @brief Sets budget of all tracked textures in bytes, 0 derives it from the VMA heap budget.
+        /// @param uint64_t bytes - Budget in bytes.
+        void setBudget(uint64_t bytes) { m_configuredBudget = bytes; }
+
+        /// @brief Returns budget used by the last `update`.
+        /// @return uint64_t
+        uint64_t getBudget() const { return m_budget; }
+
+        /// @brief Returns bytes of all resident tracked textures.
+        /// @return uint64_t
+        uint64_t getResidentBytes() const { return m_residentBytes; }
+
+        /// @brief Enables or disables streaming, disabled streamer loads every texture whole and never plans changes.
+        /// @param bool enabled - New state, affects textures requested afterwards.
+        void setEnabled(bool enabled) { m_enabled = enabled; }
+
+        /// @brief Returns true if streaming is enabled.
+        /// @return bool
+        bool isEnabled() const { return m_enabled; }
+
+        /// @brief Returns all tracked textures.
+        /// @return const std::unordered_map<std::string, TextureState>&
+        const std::unordered_map<std::string, TextureState>& getTextures() const { return m_textures; }
+
+        /// @brief Draws ImGui window with budget, usage and resident bytes of every texture.
+        /// @details Must be called between ImGui frame begin and end, e.g. from a function added with `ImGUIWrapper::addUIFunction`.
+        void drawDebugOverlay() const;
+
+    private:
+        /// @brief Derives budget from configured value and the device local heap budget reported by VMA.
+        uint64_t queryBudget() const;
+
+        VulkanContext& m_r_context;
+        std::unordered_map<std::string, TextureState> m_textures;
+        std::vector<float> m_frameUse; // largest screen size per texture index this frame, 0 if not drawn
+
+        bool m_enabled = true;
+        uint64_t m_frame = 0;
+        uint64_t m_configuredBudget = 0;
+        uint64_t m_budget = 0;
+        uint64_t m_residentBytes = 0;
+
+        std::vector<TextureResidencyEntry> m_entries;
+        std::vector<TextureState*> m_entryStates; // entry id is its position in `m_entries`
+        std::vector<TextureResidencyChange> m_changes;
+    };
+}
@@ -0,0 +1,91 @@
+/**
+ *  @file   TransparencySorter.hpp
+ *  @brief  This file defines TransparencySorter class ordering transparent geometry back to front.
+ *  @author Eryk Roszkowski
+ ***********************************************/
+
+#pragma once
+#include "VulkanMesh.hpp"
+#include "SortKeys.hpp"
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace vex {
+    /// @brief Transparent mesh that passed culling this frame.
+    struct TransparentObject {
+        VulkanMesh* mesh;
+        entt::entity entity;
+        uint32_t modelIndex;
+        glm::mat4 modelMatrix;
+    };
+
+    /// @brief Sorts transparent geometry back to front with a float key radix sort.
+    /// @details Two granularities are supported:
+    /// - per submesh: one draw per visible submesh ordered by distance of its center, cheap but can't fix overlaps inside a mesh,
+    /// - per triangle: one entry per triangle, world space triangle centers are cached per entity and only recomputed when its model matrix changes.
+    ///
+    /// Last frame's order is kept and, if the same objects are visible again, used as a starting point for an insertion sort,
+    /// which is close to linear when the camera barely moved. When it would need more than `TRANSPARENT_SORT_MOVES_PER_ITEM` moves per item the sorter falls back to radix sort.
+    /// Ties keep extraction order (model, submesh, triangle), so the result matches a stable comparison sort.
+    class TransparencySorter {
+    public:
+        /// @brief Builds sorted transparent draws.
+        /// @param const std::vector<TransparentObject>& objects - Visible transparent objects.
+        /// @param const glm::vec3& cameraPos - Camera world position.
+        /// @param uint32_t frameIndex - Frame in flight index stored in output.
+        /// @param bool perTriangle - Sort single triangles instead of whole submeshes.
+        /// @param std::vector<TransparentTriangle>& out - Receives draws, farthest first.
+        void sort(const std::vector<TransparentObject>& objects, const glm::vec3& cameraPos, uint32_t frameIndex,
+                  bool perTriangle, std::vector<TransparentTriangle>& out);
+
+        /// @brief Returns true if last `sort` reused previous frame order.
+        /// @return bool
+        bool reusedLastOrder() const { return m_reusedOrder; }
+
+        /// @brief Drops cached triangle centers and previous order.
+        void clear();
+
+    private:
+        /// @brief Identifies one object of the previous frame, used to decide if its order can be reused.
+        struct Signature {
+            VulkanMesh* mesh;
+            entt::entity entity;
+            uint32_t itemCount;
+
+            bool operator==(const Signature&) const = default;
+        };
+
+        /// @brief World space triangle centers of a single entity.
+        struct CenterCache {
+            VulkanMesh* mesh = nullptr;
+            glm::mat4 modelMatrix{ 0.0f };
+            std::vector<glm::vec3> centers;
+            uint64_t lastUsedFrame = 0;
+        };
+
+        /// @brief Appends one draw per submesh of an object.
+        void extractSubmeshes(const TransparentObject& object, const glm::vec3& cameraPos, uint32_t frameIndex);
+
+        /// @brief Appends one draw per triangle of an object, using and refreshing its center cache.
+        void extractTriangles(const TransparentObject& object, const glm::vec3& cameraPos, uint32_t frameIndex);
+
+        /// @brief Insertion sort seeded with previous order, returns false if it ran out of move budget.
+        bool sortFromLastOrder();
+
+        std::vector<TransparentTriangle> m_items;
+        std::vector<float> m_keys;
+        std::vector<uint64_t> m_sorted;
+        std::vector<uint64_t> m_scratch;
+
+        std::vector<Signature> m_signature;
+        std::vector<Signature> m_lastSignature;
+        std::vector<uint32_t> m_lastOrder;
+        bool m_lastPerTriangle = false;
+        bool m_reusedOrder = false;
+
+        std::unordered_map<entt::entity, CenterCache> m_centerCache;
+        uint64_t m_frame = 0;
+    };
+}
@@ -15,7 +15,7 @@ namespace vex {
     VulkanImGUIWrapper::~VulkanImGUIWrapper() {
 #if DEBUG
         if (m_initialized) {
-            vkDeviceWaitIdle(m_r_context.device);
+            m_r_context.waitIdle();
 
             ImGui_ImplVulkan_Shutdown();
 
@@ -93,7 +93,7 @@ namespace vex {
             init_info.Device = m_r_context.device;
             init_info.QueueFamily = m_r_context.graphicsQueueFamily;
             init_info.Queue = m_r_context.graphicsQueue;
-            init_info.PipelineCache = VK_NULL_HANDLE;
+            init_info.PipelineCache = m_r_context.pipelineCache;
             init_info.MinImageCount = m_r_context.swapchainImages.size();
             init_info.ImageCount = m_r_context.swapchainImages.size();
             init_info.CheckVkResultFn = [](VkResult err) {
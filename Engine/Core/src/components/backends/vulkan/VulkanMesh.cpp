@@ -1,5 +1,6 @@
 #include "VulkanMesh.hpp"
 #include "components/Mesh.hpp"
+#include "components/MeshCooker.hpp"
 #include "components/pathUtils.hpp"
 #include "glm/common.hpp"
 #include "glm/fwd.hpp"
@@ -12,30 +13,43 @@
 #else
 #include <X11/X.h>
 #endif
+#include <algorithm>
+#include <cfloat>
 #include <cstdint>
 #include <immintrin.h>
 #include <cstring>
 #include <iostream>
 
 namespace vex {
-    VulkanMesh::VulkanMesh(VulkanContext& context) : m_r_context(context) {
+    VulkanMesh::VulkanMesh(VulkanContext& context, MeshArena* arena) : m_r_context(context), m_p_arena(arena) {
         log("VulkanMesh created");
     }
 
     VulkanMesh::~VulkanMesh() {
         log("Destroying VulkanMesh");
-        vkDeviceWaitIdle(m_r_context.device);
+        if (m_submeshBuffers.empty()) return;
 
-        for (auto& submesh : m_submeshBuffers) {
-            if (submesh.vertexBuffer != VK_NULL_HANDLE) {
-                vmaDestroyBuffer(m_r_context.allocator, submesh.vertexBuffer, submesh.vertexAlloc);
-                submesh.vertexBuffer = VK_NULL_HANDLE;
-            }
-            if (submesh.indexBuffer != VK_NULL_HANDLE) {
-                vmaDestroyBuffer(m_r_context.allocator, submesh.indexBuffer, submesh.indexAlloc);
-                submesh.indexBuffer = VK_NULL_HANDLE;
+        // Frames in flight may still draw this mesh, arena ranges are only reused after they finished.
+        // Offsets captured by the deleter can't be relocated, so compaction has to leave the ranges where they are.
+        for (const auto& submesh : m_submeshBuffers) {
+            if (m_p_arena && submesh.arenaAlloc.valid()) {
+                m_p_arena->pin(submesh.arenaAlloc);
             }
         }
+        m_r_context.deletionQueue.push([allocator = m_r_context.allocator, arena = m_p_arena, submeshes = std::move(m_submeshBuffers)]() mutable {
+            for (auto& submesh : submeshes) {
+                if (submesh.arenaAlloc.valid()) {
+                    arena->free(submesh.arenaAlloc);
+                    continue;
+                }
+                if (submesh.vertexBuffer != VK_NULL_HANDLE) {
+                    vmaDestroyBuffer(allocator, submesh.vertexBuffer, submesh.vertexAlloc);
+                }
+                if (submesh.indexBuffer != VK_NULL_HANDLE) {
+                    vmaDestroyBuffer(allocator, submesh.indexBuffer, submesh.indexAlloc);
+                }
+            }
+        });
     }
 
     void VulkanMesh::StreamToGPU(void* dst, const void* src, size_t sizeBytes) {
@@ -76,91 +90,179 @@ namespace vex {
         _mm_sfence();
     }
 
-    void VulkanMesh::upload(const MeshData& meshData) {
+    void VulkanMesh::upload(const MeshData& meshData, VertexFormat format) {
         log("Uploading mesh with %zu submeshes", meshData.submeshes.size());
 
+        m_vertexFormat = format;
+        if (m_vertexFormat == VertexFormat::COMPACT) {
+            for (const auto& srcSubmesh : meshData.submeshes) {
+                if (!canQuantizeUVs(srcSubmesh.vertices)) {
+                    log(LogLevel::WARNING, "Mesh '%s' has UVs outside of +-%.0f, uploading it with standard vertices", meshData.meshPath.c_str(), COMPACT_UV_LIMIT);
+                    m_vertexFormat = VertexFormat::STANDARD;
+                    break;
+                }
+            }
+        }
+        const uint32_t vertexStride = m_vertexFormat == VertexFormat::COMPACT ? sizeof(CompactVertex) : sizeof(Vertex);
+
         m_submeshBuffers.reserve(meshData.submeshes.size());
         m_submeshTextures.reserve(meshData.submeshes.size());
-        m_cpuSubmeshData = meshData.submeshes;
+        m_triangleCenters.resize(meshData.submeshes.size());
+        m_submeshCenters.reserve(meshData.submeshes.size());
 
-        for (auto& srcSubmesh : m_cpuSubmeshData) {
+        std::vector<CompactVertex> compactVertices;
+        std::vector<uint32_t> lodIndices;
+        std::vector<uint16_t> shortIndices;
+        m_lodErrors = computeLodErrors(meshData);
+
+        for (const auto& srcSubmesh : meshData.submeshes) {
             SubmeshBuffers buffers{};
+            buffers.indexCount = static_cast<uint32_t>(srcSubmesh.indices.size());
+            buffers.indexType = canUse16BitIndices(srcSubmesh.vertices.size()) ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
+
+            // All levels share vertices, their indices are uploaded back to back so a level is just a different index range.
+            const std::vector<uint32_t>* indices = &srcSubmesh.indices;
+            buffers.lodCount = 1 + static_cast<uint32_t>(std::min<size_t>(srcSubmesh.lods.size(), MAX_MESH_LODS - 1));
+            buffers.lods[0] = { 0, buffers.indexCount };
+            if (buffers.lodCount > 1) {
+                lodIndices = srcSubmesh.indices;
+                for (uint32_t level = 1; level < buffers.lodCount; level++) {
+                    const SubmeshLod& lod = srcSubmesh.lods[level - 1];
+                    buffers.lods[level] = { static_cast<uint32_t>(lodIndices.size()), static_cast<uint32_t>(lod.indices.size()) };
+                    lodIndices.insert(lodIndices.end(), lod.indices.begin(), lod.indices.end());
+                }
+                indices = &lodIndices;
+            }
 
-            VkBufferCreateInfo bufferInfo{};
-            bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-            bufferInfo.size = srcSubmesh.vertices.size() * sizeof(Vertex);
-            bufferInfo.usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
+            const void* vertexData = srcSubmesh.vertices.data();
+            if (m_vertexFormat == VertexFormat::COMPACT) {
+                const PositionQuantization quantization = computePositionQuantization(srcSubmesh.vertices);
+                quantizeVertices(srcSubmesh.vertices, quantization, compactVertices);
+                vertexData = compactVertices.data();
+                m_submeshDequantization.push_back(quantization.matrix());
+            }
 
-            VmaAllocationCreateInfo allocInfo{};
-            allocInfo.usage = VMA_MEMORY_USAGE_CPU_TO_GPU;
-            vmaCreateBuffer(m_r_context.allocator, &bufferInfo, &allocInfo,
-                            &buffers.vertexBuffer, &buffers.vertexAlloc, nullptr);
+            const void* indexData = indices->data();
+            uint32_t indexSize = sizeof(uint32_t);
+            if (buffers.indexType == VK_INDEX_TYPE_UINT16) {
+                narrowIndices(*indices, shortIndices);
+                indexData = shortIndices.data();
+                indexSize = sizeof(uint16_t);
+            }
 
-            void* data;
-            vmaMapMemory(m_r_context.allocator, buffers.vertexAlloc, &data);
-            StreamToGPU(data, srcSubmesh.vertices.data(), bufferInfo.size);
-            vmaUnmapMemory(m_r_context.allocator, buffers.vertexAlloc);
+            const size_t vertexBytes = srcSubmesh.vertices.size() * vertexStride;
+            const size_t indexBytes = indices->size() * indexSize;
 
-            bufferInfo.size = srcSubmesh.indices.size() * sizeof(uint32_t);
-            bufferInfo.usage = VK_BUFFER_USAGE_INDEX_BUFFER_BIT;
-            vmaCreateBuffer(m_r_context.allocator, &bufferInfo, &allocInfo,
-                            &buffers.indexBuffer, &buffers.indexAlloc, nullptr);
+            if (m_p_arena && m_p_arena->allocate(srcSubmesh.vertices.size(), vertexStride, indices->size(), indexSize, buffers.arenaAlloc)) [[likely]] {
+                m_p_arena->upload(buffers.arenaAlloc, vertexData, vertexBytes, indexData, indexBytes);
 
-            vmaMapMemory(m_r_context.allocator, buffers.indexAlloc, &data);
-            StreamToGPU(data, srcSubmesh.indices.data(), bufferInfo.size);
-            vmaUnmapMemory(m_r_context.allocator, buffers.indexAlloc);
+                buffers.vertexBuffer = m_p_arena->getVertexBuffer();
+                buffers.indexBuffer = m_p_arena->getIndexBuffer();
+                buffers.firstIndex = buffers.arenaAlloc.firstIndex;
+                buffers.vertexOffset = buffers.arenaAlloc.vertexOffset;
+            } else {
+                if (m_p_arena) {
+                    log(LogLevel::WARNING, "Mesh arena is full, submesh gets its own buffers");
+                }
+                createOwnBuffers(vertexData, vertexBytes, indexData, indexBytes, buffers);
+            }
 
-            buffers.indexCount = static_cast<uint32_t>(srcSubmesh.indices.size());
+            for (uint32_t level = 0; level < buffers.lodCount; level++) {
+                buffers.lods[level].firstIndex += buffers.firstIndex;
+            }
+
+            m_geometryBytes += vertexBytes + indexBytes;
+            m_standardGeometryBytes += srcSubmesh.vertices.size() * sizeof(Vertex) + indices->size() * sizeof(uint32_t);
 
             m_submeshBuffers.push_back(buffers);
             m_submeshTextures.push_back(srcSubmesh.texturePath);
 
-            for (size_t i = 0; i < srcSubmesh.indices.size(); i += 3) {
-                const auto& p0 = srcSubmesh.vertices[srcSubmesh.indices[i+0]].position;
-                const auto& p1 = srcSubmesh.vertices[srcSubmesh.indices[i+1]].position;
-                const auto& p2 = srcSubmesh.vertices[srcSubmesh.indices[i+2]].position;
-                srcSubmesh.triangleCenters.push_back((p0 + p1 + p2) / 3.0f);
+            glm::vec3 min = glm::vec3(FLT_MAX);
+            glm::vec3 max = glm::vec3(-FLT_MAX);
+            for (const auto& vertex : srcSubmesh.vertices) {
+                min = glm::min(min, vertex.position);
+                max = glm::max(max, vertex.position);
             }
+            m_submeshCenters.push_back(srcSubmesh.vertices.empty() ? glm::vec3(0.0f) : (min + max) * 0.5f);
 
-            log("Uploaded submesh: %zu vertices, %u indices, texture: '%s'",
-                   srcSubmesh.vertices.size(), buffers.indexCount,
+            log("Uploaded submesh: %zu vertices, %u indices (%u bit), %u LODs, texture: '%s'",
+                   srcSubmesh.vertices.size(), buffers.indexCount, indexSize * 8, buffers.lodCount,
                    srcSubmesh.texturePath.c_str());
         }
+
+        if (m_p_arena) {
+            m_p_arena->flush();
+        }
+
+        log("Mesh geometry: %llu bytes with %s vertices, %llu bytes saved",
+            static_cast<unsigned long long>(m_geometryBytes),
+            m_vertexFormat == VertexFormat::COMPACT ? "compact" : "standard",
+            static_cast<unsigned long long>(getGeometryBytesSaved()));
     }
 
-    void VulkanMesh::extractTransparentTriangles(
-        const glm::mat4& modelMatrix,
-        const glm::vec3& cameraPos,
-        uint32_t modelIndex,
-        uint32_t frameIndex,
-        entt::entity entity,
-        std::vector<TransparentTriangle>& outTriangles
-    ) {
-        glm::mat3 rotation_scale_matrix = glm::mat3(modelMatrix);
-        glm::vec3 translation_vector = glm::vec3(modelMatrix[3]);
-
-        for (uint32_t submeshIndex = 0; submeshIndex < m_cpuSubmeshData.size(); ++submeshIndex) {
-            const auto& submesh = m_cpuSubmeshData[submeshIndex];
-            const size_t indexCount = submesh.indices.size();
-            const glm::vec3* centers = submesh.triangleCenters.data();
-
-            for (uint32_t i = 0; i < indexCount; i += 3) {
-                glm::vec3 center_world = rotation_scale_matrix * centers[i/3] + translation_vector;
-
-                glm::vec3 d = center_world - cameraPos;
-                float distanceSq = glm::dot(d, d);
-
-                outTriangles.push_back({
-                    distanceSq,
-                    modelIndex,
-                    frameIndex,
-                    i,
-                    submeshIndex,
-                    this,
-                    entity
-                });
+    void VulkanMesh::relocate(const MeshArena::Relocation& relocation) {
+        for (auto& buffers : m_submeshBuffers) {
+            if (!relocation.apply(buffers.arenaAlloc)) continue;
+
+            // LOD ranges hold absolute first indices, they shift with the submesh.
+            const int64_t indexShift = static_cast<int64_t>(buffers.arenaAlloc.firstIndex) - buffers.firstIndex;
+            for (uint32_t level = 0; level < buffers.lodCount; level++) {
+                buffers.lods[level].firstIndex = static_cast<uint32_t>(buffers.lods[level].firstIndex + indexShift);
             }
+            buffers.firstIndex = buffers.arenaAlloc.firstIndex;
+            buffers.vertexOffset = buffers.arenaAlloc.vertexOffset;
+        }
+    }
+
+    void VulkanMesh::buildTriangleCenters(const MeshData& meshData) {
+        const size_t submeshCount = std::min(m_triangleCenters.size(), meshData.submeshes.size());
+        for (size_t i = 0; i < submeshCount; i++) {
+            const Submesh& submesh = meshData.submeshes[i];
+            // Cooked meshes come with centers already.
+            if (submesh.triangleCenters.size() == submesh.indices.size() / 3) {
+                m_triangleCenters[i] = submesh.triangleCenters;
+            } else {
+                computeTriangleCenters(submesh, m_triangleCenters[i]);
+            }
+        }
+        m_hasTriangleCenters = true;
+    }
+
+    uint64_t VulkanMesh::getTriangleCenterBytes() const {
+        uint64_t bytes = 0;
+        for (const auto& centers : m_triangleCenters) {
+            bytes += centers.capacity() * sizeof(glm::vec3);
         }
+        return bytes;
+    }
+
+    void VulkanMesh::createOwnBuffers(const void* vertices, size_t vertexBytes, const void* indices, size_t indexBytes, SubmeshBuffers& buffers) {
+        VkBufferCreateInfo bufferInfo{};
+        bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        bufferInfo.size = vertexBytes;
+        bufferInfo.usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
+
+        VmaAllocationCreateInfo allocInfo{};
+        allocInfo.usage = VMA_MEMORY_USAGE_CPU_TO_GPU;
+        vmaCreateBuffer(m_r_context.allocator, &bufferInfo, &allocInfo,
+                        &buffers.vertexBuffer, &buffers.vertexAlloc, nullptr);
+
+        void* data;
+        vmaMapMemory(m_r_context.allocator, buffers.vertexAlloc, &data);
+        StreamToGPU(data, vertices, bufferInfo.size);
+        vmaUnmapMemory(m_r_context.allocator, buffers.vertexAlloc);
+
+        bufferInfo.size = indexBytes;
+        bufferInfo.usage = VK_BUFFER_USAGE_INDEX_BUFFER_BIT;
+        vmaCreateBuffer(m_r_context.allocator, &bufferInfo, &allocInfo,
+                        &buffers.indexBuffer, &buffers.indexAlloc, nullptr);
+
+        vmaMapMemory(m_r_context.allocator, buffers.indexAlloc, &data);
+        StreamToGPU(data, indices, bufferInfo.size);
+        vmaUnmapMemory(m_r_context.allocator, buffers.indexAlloc);
+
+        buffers.firstIndex = 0;
+        buffers.vertexOffset = 0;
     }
 
     void VulkanMesh::bindAndDrawBatched(
@@ -170,18 +272,15 @@ namespace vex {
         uint32_t frameIndex,
         uint32_t modelIndex,
         uint32_t submeshIndex,
+        uint32_t textureIndex,
         glm::mat4 modelMatrix,
         bool modelChanged,
         bool submeshChanged,
         const MeshComponent& mc
     ) const {
         const auto& buffers = m_submeshBuffers[submeshIndex];
-        const auto& textureName = m_submeshTextures[submeshIndex];
 
         if(modelChanged){
-            uint32_t lightsDynamicOffset = modelIndex * static_cast<uint32_t>(sizeof(SceneLightsUBO));
-            uint32_t dynamicOffsets[1] = { lightsDynamicOffset };
-
             VkDescriptorSet globalSet = resources.getDescriptorSet(frameIndex);
             vkCmdBindDescriptorSets(
                 cmd,
@@ -190,20 +289,12 @@ namespace vex {
                 0,
                 1,
                 &globalSet,
-                1,
-                dynamicOffsets
+                0,
+                nullptr
             );
         }
 
-        uint32_t textureIndex = resources.getTextureIndex(textureName);
-        if (textureIndex >= MAX_TEXTURES) {
-            textureIndex = 0;
-        }
-
-        if (m_r_context.supportsBindlessTextures) {
-
-        }
-        else {
+        if (!m_r_context.supportsBindlessTextures) {
             if(submeshChanged || modelChanged){
                 VkDescriptorSet texSet = resources.getTextureDescriptorSet(frameIndex, textureIndex);
                 vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS,
@@ -213,20 +304,16 @@ namespace vex {
         }
 
         bool needPush = modelChanged;
-        if (m_r_context.supportsBindlessTextures && submeshChanged) {
+        if (submeshChanged && (m_r_context.supportsBindlessTextures || m_vertexFormat == VertexFormat::COMPACT)) {
             needPush = true;
         }
 
         if(needPush){
             PushConstants modelPush{};
-            modelPush.model = modelMatrix;
+            modelPush.model = getDrawMatrix(submeshIndex, modelMatrix);
             modelPush.color = mc.color;
             modelPush.textureID = textureIndex;
 
-            if (!resources.textureExists(textureName) && !textureName.empty()) {
-                log(LogLevel::WARNING, "Missing texture...");
-            }
-
             vkCmdPushConstants(
                 cmd,
                 pipelineLayout,
@@ -240,16 +327,58 @@ namespace vex {
         VkBuffer vertexBuffers[] = {buffers.vertexBuffer};
         VkDeviceSize offsets[] = {0};
         vkCmdBindVertexBuffers(cmd, 0, 1, vertexBuffers, offsets);
-        vkCmdBindIndexBuffer(cmd, buffers.indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+        vkCmdBindIndexBuffer(cmd, buffers.indexBuffer, 0, buffers.indexType);
+    }
+
+    void VulkanMesh::refreshTextureHandles(VulkanResources& resources) {
+        if (m_textureHandleEpoch == resources.getTextureHandleEpoch()) [[likely]] return;
+
+        m_submeshTextureHandles.resize(m_submeshTextures.size());
+        for (size_t i = 0; i < m_submeshTextures.size(); i++) {
+            if (!resources.isTextureHandleValid(m_submeshTextureHandles[i])) {
+                m_submeshTextureHandles[i] = resources.getTextureHandle(m_submeshTextures[i]);
+            }
+        }
+        // Read after resolving, lazy loads failing right away release slots too.
+        m_textureHandleEpoch = resources.getTextureHandleEpoch();
+    }
+
+    uint32_t VulkanMesh::resolveTextureIndex(VulkanResources& resources, size_t submeshIndex, const MeshComponent& mc) const {
+        uint32_t textureIndex = 0;
+
+        if(!mc.textureOverrides.empty() && mc.textureOverrides.contains(submeshIndex)) [[unlikely]] {
+            std::string textureName = GetAssetPath(mc.textureOverrides.at(submeshIndex));
+            textureIndex = resources.getTextureIndex(textureName);
+            if (textureIndex >= MAX_TEXTURES) {
+                SDL_LogError(SDL_LOG_CATEGORY_RENDER,
+                           "Invalid texture index %u for '%s' (Max: %u)",
+                           textureIndex, textureName.c_str(), MAX_TEXTURES);
+                textureIndex = 0;
+            }
+            if(textureIndex != 0){
+                return textureIndex;
+            }
+        }
+
+        if (submeshIndex < m_submeshTextureHandles.size() && resources.isTextureHandleValid(m_submeshTextureHandles[submeshIndex])) [[likely]] {
+            return m_submeshTextureHandles[submeshIndex].index;
+        }
+
+        textureIndex = resources.getTextureIndex(m_submeshTextures[submeshIndex]);
+        if (textureIndex >= MAX_TEXTURES) {
+            SDL_LogError(SDL_LOG_CATEGORY_RENDER,
+                       "Invalid texture index %u for '%s' (Max: %u)",
+                       textureIndex, m_submeshTextures[submeshIndex].c_str(), MAX_TEXTURES);
+            textureIndex = 0;
+        }
+
+        return textureIndex;
     }
 
     void VulkanMesh::draw(VkCommandBuffer cmd, VkPipelineLayout pipelineLayout,
             VulkanResources& resources, uint32_t frameIndex, uint32_t modelIndex, glm::mat4 modelMatrix, const MeshComponent& mc) const {
 
-        std::string currentTexture = "";
-
-            uint32_t lightsDynamicOffset = modelIndex * static_cast<uint32_t>(sizeof(SceneLightsUBO));
-            uint32_t dynamicOffsets[1] = { lightsDynamicOffset };
+        uint32_t currentTexture = UINT32_MAX;
 
             VkDescriptorSet globalSet = resources.getDescriptorSet(frameIndex);
             vkCmdBindDescriptorSets(
@@ -259,49 +388,19 @@ namespace vex {
                 0,
                 1,
                 &globalSet,
-                1,
-                dynamicOffsets
+                0,
+                nullptr
             );
 
         for (size_t i = 0; i < m_submeshBuffers.size(); i++) {
             const auto& buffers = m_submeshBuffers[i];
-            std::string textureName = "";
-            uint32_t textureIndex = 0;
-            if(mc.textureOverrides.contains(i)){
-                textureName = GetAssetPath(mc.textureOverrides.at(i));
-                textureIndex = resources.getTextureIndex(textureName);
-
-                if(textureIndex == 0){
-                    textureIndex = resources.getTextureIndex(m_submeshTextures[i]);
-                }
-            }else{
-                textureName = m_submeshTextures[i];
-                textureIndex = resources.getTextureIndex(m_submeshTextures[i]);
-            }
-
-            //log("Invalid texture index %u for '%s'", textureIndex, textureName.c_str());
-
-            if (textureIndex >= MAX_TEXTURES) {
-                SDL_LogError(SDL_LOG_CATEGORY_RENDER,
-                           "Invalid texture index %u for '%s' (Max: %u)",
-                           textureIndex, textureName.c_str(), MAX_TEXTURES);
-                textureIndex = 0;
-            }
-
-            const bool textureExists = !textureName.empty() && resources.textureExists(textureName);
-
-            //log("Texture exists: %s, textureName: %s, textureIndex: %d", textureExists ? "true" : "false", textureName.c_str(), textureIndex);
-
-            if (!textureExists) {
-                textureName = "default";
-            }
-
-            PushConstants modelPush{};
+            const auto& range = buffers.lods[std::min(mc.lod, buffers.lodCount - 1)];
+            uint32_t textureIndex = resolveTextureIndex(resources, i, mc);
 
             if (m_r_context.supportsBindlessTextures) {
                     PushConstants modelPush{};
                     modelPush.color = mc.color;
-                    modelPush.model = modelMatrix;
+                    modelPush.model = getDrawMatrix(i, modelMatrix);
                     modelPush.textureID = textureIndex;
 
                     vkCmdPushConstants(
@@ -314,15 +413,15 @@ namespace vex {
                     );
                 }
                 else {
-                    if (currentTexture != textureName) {
+                    if (currentTexture != textureIndex) {
                          VkDescriptorSet texSet = resources.getTextureDescriptorSet(frameIndex, textureIndex);
                          vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 1, 1, &texSet, 0, nullptr);
-                         currentTexture = textureName;
+                         currentTexture = textureIndex;
                     }
 
                     PushConstants modelPush{};
                     modelPush.color = mc.color;
-                    modelPush.model = modelMatrix;
+                    modelPush.model = getDrawMatrix(i, modelMatrix);
 
                     vkCmdPushConstants(cmd, pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(PushConstants), &modelPush);
                 }
@@ -330,9 +429,9 @@ namespace vex {
             VkBuffer vertexBuffers[] = {buffers.vertexBuffer};
             VkDeviceSize offsets[] = {0};
             vkCmdBindVertexBuffers(cmd, 0, 1, vertexBuffers, offsets);
-            vkCmdBindIndexBuffer(cmd, buffers.indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+            vkCmdBindIndexBuffer(cmd, buffers.indexBuffer, 0, buffers.indexType);
 
-            vkCmdDrawIndexed(cmd, buffers.indexCount, 1, 0, 0, 0);
+            vkCmdDrawIndexed(cmd, range.indexCount, 1, range.firstIndex, buffers.vertexOffset, 0);
         }
     }
 }
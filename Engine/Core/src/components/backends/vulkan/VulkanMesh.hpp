@@ -7,12 +7,16 @@
 #pragma once
 #include "context.hpp"
 #include "components/Mesh.hpp"
+#include "components/VertexQuantization.hpp"
 #include "components/errorUtils.hpp"
 #include "Resources.hpp"
+#include "MeshArena.hpp"
 
 #include "components/GameComponents/BasicComponents.hpp"
 
 #include <sys/types.h>
+#include <algorithm>
+#include <array>
 
 namespace vex {
     struct TransparentTriangle;
@@ -25,33 +29,41 @@ namespace vex {
     public:
         /// @brief Constructor for VulkanMesh class.
         /// @param VulkanContext& context - Reference to the VulkanContext object.
-        VulkanMesh(VulkanContext& context);
+        /// @param MeshArena* arena - Shared geometry arena, when null (or full) submeshes get their own buffers.
+        VulkanMesh(VulkanContext& context, MeshArena* arena = nullptr);
         ~VulkanMesh();
 
         /// @brief Uploads mesh data to the GPU.
-        /// @details Creates VMA buffers (`VK_BUFFER_USAGE_VERTEX_BUFFER_BIT` / `INDEX`) and uploads data from `MeshData`. Stores CPU copies of triangle centers for transparency sorting.
+        /// @details Places submeshes in the `MeshArena` and queues their upload, submeshes that don't fit get own host visible VMA buffers. Keeps only submesh centers on the CPU,
+        /// `meshData` isn't referenced after this returns. Indices of `Submesh::lods` are uploaded after the full detail ones.
+        /// Vertices are quantized when `format` is `COMPACT` and submeshes with less than 65536 vertices get 16 bit indices.
         /// @param const MeshData& meshData - The source mesh data.
-        void upload(const MeshData& meshData);
-
-        // @brief Function to extract transparent triangles
-        // @details Transforms triangle centers to world space, calculates distance to camera, and populates `outTriangles` with render data.
-        // @param const glm::mat4& modelMatrix - Model matrix for the mesh.
-        // @param const glm::vec3& cameraPos - Position of the camera.
-        // @param uint32_t modelIndex - Index of the current model.
-        // @param uint32_t frameIndex - Index of the current frame.
-        // @param entt::entity entity - Entity associated with the mesh.
-        // @param std::vector<TransparentTriangle>& outTriangles - Vector to store extracted transparent triangles.
-        void extractTransparentTriangles(
-            const glm::mat4& modelMatrix,
-            const glm::vec3& cameraPos,
-            uint32_t modelIndex,
-            uint32_t frameIndex,
-            entt::entity entity,
-            std::vector<TransparentTriangle>& outTriangles
-        );
+        /// @param VertexFormat format - Vertex layout to upload with, overrides `MeshData::vertexFormat`.
+        void upload(const MeshData& meshData, VertexFormat format);
+
+        /// @brief Uploads mesh data to the GPU with `MeshData::vertexFormat`.
+        /// @param const MeshData& meshData - The source mesh data.
+        void upload(const MeshData& meshData) { upload(meshData, meshData.vertexFormat); }
+
+        /// @brief Moves submeshes placed in the arena to their offsets after `MeshArena::compact`.
+        /// @param const MeshArena::Relocation& relocation - Returned by `compact` of the arena this mesh uses.
+        void relocate(const MeshArena::Relocation& relocation);
+
+        /// @brief Keeps local space triangle centers of full detail submeshes, needed to sort the mesh per triangle when it's drawn transparent.
+        /// @details Separate from `upload` so opaque meshes never hold them. Uses cooked centers when `meshData` has them.
+        /// @param const MeshData& meshData - Same data the mesh was uploaded from.
+        void buildTriangleCenters(const MeshData& meshData);
+
+        /// @brief Returns true once `buildTriangleCenters` was called.
+        /// @return bool
+        bool hasTriangleCenters() const { return m_hasTriangleCenters; }
+
+        /// @brief Returns bytes of CPU memory held by triangle centers.
+        /// @return uint64_t
+        uint64_t getTriangleCenterBytes() const;
 
         /// @brief Draws the mesh to the screen.
-        /// @details Binds buffers, descriptors, and issues draw calls for each submesh. Resolves texture overrides from `MeshComponent`.
+        /// @details Binds buffers, descriptors, and issues draw calls for each submesh. Resolves texture overrides and level of detail from `MeshComponent`.
         /// @param VkCommandBuffer cmd - Command buffer to draw the mesh.
         /// @param VkPipelineLayout pipelineLayout - Pipeline layout for the mesh.
         /// @param VulkanResources& resources - Vulkan resources for the mesh.
@@ -65,12 +77,14 @@ namespace vex {
 
         /// @brief Batch-optimized draw call for sorted transparent triangles.
         /// @details Only re-binds descriptors/buffers if `modelChanged` or `submeshChanged` is true. Used in conjunction with `issueMultiDrawIndexed`.
+        /// Does not look up textures, so it can be called from recording threads.
         /// @param VkCommandBuffer cmd - Command buffer.
         /// @param VkPipelineLayout pipelineLayout - Pipeline layout.
         /// @param VulkanResources& resources - Resource manager.
         /// @param uint32_t frameIndex - Frame index.
         /// @param uint32_t modelIndex - Model index.
         /// @param uint32_t submeshIndex - Submesh index.
+        /// @param uint32_t textureIndex - Texture index resolved with `resolveTextureIndex`.
         /// @param glm::mat4 modelMatrix - Transform matrix.
         /// @param bool modelChanged - Flag indicating if model-level data (matrix/lights) needs rebinding.
         /// @param bool submeshChanged - Flag indicating if submesh-level data (buffers/textures) needs rebinding.
@@ -82,12 +96,94 @@ namespace vex {
                 uint32_t frameIndex,
                 uint32_t modelIndex,
                 uint32_t submeshIndex,
+                uint32_t textureIndex,
                 glm::mat4 modelMatrix,
                 bool modelChanged,
                 bool submeshChanged,
                 const MeshComponent& mc
             ) const;
 
+        /// @brief Geometry of a single submesh, used to build indirect draw commands.
+        struct SubmeshDrawInfo {
+            VkBuffer vertexBuffer;
+            VkBuffer indexBuffer;
+            uint32_t indexCount;
+            uint32_t firstIndex;
+            int32_t vertexOffset;
+            VkIndexType indexType;
+        };
+
+        /// @brief Returns number of uploaded submeshes.
+        /// @return size_t
+        size_t getSubmeshCount() const { return m_submeshBuffers.size(); }
+
+        /// @brief Returns texture path of every submesh, empty for untextured ones.
+        /// @return const std::vector<std::string>&
+        const std::vector<std::string>& getSubmeshTextures() const { return m_submeshTextures; }
+
+        /// @brief Returns buffers and index range of a submesh.
+        /// @param size_t submeshIndex - Index of the submesh.
+        /// @param uint32_t lod - Level of detail, clamped to the coarsest level the submesh has.
+        /// @return SubmeshDrawInfo
+        SubmeshDrawInfo getSubmeshDrawInfo(size_t submeshIndex, uint32_t lod = 0) const {
+            const auto& buffers = m_submeshBuffers[submeshIndex];
+            const auto& range = buffers.lods[std::min(lod, buffers.lodCount - 1)];
+            return { buffers.vertexBuffer, buffers.indexBuffer, range.indexCount, range.firstIndex, buffers.vertexOffset, buffers.indexType };
+        }
+
+        /// @brief Returns number of levels of detail, including full detail. Submeshes with fewer levels reuse their coarsest one.
+        /// @return uint32_t
+        uint32_t getLodCount() const { return static_cast<uint32_t>(m_lodErrors.size()); }
+
+        /// @brief Returns largest error of a level over all submeshes, in mesh units. 0 for full detail.
+        /// @param uint32_t lod - Level of detail, must be below `getLodCount`.
+        /// @return float
+        float getLodError(uint32_t lod) const { return m_lodErrors[lod]; }
+
+        /// @brief Returns vertex layout the mesh was uploaded with, compact meshes have to be drawn with compact pipelines.
+        /// @return VertexFormat
+        VertexFormat getVertexFormat() const { return m_vertexFormat; }
+
+        /// @brief Returns matrix a submesh has to be drawn with, for compact meshes the model matrix with position dequantization folded in.
+        /// @param size_t submeshIndex - Index of the submesh.
+        /// @param const glm::mat4& modelMatrix - Model matrix of the instance.
+        /// @return glm::mat4
+        glm::mat4 getDrawMatrix(size_t submeshIndex, const glm::mat4& modelMatrix) const {
+            if (m_vertexFormat == VertexFormat::STANDARD) return modelMatrix;
+            return modelMatrix * m_submeshDequantization[submeshIndex];
+        }
+
+        /// @brief Returns bytes of vertex and index data uploaded for this mesh.
+        /// @return uint64_t
+        uint64_t getGeometryBytes() const { return m_geometryBytes; }
+
+        /// @brief Returns bytes saved by compact vertices and 16 bit indices, compared to standard vertices with 32 bit indices.
+        /// @return uint64_t
+        uint64_t getGeometryBytesSaved() const { return m_standardGeometryBytes - m_geometryBytes; }
+
+        /// @brief Returns local space centers of submesh triangles, in index order. Empty until `buildTriangleCenters` was called.
+        /// @param size_t submeshIndex - Index of the submesh.
+        /// @return const std::vector<glm::vec3>&
+        const std::vector<glm::vec3>& getTriangleCenters(size_t submeshIndex) const { return m_triangleCenters[submeshIndex]; }
+
+        /// @brief Returns local space center of submesh bounding box.
+        /// @param size_t submeshIndex - Index of the submesh.
+        /// @return glm::vec3
+        glm::vec3 getSubmeshCenter(size_t submeshIndex) const { return m_submeshCenters[submeshIndex]; }
+
+        /// @brief Resolves handles of submesh textures again if any texture slot was released since the last call.
+        /// @details Called once per frame for bound meshes before drawing, after that `resolveTextureIndex` only reads the handles.
+        /// @param VulkanResources& resources - Resource manager used to look up (and lazy load) textures.
+        void refreshTextureHandles(VulkanResources& resources);
+
+        /// @brief Resolves texture index of a submesh, honoring `MeshComponent::textureOverrides`.
+        /// @details Without overrides this is a handle check, names are only looked up if `refreshTextureHandles` wasn't called yet.
+        /// @param VulkanResources& resources - Resource manager used to look up (and lazy load) textures.
+        /// @param size_t submeshIndex - Index of the submesh.
+        /// @param const MeshComponent& mc - Component holding texture overrides.
+        /// @return uint32_t - Texture index, 0 (default texture) if it can't be resolved.
+        uint32_t resolveTextureIndex(VulkanResources& resources, size_t submeshIndex, const MeshComponent& mc) const;
+
         /// @brief Helper function to get number of mesh components using this VulkanMesh instance, needed for mesh manager to know when to unload VulkanMesh.
         /// @return int
         int getNumOfInstances() const { return numOfInstances; }
@@ -99,6 +195,12 @@ namespace vex {
         void removeInstance() { numOfInstances--; }
 
     private:
+        /// @brief Index range of one level of detail, absolute within the index buffer.
+        struct LodRange {
+            uint32_t firstIndex;
+            uint32_t indexCount;
+        };
+
         /// @brief struct used to hold buffers and allocations for each submesh in single object.
         struct SubmeshBuffers {
             VkBuffer vertexBuffer;
@@ -106,6 +208,12 @@ namespace vex {
             VkBuffer indexBuffer;
             VmaAllocation indexAlloc;
             uint32_t indexCount;
+            uint32_t firstIndex;
+            int32_t vertexOffset;
+            VkIndexType indexType;
+            MeshArena::Allocation arenaAlloc;
+            uint32_t lodCount;
+            std::array<LodRange, MAX_MESH_LODS> lods; // lods[0] is indexCount at firstIndex
         };
 
         /// @brief Helper function to stream data to GPU memory.
@@ -115,12 +223,31 @@ namespace vex {
         /// @param size_t sizeBytes Size of data to copy in bytes
         void StreamToGPU(void* dst, const void* src, size_t sizeBytes);
 
+        /// @brief Creates host visible buffers owned by a single submesh, used when there is no arena or it's out of space.
+        /// @param const void* vertices - Vertex data in the format of the mesh.
+        /// @param size_t vertexBytes - Size of vertex data.
+        /// @param const void* indices - Index data of `buffers.indexType`.
+        /// @param size_t indexBytes - Size of index data.
+        /// @param SubmeshBuffers& buffers - Receives created buffers.
+        void createOwnBuffers(const void* vertices, size_t vertexBytes, const void* indices, size_t indexBytes, SubmeshBuffers& buffers);
+
         VulkanContext& m_r_context;
+        MeshArena* m_p_arena = nullptr;
         std::vector<SubmeshBuffers> m_submeshBuffers;
         std::vector<std::string> m_submeshTextures;
+        std::vector<TextureHandle> m_submeshTextureHandles;
+        uint64_t m_textureHandleEpoch = UINT64_MAX; // epoch of VulkanResources handles were resolved at
         int numOfInstances = 0;
 
-        std::vector<Submesh> m_cpuSubmeshData;
+        std::vector<std::vector<glm::vec3>> m_triangleCenters; // per submesh, only filled for meshes drawn transparent
+        bool m_hasTriangleCenters = false;
+        std::vector<glm::vec3> m_submeshCenters;
+
+        VertexFormat m_vertexFormat = VertexFormat::STANDARD;
+        std::vector<glm::mat4> m_submeshDequantization; // only filled for COMPACT
+        uint64_t m_geometryBytes = 0;
+        uint64_t m_standardGeometryBytes = 0;
+        std::vector<float> m_lodErrors; // per level, max over submeshes
     };
 
 /// @brief struct used to held transparent triangles data for sorting and special rendering
@@ -132,6 +259,8 @@ struct TransparentTriangle {
         uint32_t modelIndex;
         uint32_t frameIndex;
         uint32_t firstIndex;
+        // @brief 3 for single triangles, whole submesh when sorting per object
+        uint32_t indexCount;
         uint32_t submeshIndex;
         VulkanMesh* mesh;
         entt::entity entity;
@@ -19,6 +19,7 @@
 #include <string>
 #include <queue>
 #include "components/enviroment.hpp"
+#include "DeferredDeletionQueue.hpp"
 
 namespace vex {
     /// @brief Struct holding all vulkan data, like device, surface, swapchain, images, views, and more.
@@ -29,14 +30,26 @@ namespace vex {
         VkDevice device;
         VkQueue graphicsQueue;
         VkQueue presentQueue;
+        VkQueue transferQueue;
         VmaAllocator allocator;
-        VkSurfaceKHR surface;
+        VkSurfaceKHR surface = VK_NULL_HANDLE;
 
         VkSwapchainKHR swapchain= VK_NULL_HANDLE;
         std::vector<VkImage> swapchainImages;
         VkFormat swapchainImageFormat;
         VkExtent2D swapchainExtent;
         std::vector<VkImageView> swapchainImageViews;
+        /// @brief Allocations of `swapchainImages` in headless mode, where they are plain offscreen images owned by the swapchain manager. Empty otherwise.
+        std::vector<VmaAllocation> offscreenAllocations;
+
+        /// @brief Renders into offscreen images instead of a window swapchain, nothing is acquired or presented.
+        bool headless = false;
+
+        /// @brief Layout composed frames are left in. Headless images stay readable for `Interface::readbackFrame` instead of going to the presentation engine.
+        /// @return VkImageLayout
+        VkImageLayout getFinalImageLayout() const {
+            return headless ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+        }
 
         VkImage depthImage = VK_NULL_HANDLE;
         VmaAllocation depthAllocation = VK_NULL_HANDLE;
@@ -49,6 +62,7 @@ namespace vex {
         VkFormat lowResColorFormat = VK_FORMAT_UNDEFINED;
 
         VkPipelineLayout pipelineLayout;
+        VkPipelineCache pipelineCache = VK_NULL_HANDLE;
 
         std::vector<VkCommandPool> commandPools;
         std::vector<VkCommandBuffer> commandBuffers;
@@ -86,13 +100,27 @@ namespace vex {
             submitInfo.pCommandBuffers = &commandBuffer;
 
             vkQueueSubmit(graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE);
+            idleWaitsThisFrame++;
             vkQueueWaitIdle(graphicsQueue);
 
             vkFreeCommandBuffers(device, singleTimePool, 1, &commandBuffer);
         }
 
+        /// @brief Waits for device idle and counts it in `idleWaitsThisFrame`.
+        /// @details Only for shutdown, swapchain recreation and similar one off events. Resources that frames in flight may still use go to `deletionQueue`.
+        void waitIdle() {
+            idleWaitsThisFrame++;
+            vkDeviceWaitIdle(device);
+        }
+
+        /// @brief Resources waiting until the frames that could use them finished, flushed by the renderer after each frame fence.
+        DeferredDeletionQueue deletionQueue;
+        /// @brief Device and queue idle waits since the current frame began, reported in `RenderStats::idleWaits`. Should stay zero in steady state.
+        uint32_t idleWaitsThisFrame = 0;
+
         uint32_t graphicsQueueFamily;
         uint32_t presentQueueFamily;
+        uint32_t transferQueueFamily; // equal to graphicsQueueFamily if device has no dedicated transfer family
 
         uint32_t currentFrame = 0;
         uint32_t currentImageIndex = 0;
@@ -119,6 +147,9 @@ namespace vex {
         bool supportsIndirectDraw = false;
         bool supportsBindlessTextures = false;
         bool supportsShaderDrawParameters = false;
+        bool supportsPipelineFeedback = false;
+        bool supportsTextureCompressionBC = false;
+        bool supportsMemoryBudget = false;
 
         VkDescriptorSetLayout bindlessDescriptorSetLayout = VK_NULL_HANDLE;
         VkDescriptorPool bindlessDescriptorPool = VK_NULL_HANDLE;
@@ -67,6 +67,15 @@ struct Frustum {
         }
         return true;
     }
+
+    /// @brief Returns planes packed as `xyz` = normal, `w` = distance, for DynamicAABBTree::queryPlanes.
+    std::array<glm::vec4, 6> getPlanes() const {
+        std::array<glm::vec4, 6> packed;
+        for (size_t i = 0; i < planes.size(); i++) {
+            packed[i] = glm::vec4(planes[i].normal, planes[i].distance);
+        }
+        return packed;
+    }
 };
 
 }
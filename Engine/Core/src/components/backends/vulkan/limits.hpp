@@ -12,4 +12,41 @@
 /// @todo Implement something to dynamically allocate resources and not rely on max textures and models
 const uint32_t MAX_TEXTURES = 4096; // This is already a little too much for my liking, i need to change how textures are stored/sent to gpu
 const uint32_t MAX_MODELS = 8192; // This can be much higher no problem, but you probably wont even be able to use it as long as you used textured models.
-const uint32_t MAX_DYNAMIC_LIGHTS = 255; // This should not be much higher, thats effectivelly per object (or at least should be), so its probably too much.
+const uint32_t MAX_INDIRECT_DRAWS = 10000; // Max opaque + masked submesh draws recorded through the indirect path per frame.
+const uint32_t MAX_DYNAMIC_LIGHTS = 255; // Max lights affecting a single light cluster, anything above that is dropped for that cluster.
+const uint32_t MAX_SCENE_LIGHTS = 4096; // Max lights uploaded to the gpu each frame.
+
+const uint32_t CLUSTER_GRID_X = 16; // Light cluster tiles across the screen.
+const uint32_t CLUSTER_GRID_Y = 9; // Light cluster tiles along the screen height.
+const uint32_t CLUSTER_GRID_Z = 24; // Exponential depth slices between near and far plane.
+const uint32_t CLUSTER_COUNT = (CLUSTER_GRID_X + 2) * (CLUSTER_GRID_Y + 2) * (CLUSTER_GRID_Z + 2); // Grid plus a one cluster border outside the frustum.
+const uint32_t MAX_CLUSTER_LIGHT_INDICES = CLUSTER_COUNT * 64; // Shared light index list for all clusters.
+
+const uint64_t MESH_ARENA_VERTEX_BYTES = 128ull * 1024 * 1024; // Device local vertex arena shared by all meshes.
+const uint64_t MESH_ARENA_INDEX_BYTES = 64ull * 1024 * 1024; // Device local index arena shared by all meshes.
+const uint64_t MESH_ARENA_STAGING_BYTES = 16ull * 1024 * 1024; // Staging ring used to fill the arenas, bigger meshes are uploaded in chunks.
+const float MESH_ARENA_COMPACT_FRAGMENTATION = 0.5f; // Arena is compacted once its biggest free block is smaller than this share of its free bytes.
+
+const uint32_t MAX_RECORD_THREADS = 16; // Upper limit of threads recording secondary command buffers.
+const uint32_t DEFAULT_RECORD_THREADS = 4; // Used unless Renderer::setRecordThreadCount is called, capped by hardware threads.
+const uint32_t MIN_DRAWS_PER_RECORD_TASK = 128; // Smaller passes are recorded in fewer chunks, secondary buffers aren't free.
+
+const uint32_t MAX_TEXTURE_DECODE_THREADS = 4; // Worker threads decoding texture files for the async loader, capped by hardware threads.
+const uint64_t TEXTURE_UPLOAD_BATCH_BYTES = 64ull * 1024 * 1024; // Staging bytes recorded into one transfer submit, a bigger single texture still goes alone.
+
+const uint32_t MAX_MESH_IMPORT_THREADS = 2; // Worker threads importing meshes for the async loader, capped by hardware threads. Imports are memory heavy, so fewer than texture decoders.
+const uint32_t MESH_UPLOADS_PER_FRAME = 4; // Asynchronously imported meshes uploaded per frame, the rest waits so a scene load doesn't become one long frame.
+
+const uint32_t TEXTURE_STREAMING_MIN_SIZE = 64; // Streamed textures are first loaded and never evicted below a mip this many texels on the longer side.
+const uint32_t TEXTURE_STREAMING_IDLE_FRAMES = 120; // Texture not drawn for this many frames only needs its smallest mip.
+const uint32_t TEXTURE_STREAMING_MAX_REQUESTS = 4; // Residency changes started per frame, each one reloads the texture from its new top mip.
+const float TEXTURE_STREAMING_HEAP_FRACTION = 0.8f; // Part of the device local heap budget usable by textures when no explicit budget is set.
+
+const uint32_t MAX_GPU_SCOPES = 64; // GPU profiler scopes measured per frame, further ones are ignored.
+const uint32_t GPU_PROFILER_HISTORY = 120; // Frames kept per GPU profiler scope for min/avg/max.
+
+const uint32_t HEADLESS_IMAGE_COUNT = 3; // Offscreen targets used in rotation when rendering without a window, one per frame in flight.
+
+const float LOD_HYSTERESIS = 0.25f; // Coarser LOD is only picked once its error is this fraction below the threshold, stops popping at the boundary.
+
+const uint32_t TRANSPARENT_SORT_MOVES_PER_ITEM = 4; // Reusing last frame order of transparent geometry gives up past this many insertion sort moves per item and radix sorts instead.
@@ -35,6 +35,11 @@ namespace vex {
 
         alignas(16) glm::vec4 fogColor = glm::vec4(0.0f);
         alignas(16) glm::vec2 fogDistances;
+
+        /// @brief xyz = light cluster grid size, w = number of lights uploaded this frame.
+        alignas(16) glm::uvec4 clusterGrid;
+        /// @brief x = near plane, y = far plane, z = depth slice scale, w = depth slice bias.
+        alignas(16) glm::vec4 clusterDepth;
     };
 
     /// @brief Light struct for shader
@@ -43,10 +48,10 @@ namespace vex {
         glm::vec4 color = glm::vec4(0.0f);    // w = intensity
     };
 
-    /// @brief Scene lights uniform buffer object.
-    struct alignas(256) SceneLightsUBO {
-        alignas(4) uint32_t lightCount;
-        alignas(16) Light lights[MAX_DYNAMIC_LIGHTS]; // Light is already glm::vec4 position + glm::vec4 color
+    /// @brief Light cluster entry for shader, points to a range in the light index list.
+    struct LightCluster {
+        uint32_t offset = 0;
+        uint32_t count = 0;
     };
 
     /// @brief Push constants, holds model information.
@@ -54,6 +59,15 @@ namespace vex {
         alignas(16) glm::vec4 color;
         alignas(16) glm::mat4 model;
         alignas(4)  int textureID = 0;
+        /// @brief When non zero shaders read model, color and texture from DrawData at the instance index instead.
+        alignas(4)  int useDrawData = 0;
+    };
+
+    /// @brief Per draw data for indirect rendering, indexed in shaders by firstInstance of the draw command.
+    struct alignas(16) DrawData {
+        glm::mat4 model;
+        glm::vec4 color;
+        int textureID = 0;
     };
 
     /// @brief PS1Effects namespace for easier setting of them in push constant.
@@ -1,6 +1,8 @@
 #include "components/pathUtils.hpp"
 #include "components/errorUtils.hpp"
 
+#include <SDL3/SDL_filesystem.h>
+
 #ifdef _WIN32
 #include <windows.h>
 #elif defined(__APPLE__)
@@ -89,4 +91,23 @@ std::filesystem::path GetLogDir() {
     }
 }
 
+std::filesystem::path GetUserDataDir(const std::string& appName) {
+    if (char* prefPath = SDL_GetPrefPath("VEX", appName.empty() ? "VEX" : appName.c_str())) {
+        std::filesystem::path dir(prefPath);
+        SDL_free(prefPath);
+        return dir;
+    }
+
+    std::filesystem::path dir;
+    try {
+        dir = GetExecutableDir() / "Engine" / "cache";
+        if (!std::filesystem::exists(dir)) {
+            std::filesystem::create_directories(dir);
+        }
+        return dir;
+    } catch (...) {
+        return std::filesystem::current_path();
+    }
+}
+
 } // namespace vex
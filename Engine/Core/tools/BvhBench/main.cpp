@@ -0,0 +1,258 @@
+#include "components/DynamicAABBTree.hpp"
+#include "components/backends/vulkan/frustum.hpp"
+#include "common/ToolCommon.hpp"
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+    using vex::tools::parseCount;
+    using vex::tools::millisecondsSince;
+
+    struct BenchSettings {
+        std::vector<uint32_t> entities = { 10000, 100000, 1000000 };
+        uint32_t frames = 60;
+        uint32_t moving = 10;
+        uint32_t farPlane = 200;
+        uint32_t seed = 1;
+        std::string output;
+    };
+
+    void printUsage() {
+        std::cerr << "Usage: vex_bvh_bench [--entities N] [--frames F] [--moving PERCENT] [--far DISTANCE] [--seed S] [--out results.json]\n";
+        std::cerr << "  Scatters N bounding spheres (10k, 100k and 1M when not given) at constant density and for F frames moves PERCENT of\n";
+        std::cerr << "  them, culls them against a turning camera frustum reaching DISTANCE and runs a sphere query, once by testing every\n";
+        std::cerr << "  sphere and once through DynamicAABBTree. Both must find the same entities.\n";
+    }
+
+    struct Sphere {
+        glm::vec3 center;
+        float radius;
+    };
+
+    /// Order independent fingerprint of a result set, the tree reports entities in a different order than the linear scan.
+    struct ResultSet {
+        uint64_t count = 0;
+        uint64_t hash = 0;
+
+        void add(uint32_t id) {
+            count++;
+            hash += (static_cast<uint64_t>(id) + 1) * 0x9E3779B97F4A7C15ull;
+        }
+
+        bool operator==(const ResultSet& other) const { return count == other.count && hash == other.hash; }
+    };
+
+    struct QueryResult {
+        double linearMs = 0.0;
+        double bvhMs = 0.0;
+        uint64_t found = 0;
+        bool identical = true;
+
+        nlohmann::json toJson(uint32_t frames, uint32_t entities) const {
+            return {
+                {"linearMs", linearMs / frames},
+                {"bvhMs", bvhMs / frames},
+                {"speedup", bvhMs > 0.0 ? linearMs / bvhMs : 0.0},
+                {"foundPerFrame", static_cast<double>(found) / frames},
+                {"foundShare", entities > 0 ? static_cast<double>(found) / frames / entities : 0.0},
+                {"identical", identical}
+            };
+        }
+    };
+
+    struct RunResult {
+        uint32_t entities = 0;
+        double buildMs = 0.0;
+        double updateMs = 0.0;
+        uint64_t reinserts = 0;
+        int32_t height = 0;
+        QueryResult frustum;
+        QueryResult sphere;
+    };
+
+    RunResult run(const BenchSettings& settings, uint32_t count) {
+        RunResult result;
+        result.entities = count;
+
+        // Constant density, one entity per 64 cubic units. Bigger scenes fill more of the frustum until they reach past the far plane,
+        // from there on only the share of entities it sees drops.
+        const float halfExtent = std::cbrt(static_cast<float>(count) * 64.0f) * 0.5f;
+        std::mt19937 random(settings.seed);
+        auto uniform = [&](float min, float max) { return std::uniform_real_distribution<float>(min, max)(random); };
+
+        std::vector<Sphere> spheres(count);
+        for (auto& sphere : spheres) {
+            sphere.center = glm::vec3(uniform(-halfExtent, halfExtent), uniform(-halfExtent, halfExtent), uniform(-halfExtent, halfExtent));
+            sphere.radius = uniform(0.5f, 2.0f);
+        }
+
+        vex::DynamicAABBTree tree;
+        std::vector<int32_t> proxies(count);
+        auto start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < count; i++) {
+            proxies[i] = tree.createProxy(vex::AABB::fromSphere(spheres[i].center, spheres[i].radius), i);
+        }
+        result.buildMs = millisecondsSince(start);
+
+        glm::mat4 proj = glm::perspective(glm::radians(70.0f), 16.0f / 9.0f, 0.1f, static_cast<float>(settings.farPlane));
+        proj[1][1] *= -1;
+        const uint32_t moving = static_cast<uint32_t>(static_cast<uint64_t>(count) * settings.moving / 100);
+
+        for (uint32_t frame = 0; frame < settings.frames; frame++) {
+            // Movers drift a little every frame, like animated objects, and sometimes jump, like teleported ones.
+            start = std::chrono::steady_clock::now();
+            for (uint32_t m = 0; m < moving; m++) {
+                const uint32_t i = random() % count;
+                Sphere& sphere = spheres[i];
+                if (random() % 64 == 0) {
+                    sphere.center = glm::vec3(uniform(-halfExtent, halfExtent), uniform(-halfExtent, halfExtent), uniform(-halfExtent, halfExtent));
+                } else {
+                    sphere.center = sphere.center + glm::vec3(uniform(-0.05f, 0.05f), uniform(-0.05f, 0.05f), uniform(-0.05f, 0.05f));
+                }
+                result.reinserts += tree.moveProxy(proxies[i], vex::AABB::fromSphere(sphere.center, sphere.radius)) ? 1 : 0;
+            }
+            result.updateMs += millisecondsSince(start);
+
+            const float yaw = static_cast<float>(frame) * 0.1f;
+            const glm::vec3 eye(0.0f, 0.0f, 0.0f);
+            const glm::mat4 view = glm::lookAt(eye, glm::vec3(std::sin(yaw), 0.1f, -std::cos(yaw)), glm::vec3(0.0f, 1.0f, 0.0f));
+            vex::Frustum frustum;
+            frustum.update(proj * view);
+
+            // Renderer did this before the tree, every sphere against six planes.
+            ResultSet linear;
+            start = std::chrono::steady_clock::now();
+            for (uint32_t i = 0; i < count; i++) {
+                if (frustum.testSphere(spheres[i].center, spheres[i].radius)) linear.add(i);
+            }
+            result.frustum.linearMs += millisecondsSince(start);
+
+            // Same as Renderer, only spheres in boxes that straddle a plane get the exact test.
+            ResultSet hierarchical;
+            start = std::chrono::steady_clock::now();
+            tree.queryPlanes(frustum.getPlanes(), [&](uint32_t id, bool fullyInside) {
+                if (fullyInside || frustum.testSphere(spheres[id].center, spheres[id].radius)) hierarchical.add(id);
+                return true;
+            });
+            result.frustum.bvhMs += millisecondsSince(start);
+            result.frustum.found += linear.count;
+            result.frustum.identical = result.frustum.identical && linear == hierarchical;
+
+            // Gameplay style query, everything touching a 10 unit sphere.
+            const glm::vec3 center(uniform(-halfExtent, halfExtent), uniform(-halfExtent, halfExtent), uniform(-halfExtent, halfExtent));
+            const float radius = 10.0f;
+            auto touches = [&](const Sphere& sphere) {
+                const glm::vec3 offset = sphere.center - center;
+                const float reach = sphere.radius + radius;
+                return glm::dot(offset, offset) <= reach * reach;
+            };
+
+            ResultSet linearSphere;
+            start = std::chrono::steady_clock::now();
+            for (uint32_t i = 0; i < count; i++) {
+                if (touches(spheres[i])) linearSphere.add(i);
+            }
+            result.sphere.linearMs += millisecondsSince(start);
+
+            ResultSet treeSphere;
+            start = std::chrono::steady_clock::now();
+            tree.querySphere(center, radius, [&](uint32_t id) {
+                if (touches(spheres[id])) treeSphere.add(id);
+                return true;
+            });
+            result.sphere.bvhMs += millisecondsSince(start);
+            result.sphere.found += linearSphere.count;
+            result.sphere.identical = result.sphere.identical && linearSphere == treeSphere;
+        }
+
+        result.height = tree.getHeight();
+        return result;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    BenchSettings settings;
+    bool customEntities = false;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            printUsage();
+            return 1;
+        }
+
+        bool valid = true;
+        if (arg == "--entities") {
+            uint32_t entities = 0;
+            valid = parseCount(argv[++i], entities) && entities > 0;
+            if (!customEntities) settings.entities.clear();
+            customEntities = true;
+            settings.entities.push_back(entities);
+        } else if (arg == "--frames") {
+            valid = parseCount(argv[++i], settings.frames) && settings.frames > 0;
+        } else if (arg == "--moving") {
+            valid = parseCount(argv[++i], settings.moving) && settings.moving <= 100;
+        } else if (arg == "--far") {
+            valid = parseCount(argv[++i], settings.farPlane) && settings.farPlane > 0;
+        } else if (arg == "--seed") {
+            valid = parseCount(argv[++i], settings.seed);
+        } else if (arg == "--out") {
+            settings.output = argv[++i];
+        } else {
+            valid = false;
+        }
+
+        if (!valid) {
+            printUsage();
+            return 1;
+        }
+    }
+
+    nlohmann::json result;
+    result["settings"] = {
+        {"entities", settings.entities},
+        {"frames", settings.frames},
+        {"moving", settings.moving},
+        {"far", settings.farPlane},
+        {"seed", settings.seed}
+    };
+
+    bool identical = true;
+    for (uint32_t count : settings.entities) {
+        const RunResult measured = run(settings, count);
+        identical = identical && measured.frustum.identical && measured.sphere.identical;
+        result["runs"].push_back({
+            {"entities", measured.entities},
+            {"buildMs", measured.buildMs},
+            {"updateMs", measured.updateMs / settings.frames},
+            {"reinsertsPerFrame", static_cast<double>(measured.reinserts) / settings.frames},
+            {"treeHeight", measured.height},
+            {"frustum", measured.frustum.toJson(settings.frames, measured.entities)},
+            {"sphere", measured.sphere.toJson(settings.frames, measured.entities)}
+        });
+    }
+    result["identical"] = identical;
+
+    if (settings.output.empty()) {
+        std::cout << result.dump(2) << std::endl;
+    } else {
+        std::ofstream output(settings.output, std::ios::trunc);
+        if (!(output << result.dump(2) << std::endl)) {
+            std::cerr << "Failed to write " << settings.output << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
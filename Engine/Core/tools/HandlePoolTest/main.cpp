@@ -0,0 +1,338 @@
+#include "components/Handle.hpp"
+#include "components/types.hpp"
+#include "common/ToolCommon.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+    using vex::tools::parseCount;
+    using vex::tools::millisecondsSince;
+    using vex::tools::CaseResult;
+    using vex::tools::reportCase;
+
+    struct TestSettings {
+        uint32_t operations = 200000;
+        uint32_t objects = 500;
+        uint32_t draws = 20000;
+        uint32_t seed = 1;
+        bool fullWrap = false;
+        std::string output;
+    };
+
+    void printUsage() {
+        std::cerr << "Usage: vex_handle_pool_test [--operations N] [--objects M] [--draws D] [--seed S] [--full-wrap 0|1] [--out results.json]\n";
+        std::cerr << "  Checks HandlePool rejects handles whose slot was freed and reused, retires a slot once its generation runs out instead of\n";
+        std::cerr << "  wrapping to a generation an old handle may still carry, and matches a reference model over N random inserts and erases.\n";
+        std::cerr << "  Then times D lookups per frame of M objects by path string and by handle. --full-wrap 1 also cycles one slot of the\n";
+        std::cerr << "  default pool through all 2^32 generations, which takes tens of seconds. Exits with 1 on any failure.\n";
+    }
+
+    struct TestTag {};
+    using TestHandle = vex::Handle<TestTag>;
+
+    CaseResult testNullHandle() {
+        CaseResult result;
+        vex::HandlePool<int, TestTag> pool;
+        const TestHandle null;
+        result.check(null.isNull(), "default handle is null");
+        result.check(pool.get(null) == nullptr && !pool.contains(null), "null handle resolves to nothing in an empty pool");
+
+        const TestHandle handle = pool.insert(7);
+        result.check(!handle.isNull() && handle.generation != null.generation, "inserted handle is not null and its generation differs from the default one");
+        result.check(pool.get(null) == nullptr, "null handle resolves to nothing once slot 0 is live");
+        result.check(pool.get({ handle.index, 0 }) == nullptr, "generation 0 never resolves");
+        result.check(!pool.erase(null) && pool.size() == 1, "erasing the null handle does nothing");
+        return result;
+    }
+
+    CaseResult testStaleReuse() {
+        CaseResult result;
+        vex::HandlePool<int, TestTag> pool;
+        const TestHandle a = pool.insert(1);
+        const TestHandle b = pool.insert(2);
+        result.check(pool.get(a) && *pool.get(a) == 1 && pool.get(b) && *pool.get(b) == 2, "live handles resolve to their objects");
+
+        result.check(pool.erase(a), "erasing a live handle succeeds");
+        result.check(!pool.erase(a), "erasing it twice fails");
+        result.check(pool.get(a) == nullptr && !pool.contains(a), "erased handle is stale before its slot is reused");
+
+        const TestHandle c = pool.insert(3);
+        result.check(c.index == a.index, "freed slot is reused");
+        result.check(c.generation != a.generation, "reused slot gets a new generation");
+        result.check(pool.get(a) == nullptr, "stale handle does not resolve to the object that reused its slot");
+        result.check(!pool.erase(a) && pool.get(c) && *pool.get(c) == 3, "erasing through a stale handle leaves the new object alone");
+        result.check(pool.get(b) && *pool.get(b) == 2, "other slots are untouched");
+        result.check(pool.get({ b.index + 10, b.generation }) == nullptr, "index past the end resolves to nothing");
+        result.check(pool.size() == 2, "size counts live objects");
+
+        pool.clear();
+        result.check(pool.size() == 0 && !pool.contains(b) && !pool.contains(c), "clear makes every handle stale");
+        const TestHandle d = pool.insert(4);
+        const TestHandle e = pool.insert(5);
+        result.check(pool.get(b) == nullptr && pool.get(c) == nullptr, "handles from before clear stay stale after their slots are reused");
+        result.check(pool.get(d) && *pool.get(d) == 4 && pool.get(e) && *pool.get(e) == 5, "slots freed by clear are reused");
+        return result;
+    }
+
+    CaseResult testGenerationWrap() {
+        CaseResult result;
+        // Generations 1 to 3, the slot is retired when the fourth would be handed out.
+        vex::HandlePool<int, TestTag, 4> pool;
+        std::vector<TestHandle> old;
+        for (int i = 0; i < 3; i++) {
+            const TestHandle handle = pool.insert(i);
+            result.check(handle.index == 0, "one slot is cycled while it has generations left");
+            old.push_back(handle);
+            pool.erase(handle);
+        }
+        result.check(pool.retiredCount() == 1, "slot is retired once it ran out of generations");
+
+        std::vector<TestHandle> fresh;
+        for (int i = 0; i < 16; i++) {
+            const TestHandle handle = pool.insert(100 + i);
+            result.check(handle.index != 0, "retired slot is never handed out again");
+            fresh.push_back(handle);
+        }
+        for (const TestHandle& handle : old) {
+            result.check(pool.get(handle) == nullptr, "handles of a retired slot stay stale");
+        }
+        for (int i = 0; i < 16; i++) {
+            result.check(pool.get(fresh[i]) && *pool.get(fresh[i]) == 100 + i, "other slots keep working after one is retired");
+        }
+
+        pool.clear();
+        result.check(pool.size() == 0 && pool.retiredCount() == 1, "clear only retires slots that ran out of generations");
+        return result;
+    }
+
+    struct FullWrapResult {
+        CaseResult checks;
+        uint64_t cycles = 0;
+        double milliseconds = 0.0;
+    };
+
+    /// Cycles one slot of the default pool through every generation it has.
+    FullWrapResult testFullWrap() {
+        FullWrapResult result;
+        vex::HandlePool<uint32_t, TestTag> pool;
+        const TestHandle first = pool.insert(0);
+        pool.erase(first);
+
+        auto start = std::chrono::steady_clock::now();
+        TestHandle last = first;
+        while (pool.retiredCount() == 0) {
+            last = pool.insert(0);
+            if (last.index != first.index) break;
+            pool.erase(last);
+            result.cycles++;
+        }
+        result.milliseconds = millisecondsSince(start);
+
+        result.checks.check(pool.retiredCount() == 1, "slot is retired after its last generation");
+        result.checks.check(result.cycles == UINT32_MAX - 2, "slot was handed out once for every generation from 2 to UINT32_MAX - 1 after the first");
+        const TestHandle next = pool.insert(0);
+        result.checks.check(next.index != first.index, "retired slot is not reused");
+        result.checks.check(pool.get(first) == nullptr && pool.get(last) == nullptr, "first and last handle of the retired slot are stale");
+        return result;
+    }
+
+    /// Runs random inserts and erases against a list of every handle ever given out, checking each one still resolves exactly while it is alive.
+    template <uint32_t MaxGeneration>
+    CaseResult testRandomOperations(const TestSettings& settings, size_t& retired) {
+        CaseResult result;
+        vex::HandlePool<uint32_t, TestTag, MaxGeneration> pool;
+        std::mt19937 random(settings.seed);
+
+        struct Issued {
+            TestHandle handle;
+            uint32_t value;
+            bool alive;
+        };
+        std::vector<Issued> issued;
+        std::vector<size_t> live;
+
+        for (uint32_t op = 0; op < settings.operations; op++) {
+            // Keeps the live count around a few dozen so slots get reused a lot.
+            const bool insert = live.empty() || (live.size() < 64 && random() % 2 == 0);
+            if (insert) {
+                const TestHandle handle = pool.insert(op);
+                result.check(!handle.isNull(), "insert never returns the null handle");
+                live.push_back(issued.size());
+                issued.push_back({ handle, op, true });
+            } else {
+                const size_t pick = random() % live.size();
+                Issued& victim = issued[live[pick]];
+                result.check(pool.erase(victim.handle), "erasing a live handle succeeds");
+                victim.alive = false;
+                live[pick] = live.back();
+                live.pop_back();
+            }
+
+            // Full sweep now and then, plus a few random old handles every step.
+            if (op % 1024 == 0) {
+                for (const Issued& entry : issued) {
+                    const uint32_t* value = pool.get(entry.handle);
+                    result.check(entry.alive == (value != nullptr), "handle resolves exactly while its object is alive");
+                    result.check(!value || *value == entry.value, "live handle resolves to its own object");
+                }
+            }
+            for (int probe = 0; probe < 4; probe++) {
+                const Issued& entry = issued[random() % issued.size()];
+                const uint32_t* value = pool.get(entry.handle);
+                result.check(entry.alive == (value != nullptr), "handle resolves exactly while its object is alive");
+                result.check(!value || *value == entry.value, "live handle resolves to its own object");
+            }
+            result.check(pool.size() == live.size(), "size matches the number of live objects");
+        }
+        retired = pool.retiredCount();
+        return result;
+    }
+
+    struct LookupBench {
+        double pathNsPerDraw = 0.0;
+        double handleNsPerDraw = 0.0;
+        uint64_t checksum = 0;
+    };
+
+    /// Per draw lookup as the renderer did it before handles (path string into vex_map) against the handle lookup it does now.
+    LookupBench benchLookups(const TestSettings& settings) {
+        struct Object {
+            uint64_t payload;
+        };
+
+        vex::vex_map<std::string, Object> byPath;
+        vex::HandlePool<Object, TestTag> pool;
+        std::vector<std::string> paths;
+        std::vector<TestHandle> handles;
+        for (uint32_t i = 0; i < settings.objects; i++) {
+            paths.push_back("Assets/meshes/props/object_" + std::to_string(i) + ".obj");
+            byPath[paths.back()] = { i + 1 };
+            handles.push_back(pool.insert({ i + 1 }));
+        }
+
+        // Draws reference objects in random order, like entities of a scene do.
+        std::mt19937 random(settings.seed);
+        std::vector<uint32_t> drawObjects(settings.draws);
+        for (uint32_t& object : drawObjects) {
+            object = random() % settings.objects;
+        }
+
+        constexpr int FRAMES = 20;
+        LookupBench bench;
+        uint64_t pathSum = 0, handleSum = 0;
+
+        auto start = std::chrono::steady_clock::now();
+        for (int frame = 0; frame < FRAMES; frame++) {
+            for (uint32_t object : drawObjects) {
+                auto it = byPath.find(paths[object]);
+                if (it != byPath.end()) pathSum += it->second.payload;
+            }
+        }
+        bench.pathNsPerDraw = millisecondsSince(start) * 1.0e6 / (static_cast<double>(FRAMES) * settings.draws);
+
+        start = std::chrono::steady_clock::now();
+        for (int frame = 0; frame < FRAMES; frame++) {
+            for (uint32_t object : drawObjects) {
+                if (const Object* found = pool.get(handles[object])) handleSum += found->payload;
+            }
+        }
+        bench.handleNsPerDraw = millisecondsSince(start) * 1.0e6 / (static_cast<double>(FRAMES) * settings.draws);
+
+        // Both sums go to the output, so neither loop can be dropped, and they must agree.
+        bench.checksum = pathSum == handleSum ? pathSum : 0;
+        return bench;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    TestSettings settings;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            printUsage();
+            return 1;
+        }
+
+        bool valid = true;
+        uint32_t flag = 0;
+        if (arg == "--operations") {
+            valid = parseCount(argv[++i], settings.operations) && settings.operations > 0;
+        } else if (arg == "--objects") {
+            valid = parseCount(argv[++i], settings.objects) && settings.objects > 0;
+        } else if (arg == "--draws") {
+            valid = parseCount(argv[++i], settings.draws) && settings.draws > 0;
+        } else if (arg == "--seed") {
+            valid = parseCount(argv[++i], settings.seed);
+        } else if (arg == "--full-wrap") {
+            valid = parseCount(argv[++i], flag) && flag <= 1;
+            settings.fullWrap = flag == 1;
+        } else if (arg == "--out") {
+            settings.output = argv[++i];
+        } else {
+            valid = false;
+        }
+
+        if (!valid) {
+            printUsage();
+            return 1;
+        }
+    }
+
+    bool passed = true;
+    nlohmann::json result;
+    result["settings"] = {
+        {"operations", settings.operations},
+        {"objects", settings.objects},
+        {"draws", settings.draws},
+        {"seed", settings.seed},
+        {"fullWrap", settings.fullWrap}
+    };
+    result["nullHandle"] = reportCase(testNullHandle(), passed);
+    result["staleReuse"] = reportCase(testStaleReuse(), passed);
+    result["generationWrap"] = reportCase(testGenerationWrap(), passed);
+
+    size_t retired = 0;
+    result["randomOperations"] = reportCase(testRandomOperations<UINT32_MAX>(settings, retired), passed);
+    result["randomOperations"]["retiredSlots"] = retired;
+    // Few generations per slot, so slots get retired while random handles are still being checked.
+    result["randomOperationsShortGenerations"] = reportCase(testRandomOperations<8>(settings, retired), passed);
+    result["randomOperationsShortGenerations"]["retiredSlots"] = retired;
+
+    if (settings.fullWrap) {
+        const FullWrapResult wrap = testFullWrap();
+        result["fullWrap"] = reportCase(wrap.checks, passed);
+        result["fullWrap"]["cycles"] = wrap.cycles;
+        result["fullWrap"]["milliseconds"] = wrap.milliseconds;
+    }
+
+    const LookupBench bench = benchLookups(settings);
+    CaseResult benchChecks;
+    benchChecks.check(bench.checksum != 0, "path and handle lookups find the same objects");
+    result["lookup"] = reportCase(benchChecks, passed);
+    result["lookup"]["pathNsPerDraw"] = bench.pathNsPerDraw;
+    result["lookup"]["handleNsPerDraw"] = bench.handleNsPerDraw;
+    result["lookup"]["checksum"] = bench.checksum;
+    result["passed"] = passed;
+
+    if (settings.output.empty()) {
+        std::cout << result.dump(2) << std::endl;
+    } else {
+        std::ofstream output(settings.output, std::ios::trunc);
+        if (!(output << result.dump(2) << std::endl)) {
+            std::cerr << "Failed to write " << settings.output << std::endl;
+            return 1;
+        }
+    }
+    return passed ? 0 : 1;
+}
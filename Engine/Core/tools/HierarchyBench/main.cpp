@@ -0,0 +1,183 @@
+#include "components/HierarchySystem.hpp"
+#include "common/ToolCommon.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+    using vex::tools::parseCount;
+    using vex::tools::millisecondsSince;
+
+    struct BenchSettings {
+        uint32_t objects = 50000;
+        uint32_t destroy = 10000;
+        uint32_t children = 8;
+        uint32_t seed = 1;
+        std::string output;
+    };
+
+    void printUsage() {
+        std::cerr << "Usage: vex_hierarchy_bench [--objects N] [--destroy D] [--children C] [--seed S] [--out results.json]\n";
+        std::cerr << "  Builds a tree of N transforms with C children per parent and destroys D random ones, first unparenting children by\n";
+        std::cerr << "  scanning every transform like GameObject::Destroy used to, then through HierarchySystem. Also times D random reparents.\n";
+    }
+
+    std::vector<entt::entity> buildScene(entt::registry& registry, const BenchSettings& settings) {
+        std::vector<entt::entity> entities(settings.objects);
+        for (uint32_t i = 0; i < settings.objects; i++) {
+            entities[i] = registry.create();
+            const entt::entity parent = i == 0 ? entt::entity{ entt::null } : entities[(i - 1) / settings.children];
+            registry.emplace<vex::TransformComponent>(entities[i], registry, glm::vec3(static_cast<float>(i % 13), 0.0f, 0.0f), parent);
+        }
+        return entities;
+    }
+
+    /// Counts transforms whose parent isn't linked back through the relationship lists, plus child counts that don't match their list.
+    uint32_t countBrokenLinks(const entt::registry& registry) {
+        uint32_t broken = 0;
+        for (auto [entity, transform] : registry.view<vex::TransformComponent>().each()) {
+            const entt::entity parent = transform.getParent();
+            if (vex::HierarchySystem::getParent(registry, entity) != parent) {
+                broken++;
+                continue;
+            }
+            if (parent == entt::null) continue;
+            const auto children = vex::HierarchySystem::getChildren(registry, parent);
+            if (std::find(children.begin(), children.end(), entity) == children.end()) broken++;
+        }
+        for (auto [entity, relationship] : registry.view<vex::RelationshipComponent>().each()) {
+            if (vex::HierarchySystem::getChildren(registry, entity).size() != relationship.childCount) broken++;
+        }
+        return broken;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    BenchSettings settings;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            printUsage();
+            return 1;
+        }
+
+        bool valid = true;
+        if (arg == "--objects") {
+            valid = parseCount(argv[++i], settings.objects) && settings.objects > 0;
+        } else if (arg == "--destroy") {
+            valid = parseCount(argv[++i], settings.destroy);
+        } else if (arg == "--children") {
+            valid = parseCount(argv[++i], settings.children) && settings.children > 0;
+        } else if (arg == "--seed") {
+            valid = parseCount(argv[++i], settings.seed);
+        } else if (arg == "--out") {
+            settings.output = argv[++i];
+        } else {
+            valid = false;
+        }
+
+        if (!valid) {
+            printUsage();
+            return 1;
+        }
+    }
+    settings.destroy = std::min(settings.destroy, settings.objects);
+
+    std::mt19937 random(settings.seed);
+    std::vector<uint32_t> victims(settings.objects);
+    for (uint32_t i = 0; i < settings.objects; i++) victims[i] = i;
+    std::shuffle(victims.begin(), victims.end(), random);
+    victims.resize(settings.destroy);
+
+    // Without the system nothing links the transforms, setParent only finds no relationship to update.
+    entt::registry scanRegistry;
+    const auto scanEntities = buildScene(scanRegistry, settings);
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t victim : victims) {
+        const entt::entity destroyed = scanEntities[victim];
+        for (auto [entity, transform] : scanRegistry.view<vex::TransformComponent>().each()) {
+            if (transform.getParent() == destroyed) {
+                transform.setParent(entt::null);
+            }
+        }
+        scanRegistry.destroy(destroyed);
+    }
+    const double scanMs = millisecondsSince(start);
+
+    entt::registry registry;
+    vex::HierarchySystem hierarchy(registry);
+    start = std::chrono::steady_clock::now();
+    const auto entities = buildScene(registry, settings);
+    const double buildMs = millisecondsSince(start);
+
+    start = std::chrono::steady_clock::now();
+    for (uint32_t victim : victims) {
+        registry.destroy(entities[victim]);
+    }
+    const double hierarchyMs = millisecondsSince(start);
+
+    uint32_t mismatches = 0;
+    for (size_t i = 0; i < entities.size(); i++) {
+        if (!registry.valid(entities[i])) continue;
+        if (registry.get<vex::TransformComponent>(entities[i]).getParent() != scanRegistry.get<vex::TransformComponent>(scanEntities[i]).getParent()) {
+            mismatches++;
+        }
+    }
+
+    std::vector<entt::entity> survivors;
+    for (entt::entity entity : entities) {
+        if (registry.valid(entity)) survivors.push_back(entity);
+    }
+    uint32_t reparented = 0;
+    start = std::chrono::steady_clock::now();
+    if (!survivors.empty()) {
+        std::uniform_int_distribution<size_t> pick(0, survivors.size() - 1);
+        for (uint32_t i = 0; i < settings.destroy; i++) {
+            reparented += vex::HierarchySystem::setParent(registry, survivors[pick(random)], survivors[pick(random)]);
+        }
+    }
+    const double reparentMs = millisecondsSince(start);
+    const uint32_t brokenLinks = countBrokenLinks(registry);
+
+    nlohmann::json result;
+    result["settings"] = {
+        {"objects", settings.objects},
+        {"destroy", settings.destroy},
+        {"children", settings.children},
+        {"seed", settings.seed}
+    };
+    result["destroy"] = {
+        {"scanMs", scanMs},
+        {"hierarchyMs", hierarchyMs},
+        {"speedup", hierarchyMs > 0.0 ? scanMs / hierarchyMs : 0.0},
+        {"parentMismatches", mismatches}
+    };
+    result["buildMs"] = buildMs;
+    result["reparent"] = {
+        {"attempts", survivors.empty() ? 0 : settings.destroy},
+        {"accepted", reparented},
+        {"ms", reparentMs}
+    };
+    result["brokenLinks"] = brokenLinks;
+
+    if (settings.output.empty()) {
+        std::cout << result.dump(2) << std::endl;
+    } else {
+        std::ofstream output(settings.output, std::ios::trunc);
+        if (!(output << result.dump(2) << std::endl)) {
+            std::cerr << "Failed to write " << settings.output << std::endl;
+            return 1;
+        }
+    }
+    return (mismatches == 0 && brokenLinks == 0) ? 0 : 1;
+}
@@ -0,0 +1,187 @@
+#include "components/backends/vulkan/ClusteredLighting.hpp"
+#include "common/ToolCommon.hpp"
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+    using vex::tools::parseCount;
+
+    struct TestSettings {
+        uint32_t cameras = 64;
+        uint32_t lights = 200;
+        uint32_t points = 20000;
+        uint32_t seed = 1;
+        std::string output;
+    };
+
+    void printUsage() {
+        std::cerr << "Usage: vex_light_cluster_test [--cameras C] [--lights L] [--points P] [--seed S] [--out results.json]\n";
+        std::cerr << "  Builds LightClusterGrid for C random cameras with L lights, looks up the cluster of P positions per camera inside,\n";
+        std::cerr << "  beside, behind, in front of the near plane and past the far plane of the frustum and checks every light whose sphere\n";
+        std::cerr << "  contains the position is listed in its cluster. Exits with 1 if any light is missing.\n";
+    }
+
+    enum PointRegion : uint32_t { INSIDE, BESIDE, BEHIND, BEFORE_NEAR, PAST_FAR, REGION_COUNT };
+    constexpr std::array<const char*, REGION_COUNT> REGION_NAMES = { "inside", "beside", "behind", "beforeNear", "pastFar" };
+
+    struct RegionResult {
+        uint64_t points = 0;
+        uint64_t expectedLights = 0;
+        uint64_t listedLights = 0;
+        uint64_t missingLights = 0;
+    };
+}
+
+int main(int argc, char* argv[]) {
+    TestSettings settings;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            printUsage();
+            return 1;
+        }
+
+        bool valid = true;
+        if (arg == "--cameras") {
+            valid = parseCount(argv[++i], settings.cameras) && settings.cameras > 0;
+        } else if (arg == "--lights") {
+            valid = parseCount(argv[++i], settings.lights) && settings.lights > 0 && settings.lights <= MAX_DYNAMIC_LIGHTS;
+        } else if (arg == "--points") {
+            valid = parseCount(argv[++i], settings.points) && settings.points > 0;
+        } else if (arg == "--seed") {
+            valid = parseCount(argv[++i], settings.seed);
+        } else if (arg == "--out") {
+            settings.output = argv[++i];
+        } else {
+            valid = false;
+        }
+
+        if (!valid) {
+            printUsage();
+            return 1;
+        }
+    }
+
+    std::mt19937 random(settings.seed);
+    auto uniform = [&](float min, float max) { return std::uniform_real_distribution<float>(min, max)(random); };
+
+    std::array<RegionResult, REGION_COUNT> regions{};
+    vex::LightClusterGrid grid;
+    std::vector<vex::Light> lights(settings.lights);
+    std::vector<glm::vec3> viewLights(settings.lights);
+
+    for (uint32_t camera = 0; camera < settings.cameras; camera++) {
+        const float nearPlane = uniform(0.05f, 1.0f);
+        const float farPlane = uniform(20.0f, 300.0f);
+        glm::mat4 proj = glm::perspective(glm::radians(uniform(30.0f, 110.0f)), uniform(0.5f, 2.4f), nearPlane, farPlane);
+        proj[1][1] *= -1;
+
+        const glm::vec3 eye(uniform(-50.0f, 50.0f), uniform(-10.0f, 10.0f), uniform(-50.0f, 50.0f));
+        const glm::vec3 target = eye + glm::vec3(uniform(-1.0f, 1.0f), uniform(-0.5f, 0.5f), uniform(-1.0f, 1.0f));
+        const glm::mat4 view = glm::lookAt(eye, target, glm::vec3(0.0f, 1.0f, 0.0f));
+
+        // Lights all around the camera, including behind it and past the far plane.
+        for (uint32_t i = 0; i < settings.lights; i++) {
+            const float reach = farPlane * 1.2f;
+            const glm::vec3 viewPosition(uniform(-reach, reach), uniform(-reach, reach), uniform(-reach, farPlane * 0.1f));
+            lights[i].position = glm::vec4(glm::vec3(glm::inverse(view) * glm::vec4(viewPosition, 1.0f)), uniform(0.2f, farPlane * 0.1f));
+            lights[i].color = glm::vec4(1.0f);
+            viewLights[i] = glm::vec3(view * glm::vec4(glm::vec3(lights[i].position), 1.0f));
+        }
+        grid.build(view, proj, nearPlane, farPlane, lights);
+
+        // Points are placed in view space by NDC and depth, through the same projection the grid uses.
+        const float tanX = 1.0f / proj[0][0];
+        const float tanY = 1.0f / std::abs(proj[1][1]);
+        for (uint32_t p = 0; p < settings.points; p++) {
+            const PointRegion region = static_cast<PointRegion>(p % REGION_COUNT);
+            float ndcX = uniform(-1.0f, 1.0f);
+            float ndcY = uniform(-1.0f, 1.0f);
+            float depth = uniform(nearPlane, farPlane);
+            switch (region) {
+                case INSIDE: break;
+                case BESIDE:
+                    ndcX *= uniform(1.0f, 4.0f);
+                    ndcY *= uniform(1.0f, 4.0f);
+                    break;
+                case BEHIND: depth = -uniform(0.0f, farPlane * 0.2f); break;
+                case BEFORE_NEAR: depth = uniform(0.0f, nearPlane); break;
+                case PAST_FAR: depth = uniform(farPlane, farPlane * 1.5f); break;
+                case REGION_COUNT: break;
+            }
+            // Behind the camera the depth doesn't give a lateral scale, spread positions over the light range instead.
+            const float lateral = depth > 0.0f ? depth : farPlane * 0.2f;
+            const glm::vec3 position(ndcX * tanX * lateral, ndcY * tanY * lateral, -depth);
+
+            const vex::LightCluster& cluster = grid.getClusters()[grid.getClusterIndex(position)];
+            const uint32_t* first = grid.getLightIndices().data() + cluster.offset;
+            const uint32_t* last = first + cluster.count;
+
+            RegionResult& result = regions[region];
+            result.points++;
+            result.listedLights += cluster.count;
+            for (uint32_t i = 0; i < settings.lights; i++) {
+                const glm::vec3 offset = viewLights[i] - position;
+                const float radius = lights[i].position.w;
+                // Slightly inside the sphere, positions on its surface can go either way with rounding.
+                if (glm::dot(offset, offset) > radius * radius * 0.999f) continue;
+
+                result.expectedLights++;
+                if (std::find(first, last, i) == last) result.missingLights++;
+            }
+        }
+    }
+
+    uint64_t points = 0;
+    uint64_t expected = 0;
+    uint64_t listed = 0;
+    uint64_t missing = 0;
+    nlohmann::json result;
+    result["settings"] = {
+        {"cameras", settings.cameras},
+        {"lights", settings.lights},
+        {"points", settings.points},
+        {"seed", settings.seed}
+    };
+    for (uint32_t region = 0; region < REGION_COUNT; region++) {
+        const RegionResult& regionResult = regions[region];
+        result["regions"][REGION_NAMES[region]] = {
+            {"points", regionResult.points},
+            {"expectedLights", regionResult.expectedLights},
+            {"listedLights", regionResult.listedLights},
+            {"missingLights", regionResult.missingLights}
+        };
+        points += regionResult.points;
+        expected += regionResult.expectedLights;
+        listed += regionResult.listedLights;
+        missing += regionResult.missingLights;
+    }
+    result["lightsPerPoint"] = points > 0 ? static_cast<double>(expected) / points : 0.0;
+    result["listedLightsPerPoint"] = points > 0 ? static_cast<double>(listed) / points : 0.0;
+    result["missingLights"] = missing;
+    result["passed"] = missing == 0;
+
+    if (settings.output.empty()) {
+        std::cout << result.dump(2) << std::endl;
+    } else {
+        std::ofstream output(settings.output, std::ios::trunc);
+        if (!(output << result.dump(2) << std::endl)) {
+            std::cerr << "Failed to write " << settings.output << std::endl;
+            return 1;
+        }
+    }
+    return missing == 0 ? 0 : 1;
+}
@@ -0,0 +1,252 @@
+#include "components/Mesh.hpp"
+#include "components/MeshCooker.hpp"
+#include "components/MeshSimplifier.hpp"
+#include "components/VirtualFileSystem.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+    constexpr int BENCH_RUNS = 3;
+
+    void printUsage() {
+        std::cerr << "Usage: MeshCooker <input mesh> [output.vmesh]\n";
+        std::cerr << "       MeshCooker --dir <assets folder> [--bench]\n";
+        std::cerr << "  --dir cooks every mesh into a .vmesh next to it, the engine loads it instead of importing the source.\n";
+        std::cerr << "  --bench compares Assimp import with loading the cooked file, for one mesh or a whole folder.\n";
+        std::cerr << "Example: MeshCooker --dir Assets\n";
+    }
+
+    bool readFile(const fs::path& path, std::vector<uint8_t>& data) {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file) return false;
+        data.resize(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        return static_cast<bool>(file.read(reinterpret_cast<char*>(data.data()), data.size()));
+    }
+
+    bool isSourceMesh(const fs::path& path) {
+        std::string extension = path.extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return std::tolower(c); });
+        return vex::AssetExtensions::IsValid(extension, vex::AssetExtensions::Mesh);
+    }
+
+    /// Same work `MeshManager::loadMesh` does when there is no cooked file.
+    bool importMesh(const std::string& sourcePath, vex::VirtualFileSystem& vfs, vex::MeshData& meshData) {
+        try {
+            meshData.loadFromFile(sourcePath, &vfs);
+        } catch (const std::exception& e) {
+            std::cerr << "Failed to import " << sourcePath << ": " << e.what() << std::endl;
+            return false;
+        }
+        if (meshData.submeshes.empty()) {
+            std::cerr << "Failed to import " << sourcePath << std::endl;
+            return false;
+        }
+        vex::generateLods(meshData, vex::MeshLodSettings{});
+        return true;
+    }
+
+    bool cookMesh(const std::string& sourcePath, const std::string& outputPath, vex::VirtualFileSystem& vfs) {
+        std::vector<uint8_t> source;
+        if (!readFile(sourcePath, source)) {
+            std::cerr << "Failed to read " << sourcePath << std::endl;
+            return false;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        vex::MeshData meshData;
+        if (!importMesh(sourcePath, vfs, meshData)) return false;
+
+        const uint64_t sourceHash = vex::hashMeshSource(source.data(), source.size(), vex::MeshLodSettings{});
+        const std::vector<uint8_t> cooked = vex::writeCookedMesh(meshData, sourcePath, sourceHash);
+
+        std::ofstream output(outputPath, std::ios::binary | std::ios::trunc);
+        if (!output.write(reinterpret_cast<const char*>(cooked.data()), cooked.size())) {
+            std::cerr << "Failed to write " << outputPath << std::endl;
+            return false;
+        }
+
+        size_t triangles = 0;
+        size_t lods = 0;
+        for (const auto& submesh : meshData.submeshes) {
+            triangles += submesh.indices.size() / 3;
+            lods = std::max(lods, submesh.lods.size());
+        }
+        double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        std::cout << sourcePath << ": " << meshData.submeshes.size() << " submeshes, " << triangles << " triangles, " << lods
+                  << " LODs, " << (cooked.size() / 1024) << " KiB (" << milliseconds << " ms)" << std::endl;
+        return true;
+    }
+
+    /// Returns true if output exists and was cooked from the current source with default settings.
+    bool isUpToDate(const fs::path& sourcePath, const fs::path& outputPath) {
+        std::ifstream output(outputPath, std::ios::binary);
+        vex::MeshContainerHeader header;
+        if (!output || !output.read(reinterpret_cast<char*>(&header), sizeof(header))) return false;
+        if (!vex::isMeshContainer(&header, sizeof(header))) return false;
+
+        std::vector<uint8_t> source;
+        if (!readFile(sourcePath, source)) return false;
+        return vex::hashMeshSource(source.data(), source.size(), vex::MeshLodSettings{}) == header.sourceHash;
+    }
+
+    int cookDirectory(const std::string& directory, vex::VirtualFileSystem& vfs) {
+        int failed = 0;
+        size_t cooked = 0;
+        size_t skipped = 0;
+
+        std::error_code ec;
+        for (const auto& entry : fs::recursive_directory_iterator(directory, ec)) {
+            if (!entry.is_regular_file() || !isSourceMesh(entry.path())) continue;
+
+            const fs::path sourcePath = fs::absolute(entry.path());
+            const fs::path outputPath = vex::cookedMeshPath(sourcePath.string());
+            if (isUpToDate(sourcePath, outputPath)) {
+                skipped++;
+                continue;
+            }
+
+            if (cookMesh(sourcePath.string(), outputPath.string(), vfs)) {
+                cooked++;
+            } else {
+                failed++;
+            }
+        }
+
+        if (ec) {
+            std::cerr << "Failed to walk " << directory << ": " << ec.message() << std::endl;
+            return 1;
+        }
+
+        std::cout << "Cooked " << cooked << " meshes (" << skipped << " up to date, " << failed << " failed)" << std::endl;
+        return failed;
+    }
+
+    template <typename Function>
+    double fastestRun(Function&& function) {
+        double fastest = 0.0;
+        for (int run = 0; run < BENCH_RUNS; run++) {
+            auto start = std::chrono::steady_clock::now();
+            if (!function()) return -1.0;
+            double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            fastest = run == 0 ? milliseconds : std::min(fastest, milliseconds);
+        }
+        return fastest;
+    }
+
+    /// Times both paths of `MeshManager::loadMesh`, fastest of `BENCH_RUNS` each. Cooked load includes source hash check done outside distribution builds.
+    bool benchMesh(const std::string& sourcePath, vex::VirtualFileSystem& vfs, double& assimpTotal, double& cookedTotal) {
+        const std::string cookedPath = vex::cookedMeshPath(sourcePath);
+        if (!isUpToDate(sourcePath, cookedPath) && !cookMesh(sourcePath, cookedPath, vfs)) return false;
+
+        double assimp = fastestRun([&] {
+            vex::MeshData meshData;
+            if (!importMesh(sourcePath, vfs, meshData)) return false;
+            vex::MeshBounds bounds = vex::computeMeshBounds(meshData);
+            return bounds.radius >= 0.0f;
+        });
+
+        double hashOnly = 0.0;
+        double cooked = fastestRun([&] {
+            auto cookedFile = vfs.load_file(cookedPath);
+            if (!cookedFile) return false;
+
+            vex::MeshData meshData;
+            vex::MeshBounds bounds;
+            uint64_t cookedHash = 0;
+            if (!vex::readCookedMesh(cookedFile->data.data(), cookedFile->size, sourcePath, meshData, bounds, cookedHash)) return false;
+
+            auto hashStart = std::chrono::steady_clock::now();
+            auto sourceFile = vfs.load_file(sourcePath);
+            if (!sourceFile) return false;
+            bool matches = vex::hashMeshSource(sourceFile->data.data(), sourceFile->size, vex::MeshLodSettings{}) == cookedHash;
+            hashOnly = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - hashStart).count();
+            return matches;
+        });
+
+        if (assimp < 0.0 || cooked < 0.0) {
+            std::cerr << "Benchmark of " << sourcePath << " failed" << std::endl;
+            return false;
+        }
+
+        std::cout << "[bench] " << sourcePath << ": Assimp " << assimp << " ms, cooked " << cooked << " ms (" << hashOnly
+                  << " ms source hash), " << (assimp / std::max(cooked, 0.001)) << "x" << std::endl;
+        assimpTotal += assimp;
+        cookedTotal += cooked;
+        return true;
+    }
+
+    int benchDirectory(const std::string& directory, vex::VirtualFileSystem& vfs) {
+        int failed = 0;
+        double assimpTotal = 0.0;
+        double cookedTotal = 0.0;
+
+        std::error_code ec;
+        for (const auto& entry : fs::recursive_directory_iterator(directory, ec)) {
+            if (!entry.is_regular_file() || !isSourceMesh(entry.path())) continue;
+            if (!benchMesh(fs::absolute(entry.path()).string(), vfs, assimpTotal, cookedTotal)) failed++;
+        }
+
+        if (ec) {
+            std::cerr << "Failed to walk " << directory << ": " << ec.message() << std::endl;
+            return 1;
+        }
+
+        std::cout << "[bench] Total: Assimp " << assimpTotal << " ms, cooked " << cookedTotal << " ms" << std::endl;
+        return failed;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::string directory;
+    bool bench = false;
+    std::vector<std::string> positional;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--dir" && i + 1 < argc) {
+            directory = argv[++i];
+        } else if (arg == "--bench") {
+            bench = true;
+        } else if (!arg.empty() && arg[0] == '-') {
+            printUsage();
+            return 1;
+        } else {
+            positional.push_back(arg);
+        }
+    }
+
+    // Sources are opened by absolute path, so the file system only has to be in loose mode.
+    vex::VirtualFileSystem vfs;
+    vfs.initialize(fs::current_path().string());
+
+    if (!directory.empty()) {
+        if (bench) return benchDirectory(directory, vfs) == 0 ? 0 : 1;
+        return cookDirectory(directory, vfs) == 0 ? 0 : 1;
+    }
+
+    if (positional.empty() || positional.size() > 2 || (bench && positional.size() != 1)) {
+        printUsage();
+        return 1;
+    }
+
+    const std::string sourcePath = fs::absolute(positional[0]).string();
+    if (bench) {
+        double assimpTotal = 0.0;
+        double cookedTotal = 0.0;
+        return benchMesh(sourcePath, vfs, assimpTotal, cookedTotal) ? 0 : 1;
+    }
+
+    std::string output = positional.size() == 2 ? positional[1] : vex::cookedMeshPath(sourcePath);
+    return cookMesh(sourcePath, output, vfs) ? 0 : 1;
+}
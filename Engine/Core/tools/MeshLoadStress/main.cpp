@@ -0,0 +1,334 @@
+#include "Engine.hpp"
+#include "components/GameComponents/BasicComponents.hpp"
+#include "components/backends/vulkan/Interface.hpp"
+#include "components/pathUtils.hpp"
+#include "common/ToolCommon.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+    using vex::tools::parseCount;
+    using vex::tools::CaseResult;
+    using vex::tools::reportCase;
+
+    struct StressSettings {
+        uint32_t entities = 4000;
+        uint32_t frames = 600;
+        uint32_t meshes = 24;
+        uint32_t churn = 100;
+        uint32_t seed = 1;
+        std::string output;
+    };
+
+    void printUsage() {
+        std::cerr << "Usage: vex_mesh_load_stress [--entities N] [--frames F] [--meshes M] [--churn C] [--seed S] [--out results.json]\n";
+        std::cerr << "  Runs the engine headless (SDL offscreen or dummy video driver) for F frames, destroying C random entities and spawning\n";
+        std::cerr << "  new ones every frame around N live entities, all using M generated meshes that load asynchronously. Some meshes are\n";
+        std::cerr << "  rarely used and every entity of a mesh is destroyed now and then, so loads get cancelled while importing and\n";
+        std::cerr << "  requested again before the old import finishes. Checks every mesh is loading or uploaded with one instance per\n";
+        std::cerr << "  entity using it, and that everything is released at the end. Exits with 1 on any failure.\n";
+        std::cerr << "Example: SDL_VIDEO_DRIVER=dummy vex_mesh_load_stress --entities 10000 --churn 300 --out stress.json\n";
+    }
+
+    /// Generated mesh, import time grows with its grid size so some imports are still running when their load gets cancelled.
+    struct StressMesh {
+        std::string path;
+        float halfExtent = 0.0f; ///< Bounding radius of the mesh is at least this.
+        bool rare = false;       ///< Picked rarely, its last entity is often destroyed while it loads.
+        bool missing = false;    ///< Never written, its import fails.
+    };
+
+    /// Writes a wavy grid as Wavefront OBJ, the same Assimp import and LOD generation path real assets take.
+    void writeGridObj(const fs::path& file, uint32_t size, float halfExtent) {
+        std::ofstream output(file, std::ios::trunc);
+        for (uint32_t y = 0; y <= size; y++) {
+            for (uint32_t x = 0; x <= size; x++) {
+                const float u = static_cast<float>(x) / size * 2.0f - 1.0f;
+                const float v = static_cast<float>(y) / size * 2.0f - 1.0f;
+                const float height = std::sin(u * 5.0f) * std::cos(v * 3.0f) * halfExtent * 0.1f;
+                output << "v " << u * halfExtent << ' ' << height << ' ' << v * halfExtent << '\n';
+            }
+        }
+        output << "vn 0 1 0\n";
+        for (uint32_t y = 0; y < size; y++) {
+            for (uint32_t x = 0; x < size; x++) {
+                // OBJ indices start at 1.
+                const uint32_t a = y * (size + 1) + x + 1, b = a + 1, c = a + size + 2, d = a + size + 1;
+                output << "f " << a << "//1 " << d << "//1 " << c << "//1\n";
+                output << "f " << a << "//1 " << c << "//1 " << b << "//1\n";
+            }
+        }
+    }
+
+    std::vector<StressMesh> writeMeshes(const fs::path& directory, const StressSettings& settings) {
+        std::vector<StressMesh> meshes;
+        for (uint32_t i = 0; i < settings.meshes; i++) {
+            StressMesh mesh;
+            mesh.path = "stress_" + std::to_string(i) + ".obj";
+            mesh.halfExtent = 2.0f + static_cast<float>(i % 8);
+            mesh.rare = i % 3 == 0;
+            writeGridObj(directory / mesh.path, 16 + (i * 37) % 113, mesh.halfExtent);
+            meshes.push_back(mesh);
+        }
+
+        StressMesh missing;
+        missing.path = "stress_missing.obj";
+        missing.rare = true;
+        missing.missing = true;
+        meshes.push_back(missing);
+        return meshes;
+    }
+
+    struct LiveEntity {
+        entt::entity entity;
+        uint32_t mesh;
+    };
+}
+
+int main(int argc, char* argv[]) {
+    StressSettings settings;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            printUsage();
+            return 1;
+        }
+
+        bool valid = true;
+        if (arg == "--entities") {
+            valid = parseCount(argv[++i], settings.entities) && settings.entities > 0;
+        } else if (arg == "--frames") {
+            valid = parseCount(argv[++i], settings.frames) && settings.frames > 0;
+        } else if (arg == "--meshes") {
+            valid = parseCount(argv[++i], settings.meshes) && settings.meshes >= 3;
+        } else if (arg == "--churn") {
+            valid = parseCount(argv[++i], settings.churn) && settings.churn > 0;
+        } else if (arg == "--seed") {
+            valid = parseCount(argv[++i], settings.seed);
+        } else if (arg == "--out") {
+            settings.output = argv[++i];
+        } else {
+            valid = false;
+        }
+
+        if (!valid) {
+            printUsage();
+            return 1;
+        }
+    }
+
+    // Engine switches to the executable directory, paths given on the command line are relative to where the tool was started.
+    if (!settings.output.empty()) settings.output = fs::absolute(settings.output).string();
+
+    const fs::path assetDirectory = fs::temp_directory_path() / "vex_mesh_load_stress";
+    std::error_code error;
+    fs::remove_all(assetDirectory, error);
+    fs::create_directories(assetDirectory);
+    const std::vector<StressMesh> meshes = writeMeshes(assetDirectory, settings);
+
+    vex::GameInfo gameInfo;
+    gameInfo.projectName = "vex_mesh_load_stress";
+    gameInfo.versionMajor = 1;
+
+    vex::Engine engine("vex_mesh_load_stress", 640, 360, gameInfo, true);
+    engine.setFrameLimit(0);
+    vex::SetAssetRoot(assetDirectory.string());
+
+    vex::MeshManager& meshManager = engine.getInterface()->getMeshManager();
+    meshManager.setAsyncLoading(true);
+    entt::registry& registry = engine.getRegistry();
+
+    entt::entity camera = registry.create();
+    auto& cameraTransform = registry.emplace<vex::TransformComponent>(camera, registry, glm::vec3(0.0f, 40.0f, 60.0f));
+    cameraTransform.setLocalRotation(glm::vec3(-glm::degrees(std::atan2(40.0f, 60.0f)), 0.0f, 0.0f));
+    vex::CameraComponent cameraComponent;
+    cameraComponent.farPlane = 300.0f;
+    registry.emplace<vex::CameraComponent>(camera, cameraComponent);
+
+    std::mt19937 random(settings.seed);
+    auto uniform = [&](float min, float max) { return std::uniform_real_distribution<float>(min, max)(random); };
+
+    std::vector<uint32_t> rareMeshes, commonMeshes;
+    for (uint32_t i = 0; i < meshes.size(); i++) {
+        (meshes[i].rare ? rareMeshes : commonMeshes).push_back(i);
+    }
+
+    std::vector<LiveEntity> live;
+    std::vector<uint32_t> users(meshes.size(), 0);
+    uint64_t spawned = 0, destroyed = 0, purges = 0;
+    size_t peakEntities = 0;
+    CaseResult checks;
+
+    auto spawn = [&](uint32_t mesh) {
+        entt::entity entity = registry.create();
+        registry.emplace<vex::TransformComponent>(entity, registry, glm::vec3(uniform(-40.0f, 40.0f), 0.0f, uniform(-40.0f, 40.0f)));
+        vex::MeshComponent meshComponent;
+        meshComponent.meshData.meshPath = meshes[mesh].path;
+        registry.emplace<vex::MeshComponent>(entity, meshComponent);
+        live.push_back({ entity, mesh });
+        users[mesh]++;
+        spawned++;
+    };
+
+    auto destroyAt = [&](size_t index) {
+        users[live[index].mesh]--;
+        registry.destroy(live[index].entity);
+        live[index] = live.back();
+        live.pop_back();
+        destroyed++;
+    };
+
+    // State left by the previous frame, the renderer uploaded what finished importing in between.
+    auto checkMeshes = [&]() {
+        std::unordered_map<std::string, vex::MeshMemoryInfo> infos;
+        for (auto& info : meshManager.getMeshMemoryInfo()) {
+            infos[info.path] = std::move(info);
+        }
+
+        for (uint32_t i = 0; i < meshes.size(); i++) {
+            const bool loading = meshManager.isMeshLoading(meshes[i].path);
+            auto info = infos.find(meshes[i].path);
+            const bool uploaded = info != infos.end() && info->second.instances > 0;
+
+            if (users[i] == 0) {
+                checks.check(!loading && info == infos.end(), "mesh without entities is neither loading nor uploaded");
+                continue;
+            }
+            checks.check(loading != uploaded, "mesh with entities is either loading or uploaded");
+            if (!uploaded) continue;
+
+            checks.check(info->second.instances == static_cast<int>(users[i]), "uploaded mesh has one instance per entity using it");
+            if (meshes[i].missing) continue;
+            for (const auto& entry : live) {
+                if (entry.mesh != i) continue;
+                const auto& meshComponent = registry.get<vex::MeshComponent>(entry.entity);
+                checks.check(meshComponent.localRadius >= meshes[i].halfExtent, "entities of an uploaded mesh carry its bounds");
+            }
+        }
+    };
+
+    std::vector<double> frameTimes;
+    frameTimes.reserve(settings.frames);
+    uint32_t frame = 0;
+    uint32_t drainFrames = 0;
+    auto lastFrameStart = std::chrono::steady_clock::now();
+
+    engine.run([&] {
+        auto now = std::chrono::steady_clock::now();
+        if (frame > 0) frameTimes.push_back(std::chrono::duration<double, std::milli>(now - lastFrameStart).count());
+        lastFrameStart = now;
+
+        checkMeshes();
+
+        if (frame < settings.frames) {
+            const size_t destroyCount = std::min<size_t>(live.size(), live.size() * 2 >= settings.entities ? settings.churn : 0);
+            for (size_t i = 0; i < destroyCount; i++) {
+                destroyAt(random() % live.size());
+            }
+
+            // Every entity of one mesh goes at once and one comes right back, the new request races the import of the cancelled one.
+            if (frame % 30 == 29) {
+                const uint32_t mesh = random() % meshes.size();
+                for (size_t i = live.size(); i-- > 0;) {
+                    if (live[i].mesh == mesh) destroyAt(i);
+                }
+                spawn(mesh);
+                purges++;
+            }
+
+            const size_t room = settings.entities > live.size() ? settings.entities - live.size() : 0;
+            const size_t spawnCount = std::min<size_t>(room, settings.churn * 2);
+            for (size_t i = 0; i < spawnCount; i++) {
+                const bool rare = random() % 50 == 0;
+                const std::vector<uint32_t>& pool = rare ? rareMeshes : commonMeshes;
+                spawn(pool[random() % pool.size()]);
+            }
+            peakEntities = std::max(peakEntities, live.size());
+        } else if (frame == settings.frames) {
+            while (!live.empty()) {
+                destroyAt(live.size() - 1);
+            }
+        } else if (++drainFrames > 3) {
+            engine.quit();
+            return;
+        }
+        frame++;
+    });
+
+    const vex::AsyncMeshLoader::Stats stats = meshManager.getMeshLoadStats();
+    checks.check(meshManager.getLoadingMeshCount() == 0, "no mesh is loading after every entity is gone");
+    checks.check(stats.requested == stats.replaced + stats.cancelled + stats.collected, "every request was cancelled, replaced or collected");
+    checks.check(stats.cancelled > 0, "run cancelled loads");
+    checks.check(stats.discarded > 0, "run had imports finishing after their load was cancelled");
+    for (const auto& info : meshManager.getMeshMemoryInfo()) {
+        checks.check(info.path.rfind("stress_", 0) != 0, "every mesh is released once no entity uses it");
+    }
+
+    std::vector<double> sortedTimes = frameTimes;
+    std::sort(sortedTimes.begin(), sortedTimes.end());
+    auto percentile = [&](double p) {
+        if (sortedTimes.empty()) return 0.0;
+        size_t index = static_cast<size_t>(std::ceil(p * sortedTimes.size())) - 1;
+        return sortedTimes[std::min(index, sortedTimes.size() - 1)];
+    };
+
+    nlohmann::json result;
+    result["videoDriver"] = SDL_GetCurrentVideoDriver() ? SDL_GetCurrentVideoDriver() : "unknown";
+    result["settings"] = {
+        {"entities", settings.entities},
+        {"frames", settings.frames},
+        {"meshes", settings.meshes},
+        {"churn", settings.churn},
+        {"seed", settings.seed}
+    };
+    result["entities"] = {
+        {"spawned", spawned},
+        {"destroyed", destroyed},
+        {"peak", peakEntities},
+        {"purges", purges}
+    };
+    result["loader"] = {
+        {"requested", stats.requested},
+        {"replaced", stats.replaced},
+        {"cancelled", stats.cancelled},
+        {"imported", stats.imported},
+        {"discarded", stats.discarded},
+        {"collected", stats.collected}
+    };
+    result["frameTimeMs"] = {
+        {"p50", percentile(0.50)},
+        {"p99", percentile(0.99)},
+        {"max", sortedTimes.empty() ? 0.0 : sortedTimes.back()}
+    };
+    bool passed = true;
+    result.update(reportCase(checks, passed));
+
+    fs::remove_all(assetDirectory, error);
+
+    if (settings.output.empty()) {
+        std::cout << result.dump(2) << std::endl;
+    } else {
+        std::ofstream output(settings.output, std::ios::trunc);
+        if (!(output << result.dump(2) << std::endl)) {
+            std::cerr << "Failed to write " << settings.output << std::endl;
+            return 1;
+        }
+    }
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,312 @@
+#include "components/MeshSimplifier.hpp"
+#include "common/ToolCommon.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+    using vex::tools::parseCount;
+    using vex::tools::CaseResult;
+    using vex::tools::reportCase;
+
+    struct TestSettings {
+        uint32_t subdivisions = 4;
+        uint32_t grid = 64;
+        uint32_t seed = 1;
+        std::string output;
+    };
+
+    void printUsage() {
+        std::cerr << "Usage: vex_mesh_lod_test [--subdivisions N] [--grid G] [--seed S] [--out results.json]\n";
+        std::cerr << "  Generates levels of detail for an icosphere subdivided N times, a noisy GxG terrain, a box with hard edges and a mesh\n";
+        std::cerr << "  made of all of them, over several reduction and error settings. Checks every chain gets coarser with an error that never\n";
+        std::cerr << "  decreases and stays within the setting, and that the per level errors selectLod compares never decrease either.\n";
+        std::cerr << "  Exits with 1 on any failure.\n";
+    }
+
+    vex::Vertex makeVertex(const glm::vec3& position, const glm::vec3& normal, const glm::vec2& uv) {
+        vex::Vertex vertex;
+        vertex.position = position;
+        vertex.normal = normal;
+        vertex.uv = uv;
+        return vertex;
+    }
+
+    /// Smooth closed surface, radius 2, untextured.
+    vex::Submesh makeSphere(uint32_t subdivisions) {
+        const float t = (1.0f + std::sqrt(5.0f)) * 0.5f;
+        std::vector<glm::vec3> points = {
+            { -1, t, 0 }, { 1, t, 0 }, { -1, -t, 0 }, { 1, -t, 0 }, { 0, -1, t }, { 0, 1, t },
+            { 0, -1, -t }, { 0, 1, -t }, { t, 0, -1 }, { t, 0, 1 }, { -t, 0, -1 }, { -t, 0, 1 }
+        };
+        std::vector<uint32_t> faces = {
+            0, 11, 5, 0, 5, 1, 0, 1, 7, 0, 7, 10, 0, 10, 11, 1, 5, 9, 5, 11, 4, 11, 10, 2, 10, 7, 6, 7, 1, 8,
+            3, 9, 4, 3, 4, 2, 3, 2, 6, 3, 6, 8, 3, 8, 9, 4, 9, 5, 2, 4, 11, 6, 2, 10, 8, 6, 7, 9, 8, 1
+        };
+        for (auto& point : points) point = glm::normalize(point);
+
+        for (uint32_t level = 0; level < subdivisions; level++) {
+            std::map<std::pair<uint32_t, uint32_t>, uint32_t> midpoints;
+            auto midpoint = [&](uint32_t a, uint32_t b) {
+                const auto key = std::minmax(a, b);
+                auto it = midpoints.find(key);
+                if (it != midpoints.end()) return it->second;
+                points.push_back(glm::normalize((points[a] + points[b]) * 0.5f));
+                return midpoints[key] = static_cast<uint32_t>(points.size() - 1);
+            };
+
+            std::vector<uint32_t> next;
+            for (size_t i = 0; i < faces.size(); i += 3) {
+                const uint32_t a = faces[i], b = faces[i + 1], c = faces[i + 2];
+                const uint32_t ab = midpoint(a, b), bc = midpoint(b, c), ca = midpoint(c, a);
+                next.insert(next.end(), { a, ab, ca, b, bc, ab, c, ca, bc, ab, bc, ca });
+            }
+            faces = std::move(next);
+        }
+
+        vex::Submesh submesh;
+        for (const auto& point : points) {
+            submesh.vertices.push_back(makeVertex(point * 2.0f, point, glm::vec2(-100000.0f)));
+        }
+        submesh.indices = std::move(faces);
+        return submesh;
+    }
+
+    /// Open surface with borders, rolling hills plus noise so the error grows steadily as it simplifies.
+    vex::Submesh makeTerrain(uint32_t size, std::mt19937& random) {
+        std::uniform_real_distribution<float> noise(-0.05f, 0.05f);
+        vex::Submesh submesh;
+        for (uint32_t y = 0; y <= size; y++) {
+            for (uint32_t x = 0; x <= size; x++) {
+                const float fx = static_cast<float>(x), fy = static_cast<float>(y);
+                const float height = std::sin(fx * 0.15f) * 2.0f + std::cos(fy * 0.11f) * 1.5f + noise(random);
+                submesh.vertices.push_back(makeVertex(glm::vec3(fx, height, fy), glm::vec3(0.0f, 1.0f, 0.0f),
+                                                      glm::vec2(fx / size, fy / size)));
+            }
+        }
+        for (uint32_t y = 0; y < size; y++) {
+            for (uint32_t x = 0; x < size; x++) {
+                const uint32_t a = y * (size + 1) + x, b = a + 1, c = a + size + 2, d = a + size + 1;
+                submesh.indices.insert(submesh.indices.end(), { a, c, b, a, d, c });
+            }
+        }
+        return submesh;
+    }
+
+    /// Six separately textured faces with their own normals, so every edge of the box is a seam.
+    vex::Submesh makeBox(uint32_t size) {
+        vex::Submesh submesh;
+        for (int axis = 0; axis < 3; axis++) {
+            for (float sign : { -1.0f, 1.0f }) {
+                glm::vec3 normal(0.0f);
+                normal[axis] = sign;
+                const int u = (axis + 1) % 3, v = (axis + 2) % 3;
+                const uint32_t base = static_cast<uint32_t>(submesh.vertices.size());
+                for (uint32_t y = 0; y <= size; y++) {
+                    for (uint32_t x = 0; x <= size; x++) {
+                        glm::vec3 position(0.0f);
+                        position[axis] = sign;
+                        position[u] = static_cast<float>(x) / size * 2.0f - 1.0f;
+                        position[v] = static_cast<float>(y) / size * 2.0f - 1.0f;
+                        submesh.vertices.push_back(makeVertex(position, normal, glm::vec2(static_cast<float>(x) / size, static_cast<float>(y) / size)));
+                    }
+                }
+                for (uint32_t y = 0; y < size; y++) {
+                    for (uint32_t x = 0; x < size; x++) {
+                        const uint32_t a = base + y * (size + 1) + x, b = a + 1, c = a + size + 2, d = a + size + 1;
+                        if (sign > 0.0f) {
+                            submesh.indices.insert(submesh.indices.end(), { a, b, c, a, c, d });
+                        } else {
+                            submesh.indices.insert(submesh.indices.end(), { a, c, b, a, d, c });
+                        }
+                    }
+                }
+            }
+        }
+        return submesh;
+    }
+
+    float boundingRadius(const vex::Submesh& submesh) {
+        glm::vec3 min(FLT_MAX), max(-FLT_MAX);
+        for (const auto& vertex : submesh.vertices) {
+            min = glm::min(min, vertex.position);
+            max = glm::max(max, vertex.position);
+        }
+        return glm::length(max - min) * 0.5f;
+    }
+
+    /// Checks chains of one generated mesh and returns them for the report.
+    nlohmann::json checkMesh(const std::string& name, const vex::MeshData& mesh, const vex::MeshLodSettings& settings, CaseResult& result) {
+        nlohmann::json report;
+        report["mesh"] = name;
+        report["reductionPerLevel"] = settings.reductionPerLevel;
+        report["maxError"] = settings.maxError;
+
+        for (const auto& submesh : mesh.submeshes) {
+            const float allowed = settings.maxError * boundingRadius(submesh) * 1.0001f;
+            size_t previousCount = submesh.indices.size();
+            float previousError = 0.0f;
+            nlohmann::json chain = { { {"triangles", submesh.indices.size() / 3}, {"error", 0.0f} } };
+
+            result.check(submesh.lods.size() <= vex::MAX_MESH_LODS - 1, name + ": chain fits MAX_MESH_LODS");
+            for (const auto& lod : submesh.lods) {
+                result.check(lod.indices.size() < previousCount, name + ": every level has fewer triangles than the one before");
+                result.check(lod.error >= previousError, name + ": error never decreases down a submesh's chain");
+                result.check(lod.error <= allowed, name + ": error stays within maxError of the bounding radius");
+                previousCount = lod.indices.size();
+                previousError = lod.error;
+                chain.push_back({ {"triangles", lod.indices.size() / 3}, {"error", lod.error} });
+            }
+            report["submeshes"].push_back(chain);
+        }
+
+        // What VulkanMesh hands to selectLod.
+        const std::vector<float> errors = vex::computeLodErrors(mesh);
+        result.check(!errors.empty() && errors[0] == 0.0f, name + ": full detail has no error");
+        for (size_t level = 1; level < errors.size(); level++) {
+            result.check(errors[level] >= errors[level - 1], name + ": mesh level error never decreases");
+        }
+        for (const auto& submesh : mesh.submeshes) {
+            for (size_t level = 1; level < errors.size() && !submesh.lods.empty(); level++) {
+                const float drawn = submesh.lods[std::min(level, submesh.lods.size()) - 1].error;
+                result.check(errors[level] >= drawn, name + ": mesh level error covers the level every submesh draws");
+            }
+        }
+        report["levelErrors"] = errors;
+        return report;
+    }
+
+    struct ChainResult {
+        CaseResult checks;
+        nlohmann::json meshes = nlohmann::json::array();
+    };
+
+    ChainResult testGeneratedChains(const TestSettings& settings) {
+        ChainResult result;
+        std::mt19937 random(settings.seed);
+
+        std::vector<std::pair<std::string, vex::MeshData>> meshes;
+        meshes.push_back({ "sphere", {} });
+        meshes.back().second.submeshes.push_back(makeSphere(settings.subdivisions));
+        meshes.push_back({ "terrain", {} });
+        meshes.back().second.submeshes.push_back(makeTerrain(settings.grid, random));
+        meshes.push_back({ "box", {} });
+        meshes.back().second.submeshes.push_back(makeBox(16));
+
+        // Submeshes stop at different levels here, one is too small to simplify at all.
+        meshes.push_back({ "combined", {} });
+        auto& combined = meshes.back().second.submeshes;
+        combined.push_back(makeSphere(settings.subdivisions));
+        combined.push_back(makeTerrain(settings.grid, random));
+        combined.push_back(makeBox(16));
+        combined.push_back(makeBox(2));
+
+        for (float reduction : { 0.25f, 0.5f, 0.7f }) {
+            for (float maxError : { 0.005f, 0.02f, 0.1f }) {
+                vex::MeshLodSettings lodSettings;
+                lodSettings.reductionPerLevel = reduction;
+                lodSettings.maxError = maxError;
+                for (auto& [name, mesh] : meshes) {
+                    vex::generateLods(mesh, lodSettings);
+                    result.meshes.push_back(checkMesh(name, mesh, lodSettings, result.checks));
+                }
+            }
+        }
+        return result;
+    }
+
+    vex::Submesh chainWithErrors(std::initializer_list<float> errors) {
+        vex::Submesh submesh;
+        size_t count = 3 * (errors.size() + 1);
+        submesh.indices.assign(count, 0);
+        for (float error : errors) {
+            count -= 3;
+            submesh.lods.push_back({ std::vector<uint32_t>(count, 0), error });
+        }
+        return submesh;
+    }
+
+    /// Chains of different lengths, a shorter one keeps its coarsest error for every level past its end.
+    CaseResult testShorterChains() {
+        CaseResult result;
+        vex::MeshData mesh;
+        mesh.submeshes.push_back(chainWithErrors({ 0.1f, 0.2f, 0.3f }));
+        mesh.submeshes.push_back(chainWithErrors({ 0.5f, 0.9f }));
+        mesh.submeshes.push_back(chainWithErrors({}));
+        result.check(vex::computeLodErrors(mesh) == std::vector<float>{ 0.0f, 0.5f, 0.9f, 0.9f }, "level past a short chain keeps that chain's coarsest error");
+
+        mesh.submeshes.push_back(chainWithErrors({ 0.01f, 0.02f, 0.03f, 5.0f, 6.0f }));
+        result.check(vex::computeLodErrors(mesh) == std::vector<float>{ 0.0f, 0.5f, 0.9f, 0.9f }, "levels past MAX_MESH_LODS are ignored");
+
+        vex::MeshData empty;
+        result.check(vex::computeLodErrors(empty) == std::vector<float>{ 0.0f }, "mesh without levels has only full detail");
+        return result;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    TestSettings settings;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            printUsage();
+            return 1;
+        }
+
+        bool valid = true;
+        if (arg == "--subdivisions") {
+            valid = parseCount(argv[++i], settings.subdivisions) && settings.subdivisions <= 6;
+        } else if (arg == "--grid") {
+            valid = parseCount(argv[++i], settings.grid) && settings.grid >= 2 && settings.grid <= 1024;
+        } else if (arg == "--seed") {
+            valid = parseCount(argv[++i], settings.seed);
+        } else if (arg == "--out") {
+            settings.output = argv[++i];
+        } else {
+            valid = false;
+        }
+
+        if (!valid) {
+            printUsage();
+            return 1;
+        }
+    }
+
+    bool passed = true;
+    nlohmann::json result;
+    result["settings"] = {
+        {"subdivisions", settings.subdivisions},
+        {"grid", settings.grid},
+        {"seed", settings.seed}
+    };
+
+    const ChainResult chains = testGeneratedChains(settings);
+    result["generatedChains"] = reportCase(chains.checks, passed);
+    result["generatedChains"]["meshes"] = chains.meshes;
+    result["shorterChains"] = reportCase(testShorterChains(), passed);
+    result["passed"] = passed;
+
+    if (settings.output.empty()) {
+        std::cout << result.dump(2) << std::endl;
+    } else {
+        std::ofstream output(settings.output, std::ios::trunc);
+        if (!(output << result.dump(2) << std::endl)) {
+            std::cerr << "Failed to write " << settings.output << std::endl;
+            return 1;
+        }
+    }
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,359 @@
+#include "components/backends/vulkan/RangeAllocator.hpp"
+#include "common/ToolCommon.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+    using vex::tools::parseCount;
+    using vex::tools::CaseResult;
+    using vex::tools::reportCase;
+
+    struct TestSettings {
+        uint32_t capacity = 1u << 20;
+        uint32_t operations = 20000;
+        uint32_t staging = 4096;
+        uint32_t seed = 1;
+        std::string output;
+    };
+
+    void printUsage() {
+        std::cerr << "Usage: vex_range_allocator_test [--capacity BYTES] [--operations N] [--staging BYTES] [--seed S] [--out results.json]\n";
+        std::cerr << "  Checks RangeAllocator picks the smallest fitting block, keeps alignment and merges neighbours on free, then runs N random\n";
+        std::cerr << "  allocations and frees over a byte store of CAPACITY, compacting it now and then by copying moved ranges through a staging\n";
+        std::cerr << "  buffer of STAGING bytes the way MeshArena does and verifying every allocation kept its bytes. Exits with 1 on any failure.\n";
+    }
+
+    CaseResult testBestFit() {
+        CaseResult result;
+        vex::RangeAllocator allocator(1000);
+        const uint64_t a = allocator.allocate(100);
+        const uint64_t b = allocator.allocate(50);
+        const uint64_t c = allocator.allocate(100);
+        const uint64_t d = allocator.allocate(200);
+        const uint64_t e = allocator.allocate(100);
+        result.check(a == 0 && b == 100 && c == 150 && d == 250 && e == 450, "first allocations are packed from offset 0");
+
+        // Holes of 50 and 200 bytes plus the 450 byte tail.
+        allocator.free(b);
+        allocator.free(d);
+        result.check(allocator.getFreeBlockCount() == 3, "two holes and the tail are free");
+        result.check(allocator.allocate(40) == b, "40 bytes go to the 50 byte hole");
+        result.check(allocator.allocate(150) == d, "150 bytes go to the 200 byte hole, not the tail");
+        result.check(allocator.allocate(300) == 550, "300 bytes only fit the tail");
+        result.check(allocator.allocate(200) == vex::RangeAllocator::INVALID_OFFSET, "200 bytes don't fit anywhere");
+        result.check(allocator.allocate(0) == vex::RangeAllocator::INVALID_OFFSET, "empty allocations are refused");
+        result.check(allocator.getUsedBytes() == 100 + 40 + 100 + 150 + 100 + 300, "used bytes count every live allocation");
+        return result;
+    }
+
+    CaseResult testAlignment() {
+        CaseResult result;
+        vex::RangeAllocator allocator(256);
+        const uint64_t a = allocator.allocate(1);
+        const uint64_t b = allocator.allocate(24, 12);
+        result.check(a == 0 && b == 12, "12 byte aligned allocation skips to offset 12");
+        result.check(allocator.getFreeBlockCount() == 2, "padding in front of an aligned allocation stays free");
+        result.check(allocator.allocate(11) == 1, "padding is reused by an allocation that fits it");
+
+        const uint64_t c = allocator.allocate(20, 20);
+        result.check(c != vex::RangeAllocator::INVALID_OFFSET && c % 20 == 0, "alignment doesn't have to be a power of two");
+        return result;
+    }
+
+    CaseResult testMerging() {
+        CaseResult result;
+        // Every order of freeing three neighbours has to end with one block again.
+        const std::vector<std::vector<uint32_t>> orders = { {0, 1, 2}, {0, 2, 1}, {1, 0, 2}, {1, 2, 0}, {2, 0, 1}, {2, 1, 0} };
+        for (const auto& order : orders) {
+            vex::RangeAllocator allocator(300);
+            const uint64_t offsets[3] = { allocator.allocate(100), allocator.allocate(100), allocator.allocate(100) };
+            for (uint32_t index : order) {
+                allocator.free(offsets[index]);
+            }
+            const std::string name = "free order " + std::to_string(order[0]) + std::to_string(order[1]) + std::to_string(order[2]);
+            result.check(allocator.getFreeBlockCount() == 1 && allocator.getLargestFreeBlock() == 300, name + " merges into one block");
+            result.check(allocator.getUsedBytes() == 0, name + " leaves no used bytes");
+        }
+
+        vex::RangeAllocator allocator(300);
+        const uint64_t a = allocator.allocate(100);
+        allocator.allocate(100);
+        allocator.free(a);
+        result.check(allocator.getFreeBlockCount() == 2 && allocator.getLargestFreeBlock() == 100, "blocks split by a live allocation don't merge");
+        return result;
+    }
+
+    CaseResult testPinnedCompaction() {
+        CaseResult result;
+        vex::RangeAllocator allocator(1000);
+        const uint64_t a = allocator.allocate(100);
+        const uint64_t b = allocator.allocate(100);
+        const uint64_t c = allocator.allocate(100);
+        const uint64_t d = allocator.allocate(100);
+        allocator.free(a);
+        allocator.free(c);
+        allocator.pin(b);
+
+        const auto moves = allocator.compact();
+        result.check(moves.size() == 1 && moves[0].from == d && moves[0].to == 200, "unpinned allocation slides right behind the pinned one");
+        result.check(allocator.getFreeBlockCount() == 2 && allocator.getLargestFreeBlock() == 700, "hole in front of pinned allocation stays, the rest is one block");
+        allocator.free(b);
+        allocator.free(200);
+        result.check(allocator.getFreeBlockCount() == 1 && allocator.getUsedBytes() == 0, "moved and pinned allocations free at their offsets");
+        return result;
+    }
+
+    /// Byte store standing in for an arena buffer, moves are copied through a staging buffer in batches like MeshArena::compact records them:
+    /// every read of a batch happens before any write of it.
+    struct MockStore {
+        std::vector<uint8_t> bytes;
+        uint64_t batches = 0;
+
+        void applyMoves(const std::vector<vex::RangeAllocator::Move>& moves, uint64_t stagingBytes) {
+            struct Copy {
+                uint64_t from;
+                uint64_t to;
+                uint64_t staging;
+                uint64_t size;
+            };
+            std::vector<uint8_t> staging(stagingBytes);
+            std::vector<Copy> batch;
+            uint64_t stagingUsed = 0;
+
+            auto flush = [&] {
+                for (const Copy& copy : batch) std::memcpy(staging.data() + copy.staging, bytes.data() + copy.from, copy.size);
+                for (const Copy& copy : batch) std::memcpy(bytes.data() + copy.to, staging.data() + copy.staging, copy.size);
+                batches += batch.empty() ? 0 : 1;
+                batch.clear();
+                stagingUsed = 0;
+            };
+
+            for (const auto& move : moves) {
+                for (uint64_t done = 0; done < move.size;) {
+                    const uint64_t chunk = std::min(move.size - done, stagingBytes);
+                    if (stagingUsed + chunk > stagingBytes) flush();
+                    batch.push_back({ move.from + done, move.to + done, stagingUsed, chunk });
+                    stagingUsed += chunk;
+                    done += chunk;
+                }
+            }
+            flush();
+        }
+    };
+
+    struct LiveAllocation {
+        uint64_t size;
+        uint64_t alignment;
+        uint32_t pattern;
+        bool pinned;
+    };
+
+    uint8_t patternByte(uint32_t pattern, uint64_t index) {
+        return static_cast<uint8_t>((pattern * 2654435761u + index * 40503u) >> 7);
+    }
+
+    struct StressResult {
+        CaseResult checks;
+        uint64_t allocations = 0;
+        uint64_t failedAllocations = 0;
+        uint64_t compactions = 0;
+        uint64_t moves = 0;
+        uint64_t movedBytes = 0;
+        uint64_t stagingBatches = 0;
+        double largestFreeShareBefore = 0.0;
+        double largestFreeShareAfter = 0.0;
+    };
+
+    StressResult testRandomCompaction(const TestSettings& settings) {
+        StressResult result;
+        CaseResult& checks = result.checks;
+        std::mt19937 random(settings.seed);
+        // Element sizes of vertex formats and index types sharing the arenas.
+        const uint64_t alignments[] = { 2, 4, 12, 16, 20, 32, 44 };
+
+        vex::RangeAllocator allocator(settings.capacity);
+        MockStore store;
+        store.bytes.assign(settings.capacity, 0);
+        std::unordered_map<uint64_t, LiveAllocation> live;
+        uint32_t nextPattern = 1;
+        uint64_t compactions = 0;
+        double shareBefore = 0.0;
+        double shareAfter = 0.0;
+
+        auto freeShare = [&] {
+            const uint64_t freeBytes = allocator.getCapacity() - allocator.getUsedBytes();
+            return freeBytes > 0 ? static_cast<double>(allocator.getLargestFreeBlock()) / freeBytes : 1.0;
+        };
+
+        for (uint32_t operation = 0; operation < settings.operations; operation++) {
+            const bool allocate = live.empty() || random() % 100 < 55;
+            if (allocate) {
+                const uint64_t alignment = alignments[random() % std::size(alignments)];
+                const uint64_t size = alignment * (1 + random() % std::max<uint64_t>(1, settings.capacity / 256 / alignment));
+                const uint64_t offset = allocator.allocate(size, alignment);
+                if (offset == vex::RangeAllocator::INVALID_OFFSET) {
+                    result.failedAllocations++;
+                    continue;
+                }
+                result.allocations++;
+                checks.check(offset % alignment == 0, "allocation is aligned");
+                checks.check(offset + size <= settings.capacity, "allocation is inside the range");
+                const uint32_t pattern = nextPattern++;
+                for (uint64_t i = 0; i < size; i++) store.bytes[offset + i] = patternByte(pattern, i);
+                live.emplace(offset, LiveAllocation{ size, alignment, pattern, false });
+            } else {
+                auto it = live.begin();
+                std::advance(it, random() % live.size());
+                allocator.free(it->first);
+                live.erase(it);
+            }
+
+            if (operation % 997 != 996) continue;
+
+            // A few allocations stay put like ranges still waiting in the deletion queue.
+            for (auto& [offset, allocation] : live) {
+                if (!allocation.pinned && random() % 50 == 0) {
+                    allocator.pin(offset);
+                    allocation.pinned = true;
+                }
+            }
+
+            shareBefore += freeShare();
+            const auto moves = allocator.compact();
+            compactions++;
+
+            uint64_t previousEnd = 0;
+            for (size_t i = 0; i < moves.size(); i++) {
+                const auto& move = moves[i];
+                checks.check(move.to < move.from, "moves only go toward offset 0");
+                checks.check(move.from >= previousEnd, "moves are ordered and don't overlap");
+                // A write must never land on bytes a later move still has to read, batches are copied in order.
+                checks.check(i + 1 == moves.size() || move.to + move.size <= moves[i + 1].from, "move doesn't overwrite a later source");
+                previousEnd = move.from + move.size;
+                result.movedBytes += move.size;
+            }
+            result.moves += moves.size();
+            store.applyMoves(moves, settings.staging);
+
+            std::unordered_map<uint64_t, LiveAllocation> relocated;
+            std::unordered_map<uint64_t, uint64_t> newOffsets;
+            for (const auto& move : moves) newOffsets.emplace(move.from, move.to);
+            for (const auto& [offset, allocation] : live) {
+                auto moved = newOffsets.find(offset);
+                const uint64_t newOffset = moved != newOffsets.end() ? moved->second : offset;
+                checks.check(!allocation.pinned || newOffset == offset, "pinned allocation didn't move");
+                checks.check(newOffset % allocation.alignment == 0, "moved allocation keeps its alignment");
+                bool intact = true;
+                for (uint64_t i = 0; i < allocation.size && intact; i++) {
+                    intact = store.bytes[newOffset + i] == patternByte(allocation.pattern, i);
+                }
+                checks.check(intact, "allocation kept its bytes through compaction");
+                relocated.emplace(newOffset, allocation);
+            }
+            live = std::move(relocated);
+            shareAfter += freeShare();
+
+            // Pinned ranges are released later, like the deletion queue does.
+            for (auto it = live.begin(); it != live.end();) {
+                if (it->second.pinned) {
+                    allocator.free(it->first);
+                    it = live.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
+
+        checks.check(allocator.getAllocationCount() == live.size(), "allocator tracks every live allocation");
+        for (const auto& [offset, allocation] : live) {
+            allocator.free(offset);
+        }
+        checks.check(allocator.getUsedBytes() == 0 && allocator.getFreeBlockCount() == 1 && allocator.getLargestFreeBlock() == settings.capacity,
+                     "freeing everything after compactions leaves one block");
+
+        result.compactions = compactions;
+        result.stagingBatches = store.batches;
+        result.largestFreeShareBefore = compactions > 0 ? shareBefore / compactions : 0.0;
+        result.largestFreeShareAfter = compactions > 0 ? shareAfter / compactions : 0.0;
+        return result;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    TestSettings settings;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            printUsage();
+            return 1;
+        }
+
+        bool valid = true;
+        if (arg == "--capacity") {
+            valid = parseCount(argv[++i], settings.capacity) && settings.capacity >= 4096;
+        } else if (arg == "--operations") {
+            valid = parseCount(argv[++i], settings.operations);
+        } else if (arg == "--staging") {
+            valid = parseCount(argv[++i], settings.staging) && settings.staging > 0;
+        } else if (arg == "--seed") {
+            valid = parseCount(argv[++i], settings.seed);
+        } else if (arg == "--out") {
+            settings.output = argv[++i];
+        } else {
+            valid = false;
+        }
+
+        if (!valid) {
+            printUsage();
+            return 1;
+        }
+    }
+
+    bool passed = true;
+    nlohmann::json result;
+    result["settings"] = {
+        {"capacity", settings.capacity},
+        {"operations", settings.operations},
+        {"staging", settings.staging},
+        {"seed", settings.seed}
+    };
+    result["bestFit"] = reportCase(testBestFit(), passed);
+    result["alignment"] = reportCase(testAlignment(), passed);
+    result["merging"] = reportCase(testMerging(), passed);
+    result["pinnedCompaction"] = reportCase(testPinnedCompaction(), passed);
+
+    const StressResult stress = testRandomCompaction(settings);
+    result["randomCompaction"] = reportCase(stress.checks, passed);
+    result["randomCompaction"]["allocations"] = stress.allocations;
+    result["randomCompaction"]["failedAllocations"] = stress.failedAllocations;
+    result["randomCompaction"]["compactions"] = stress.compactions;
+    result["randomCompaction"]["moves"] = stress.moves;
+    result["randomCompaction"]["movedBytes"] = stress.movedBytes;
+    result["randomCompaction"]["stagingBatches"] = stress.stagingBatches;
+    result["randomCompaction"]["largestFreeShareBefore"] = stress.largestFreeShareBefore;
+    result["randomCompaction"]["largestFreeShareAfter"] = stress.largestFreeShareAfter;
+    result["passed"] = passed;
+
+    if (settings.output.empty()) {
+        std::cout << result.dump(2) << std::endl;
+    } else {
+        std::ofstream output(settings.output, std::ios::trunc);
+        if (!(output << result.dump(2) << std::endl)) {
+            std::cerr << "Failed to write " << settings.output << std::endl;
+            return 1;
+        }
+    }
+    return passed ? 0 : 1;
+}
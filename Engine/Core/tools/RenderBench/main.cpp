@@ -0,0 +1,375 @@
+#include "Engine.hpp"
+#include "components/GameComponents/BasicComponents.hpp"
+#include "components/ImageWriter.hpp"
+#include "components/backends/vulkan/Interface.hpp"
+#include "common/ToolCommon.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+    using vex::tools::parseCount;
+
+    struct BenchSettings {
+        uint32_t meshes = 1000;
+        uint32_t lights = 32;
+        uint32_t transparent = 100;
+        uint32_t frames = 300;
+        uint32_t warmup = 30;
+        int width = 1280;
+        int height = 720;
+        uint32_t recordThreads = 0; // 0 keeps the renderer default
+        std::string output;
+        std::string png;
+    };
+
+    /// Running sums of renderer counters over measured frames.
+    struct StatsTotals {
+        uint64_t visibleObjects = 0;
+        uint64_t drawsBeforeBatching = 0;
+        uint64_t drawsAfterBatching = 0;
+        uint64_t transparentTriangles = 0;
+        uint64_t triangles = 0;
+        uint64_t idleWaits = 0;
+    };
+
+    constexpr float GRID_SPACING = 2.5f;
+
+    void printUsage() {
+        std::cerr << "Usage: vex_render_bench [--meshes N] [--lights M] [--transparent K] [--frames F] [--warmup W]\n";
+        std::cerr << "                        [--width X] [--height Y] [--threads T] [--out results.json] [--png frame.png]\n";
+        std::cerr << "  Renders a synthetic scene headless (SDL offscreen or dummy video driver, e.g. on lavapipe) for a fixed number of frames\n";
+        std::cerr << "  and writes CPU frame times, draw counts and a hash of the final image as JSON, to stdout unless --out is given.\n";
+        std::cerr << "Example: SDL_VIDEO_DRIVER=dummy vex_render_bench --meshes 5000 --frames 500 --out bench.json\n";
+    }
+
+    /// Deterministic value in [0, 1) for index, so scenes are identical on every platform and standard library.
+    float hashUnit(uint32_t index, uint32_t salt) {
+        uint32_t x = index * 0x9E3779B9u ^ salt * 0x85EBCA6Bu;
+        x ^= x >> 16;
+        x *= 0x7FEB352Du;
+        x ^= x >> 15;
+        x *= 0x846CA68Bu;
+        x ^= x >> 16;
+        return static_cast<float>(x >> 8) / static_cast<float>(1u << 24);
+    }
+
+    /// FNV-1a over the read back pixels, equal images give equal hashes on every device producing the same bytes.
+    uint64_t hashPixels(const std::vector<uint8_t>& pixels) {
+        uint64_t hash = 0xCBF29CE484222325ull;
+        for (uint8_t byte : pixels) {
+            hash ^= byte;
+            hash *= 0x100000001B3ull;
+        }
+        return hash;
+    }
+
+    /// Unit cube with per face normals, untextured so every object uses the default texture.
+    vex::MeshData buildCube() {
+        static const glm::vec3 normals[6] = {
+            {1, 0, 0}, {-1, 0, 0}, {0, 1, 0}, {0, -1, 0}, {0, 0, 1}, {0, 0, -1}
+        };
+
+        vex::Submesh submesh;
+        for (const glm::vec3& normal : normals) {
+            const glm::vec3 tangent = std::abs(normal.y) > 0.5f ? glm::vec3(1, 0, 0) : glm::vec3(0, 1, 0);
+            const glm::vec3 bitangent = glm::cross(normal, tangent);
+            const uint32_t first = static_cast<uint32_t>(submesh.vertices.size());
+
+            const glm::vec2 corners[4] = {{-1, -1}, {1, -1}, {1, 1}, {-1, 1}};
+            for (const glm::vec2& corner : corners) {
+                vex::Vertex vertex;
+                vertex.position = (normal + tangent * corner.x + bitangent * corner.y) * 0.5f;
+                vertex.normal = normal;
+                submesh.vertices.push_back(vertex);
+            }
+
+            for (uint32_t index : {0u, 1u, 2u, 0u, 2u, 3u}) {
+                submesh.indices.push_back(first + index);
+            }
+        }
+
+        vex::MeshData meshData;
+        meshData.meshPath = "RenderBench/cube";
+        meshData.submeshes.push_back(std::move(submesh));
+        return meshData;
+    }
+
+    /// Lays out opaque cubes on a square grid, transparent ones above them and lights above everything.
+    void buildScene(entt::registry& registry, const BenchSettings& settings, float& outExtent) {
+        const vex::MeshData cube = buildCube();
+        const uint32_t side = std::max(1u, static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<float>(std::max(settings.meshes, settings.transparent))))));
+        const float half = (side - 1) * GRID_SPACING * 0.5f;
+        outExtent = half + GRID_SPACING;
+
+        bool cubeCached = false;
+        auto addCube = [&](glm::vec3 position, glm::vec3 rotation, glm::vec4 color, vex::RenderType renderType) {
+            entt::entity entity = registry.create();
+            registry.emplace<vex::TransformComponent>(entity, registry, position, rotation, glm::vec3(1.0f));
+            vex::MeshComponent mesh;
+            // First component moves the cube into the mesh cache, the rest only need its path.
+            if (cubeCached) {
+                mesh.meshData.meshPath = cube.meshPath;
+            } else {
+                mesh.meshData = cube;
+                cubeCached = true;
+            }
+            mesh.renderType = renderType;
+            mesh.color = color;
+            registry.emplace<vex::MeshComponent>(entity, mesh);
+        };
+
+        for (uint32_t i = 0; i < settings.meshes; i++) {
+            glm::vec3 position((i % side) * GRID_SPACING - half, 0.0f, (i / side) * GRID_SPACING - half);
+            glm::vec3 rotation(0.0f, hashUnit(i, 1) * 90.0f, 0.0f);
+            glm::vec4 color(0.4f + 0.6f * hashUnit(i, 2), 0.4f + 0.6f * hashUnit(i, 3), 0.4f + 0.6f * hashUnit(i, 4), 1.0f);
+            addCube(position, rotation, color, vex::RenderType::OPAQUE);
+        }
+
+        for (uint32_t i = 0; i < settings.transparent; i++) {
+            glm::vec3 position((i % side) * GRID_SPACING - half, 1.5f, (i / side) * GRID_SPACING - half);
+            glm::vec3 rotation(hashUnit(i, 5) * 45.0f, hashUnit(i, 6) * 90.0f, 0.0f);
+            glm::vec4 color(hashUnit(i, 7), hashUnit(i, 8), hashUnit(i, 9), 0.35f);
+            addCube(position, rotation, color, vex::RenderType::TRANSPARENT);
+        }
+
+        for (uint32_t i = 0; i < settings.lights; i++) {
+            entt::entity entity = registry.create();
+            glm::vec3 position((hashUnit(i, 10) * 2.0f - 1.0f) * outExtent, 3.0f, (hashUnit(i, 11) * 2.0f - 1.0f) * outExtent);
+            registry.emplace<vex::TransformComponent>(entity, registry, position);
+            vex::LightComponent light;
+            light.color = glm::vec3(hashUnit(i, 12), hashUnit(i, 13), hashUnit(i, 14));
+            light.intensity = 2.0f;
+            light.radius = GRID_SPACING * 4.0f;
+            registry.emplace<vex::LightComponent>(entity, light);
+        }
+    }
+
+    /// Camera orbit depends on frame number only, so the final image doesn't depend on timing.
+    void placeCamera(vex::TransformComponent& transform, uint32_t frame, float extent) {
+        const float radius = extent * 1.2f + 5.0f;
+        const float height = extent * 0.5f + 4.0f;
+        const float angle = frame * 0.005f;
+        transform.setLocalPosition(glm::vec3(std::sin(angle) * radius, height, std::cos(angle) * radius));
+        transform.setLocalRotation(glm::vec3(-glm::degrees(std::atan2(height, radius)), glm::degrees(angle), 0.0f));
+    }
+
+    nlohmann::json summarize(std::vector<double> frameTimes) {
+        nlohmann::json result = nlohmann::json::object();
+        if (frameTimes.empty()) return result;
+
+        double total = 0.0;
+        for (double time : frameTimes) total += time;
+        std::sort(frameTimes.begin(), frameTimes.end());
+        auto percentile = [&](double p) {
+            size_t index = static_cast<size_t>(std::ceil(p * frameTimes.size())) - 1;
+            return frameTimes[std::min(index, frameTimes.size() - 1)];
+        };
+
+        result["min"] = frameTimes.front();
+        result["avg"] = total / frameTimes.size();
+        result["p50"] = percentile(0.50);
+        result["p95"] = percentile(0.95);
+        result["p99"] = percentile(0.99);
+        result["max"] = frameTimes.back();
+        return result;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    BenchSettings settings;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            printUsage();
+            return 1;
+        }
+
+        bool valid = true;
+        if (arg == "--meshes") {
+            valid = parseCount(argv[++i], settings.meshes);
+        } else if (arg == "--lights") {
+            valid = parseCount(argv[++i], settings.lights);
+        } else if (arg == "--transparent") {
+            valid = parseCount(argv[++i], settings.transparent);
+        } else if (arg == "--frames") {
+            valid = parseCount(argv[++i], settings.frames) && settings.frames > 0;
+        } else if (arg == "--warmup") {
+            valid = parseCount(argv[++i], settings.warmup);
+        } else if (arg == "--threads") {
+            valid = parseCount(argv[++i], settings.recordThreads);
+        } else if (arg == "--width" || arg == "--height") {
+            uint32_t size = 0;
+            valid = parseCount(argv[++i], size) && size > 0 && size <= 16384;
+            (arg == "--width" ? settings.width : settings.height) = static_cast<int>(size);
+        } else if (arg == "--out") {
+            settings.output = argv[++i];
+        } else if (arg == "--png") {
+            settings.png = argv[++i];
+        } else {
+            valid = false;
+        }
+
+        if (!valid) {
+            printUsage();
+            return 1;
+        }
+    }
+
+    // Engine switches to the executable directory, paths given on the command line are relative to where the bench was started.
+    if (!settings.output.empty()) settings.output = fs::absolute(settings.output).string();
+    if (!settings.png.empty()) settings.png = fs::absolute(settings.png).string();
+
+    vex::GameInfo gameInfo;
+    gameInfo.projectName = "vex_render_bench";
+    gameInfo.versionMajor = 1;
+
+    vex::Engine engine("vex_render_bench", settings.width, settings.height, gameInfo, true);
+    engine.setFrameLimit(0);
+    engine.setResolutionMode(vex::ResolutionMode::NATIVE);
+
+    // Time based effects would make the image hash differ between runs.
+    vex::enviroment environment = engine.getEnvironmentSettings();
+    environment.passiveVertexJitter = false;
+    environment.ntfsArtifacts = false;
+    engine.setEnvironmentSettings(environment);
+
+    vex::Interface& vulkanInterface = *engine.getInterface();
+    if (settings.recordThreads > 0) {
+        vulkanInterface.getRenderer().setRecordThreadCount(settings.recordThreads);
+    }
+
+    entt::registry& registry = engine.getRegistry();
+    float extent = 0.0f;
+    buildScene(registry, settings, extent);
+
+    entt::entity camera = registry.create();
+    registry.emplace<vex::TransformComponent>(camera, registry);
+    vex::CameraComponent cameraComponent;
+    cameraComponent.farPlane = extent * 4.0f + 50.0f;
+    registry.emplace<vex::CameraComponent>(camera, cameraComponent);
+
+    const uint32_t totalFrames = settings.warmup + settings.frames;
+    std::vector<double> frameTimes;
+    frameTimes.reserve(settings.frames);
+    StatsTotals totals;
+    vex::RenderStats lastStats;
+
+    uint32_t frame = 0;
+    auto lastFrameStart = std::chrono::steady_clock::now();
+
+    // Called at the start of every loop iteration, so the time between two calls is one whole frame: events, update and render.
+    engine.run([&] {
+        auto now = std::chrono::steady_clock::now();
+        if (frame > settings.warmup) {
+            frameTimes.push_back(std::chrono::duration<double, std::milli>(now - lastFrameStart).count());
+
+            lastStats = vulkanInterface.getRenderer().getStats();
+            totals.visibleObjects += lastStats.visibleObjects;
+            totals.drawsBeforeBatching += lastStats.drawsBeforeBatching;
+            totals.drawsAfterBatching += lastStats.drawsAfterBatching;
+            totals.transparentTriangles += lastStats.transparentTriangles;
+            totals.triangles += lastStats.triangles;
+            totals.idleWaits += lastStats.idleWaits;
+        }
+        lastFrameStart = now;
+
+        if (frame == totalFrames) {
+            engine.quit();
+            return;
+        }
+
+        placeCamera(registry.get<vex::TransformComponent>(camera), frame, extent);
+        frame++;
+    });
+
+    std::vector<uint8_t> pixels;
+    glm::uvec2 imageSize(0);
+    if (!vulkanInterface.readbackFrame(pixels, imageSize)) {
+        std::cerr << "Failed to read back the final frame" << std::endl;
+        return 1;
+    }
+
+    char hash[17];
+    std::snprintf(hash, sizeof(hash), "%016llx", static_cast<unsigned long long>(hashPixels(pixels)));
+
+    if (!settings.png.empty() && !vex::writePng(settings.png, pixels.data(), imageSize.x, imageSize.y)) {
+        std::cerr << "Failed to write " << settings.png << std::endl;
+        return 1;
+    }
+
+    VkPhysicalDeviceProperties deviceProperties;
+    vkGetPhysicalDeviceProperties(vulkanInterface.getContext()->physicalDevice, &deviceProperties);
+
+    const double measured = static_cast<double>(std::max<size_t>(frameTimes.size(), 1));
+    nlohmann::json result;
+    result["device"] = deviceProperties.deviceName;
+    result["videoDriver"] = SDL_GetCurrentVideoDriver() ? SDL_GetCurrentVideoDriver() : "unknown";
+    result["scene"] = {
+        {"meshes", settings.meshes},
+        {"lights", settings.lights},
+        {"transparent", settings.transparent},
+        {"frames", settings.frames},
+        {"warmup", settings.warmup},
+        {"recordThreads", vulkanInterface.getRenderer().getRecordThreadCount()}
+    };
+    result["frameTimeMs"] = summarize(frameTimes);
+    result["frameTimesMs"] = frameTimes;
+    result["drawsPerFrame"] = {
+        {"visibleObjects", totals.visibleObjects / measured},
+        {"drawsBeforeBatching", totals.drawsBeforeBatching / measured},
+        {"drawsAfterBatching", totals.drawsAfterBatching / measured},
+        {"transparentTriangles", totals.transparentTriangles / measured},
+        {"triangles", totals.triangles / measured},
+        {"idleWaits", totals.idleWaits / measured}
+    };
+    result["lastFrame"] = {
+        {"visibleObjects", lastStats.visibleObjects},
+        {"drawsBeforeBatching", lastStats.drawsBeforeBatching},
+        {"drawsAfterBatching", lastStats.drawsAfterBatching},
+        {"transparentTriangles", lastStats.transparentTriangles},
+        {"triangles", lastStats.triangles},
+        {"idleWaits", lastStats.idleWaits}
+    };
+    // Trails the last frame by the frames in flight, only steady state timings are reported anyway.
+    nlohmann::json gpuScopes = nlohmann::json::array();
+    for (const auto& timing : vulkanInterface.getRenderer().getGpuProfiler().getTimings()) {
+        gpuScopes.push_back({
+            {"name", timing.name},
+            {"depth", timing.depth},
+            {"avgMs", timing.avgMs},
+            {"minMs", timing.minMs},
+            {"maxMs", timing.maxMs}
+        });
+    }
+    result["gpuScopes"] = gpuScopes;
+    result["image"] = {
+        {"width", imageSize.x},
+        {"height", imageSize.y},
+        {"fnv1a64", hash}
+    };
+
+    if (settings.output.empty()) {
+        std::cout << result.dump(2) << std::endl;
+    } else {
+        std::ofstream output(settings.output, std::ios::trunc);
+        if (!(output << result.dump(2) << std::endl)) {
+            std::cerr << "Failed to write " << settings.output << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
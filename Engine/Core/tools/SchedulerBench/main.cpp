@@ -0,0 +1,197 @@
+#include "components/SystemScheduler.hpp"
+#include "common/ToolCommon.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+    using vex::tools::parseCount;
+
+    constexpr uint32_t COMPONENT_TYPES = 8;
+
+    template <uint32_t Index>
+    struct BenchValue {
+        float value = 0.0f;
+        float velocity = 0.0f;
+    };
+
+    struct BenchSettings {
+        uint32_t entities = 100000;
+        uint32_t systems = 20;
+        uint32_t frames = 100;
+        uint32_t threads = std::max(1u, std::thread::hardware_concurrency());
+        uint32_t work = 4;
+        std::string output;
+    };
+
+    void printUsage() {
+        std::cerr << "Usage: vex_scheduler_bench [--entities N] [--systems S] [--frames F] [--threads T] [--work W] [--out results.json]\n";
+        std::cerr << "  Runs S systems over N entities with 8 component types, each system writing one type and reading another with W\n";
+        std::cerr << "  sin() calls per entity, on a JobPool of one thread and of T threads, and checks both give bit identical components.\n";
+    }
+
+    template <uint32_t Write, uint32_t Read>
+    void addBenchSystem(vex::SystemScheduler& scheduler, uint32_t index, uint32_t work) {
+        vex::SystemAccess access;
+        access.write<BenchValue<Write>>();
+        access.read<BenchValue<Read>>();
+        scheduler.addSystem("Bench system " + std::to_string(index), access, [work](entt::registry& registry, float deltaTime) {
+            registry.view<BenchValue<Write>, const BenchValue<Read>>().each([&](BenchValue<Write>& written, const BenchValue<Read>& read) {
+                float target = read.value;
+                for (uint32_t i = 0; i < work; i++) {
+                    target = std::sin(target + written.velocity);
+                }
+                written.velocity += (target - written.value) * deltaTime;
+                written.value += written.velocity * deltaTime;
+            });
+        });
+    }
+
+    using AddSystemFunction = void (*)(vex::SystemScheduler&, uint32_t, uint32_t);
+
+    template <uint32_t Write, uint32_t... Reads>
+    constexpr std::array<AddSystemFunction, COMPONENT_TYPES> addFunctionsRow(std::integer_sequence<uint32_t, Reads...>) {
+        return { &addBenchSystem<Write, Reads>... };
+    }
+
+    template <uint32_t... Writes>
+    constexpr std::array<std::array<AddSystemFunction, COMPONENT_TYPES>, COMPONENT_TYPES> addFunctionsTable(std::integer_sequence<uint32_t, Writes...>) {
+        return { addFunctionsRow<Writes>(std::make_integer_sequence<uint32_t, COMPONENT_TYPES>())... };
+    }
+
+    template <uint32_t... Indices>
+    void emplaceValues(entt::registry& registry, entt::entity entity, uint32_t seed, std::integer_sequence<uint32_t, Indices...>) {
+        (registry.emplace<BenchValue<Indices>>(entity, static_cast<float>((seed * 31 + Indices * 7) % 97) * 0.01f, 0.0f), ...);
+    }
+
+    template <uint32_t... Indices>
+    uint64_t hashValues(entt::registry& registry, std::integer_sequence<uint32_t, Indices...>) {
+        uint64_t hash = 1469598103934665603ull;
+        auto mix = [&](float value) {
+            uint32_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            hash = (hash ^ bits) * 1099511628211ull;
+        };
+        (registry.view<BenchValue<Indices>>().each([&](const BenchValue<Indices>& component) {
+            mix(component.value);
+            mix(component.velocity);
+        }), ...);
+        return hash;
+    }
+
+    struct RunResult {
+        double frameMs = 0.0;
+        uint64_t hash = 0;
+        uint32_t criticalPath = 0;
+    };
+
+    RunResult run(const BenchSettings& settings, uint32_t threads) {
+        entt::registry registry;
+        for (uint32_t i = 0; i < settings.entities; i++) {
+            emplaceValues(registry, registry.create(), i, std::make_integer_sequence<uint32_t, COMPONENT_TYPES>());
+        }
+
+        vex::JobPool pool(threads);
+        vex::SystemScheduler scheduler(registry, pool);
+        constexpr auto addFunctions = addFunctionsTable(std::make_integer_sequence<uint32_t, COMPONENT_TYPES>());
+        for (uint32_t i = 0; i < settings.systems; i++) {
+            const uint32_t write = i % COMPONENT_TYPES;
+            uint32_t read = (i * 3 + 1) % COMPONENT_TYPES;
+            if (read == write) read = (read + 1) % COMPONENT_TYPES;
+            addFunctions[write][read](scheduler, i, settings.work);
+        }
+
+        RunResult result;
+        std::vector<uint32_t> depth(scheduler.getSystemCount(), 1);
+        for (uint32_t i = 0; i < scheduler.getSystemCount(); i++) {
+            for (uint32_t dependency : scheduler.getDependencies(i)) {
+                depth[i] = std::max(depth[i], depth[dependency] + 1);
+            }
+            result.criticalPath = std::max(result.criticalPath, depth[i]);
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        for (uint32_t frame = 0; frame < settings.frames; frame++) {
+            scheduler.run(1.0f / 60.0f);
+        }
+        result.frameMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / settings.frames;
+        result.hash = hashValues(registry, std::make_integer_sequence<uint32_t, COMPONENT_TYPES>());
+        return result;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    BenchSettings settings;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            printUsage();
+            return 1;
+        }
+
+        bool valid = true;
+        if (arg == "--entities") {
+            valid = parseCount(argv[++i], settings.entities) && settings.entities > 0;
+        } else if (arg == "--systems") {
+            valid = parseCount(argv[++i], settings.systems) && settings.systems > 0;
+        } else if (arg == "--frames") {
+            valid = parseCount(argv[++i], settings.frames) && settings.frames > 0;
+        } else if (arg == "--threads") {
+            valid = parseCount(argv[++i], settings.threads) && settings.threads > 0;
+        } else if (arg == "--work") {
+            valid = parseCount(argv[++i], settings.work);
+        } else if (arg == "--out") {
+            settings.output = argv[++i];
+        } else {
+            valid = false;
+        }
+
+        if (!valid) {
+            printUsage();
+            return 1;
+        }
+    }
+
+    const RunResult single = run(settings, 1);
+    const RunResult parallel = run(settings, settings.threads);
+
+    nlohmann::json result;
+    result["settings"] = {
+        {"entities", settings.entities},
+        {"systems", settings.systems},
+        {"componentTypes", COMPONENT_TYPES},
+        {"frames", settings.frames},
+        {"threads", settings.threads},
+        {"work", settings.work}
+    };
+    result["criticalPath"] = single.criticalPath;
+    result["singleThreadMs"] = single.frameMs;
+    result["parallelMs"] = parallel.frameMs;
+    result["speedup"] = parallel.frameMs > 0.0 ? single.frameMs / parallel.frameMs : 0.0;
+    result["identical"] = single.hash == parallel.hash;
+
+    if (settings.output.empty()) {
+        std::cout << result.dump(2) << std::endl;
+    } else {
+        std::ofstream output(settings.output, std::ios::trunc);
+        if (!(output << result.dump(2) << std::endl)) {
+            std::cerr << "Failed to write " << settings.output << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
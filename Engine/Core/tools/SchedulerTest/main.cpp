@@ -0,0 +1,466 @@
+#include "components/SystemScheduler.hpp"
+#include "common/ToolCommon.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+    using vex::tools::parseCount;
+    using vex::tools::CaseResult;
+    using vex::tools::reportCase;
+
+    struct TestSettings {
+        uint32_t threads = std::max(4u, std::thread::hardware_concurrency());
+        uint32_t rounds = 200;
+        uint32_t frames = 500;
+        uint32_t seed = 1;
+        std::string output;
+    };
+
+    void printUsage() {
+        std::cerr << "Usage: vex_scheduler_test [--threads T] [--rounds R] [--frames F] [--seed S] [--out results.json]\n";
+        std::cerr << "  Checks JobPool on T threads: R rounds of jobs submitting more jobs, stealing from a blocked worker, submits and waits\n";
+        std::cerr << "  from threads that aren't workers (queue 0), main thread jobs and jobs that throw. Then runs SystemScheduler for F\n";
+        std::cerr << "  frames over a fixed and a random system graph and checks conflicting systems run in registration order, once per\n";
+        std::cerr << "  frame. Meant to be built with -DVEX_SANITIZE_THREAD=ON, ThreadSanitizer then reports any race. Exits with 1 on any failure.\n";
+    }
+
+    /// Spins until the flag is set, false once the timeout passed. A hang then shows up as a failed check instead of a stuck run.
+    bool waitFor(const std::atomic<bool>& flag) {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (!flag.load(std::memory_order_acquire)) {
+            if (std::chrono::steady_clock::now() > deadline) return false;
+            std::this_thread::yield();
+        }
+        return true;
+    }
+
+    CaseResult testNestedSubmits(const TestSettings& settings) {
+        CaseResult result;
+        vex::JobPool pool(settings.threads);
+        std::atomic<uint32_t> count{ 0 };
+        constexpr uint32_t JOBS = 50, CHILDREN = 3;
+
+        for (uint32_t round = 0; round < settings.rounds; round++) {
+            vex::JobGroup group;
+            for (uint32_t i = 0; i < JOBS; i++) {
+                pool.submit(group, [&] {
+                    count.fetch_add(1, std::memory_order_relaxed);
+                    // Submitted from a worker these land in its own queue, the others steal them.
+                    for (uint32_t child = 0; child < CHILDREN; child++) {
+                        pool.submit(group, [&] { count.fetch_add(1, std::memory_order_relaxed); });
+                    }
+                });
+            }
+            pool.wait(group);
+            result.check(group.isDone(), "group is done once wait returns");
+        }
+        result.check(count.load() == settings.rounds * JOBS * (1 + CHILDREN), "every job and every job it submitted ran once");
+        return result;
+    }
+
+    CaseResult testOwnQueueOrder() {
+        CaseResult result;
+        // No workers, the waiting thread takes the newest job of queue 0 first.
+        vex::JobPool pool(1);
+        vex::JobGroup group;
+        std::vector<int> order;
+        for (int i = 0; i < 5; i++) {
+            pool.submit(group, [&order, i] { order.push_back(i); });
+        }
+        pool.wait(group);
+        result.check(order == std::vector<int>{ 4, 3, 2, 1, 0 }, "owner takes its newest job first");
+        return result;
+    }
+
+    CaseResult testStealing() {
+        CaseResult result;
+        // Two threads: the parent blocks until its children ran, so the other thread has to steal all of them, oldest first.
+        vex::JobPool pool(2);
+        vex::JobGroup group;
+        constexpr int CHILDREN = 64;
+        std::mutex orderMutex;
+        std::vector<int> order;
+        std::atomic<int> remaining{ CHILDREN };
+        std::atomic<bool> childrenDone{ false };
+        std::atomic<bool> parentTimedOut{ false };
+        std::thread::id parentThread;
+        std::atomic<int> ranOnParentThread{ 0 };
+
+        pool.submit(group, [&] {
+            parentThread = std::this_thread::get_id();
+            for (int i = 0; i < CHILDREN; i++) {
+                pool.submit(group, [&, i] {
+                    if (std::this_thread::get_id() == parentThread) ranOnParentThread++;
+                    {
+                        std::lock_guard<std::mutex> lock(orderMutex);
+                        order.push_back(i);
+                    }
+                    if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                        childrenDone.store(true, std::memory_order_release);
+                    }
+                });
+            }
+            if (!waitFor(childrenDone)) parentTimedOut = true;
+        });
+        pool.wait(group);
+
+        result.check(!parentTimedOut.load(), "children of a blocked job are stolen by the other thread");
+        result.check(ranOnParentThread.load() == 0, "no child ran on the thread of its blocked parent");
+        std::vector<int> expected(CHILDREN);
+        for (int i = 0; i < CHILDREN; i++) expected[i] = i;
+        result.check(order == expected, "thief takes the oldest job first");
+        return result;
+    }
+
+    CaseResult testForeignThreads(const TestSettings& settings) {
+        CaseResult result;
+        vex::JobPool pool(settings.threads);
+        constexpr uint32_t SUBMITTERS = 4, JOBS = 500;
+        std::array<std::atomic<uint32_t>, SUBMITTERS> counts{};
+        std::array<std::atomic<bool>, SUBMITTERS> done{};
+
+        // Threads that aren't workers all share queue 0, for submitting and for waiting.
+        std::vector<std::thread> submitters;
+        for (uint32_t s = 0; s < SUBMITTERS; s++) {
+            submitters.emplace_back([&, s] {
+                vex::JobGroup group;
+                for (uint32_t i = 0; i < JOBS; i++) {
+                    pool.submit(group, [&counts, s] { counts[s].fetch_add(1, std::memory_order_relaxed); });
+                }
+                pool.wait(group);
+                done[s] = group.isDone();
+            });
+        }
+        for (auto& submitter : submitters) {
+            submitter.join();
+        }
+        for (uint32_t s = 0; s < SUBMITTERS; s++) {
+            result.check(done[s].load(), "wait from a thread that isn't a worker returns once its group is done");
+            result.check(counts[s].load() == JOBS, "every job submitted from a thread that isn't a worker ran once");
+        }
+
+        // Same with no workers at all, the waiting threads run everything from queue 0.
+        vex::JobPool single(1);
+        std::atomic<uint32_t> singleCount{ 0 };
+        std::vector<std::thread> waiters;
+        for (uint32_t s = 0; s < SUBMITTERS; s++) {
+            waiters.emplace_back([&] {
+                vex::JobGroup group;
+                for (uint32_t i = 0; i < JOBS; i++) {
+                    single.submit(group, [&] { singleCount.fetch_add(1, std::memory_order_relaxed); });
+                }
+                single.wait(group);
+            });
+        }
+        for (auto& waiter : waiters) {
+            waiter.join();
+        }
+        result.check(singleCount.load() == SUBMITTERS * JOBS, "pool without workers runs jobs of every waiting thread");
+        return result;
+    }
+
+    CaseResult testMainThreadJobs(const TestSettings& settings) {
+        CaseResult result;
+        vex::JobPool pool(settings.threads);
+        const std::thread::id mainThread = std::this_thread::get_id();
+
+        for (uint32_t round = 0; round < settings.rounds; round++) {
+            vex::JobGroup group;
+            std::atomic<bool> onMain{ false };
+            std::atomic<bool> nestedDone{ false };
+            pool.submit(group, [&] {
+                pool.submit(group, [&] { onMain = std::this_thread::get_id() == mainThread; }, true);
+
+                // A worker waiting here must leave the main thread job alone.
+                vex::JobGroup inner;
+                std::atomic<int> value{ 0 };
+                pool.submit(inner, [&] { value = 5; });
+                pool.wait(inner);
+                nestedDone = value.load() == 5;
+            });
+            pool.wait(group);
+            result.check(onMain.load(), "main thread job runs on the waiting thread");
+            result.check(nestedDone.load(), "wait inside a job returns once its group is done");
+        }
+
+        vex::JobGroup failing;
+        std::atomic<bool> afterThrow{ false };
+        pool.submit(failing, [] { throw std::runtime_error("expected test failure"); });
+        pool.submit(failing, [&] { afterThrow = true; });
+        pool.wait(failing);
+        result.check(failing.isDone() && afterThrow.load(), "job that throws is counted as finished and the pool keeps going");
+        return result;
+    }
+
+    struct A { uint32_t value = 0; };
+    struct B { uint32_t value = 0; };
+    struct C { uint32_t value = 0; };
+
+    CaseResult testFixedGraph(const TestSettings& settings) {
+        CaseResult result;
+        entt::registry registry;
+        vex::JobPool pool(settings.threads);
+        vex::SystemScheduler scheduler(registry, pool);
+
+        const entt::entity entity = registry.create();
+        registry.emplace<A>(entity);
+        registry.emplace<B>(entity);
+        registry.emplace<C>(entity);
+
+        std::mutex orderMutex;
+        std::vector<int> order;
+        auto note = [&](int id) {
+            std::lock_guard<std::mutex> lock(orderMutex);
+            order.push_back(id);
+        };
+        const std::thread::id mainThread = std::this_thread::get_id();
+        std::atomic<bool> mainSystemOnMain{ true };
+
+        scheduler.addSystem("Write A", vex::SystemAccess().write<A>(), [&](entt::registry& r, float) {
+            r.get<A>(entity).value = r.get<A>(entity).value * 2 + 1;
+            note(0);
+        });
+        scheduler.addSystem("Write B", vex::SystemAccess().write<B>(), [&](entt::registry& r, float) {
+            r.get<B>(entity).value++;
+            note(1);
+        });
+        scheduler.addSystem("Read A write C", vex::SystemAccess().read<A>().write<C>(), [&](entt::registry& r, float) {
+            r.get<C>(entity).value = r.get<A>(entity).value;
+            note(2);
+        });
+        scheduler.addSystem("Read B", vex::SystemAccess().read<const B>(), [&](entt::registry& r, float) {
+            volatile uint32_t value = r.get<B>(entity).value;
+            (void)value;
+            note(3);
+        });
+        scheduler.addSystem("Write A again", vex::SystemAccess().write<A>(), [&](entt::registry& r, float) {
+            r.get<A>(entity).value += 10;
+            note(4);
+        });
+        scheduler.addSystem("Exclusive", vex::SystemAccess().exclusive(), [&](entt::registry&, float) { note(5); });
+        scheduler.addSystem("Main thread", vex::SystemAccess().read<C>().mainThread(), [&](entt::registry&, float) {
+            if (std::this_thread::get_id() != mainThread) mainSystemOnMain = false;
+            note(6);
+        });
+        // Throws in the first frame only, run has to return and the next frames run normally. One logged failure is enough.
+        std::atomic<bool> thrown{ false };
+        scheduler.addSystem("Throws", vex::SystemAccess().read<C>(), [&](entt::registry&, float) {
+            if (!thrown.exchange(true)) throw std::runtime_error("expected test failure");
+        });
+
+        using Dependencies = std::vector<uint32_t>;
+        result.check(scheduler.getDependencies(0).empty() && scheduler.getDependencies(1).empty(), "first writers of A and B wait for nothing");
+        result.check(scheduler.getDependencies(2) == Dependencies{ 0 }, "reader of A waits for its writer");
+        result.check(scheduler.getDependencies(3) == Dependencies{ 1 }, "reader of B waits for its writer");
+        result.check(scheduler.getDependencies(4) == Dependencies{ 2 }, "second writer of A reaches the first through the reader");
+        result.check(scheduler.getDependencies(5) == Dependencies{ 3, 4 }, "exclusive system waits only for systems nothing else waits for");
+        result.check(scheduler.getDependencies(6) == Dependencies{ 5 } && scheduler.getDependencies(7) == Dependencies{ 5 }, "systems after an exclusive one wait for it");
+
+        uint32_t expectedA = 0, expectedC = 0;
+        for (uint32_t frame = 0; frame < settings.frames; frame++) {
+            order.clear();
+            scheduler.run(0.016f);
+            expectedC = expectedA * 2 + 1;
+            expectedA = expectedC + 10;
+
+            auto position = [&](int id) { return std::find(order.begin(), order.end(), id) - order.begin(); };
+            result.check(order.size() == 7, "every system ran once per frame");
+            result.check(position(0) < position(2) && position(2) < position(4), "conflicting writers and readers of A run in registration order");
+            result.check(position(1) < position(3), "reader of B runs after its writer");
+            result.check(position(3) < position(5) && position(4) < position(5) && position(5) < position(6), "exclusive system runs alone between the others");
+        }
+        result.check(mainSystemOnMain.load(), "main thread system runs on the thread calling run");
+        result.check(registry.get<A>(entity).value == expectedA, "A matches a single threaded run");
+        result.check(registry.get<B>(entity).value == settings.frames, "B was written once per frame");
+        result.check(registry.get<C>(entity).value == expectedC, "C saw A between its two writers");
+
+        // Disabled system is skipped but its dependents still run, so the dependency counters must still count it.
+        scheduler.setSystemEnabled(4, false);
+        order.clear();
+        scheduler.run(0.016f);
+        result.check(order.size() == 6 && std::find(order.begin(), order.end(), 4) == order.end(), "disabled system is skipped and the rest still run");
+        result.check(registry.get<A>(entity).value == expectedA * 2 + 1, "disabled writer left A alone");
+        return result;
+    }
+
+    constexpr uint32_t SLOT_TYPES = 6;
+
+    /// Component whose history lists systems that wrote it, in the order they ran.
+    template <uint32_t Index>
+    struct Slot {
+        std::vector<uint32_t> writers;
+    };
+
+    template <uint32_t Index>
+    void declareSlot(vex::SystemAccess& access, bool write) {
+        if (write) {
+            access.write<Slot<Index>>();
+        } else {
+            access.read<Slot<Index>>();
+        }
+    }
+
+    template <uint32_t Index>
+    std::vector<uint32_t>& slotWriters(entt::registry& registry, entt::entity entity) {
+        return registry.get<Slot<Index>>(entity).writers;
+    }
+
+    using SlotDeclare = void (*)(vex::SystemAccess&, bool);
+    using SlotWriters = std::vector<uint32_t>& (*)(entt::registry&, entt::entity);
+
+    template <uint32_t... Indices>
+    constexpr std::array<SlotDeclare, SLOT_TYPES> slotDeclares(std::integer_sequence<uint32_t, Indices...>) {
+        return { &declareSlot<Indices>... };
+    }
+
+    template <uint32_t... Indices>
+    constexpr std::array<SlotWriters, SLOT_TYPES> slotWritersTable(std::integer_sequence<uint32_t, Indices...>) {
+        return { &slotWriters<Indices>... };
+    }
+
+    template <uint32_t... Indices>
+    void emplaceSlots(entt::registry& registry, entt::entity entity, std::integer_sequence<uint32_t, Indices...>) {
+        (registry.emplace<Slot<Indices>>(entity), ...);
+    }
+
+    CaseResult testRandomGraph(const TestSettings& settings) {
+        CaseResult result;
+        entt::registry registry;
+        vex::JobPool pool(settings.threads);
+        vex::SystemScheduler scheduler(registry, pool);
+        const entt::entity entity = registry.create();
+        constexpr auto SLOTS = std::make_integer_sequence<uint32_t, SLOT_TYPES>();
+        emplaceSlots(registry, entity, SLOTS);
+        constexpr auto declares = slotDeclares(SLOTS);
+        constexpr auto writers = slotWritersTable(SLOTS);
+
+        struct Plan {
+            uint32_t write;
+            uint32_t read;
+        };
+        constexpr uint32_t SYSTEMS = 32;
+        std::mt19937 random(settings.seed);
+        std::vector<Plan> plans(SYSTEMS);
+        // Writes seen by each system in its read slot, filled by the system itself.
+        std::vector<size_t> seenWrites(SYSTEMS, 0);
+        std::vector<uint32_t> runs(SYSTEMS, 0);
+
+        for (uint32_t index = 0; index < SYSTEMS; index++) {
+            Plan& plan = plans[index];
+            plan.write = random() % SLOT_TYPES;
+            plan.read = random() % SLOT_TYPES;
+            vex::SystemAccess access;
+            declares[plan.write](access, true);
+            if (plan.read != plan.write) declares[plan.read](access, false);
+
+            scheduler.addSystem("Random system " + std::to_string(index), access, [&, index](entt::registry& r, float) {
+                const Plan& own = plans[index];
+                seenWrites[index] = writers[own.read](r, entity).size();
+                writers[own.write](r, entity).push_back(index);
+                runs[index]++;
+            });
+        }
+
+        for (uint32_t frame = 0; frame < settings.frames; frame++) {
+            for (uint32_t slot = 0; slot < SLOT_TYPES; slot++) {
+                writers[slot](registry, entity).clear();
+            }
+            scheduler.run(0.016f);
+
+            for (uint32_t slot = 0; slot < SLOT_TYPES; slot++) {
+                std::vector<uint32_t> expected;
+                for (uint32_t index = 0; index < SYSTEMS; index++) {
+                    if (plans[index].write == slot) expected.push_back(index);
+                }
+                result.check(writers[slot](registry, entity) == expected, "writers of a component run in registration order");
+            }
+            for (uint32_t index = 0; index < SYSTEMS; index++) {
+                size_t earlierWrites = 0;
+                for (uint32_t earlier = 0; earlier < index; earlier++) {
+                    if (plans[earlier].write == plans[index].read) earlierWrites++;
+                }
+                result.check(seenWrites[index] == earlierWrites, "reader sees exactly the writes registered before it");
+            }
+        }
+        for (uint32_t index = 0; index < SYSTEMS; index++) {
+            result.check(runs[index] == settings.frames, "every system ran once per frame");
+        }
+        return result;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    TestSettings settings;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            printUsage();
+            return 1;
+        }
+
+        bool valid = true;
+        if (arg == "--threads") {
+            valid = parseCount(argv[++i], settings.threads) && settings.threads >= 2;
+        } else if (arg == "--rounds") {
+            valid = parseCount(argv[++i], settings.rounds) && settings.rounds > 0;
+        } else if (arg == "--frames") {
+            valid = parseCount(argv[++i], settings.frames) && settings.frames > 0;
+        } else if (arg == "--seed") {
+            valid = parseCount(argv[++i], settings.seed);
+        } else if (arg == "--out") {
+            settings.output = argv[++i];
+        } else {
+            valid = false;
+        }
+
+        if (!valid) {
+            printUsage();
+            return 1;
+        }
+    }
+
+    bool passed = true;
+    nlohmann::json result;
+    result["settings"] = {
+        {"threads", settings.threads},
+        {"rounds", settings.rounds},
+        {"frames", settings.frames},
+        {"seed", settings.seed}
+    };
+    result["nestedSubmits"] = reportCase(testNestedSubmits(settings), passed);
+    result["ownQueueOrder"] = reportCase(testOwnQueueOrder(), passed);
+    result["stealing"] = reportCase(testStealing(), passed);
+    result["foreignThreads"] = reportCase(testForeignThreads(settings), passed);
+    result["mainThreadJobs"] = reportCase(testMainThreadJobs(settings), passed);
+    result["fixedGraph"] = reportCase(testFixedGraph(settings), passed);
+    result["randomGraph"] = reportCase(testRandomGraph(settings), passed);
+    result["passed"] = passed;
+
+    if (settings.output.empty()) {
+        std::cout << result.dump(2) << std::endl;
+    } else {
+        std::ofstream output(settings.output, std::ios::trunc);
+        if (!(output << result.dump(2) << std::endl)) {
+            std::cerr << "Failed to write " << settings.output << std::endl;
+            return 1;
+        }
+    }
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,429 @@
+#include "components/backends/vulkan/TextureResidency.hpp"
+#include "common/ToolCommon.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+    using vex::tools::parseCount;
+    using vex::tools::CaseResult;
+    using vex::tools::reportCase;
+
+    struct TestSettings {
+        uint32_t textures = 500;
+        uint32_t frames = 200;
+        uint32_t seed = 1;
+        std::string output;
+    };
+
+    void printUsage() {
+        std::cerr << "Usage: vex_texture_residency_test [--textures N] [--frames F] [--seed S] [--out results.json]\n";
+        std::cerr << "  Feeds planTextureResidency fixed budgets and priorities and checks which mips it evicts or raises and in what order,\n";
+        std::cerr << "  then checks shuffled input gives the same plan and applies plans for N random textures over up to F frames until\n";
+        std::cerr << "  they settle within the budget. Exits with 1 on any failure.\n";
+    }
+
+    using Changes = std::vector<vex::TextureResidencyChange>;
+
+    /// Square RGBA8 texture of `size` texels with its full mip chain, idle at `residentMip`.
+    vex::TextureResidencyEntry makeEntry(uint32_t id, uint32_t size, uint32_t residentMip, uint32_t wantedMip, uint32_t floorMip,
+                                         uint64_t lastUsedFrame, float priority) {
+        vex::TextureResidencyEntry entry;
+        entry.id = id;
+        entry.mipCount = 1;
+        while ((size >> entry.mipCount) > 0) entry.mipCount++;
+        entry.chainBytes[entry.mipCount] = 0;
+        for (uint32_t mip = entry.mipCount; mip-- > 0;) {
+            const uint64_t side = std::max(size >> mip, 1u);
+            entry.chainBytes[mip] = entry.chainBytes[mip + 1] + side * side * 4;
+        }
+        entry.residentMip = residentMip;
+        entry.pendingMip = residentMip;
+        entry.wantedMip = wantedMip;
+        entry.floorMip = floorMip;
+        entry.lastUsedFrame = lastUsedFrame;
+        entry.priority = priority;
+        return entry;
+    }
+
+    uint64_t usageOf(const std::vector<vex::TextureResidencyEntry>& entries) {
+        uint64_t usage = 0;
+        for (const auto& entry : entries) {
+            usage += entry.chainBytes[std::min(entry.residentMip, entry.pendingMip)];
+        }
+        return usage;
+    }
+
+    bool sameChanges(const Changes& a, const Changes& b) {
+        return std::equal(a.begin(), a.end(), b.begin(), b.end(), [](const auto& x, const auto& y) {
+            return x.id == y.id && x.targetMip == y.targetMip;
+        });
+    }
+
+    // Level sizes of a 256 texel RGBA8 texture, mip 0 alone is 256 KiB.
+    const uint64_t MIP0 = 256 * 256 * 4;
+    const uint64_t MIP1 = 128 * 128 * 4;
+
+    CaseResult testUnderBudget() {
+        CaseResult result;
+        std::vector<vex::TextureResidencyEntry> entries = {
+            makeEntry(1, 256, 0, 0, 4, 1, 10.0f),
+            makeEntry(2, 256, 2, 2, 4, 2, 10.0f),
+            makeEntry(3, 64, 1, 1, 4, 3, 10.0f)
+        };
+        const uint64_t usage = usageOf(entries);
+
+        Changes changes;
+        result.check(vex::planTextureResidency(entries, usage, 16, changes) == usage, "usage fitting the budget exactly is returned as is");
+        result.check(changes.empty(), "nothing changes when usage fits and nothing wants more detail");
+        changes.push_back({ 99, 0 });
+        vex::planTextureResidency(entries, usage * 2, 16, changes);
+        result.check(changes.empty(), "output is cleared first");
+        return result;
+    }
+
+    CaseResult testLeastRecentlyUsedFirst() {
+        CaseResult result;
+        std::vector<vex::TextureResidencyEntry> entries = {
+            makeEntry(1, 256, 0, 0, 4, 10, 10.0f),
+            makeEntry(2, 256, 0, 0, 4, 5, 10.0f),
+            makeEntry(3, 256, 0, 0, 4, 8, 10.0f)
+        };
+        const uint64_t usage = usageOf(entries);
+        const uint64_t toFloor = entries[0].chainBytes[0] - entries[0].chainBytes[4];
+
+        Changes changes;
+        uint64_t planned = vex::planTextureResidency(entries, usage - 1000, 16, changes);
+        result.check(sameChanges(changes, { { 2, 1 } }), "a small overshoot costs the oldest texture its top level");
+        result.check(planned == usage - MIP0, "returned usage drops by the evicted level");
+
+        // The oldest texture goes all the way to its floor before the next one loses anything.
+        planned = vex::planTextureResidency(entries, usage - toFloor - 1000, 16, changes);
+        result.check(sameChanges(changes, { { 2, 4 }, { 3, 1 } }), "oldest goes to its floor, then the next oldest loses one level");
+        result.check(planned == usage - toFloor - MIP0, "returned usage counts both evictions");
+
+        planned = vex::planTextureResidency(entries, 0, 16, changes);
+        result.check(sameChanges(changes, { { 2, 4 }, { 3, 4 }, { 1, 4 } }), "without budget every texture goes to its floor, oldest first");
+        result.check(planned == 3 * entries[0].chainBytes[4], "floors stay counted when the budget can't be met");
+        return result;
+    }
+
+    CaseResult testUnwantedDetailFirst() {
+        CaseResult result;
+        // Texture 1 is older but its detail is on screen, texture 2 is newer but far away and only wants mip 2.
+        std::vector<vex::TextureResidencyEntry> entries = {
+            makeEntry(1, 256, 0, 0, 4, 1, 10.0f),
+            makeEntry(2, 256, 0, 2, 4, 9, 10.0f)
+        };
+        const uint64_t usage = usageOf(entries);
+
+        Changes changes;
+        vex::planTextureResidency(entries, usage - 100000, 16, changes);
+        result.check(sameChanges(changes, { { 2, 1 } }), "unwanted top level of the newer texture goes before visible detail of the older one");
+
+        vex::planTextureResidency(entries, usage - MIP0 - MIP1, 16, changes);
+        result.check(sameChanges(changes, { { 2, 2 } }), "all unwanted detail goes before visible detail");
+
+        // Dropping both unwanted levels is not enough, only then visible detail goes in least recently used order.
+        vex::planTextureResidency(entries, usage - MIP0 - MIP1 - 1000, 16, changes);
+        result.check(sameChanges(changes, { { 1, 1 }, { 2, 2 } }), "visible detail of the oldest goes next, changes listed oldest first");
+
+        // A texture that wants detail it doesn't have yet has nothing unwanted to give up in the first pass.
+        entries[1].residentMip = entries[1].pendingMip = 3;
+        vex::planTextureResidency(entries, usageOf(entries) - 1000, 16, changes);
+        result.check(sameChanges(changes, { { 1, 1 } }), "a texture below its wanted mip has nothing unwanted to drop");
+        return result;
+    }
+
+    CaseResult testTieBreakers() {
+        CaseResult result;
+        // Same frame, floors one level down so each texture gives up exactly its top level.
+        std::vector<vex::TextureResidencyEntry> entries = {
+            makeEntry(1, 256, 0, 0, 1, 7, 100.0f),
+            makeEntry(3, 256, 0, 0, 1, 7, 50.0f),
+            makeEntry(2, 256, 0, 0, 1, 7, 50.0f)
+        };
+        const uint64_t usage = usageOf(entries);
+
+        Changes changes;
+        vex::planTextureResidency(entries, usage - MIP0, 16, changes);
+        result.check(sameChanges(changes, { { 2, 1 } }), "lowest priority goes first, lowest id among equal priorities");
+
+        vex::planTextureResidency(entries, usage - 2 * MIP0, 16, changes);
+        result.check(sameChanges(changes, { { 2, 1 }, { 3, 1 } }), "both low priority textures go before the high priority one");
+
+        vex::planTextureResidency(entries, usage - 3 * MIP0, 16, changes);
+        result.check(sameChanges(changes, { { 2, 1 }, { 3, 1 }, { 1, 1 } }), "high priority texture goes last");
+
+        // Recency still comes before priority.
+        entries[0].lastUsedFrame = 6;
+        vex::planTextureResidency(entries, usage - MIP0, 16, changes);
+        result.check(sameChanges(changes, { { 1, 1 } }), "older high priority texture goes before newer low priority ones");
+        return result;
+    }
+
+    CaseResult testFloor() {
+        CaseResult result;
+        std::vector<vex::TextureResidencyEntry> entries = {
+            makeEntry(1, 256, 0, 0, 2, 1, 10.0f),
+            makeEntry(2, 256, 0, 0, 2, 2, 10.0f),
+            makeEntry(3, 256, 3, 3, 2, 0, 10.0f)
+        };
+
+        Changes changes;
+        const uint64_t planned = vex::planTextureResidency(entries, 0, 16, changes);
+        result.check(sameChanges(changes, { { 1, 2 }, { 2, 2 } }), "textures stop at their floor mip");
+        result.check(planned == 2 * entries[0].chainBytes[2] + entries[2].chainBytes[3], "usage above budget is reported when floors don't fit");
+        return result;
+    }
+
+    CaseResult testPendingUploads() {
+        CaseResult result;
+        // Texture 1 is being raised from mip 2 to 0, texture 2 is being lowered from 0 to 3, both count at the finer level.
+        std::vector<vex::TextureResidencyEntry> entries = {
+            makeEntry(1, 256, 2, 0, 4, 1, 10.0f),
+            makeEntry(2, 256, 0, 3, 4, 2, 10.0f),
+            makeEntry(3, 256, 0, 0, 4, 3, 10.0f)
+        };
+        entries[0].pendingMip = 0;
+        entries[1].pendingMip = 3;
+        const uint64_t chain = entries[0].chainBytes[0];
+
+        Changes changes;
+        uint64_t planned = vex::planTextureResidency(entries, 3 * chain - 1000, 16, changes);
+        result.check(sameChanges(changes, { { 3, 1 } }), "textures with an upload in flight are left alone");
+        result.check(planned == 3 * chain - MIP0, "in flight textures count at their finer level");
+
+        entries[2].residentMip = entries[2].pendingMip = 4;
+        planned = vex::planTextureResidency(entries, 4 * chain, 16, changes);
+        result.check(sameChanges(changes, { { 3, 0 } }), "only idle textures are raised");
+        result.check(planned == 3 * chain, "raise is added to returned usage");
+        return result;
+    }
+
+    CaseResult testChangeLimit() {
+        CaseResult result;
+        std::vector<vex::TextureResidencyEntry> entries = {
+            makeEntry(1, 256, 0, 0, 1, 1, 10.0f),
+            makeEntry(2, 256, 0, 0, 1, 2, 10.0f),
+            makeEntry(3, 256, 0, 0, 1, 3, 10.0f),
+            makeEntry(4, 256, 0, 0, 1, 4, 10.0f)
+        };
+        const uint64_t usage = usageOf(entries);
+
+        Changes changes;
+        uint64_t planned = vex::planTextureResidency(entries, usage - 3 * MIP0, 2, changes);
+        result.check(sameChanges(changes, { { 1, 1 }, { 2, 1 } }), "only the oldest textures are changed when the limit is hit");
+        result.check(planned == usage - 2 * MIP0, "eviction left for next frame stays counted");
+
+        planned = vex::planTextureResidency(entries, usage - 3 * MIP0, 0, changes);
+        result.check(changes.empty() && planned == usage, "no changes and unchanged usage with a limit of 0");
+
+        for (auto& entry : entries) {
+            entry.residentMip = entry.pendingMip = 4;
+            entry.floorMip = 4;
+            entry.wantedMip = 0;
+        }
+        vex::planTextureResidency(entries, usageOf(entries) * 100, 3, changes);
+        result.check(changes.size() == 3, "raises stop at the limit too");
+        return result;
+    }
+
+    CaseResult testRaise() {
+        CaseResult result;
+        std::vector<vex::TextureResidencyEntry> entries = {
+            makeEntry(1, 256, 4, 0, 4, 1, 100.0f),
+            makeEntry(2, 256, 4, 0, 4, 1, 300.0f),
+            makeEntry(3, 256, 4, 0, 4, 1, 200.0f),
+            makeEntry(4, 256, 4, 4, 4, 1, 900.0f),
+            makeEntry(5, 256, 4, 0, 4, 1, 200.0f)
+        };
+        const uint64_t usage = usageOf(entries);
+        const uint64_t* chain = entries[0].chainBytes.data();
+
+        // Room for texture 2 up to mip 0 and texture 3 up to mip 2, texture 5 gets what's left and texture 1 nothing.
+        const uint64_t budget = usage + (chain[0] - chain[4]) + (chain[2] - chain[4]) + (chain[3] - chain[4]) + 10;
+        Changes changes;
+        uint64_t planned = vex::planTextureResidency(entries, budget, 16, changes);
+        result.check(sameChanges(changes, { { 2, 0 }, { 3, 2 }, { 5, 3 } }), "highest priority is raised first and as far as the budget allows");
+        result.check(planned == budget - 10, "returned usage includes every raise");
+
+        // Equal priority is broken by recency, then id.
+        entries[4].lastUsedFrame = 2;
+        vex::planTextureResidency(entries, budget, 16, changes);
+        result.check(sameChanges(changes, { { 2, 0 }, { 5, 2 }, { 3, 3 } }), "more recently used texture wins a priority tie");
+
+        vex::planTextureResidency(entries, usage, 16, changes);
+        result.check(changes.empty(), "nothing is raised without spare budget");
+        return result;
+    }
+
+    CaseResult testNoRaiseWhileEvicting() {
+        CaseResult result;
+        std::vector<vex::TextureResidencyEntry> entries = {
+            makeEntry(1, 256, 0, 0, 4, 1, 10.0f),
+            makeEntry(2, 256, 4, 0, 4, 9, 500.0f)
+        };
+        const uint64_t usage = usageOf(entries);
+
+        Changes changes;
+        const uint64_t planned = vex::planTextureResidency(entries, usage - 1, 16, changes);
+        result.check(sameChanges(changes, { { 1, 1 } }), "a frame that evicts raises nothing, even with room left after eviction");
+        result.check(planned == usage - MIP0, "returned usage is left below the budget");
+        return result;
+    }
+
+    vex::TextureResidencyEntry randomEntry(std::mt19937& random, uint32_t id) {
+        const uint32_t size = 1u << (random() % 12);
+        vex::TextureResidencyEntry entry = makeEntry(id, size, 0, 0, 0, random() % 8, static_cast<float>(random() % 4) * 64.0f);
+        entry.floorMip = entry.mipCount - 1 - random() % std::min(entry.mipCount, 3u);
+        entry.residentMip = entry.pendingMip = random() % (entry.floorMip + 1);
+        entry.wantedMip = random() % (entry.floorMip + 1);
+        if (random() % 8 == 0) entry.pendingMip = random() % (entry.floorMip + 1);
+        return entry;
+    }
+
+    CaseResult testDeterminism(const TestSettings& settings) {
+        CaseResult result;
+        std::mt19937 random(settings.seed);
+        std::vector<vex::TextureResidencyEntry> entries;
+        for (uint32_t i = 0; i < settings.textures; i++) {
+            entries.push_back(randomEntry(random, i));
+        }
+        const uint64_t usage = usageOf(entries);
+
+        // Over and under budget, few frame ages and priorities make many ties for the id to break.
+        for (uint64_t budget : { usage / 2, usage * 2 }) {
+            Changes expected;
+            const uint64_t expectedUsage = vex::planTextureResidency(entries, budget, 64, expected);
+            for (int round = 0; round < 8; round++) {
+                std::shuffle(entries.begin(), entries.end(), random);
+                Changes changes;
+                const uint64_t planned = vex::planTextureResidency(entries, budget, 64, changes);
+                result.check(sameChanges(changes, expected) && planned == expectedUsage, "shuffled input gives the same plan");
+            }
+        }
+        return result;
+    }
+
+    struct SettleResult {
+        CaseResult checks;
+        uint32_t frames = 0;
+        uint64_t changes = 0;
+        uint64_t budget = 0;
+        uint64_t usage = 0;
+    };
+
+    /// Applies every plan the way TextureStreamer does once the uploads finish, until the plan comes back empty.
+    SettleResult testSettle(const TestSettings& settings) {
+        SettleResult result;
+        std::mt19937 random(settings.seed);
+        std::vector<vex::TextureResidencyEntry> entries;
+        for (uint32_t i = 0; i < settings.textures; i++) {
+            entries.push_back(randomEntry(random, i));
+            entries.back().pendingMip = entries.back().residentMip;
+        }
+
+        uint64_t floorUsage = 0;
+        for (const auto& entry : entries) {
+            floorUsage += entry.chainBytes[std::max(entry.residentMip, entry.floorMip)];
+        }
+        result.budget = floorUsage + (usageOf(entries) - floorUsage) / 2;
+
+        Changes changes;
+        for (; result.frames < settings.frames; result.frames++) {
+            const uint64_t planned = vex::planTextureResidency(entries, result.budget, 32, changes);
+            if (changes.empty()) break;
+            result.changes += changes.size();
+
+            for (const auto& change : changes) {
+                auto& entry = entries[change.id];
+                const bool evict = change.targetMip > entry.residentMip;
+                result.checks.check(!evict || change.targetMip <= entry.floorMip, "eviction stops at the floor mip");
+                result.checks.check(evict || change.targetMip >= entry.wantedMip, "raise stops at the wanted mip");
+                entry.residentMip = entry.pendingMip = change.targetMip;
+            }
+            result.checks.check(planned == usageOf(entries), "returned usage matches usage after applying the plan");
+        }
+
+        result.usage = usageOf(entries);
+        result.checks.check(changes.empty(), "plans settle within the frame limit");
+        result.checks.check(result.usage <= result.budget, "settled usage fits a budget above the floors");
+        return result;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    TestSettings settings;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            printUsage();
+            return 1;
+        }
+
+        bool valid = true;
+        if (arg == "--textures") {
+            valid = parseCount(argv[++i], settings.textures) && settings.textures > 0;
+        } else if (arg == "--frames") {
+            valid = parseCount(argv[++i], settings.frames) && settings.frames > 0;
+        } else if (arg == "--seed") {
+            valid = parseCount(argv[++i], settings.seed);
+        } else if (arg == "--out") {
+            settings.output = argv[++i];
+        } else {
+            valid = false;
+        }
+
+        if (!valid) {
+            printUsage();
+            return 1;
+        }
+    }
+
+    bool passed = true;
+    nlohmann::json result;
+    result["settings"] = {
+        {"textures", settings.textures},
+        {"frames", settings.frames},
+        {"seed", settings.seed}
+    };
+    result["underBudget"] = reportCase(testUnderBudget(), passed);
+    result["leastRecentlyUsedFirst"] = reportCase(testLeastRecentlyUsedFirst(), passed);
+    result["unwantedDetailFirst"] = reportCase(testUnwantedDetailFirst(), passed);
+    result["tieBreakers"] = reportCase(testTieBreakers(), passed);
+    result["floor"] = reportCase(testFloor(), passed);
+    result["pendingUploads"] = reportCase(testPendingUploads(), passed);
+    result["changeLimit"] = reportCase(testChangeLimit(), passed);
+    result["raise"] = reportCase(testRaise(), passed);
+    result["noRaiseWhileEvicting"] = reportCase(testNoRaiseWhileEvicting(), passed);
+    result["determinism"] = reportCase(testDeterminism(settings), passed);
+
+    const SettleResult settle = testSettle(settings);
+    result["settle"] = reportCase(settle.checks, passed);
+    result["settle"]["frames"] = settle.frames;
+    result["settle"]["changes"] = settle.changes;
+    result["settle"]["budget"] = settle.budget;
+    result["settle"]["usage"] = settle.usage;
+    result["passed"] = passed;
+
+    if (settings.output.empty()) {
+        std::cout << result.dump(2) << std::endl;
+    } else {
+        std::ofstream output(settings.output, std::ios::trunc);
+        if (!(output << result.dump(2) << std::endl)) {
+            std::cerr << "Failed to write " << settings.output << std::endl;
+            return 1;
+        }
+    }
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,182 @@
+#include "components/TransformSystem.hpp"
+#include "common/ToolCommon.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+    using vex::tools::parseCount;
+    using vex::tools::millisecondsSince;
+
+    struct BenchSettings {
+        uint32_t entities = 100000;
+        uint32_t depth = 32;
+        uint32_t width = 1000;
+        uint32_t frames = 100;
+        std::string output;
+    };
+
+    void printUsage() {
+        std::cerr << "Usage: vex_transform_bench [--entities N] [--depth D] [--width W] [--frames F] [--out results.json]\n";
+        std::cerr << "  Builds flat (N roots), deep (chains of D) and wide (roots with W children) hierarchies, moves every root each frame\n";
+        std::cerr << "  and compares TransformSystem::update against recomputing every world matrix through its parents.\n";
+    }
+
+    /// Creates `count` transforms, each parented to the one `parentOf` returns for its index (entt::null for roots).
+    template <typename ParentOf>
+    std::vector<entt::entity> buildHierarchy(entt::registry& registry, uint32_t count, ParentOf parentOf) {
+        std::vector<entt::entity> entities(count);
+        for (uint32_t i = 0; i < count; i++) {
+            entities[i] = registry.create();
+            const float offset = static_cast<float>(i % 7) * 0.25f;
+            registry.emplace<vex::TransformComponent>(entities[i], registry, glm::vec3(offset, 1.0f, -offset), glm::vec3(0.0f, 5.0f, 0.0f),
+                                                      glm::vec3(1.0f), parentOf(i, entities));
+        }
+        return entities;
+    }
+
+    nlohmann::json runShape(const char* name, const BenchSettings& settings, entt::registry& registry, const std::vector<entt::entity>& entities) {
+        std::vector<entt::entity> roots;
+        for (entt::entity entity : entities) {
+            if (registry.get<vex::TransformComponent>(entity).getParent() == entt::null) roots.push_back(entity);
+        }
+        auto moveRoots = [&](uint32_t frame) {
+            for (entt::entity root : roots) {
+                registry.get<vex::TransformComponent>(root).setLocalPosition(glm::vec3(std::sin(frame * 0.1f), 0.0f, 0.0f));
+            }
+        };
+
+        // Per entity walk up the parents, what every matrix() query did when a hierarchy moved.
+        auto start = std::chrono::steady_clock::now();
+        for (uint32_t frame = 0; frame < settings.frames; frame++) {
+            moveRoots(frame);
+            for (entt::entity entity : entities) {
+                registry.get<vex::TransformComponent>(entity).recalculateMatrix();
+            }
+        }
+        const double recursiveMs = millisecondsSince(start) / settings.frames;
+
+        vex::TransformSystem system(registry);
+        start = std::chrono::steady_clock::now();
+        system.update();
+        const double rebuildMs = millisecondsSince(start);
+
+        start = std::chrono::steady_clock::now();
+        for (uint32_t frame = 0; frame < settings.frames; frame++) {
+            moveRoots(frame);
+            system.update();
+        }
+        const double systemMs = millisecondsSince(start) / settings.frames;
+
+        // Nothing moved, only dirty checks are left.
+        start = std::chrono::steady_clock::now();
+        for (uint32_t frame = 0; frame < settings.frames; frame++) {
+            system.update();
+        }
+        const double staticMs = millisecondsSince(start) / settings.frames;
+
+        float maxError = 0.0f;
+        for (entt::entity entity : entities) {
+            auto& transform = registry.get<vex::TransformComponent>(entity);
+            const glm::mat4 batched = transform.getWorldMatrix();
+            const glm::mat4 recursive = transform.recalculateMatrix();
+            for (int column = 0; column < 4; column++) {
+                const glm::vec4 difference = glm::abs(batched[column] - recursive[column]);
+                maxError = std::max({ maxError, difference.x, difference.y, difference.z, difference.w });
+            }
+        }
+
+        return {
+            {"shape", name},
+            {"entities", entities.size()},
+            {"levels", system.getLevelCount()},
+            {"recursiveMs", recursiveMs},
+            {"systemMs", systemMs},
+            {"systemStaticMs", staticMs},
+            {"rebuildMs", rebuildMs},
+            {"speedup", systemMs > 0.0 ? recursiveMs / systemMs : 0.0},
+            {"maxError", maxError}
+        };
+    }
+}
+
+int main(int argc, char* argv[]) {
+    BenchSettings settings;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            printUsage();
+            return 1;
+        }
+
+        bool valid = true;
+        if (arg == "--entities") {
+            valid = parseCount(argv[++i], settings.entities) && settings.entities > 0;
+        } else if (arg == "--depth") {
+            valid = parseCount(argv[++i], settings.depth) && settings.depth > 0;
+        } else if (arg == "--width") {
+            valid = parseCount(argv[++i], settings.width) && settings.width > 0;
+        } else if (arg == "--frames") {
+            valid = parseCount(argv[++i], settings.frames) && settings.frames > 0;
+        } else if (arg == "--out") {
+            settings.output = argv[++i];
+        } else {
+            valid = false;
+        }
+
+        if (!valid) {
+            printUsage();
+            return 1;
+        }
+    }
+
+    nlohmann::json result;
+    result["settings"] = {
+        {"entities", settings.entities},
+        {"depth", settings.depth},
+        {"width", settings.width},
+        {"frames", settings.frames}
+    };
+    result["shapes"] = nlohmann::json::array();
+
+    {
+        entt::registry registry;
+        auto entities = buildHierarchy(registry, settings.entities, [](uint32_t, const auto&) { return entt::entity{ entt::null }; });
+        result["shapes"].push_back(runShape("flat", settings, registry, entities));
+    }
+    {
+        entt::registry registry;
+        auto entities = buildHierarchy(registry, settings.entities, [&](uint32_t i, const auto& created) {
+            return i % settings.depth == 0 ? entt::entity{ entt::null } : created[i - 1];
+        });
+        result["shapes"].push_back(runShape("deep", settings, registry, entities));
+    }
+    {
+        entt::registry registry;
+        auto entities = buildHierarchy(registry, settings.entities, [&](uint32_t i, const auto& created) {
+            return i % settings.width == 0 ? entt::entity{ entt::null } : created[i - i % settings.width];
+        });
+        result["shapes"].push_back(runShape("wide", settings, registry, entities));
+    }
+
+    if (settings.output.empty()) {
+        std::cout << result.dump(2) << std::endl;
+    } else {
+        std::ofstream output(settings.output, std::ios::trunc);
+        if (!(output << result.dump(2) << std::endl)) {
+            std::cerr << "Failed to write " << settings.output << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,344 @@
+#include "components/backends/vulkan/SortKeys.hpp"
+#include "components/backends/vulkan/limits.hpp"
+#include "common/ToolCommon.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+    using vex::tools::parseCount;
+    using vex::tools::millisecondsSince;
+
+    struct BenchSettings {
+        uint32_t items = 100000;
+        uint32_t frames = 120;
+        uint32_t seed = 1;
+        std::string output;
+    };
+
+    void printUsage() {
+        std::cerr << "Usage: vex_transparency_sort_bench [--items N] [--frames F] [--seed S] [--out results.json]\n";
+        std::cerr << "  Sorts N transparent triangle centers back to front for F frames of several camera motions with the three paths of\n";
+        std::cerr << "  TransparencySorter: radix sort, insertion sort from last frame's order and radix sort after insertion ran out of budget.\n";
+        std::cerr << "  Measures where insertion stops paying off against the per item move budget and what the 32 bit float key loses\n";
+        std::cerr << "  against ordering by exact double distances and a 64 bit key radix sort.\n";
+    }
+
+    struct Point {
+        double x;
+        double y;
+        double z;
+    };
+
+    /// Camera motion between frames, from still to unrelated positions.
+    enum Motion : uint32_t { STATIC, JITTER, WALK, RUN, ORBIT, TELEPORT, MOTION_COUNT };
+    constexpr std::array<const char*, MOTION_COUNT> MOTION_NAMES = { "static", "jitter", "walk", "run", "orbit", "teleport" };
+
+    /// Transparent meshes scattered over a 200 x 20 x 200 area, triangles of one mesh within a unit of its center like foliage cards.
+    std::vector<Point> buildScene(uint32_t items, std::mt19937& random) {
+        auto uniform = [&](double min, double max) { return std::uniform_real_distribution<double>(min, max)(random); };
+        std::vector<Point> centers(items);
+        Point object{};
+        for (uint32_t i = 0; i < items; i++) {
+            if (i % 200 == 0) {
+                object = { uniform(-100.0, 100.0), uniform(0.0, 20.0), uniform(-100.0, 100.0) };
+            }
+            centers[i] = { object.x + uniform(-1.0, 1.0), object.y + uniform(-1.0, 1.0), object.z + uniform(-1.0, 1.0) };
+        }
+        return centers;
+    }
+
+    Point cameraAt(Motion motion, uint32_t frame, std::mt19937& random) {
+        auto uniform = [&](double min, double max) { return std::uniform_real_distribution<double>(min, max)(random); };
+        const double t = static_cast<double>(frame);
+        switch (motion) {
+            case STATIC: return { 0.0, 2.0, 120.0 };
+            case JITTER: return { uniform(-0.002, 0.002), 2.0 + uniform(-0.002, 0.002), 120.0 + uniform(-0.002, 0.002) };
+            case WALK: return { 0.0, 2.0, 120.0 - t * 0.025 }; // 1.5 m/s at 60 fps
+            case RUN: return { 0.0, 2.0, 120.0 - t * 0.1 };    // 6 m/s at 60 fps
+            case ORBIT: return { 120.0 * std::sin(t * 0.01), 10.0, 120.0 * std::cos(t * 0.01) };
+            case TELEPORT: return { uniform(-150.0, 150.0), uniform(0.0, 30.0), uniform(-150.0, 150.0) };
+            case MOTION_COUNT: break;
+        }
+        return {};
+    }
+
+    /// Same ordering idea as packFarthestFirst but on the exact double distance, 8 passes over a 64 bit key instead of 4.
+    struct WideKey {
+        uint64_t key;
+        uint32_t index;
+    };
+
+    void radixSortWide(std::vector<WideKey>& values, std::vector<WideKey>& scratch) {
+        const size_t count = values.size();
+        if (count < 2) return;
+        std::array<std::array<uint32_t, 256>, 8> histograms{};
+        for (const WideKey& value : values) {
+            for (uint32_t pass = 0; pass < 8; pass++) histograms[pass][(value.key >> (pass * 8)) & 0xFF]++;
+        }
+        scratch.resize(count);
+        WideKey* src = values.data();
+        WideKey* dst = scratch.data();
+        for (uint32_t pass = 0; pass < 8; pass++) {
+            auto& histogram = histograms[pass];
+            const uint32_t shift = pass * 8;
+            if (histogram[(src[0].key >> shift) & 0xFF] == count) continue;
+            uint32_t offset = 0;
+            for (auto& bucket : histogram) {
+                uint32_t bucketCount = bucket;
+                bucket = offset;
+                offset += bucketCount;
+            }
+            for (size_t i = 0; i < count; i++) dst[histogram[(src[i].key >> shift) & 0xFF]++] = src[i];
+            std::swap(src, dst);
+        }
+        if (src != values.data()) std::memcpy(values.data(), src, count * sizeof(WideKey));
+    }
+
+    uint64_t farthestFirstWide(double distance) {
+        uint64_t bits;
+        std::memcpy(&bits, &distance, sizeof(bits));
+        return ~(bits ^ ((bits >> 63) ? ~0ull : 0x8000000000000000ull));
+    }
+
+    struct MotionResult {
+        uint32_t frames = 0;
+        double radixMs = 0.0;
+        double coherentMs = 0.0;           // insertion from last order, radix after it when it gave up, what the sorter does
+        double wastedMs = 0.0;             // insertion time thrown away by fallbacks
+        uint32_t fallbacks = 0;
+        double movesPerItem = 0.0;         // of frames that finished within the sampling budget
+        double maxMovesPerItem = 0.0;
+        uint32_t overSampleBudget = 0;     // frames needing more than the sampling budget, far past the break even point
+        bool identical = true;
+    };
+
+    /// Insertion sort cost of one frame, collected from every motion to find where it costs as much as radix sort.
+    struct CostSample {
+        double movesPerItem;
+        double insertionMs;
+    };
+}
+
+int main(int argc, char* argv[]) {
+    BenchSettings settings;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            printUsage();
+            return 1;
+        }
+
+        bool valid = true;
+        if (arg == "--items") {
+            valid = parseCount(argv[++i], settings.items) && settings.items > 1;
+        } else if (arg == "--frames") {
+            valid = parseCount(argv[++i], settings.frames) && settings.frames > 1;
+        } else if (arg == "--seed") {
+            valid = parseCount(argv[++i], settings.seed);
+        } else if (arg == "--out") {
+            settings.output = argv[++i];
+        } else {
+            valid = false;
+        }
+
+        if (!valid) {
+            printUsage();
+            return 1;
+        }
+    }
+
+    std::mt19937 random(settings.seed);
+    const std::vector<Point> centers = buildScene(settings.items, random);
+    const uint32_t count = settings.items;
+    // Frames needing more than this are so far past break even that sampling them fully would only slow the bench down.
+    const size_t sampleBudget = static_cast<size_t>(count) * 64;
+
+    std::vector<float> keys(count);
+    std::vector<double> exactKeys(count);
+    std::vector<uint64_t> radixSorted(count);
+    std::vector<uint64_t> coherent(count);
+    std::vector<uint64_t> sample(count);
+    std::vector<uint64_t> scratch;
+    std::vector<uint32_t> lastOrder(count);
+    std::vector<WideKey> wide(count);
+    std::vector<WideKey> wideScratch;
+
+    std::array<MotionResult, MOTION_COUNT> motions{};
+    std::vector<CostSample> samples;
+    double radix32Ms = 0.0;
+    double radix64Ms = 0.0;
+    uint64_t comparedPairs = 0;
+    uint64_t misorderedPairs = 0;
+    uint64_t floatTies = 0;
+    double maxMisorderedRelative = 0.0;
+
+    for (uint32_t motion = 0; motion < MOTION_COUNT; motion++) {
+        MotionResult& result = motions[motion];
+        for (uint32_t frame = 0; frame < settings.frames; frame++) {
+            const Point camera = cameraAt(static_cast<Motion>(motion), frame, random);
+            for (uint32_t i = 0; i < count; i++) {
+                const double dx = centers[i].x - camera.x;
+                const double dy = centers[i].y - camera.y;
+                const double dz = centers[i].z - camera.z;
+                exactKeys[i] = dx * dx + dy * dy + dz * dz;
+                // Sorter computes squared distance in float from float positions.
+                const float fx = static_cast<float>(centers[i].x) - static_cast<float>(camera.x);
+                const float fy = static_cast<float>(centers[i].y) - static_cast<float>(camera.y);
+                const float fz = static_cast<float>(centers[i].z) - static_cast<float>(camera.z);
+                keys[i] = fx * fx + fy * fy + fz * fz;
+            }
+
+            auto start = std::chrono::steady_clock::now();
+            for (uint32_t i = 0; i < count; i++) radixSorted[i] = vex::packFarthestFirst(keys[i], i);
+            vex::radixSortKeys(radixSorted, scratch);
+            const double radixMs = millisecondsSince(start);
+            radix32Ms += radixMs;
+
+            if (frame == 0) {
+                // First frame has no previous order, the sorter always radix sorts it.
+                for (uint32_t i = 0; i < count; i++) lastOrder[i] = static_cast<uint32_t>(radixSorted[i]);
+                continue;
+            }
+            result.frames++;
+            result.radixMs += radixMs;
+
+            // What TransparencySorter::sort does with the same objects visible as last frame.
+            start = std::chrono::steady_clock::now();
+            for (uint32_t i = 0; i < count; i++) coherent[i] = vex::packFarthestFirst(keys[lastOrder[i]], lastOrder[i]);
+            const bool reused = vex::insertionSortKeys(coherent, static_cast<size_t>(count) * TRANSPARENT_SORT_MOVES_PER_ITEM);
+            const double insertionMs = millisecondsSince(start);
+            if (!reused) {
+                result.fallbacks++;
+                result.wastedMs += insertionMs;
+                for (uint32_t i = 0; i < count; i++) coherent[i] = vex::packFarthestFirst(keys[i], i);
+                vex::radixSortKeys(coherent, scratch);
+            }
+            result.coherentMs += millisecondsSince(start);
+            result.identical = result.identical && coherent == radixSorted;
+
+            // Full insertion cost of the same frame, with a budget only big enough to stop pathological frames.
+            start = std::chrono::steady_clock::now();
+            for (uint32_t i = 0; i < count; i++) sample[i] = vex::packFarthestFirst(keys[lastOrder[i]], lastOrder[i]);
+            size_t moves = 0;
+            const bool sampled = vex::insertionSortKeys(sample, sampleBudget, &moves);
+            const double sampleMs = millisecondsSince(start);
+            if (sampled) {
+                const double movesPerItem = static_cast<double>(moves) / count;
+                samples.push_back({ movesPerItem, sampleMs });
+                result.movesPerItem += movesPerItem;
+                result.maxMovesPerItem = std::max(result.maxMovesPerItem, movesPerItem);
+            } else {
+                result.overSampleBudget++;
+            }
+
+            for (uint32_t i = 0; i < count; i++) lastOrder[i] = static_cast<uint32_t>(radixSorted[i]);
+
+            // 64 bit key on the exact distance, the alternative to truncating it to a float.
+            start = std::chrono::steady_clock::now();
+            for (uint32_t i = 0; i < count; i++) wide[i] = { farthestFirstWide(exactKeys[i]), i };
+            radixSortWide(wide, wideScratch);
+            radix64Ms += millisecondsSince(start);
+
+            // Neighbours the float key orders differently than the exact distance would.
+            for (uint32_t i = 1; i < count; i++) {
+                const uint32_t nearer = static_cast<uint32_t>(radixSorted[i]);
+                const uint32_t farther = static_cast<uint32_t>(radixSorted[i - 1]);
+                comparedPairs++;
+                if (keys[nearer] == keys[farther]) floatTies++;
+                if (exactKeys[nearer] > exactKeys[farther]) {
+                    misorderedPairs++;
+                    maxMisorderedRelative = std::max(maxMisorderedRelative, (exactKeys[nearer] - exactKeys[farther]) / exactKeys[farther]);
+                }
+            }
+        }
+    }
+
+    // Least squares fit of insertion time = base + perMove * moves, break even is where it reaches radix sort time.
+    double sumX = 0.0, sumY = 0.0, sumXX = 0.0, sumXY = 0.0;
+    for (const CostSample& costSample : samples) {
+        sumX += costSample.movesPerItem;
+        sumY += costSample.insertionMs;
+        sumXX += costSample.movesPerItem * costSample.movesPerItem;
+        sumXY += costSample.movesPerItem * costSample.insertionMs;
+    }
+    const double sampleCount = static_cast<double>(samples.size());
+    const double denominator = sampleCount * sumXX - sumX * sumX;
+    const double msPerMovePerItem = denominator > 0.0 ? (sampleCount * sumXY - sumX * sumY) / denominator : 0.0;
+    const double baseMs = sampleCount > 0.0 ? (sumY - msPerMovePerItem * sumX) / sampleCount : 0.0;
+
+    uint32_t measuredFrames = 0;
+    double radixTotalMs = 0.0;
+    for (const MotionResult& result : motions) {
+        measuredFrames += result.frames;
+        radixTotalMs += result.radixMs;
+    }
+    const double radixFrameMs = measuredFrames > 0 ? radixTotalMs / measuredFrames : 0.0;
+    const double breakEven = msPerMovePerItem > 0.0 ? (radixFrameMs - baseMs) / msPerMovePerItem : 0.0;
+
+    nlohmann::json result;
+    result["settings"] = {
+        {"items", settings.items},
+        {"frames", settings.frames},
+        {"seed", settings.seed}
+    };
+
+    bool identical = true;
+    for (uint32_t motion = 0; motion < MOTION_COUNT; motion++) {
+        const MotionResult& motionResult = motions[motion];
+        const uint32_t frames = std::max(1u, motionResult.frames);
+        const uint32_t sampledFrames = std::max(1u, motionResult.frames - motionResult.overSampleBudget);
+        identical = identical && motionResult.identical;
+        result["motions"][MOTION_NAMES[motion]] = {
+            {"radixMs", motionResult.radixMs / frames},
+            {"coherentMs", motionResult.coherentMs / frames},
+            {"fallbacks", motionResult.fallbacks},
+            {"wastedMs", motionResult.fallbacks > 0 ? motionResult.wastedMs / motionResult.fallbacks : 0.0},
+            {"movesPerItem", motionResult.movesPerItem / sampledFrames},
+            {"maxMovesPerItem", motionResult.maxMovesPerItem},
+            {"overSampleBudget", motionResult.overSampleBudget},
+            {"identical", motionResult.identical}
+        };
+    }
+    result["budget"] = {
+        {"movesPerItem", TRANSPARENT_SORT_MOVES_PER_ITEM},
+        {"insertionBaseMs", baseMs},
+        {"insertionMsPerMovePerItem", msPerMovePerItem},
+        {"radixMs", radixFrameMs},
+        {"breakEvenMovesPerItem", breakEven},
+        {"samples", samples.size()}
+    };
+    result["key"] = {
+        {"comparedPairs", comparedPairs},
+        {"floatTies", floatTies},
+        {"misorderedPairs", misorderedPairs},
+        {"maxMisorderedRelativeDistance", maxMisorderedRelative},
+        {"radix32Ms", radix32Ms / (settings.frames * MOTION_COUNT)},
+        {"radix64Ms", measuredFrames > 0 ? radix64Ms / measuredFrames : 0.0}
+    };
+    result["identical"] = identical;
+
+    if (settings.output.empty()) {
+        std::cout << result.dump(2) << std::endl;
+    } else {
+        std::ofstream output(settings.output, std::ios::trunc);
+        if (!(output << result.dump(2) << std::endl)) {
+            std::cerr << "Failed to write " << settings.output << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
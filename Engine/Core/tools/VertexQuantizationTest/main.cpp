@@ -0,0 +1,295 @@
+#include "components/VertexQuantization.hpp"
+#include "common/ToolCommon.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <numbers>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+    using vex::tools::parseCount;
+    using vex::tools::CaseResult;
+    using vex::tools::reportCase;
+
+    struct TestSettings {
+        uint32_t normals = 1000000;
+        uint32_t vertices = 100000;
+        uint32_t seed = 1;
+        std::string output;
+    };
+
+    void printUsage() {
+        std::cerr << "Usage: vex_vertex_quantization_test [--normals N] [--vertices V] [--seed S] [--out results.json]\n";
+        std::cerr << "  Round trips N unit normals spread over the sphere (plus poles and octahedron seams) through octahedral R16G16_SNORM and\n";
+        std::cerr << "  reports the largest angular error, then round trips V positions per test box through R16G16B16A16_UNORM and reports\n";
+        std::cerr << "  the largest error relative to the box. Also checks every half float UV round trips. Exits with 1 when an error exceeds\n";
+        std::cerr << "  the bound VertexQuantization.hpp promises.\n";
+    }
+
+    /// Angle between a unit normal and what the vertex shader decodes from its `CompactVertex`, in double so the measurement
+    /// itself doesn't add float rounding.
+    double normalError(const glm::vec3& normal) {
+        vex::Vertex vertex;
+        vertex.position = glm::vec3(0.0f);
+        vertex.normal = normal;
+        const vex::Vertex decoded = vex::dequantizeVertex(vex::quantizeVertex(vertex, vex::PositionQuantization{}), vex::PositionQuantization{});
+
+        const double ax = normal.x, ay = normal.y, az = normal.z;
+        const double bx = decoded.normal.x, by = decoded.normal.y, bz = decoded.normal.z;
+        const double cx = ay * bz - az * by, cy = az * bx - ax * bz, cz = ax * by - ay * bx;
+        return std::atan2(std::sqrt(cx * cx + cy * cy + cz * cz), ax * bx + ay * by + az * bz);
+    }
+
+    struct NormalResult {
+        CaseResult checks;
+        uint64_t tested = 0;
+        double maxError = 0.0;
+        double meanError = 0.0;
+        glm::vec3 worst = glm::vec3(0.0f);
+    };
+
+    NormalResult testNormals(const TestSettings& settings) {
+        NormalResult result;
+        std::vector<glm::vec3> normals;
+        normals.reserve(settings.normals + 4096);
+
+        // Fibonacci sphere, evenly spread so every region of the octahedron gets the same share of samples.
+        const double golden = std::numbers::pi * (3.0 - std::sqrt(5.0));
+        for (uint32_t i = 0; i < settings.normals; i++) {
+            const double z = 1.0 - 2.0 * (i + 0.5) / settings.normals;
+            const double radius = std::sqrt(1.0 - z * z);
+            const double angle = golden * i;
+            normals.emplace_back(static_cast<float>(radius * std::cos(angle)), static_cast<float>(radius * std::sin(angle)), static_cast<float>(z));
+        }
+
+        // Poles, axes and the seams where the lower hemisphere is folded over or the sign of x or y flips.
+        for (int axis = 0; axis < 3; axis++) {
+            for (float sign : { -1.0f, 1.0f }) {
+                glm::vec3 normal(0.0f);
+                normal[axis] = sign;
+                normals.push_back(normal);
+            }
+        }
+        for (uint32_t i = 0; i < 1024; i++) {
+            const double angle = 2.0 * std::numbers::pi * i / 1024.0;
+            const float c = static_cast<float>(std::cos(angle)), s = static_cast<float>(std::sin(angle));
+            normals.emplace_back(c, s, 0.0f);
+            normals.emplace_back(c, 0.0f, s);
+            normals.emplace_back(0.0f, c, s);
+            normals.push_back(glm::normalize(glm::vec3(c, s, -1e-4f)));
+        }
+
+        double sum = 0.0;
+        for (const auto& normal : normals) {
+            const double error = normalError(normal);
+            sum += error;
+            if (error > result.maxError) {
+                result.maxError = error;
+                result.worst = normal;
+            }
+        }
+        result.tested = normals.size();
+        result.meanError = sum / normals.size();
+
+        // The sweep is unlikely to hit the exact worst spot, climb from the worst sample with shrinking random steps.
+        std::mt19937 random(settings.seed);
+        std::uniform_real_distribution<float> offset(-1.0f, 1.0f);
+        for (float step = 1e-3f; step > 1e-7f; step *= 0.5f) {
+            for (int i = 0; i < 256; i++) {
+                const glm::vec3 candidate = glm::normalize(result.worst + glm::vec3(offset(random), offset(random), offset(random)) * step);
+                const double error = normalError(candidate);
+                result.tested++;
+                if (error > result.maxError) {
+                    result.maxError = error;
+                    result.worst = candidate;
+                }
+            }
+        }
+        result.checks.check(result.maxError <= vex::COMPACT_NORMAL_MAX_ERROR, "normal angular error stays within COMPACT_NORMAL_MAX_ERROR");
+        result.checks.check(normalError(glm::vec3(0.0f, 0.0f, 1.0f)) == 0.0 && normalError(glm::vec3(0.0f, 0.0f, -1.0f)) == 0.0,
+                            "poles round trip exactly");
+        return result;
+    }
+
+    struct Box {
+        const char* name;
+        glm::vec3 min;
+        glm::vec3 max;
+    };
+
+    struct PositionResult {
+        CaseResult checks;
+        nlohmann::json boxes = nlohmann::json::array();
+    };
+
+    /// Worst error is measured on both paths, `dequantizeVertex` and the dequantization matrix folded into the model matrix.
+    PositionResult testPositions(const TestSettings& settings) {
+        PositionResult result;
+        const Box boxes[] = {
+            { "unitCube", glm::vec3(0.0f), glm::vec3(1.0f) },
+            { "character", glm::vec3(-0.4f, 0.0f, -0.3f), glm::vec3(0.4f, 1.8f, 0.3f) },
+            { "terrainTile", glm::vec3(-256.0f, -12.0f, -256.0f), glm::vec3(256.0f, 40.0f, 256.0f) },
+            { "farFromOrigin", glm::vec3(10000.0f, 5.0f, -20000.0f), glm::vec3(10010.0f, 15.0f, -19990.0f) },
+            { "flat", glm::vec3(-5.0f, 2.0f, -5.0f), glm::vec3(5.0f, 2.0f, 5.0f) },
+            { "tiny", glm::vec3(0.001f), glm::vec3(0.002f) }
+        };
+
+        std::mt19937 random(settings.seed);
+        for (const Box& box : boxes) {
+            std::vector<vex::Vertex> vertices(settings.vertices + 8);
+            for (size_t i = 0; i < vertices.size(); i++) {
+                glm::vec3 position;
+                for (int axis = 0; axis < 3; axis++) {
+                    // First eight are the corners, so the quantization covers exactly this box.
+                    const float t = i < 8 ? static_cast<float>((i >> axis) & 1) : std::uniform_real_distribution<float>(0.0f, 1.0f)(random);
+                    position[axis] = box.min[axis] + (box.max[axis] - box.min[axis]) * t;
+                }
+                vertices[i].position = position;
+                vertices[i].normal = glm::vec3(0.0f, 1.0f, 0.0f);
+            }
+
+            const vex::PositionQuantization quantization = vex::computePositionQuantization(vertices);
+            const glm::mat4 matrix = quantization.matrix();
+            double maxError = 0.0;
+            double maxMatrixError = 0.0;
+            for (const auto& vertex : vertices) {
+                const vex::CompactVertex compact = vex::quantizeVertex(vertex, quantization);
+                const vex::Vertex decoded = vex::dequantizeVertex(compact, quantization);
+                const glm::vec4 transformed = matrix * glm::vec4(compact.position[0] / 65535.0f, compact.position[1] / 65535.0f, compact.position[2] / 65535.0f, 1.0f);
+                for (int axis = 0; axis < 3; axis++) {
+                    maxError = std::max(maxError, std::abs(static_cast<double>(decoded.position[axis]) - vertex.position[axis]));
+                    maxMatrixError = std::max(maxMatrixError, std::abs(static_cast<double>(transformed[axis]) - vertex.position[axis]));
+                }
+            }
+
+            // A step is the box's longest side over 65535, the error of rounding to the nearest step is half of that.
+            const double step = quantization.scale / 65535.0;
+            const std::string name = box.name;
+            result.checks.check(maxError <= quantization.maxError(), name + ": position error stays within PositionQuantization::maxError");
+            result.checks.check(maxMatrixError <= quantization.maxError(), name + ": matrix path error stays within PositionQuantization::maxError");
+            result.boxes.push_back({
+                {"name", name},
+                {"scale", quantization.scale},
+                {"maxError", maxError},
+                {"maxMatrixError", maxMatrixError},
+                {"maxErrorRelative", maxError / quantization.scale},
+                {"maxErrorSteps", maxError / step},
+                {"bound", quantization.maxError()}
+            });
+        }
+        return result;
+    }
+
+    struct UVResult {
+        CaseResult checks;
+        uint32_t roundTripMismatches = 0;
+        double maxError = 0.0;
+    };
+
+    UVResult testUVs(const TestSettings& settings) {
+        UVResult result;
+        for (uint32_t bits = 0; bits <= UINT16_MAX; bits++) {
+            const float value = vex::halfToFloat(static_cast<uint16_t>(bits));
+            if (std::isnan(value)) continue;
+            if (vex::floatToHalf(value) != bits) result.roundTripMismatches++;
+        }
+        result.checks.check(result.roundTripMismatches == 0, "every finite half float round trips through float");
+
+        std::mt19937 random(settings.seed);
+        std::uniform_real_distribution<float> uv(-vex::COMPACT_UV_LIMIT, vex::COMPACT_UV_LIMIT);
+        for (uint32_t i = 0; i < settings.vertices; i++) {
+            vex::Vertex vertex;
+            vertex.position = glm::vec3(0.0f);
+            vertex.normal = glm::vec3(0.0f, 0.0f, 1.0f);
+            vertex.uv = glm::vec2(uv(random), uv(random));
+            const vex::Vertex decoded = vex::dequantizeVertex(vex::quantizeVertex(vertex, vex::PositionQuantization{}), vex::PositionQuantization{});
+            for (int axis = 0; axis < 2; axis++) {
+                result.maxError = std::max(result.maxError, std::abs(static_cast<double>(decoded.uv[axis]) - vertex.uv[axis]));
+            }
+        }
+        result.checks.check(result.maxError <= 1.0 / 256.0, "UV error within COMPACT_UV_LIMIT stays at or under 1/256");
+
+        vex::Vertex untextured;
+        untextured.position = glm::vec3(0.0f);
+        untextured.normal = glm::vec3(0.0f, 0.0f, 1.0f);
+        const vex::Vertex decoded = vex::dequantizeVertex(vex::quantizeVertex(untextured, vex::PositionQuantization{}), vex::PositionQuantization{});
+        result.checks.check(decoded.uv.x <= -10000.0f && decoded.uv.y <= -10000.0f, "untextured UV still reads as untextured");
+        return result;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    TestSettings settings;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            printUsage();
+            return 1;
+        }
+
+        bool valid = true;
+        if (arg == "--normals") {
+            valid = parseCount(argv[++i], settings.normals) && settings.normals > 0;
+        } else if (arg == "--vertices") {
+            valid = parseCount(argv[++i], settings.vertices) && settings.vertices > 0;
+        } else if (arg == "--seed") {
+            valid = parseCount(argv[++i], settings.seed);
+        } else if (arg == "--out") {
+            settings.output = argv[++i];
+        } else {
+            valid = false;
+        }
+
+        if (!valid) {
+            printUsage();
+            return 1;
+        }
+    }
+
+    bool passed = true;
+    nlohmann::json result;
+    result["settings"] = {
+        {"normals", settings.normals},
+        {"vertices", settings.vertices},
+        {"seed", settings.seed}
+    };
+
+    const NormalResult normals = testNormals(settings);
+    result["normals"] = reportCase(normals.checks, passed);
+    result["normals"]["tested"] = normals.tested;
+    result["normals"]["maxErrorRadians"] = normals.maxError;
+    result["normals"]["maxErrorDegrees"] = normals.maxError * 180.0 / std::numbers::pi;
+    result["normals"]["meanErrorRadians"] = normals.meanError;
+    result["normals"]["boundRadians"] = vex::COMPACT_NORMAL_MAX_ERROR;
+    result["normals"]["worst"] = { normals.worst.x, normals.worst.y, normals.worst.z };
+
+    const PositionResult positions = testPositions(settings);
+    result["positions"] = reportCase(positions.checks, passed);
+    result["positions"]["boxes"] = positions.boxes;
+
+    const UVResult uvs = testUVs(settings);
+    result["uvs"] = reportCase(uvs.checks, passed);
+    result["uvs"]["roundTripMismatches"] = uvs.roundTripMismatches;
+    result["uvs"]["maxError"] = uvs.maxError;
+    result["passed"] = passed;
+
+    if (settings.output.empty()) {
+        std::cout << result.dump(2) << std::endl;
+    } else {
+        std::ofstream output(settings.output, std::ios::trunc);
+        if (!(output << result.dump(2) << std::endl)) {
+            std::cerr << "Failed to write " << settings.output << std::endl;
+            return 1;
+        }
+    }
+    return passed ? 0 : 1;
+}
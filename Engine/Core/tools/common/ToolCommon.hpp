@@ -0,0 +1,62 @@
+/**
+ *  @file   ToolCommon.hpp
+ *  @brief  This file defines argument parsing, timing and check reporting shared by the benchmarks and tests under tools/.
+ *  @author Eryk Roszkowski
+ ***********************************************/
+
+#pragma once
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace vex::tools {
+    /// @brief Parses a whole decimal argument.
+    /// @param const char* text - Argument as given on the command line.
+    /// @param uint32_t& out - Receives the value, left untouched on failure.
+    /// @return bool - False when text is not a number or does not fit 32 bits.
+    inline bool parseCount(const char* text, uint32_t& out) {
+        char* end = nullptr;
+        unsigned long value = std::strtoul(text, &end, 10);
+        if (end == text || *end != '\0' || value > UINT32_MAX) return false;
+        out = static_cast<uint32_t>(value);
+        return true;
+    }
+
+    /// @brief Milliseconds passed since start.
+    /// @param std::chrono::steady_clock::time_point start - Time the measurement began.
+    /// @return double
+    inline double millisecondsSince(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    /// @brief Failed checks of one test case, reported by name.
+    struct CaseResult {
+        std::vector<std::string> failures;
+
+        /// @brief Records what when condition does not hold.
+        /// @param bool condition - Checked condition.
+        /// @param const std::string& what - What the condition states, e.g. "stale handle does not resolve".
+        void check(bool condition, const std::string& what) {
+            if (!condition) failures.push_back(what);
+        }
+    };
+
+    /// @brief Turns a case into its JSON report and clears passed if the case failed.
+    /// @param const CaseResult& result - Case to report.
+    /// @param bool& passed - Overall result of the run.
+    /// @return nlohmann::json - {"passed": bool, "failures": [...]}.
+    inline nlohmann::json reportCase(const CaseResult& result, bool& passed) {
+        // Each distinct failure once, checks inside loops repeat the same failure many times.
+        std::vector<std::string> failures = result.failures;
+        std::sort(failures.begin(), failures.end());
+        failures.erase(std::unique(failures.begin(), failures.end()), failures.end());
+        passed = passed && failures.empty();
+        return { {"passed", failures.empty()}, {"failures", failures} };
+    }
+}
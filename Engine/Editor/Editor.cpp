@@ -10,12 +10,15 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <volk.h>
+#include <algorithm>
 #include <filesystem>
 #include <limits>
+#include <thread>
 
 #include "components/GameComponents/BasicComponents.hpp"
 #include "components/GameObjects/Creators/ModelCreator.hpp"
 #include "components/assetTypes.hpp"
+#include "components/Profiler.hpp"
 #include "ImReflect.hpp"
 
 #include "../Core/include/components/SceneManager.hpp"
@@ -55,6 +58,10 @@ namespace vex {
 
         m_physicsSystem = std::make_unique<PhysicsSystem>(m_registry);
         m_physicsSystem->init();
+        m_transformSystem = std::make_unique<TransformSystem>(m_registry);
+        m_hierarchySystem = std::make_unique<HierarchySystem>(m_registry);
+        m_jobPool = std::make_unique<JobPool>(std::max(1u, std::thread::hardware_concurrency()));
+        m_systemScheduler = std::make_unique<SystemScheduler>(m_registry, *m_jobPool);
 
         auto renderRes = m_resolutionManager->getRenderResolution();
         log("Initializing Vulkan interface...");
@@ -68,6 +75,8 @@ namespace vex {
         m_sceneManager = std::make_unique<SceneManager>();
 
         getInterface()->getMeshManager().init(static_cast<Engine*>(this));
+        // Picking tests mesh triangles, so their data has to stay around after upload.
+        getInterface()->getMeshManager().setRetainMeshData(true);
         setInputMode(InputMode::UI);
 
         log("Initializing editor components...");
@@ -196,6 +205,7 @@ namespace vex {
         }
 
     void Editor::update(float deltaTime) {
+        VEX_PROFILE_SCOPE("Editor::update");
         if (!m_pendingSceneToLoad.empty() && !m_waitForGui) {
             m_interface->WaitForGPUToFinish();
             getSceneManager()->loadScene(m_pendingSceneToLoad, *this);
@@ -249,6 +259,7 @@ namespace vex {
         m_camera->Update(deltaTime);
         m_physicsSystem->SyncBodies();
 
+        m_transformSystem->update();
         render();
         if(!m_refresh){
             m_frame = 1;
@@ -301,6 +312,10 @@ namespace vex {
             glm::uvec2 newRes = viewportRes;
             drawEditorLayout(renderData, newRes);
 
+            if (m_editorProperties.showTextureStreaming) {
+                m_interface->getResources()->getTextureStreamer().drawDebugOverlay();
+            }
+
             if (newRes != m_viewportSize && newRes.x > 0 && newRes.y > 0) {
                 m_viewportSize = newRes;
             }
@@ -342,13 +357,16 @@ namespace vex {
 
         VkSampler sampler = resources->getTextureSampler();
 
+        for (auto& [path, targetPtr] : targets) {
+            std::filesystem::path correctPath = GetExecutableDir() / path;
+            resources->loadTexture(correctPath.string(), "editor_" + path);
+        }
+        resources->finishTextureUploads();
+
         for (auto& [path, targetPtr] : targets) {
             std::string name = "editor_" + path;
 
             try {
-                std::filesystem::path correctPath = GetExecutableDir() / path;
-                resources->loadTexture(correctPath.string(), name);
-
                 VkDescriptorSet ds = vulkanGUI->addTexture(
                     sampler,
                     resources->getTextureView(name),
@@ -708,6 +726,7 @@ namespace vex {
                 entt::entity hitEntity = entt::null;
 
                 auto viewGroup = m_registry.view<TransformComponent, MeshComponent>();
+                auto& meshManager = getInterface()->getMeshManager();
 
                 for (auto entity : viewGroup) {
                     auto& mesh = viewGroup.get<MeshComponent>(entity);
@@ -717,6 +736,14 @@ namespace vex {
                         continue;
                     }
 
+                    if (meshManager.isMeshLoading(mesh.meshData.meshPath)) {
+                        continue;
+                    }
+                    std::shared_ptr<const MeshData> meshData = meshManager.getMeshData(mesh.meshData.meshPath);
+                    if (!meshData) {
+                        continue;
+                    }
+
                     glm::mat4 modelMat = transform.matrix();
                     glm::mat4 invModel = glm::inverse(modelMat);
 
@@ -728,7 +755,7 @@ namespace vex {
                     float localClosest = std::numeric_limits<float>::max();
                     bool hitMesh = false;
 
-                    for (const auto& submesh : mesh.meshData.submeshes) {
+                    for (const auto& submesh : meshData->submeshes) {
                         for (size_t i = 0; i < submesh.indices.size(); i += 3) {
                             const auto& v0 = submesh.vertices[submesh.indices[i]].position;
                             const auto& v1 = submesh.vertices[submesh.indices[i+1]].position;
@@ -1,5 +1,6 @@
 #include "EditorMenuBar.hpp"
 #include "AssetBrowser.hpp"
+#include "ProfilerMenu.hpp"
 
 #include "../Editor.hpp"
 #include "../DialogWindow.hpp"
@@ -12,6 +13,7 @@
 #include "components/pathUtils.hpp"
 #include "components/Scene.hpp"
 #include "components/SceneManager.hpp"
+#include "components/backends/vulkan/Interface.hpp"
 #include "imgui.h"
 
 #include <nlohmann/json.hpp>
@@ -81,6 +83,15 @@ void EditorMenuBar::DrawBar(){
             }
             ImGui::EndMenu();
         }
+        if (ImGui::BeginMenu("Tools")) {
+            if (ImGui::MenuItem("CPU Profiler")) {
+                OpenCpuProfiler();
+            }
+            if (ImGui::MenuItem("GPU Profiler")) {
+                OpenGpuProfiler();
+            }
+            ImGui::EndMenu();
+        }
 
         float runMenuWidth = ImGui::CalcTextSize("Run").x + 40.0f;
         float currentPos = ImGui::GetCursorPosX();
@@ -229,6 +240,46 @@ void EditorMenuBar::OpenEditorSettings(){
         openSceneWindow->Create(m_ImGUIWrapper);
 }
 
+void EditorMenuBar::OpenCpuProfiler(){
+    std::shared_ptr<BasicEditorWindow> profilerWindow = std::make_shared<BasicEditorWindow>();
+    std::weak_ptr<BasicEditorWindow> weakWindow = profilerWindow;
+
+        profilerWindow->Create = [weakWindow](vex::ImGUIWrapper& wrapper){
+            wrapper.addUIFunction([=](){
+                auto window = weakWindow.lock(); if (!window || !window->isOpen) return;
+                ImGui::SetNextWindowSize(ImVec2(420, 360), ImGuiCond_FirstUseEver);
+
+                if (ImGui::Begin("CPU Profiler", &window->isOpen)) {
+                    vex::DrawCpuProfiler();
+                }
+                ImGui::End();
+            });
+        };
+
+        m_Windows.push_back(profilerWindow);
+        profilerWindow->Create(m_ImGUIWrapper);
+}
+
+void EditorMenuBar::OpenGpuProfiler(){
+    std::shared_ptr<BasicEditorWindow> profilerWindow = std::make_shared<BasicEditorWindow>();
+    std::weak_ptr<BasicEditorWindow> weakWindow = profilerWindow;
+
+        profilerWindow->Create = [this, weakWindow](vex::ImGUIWrapper& wrapper){
+            wrapper.addUIFunction([=, this](){
+                auto window = weakWindow.lock(); if (!window || !window->isOpen) return;
+                ImGui::SetNextWindowSize(ImVec2(520, 320), ImGuiCond_FirstUseEver);
+
+                if (ImGui::Begin("GPU Profiler", &window->isOpen)) {
+                    vex::DrawGpuProfiler(m_editor.getInterface()->getRenderer().getGpuProfiler());
+                }
+                ImGui::End();
+            });
+        };
+
+        m_Windows.push_back(profilerWindow);
+        profilerWindow->Create(m_ImGUIWrapper);
+}
+
 void EditorMenuBar::OpenProjectSettings(){
     std::shared_ptr<BasicEditorWindow> openSceneWindow = std::make_shared<BasicEditorWindow>();
     std::weak_ptr<BasicEditorWindow> weakWindow = openSceneWindow;
@@ -40,6 +40,12 @@ public:
     /// @brief Opens the project settings window/menu.
     void OpenProjectSettings();
 
+    /// @brief Opens the window showing CPU zones of the last frame and trace capture controls.
+    void OpenCpuProfiler();
+
+    /// @brief Opens the window showing GPU time of render passes.
+    void OpenGpuProfiler();
+
     /// @brief Opens the project selector window.
     void OpenProjectSelector();
 
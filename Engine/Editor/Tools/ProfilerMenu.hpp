@@ -0,0 +1,156 @@
+/**
+ * @file   ProfilerMenu.hpp
+ * @brief  Utility functions for drawing CPU and GPU profiler timings in an ImGUI window.
+ * @author Eryk Roszkowski
+ ***********************************************/
+
+#pragma once
+
+#include <imgui.h>
+
+#include "components/Profiler.hpp"
+#include "../../Core/src/components/backends/vulkan/GpuProfiler.hpp"
+
+namespace vex {
+    /**
+         * @brief Draws per scope GPU timings and pipeline statistics of the renderer.
+         * @param GpuProfiler& profiler - Profiler of the renderer, see `Renderer::getGpuProfiler`.
+         */
+    inline void DrawGpuProfiler(GpuProfiler& profiler) {
+        if (!profiler.isSupported()) {
+            ImGui::TextWrapped("GPU timestamps are not supported on this device, nothing is measured.");
+            return;
+        }
+
+        bool enabled = profiler.isEnabled();
+        if (ImGui::Checkbox("Enabled", &enabled)) {
+            profiler.setEnabled(enabled);
+        }
+        ImGui::SameLine();
+        if (ImGui::Button("Reset")) {
+            profiler.clearHistory();
+        }
+        if (profiler.getDroppedFrames() > 0) {
+            ImGui::SameLine();
+            ImGui::TextDisabled("(%llu frames dropped)", static_cast<unsigned long long>(profiler.getDroppedFrames()));
+        }
+
+        const auto& timings = profiler.getTimings();
+        const ImGuiTableFlags tableFlags = ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV | ImGuiTableFlags_SizingStretchProp;
+
+        if (ImGui::BeginTable("GpuTimings", 5, tableFlags)) {
+            ImGui::TableSetupColumn("Scope", ImGuiTableColumnFlags_WidthStretch, 2.0f);
+            ImGui::TableSetupColumn("Last ms");
+            ImGui::TableSetupColumn("Avg ms");
+            ImGui::TableSetupColumn("Min ms");
+            ImGui::TableSetupColumn("Max ms");
+            ImGui::TableHeadersRow();
+
+            for (const auto& timing : timings) {
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::Text("%*s%s", static_cast<int>(timing.depth * 2), "", timing.name.c_str());
+                ImGui::TableNextColumn();
+                ImGui::Text("%.3f", timing.lastMs);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.3f", timing.avgMs);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.3f", timing.minMs);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.3f", timing.maxMs);
+            }
+            ImGui::EndTable();
+        }
+
+        if (!profiler.supportsStatistics()) {
+            ImGui::TextDisabled("Pipeline statistics are not supported on this device.");
+            return;
+        }
+
+        if (ImGui::CollapsingHeader("Pipeline Statistics", ImGuiTreeNodeFlags_DefaultOpen)) {
+            if (ImGui::BeginTable("GpuStatistics", 6, tableFlags)) {
+                ImGui::TableSetupColumn("Scope", ImGuiTableColumnFlags_WidthStretch, 2.0f);
+                ImGui::TableSetupColumn("Vertices");
+                ImGui::TableSetupColumn("Primitives");
+                ImGui::TableSetupColumn("VS Invocations");
+                ImGui::TableSetupColumn("Clipped Primitives");
+                ImGui::TableSetupColumn("FS Invocations");
+                ImGui::TableHeadersRow();
+
+                for (const auto& timing : timings) {
+                    if (!timing.hasStatistics) continue;
+
+                    const GpuPipelineStatistics& statistics = timing.statistics;
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn();
+                    ImGui::TextUnformatted(timing.name.c_str());
+                    for (uint64_t value : { statistics.inputVertices, statistics.inputPrimitives, statistics.vertexInvocations,
+                                            statistics.clippingPrimitives, statistics.fragmentInvocations }) {
+                        ImGui::TableNextColumn();
+                        ImGui::Text("%llu", static_cast<unsigned long long>(value));
+                    }
+                }
+                ImGui::EndTable();
+            }
+        }
+    }
+
+    /**
+         * @brief Draws CPU zones of the last frame as a hierarchy and controls for trace captures.
+         */
+    inline void DrawCpuProfiler() {
+#if !VEX_PROFILER
+        ImGui::TextWrapped("Engine was built with VEX_PROFILER off, profiler scopes are compiled out.");
+#else
+        bool enabled = Profiler::isEnabled();
+        if (ImGui::Checkbox("Record", &enabled)) {
+            Profiler::setEnabled(enabled);
+        }
+        ImGui::SameLine();
+
+        // Relative to the executable directory, same as captures taken with the capture key.
+        if (Profiler::isCapturing()) {
+            if (ImGui::Button("Stop Capture")) {
+                Profiler::stopCapture(Profiler::captureFileName());
+            }
+        } else {
+            if (ImGui::Button("Start Capture")) {
+                Profiler::startCapture();
+            }
+            ImGui::SameLine();
+            if (ImGui::Button("Capture 120 Frames")) {
+                Profiler::captureFrames(120, Profiler::captureFileName());
+            }
+        }
+
+        const ProfileFrame& frame = Profiler::getLastFrame();
+        if (frame.zones.empty()) {
+            ImGui::TextDisabled("Nothing recorded, enable Record or start a capture.");
+            return;
+        }
+
+        const double frameMs = (frame.end - frame.start) / 1000000.0;
+        ImGui::Text("Frame %llu: %.3f ms", static_cast<unsigned long long>(frame.index), frameMs);
+
+        const ImGuiTableFlags tableFlags = ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV | ImGuiTableFlags_SizingStretchProp;
+        if (ImGui::BeginTable("CpuZones", 3, tableFlags)) {
+            ImGui::TableSetupColumn("Zone", ImGuiTableColumnFlags_WidthStretch, 2.0f);
+            ImGui::TableSetupColumn("ms");
+            ImGui::TableSetupColumn("% of frame");
+            ImGui::TableHeadersRow();
+
+            for (const ProfileZone& zone : frame.zones) {
+                const double ms = (zone.end - zone.start) / 1000000.0;
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::Text("%*s%s", static_cast<int>(zone.depth * 2), "", zone.name);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.3f", ms);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.1f", frameMs > 0.0 ? ms / frameMs * 100.0 : 0.0);
+            }
+            ImGui::EndTable();
+        }
+#endif
+    }
+}
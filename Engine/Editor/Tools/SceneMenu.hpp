@@ -63,25 +63,12 @@ inline void ReparentObject(vex::GameObject* child, vex::GameObject* parent) {
 
     auto& childTc = child->GetComponent<vex::TransformComponent>();
 
-    entt::entity parentCheck = parent->GetEntity();
-    auto* registry = &child->GetEngine().getRegistry();
-
-    while(parentCheck != entt::null && registry->valid(parentCheck)) {
-        if(parentCheck == child->GetEntity()) {
-            return;
-        }
-        if(registry->all_of<vex::TransformComponent>(parentCheck)) {
-            parentCheck = registry->get<vex::TransformComponent>(parentCheck).getParent();
-        } else {
-            break;
-        }
-    }
-
     glm::vec3 oldWorldPos = childTc.getWorldPosition();
     glm::quat oldWorldRot = childTc.getWorldQuaternion();
     glm::vec3 oldWorldScale = childTc.getWorldScale();
 
-    childTc.setParent(parent->GetEntity());
+    // Refused when the parent is one of the child's descendants.
+    if (!vex::HierarchySystem::setParent(child->GetEngine().getRegistry(), child->GetEntity(), parent->GetEntity())) return;
 
     childTc.setWorldPosition(oldWorldPos);
     childTc.setWorldQuaternion(oldWorldRot);
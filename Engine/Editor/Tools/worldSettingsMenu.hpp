@@ -28,6 +28,8 @@ namespace vex {
             changed |= ImGui::Checkbox("Texture Color Quantization", &env.textureQuantization);
             changed |= ImGui::Checkbox("Screen Dithering", &env.screenDither);
             changed |= ImGui::Checkbox("CRT Artifacts", &env.ntfsArtifacts);
+            changed |= ImGui::Checkbox("Per Triangle Transparency Sorting", &env.perTriangleTransparency);
+            changed |= ImGui::DragFloat("LOD Error (pixels)", &env.lodErrorPixels, 0.05f, 0.0f, 16.0f);
         }
 
         if (ImGui::CollapsingHeader("Lighting & Atmosphere", ImGuiTreeNodeFlags_DefaultOpen)) {
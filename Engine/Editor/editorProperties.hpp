@@ -13,6 +13,7 @@
 struct EditorProperties {
     bool showFPS = false;
     bool showCollisions = false;
+    bool showTextureStreaming = false;
 
     float assetBrowserThumbnailSize = 64.0f;
 
@@ -25,5 +26,5 @@ struct EditorProperties {
     auto operator<=>(const EditorProperties&) const = default;
 };
 
-IMGUI_REFLECT(EditorProperties, showFPS, showCollisions, assetBrowserThumbnailSize, editorCameraFov, editorCameraRenderDistance, frameLimit, vsync);
-NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_WITH_DEFAULT(EditorProperties, showFPS, showCollisions, assetBrowserThumbnailSize, editorCameraFov, editorCameraRenderDistance, frameLimit, vsync);
+IMGUI_REFLECT(EditorProperties, showFPS, showCollisions, showTextureStreaming, assetBrowserThumbnailSize, editorCameraFov, editorCameraRenderDistance, frameLimit, vsync);
+NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_WITH_DEFAULT(EditorProperties, showFPS, showCollisions, showTextureStreaming, assetBrowserThumbnailSize, editorCameraFov, editorCameraRenderDistance, frameLimit, vsync);